@@ -1221,6 +1221,64 @@ int wrapper_mqtt_publish(void *client, const char *topicName, iotx_mqtt_topic_in
     return (int)msg_id;
 }
 
+/* module takes payload by AT command and frames the packet itself, so buffer is plain payload here */
+void *wrapper_mqtt_buf_alloc(void *client, int topic_len, int payload_len)
+{
+#ifdef PLATFORM_HAS_DYNMEM
+    if (NULL == client || payload_len < 0) {
+        return NULL;
+    }
+
+    return mal_malloc(payload_len > 0 ? payload_len : 1);
+#else
+    return NULL;
+#endif
+}
+
+void *wrapper_mqtt_buf_payload(void *buf)
+{
+    return buf;
+}
+
+void wrapper_mqtt_buf_release(void *buf)
+{
+#ifdef PLATFORM_HAS_DYNMEM
+    if (NULL != buf) {
+        mal_free(buf);
+    }
+#endif
+}
+
+int wrapper_mqtt_inflight_stats(void *client, iotx_mqtt_inflight_stats_t *stats)
+{
+    /* module keeps QoS1 publishes itself */
+    return FAIL_RETURN;
+}
+
+int wrapper_mqtt_outbox_open(void *client, const char *name, int max_msgs)
+{
+    /* publishes while module is offline are not kept */
+    return FAIL_RETURN;
+}
+
+int wrapper_mqtt_outbox_stats(void *client, iotx_mqtt_outbox_stats_t *stats)
+{
+    return FAIL_RETURN;
+}
+
+int wrapper_mqtt_publish_buf(void *client, const char *topicName, iotx_mqtt_topic_info_pt topic_msg, void *buf)
+{
+    int rc = NULL_VALUE_ERROR;
+
+    if (NULL != buf && NULL != topic_msg) {
+        topic_msg->payload = buf;
+        rc = wrapper_mqtt_publish(client, topicName, topic_msg);
+    }
+
+    wrapper_mqtt_buf_release(buf);
+    return rc;
+}
+
 int wrapper_mqtt_release(void **client)
 {
     iotx_mc_client_t *pClient;
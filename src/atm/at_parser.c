@@ -11,17 +11,59 @@
 
 #define OOB_MAX 5
 
+/* longest prefix or postfix that can be matched, for oob and reply delimiters */
+#ifndef AT_PATTERN_LEN_MAX
+#define AT_PATTERN_LEN_MAX      32
+#endif
+
+/*
+ * bytes asked from uart in one read, raise it only for a HAL_AT_Uart_Recv that returns what
+ * has arrived, one that waits for expect_size bytes would hold short replies until timeout
+ */
+#ifndef AT_UART_RX_BLOCK_SIZE
+#define AT_UART_RX_BLOCK_SIZE   1
+#endif
+
+#define AT_OOB_NODE_NUM         (OOB_MAX * AT_PATTERN_LEN_MAX + 1)
+
+/*
+ * Matcher of a single pattern fed one byte at a time, tells whether the bytes fed
+ * so far end with the pattern, fail[i] is the longest proper border of pattern[0, i)
+ */
+typedef struct
+{
+    const char *pattern;
+    int         len;
+    int         state;
+    uint8_t     fail[AT_PATTERN_LEN_MAX + 1];
+} at_matcher_t;
+
 typedef struct oob_s
 {
     char *     prefix;
     char *     postfix;
     char *     oobinputdata;
+    uint32_t   prefix_len;
     uint32_t   reallen;
     uint32_t   maxlen;
+    at_matcher_t postfix_matcher;
     at_recv_cb cb;
     void *     arg;
 } oob_t;
 
+/*
+ * Node of the automaton compiled from all oob prefixes, children are chained by sibling,
+ * bit k of out is set if prefix of _oobs[k] is a suffix of the text leading to the node
+ */
+typedef struct
+{
+    char     ch;
+    uint8_t  out;
+    int16_t  child;
+    int16_t  sibling;
+    int16_t  fail;
+} oob_node_t;
+
 /*
  * --> | slist | --> | slist | --> NULL
  *     ---------     ---------
@@ -46,6 +88,10 @@ typedef struct at_task_s
     uint32_t  rsp_fail_postfix_len;
     uint32_t  rsp_offset;
     uint32_t  rsp_len;
+    at_matcher_t rsp_prefix_matcher;
+    at_matcher_t rsp_success_matcher;
+    at_matcher_t rsp_fail_matcher;
+    int       rsp_prefix_synced;
 } at_task_t;
 #endif
 
@@ -66,6 +112,12 @@ typedef struct
     int         _send_delim_size;
     oob_t       _oobs[OOB_MAX];
     int         _oobs_num;
+    oob_node_t  _oob_nodes[AT_OOB_NODE_NUM];
+    int         _oob_state;
+    int         _oob_resync;
+    char        _rx_block[AT_UART_RX_BLOCK_SIZE];
+    uint32_t    _rx_pos;
+    uint32_t    _rx_len;
     void *      at_uart_recv_mutex;
     void *      at_uart_send_mutex;
     void *      task_mutex;
@@ -308,6 +360,64 @@ static int at_recvfrom_lower(uart_dev_t *uart, void *data, uint32_t expect_size,
     return ret;
 }
 
+static int at_matcher_init(at_matcher_t *m, const char *pattern, int len)
+{
+    int i, k = 0;
+
+    if (len > AT_PATTERN_LEN_MAX) {
+        atpsr_err("pattern %s is longer than %d", pattern, AT_PATTERN_LEN_MAX);
+        return -1;
+    }
+
+    m->pattern = pattern;
+    m->len     = len;
+    m->state   = 0;
+    m->fail[0] = 0;
+    if (len > 0) {
+        m->fail[1] = 0;
+    }
+    for (i = 1; i < len; i++) {
+        while (k > 0 && pattern[i] != pattern[k]) {
+            k = m->fail[k];
+        }
+        if (pattern[i] == pattern[k]) {
+            k++;
+        }
+        m->fail[i + 1] = k;
+    }
+
+    return 0;
+}
+
+/* return 1 if bytes fed since last reset end with the pattern */
+static int at_matcher_reset(at_matcher_t *m)
+{
+    m->state = 0;
+    return m->len == 0;
+}
+
+static int at_matcher_step(at_matcher_t *m, char c)
+{
+    int state = m->state;
+
+    if (m->len == 0) {
+        return 1;
+    }
+
+    if (state == m->len) {
+        state = m->fail[state];
+    }
+    while (state > 0 && m->pattern[state] != c) {
+        state = m->fail[state];
+    }
+    if (m->pattern[state] == c) {
+        state++;
+    }
+    m->state = state;
+
+    return state == m->len;
+}
+
 #if AT_SINGLE_TASK
 int at_send_wait_reply(const char *cmd, int cmdlen, bool delimiter,
                        const char *data, int datalen,
@@ -432,6 +542,28 @@ int at_send_wait_reply(const char *cmd, int cmdlen, bool delimiter,
         }
     }
 
+    if (NULL == tsk->rsp_prefix || 0 == tsk->rsp_prefix_len) {
+        tsk->rsp_prefix     = at._default_recv_prefix;
+        tsk->rsp_prefix_len = at._recv_prefix_len;
+    }
+
+    if (NULL == tsk->rsp_success_postfix || 0 == tsk->rsp_success_postfix_len) {
+        tsk->rsp_success_postfix     = at._default_recv_success_postfix;
+        tsk->rsp_success_postfix_len = at._recv_success_postfix_len;
+    }
+
+    if (NULL == tsk->rsp_fail_postfix || 0 == tsk->rsp_fail_postfix_len) {
+        tsk->rsp_fail_postfix     = at._default_recv_fail_postfix;
+        tsk->rsp_fail_postfix_len = at._recv_fail_postfix_len;
+    }
+
+    if (at_matcher_init(&tsk->rsp_prefix_matcher, tsk->rsp_prefix, tsk->rsp_prefix_len) != 0 ||
+        at_matcher_init(&tsk->rsp_success_matcher, tsk->rsp_success_postfix, tsk->rsp_success_postfix_len) != 0 ||
+        at_matcher_init(&tsk->rsp_fail_matcher, tsk->rsp_fail_postfix, tsk->rsp_fail_postfix_len) != 0) {
+        ret = -1;
+        goto end;
+    }
+
     tsk->command = (char *)cmd;
     tsk->rsp     = replybuf;
     tsk->rsp_len = bufsize;
@@ -512,7 +644,7 @@ int at_send_no_reply(const char *data, int datalen, bool delimiter)
 static int at_getc(char *c, int timeout_ms)
 {
     int      ret = 0;
-    char     data;
+    int      got = 0;
     uint32_t recv_size = 0;
 
     if (NULL == c) {
@@ -525,25 +657,30 @@ static int at_getc(char *c, int timeout_ms)
     }
 
     HAL_MutexLock(at.at_uart_recv_mutex);
-    ret = at_recvfrom_lower(at._pstuart, (void *)&data, 1, &recv_size, timeout_ms);
+    if (at._rx_pos >= at._rx_len) {
+        /* take whatever uart has in one read, later bytes are served from the block,
+           bytes received before an error are kept as well */
+        at._rx_pos = 0;
+        at._rx_len = 0;
+        ret = at_recvfrom_lower(at._pstuart, (void *)at._rx_block, AT_UART_RX_BLOCK_SIZE,
+                                &recv_size, timeout_ms);
+        at._rx_len = recv_size > AT_UART_RX_BLOCK_SIZE ? AT_UART_RX_BLOCK_SIZE : recv_size;
+    }
+    if (at._rx_pos < at._rx_len) {
+        *c = at._rx_block[at._rx_pos++];
+        got = 1;
+    }
     HAL_MutexUnlock(at.at_uart_recv_mutex);
 
-    if (ret != 0) {
 #ifdef WORKAROUND_DEVELOPERBOARD_DMA_UART
-        if (ret == 1) {
-            HAL_UART_Deinit(at._pstuart);
-            at_init_uart();
-        }
-#endif
-        return -1;
+    if (ret == 1) {
+        HAL_UART_Deinit(at._pstuart);
+        at_init_uart();
     }
+#endif
 
-    if (recv_size == 1) {
-        *c = data;
-        return 0;
-    } else {
-        return -1;
-    }
+    /* a byte received before an error is still good */
+    return got ? 0 : -1;
 }
 
 int at_read(char *outbuf, int readsize)
@@ -557,6 +694,16 @@ int at_read(char *outbuf, int readsize)
     }
 
     HAL_MutexLock(at.at_uart_recv_mutex);
+    /* bytes already taken from uart by at_getc come first */
+    if (at._rx_pos < at._rx_len && readsize > 0) {
+        total_read = at._rx_len - at._rx_pos;
+        if (total_read > readsize) {
+            total_read = readsize;
+        }
+        memcpy(outbuf, at._rx_block + at._rx_pos, total_read);
+        at._rx_pos += total_read;
+    }
+
     while (total_read < readsize) {
         ret = at_recvfrom_lower(at._pstuart, (void *)(outbuf + total_read),
                                 readsize - total_read, &recv_size, at._timeout);
@@ -582,6 +729,84 @@ int at_read(char *outbuf, int readsize)
     return total_read;
 }
 
+static int at_oob_child(int node, char c)
+{
+    int child;
+
+    for (child = at._oob_nodes[node].child; child >= 0; child = at._oob_nodes[child].sibling) {
+        if (at._oob_nodes[child].ch == c) {
+            return child;
+        }
+    }
+
+    return -1;
+}
+
+static int at_oob_step(int state, char c)
+{
+    int next;
+
+    while ((next = at_oob_child(state, c)) < 0 && state != 0) {
+        state = at._oob_nodes[state].fail;
+    }
+
+    return next >= 0 ? next : 0;
+}
+
+/* build the automaton of all registered oob prefixes, so each received byte is matched once */
+static void at_oob_compile(void)
+{
+    oob_node_t *nodes = at._oob_nodes;
+    int16_t     queue[AT_OOB_NODE_NUM];
+    int         head = 0, tail = 0, count = 1;
+    int         k, i, node, child, fail;
+
+    nodes[0].ch      = 0;
+    nodes[0].out     = 0;
+    nodes[0].child   = -1;
+    nodes[0].sibling = -1;
+    nodes[0].fail    = 0;
+
+    for (k = 0; k < at._oobs_num; k++) {
+        node = 0;
+        for (i = 0; i < at._oobs[k].prefix_len; i++) {
+            child = at_oob_child(node, at._oobs[k].prefix[i]);
+            if (child < 0) {
+                child = count++;
+                nodes[child].ch      = at._oobs[k].prefix[i];
+                nodes[child].out     = 0;
+                nodes[child].child   = -1;
+                nodes[child].sibling = nodes[node].child;
+                nodes[child].fail    = 0;
+                nodes[node].child    = child;
+            }
+            node = child;
+        }
+        nodes[node].out |= (1 << k);
+    }
+
+    for (child = nodes[0].child; child >= 0; child = nodes[child].sibling) {
+        nodes[child].out |= nodes[0].out;
+        queue[tail++] = child;
+    }
+
+    while (head < tail) {
+        node = queue[head++];
+        for (child = nodes[node].child; child >= 0; child = nodes[child].sibling) {
+            fail = nodes[node].fail;
+            while ((k = at_oob_child(fail, nodes[child].ch)) < 0 && fail != 0) {
+                fail = nodes[fail].fail;
+            }
+            nodes[child].fail = k >= 0 ? k : 0;
+            nodes[child].out |= nodes[nodes[child].fail].out;
+            queue[tail++] = child;
+        }
+    }
+
+    /* received bytes are matched again against the new prefix set */
+    at._oob_resync = 1;
+}
+
 #define RECV_BUFFER_SIZE 512
 static char at_rx_buf[RECV_BUFFER_SIZE];
 int at_register_callback(const char *prefix, const char *postfix, char *recvbuf,
@@ -600,6 +825,11 @@ int at_register_callback(const char *prefix, const char *postfix, char *recvbuf,
         return -1;
     }
 
+    if (strlen(prefix) > AT_PATTERN_LEN_MAX) {
+        atpsr_err("%s prefix is too long \r\n", __func__);
+        return -1;
+    }
+
     if (at._oobs_num >= OOB_MAX) {
         atpsr_err("No place left in OOB.\r\n");
         return -1;
@@ -614,7 +844,13 @@ int at_register_callback(const char *prefix, const char *postfix, char *recvbuf,
         }
     }
 
-    oob = &(at._oobs[at._oobs_num++]);
+    oob = &(at._oobs[at._oobs_num]);
+
+    if (NULL != postfix &&
+        at_matcher_init(&oob->postfix_matcher, postfix, strlen(postfix)) != 0) {
+        return -1;
+    }
+    at._oobs_num++;
 
     oob->oobinputdata = recvbuf;
     if (oob->oobinputdata != NULL) {
@@ -622,11 +858,14 @@ int at_register_callback(const char *prefix, const char *postfix, char *recvbuf,
     }
     oob->maxlen  = bufsize;
     oob->prefix  = (char *)prefix;
+    oob->prefix_len = strlen(prefix);
     oob->postfix = (char *)postfix;
     oob->cb      = cb;
     oob->arg     = arg;
     oob->reallen = 0;
 
+    at_oob_compile();
+
     atpsr_debug("New oob registered (%s)", oob->prefix);
 
     return 0;
@@ -634,7 +873,9 @@ int at_register_callback(const char *prefix, const char *postfix, char *recvbuf,
 
 static void at_scan_for_callback(char c, char *buf, int *index)
 {
-    int     k;
+    int     k, i;
+    int     matched;
+    int     out;
     oob_t  *oob = NULL;
     int offset = *index;
 
@@ -642,12 +883,20 @@ static void at_scan_for_callback(char c, char *buf, int *index)
         return;
     }
 
+    if (at._oob_resync) {
+        at._oob_resync = 0;
+        at._oob_state  = 0;
+        for (i = 0; i < offset; i++) {
+            at._oob_state = at_oob_step(at._oob_state, buf[i]);
+        }
+    } else {
+        at._oob_state = at_oob_step(at._oob_state, c);
+    }
+    out = at._oob_nodes[at._oob_state].out;
+
     for (k = 0; k < at._oobs_num; k++) {
         oob = &(at._oobs[k]);
-        if (oob->reallen > 0 ||
-            (offset >= strlen(oob->prefix) &&
-             memcmp(oob->prefix, buf + offset - strlen(oob->prefix),
-                    strlen(oob->prefix)) == 0)) {
+        if (oob->reallen > 0 || (out & (1 << k))) {
             atpsr_debug("AT! %s\r\n", oob->prefix);
             if (oob->postfix == NULL) {
                 oob->cb(oob->arg, NULL, 0);
@@ -655,22 +904,24 @@ static void at_scan_for_callback(char c, char *buf, int *index)
                 offset = 0;
             } else {
                 if (oob->reallen == 0) {
-                    int len = strlen(oob->prefix) - 1;
+                    int len = oob->prefix_len - 1;
                     len = len > 0 ? len : 0;
                     memset(oob->oobinputdata, 0, oob->maxlen);
                     memcpy(oob->oobinputdata, oob->prefix, len);
                     oob->reallen += len;
+                    at_matcher_reset(&oob->postfix_matcher);
                 }
 
                 if (oob->reallen < oob->maxlen) {
                         oob->oobinputdata[oob->reallen] = c;
                         oob->reallen++;
-                        if ((oob->reallen >=
-                             strlen(oob->prefix) + strlen(oob->postfix)) &&
-                            (strncmp(oob->oobinputdata + oob->reallen -
-                                       strlen(oob->postfix),
-                                     oob->postfix,
-                                     strlen(oob->postfix)) == 0)) {
+                        /* postfix is looked for in bytes following the prefix only */
+                        if (oob->reallen > oob->prefix_len) {
+                            matched = at_matcher_step(&oob->postfix_matcher, c);
+                        } else {
+                            matched = (oob->postfix_matcher.len == 0);
+                        }
+                        if (matched) {
                             /*recv postfix*/
                             oob->cb(oob->arg, oob->oobinputdata, oob->reallen);
                             memset(oob->oobinputdata, 0, oob->reallen);
@@ -693,6 +944,12 @@ static void at_scan_for_callback(char c, char *buf, int *index)
                     offset = 0;
                 }
             }
+
+            if (offset == 0) {
+                /* buffer dropped, only empty prefix can match for the rest */
+                at._oob_state = 0;
+                out = at._oob_nodes[0].out;
+            }
             continue;
         }
     }
@@ -712,11 +969,17 @@ int at_yield(char *replybuf, int bufsize, const atcmd_config_t *atcmdconfig,
     int        rsp_fail_postfix_len    = 0;
     int        at_reply_begin          = 0;
     int        at_reply_offset         = 0;
+    int        prefix_matched          = 0;
+    int        success_matched         = 0;
+    int        fail_matched            = 0;
     char       c                       = 0;
     char      *buf                 = NULL;
     char      *rsp_prefix          = NULL;
     char      *rsp_success_postfix = NULL;
     char      *rsp_fail_postfix    = NULL;
+    at_matcher_t prefix_matcher;
+    at_matcher_t success_matcher;
+    at_matcher_t fail_matcher;
 
     if (!inited) {
         atpsr_err("AT parser has not inited!\r\n");
@@ -734,7 +997,38 @@ int at_yield(char *replybuf, int bufsize, const atcmd_config_t *atcmdconfig,
         return -1;
     }
 
+    if (NULL != atcmdconfig && NULL != atcmdconfig->reply_prefix) {
+        rsp_prefix     = atcmdconfig->reply_prefix;
+        rsp_prefix_len = strlen(rsp_prefix);
+    } else {
+        rsp_prefix     = at._default_recv_prefix;
+        rsp_prefix_len = at._recv_prefix_len;
+    }
+
+    if (NULL != atcmdconfig && NULL != atcmdconfig->reply_success_postfix) {
+        rsp_success_postfix     = atcmdconfig->reply_success_postfix;
+        rsp_success_postfix_len = strlen(rsp_success_postfix);
+    } else {
+        rsp_success_postfix     = at._default_recv_success_postfix;
+        rsp_success_postfix_len = at._recv_success_postfix_len;
+    }
+
+    if (NULL != atcmdconfig && NULL != atcmdconfig->reply_fail_postfix) {
+        rsp_fail_postfix     = atcmdconfig->reply_fail_postfix;
+        rsp_fail_postfix_len = strlen(rsp_fail_postfix);
+    } else {
+        rsp_fail_postfix     = at._default_recv_fail_postfix;
+        rsp_fail_postfix_len = at._recv_fail_postfix_len;
+    }
+
+    if (at_matcher_init(&prefix_matcher, rsp_prefix, rsp_prefix_len) != 0 ||
+        at_matcher_init(&success_matcher, rsp_success_postfix, rsp_success_postfix_len) != 0 ||
+        at_matcher_init(&fail_matcher, rsp_fail_postfix, rsp_fail_postfix_len) != 0) {
+        return -1;
+    }
+
     memset(buf, 0, RECV_BUFFER_SIZE);
+    at._oob_state = 0;
 
     while (true) {
         /* read from uart and store buf */
@@ -758,33 +1052,14 @@ int at_yield(char *replybuf, int bufsize, const atcmd_config_t *atcmdconfig,
             continue;
         }
 
-        if (NULL != atcmdconfig && NULL != atcmdconfig->reply_prefix) {
-            rsp_prefix     = atcmdconfig->reply_prefix;
-            rsp_prefix_len = strlen(rsp_prefix);
-        } else {
-            rsp_prefix     = at._default_recv_prefix;
-            rsp_prefix_len = at._recv_prefix_len;
-        }
-
-        if (NULL != atcmdconfig && NULL != atcmdconfig->reply_success_postfix) {
-            rsp_success_postfix     = atcmdconfig->reply_success_postfix;
-            rsp_success_postfix_len = strlen(rsp_success_postfix);
+        /* prefix is looked for in the receive buffer, which may have been dropped by oob */
+        if (offset == 0) {
+            prefix_matched = at_matcher_reset(&prefix_matcher);
         } else {
-            rsp_success_postfix     = at._default_recv_success_postfix;
-            rsp_success_postfix_len = at._recv_success_postfix_len;
+            prefix_matched = at_matcher_step(&prefix_matcher, c);
         }
 
-        if (NULL != atcmdconfig && NULL != atcmdconfig->reply_fail_postfix) {
-            rsp_fail_postfix     = atcmdconfig->reply_fail_postfix;
-            rsp_fail_postfix_len = strlen(rsp_fail_postfix);
-        } else {
-            rsp_fail_postfix     = at._default_recv_fail_postfix;
-            rsp_fail_postfix_len = at._recv_fail_postfix_len;
-        }
-
-        if (offset >= rsp_prefix_len && at_reply_begin == 0 &&
-            (strncmp(buf + offset - rsp_prefix_len, rsp_prefix,
-                     rsp_prefix_len) == 0)) {
+        if (prefix_matched && at_reply_begin == 0) {
             at_reply_begin = 1;
         }
 
@@ -793,13 +1068,9 @@ int at_yield(char *replybuf, int bufsize, const atcmd_config_t *atcmdconfig,
                 replybuf[at_reply_offset] = c;
                 at_reply_offset++;
 
-                if ((at_reply_offset >= rsp_success_postfix_len &&
-                     strncmp(
-                       replybuf + at_reply_offset - rsp_success_postfix_len,
-                       rsp_success_postfix, rsp_success_postfix_len) == 0) ||
-                    (at_reply_offset >= rsp_fail_postfix_len &&
-                     strncmp(replybuf + at_reply_offset - rsp_fail_postfix_len,
-                             rsp_fail_postfix, rsp_fail_postfix_len) == 0)) {
+                success_matched = at_matcher_step(&success_matcher, c);
+                fail_matched    = at_matcher_step(&fail_matcher, c);
+                if (success_matched || fail_matched) {
                     return 0;
                 }
             } else {
@@ -818,17 +1089,20 @@ static void* at_worker(void *arg)
 {
     int        offset                  = 0;
     int        ret                     = 0;
+    int        i                       = 0;
     int        at_task_empty           = 0;
     int        at_task_reponse_begin   = 0;
     int        memcpy_size             = 0;
     int        rsp_prefix_len          = 0;
     int        rsp_success_postfix_len = 0;
     int        rsp_fail_postfix_len    = 0;
+    int        rx_truncated            = 0;
+    int        prefix_matched          = 0;
+    int        success_matched         = 0;
+    int        fail_matched            = 0;
     char       c                       = 0;
     at_task_t *tsk;
     char      *buf                 = NULL;
-    char      *rsp_prefix          = NULL;
-    char      *rsp_success_postfix = NULL;
     char      *rsp_fail_postfix    = NULL;
 
     atpsr_debug("at_work started.");
@@ -871,34 +1145,27 @@ static void* at_worker(void *arg)
             goto check_buffer;
         }
 
-        if (NULL != tsk->rsp_prefix && 0 != tsk->rsp_prefix_len) {
-            rsp_prefix     = tsk->rsp_prefix;
-            rsp_prefix_len = tsk->rsp_prefix_len;
-        } else {
-            rsp_prefix     = at._default_recv_prefix;
-            rsp_prefix_len = at._recv_prefix_len;
-        }
-
-        if (NULL != tsk->rsp_success_postfix &&
-            0 != tsk->rsp_success_postfix_len) {
-            rsp_success_postfix     = tsk->rsp_success_postfix;
-            rsp_success_postfix_len = tsk->rsp_success_postfix_len;
-        } else {
-            rsp_success_postfix     = at._default_recv_success_postfix;
-            rsp_success_postfix_len = at._recv_success_postfix_len;
-        }
-
-        if (NULL != tsk->rsp_fail_postfix && 0 != tsk->rsp_fail_postfix_len) {
-            rsp_fail_postfix     = tsk->rsp_fail_postfix;
-            rsp_fail_postfix_len = tsk->rsp_fail_postfix_len;
+        /* delimiters were chosen when the task was queued */
+        rsp_prefix_len          = tsk->rsp_prefix_len;
+        rsp_success_postfix_len = tsk->rsp_success_postfix_len;
+        rsp_fail_postfix     = tsk->rsp_fail_postfix;
+        rsp_fail_postfix_len = tsk->rsp_fail_postfix_len;
+
+        /* prefix is looked for in the receive buffer, which may hold bytes older than the task */
+        if (tsk->rsp_prefix_synced == 0 || rx_truncated) {
+            prefix_matched = at_matcher_reset(&tsk->rsp_prefix_matcher);
+            for (i = 0; i < offset; i++) {
+                prefix_matched = at_matcher_step(&tsk->rsp_prefix_matcher, buf[i]);
+            }
+            tsk->rsp_prefix_synced = 1;
+            rx_truncated = 0;
+        } else if (offset == 0) {
+            prefix_matched = at_matcher_reset(&tsk->rsp_prefix_matcher);
         } else {
-            rsp_fail_postfix     = at._default_recv_fail_postfix;
-            rsp_fail_postfix_len = at._recv_fail_postfix_len;
+            prefix_matched = at_matcher_step(&tsk->rsp_prefix_matcher, c);
         }
 
-        if (offset >= rsp_prefix_len && at_task_reponse_begin == 0 &&
-            (strncmp(buf + offset - rsp_prefix_len, rsp_prefix,
-                     rsp_prefix_len) == 0)) {
+        if (prefix_matched && at_task_reponse_begin == 0) {
             at_task_reponse_begin = 1;
         }
 
@@ -907,13 +1174,9 @@ static void* at_worker(void *arg)
                 tsk->rsp[tsk->rsp_offset] = c;
                 tsk->rsp_offset++;
 
-                if ((tsk->rsp_offset >= rsp_success_postfix_len &&
-                     strncmp(
-                       tsk->rsp + tsk->rsp_offset - rsp_success_postfix_len,
-                       rsp_success_postfix, rsp_success_postfix_len) == 0) ||
-                    (tsk->rsp_offset >= rsp_fail_postfix_len &&
-                     strncmp(tsk->rsp + tsk->rsp_offset - rsp_fail_postfix_len,
-                             rsp_fail_postfix, rsp_fail_postfix_len) == 0)) {
+                success_matched = at_matcher_step(&tsk->rsp_success_matcher, c);
+                fail_matched    = at_matcher_step(&tsk->rsp_fail_matcher, c);
+                if (success_matched || fail_matched) {
                     HAL_SemaphorePost(tsk->smpr);
                     at_task_reponse_begin = 0;
                     memset(buf, 0, offset);
@@ -940,6 +1203,9 @@ static void* at_worker(void *arg)
             memcpy(buf, buf + offset - memcpy_size, memcpy_size);
             memset(buf + memcpy_size, 0, offset - memcpy_size);
             offset = memcpy_size;
+            /* matching state no longer reflects the buffer, rebuild it from what is kept */
+            at._oob_resync = 1;
+            rx_truncated = 1;
         }
     }
 
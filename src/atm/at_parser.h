@@ -9,7 +9,9 @@
 
 /* uart config */
 #define AT_UART_PORT 1
+#ifndef AT_UART_LINUX_DEV
 #define AT_UART_LINUX_DEV    "/dev/ttyUSB0"
+#endif
 #define AT_UART_BAUDRATE     115200
 #define AT_UART_DATA_WIDTH   DATA_WIDTH_8BIT
 #define AT_UART_PARITY       NO_PARITY
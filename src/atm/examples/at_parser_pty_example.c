@@ -0,0 +1,220 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+/*
+ * Loopback modem on a Linux pseudo-terminal, for measuring how fast the AT parser takes
+ * oob lines off the uart. The modem side writes "+IPD,<seq>,<payload>\r\n" lines into the
+ * pty master, the parser reads the slave through HAL_AT_Uart_Recv, as it reads a real modem.
+ *
+ * AT_UART_LINUX_DEV is made a link to the pty slave, so build with a path of your own, e.g.
+ *     -DAT_UART_LINUX_DEV=\"/tmp/ttyAT0\"
+ *
+ * usage: at-parser-pty-example [lines] [baud]
+ *     lines  number of oob lines sent by modem, 20000 by default
+ *     baud   pace of modem in bits per second, 0 (default) sends as fast as the pty takes
+ */
+
+#define _XOPEN_SOURCE 600
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <sys/stat.h>
+
+#include "infra_types.h"
+#include "infra_defs.h"
+#include "wrappers_defs.h"
+#include "at_parser.h"
+
+#define EXAMPLE_OOB_PREFIX      "+IPD,"
+#define EXAMPLE_OOB_POSTFIX     "\r\n"
+#define EXAMPLE_PAYLOAD         "{\"temperature\":23.5,\"humidity\":41}"
+#define EXAMPLE_LINE_MAXLEN     128
+#define EXAMPLE_IDLE_MS         3000
+
+void HAL_Printf(const char *fmt, ...);
+void HAL_SleepMs(uint32_t ms);
+int HAL_Snprintf(char *str, const int len, const char *fmt, ...);
+uint64_t HAL_UptimeMs(void);
+int HAL_ThreadCreate(void **thread_handle, void *(*work_routine)(void *), void *arg,
+                     hal_os_thread_param_t *hal_os_thread_param, int *stack_used);
+
+static int      g_modem_fd = -1;
+static int      g_lines = 20000;
+static int      g_baud = 0;
+static int      g_modem_done = 0;
+static uint64_t g_modem_bytes = 0;
+
+static int      g_recv_lines = 0;
+static int      g_recv_lost = 0;
+static int      g_recv_bad = 0;
+static int      g_recv_next = 0;
+static uint64_t g_recv_last_ms = 0;
+static char     g_oob_buf[EXAMPLE_LINE_MAXLEN];
+
+static void example_oob_cb(void *arg, char *buf, int buflen)
+{
+    int seq;
+
+    g_recv_last_ms = HAL_UptimeMs();
+    if (buflen < (int)strlen(EXAMPLE_OOB_PREFIX) + (int)strlen(EXAMPLE_PAYLOAD) + 2 ||
+        strstr(buf, EXAMPLE_PAYLOAD) == NULL) {
+        g_recv_bad++;
+        return;
+    }
+
+    seq = atoi(buf + strlen(EXAMPLE_OOB_PREFIX));
+    if (seq < g_recv_next) {
+        g_recv_bad++;
+        return;
+    }
+    g_recv_lost += seq - g_recv_next;
+    g_recv_next = seq + 1;
+    g_recv_lines++;
+}
+
+static void *example_modem(void *arg)
+{
+    char     line[EXAMPLE_LINE_MAXLEN];
+    int      seq, len, sent, ret;
+    uint64_t start = HAL_UptimeMs();
+
+    for (seq = 0; seq < g_lines; seq++) {
+        len = HAL_Snprintf(line, sizeof(line), "%s%06d,%s%s", EXAMPLE_OOB_PREFIX, seq,
+                           EXAMPLE_PAYLOAD, EXAMPLE_OOB_POSTFIX);
+        for (sent = 0; sent < len; sent += ret) {
+            ret = write(g_modem_fd, line + sent, len - sent);
+            if (ret < 0) {
+                if (errno == EINTR || errno == EAGAIN) {
+                    ret = 0;
+                    continue;
+                }
+                HAL_Printf("modem write failed, errno %d\n", errno);
+                g_modem_done = 1;
+                return NULL;
+            }
+        }
+        g_modem_bytes += len;
+
+        /* 10 bits per byte on the wire, hold back while ahead of the baud rate */
+        while (g_baud > 0 && g_modem_bytes * 10 * 1000 / g_baud > HAL_UptimeMs() - start) {
+            HAL_SleepMs(1);
+        }
+    }
+
+    g_modem_done = 1;
+    return NULL;
+}
+
+static int example_modem_open(void)
+{
+    struct termios t_opt;
+    struct stat    st;
+    char          *slave;
+
+    g_modem_fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (g_modem_fd < 0 || grantpt(g_modem_fd) != 0 || unlockpt(g_modem_fd) != 0) {
+        HAL_Printf("open pty failed, errno %d\n", errno);
+        return -1;
+    }
+
+    /* modem side passes bytes as they are */
+    if (tcgetattr(g_modem_fd, &t_opt) == 0) {
+        t_opt.c_iflag &= ~(IXON | IXOFF | IXANY | INLCR | ICRNL);
+        t_opt.c_oflag &= ~OPOST;
+        t_opt.c_lflag &= ~(ECHO | ECHOE | ISIG | ICANON);
+        tcsetattr(g_modem_fd, TCSANOW, &t_opt);
+    }
+
+    slave = ptsname(g_modem_fd);
+    if (slave == NULL) {
+        return -1;
+    }
+
+    /* never replace a real device */
+    if (lstat(AT_UART_LINUX_DEV, &st) == 0) {
+        if (!S_ISLNK(st.st_mode)) {
+            HAL_Printf("%s exists and is not a link, build with another AT_UART_LINUX_DEV\n",
+                       AT_UART_LINUX_DEV);
+            return -1;
+        }
+        unlink(AT_UART_LINUX_DEV);
+    }
+    if (symlink(slave, AT_UART_LINUX_DEV) != 0) {
+        HAL_Printf("link %s to %s failed, errno %d\n", AT_UART_LINUX_DEV, slave, errno);
+        return -1;
+    }
+
+    HAL_Printf("modem on %s, linked from %s\n", slave, AT_UART_LINUX_DEV);
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    void    *modem_thread = NULL;
+    uint64_t start, elapsed;
+    int      res = -1;
+
+    if (argc > 1) {
+        g_lines = atoi(argv[1]);
+    }
+    if (argc > 2) {
+        g_baud = atoi(argv[2]);
+    }
+
+    if (example_modem_open() != 0) {
+        return -1;
+    }
+
+    if (at_parser_init() != 0) {
+        HAL_Printf("at_parser_init failed\n");
+        goto out;
+    }
+
+    if (at_register_callback(EXAMPLE_OOB_PREFIX, EXAMPLE_OOB_POSTFIX, g_oob_buf, sizeof(g_oob_buf),
+                             example_oob_cb, NULL) != 0) {
+        HAL_Printf("at_register_callback failed\n");
+        goto out;
+    }
+
+    start = HAL_UptimeMs();
+    g_recv_last_ms = start;
+    if (HAL_ThreadCreate(&modem_thread, example_modem, NULL, NULL, NULL) != 0) {
+        HAL_Printf("create modem thread failed\n");
+        goto out;
+    }
+
+    /* stop once every line is in, or nothing arrived for a while after modem is done */
+    while (g_recv_lines + g_recv_lost < g_lines) {
+        if (g_modem_done && HAL_UptimeMs() - g_recv_last_ms > EXAMPLE_IDLE_MS) {
+            break;
+        }
+#if AT_SINGLE_TASK
+        at_yield(NULL, 0, NULL, 100);
+#else
+        HAL_SleepMs(10);
+#endif
+    }
+    elapsed = g_recv_last_ms - start;
+    if (elapsed == 0) {
+        elapsed = 1;
+    }
+
+    HAL_Printf("sent     : %d lines, %d bytes, baud %d\n", g_lines, (int)g_modem_bytes, g_baud);
+    HAL_Printf("received : %d lines in %d ms, %d lost, %d bad\n",
+               g_recv_lines, (int)elapsed, g_recv_lost + (g_lines - g_recv_next), g_recv_bad);
+    HAL_Printf("rate     : %d lines/s, %d bytes/s\n", (int)(g_recv_lines * 1000 / elapsed),
+               (int)(g_modem_bytes * 1000 / elapsed));
+
+    res = (g_recv_lines == g_lines && g_recv_bad == 0) ? 0 : -1;
+
+out:
+    unlink(AT_UART_LINUX_DEV);
+    close(g_modem_fd);
+    return res;
+}
@@ -17,3 +17,9 @@ ifneq (,$(filter -DAT_PARSER_ENABLED, $(CFLAGS)))
 LIB_SRCS_PATTERN += at_parser.c
 endif
 endif
+
+SRCS_at-parser-pty-example := examples/at_parser_pty_example.c
+$(call Append_Conditional, TARGET, at-parser-pty-example, AT_PARSER_ENABLED, BUILD_AOS NO_EXECUTABLES)
+
+DEPENDS         += wrappers
+LDFLAGS         += -liot_sdk -liot_hal -liot_tls
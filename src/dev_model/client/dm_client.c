@@ -37,6 +37,7 @@ static dm_client_uri_map_t g_dm_client_uri_map[] = {
     {DM_URI_THING_TOPO_GET_REPLY,             DM_URI_SYS_PREFIX,         IOTX_DM_DEVICE_GATEWAY, (void *)dm_client_thing_topo_get_reply               },
     {DM_URI_THING_LIST_FOUND_REPLY,           DM_URI_SYS_PREFIX,         IOTX_DM_DEVICE_GATEWAY, (void *)dm_client_thing_list_found_reply             },
     {DM_URI_COMBINE_LOGIN_REPLY,              DM_URI_EXT_SESSION_PREFIX, IOTX_DM_DEVICE_GATEWAY, (void *)dm_client_combine_login_reply                },
+    {DM_URI_COMBINE_BATCH_LOGIN_REPLY,        DM_URI_EXT_SESSION_PREFIX, IOTX_DM_DEVICE_GATEWAY, (void *)dm_client_combine_batch_login_reply          },
     {DM_URI_COMBINE_LOGOUT_REPLY,             DM_URI_EXT_SESSION_PREFIX, IOTX_DM_DEVICE_GATEWAY, (void *)dm_client_combine_logout_reply               },
     {DM_URI_THING_DISABLE,                    DM_URI_SYS_PREFIX,         IOTX_DM_DEVICE_GATEWAY, (void *)dm_client_thing_disable                      },
     {DM_URI_THING_ENABLE,                     DM_URI_SYS_PREFIX,         IOTX_DM_DEVICE_GATEWAY, (void *)dm_client_thing_enable                       },
@@ -69,8 +70,21 @@ static int _dm_client_subscribe_filter(char *uri, char *uri_name, char product_k
     return SUCCESS_RETURN;
 }
 
-int dm_client_subscribe_all(char product_key[IOTX_PRODUCT_KEY_LEN + 1], char device_name[IOTX_DEVICE_NAME_LEN + 1],
-                            int dev_type)
+/* subscribe and wait for SUBACK, or only track it for @devid if it is not negative */
+static int _dm_client_subscribe(char *uri, iotx_cm_data_handle_cb callback, uint8_t *local_sub, int devid)
+{
+#ifdef DEVICE_MODEL_GATEWAY
+    /* local subscription has no SUBACK */
+    if (devid >= 0 && (local_sub == NULL || *local_sub == 0)) {
+        return dm_client_subscribe_async(uri, callback, devid);
+    }
+#endif
+
+    return dm_client_subscribe(uri, callback, local_sub);
+}
+
+static int _dm_client_subscribe_all(char product_key[IOTX_PRODUCT_KEY_LEN + 1],
+                                    char device_name[IOTX_DEVICE_NAME_LEN + 1], int dev_type, int devid)
 {
     int res = 0, index = 0, fail_count = 0;
     int number = sizeof(g_dm_client_uri_map) / sizeof(dm_client_uri_map_t);
@@ -96,7 +110,7 @@ int dm_client_subscribe_all(char product_key[IOTX_PRODUCT_KEY_LEN + 1], char dev
             continue;
         }
 
-        res = dm_client_subscribe(uri, (iotx_cm_data_handle_cb)g_dm_client_uri_map[0].callback, 0);
+        res = _dm_client_subscribe(uri, (iotx_cm_data_handle_cb)g_dm_client_uri_map[0].callback, NULL, devid);
         if (res < SUCCESS_RETURN) {
             DM_free(uri);
             continue;
@@ -140,7 +154,7 @@ int dm_client_subscribe_all(char product_key[IOTX_PRODUCT_KEY_LEN + 1], char dev
             continue;
         }
 
-        res = dm_client_subscribe(uri, (iotx_cm_data_handle_cb)g_dm_client_uri_map[index].callback, &local_sub);
+        res = _dm_client_subscribe(uri, (iotx_cm_data_handle_cb)g_dm_client_uri_map[index].callback, &local_sub, devid);
         if (res < SUCCESS_RETURN) {
             index--;
             fail_count++;
@@ -159,6 +173,20 @@ int dm_client_subscribe_all(char product_key[IOTX_PRODUCT_KEY_LEN + 1], char dev
     return SUCCESS_RETURN;
 }
 
+int dm_client_subscribe_all(char product_key[IOTX_PRODUCT_KEY_LEN + 1], char device_name[IOTX_DEVICE_NAME_LEN + 1],
+                            int dev_type)
+{
+    return _dm_client_subscribe_all(product_key, device_name, dev_type, -1);
+}
+
+#ifdef DEVICE_MODEL_GATEWAY
+int dm_client_subscribe_all_async(char product_key[IOTX_PRODUCT_KEY_LEN + 1],
+                                  char device_name[IOTX_DEVICE_NAME_LEN + 1], int dev_type, int devid)
+{
+    return _dm_client_subscribe_all(product_key, device_name, dev_type, devid);
+}
+#endif
+
 static void _dm_client_event_cloud_connected_handle(void)
 {
     dm_log_info("IOTX_CM_EVENT_CLOUD_CONNECTED");
@@ -191,6 +219,13 @@ void dm_client_event_handle(int fd, iotx_cm_event_msg_t *event, void *context)
             _dm_client_event_cloud_disconnect_handle();
         }
         break;
+#ifdef DEVICE_MODEL_GATEWAY
+        case IOTX_CM_EVENT_SUBCRIBE_SUCCESS:
+        case IOTX_CM_EVENT_SUBCRIBE_FAILED: {
+            dm_client_suback_handle((int)(uintptr_t)event->msg, event->type == IOTX_CM_EVENT_SUBCRIBE_SUCCESS);
+        }
+        break;
+#endif
         default:
             break;
     }
@@ -721,6 +756,21 @@ void dm_client_combine_login_reply(int fd, const char *topic, const char *payloa
     dm_msg_proc_combine_login_reply(&source);
 }
 
+void dm_client_combine_batch_login_reply(int fd, const char *topic, const char *payload, unsigned int payload_len,
+        void *context)
+{
+    dm_msg_source_t source;
+
+    memset(&source, 0, sizeof(dm_msg_source_t));
+
+    source.uri = topic;
+    source.payload = (unsigned char *)payload;
+    source.payload_len = payload_len;
+    source.context = NULL;
+
+    dm_msg_proc_combine_batch_login_reply(&source);
+}
+
 void dm_client_combine_logout_reply(int fd, const char *topic, const char *payload, unsigned int payload_len,
                                     void *context)
 {
@@ -11,6 +11,11 @@ typedef struct {
 void dm_client_event_handle(int fd, iotx_cm_event_msg_t *event, void *context);
 
 int dm_client_subscribe_all(char product_key[IOTX_PRODUCT_KEY_LEN + 1], char device_name[IOTX_DEVICE_NAME_LEN + 1], int dev_type);
+#ifdef DEVICE_MODEL_GATEWAY
+/* SUBACKs are not waited for but collected for @devid, see dm_client_suback_result() */
+int dm_client_subscribe_all_async(char product_key[IOTX_PRODUCT_KEY_LEN + 1],
+                                  char device_name[IOTX_DEVICE_NAME_LEN + 1], int dev_type, int devid);
+#endif
 
 void dm_client_thing_model_down_raw(int fd, const char *topic, const char *payload, unsigned int payload_len,
                                     void *context);
@@ -69,6 +74,8 @@ void dm_client_thing_list_found_reply(int fd, const char *topic, const char *pay
                                       void *context);
 void dm_client_combine_login_reply(int fd, const char *topic, const char *payload, unsigned int payload_len,
                                    void *context);
+void dm_client_combine_batch_login_reply(int fd, const char *topic, const char *payload, unsigned int payload_len,
+        void *context);
 void dm_client_combine_logout_reply(int fd, const char *topic, const char *payload, unsigned int payload_len,
                                     void *context);
 #endif
@@ -16,6 +16,14 @@ int dm_client_open(void)
     memset(ctx, 0, sizeof(dm_client_ctx_t));
     memset(&cm_param, 0, sizeof(iotx_cm_init_param_t));
 
+#ifdef DEVICE_MODEL_GATEWAY
+    ctx->suback_mutex = HAL_MutexCreate();
+    if (ctx->suback_mutex == NULL) {
+        return DM_MEMORY_NOT_ENOUGH;
+    }
+    INIT_LIST_HEAD(&ctx->suback_list);
+#endif
+
     cm_param.request_timeout_ms = IOTX_DM_CLIENT_REQUEST_TIMEOUT_MS;
     cm_param.keepalive_interval_ms = IOTX_DM_CLIENT_KEEPALIVE_INTERVAL_MS;
     cm_param.write_buf_size = CONFIG_MQTT_TX_MAXLEN;
@@ -30,6 +38,10 @@ int dm_client_open(void)
     res = iotx_cm_open(&cm_param);
 
     if (res < SUCCESS_RETURN) {
+#ifdef DEVICE_MODEL_GATEWAY
+        HAL_MutexDestroy(ctx->suback_mutex);
+        ctx->suback_mutex = NULL;
+#endif
         return res;
     }
     ctx->fd = res;
@@ -54,9 +66,25 @@ int dm_client_connect(int timeout_ms)
 
 int dm_client_close(void)
 {
+    int res = 0;
     dm_client_ctx_t *ctx = dm_client_get_ctx();
 
-    return iotx_cm_close(ctx->fd);
+    res = iotx_cm_close(ctx->fd);
+
+#ifdef DEVICE_MODEL_GATEWAY
+    if (ctx->suback_mutex != NULL) {
+        dm_client_suback_t *node = NULL, *next_node = NULL;
+
+        list_for_each_entry_safe(node, next_node, &ctx->suback_list, linked_list, dm_client_suback_t) {
+            list_del(&node->linked_list);
+            DM_free(node);
+        }
+        HAL_MutexDestroy(ctx->suback_mutex);
+        ctx->suback_mutex = NULL;
+    }
+#endif
+
+    return res;
 }
 
 int dm_client_subscribe(char *uri, iotx_cm_data_handle_cb callback, void *context)
@@ -143,3 +171,108 @@ int dm_client_yield(unsigned int timeout)
 
     return iotx_cm_yield(ctx->fd, timeout);
 }
+
+#ifdef DEVICE_MODEL_GATEWAY
+#if defined(COAP_COMM_ENABLED) && !defined(MQTT_COMM_ENABLED)
+int dm_client_subscribe_async(char *uri, iotx_cm_data_handle_cb callback, int devid)
+{
+    /* no SUBACK to wait for */
+    return dm_client_subscribe(uri, callback, NULL);
+}
+#else
+int dm_client_subscribe_async(char *uri, iotx_cm_data_handle_cb callback, int devid)
+{
+    int res = 0;
+    dm_client_ctx_t *ctx = dm_client_get_ctx();
+    iotx_cm_ext_params_t sub_params;
+    dm_client_suback_t *node = NULL;
+
+    node = DM_malloc(sizeof(dm_client_suback_t));
+    if (node == NULL) {
+        return DM_MEMORY_NOT_ENOUGH;
+    }
+    memset(node, 0, sizeof(dm_client_suback_t));
+    node->devid = devid;
+
+    memset(&sub_params, 0, sizeof(iotx_cm_ext_params_t));
+    sub_params.ack_type = IOTX_CM_MESSAGE_NO_ACK;
+    sub_params.sync_mode = IOTX_CM_ASYNC;
+
+    /* a SUBACK read by another thread waits until its packet id is in list */
+    HAL_MutexLock(ctx->suback_mutex);
+    res = iotx_cm_sub(ctx->fd, &sub_params, (const char *)uri, callback, NULL);
+    dm_log_info("Subscribe Result: %d", res);
+    if (res <= 0) {
+        HAL_MutexUnlock(ctx->suback_mutex);
+        DM_free(node);
+        return (res < SUCCESS_RETURN) ? res : FAIL_RETURN;
+    }
+    node->packet_id = res;
+    list_add_tail(&node->linked_list, &ctx->suback_list);
+    HAL_MutexUnlock(ctx->suback_mutex);
+
+    return SUCCESS_RETURN;
+}
+#endif
+
+void dm_client_suback_handle(int packet_id, int success)
+{
+    dm_client_ctx_t *ctx = dm_client_get_ctx();
+    dm_client_suback_t *node = NULL;
+
+    if (ctx->suback_mutex == NULL) {
+        return;
+    }
+
+    HAL_MutexLock(ctx->suback_mutex);
+    list_for_each_entry(node, &ctx->suback_list, linked_list, dm_client_suback_t) {
+        if (node->packet_id == packet_id && node->acked == 0) {
+            node->acked = 1;
+            node->failed = !success;
+            break;
+        }
+    }
+    HAL_MutexUnlock(ctx->suback_mutex);
+}
+
+int dm_client_suback_result(int devid)
+{
+    int res = SUCCESS_RETURN;
+    dm_client_ctx_t *ctx = dm_client_get_ctx();
+    dm_client_suback_t *node = NULL;
+
+    HAL_MutexLock(ctx->suback_mutex);
+    list_for_each_entry(node, &ctx->suback_list, linked_list, dm_client_suback_t) {
+        if (node->devid != devid) {
+            continue;
+        }
+        if (node->acked == 0) {
+            HAL_MutexUnlock(ctx->suback_mutex);
+            return 1;
+        }
+        if (node->failed) {
+            res = FAIL_RETURN;
+        }
+    }
+    HAL_MutexUnlock(ctx->suback_mutex);
+
+    dm_client_suback_cancel(devid);
+
+    return res;
+}
+
+void dm_client_suback_cancel(int devid)
+{
+    dm_client_ctx_t *ctx = dm_client_get_ctx();
+    dm_client_suback_t *node = NULL, *next_node = NULL;
+
+    HAL_MutexLock(ctx->suback_mutex);
+    list_for_each_entry_safe(node, next_node, &ctx->suback_list, linked_list, dm_client_suback_t) {
+        if (node->devid == devid) {
+            list_del(&node->linked_list);
+            DM_free(node);
+        }
+    }
+    HAL_MutexUnlock(ctx->suback_mutex);
+}
+#endif
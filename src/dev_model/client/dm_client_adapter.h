@@ -1,10 +1,25 @@
 #ifndef _DM_CLIENT_ADAPTER_H_
 #define _DM_CLIENT_ADAPTER_H_
 
+#ifdef DEVICE_MODEL_GATEWAY
+/* SUBACK a device subscribing with dm_client_subscribe_async() waits for */
+typedef struct {
+    int packet_id;
+    int devid;
+    int acked;
+    int failed;
+    struct list_head linked_list;
+} dm_client_suback_t;
+#endif
+
 typedef struct {
     int fd;
     iotx_conn_info_t *conn_info;
     void *callback;
+#ifdef DEVICE_MODEL_GATEWAY
+    void *suback_mutex;         /* guards suback_list, held from sending SUBSCRIBE until its SUBACK is tracked */
+    struct list_head suback_list;
+#endif
 } dm_client_ctx_t;
 
 int dm_client_open(void);
@@ -15,4 +30,14 @@ int dm_client_unsubscribe(char *uri);
 int dm_client_publish(char *uri, unsigned char *payload, int payload_len, iotx_cm_data_handle_cb callback);
 int dm_client_yield(unsigned int timeout);
 
+#ifdef DEVICE_MODEL_GATEWAY
+/* subscribe without waiting for SUBACK, which is collected for @devid by dm_client_suback_result() */
+int dm_client_subscribe_async(char *uri, iotx_cm_data_handle_cb callback, int devid);
+void dm_client_suback_handle(int packet_id, int success);
+
+/* 1 while SUBACK of @devid is pending, then SUCCESS_RETURN or FAIL_RETURN, records of @devid are dropped unless pending */
+int dm_client_suback_result(int devid);
+void dm_client_suback_cancel(int devid);
+#endif
+
 #endif
\ No newline at end of file
@@ -100,6 +100,85 @@ DLL_IOT_API int IOT_Linkkit_Open(iotx_linkkit_dev_type_t dev_type, iotx_linkkit_
  */
 DLL_IOT_API int IOT_Linkkit_Connect(int devid);
 
+/**
+ * @brief result of one slave device of IOT_Linkkit_Connect_Batch()
+ *
+ * @param devid. device identifier.
+ * @param result. 0 when device is added to topo of master and logged in, -1 otherwise.
+ * @param user_data. user_data given to IOT_Linkkit_Connect_Batch().
+ *
+ */
+typedef void (*iotx_linkkit_batch_cb_t)(int devid, int result, void *user_data);
+
+/**
+ * @brief only for master device, connect and login many slave devices at once.
+ *        slave devices without device secret are registered first, then added to topo with master device
+ *        and logged in by batch requests, CONFIG_LINKKIT_BATCH_DEVICES devices in one request and
+ *        CONFIG_LINKKIT_BATCH_INFLIGHT requests waiting for reply at a time.
+ *        a slave device logged in is ready as if IOT_Linkkit_Connect() and IOT_Linkkit_Report(ITM_MSG_LOGIN) were done.
+ *
+ * @param devids. slave devices created by IOT_Linkkit_Open().
+ * @param devid_num. number of devids.
+ * @param callback. called once for each device when its result is known, can be NULL.
+ * @param user_data. passed to callback.
+ *
+ * @return success: number of devices logged in (>=0), fail: -1.
+ *
+ */
+DLL_IOT_API int IOT_Linkkit_Connect_Batch(int *devids, int devid_num, iotx_linkkit_batch_cb_t callback,
+        void *user_data);
+
+typedef enum {
+    /* only for slave device without device secret, register it to get one */
+    IOTX_LINKKIT_REQUEST_REGISTER,
+
+    /* only for slave device, add topo with master device */
+    IOTX_LINKKIT_REQUEST_TOPO_ADD,
+
+    /* only for slave device, delete topo with master device */
+    IOTX_LINKKIT_REQUEST_TOPO_DELETE,
+
+    /* only for slave device, login, it is subscribed and reported with ITE_INITIALIZE_COMPLETED when done */
+    IOTX_LINKKIT_REQUEST_LOGIN,
+
+    /* only for slave device, logout */
+    IOTX_LINKKIT_REQUEST_LOGOUT,
+
+    IOTX_LINKKIT_REQUEST_MAX
+} iotx_linkkit_request_type_t;
+
+/**
+ * @brief completion of one request of IOT_Linkkit_Request_Async()
+ *
+ * @param devid. device identifier.
+ * @param request_id. id returned by IOT_Linkkit_Request_Async().
+ * @param result. 0 when cloud accepted the request, -1 if it refused or did not reply in time.
+ * @param user_data. user_data given to IOT_Linkkit_Request_Async().
+ *
+ */
+typedef void (*iotx_linkkit_request_cb_t)(int devid, int request_id, int result, void *user_data);
+
+/**
+ * @brief only for master device, send request of slave device without waiting for its reply.
+ *        callback is called from IOT_Linkkit_Yield() once reply arrives or after 10s without one,
+ *        so one thread can keep many requests in flight and callback can send the next request of device.
+ *        topo requests fail at once when CONFIG_MSGCACHE_QUEUE_MAXLEN replies are awaited already,
+ *        and replies beyond CONFIG_DISPATCH_QUEUE_MAXLEN arriving within one yield are lost,
+ *        so raise both to keep hundreds of requests in flight.
+ *        callbacks of requests in flight are dropped when master device is closed.
+ *
+ * @param devid. slave device identifier.
+ * @param type. request to send, see iotx_linkkit_request_type_t.
+ * @param callback. called once with result of request, can be NULL.
+ * @param user_data. passed to callback.
+ *
+ * @return success: request id (>0), or 0 for IOTX_LINKKIT_REQUEST_REGISTER of device having device secret already,
+ *         in which case callback is not called. fail: -1.
+ *
+ */
+DLL_IOT_API int IOT_Linkkit_Request_Async(int devid, iotx_linkkit_request_type_t type,
+        iotx_linkkit_request_cb_t callback, void *user_data);
+
 /**
  * @brief try to receive message from cloud and dispatch these message to user event callback
  *
@@ -138,6 +217,7 @@ DLL_IOT_API int IOT_Linkkit_Close(int devid);
  * @param payload_len. message payload length.
  *
  * @return success: 0 or message id (>=1), fail: -1.
+ *         ITM_MSG_POST_PROPERTY returns 0 when merged into a later report, see IOTX_IOCTL_SET_PROP_REPORT_WINDOW.
  *
  */
 DLL_IOT_API int IOT_Linkkit_Report(int devid, iotx_linkkit_msg_type_t msg_type, unsigned char *payload,
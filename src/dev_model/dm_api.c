@@ -145,6 +145,9 @@ int iotx_dm_connect(_IN_ iotx_dm_init_params_t *init_params)
     if (init_params->event_callback != NULL) {
         ctx->event_callback = init_params->event_callback;
     }
+    if (init_params->event_handler != NULL) {
+        ctx->event_handler = init_params->event_handler;
+    }
 
     res = dm_client_connect(IOTX_DM_CLIENT_CONNECT_TIMEOUT_MS);
     if (res != SUCCESS_RETURN) {
@@ -162,7 +165,8 @@ int iotx_dm_connect(_IN_ iotx_dm_init_params_t *init_params)
     return SUCCESS_RETURN;
 }
 
-int iotx_dm_subscribe(_IN_ int devid)
+/* @async: SUBACKs of cloud subscriptions are collected by iotx_dm_subscribe_result() instead of waited for */
+static int _dm_api_subscribe(_IN_ int devid, _IN_ int async)
 {
     int res = 0, dev_type = 0;
     char product_key[IOTX_PRODUCT_KEY_LEN + 1] = {0};
@@ -198,18 +202,30 @@ int iotx_dm_subscribe(_IN_ int devid)
     }
 #endif
 
-    res = dm_client_subscribe_all(product_key, device_name, dev_type);
+#ifdef DEVICE_MODEL_GATEWAY
+    if (async) {
+        res = dm_client_subscribe_all_async(product_key, device_name, dev_type, devid);
+    } else
+#endif
+    {
+        res = dm_client_subscribe_all(product_key, device_name, dev_type);
+    }
     if (res < SUCCESS_RETURN) {
         _dm_api_unlock();
         return res;
     }
 
     _dm_api_unlock();
-    dm_log_info("Devid %d Sub Completed", devid);
+    dm_log_info("Devid %d Sub %s", devid, async ? "Sent" : "Completed");
 
     return SUCCESS_RETURN;
 }
 
+int iotx_dm_subscribe(_IN_ int devid)
+{
+    return _dm_api_subscribe(devid, 0);
+}
+
 int iotx_dm_close(void)
 {
     dm_api_ctx_t *ctx = _dm_api_get_ctx();
@@ -264,6 +280,11 @@ void iotx_dm_dispatch(void)
 #if !defined(DM_MESSAGE_CACHE_DISABLED)
     dm_msg_cache_tick();
 #endif
+#if !defined(DEVICE_MODEL_RAWDATA_SOLO)
+    _dm_api_lock();
+    dm_mgr_upstream_thing_property_report_tick();
+    _dm_api_unlock();
+#endif
 #if defined(OTA_ENABLED) && !defined(BUILD_AOS)
     dm_cota_status_check();
     dm_fota_status_check();
@@ -272,7 +293,12 @@ void iotx_dm_dispatch(void)
         if (dm_ipc_msg_next(&data) == SUCCESS_RETURN) {
             dm_ipc_msg_t *msg = (dm_ipc_msg_t *)data;
 
-            if (ctx->event_callback) {
+            if (ctx->event_handler) {
+                msg->event.json = msg->data;
+                ctx->event_handler(&msg->event);
+            } else if (ctx->event_callback) {
+                /* render JSON of typed event only for the callback still asking for it */
+                dm_msg_event_render(msg);
                 ctx->event_callback(msg->type, msg->data);
             }
 
@@ -308,18 +334,58 @@ int iotx_dm_post_rawdata(_IN_ int devid, _IN_ char *payload, _IN_ int payload_le
 }
 
 #if !defined(DEVICE_MODEL_RAWDATA_SOLO)
+/* opt is impl_linkkit_ioctl_cmd_t, its first values are also those of deprecated linkkit_opt_t */
+static int _iotx_dm_opt(int opt, dm_opt_t *dm_opt)
+{
+    switch (opt) {
+        case IMPL_LINKKIT_IOCTL_SWITCH_PROPERTY_POST_REPLY: {
+            *dm_opt = DM_OPT_DOWNSTREAM_PROPERTY_POST_REPLY;
+        }
+        break;
+        case IMPL_LINKKIT_IOCTL_SWITCH_EVENT_POST_REPLY: {
+            *dm_opt = DM_OPT_DOWNSTREAM_EVENT_POST_REPLY;
+        }
+        break;
+        case IMPL_LINKKIT_IOCTL_SWITCH_PROPERTY_SET_REPLY: {
+            *dm_opt = DM_OPT_UPSTREAM_PROPERTY_SET_REPLY;
+        }
+        break;
+        case IMPL_LINKKIT_IOCTL_PROPERTY_REPORT_WINDOW_MS: {
+            *dm_opt = DM_OPT_PROPERTY_REPORT_WINDOW_MS;
+        }
+        break;
+        case IMPL_LINKKIT_IOCTL_PROPERTY_REPORT_DELTA: {
+            *dm_opt = DM_OPT_PROPERTY_REPORT_DELTA;
+        }
+        break;
+        default: {
+            return FAIL_RETURN;
+        }
+    }
+
+    return SUCCESS_RETURN;
+}
+
 int iotx_dm_set_opt(int opt, void *data)
 {
-    return dm_opt_set(opt, data);
+    dm_opt_t dm_opt;
+
+    if (_iotx_dm_opt(opt, &dm_opt) != SUCCESS_RETURN) {
+        return FAIL_RETURN;
+    }
+
+    return dm_opt_set(dm_opt, data);
 }
 
 int iotx_dm_get_opt(int opt, void *data)
 {
-    if (data == NULL) {
+    dm_opt_t dm_opt;
+
+    if (data == NULL || _iotx_dm_opt(opt, &dm_opt) != SUCCESS_RETURN) {
         return FAIL_RETURN;
     }
 
-    return dm_opt_get(opt, data);
+    return dm_opt_get(dm_opt, data);
 }
 #ifdef DEVICE_MODEL_SHADOW
 int iotx_dm_property_desired_get(_IN_ int devid, _IN_ char *payload, _IN_ int payload_len)
@@ -361,7 +427,7 @@ int iotx_dm_post_property(_IN_ int devid, _IN_ char *payload, _IN_ int payload_l
 
     _dm_api_lock();
 
-    res = dm_mgr_upstream_thing_property_post(devid, payload, payload_len);
+    res = dm_mgr_upstream_thing_property_report(devid, payload, payload_len);
     if (res < SUCCESS_RETURN) {
         _dm_api_unlock();
         return FAIL_RETURN;
@@ -778,6 +844,57 @@ int iotx_dm_subdev_login(_IN_ int devid)
     return res;
 }
 
+int iotx_dm_subdev_topo_add_batch(_IN_ int *devids, _IN_ int devid_num)
+{
+    int res = 0;
+
+    if (devids == NULL || devid_num <= 0) {
+        return DM_INVALID_PARAMETER;
+    }
+
+    _dm_api_lock();
+
+    res = dm_mgr_upstream_thing_topo_add_batch(devids, devid_num);
+
+    _dm_api_unlock();
+    return res;
+}
+
+int iotx_dm_subdev_login_batch(_IN_ int *devids, _IN_ int devid_num)
+{
+    int res = 0;
+
+    if (devids == NULL || devid_num <= 0) {
+        return DM_INVALID_PARAMETER;
+    }
+
+    _dm_api_lock();
+
+    res = dm_mgr_upstream_combine_batch_login(devids, devid_num);
+
+    _dm_api_unlock();
+    return res;
+}
+
+int iotx_dm_subscribe_async(_IN_ int devid)
+{
+    return _dm_api_subscribe(devid, 1);
+}
+
+int iotx_dm_subscribe_result(_IN_ int devid)
+{
+    if (devid < 0) {
+        return DM_INVALID_PARAMETER;
+    }
+
+    return dm_client_suback_result(devid);
+}
+
+void iotx_dm_subscribe_cancel(_IN_ int devid)
+{
+    dm_client_suback_cancel(devid);
+}
+
 int iotx_dm_subdev_logout(_IN_ int devid)
 {
     int res = 0;
@@ -1105,8 +1222,9 @@ int iotx_dm_deprecated_post_property_start(_IN_ int devid, _OU_ void **handle)
     /* Set Devid */
     dapi_property->devid = devid;
 
-    /* Init Json Object */
-    dapi_property->lite = lite_cjson_create_object();
+    /* Init Json Object, all of its items are released with arena */
+    lite_cjson_arena_init(&dapi_property->arena, NULL, 0);
+    dapi_property->lite = lite_cjson_arena_create_object(&dapi_property->arena);
     if (dapi_property->lite == NULL) {
         DM_free(dapi_property->mutex);
         DM_free(dapi_property);
@@ -1131,7 +1249,8 @@ static int _iotx_dm_deprecated_post_property_add(_IN_ void *handle, _IN_ char *i
     dapi_property = (dm_api_property_t *)handle;
 
     /* Assemble Property Payload */
-    res = dm_mgr_deprecated_assemble_property(dapi_property->devid, identifier, identifier_len, dapi_property->lite);
+    res = dm_mgr_deprecated_assemble_property(dapi_property->devid, identifier, identifier_len, dapi_property->lite,
+            &dapi_property->arena);
     if (res != SUCCESS_RETURN) {
         return FAIL_RETURN;
     }
@@ -1209,7 +1328,7 @@ int iotx_dm_deprecated_post_property_end(_IN_ void **handle)
 
     payload = lite_cjson_print_unformatted(dapi_property->lite);
     if (payload == NULL) {
-        lite_cjson_delete(dapi_property->lite);
+        lite_cjson_arena_deinit(&dapi_property->arena);
         if (dapi_property->mutex) {
             HAL_MutexDestroy(dapi_property->mutex);
         }
@@ -1223,7 +1342,7 @@ int iotx_dm_deprecated_post_property_end(_IN_ void **handle)
     res = dm_mgr_upstream_thing_property_post(dapi_property->devid, payload, strlen(payload));
 
     DM_free(payload);
-    lite_cjson_delete(dapi_property->lite);
+    lite_cjson_arena_deinit(&dapi_property->arena);
     if (dapi_property->mutex) {
         HAL_MutexDestroy(dapi_property->mutex);
     }
@@ -1239,6 +1358,7 @@ int iotx_dm_deprecated_post_event(_IN_ int devid, _IN_ char *identifier, _IN_ in
     int res = 0;
     void *event = NULL;
     lite_cjson_item_t *lite = NULL;
+    lite_cjson_arena_t arena;
     char *method = NULL, *payload = NULL;
 
     if (devid < 0 || identifier == NULL || identifier_len <= 0) {
@@ -1246,21 +1366,23 @@ int iotx_dm_deprecated_post_event(_IN_ int devid, _IN_ char *identifier, _IN_ in
     }
 
     _dm_api_lock();
-    lite = lite_cjson_create_object();
+    lite_cjson_arena_init(&arena, NULL, 0);
+    lite = lite_cjson_arena_create_object(&arena);
     if (lite == NULL) {
+        lite_cjson_arena_deinit(&arena);
         _dm_api_unlock();
         return DM_MEMORY_NOT_ENOUGH;
     }
 
-    res = dm_mgr_deprecated_assemble_event_output(devid, identifier, identifier_len, lite);
+    res = dm_mgr_deprecated_assemble_event_output(devid, identifier, identifier_len, lite, &arena);
     if (res != SUCCESS_RETURN) {
-        lite_cjson_delete(lite);
+        lite_cjson_arena_deinit(&arena);
         _dm_api_unlock();
         return FAIL_RETURN;
     }
 
     payload = lite_cjson_print_unformatted(lite);
-    lite_cjson_delete(lite);
+    lite_cjson_arena_deinit(&arena);
     if (payload == NULL) {
         _dm_api_unlock();
         return DM_MEMORY_NOT_ENOUGH;
@@ -2000,6 +2122,7 @@ int iotx_dm_deprecated_send_service_response(_IN_ int devid, _IN_ int msgid, _IN
 {
     int res = 0;
     lite_cjson_item_t *lite = NULL;
+    lite_cjson_arena_t arena;
     char *payload = NULL;
 
     if (devid < 0 || msgid < 0 || identifier == NULL || identifier_len <= 0) {
@@ -2007,21 +2130,23 @@ int iotx_dm_deprecated_send_service_response(_IN_ int devid, _IN_ int msgid, _IN
     }
 
     _dm_api_lock();
-    lite = lite_cjson_create_object();
+    lite_cjson_arena_init(&arena, NULL, 0);
+    lite = lite_cjson_arena_create_object(&arena);
     if (lite == NULL) {
+        lite_cjson_arena_deinit(&arena);
         _dm_api_unlock();
         return DM_MEMORY_NOT_ENOUGH;
     }
 
-    res = dm_mgr_deprecated_assemble_service_output(devid, identifier, identifier_len, lite);
+    res = dm_mgr_deprecated_assemble_service_output(devid, identifier, identifier_len, lite, &arena);
     if (res != SUCCESS_RETURN) {
-        lite_cjson_delete(lite);
+        lite_cjson_arena_deinit(&arena);
         _dm_api_unlock();
         return FAIL_RETURN;
     }
 
     payload = lite_cjson_print_unformatted(lite);
-    lite_cjson_delete(lite);
+    lite_cjson_arena_deinit(&arena);
     if (payload == NULL) {
         _dm_api_unlock();
         return DM_MEMORY_NOT_ENOUGH;
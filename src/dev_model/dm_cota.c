@@ -41,12 +41,11 @@ int dm_cota_deinit(void)
 
 static int _dm_cota_send_new_config_to_user(void *ota_handle)
 {
-    int res = 0, message_len = 0;
-    char *message = NULL;
+    int res = 0;
     uint32_t config_size = 0;
     char *config_id = NULL, *sign = NULL, *sign_method = NULL, *url = NULL, *get_type = NULL;
-    const char *cota_new_config_fmt =
-                "{\"configId\":\"%s\",\"configSize\":%d,\"getType\":\"%s\",\"sign\":\"%s\",\"signMethod\":\"%s\",\"url\":\"%s\"}";
+    dm_ipc_msg_t *dipc_msg = NULL;
+    iotx_dm_event_cota_t *cota = NULL;
 
     IOT_OTA_Ioctl(ota_handle, IOT_OTAG_COTA_CONFIG_ID, (void *)&config_id, 1);
     IOT_OTA_Ioctl(ota_handle, IOT_OTAG_COTA_CONFIG_SIZE, &config_size, 4);
@@ -60,24 +59,24 @@ static int _dm_cota_send_new_config_to_user(void *ota_handle)
         goto ERROR;
     }
 
-    message_len = strlen(cota_new_config_fmt) + strlen(config_id) + DM_UTILS_UINT32_STRLEN + strlen(get_type) +
-                  strlen(sign) + strlen(sign_method) + strlen(url) + 1;
+    dm_log_info("Send To User: %s", config_id);
 
-    message = DM_malloc(message_len);
-    if (message == NULL) {
+    dipc_msg = dm_msg_event_new(IOTX_DM_EVENT_COTA_NEW_CONFIG, IOTX_DM_LOCAL_NODE_DEVID,
+                                strlen(config_id) + strlen(get_type) + strlen(sign) + strlen(sign_method) + strlen(url));
+    if (dipc_msg == NULL) {
         res = DM_MEMORY_NOT_ENOUGH;
         goto ERROR;
     }
-    memset(message, 0, message_len);
-    HAL_Snprintf(message, message_len, cota_new_config_fmt, config_id, config_size, get_type, sign, sign_method, url);
-
-    dm_log_info("Send To User: %s", message);
+    cota = &dipc_msg->event.data.cota;
+    dm_msg_event_str_set(dipc_msg, &cota->config_id, config_id, strlen(config_id));
+    dm_msg_event_str_set(dipc_msg, &cota->get_type, get_type, strlen(get_type));
+    dm_msg_event_str_set(dipc_msg, &cota->sign, sign, strlen(sign));
+    dm_msg_event_str_set(dipc_msg, &cota->sign_method, sign_method, strlen(sign_method));
+    dm_msg_event_str_set(dipc_msg, &cota->url, url, strlen(url));
+    cota->config_size = config_size;
 
-    res = _dm_msg_send_to_user(IOTX_DM_EVENT_COTA_NEW_CONFIG, message);
+    res = dm_msg_event_send_to_user(dipc_msg);
     if (res != SUCCESS_RETURN) {
-        if (message) {
-            DM_free(message);
-        }
         res = FAIL_RETURN;
         goto ERROR;
     }
@@ -32,33 +32,20 @@ int dm_fota_deinit(void)
 
 static int _dm_fota_send_new_config_to_user(void *ota_handle)
 {
-    int res = 0, message_len = 0;
-    char *message = NULL;
     char version[128] = {0};
-    const char *fota_new_config_fmt = "{\"version\":\"%s\"}";
+    dm_ipc_msg_t *dipc_msg = NULL;
 
     IOT_OTA_Ioctl(ota_handle, IOT_OTAG_VERSION, version, 128);
 
-    message_len = strlen(fota_new_config_fmt) + strlen(version) + 1;
+    dm_log_info("Send To User: %s", version);
 
-    message = DM_malloc(message_len);
-    if (message == NULL) {
+    dipc_msg = dm_msg_event_new(IOTX_DM_EVENT_FOTA_NEW_FIRMWARE, IOTX_DM_LOCAL_NODE_DEVID, strlen(version));
+    if (dipc_msg == NULL) {
         return DM_MEMORY_NOT_ENOUGH;
     }
-    memset(message, 0, message_len);
-    HAL_Snprintf(message, message_len, fota_new_config_fmt, version);
+    dm_msg_event_str_set(dipc_msg, &dipc_msg->event.data.version, version, strlen(version));
 
-    dm_log_info("Send To User: %s", message);
-
-    res = _dm_msg_send_to_user(IOTX_DM_EVENT_FOTA_NEW_FIRMWARE, message);
-    if (res != SUCCESS_RETURN) {
-        if (message) {
-            DM_free(message);
-        }
-        return FAIL_RETURN;
-    }
-
-    return SUCCESS_RETURN;
+    return dm_msg_event_send_to_user(dipc_msg);
 }
 
 int dm_fota_perform_sync(_OU_ char *output, _IN_ int output_len)
@@ -12,6 +12,7 @@ typedef struct {
     void *cloud_connectivity;
     void *local_connectivity;
     iotx_dm_event_callback event_callback;
+    iotx_dm_event_handler event_handler;
 } dm_api_ctx_t;
 
 #if defined(DEPRECATED_LINKKIT)
@@ -19,6 +20,7 @@ typedef struct {
     void *mutex;
     int devid;
     lite_cjson_item_t *lite;
+    lite_cjson_arena_t arena;
 } dm_api_property_t;
 #endif
 
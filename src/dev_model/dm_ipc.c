@@ -29,6 +29,119 @@ static void _dm_ipc_unlock(void)
     }
 }
 
+#ifdef DM_IPC_RING_ENABLED
+#define _DM_IPC_LOAD_ACQUIRE(ptr)         __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define _DM_IPC_STORE_RELEASE(ptr, val)   __atomic_store_n(ptr, val, __ATOMIC_RELEASE)
+
+int dm_ipc_init(int max_size)
+{
+    dm_ipc_t *ctx = _dm_ipc_get_ctx();
+
+    if (max_size < 0) {
+        return DM_INVALID_PARAMETER;
+    }
+
+    memset(ctx, 0, sizeof(dm_ipc_t));
+
+    /* Create Mutex */
+    ctx->mutex = HAL_MutexCreate();
+    if (ctx->mutex == NULL) {
+        return DM_INVALID_PARAMETER;
+    }
+
+    /* Init Ring, every slot is allocated here once */
+    ctx->msg_ring.slots = DM_malloc((max_size + 1) * sizeof(void *));
+    if (ctx->msg_ring.slots == NULL) {
+        HAL_MutexDestroy(ctx->mutex);
+        ctx->mutex = NULL;
+        return DM_MEMORY_NOT_ENOUGH;
+    }
+    memset(ctx->msg_ring.slots, 0, (max_size + 1) * sizeof(void *));
+    ctx->msg_ring.size = max_size + 1;
+
+    return SUCCESS_RETURN;
+}
+
+void dm_ipc_deinit(void)
+{
+    dm_ipc_t *ctx = _dm_ipc_get_ctx();
+    dm_ipc_msg_t *del_msg = NULL;
+
+    if (ctx->mutex) {
+        HAL_MutexDestroy(ctx->mutex);
+        ctx->mutex = NULL;
+    }
+
+    while (ctx->msg_ring.head != ctx->msg_ring.tail) {
+        /* Free Message */
+        del_msg = (dm_ipc_msg_t *)ctx->msg_ring.slots[ctx->msg_ring.head];
+        if (del_msg->data) {
+            DM_free(del_msg->data);
+        }
+        DM_free(del_msg);
+        ctx->msg_ring.head = (ctx->msg_ring.head + 1) % ctx->msg_ring.size;
+    }
+
+    if (ctx->msg_ring.slots) {
+        DM_free(ctx->msg_ring.slots);
+    }
+    memset(&ctx->msg_ring, 0, sizeof(dm_ipc_msg_ring_t));
+}
+
+int dm_ipc_msg_insert(void *data)
+{
+    dm_ipc_t *ctx = _dm_ipc_get_ctx();
+    unsigned int head = 0, tail = 0, next = 0;
+
+    if (data == NULL) {
+        return DM_INVALID_PARAMETER;
+    }
+
+    _dm_ipc_lock();
+
+    tail = ctx->msg_ring.tail;
+    head = _DM_IPC_LOAD_ACQUIRE(&ctx->msg_ring.head);
+    next = (tail + 1) % ctx->msg_ring.size;
+    dm_log_debug("dm msg list size: %d, max size: %d", (int)((tail + ctx->msg_ring.size - head) % ctx->msg_ring.size),
+                 (int)(ctx->msg_ring.size - 1));
+    if (next == head) {
+        dm_log_warning("dm ipc list full");
+        _dm_ipc_unlock();
+        return FAIL_RETURN;
+    }
+
+    /* slot must be filled before it is published by tail */
+    ctx->msg_ring.slots[tail] = data;
+    _DM_IPC_STORE_RELEASE(&ctx->msg_ring.tail, next);
+
+    _dm_ipc_unlock();
+    return SUCCESS_RETURN;
+}
+
+int dm_ipc_msg_next(void **data)
+{
+    dm_ipc_t *ctx = _dm_ipc_get_ctx();
+    unsigned int head = 0;
+
+    if (data == NULL || *data != NULL) {
+        return DM_INVALID_PARAMETER;
+    }
+
+    /* only dispatch thread takes messages, no lock needed against producers */
+    head = ctx->msg_ring.head;
+    if (head == _DM_IPC_LOAD_ACQUIRE(&ctx->msg_ring.tail)) {
+        return FAIL_RETURN;
+    }
+
+    *data = ctx->msg_ring.slots[head];
+
+    /* release the slot to producers only after it has been read */
+    _DM_IPC_STORE_RELEASE(&ctx->msg_ring.head, (head + 1) % ctx->msg_ring.size);
+
+    return SUCCESS_RETURN;
+}
+
+#else
 int dm_ipc_init(int max_size)
 {
     dm_ipc_t *ctx = _dm_ipc_get_ctx();
@@ -133,4 +246,4 @@ int dm_ipc_msg_next(void **data)
     _dm_ipc_unlock();
     return SUCCESS_RETURN;
 }
-
+#endif
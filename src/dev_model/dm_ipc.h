@@ -11,7 +11,10 @@
 
 typedef struct {
     iotx_dm_event_types_t type;
-    char *data;
+    char *data;                 /* JSON message, NULL if the event is only carried in typed form */
+    iotx_dm_event_t event;
+    int str_size;               /* slices of event are stored right after this structure */
+    int str_used;
 } dm_ipc_msg_t;
 
 typedef struct {
@@ -25,9 +28,25 @@ typedef struct {
     struct list_head message_list;
 } dm_ipc_msg_list_t;
 
+/*
+ * Fixed ring between producers and the dispatch thread, head is only written by consumer and tail only by
+ * producer, so dispatch never takes the lock. Producers still serialize among themselves on mutex, which is
+ * uncontended while messages come from the yield thread only.
+ */
+typedef struct {
+    void **slots;
+    unsigned int size;          /* one more than max size, an empty slot tells full from empty */
+    unsigned int head;          /* next slot to take */
+    unsigned int tail;          /* next slot to put */
+} dm_ipc_msg_ring_t;
+
 typedef struct {
     void *mutex;
+#ifdef DM_IPC_RING_ENABLED
+    dm_ipc_msg_ring_t msg_ring;
+#else
     dm_ipc_msg_list_t msg_list;
+#endif
 } dm_ipc_t;
 
 int dm_ipc_init(int max_size);
@@ -36,12 +36,51 @@ static int _dm_mgr_next_devid(void)
     return ctx->global_devid++;
 }
 
-static int _dm_mgr_search_dev_by_devid(_IN_ int devid, _OU_ dm_mgr_dev_node_t **node)
+static struct list_head *_dm_mgr_devid_bucket(_IN_ int devid)
+{
+    dm_mgr_ctx *ctx = _dm_mgr_get_ctx();
+
+    return &ctx->devid_hash[(unsigned int)devid % CONFIG_DM_DEV_HASH_SIZE];
+}
+
+static struct list_head *_dm_mgr_pkdn_bucket(_IN_ const char *product_key, _IN_ const char *device_name)
+{
+    dm_mgr_ctx *ctx = _dm_mgr_get_ctx();
+    unsigned int hash = 2166136261u;
+
+    while (*product_key) {
+        hash = (hash ^ (unsigned char)*product_key++) * 16777619u;
+    }
+    hash = (hash ^ '/') * 16777619u;
+    while (*device_name) {
+        hash = (hash ^ (unsigned char)*device_name++) * 16777619u;
+    }
+
+    return &ctx->pkdn_hash[hash % CONFIG_DM_DEV_HASH_SIZE];
+}
+
+/* device list keeps creation order for iterating by index, both hash indexes are for searching */
+static void _dm_mgr_link_dev(_IN_ dm_mgr_dev_node_t *node)
 {
     dm_mgr_ctx *ctx = _dm_mgr_get_ctx();
+
+    list_add_tail(&node->linked_list, &ctx->dev_list);
+    list_add(&node->devid_linked, _dm_mgr_devid_bucket(node->devid));
+    list_add(&node->pkdn_linked, _dm_mgr_pkdn_bucket(node->product_key, node->device_name));
+}
+
+static void _dm_mgr_unlink_dev(_IN_ dm_mgr_dev_node_t *node)
+{
+    list_del(&node->linked_list);
+    list_del(&node->devid_linked);
+    list_del(&node->pkdn_linked);
+}
+
+static int _dm_mgr_search_dev_by_devid(_IN_ int devid, _OU_ dm_mgr_dev_node_t **node)
+{
     dm_mgr_dev_node_t *search_node = NULL;
 
-    list_for_each_entry(search_node, &ctx->dev_list, linked_list, dm_mgr_dev_node_t) {
+    list_for_each_entry(search_node, _dm_mgr_devid_bucket(devid), devid_linked, dm_mgr_dev_node_t) {
         if (search_node->devid == devid) {
             /* dm_log_debug("Device Found, devid: %d", devid); */
             if (node) {
@@ -58,14 +97,11 @@ static int _dm_mgr_search_dev_by_devid(_IN_ int devid, _OU_ dm_mgr_dev_node_t **
 static int _dm_mgr_search_dev_by_pkdn(_IN_ char product_key[IOTX_PRODUCT_KEY_LEN + 1],
                                       _IN_ char device_name[IOTX_DEVICE_NAME_LEN + 1], _OU_ dm_mgr_dev_node_t **node)
 {
-    dm_mgr_ctx *ctx = _dm_mgr_get_ctx();
     dm_mgr_dev_node_t *search_node = NULL;
 
-    list_for_each_entry(search_node, &ctx->dev_list, linked_list, dm_mgr_dev_node_t) {
-        if ((strlen(search_node->product_key) == strlen(product_key)) &&
-            (memcmp(search_node->product_key, product_key, strlen(product_key)) == 0) &&
-            (strlen(search_node->device_name) == strlen(device_name)) &&
-            (memcmp(search_node->device_name, device_name, strlen(device_name)) == 0)) {
+    list_for_each_entry(search_node, _dm_mgr_pkdn_bucket(product_key, device_name), pkdn_linked, dm_mgr_dev_node_t) {
+        if (strcmp(search_node->product_key, product_key) == 0 &&
+            strcmp(search_node->device_name, device_name) == 0) {
             /* dm_log_debug("Device Found, Product Key: %s, Device Name: %s", product_key, device_name); */
             if (node) {
                 *node = search_node;
@@ -82,7 +118,6 @@ static int _dm_mgr_insert_dev(_IN_ int devid, _IN_ int dev_type, char product_ke
                               char device_name[IOTX_DEVICE_NAME_LEN + 1])
 {
     int res = 0;
-    dm_mgr_ctx *ctx = _dm_mgr_get_ctx();
     dm_mgr_dev_node_t *node = NULL;
 
     if (devid < 0 || product_key == NULL || strlen(product_key) >= IOTX_PRODUCT_KEY_LEN + 1 ||
@@ -107,11 +142,68 @@ static int _dm_mgr_insert_dev(_IN_ int devid, _IN_ int dev_type, char product_ke
     memcpy(node->device_name, device_name, strlen(device_name));
     INIT_LIST_HEAD(&node->linked_list);
 
-    list_add_tail(&node->linked_list, &ctx->dev_list);
+    _dm_mgr_link_dev(node);
 
     return SUCCESS_RETURN;
 }
 
+/* service names of DM_URI_SYS_PREFIX whose topic is kept by device, in order of dm_mgr_topic_t */
+static const char *const g_dm_mgr_topic_names[DM_MGR_TOPIC_NUM] = {
+    DM_URI_THING_MODEL_UP_RAW,
+#if !defined(DEVICE_MODEL_RAWDATA_SOLO)
+    DM_URI_THING_EVENT_PROPERTY_POST,
+    DM_URI_THING_DEVICEINFO_UPDATE,
+    DM_URI_THING_DEVICEINFO_DELETE,
+#endif
+};
+
+/* topic of frequent upstream message is built the first time device sends it and kept, NULL for other topics */
+static const char *_dm_mgr_topic(_IN_ dm_mgr_dev_node_t *node, _IN_ const char *service_prefix,
+                                 _IN_ const char *service_name)
+{
+    int index = 0;
+
+    if (service_prefix != DM_URI_SYS_PREFIX) {
+        return NULL;
+    }
+
+    for (index = 0; index < DM_MGR_TOPIC_NUM; index++) {
+        if (g_dm_mgr_topic_names[index] == service_name) {
+            break;
+        }
+    }
+    if (index == DM_MGR_TOPIC_NUM) {
+        return NULL;
+    }
+
+    if (node->topics[index] == NULL &&
+        dm_utils_service_name(service_prefix, service_name, node->product_key, node->device_name,
+                              &node->topics[index]) != SUCCESS_RETURN) {
+        return NULL;
+    }
+
+    return node->topics[index];
+}
+
+static void _dm_mgr_free_topics(_IN_ dm_mgr_dev_node_t *node)
+{
+    int index = 0;
+
+    for (index = 0; index < DM_MGR_TOPIC_NUM; index++) {
+        if (node->topics[index] != NULL) {
+            DM_free(node->topics[index]);
+        }
+    }
+
+#if !defined(DEVICE_MODEL_RAWDATA_SOLO)
+    /* property values still waiting to be merged are dropped with device */
+    if (node->prop_report != NULL) {
+        dm_prop_report_clear(node->prop_report);
+        DM_free(node->prop_report);
+    }
+#endif
+}
+
 static void _dm_mgr_destroy_devlist(void)
 {
     dm_mgr_ctx *ctx = _dm_mgr_get_ctx();
@@ -119,10 +211,11 @@ static void _dm_mgr_destroy_devlist(void)
     dm_mgr_dev_node_t *next_node = NULL;
 
     list_for_each_entry_safe(del_node, next_node, &ctx->dev_list, linked_list, dm_mgr_dev_node_t) {
-        list_del(&del_node->linked_list);
+        _dm_mgr_unlink_dev(del_node);
 #ifdef DEPRECATED_LINKKIT
         dm_shw_destroy(&del_node->dev_shadow);
 #endif
+        _dm_mgr_free_topics(del_node);
         DM_free(del_node);
     }
 }
@@ -154,7 +247,7 @@ static int _dm_mgr_legacy_thing_created(int devid)
 
 int dm_mgr_init(void)
 {
-    int res = 0;
+    int res = 0, index = 0;
     dm_mgr_ctx *ctx = _dm_mgr_get_ctx();
     char product_key[IOTX_PRODUCT_KEY_LEN + 1] = {0};
     char device_name[IOTX_DEVICE_NAME_LEN + 1] = {0};
@@ -172,6 +265,10 @@ int dm_mgr_init(void)
 
     /* Init Device List */
     INIT_LIST_HEAD(&ctx->dev_list);
+    for (index = 0; index < CONFIG_DM_DEV_HASH_SIZE; index++) {
+        INIT_LIST_HEAD(&ctx->devid_hash[index]);
+        INIT_LIST_HEAD(&ctx->pkdn_hash[index]);
+    }
 
     /* Local Node */
     HAL_GetProductKey(product_key);
@@ -214,7 +311,6 @@ int dm_mgr_device_create(_IN_ int dev_type, _IN_ char product_key[IOTX_PRODUCT_K
                          _IN_ char device_name[IOTX_DEVICE_NAME_LEN + 1], _IN_ char device_secret[IOTX_DEVICE_SECRET_LEN + 1], _OU_ int *devid)
 {
     int res = 0;
-    dm_mgr_ctx *ctx = _dm_mgr_get_ctx();
     dm_mgr_dev_node_t *node = NULL;
 
     if (product_key == NULL || device_name == NULL ||
@@ -255,7 +351,7 @@ int dm_mgr_device_create(_IN_ int dev_type, _IN_ char product_key[IOTX_PRODUCT_K
     node->dev_status = IOTX_DM_DEV_STATUS_AUTHORIZED;
     INIT_LIST_HEAD(&node->linked_list);
 
-    list_add_tail(&node->linked_list, &ctx->dev_list);
+    _dm_mgr_link_dev(node);
 
     if (devid) {
         *devid = node->devid;
@@ -282,7 +378,7 @@ int dm_mgr_device_destroy(_IN_ int devid)
         return FAIL_RETURN;
     }
 
-    list_del(&node->linked_list);
+    _dm_mgr_unlink_dev(node);
 
 #if defined(DEPRECATED_LINKKIT)
     if (node->dev_shadow) {
@@ -294,6 +390,7 @@ int dm_mgr_device_destroy(_IN_ int devid)
     dm_client_subdev_unsubscribe(node->product_key,node->device_name);
 #endif
 
+    _dm_mgr_free_topics(node);
     DM_free(node);
 
     return SUCCESS_RETURN;
@@ -558,25 +655,14 @@ int dm_mgr_set_device_secret(_IN_ int devid, _IN_ char device_secret[IOTX_DEVICE
 
 int dm_mgr_dev_initialized(int devid)
 {
-    int res = 0, message_len = 0;
-    char *message = NULL;
-    const char *fmt = "{\"devid\":%d}";
+    dm_ipc_msg_t *dipc_msg = NULL;
 
-    message_len = strlen(fmt) + DM_UTILS_UINT32_STRLEN + 1;
-    message = DM_malloc(message_len);
-    if (message == NULL) {
+    dipc_msg = dm_msg_event_new(IOTX_DM_EVENT_INITIALIZED, devid, 0);
+    if (dipc_msg == NULL) {
         return DM_MEMORY_NOT_ENOUGH;
     }
-    memset(message, 0, message_len);
-    HAL_Snprintf(message, message_len, fmt, devid);
 
-    res = _dm_msg_send_to_user(IOTX_DM_EVENT_INITIALIZED, message);
-    if (res != SUCCESS_RETURN) {
-        DM_free(message);
-        return FAIL_RETURN;
-    }
-
-    return SUCCESS_RETURN;
+    return dm_msg_event_send_to_user(dipc_msg);
 }
 
 #ifdef DEVICE_MODEL_GATEWAY
@@ -718,8 +804,13 @@ int dm_mgr_upstream_thing_topo_add(_IN_ int devid)
     res = dm_msg_request(DM_MSG_DEST_CLOUD, &request);
 #if !defined(DM_MESSAGE_CACHE_DISABLED)
     if (res == SUCCESS_RETURN) {
-        dm_msg_cache_insert(request.msgid, request.devid, IOTX_DM_EVENT_TOPO_ADD_REPLY, NULL);
-        res = request.msgid;
+        /* reply is matched to its device through message cache only */
+        res = dm_msg_cache_insert(request.msgid, request.devid, IOTX_DM_EVENT_TOPO_ADD_REPLY, NULL);
+        if (res != SUCCESS_RETURN) {
+            dm_log_err("Message Cache Full, Reply Of %d Dropped", request.msgid);
+        } else {
+            res = request.msgid;
+        }
     }
 #endif
     DM_free(request.params);
@@ -767,8 +858,13 @@ int dm_mgr_upstream_thing_topo_delete(_IN_ int devid)
     res = dm_msg_request(DM_MSG_DEST_CLOUD, &request);
 #if !defined(DM_MESSAGE_CACHE_DISABLED)
     if (res == SUCCESS_RETURN) {
-        dm_msg_cache_insert(request.msgid, request.devid, IOTX_DM_EVENT_TOPO_DELETE_REPLY, NULL);
-        res = request.msgid;
+        /* reply is matched to its device through message cache only */
+        res = dm_msg_cache_insert(request.msgid, request.devid, IOTX_DM_EVENT_TOPO_DELETE_REPLY, NULL);
+        if (res != SUCCESS_RETURN) {
+            dm_log_err("Message Cache Full, Reply Of %d Dropped", request.msgid);
+        } else {
+            res = request.msgid;
+        }
     }
 #endif
     DM_free(request.params);
@@ -919,6 +1015,90 @@ int dm_mgr_upstream_combine_login(_IN_ int devid)
     return res;
 }
 
+/* one request for sub devices @devids, topo add or combine login */
+static int _dm_mgr_upstream_subdev_batch(_IN_ int *devids, _IN_ int devid_num, _IN_ int login)
+{
+    int res = 0, index = 0;
+    dm_mgr_dev_node_t *node = NULL;
+    dm_msg_subdev_t *subdevs = NULL;
+    dm_msg_request_t request;
+
+    if (devids == NULL || devid_num <= 0) {
+        return DM_INVALID_PARAMETER;
+    }
+
+    subdevs = DM_malloc(sizeof(dm_msg_subdev_t) * devid_num);
+    if (subdevs == NULL) {
+        return DM_MEMORY_NOT_ENOUGH;
+    }
+
+    for (index = 0; index < devid_num; index++) {
+        node = NULL;
+        if (devids[index] <= 0 || _dm_mgr_search_dev_by_devid(devids[index], &node) != SUCCESS_RETURN) {
+            DM_free(subdevs);
+            return FAIL_RETURN;
+        }
+        subdevs[index].product_key = node->product_key;
+        subdevs[index].device_name = node->device_name;
+        subdevs[index].device_secret = node->device_secret;
+    }
+
+    memset(&request, 0, sizeof(dm_msg_request_t));
+    HAL_GetProductKey(request.product_key);
+    HAL_GetDeviceName(request.device_name);
+
+    /* Get Params And Method */
+    if (login) {
+        request.service_prefix = DM_URI_EXT_SESSION_PREFIX;
+        request.service_name = DM_URI_COMBINE_BATCH_LOGIN;
+        request.callback = dm_client_combine_batch_login_reply;
+        res = dm_msg_combine_batch_login(subdevs, devid_num, &request);
+    } else {
+        request.service_prefix = DM_URI_SYS_PREFIX;
+        request.service_name = DM_URI_THING_TOPO_ADD;
+        request.callback = dm_client_thing_topo_add_reply;
+        res = dm_msg_thing_topo_add_batch(subdevs, devid_num, &request);
+    }
+    DM_free(subdevs);
+    if (res != SUCCESS_RETURN) {
+        return FAIL_RETURN;
+    }
+
+    /* Get Msg ID */
+    request.msgid = iotx_report_id();
+
+    /* Sent on behalf of the gateway, reply tells which sub devices succeeded */
+    request.devid = IOTX_DM_LOCAL_NODE_DEVID;
+
+    /* Send Message To Cloud */
+    res = dm_msg_request(DM_MSG_DEST_CLOUD, &request);
+#if !defined(DM_MESSAGE_CACHE_DISABLED)
+    if (res == SUCCESS_RETURN) {
+        res = dm_msg_cache_insert(request.msgid, request.devid,
+                                  login ? IOTX_DM_EVENT_COMBINE_LOGIN_REPLY : IOTX_DM_EVENT_TOPO_ADD_REPLY, NULL);
+        if (res != SUCCESS_RETURN && !login) {
+            /* topo add reply is matched through message cache only */
+            dm_log_err("Message Cache Full, Reply Of %d Dropped", request.msgid);
+        } else {
+            res = request.msgid;
+        }
+    }
+#endif
+    DM_free(request.params);
+
+    return res;
+}
+
+int dm_mgr_upstream_thing_topo_add_batch(_IN_ int *devids, _IN_ int devid_num)
+{
+    return _dm_mgr_upstream_subdev_batch(devids, devid_num, 0);
+}
+
+int dm_mgr_upstream_combine_batch_login(_IN_ int *devids, _IN_ int devid_num)
+{
+    return _dm_mgr_upstream_subdev_batch(devids, devid_num, 1);
+}
+
 int dm_mgr_upstream_combine_logout(_IN_ int devid)
 {
     int res = 0;
@@ -1024,7 +1204,6 @@ int dm_mgr_upstream_thing_model_up_raw(_IN_ int devid, _IN_ char *payload, _IN_
     int res = 0, res1 = 0;
     dm_mgr_dev_node_t *node = NULL;
     char *uri = NULL;
-    dm_msg_request_t request;
 
     if (devid < 0 || payload == NULL || payload_len <= 0) {
         return DM_INVALID_PARAMETER;
@@ -1035,16 +1214,9 @@ int dm_mgr_upstream_thing_model_up_raw(_IN_ int devid, _IN_ char *payload, _IN_
         return FAIL_RETURN;
     }
 
-    memset(&request, 0, sizeof(dm_msg_request_t));
-    request.service_prefix = DM_URI_SYS_PREFIX;
-    request.service_name = DM_URI_THING_MODEL_UP_RAW;
-    memcpy(request.product_key, node->product_key, strlen(node->product_key));
-    memcpy(request.device_name, node->device_name, strlen(node->device_name));
-
-    /* Request URI */
-    res = dm_utils_service_name(request.service_prefix, request.service_name,
-                                request.product_key, request.device_name, &uri);
-    if (res != SUCCESS_RETURN) {
+    /* Request URI, kept by device */
+    uri = (char *)_dm_mgr_topic(node, DM_URI_SYS_PREFIX, DM_URI_THING_MODEL_UP_RAW);
+    if (uri == NULL) {
         return FAIL_RETURN;
     }
 
@@ -1057,11 +1229,9 @@ int dm_mgr_upstream_thing_model_up_raw(_IN_ int devid, _IN_ char *payload, _IN_
 #endif
 
     if (res < SUCCESS_RETURN || res1 < SUCCESS_RETURN) {
-        DM_free(uri);
         return FAIL_RETURN;
     }
 
-    DM_free(uri);
     return SUCCESS_RETURN;
 }
 
@@ -1082,6 +1252,7 @@ static int _dm_mgr_upstream_request_assemble(_IN_ int msgid, _IN_ int devid, _IN
     request->devid = devid;
     request->service_prefix = service_prefix;
     request->service_name = service_name;
+    request->topic = _dm_mgr_topic(node, service_prefix, service_name);
     memcpy(request->product_key, node->product_key, strlen(node->product_key));
     memcpy(request->device_name, node->device_name, strlen(node->device_name));
     request->params = params;
@@ -1161,15 +1332,13 @@ int dm_mgr_upstream_thing_property_desired_delete(_IN_ int devid, _IN_ char *pay
 }
 #endif
 
-int dm_mgr_upstream_thing_property_post(_IN_ int devid, _IN_ char *payload, _IN_ int payload_len)
+/* @publish_res, if not NULL, gets result of publishing, a post which is not sent still returns its msgid */
+static int _dm_mgr_upstream_thing_property_send(_IN_ int devid, _IN_ char *payload, _IN_ int payload_len,
+        _OU_ int *publish_res)
 {
     int res = 0;
     dm_msg_request_t request;
 
-    if (devid < 0 || payload == NULL || payload_len <= 0) {
-        return DM_INVALID_PARAMETER;
-    }
-
     memset(&request, 0, sizeof(dm_msg_request_t));
     res = _dm_mgr_upstream_request_assemble(iotx_report_id(), devid, DM_URI_SYS_PREFIX, DM_URI_THING_EVENT_PROPERTY_POST,
                                             payload, payload_len, "thing.event.property.post", &request);
@@ -1182,6 +1351,9 @@ int dm_mgr_upstream_thing_property_post(_IN_ int devid, _IN_ char *payload, _IN_
 
     /* Send Message To Cloud */
     res = dm_msg_request(DM_MSG_DEST_ALL, &request);
+    if (publish_res != NULL) {
+        *publish_res = (res == SUCCESS_RETURN) ? request.publish_res : res;
+    }
 #if !defined(DM_MESSAGE_CACHE_DISABLED)
     if (res == SUCCESS_RETURN) {
         int prop_post_reply = 0;
@@ -1195,6 +1367,117 @@ int dm_mgr_upstream_thing_property_post(_IN_ int devid, _IN_ char *payload, _IN_
     return res;
 }
 
+int dm_mgr_upstream_thing_property_post(_IN_ int devid, _IN_ char *payload, _IN_ int payload_len)
+{
+    if (devid < 0 || payload == NULL || payload_len <= 0) {
+        return DM_INVALID_PARAMETER;
+    }
+
+    return _dm_mgr_upstream_thing_property_send(devid, payload, payload_len, NULL);
+}
+
+static int _dm_mgr_upstream_thing_property_report_flush(_IN_ dm_mgr_dev_node_t *node)
+{
+    int res = 0, delta = 0, payload_len = 0, publish_res = 0;
+    char *payload = NULL;
+
+    res = dm_prop_report_payload(node->prop_report, &payload, &payload_len);
+    if (res != SUCCESS_RETURN) {
+        return res;
+    }
+
+    res = _dm_mgr_upstream_thing_property_send(node->devid, payload, payload_len, &publish_res);
+    DM_free(payload);
+    if (res < SUCCESS_RETURN || publish_res < SUCCESS_RETURN) {
+        /* values are kept waiting and sent again on next tick */
+        dm_log_debug("property report of devid %d not sent, retry later", node->devid);
+        return FAIL_RETURN;
+    }
+
+    dm_opt_get(DM_OPT_PROPERTY_REPORT_DELTA, &delta);
+    dm_prop_report_done(node->prop_report, delta);
+
+    return res;
+}
+
+int dm_mgr_upstream_thing_property_report(_IN_ int devid, _IN_ char *payload, _IN_ int payload_len)
+{
+    int res = 0, window_ms = 0, delta = 0;
+    dm_mgr_dev_node_t *node = NULL;
+
+    if (devid < 0 || payload == NULL || payload_len <= 0) {
+        return DM_INVALID_PARAMETER;
+    }
+
+    dm_opt_get(DM_OPT_PROPERTY_REPORT_WINDOW_MS, &window_ms);
+    if (window_ms <= 0) {
+        return dm_mgr_upstream_thing_property_post(devid, payload, payload_len);
+    }
+
+    res = _dm_mgr_search_dev_by_devid(devid, &node);
+    if (res != SUCCESS_RETURN) {
+        return FAIL_RETURN;
+    }
+
+    if (node->prop_report == NULL) {
+        node->prop_report = DM_malloc(sizeof(dm_prop_report_t));
+        if (node->prop_report == NULL) {
+            return DM_MEMORY_NOT_ENOUGH;
+        }
+        memset(node->prop_report, 0, sizeof(dm_prop_report_t));
+    }
+
+    /* each member takes no more room merged than in payload, so flush first if the whole payload may not fit,
+       payload is not merged while waiting values can not be sent, caller may post it again */
+    if (node->prop_report->waiting > 0 &&
+        node->prop_report->payload_len + payload_len > CONFIG_DM_PROP_REPORT_MAXLEN) {
+        res = _dm_mgr_upstream_thing_property_report_flush(node);
+        if (res < SUCCESS_RETURN) {
+            return FAIL_RETURN;
+        }
+    }
+
+    dm_opt_get(DM_OPT_PROPERTY_REPORT_DELTA, &delta);
+    res = dm_prop_report_merge(node->prop_report, payload, payload_len, delta);
+    if (res != SUCCESS_RETURN) {
+        return FAIL_RETURN;
+    }
+
+    /* merged, it is reported with others when window expires or payload is long enough,
+       a report that can not be sent now is kept and sent again on next tick */
+    if (node->prop_report->waiting > 0 && node->prop_report->payload_len >= CONFIG_DM_PROP_REPORT_MAXLEN) {
+        res = _dm_mgr_upstream_thing_property_report_flush(node);
+        if (res > SUCCESS_RETURN) {
+            return res;
+        }
+    }
+
+    return SUCCESS_RETURN;
+}
+
+void dm_mgr_upstream_thing_property_report_tick(void)
+{
+    int window_ms = 0;
+    uint64_t current_time = 0;
+    dm_mgr_ctx *ctx = _dm_mgr_get_ctx();
+    dm_mgr_dev_node_t *node = NULL;
+
+    dm_opt_get(DM_OPT_PROPERTY_REPORT_WINDOW_MS, &window_ms);
+    current_time = HAL_UptimeMs();
+
+    list_for_each_entry(node, &ctx->dev_list, linked_list, dm_mgr_dev_node_t) {
+        if (node->prop_report == NULL || node->prop_report->waiting == 0) {
+            continue;
+        }
+        /* values left over after merging is switched off are sent at once */
+        if (window_ms > 0 && current_time >= node->prop_report->first_ms &&
+            current_time - node->prop_report->first_ms < window_ms) {
+            continue;
+        }
+        _dm_mgr_upstream_thing_property_report_flush(node);
+    }
+}
+
 #ifdef LOG_REPORT_TO_CLOUD
 static unsigned int log_size = 0;
 int dm_mgr_upstream_thing_log_post(_IN_ int devid, _IN_ char *payload, _IN_ int payload_len, int force_upload)
@@ -2142,7 +2425,7 @@ int dm_mgr_deprecated_get_service_output_value(_IN_ int devid, _IN_ char *key, _
 }
 
 int dm_mgr_deprecated_assemble_property(_IN_ int devid, _IN_ char *identifier, _IN_ int identifier_len,
-                                        _IN_ lite_cjson_item_t *lite)
+                                        _IN_ lite_cjson_item_t *lite, _IN_ lite_cjson_arena_t *arena)
 {
     int res = 0;
     dm_mgr_dev_node_t *node = NULL;
@@ -2156,7 +2439,7 @@ int dm_mgr_deprecated_assemble_property(_IN_ int devid, _IN_ char *identifier, _
         return FAIL_RETURN;
     }
 
-    res = dm_shw_assemble_property(node->dev_shadow, identifier, identifier_len, lite);
+    res = dm_shw_assemble_property(node->dev_shadow, identifier, identifier_len, lite, arena);
     if (res != SUCCESS_RETURN) {
         return FAIL_RETURN;
     }
@@ -2165,7 +2448,7 @@ int dm_mgr_deprecated_assemble_property(_IN_ int devid, _IN_ char *identifier, _
 }
 
 int dm_mgr_deprecated_assemble_event_output(_IN_ int devid, _IN_ char *identifier, _IN_ int identifier_len,
-        _IN_ lite_cjson_item_t *lite)
+        _IN_ lite_cjson_item_t *lite, _IN_ lite_cjson_arena_t *arena)
 {
     int res = 0;
     dm_mgr_dev_node_t *node = NULL;
@@ -2179,7 +2462,7 @@ int dm_mgr_deprecated_assemble_event_output(_IN_ int devid, _IN_ char *identifie
         return FAIL_RETURN;
     }
 
-    res = dm_shw_assemble_event_output(node->dev_shadow, identifier, identifier_len, lite);
+    res = dm_shw_assemble_event_output(node->dev_shadow, identifier, identifier_len, lite, arena);
     if (res != SUCCESS_RETURN) {
         return FAIL_RETURN;
     }
@@ -2188,7 +2471,7 @@ int dm_mgr_deprecated_assemble_event_output(_IN_ int devid, _IN_ char *identifie
 }
 
 int dm_mgr_deprecated_assemble_service_output(_IN_ int devid, _IN_ char *identifier, _IN_ int identifier_len,
-        _IN_ lite_cjson_item_t *lite)
+        _IN_ lite_cjson_item_t *lite, _IN_ lite_cjson_arena_t *arena)
 {
     int res = 0;
     dm_mgr_dev_node_t *node = NULL;
@@ -2202,7 +2485,7 @@ int dm_mgr_deprecated_assemble_service_output(_IN_ int devid, _IN_ char *identif
         return FAIL_RETURN;
     }
 
-    res = dm_shw_assemble_service_output(node->dev_shadow, identifier, identifier_len, lite);
+    res = dm_shw_assemble_service_output(node->dev_shadow, identifier, identifier_len, lite, arena);
     if (res != SUCCESS_RETURN) {
         return FAIL_RETURN;
     }
@@ -9,6 +9,17 @@
 
 #include "iotx_dm_internal.h"
 
+/* upstream topics built once per device and kept with it, see _dm_mgr_topic() */
+typedef enum {
+    DM_MGR_TOPIC_MODEL_UP_RAW,
+#if !defined(DEVICE_MODEL_RAWDATA_SOLO)
+    DM_MGR_TOPIC_EVENT_PROPERTY_POST,
+    DM_MGR_TOPIC_DEVICEINFO_UPDATE,
+    DM_MGR_TOPIC_DEVICEINFO_DELETE,
+#endif
+    DM_MGR_TOPIC_NUM
+} dm_mgr_topic_t;
+
 typedef struct {
     int devid;
     int dev_type;
@@ -21,6 +32,12 @@ typedef struct {
     char device_secret[IOTX_DEVICE_SECRET_LEN + 1];
     iotx_dm_dev_avail_t status;
     iotx_dm_dev_status_t dev_status;
+    char *topics[DM_MGR_TOPIC_NUM];
+#if !defined(DEVICE_MODEL_RAWDATA_SOLO)
+    dm_prop_report_t *prop_report;
+#endif
+    struct list_head devid_linked;
+    struct list_head pkdn_linked;
     struct list_head linked_list;
 } dm_mgr_dev_node_t;
 
@@ -28,6 +45,8 @@ typedef struct {
     void *mutex;
     int global_devid;
     struct list_head dev_list;
+    struct list_head devid_hash[CONFIG_DM_DEV_HASH_SIZE];
+    struct list_head pkdn_hash[CONFIG_DM_DEV_HASH_SIZE];
 } dm_mgr_ctx;
 
 int dm_mgr_init(void);
@@ -65,10 +84,14 @@ int dm_mgr_upstream_thing_property_desired_delete(_IN_ int devid, _IN_ char *pay
     int dm_mgr_upstream_thing_list_found(_IN_ int devid);
     int dm_mgr_upstream_combine_login(_IN_ int devid);
     int dm_mgr_upstream_combine_logout(_IN_ int devid);
+    int dm_mgr_upstream_thing_topo_add_batch(_IN_ int *devids, _IN_ int devid_num);
+    int dm_mgr_upstream_combine_batch_login(_IN_ int *devids, _IN_ int devid_num);
 #endif
 int dm_mgr_upstream_thing_model_up_raw(_IN_ int devid, _IN_ char *payload, _IN_ int payload_len);
 #if !defined(DEVICE_MODEL_RAWDATA_SOLO)
 int dm_mgr_upstream_thing_property_post(_IN_ int devid, _IN_ char *payload, _IN_ int payload_len);
+int dm_mgr_upstream_thing_property_report(_IN_ int devid, _IN_ char *payload, _IN_ int payload_len);
+void dm_mgr_upstream_thing_property_report_tick(void);
 #ifdef LOG_REPORT_TO_CLOUD
     int dm_mgr_upstream_thing_log_post(_IN_ int devid, _IN_ char *payload, _IN_ int payload_len, int force_update);
 #endif
@@ -125,11 +148,11 @@ int dm_mgr_deprecated_set_service_output_value(_IN_ int devid, _IN_ char *key, _
         _IN_ int value_len);
 int dm_mgr_deprecated_get_service_output_value(_IN_ int devid, _IN_ char *key, _IN_ int key_len, _IN_ void *value);
 int dm_mgr_deprecated_assemble_property(_IN_ int devid, _IN_ char *identifier, _IN_ int identifier_len,
-                                        _IN_ lite_cjson_item_t *lite);
+                                        _IN_ lite_cjson_item_t *lite, _IN_ lite_cjson_arena_t *arena);
 int dm_mgr_deprecated_assemble_event_output(_IN_ int devid, _IN_ char *identifier, _IN_ int identifier_len,
-        _IN_ lite_cjson_item_t *lite);
+        _IN_ lite_cjson_item_t *lite, _IN_ lite_cjson_arena_t *arena);
 int dm_mgr_deprecated_assemble_service_output(_IN_ int devid, _IN_ char *identifier, _IN_ int identifier_len,
-        _IN_ lite_cjson_item_t *lite);
+        _IN_ lite_cjson_item_t *lite, _IN_ lite_cjson_arena_t *arena);
 int dm_mgr_deprecated_upstream_thing_service_response(_IN_ int devid, _IN_ int msgid, _IN_ iotx_dm_error_code_t code,
         _IN_ char *identifier, _IN_ int identifier_len, _IN_ char *payload, _IN_ int payload_len);
 #endif
@@ -40,6 +40,7 @@ int _dm_msg_send_to_user(iotx_dm_event_types_t type, char *message)
 
     dipc_msg->type = type;
     dipc_msg->data = message;
+    dipc_msg->event.type = type;
 
     res = dm_ipc_msg_insert((void *)dipc_msg);
     if (res != SUCCESS_RETURN) {
@@ -50,29 +51,285 @@ int _dm_msg_send_to_user(iotx_dm_event_types_t type, char *message)
     return SUCCESS_RETURN;
 }
 
-const char DM_MSG_SEND_MSG_TIMEOUT_FMT[] DM_READ_ONLY = "{\"id\":%d,\"code\":%d,\"devid\":%d}";
-int dm_msg_send_msg_timeout_to_user(int msg_id, int devid, iotx_dm_event_types_t type)
+dm_ipc_msg_t *dm_msg_event_new(iotx_dm_event_types_t type, int devid, int str_len)
 {
-    int res = 0, message_len = 0;
-    char *message = NULL;
+    int str_size = 0;
+    dm_ipc_msg_t *dipc_msg = NULL;
+
+    /* slices share one allocation with the message, one more byte for '\0' of each */
+    str_size = str_len + DM_MSG_EVENT_STR_NUM_MAX;
+
+    dipc_msg = DM_malloc(sizeof(dm_ipc_msg_t) + str_size);
+    if (dipc_msg == NULL) {
+        return NULL;
+    }
+    memset(dipc_msg, 0, sizeof(dm_ipc_msg_t));
+
+    dipc_msg->type = type;
+    dipc_msg->event.type = type;
+    dipc_msg->event.devid = devid;
+    dipc_msg->str_size = str_size;
+
+    return dipc_msg;
+}
+
+void dm_msg_event_str_set(dm_ipc_msg_t *msg, iotx_dm_event_str_t *str, const char *value, int value_len)
+{
+    char *buffer = (char *)(msg + 1);
+
+    /* a member missing from message is passed as empty string, as it was before typed events */
+    if (value == NULL || value_len < 0) {
+        value = "";
+        value_len = 0;
+    }
+
+    if (msg->str_used + value_len + 1 > msg->str_size) {
+        dm_log_err("event slice of %d bytes dropped", value_len);
+        return;
+    }
+
+    str->value = buffer + msg->str_used;
+    str->value_length = value_len;
+    memcpy(str->value, value, value_len);
+    str->value[value_len] = '\0';
+    msg->str_used += value_len + 1;
+}
+
+int dm_msg_event_send_to_user(dm_ipc_msg_t *msg)
+{
+    int res = 0;
+
+    res = dm_ipc_msg_insert((void *)msg);
+    if (res != SUCCESS_RETURN) {
+        DM_free(msg);
+        return FAIL_RETURN;
+    }
+
+    return SUCCESS_RETURN;
+}
+
+static int _dm_msg_reply_send_to_user(iotx_dm_event_types_t type, int id, int code, int devid)
+{
+    dm_ipc_msg_t *dipc_msg = NULL;
+
+    dipc_msg = dm_msg_event_new(type, devid, 0);
+    if (dipc_msg == NULL) {
+        return DM_MEMORY_NOT_ENOUGH;
+    }
+    dipc_msg->event.data.reply.id = id;
+    dipc_msg->event.data.reply.code = code;
+
+    return dm_msg_event_send_to_user(dipc_msg);
+}
+
+/* JSON formats of typed events, rendered only for iotx_dm_event_callback */
+const char DM_MSG_EVENT_REPLY_FMT[] DM_READ_ONLY = "{\"id\":%d,\"code\":%d,\"devid\":%d}";
+const char DM_MSG_EVENT_DEVID_FMT[] DM_READ_ONLY = "{\"devid\":%d}";
+const char DM_MSG_THING_MODEL_DOWN_FMT[] DM_READ_ONLY = "{\"devid\":%d,\"payload\":\"%.*s\"}";
+#if !defined(DEVICE_MODEL_RAWDATA_SOLO)
+#ifndef DEPRECATED_LINKKIT
+#ifdef LOG_REPORT_TO_CLOUD
+    const char DM_MSG_PROPERTY_SET_FMT[] DM_READ_ONLY = "{\"devid\":%d,\"payload\":%.*s,\"msgid\":%.*s}";
+#else
+    const char DM_MSG_PROPERTY_SET_FMT[] DM_READ_ONLY = "{\"devid\":%d,\"payload\":%.*s}";
+#endif
+const char DM_MSG_THING_PROPERTY_GET_FMT[] DM_READ_ONLY =
+            "{\"id\":\"%.*s\",\"devid\":%d,\"payload\":%.*s,\"ctx\":\"%s\"}";
+const char DM_MSG_SERVICE_REQUEST_FMT[] DM_READ_ONLY =
+            "{\"id\":\"%.*s\",\"devid\":%d,\"serviceid\":\"%.*s\",\"payload\":%.*s,\"ctx\":\"%s\"}";
+#endif
+const char DM_MSG_EVENT_RRPC_REQUEST_FMT[] DM_READ_ONLY =
+            "{\"id\":\"%.*s\",\"devid\":%d,\"serviceid\":\"%.*s\",\"rrpcid\":\"%.*s\",\"payload\":%.*s}";
+const char DM_MSG_EVENT_PROPERTY_POST_REPLY_FMT[] DM_READ_ONLY =
+            "{\"id\":%d,\"code\":%d,\"devid\":%d,\"payload\":%.*s}";
+const char DM_MSG_EVENT_SPECIFIC_POST_REPLY_FMT[] DM_READ_ONLY =
+            "{\"id\":%d,\"code\":%d,\"devid\":%d,\"eventid\":\"%.*s\",\"payload\":\"%.*s\"}";
+#ifdef DEVICE_MODEL_SHADOW
+const char DM_MSG_EVENT_PROPERTY_DESIRED_GET_REPLY_FMT[] DM_READ_ONLY = "{\"id\":%d,\"code\":%d,\"data\":%.*s}";
+const char DM_MSG_EVENT_PROPERTY_DESIRED_DELETE_REPLY_FMT[] DM_READ_ONLY =
+            "{\"id\":%d,\"code\":%d,\"data\":%.*s,\"devid\":%d}";
+#endif
+const char DM_MSG_THING_NTP_RESPONSE_FMT[] DM_READ_ONLY = "{\"utc\":\"%.*s\"}";
+#endif
+#ifdef DEVICE_MODEL_GATEWAY
+const char DM_MSG_TOPO_GET_REPLY_FMT[] DM_READ_ONLY = "{\"id\":%d,\"code\":%d,\"devid\":%d,\"topo\":%.*s}";
+#endif
+#if defined(OTA_ENABLED) && !defined(BUILD_AOS)
+const char DM_MSG_FOTA_NEW_FIRMWARE_FMT[] DM_READ_ONLY = "{\"version\":\"%.*s\"}";
+const char DM_MSG_COTA_NEW_CONFIG_FMT[] DM_READ_ONLY =
+            "{\"configId\":\"%.*s\",\"configSize\":%d,\"getType\":\"%.*s\",\"sign\":\"%.*s\",\"signMethod\":\"%.*s\",\"url\":\"%.*s\"}";
+#endif
+
+static const char *_dm_msg_event_fmt(iotx_dm_event_t *event)
+{
+    iotx_dm_event_reply_t *reply = &event->data.reply;
+
+    switch (event->type) {
+        case IOTX_DM_EVENT_CLOUD_CONNECTED:
+        case IOTX_DM_EVENT_CLOUD_DISCONNECT:
+        case IOTX_DM_EVENT_CLOUD_RECONNECT:
+            return NULL;
+        case IOTX_DM_EVENT_INITIALIZED:
+            return DM_MSG_EVENT_DEVID_FMT;
+        case IOTX_DM_EVENT_MODEL_DOWN_RAW:
+        case IOTX_DM_EVENT_MODEL_UP_RAW_REPLY:
+            return DM_MSG_THING_MODEL_DOWN_FMT;
+#if !defined(DEVICE_MODEL_RAWDATA_SOLO)
+#ifndef DEPRECATED_LINKKIT
+        case IOTX_DM_EVENT_PROPERTY_SET:
+            return DM_MSG_PROPERTY_SET_FMT;
+        case IOTX_DM_EVENT_PROPERTY_GET:
+            return DM_MSG_THING_PROPERTY_GET_FMT;
+        case IOTX_DM_EVENT_THING_SERVICE_REQUEST:
+            return DM_MSG_SERVICE_REQUEST_FMT;
+#endif
+        case IOTX_DM_EVENT_RRPC_REQUEST:
+            return DM_MSG_EVENT_RRPC_REQUEST_FMT;
+        case IOTX_DM_EVENT_NTP_RESPONSE:
+            return DM_MSG_THING_NTP_RESPONSE_FMT;
+        case IOTX_DM_EVENT_EVENT_PROPERTY_POST_REPLY:
+            return (reply->payload.value) ? (DM_MSG_EVENT_PROPERTY_POST_REPLY_FMT) : (DM_MSG_EVENT_REPLY_FMT);
+        case IOTX_DM_EVENT_EVENT_SPECIFIC_POST_REPLY:
+            return (reply->eventid.value) ? (DM_MSG_EVENT_SPECIFIC_POST_REPLY_FMT) : (DM_MSG_EVENT_REPLY_FMT);
+#ifdef DEVICE_MODEL_SHADOW
+        case IOTX_DM_EVENT_PROPERTY_DESIRED_GET_REPLY:
+            return (reply->payload.value) ? (DM_MSG_EVENT_PROPERTY_DESIRED_GET_REPLY_FMT) : (DM_MSG_EVENT_REPLY_FMT);
+        case IOTX_DM_EVENT_PROPERTY_DESIRED_DELETE_REPLY:
+            return (reply->payload.value) ? (DM_MSG_EVENT_PROPERTY_DESIRED_DELETE_REPLY_FMT) : (DM_MSG_EVENT_REPLY_FMT);
+#endif
+#endif
+#ifdef DEVICE_MODEL_GATEWAY
+        case IOTX_DM_EVENT_TOPO_GET_REPLY:
+            return (reply->payload.value) ? (DM_MSG_TOPO_GET_REPLY_FMT) : (DM_MSG_EVENT_REPLY_FMT);
+#endif
+#if defined(OTA_ENABLED) && !defined(BUILD_AOS)
+        case IOTX_DM_EVENT_FOTA_NEW_FIRMWARE:
+            return DM_MSG_FOTA_NEW_FIRMWARE_FMT;
+        case IOTX_DM_EVENT_COTA_NEW_CONFIG:
+            return DM_MSG_COTA_NEW_CONFIG_FMT;
+#endif
+        default:
+            /* other typed events are replies without payload */
+            return DM_MSG_EVENT_REPLY_FMT;
+    }
+}
+
+int dm_msg_event_render(dm_ipc_msg_t *msg)
+{
+    int message_len = 0;
+    const char *fmt = NULL;
+    char *message = NULL, *hexstr = NULL;
+    char ctx_addr_str[sizeof(uintptr_t) * 2 + 1] = {0};
+    iotx_dm_event_t *event = &msg->event;
+    iotx_dm_event_reply_t *reply = &event->data.reply;
+    iotx_dm_event_request_t *request = &event->data.request;
+
+    if (msg->data != NULL) {
+        return SUCCESS_RETURN;
+    }
+
+    fmt = _dm_msg_event_fmt(event);
+    if (fmt == NULL) {
+        return SUCCESS_RETURN;
+    }
+
+    if (event->type == IOTX_DM_EVENT_MODEL_DOWN_RAW || event->type == IOTX_DM_EVENT_MODEL_UP_RAW_REPLY) {
+        if (dm_utils_hex_to_str((unsigned char *)request->payload.value, request->payload.value_length,
+                                &hexstr) != SUCCESS_RETURN) {
+            return FAIL_RETURN;
+        }
+    } else if (event->type == IOTX_DM_EVENT_PROPERTY_GET || event->type == IOTX_DM_EVENT_THING_SERVICE_REQUEST) {
+        uintptr_t ctx_addr_num = (uintptr_t)request->ctx;
+        infra_hex2str((unsigned char *)&ctx_addr_num, sizeof(uintptr_t), ctx_addr_str);
+    }
 
-    message_len = strlen(DM_MSG_SEND_MSG_TIMEOUT_FMT) + DM_UTILS_UINT32_STRLEN * 3 + 1;
-    message = DM_malloc(message_len + 1);
+    /* every slice is printed at most once, raw data is printed in hex */
+    message_len = strlen(fmt) + DM_UTILS_UINT32_STRLEN * 3 + msg->str_used * 2 + sizeof(ctx_addr_str) + 1;
+    message = DM_malloc(message_len);
     if (message == NULL) {
+        if (hexstr) {
+            DM_free(hexstr);
+        }
         return DM_MEMORY_NOT_ENOUGH;
     }
     memset(message, 0, message_len);
-    HAL_Snprintf(message, message_len, DM_MSG_SEND_MSG_TIMEOUT_FMT, msg_id, IOTX_DM_ERR_CODE_TIMEOUT, devid);
 
-    res = _dm_msg_send_to_user(type, message);
-    if (res != SUCCESS_RETURN) {
-        DM_free(message);
-        return FAIL_RETURN;
+    if (fmt == DM_MSG_EVENT_REPLY_FMT) {
+        HAL_Snprintf(message, message_len, fmt, reply->id, reply->code, event->devid);
+    } else if (fmt == DM_MSG_EVENT_DEVID_FMT) {
+        HAL_Snprintf(message, message_len, fmt, event->devid);
+    } else if (fmt == DM_MSG_THING_MODEL_DOWN_FMT) {
+        HAL_Snprintf(message, message_len, fmt, event->devid, (int)strlen(hexstr), hexstr);
+        DM_free(hexstr);
     }
+#if !defined(DEVICE_MODEL_RAWDATA_SOLO)
+#ifndef DEPRECATED_LINKKIT
+    else if (fmt == DM_MSG_PROPERTY_SET_FMT) {
+#ifdef LOG_REPORT_TO_CLOUD
+        HAL_Snprintf(message, message_len, fmt, event->devid, request->payload.value_length, request->payload.value,
+                     request->id.value_length, request->id.value);
+#else
+        HAL_Snprintf(message, message_len, fmt, event->devid, request->payload.value_length, request->payload.value);
+#endif
+    } else if (fmt == DM_MSG_THING_PROPERTY_GET_FMT) {
+        HAL_Snprintf(message, message_len, fmt, request->id.value_length, request->id.value, event->devid,
+                     request->payload.value_length, request->payload.value, ctx_addr_str);
+    } else if (fmt == DM_MSG_SERVICE_REQUEST_FMT) {
+        HAL_Snprintf(message, message_len, fmt, request->id.value_length, request->id.value, event->devid,
+                     request->serviceid.value_length, request->serviceid.value,
+                     request->payload.value_length, request->payload.value, ctx_addr_str);
+    }
+#endif
+    else if (fmt == DM_MSG_EVENT_RRPC_REQUEST_FMT) {
+        HAL_Snprintf(message, message_len, fmt, request->id.value_length, request->id.value, event->devid,
+                     request->serviceid.value_length, request->serviceid.value,
+                     request->rrpcid.value_length, request->rrpcid.value,
+                     request->payload.value_length, request->payload.value);
+    } else if (fmt == DM_MSG_THING_NTP_RESPONSE_FMT) {
+        HAL_Snprintf(message, message_len, fmt, event->data.utc.value_length, event->data.utc.value);
+    } else if (fmt == DM_MSG_EVENT_PROPERTY_POST_REPLY_FMT) {
+        HAL_Snprintf(message, message_len, fmt, reply->id, reply->code, event->devid,
+                     reply->payload.value_length, reply->payload.value);
+    } else if (fmt == DM_MSG_EVENT_SPECIFIC_POST_REPLY_FMT) {
+        HAL_Snprintf(message, message_len, fmt, reply->id, reply->code, event->devid,
+                     reply->eventid.value_length, reply->eventid.value, reply->payload.value_length, reply->payload.value);
+    }
+#ifdef DEVICE_MODEL_SHADOW
+    else if (fmt == DM_MSG_EVENT_PROPERTY_DESIRED_GET_REPLY_FMT) {
+        HAL_Snprintf(message, message_len, fmt, reply->id, reply->code, reply->payload.value_length, reply->payload.value);
+    } else if (fmt == DM_MSG_EVENT_PROPERTY_DESIRED_DELETE_REPLY_FMT) {
+        HAL_Snprintf(message, message_len, fmt, reply->id, reply->code, reply->payload.value_length, reply->payload.value,
+                     event->devid);
+    }
+#endif
+#endif
+#ifdef DEVICE_MODEL_GATEWAY
+    else if (fmt == DM_MSG_TOPO_GET_REPLY_FMT) {
+        HAL_Snprintf(message, message_len, fmt, reply->id, reply->code, event->devid,
+                     reply->payload.value_length, reply->payload.value);
+    }
+#endif
+#if defined(OTA_ENABLED) && !defined(BUILD_AOS)
+    else if (fmt == DM_MSG_FOTA_NEW_FIRMWARE_FMT) {
+        HAL_Snprintf(message, message_len, fmt, event->data.version.value_length, event->data.version.value);
+    } else if (fmt == DM_MSG_COTA_NEW_CONFIG_FMT) {
+        iotx_dm_event_cota_t *cota = &event->data.cota;
+        HAL_Snprintf(message, message_len, fmt, cota->config_id.value_length, cota->config_id.value, cota->config_size,
+                     cota->get_type.value_length, cota->get_type.value, cota->sign.value_length, cota->sign.value,
+                     cota->sign_method.value_length, cota->sign_method.value, cota->url.value_length, cota->url.value);
+    }
+#endif
+
+    msg->data = message;
 
     return SUCCESS_RETURN;
 }
 
+int dm_msg_send_msg_timeout_to_user(int msg_id, int devid, iotx_dm_event_types_t type)
+{
+    return _dm_msg_reply_send_to_user(type, msg_id, IOTX_DM_ERR_CODE_TIMEOUT, devid);
+}
+
 int dm_msg_uri_parse_pkdn(_IN_ char *uri, _IN_ int uri_len, _IN_ int start_deli, _IN_ int end_deli,
                           _OU_ char product_key[IOTX_PRODUCT_KEY_LEN + 1], _OU_ char device_name[IOTX_DEVICE_NAME_LEN + 1])
 {
@@ -110,19 +367,26 @@ int dm_msg_uri_parse_pkdn(_IN_ char *uri, _IN_ int uri_len, _IN_ int start_deli,
 int dm_msg_request_parse(_IN_ char *payload, _IN_ int payload_len, _OU_ dm_msg_request_payload_t *request)
 {
     lite_cjson_t lite;
+    lite_cjson_node_t nodes[DM_MSG_INDEX_NODE_NUM];
+    lite_cjson_index_t index;
 
     if (payload == NULL || payload_len <= 0 || request == NULL) {
         return DM_INVALID_PARAMETER;
     }
 
-    if (dm_utils_json_parse(payload, payload_len, cJSON_Object, &lite) != SUCCESS_RETURN ||
-        dm_utils_json_object_item(&lite, DM_MSG_KEY_ID, strlen(DM_MSG_KEY_ID), cJSON_String, &request->id) != SUCCESS_RETURN ||
-        dm_utils_json_object_item(&lite, DM_MSG_KEY_VERSION, strlen(DM_MSG_KEY_VERSION), cJSON_String,
-                                  &request->version) != SUCCESS_RETURN ||
-        dm_utils_json_object_item(&lite, DM_MSG_KEY_METHOD, strlen(DM_MSG_KEY_METHOD), cJSON_String,
-                                  &request->method) != SUCCESS_RETURN ||
-        dm_utils_json_object_item(&lite, DM_MSG_KEY_PARAMS, strlen(DM_MSG_KEY_PARAMS), cJSON_Invalid,
-                                  &request->params) != SUCCESS_RETURN) {
+    index.nodes = nodes;
+    index.size = DM_MSG_INDEX_NODE_NUM;
+    index.depth = 1;
+    index.count = 0;
+
+    if (dm_utils_json_index_parse(payload, payload_len, cJSON_Object, &index, &lite) != SUCCESS_RETURN ||
+        dm_utils_json_index_item(&index, &lite, DM_MSG_KEY_ID, strlen(DM_MSG_KEY_ID), cJSON_String, &request->id) != SUCCESS_RETURN ||
+        dm_utils_json_index_item(&index, &lite, DM_MSG_KEY_VERSION, strlen(DM_MSG_KEY_VERSION), cJSON_String,
+                                 &request->version) != SUCCESS_RETURN ||
+        dm_utils_json_index_item(&index, &lite, DM_MSG_KEY_METHOD, strlen(DM_MSG_KEY_METHOD), cJSON_String,
+                                 &request->method) != SUCCESS_RETURN ||
+        dm_utils_json_index_item(&index, &lite, DM_MSG_KEY_PARAMS, strlen(DM_MSG_KEY_PARAMS), cJSON_Invalid,
+                                 &request->params) != SUCCESS_RETURN) {
         return FAIL_RETURN;
     }
 
@@ -137,17 +401,24 @@ int dm_msg_request_parse(_IN_ char *payload, _IN_ int payload_len, _OU_ dm_msg_r
 int dm_msg_response_parse(_IN_ char *payload, _IN_ int payload_len, _OU_ dm_msg_response_payload_t *response)
 {
     lite_cjson_t lite, lite_message;
+    lite_cjson_node_t nodes[DM_MSG_INDEX_NODE_NUM];
+    lite_cjson_index_t index;
 
     if (payload == NULL || payload_len <= 0 || response == NULL) {
         return DM_INVALID_PARAMETER;
     }
 
-    if (dm_utils_json_parse(payload, payload_len, cJSON_Object, &lite) != SUCCESS_RETURN ||
-        dm_utils_json_object_item(&lite, DM_MSG_KEY_ID, strlen(DM_MSG_KEY_ID), cJSON_String, &response->id) != SUCCESS_RETURN ||
-        dm_utils_json_object_item(&lite, DM_MSG_KEY_CODE, strlen(DM_MSG_KEY_CODE), cJSON_Number,
-                                  &response->code) != SUCCESS_RETURN ||
-        dm_utils_json_object_item(&lite, DM_MSG_KEY_DATA, strlen(DM_MSG_KEY_DATA), cJSON_Invalid,
-                                  &response->data) != SUCCESS_RETURN) {
+    index.nodes = nodes;
+    index.size = DM_MSG_INDEX_NODE_NUM;
+    index.depth = 1;
+    index.count = 0;
+
+    if (dm_utils_json_index_parse(payload, payload_len, cJSON_Object, &index, &lite) != SUCCESS_RETURN ||
+        dm_utils_json_index_item(&index, &lite, DM_MSG_KEY_ID, strlen(DM_MSG_KEY_ID), cJSON_String, &response->id) != SUCCESS_RETURN ||
+        dm_utils_json_index_item(&index, &lite, DM_MSG_KEY_CODE, strlen(DM_MSG_KEY_CODE), cJSON_Number,
+                                 &response->code) != SUCCESS_RETURN ||
+        dm_utils_json_index_item(&index, &lite, DM_MSG_KEY_DATA, strlen(DM_MSG_KEY_DATA), cJSON_Invalid,
+                                 &response->data) != SUCCESS_RETURN) {
         return FAIL_RETURN;
     }
 
@@ -156,76 +427,155 @@ int dm_msg_response_parse(_IN_ char *payload, _IN_ int payload_len, _OU_ dm_msg_
     dm_log_debug("Current Request Message Data: %.*s", response->data.value_length, response->data.value);
 
     memset(&lite_message, 0, sizeof(lite_cjson_t));
-    if (dm_utils_json_object_item(&lite, DM_MSG_KEY_MESSAGE, strlen(DM_MSG_KEY_MESSAGE), cJSON_Invalid,
-                                  &response->message) == SUCCESS_RETURN) {
+    if (dm_utils_json_index_item(&index, &lite, DM_MSG_KEY_MESSAGE, strlen(DM_MSG_KEY_MESSAGE), cJSON_Invalid,
+                                 &response->message) == SUCCESS_RETURN) {
         dm_log_debug("Current Request Message Desc: %.*s", response->message.value_length, response->message.value);
     }
 
     return SUCCESS_RETURN;
 }
 
-const char DM_MSG_REQUEST[] DM_READ_ONLY = "{\"id\":\"%d\",\"version\":\"%s\",\"params\":%.*s,\"method\":\"%s\"}";
+/* the payload_len + 1 bytes a payload needs are known after a write that did not fit */
+#define DM_MSG_WRITE_SHORT (-2)
+
+/* some callers count the terminator of params or data in their length, which "%.*s" used to drop */
+static int _dm_msg_raw_len(_IN_ const char *text, _IN_ int text_len)
+{
+    const char *end = memchr(text, '\0', text_len);
+
+    return (end != NULL) ? (int)(end - text) : text_len;
+}
+
+static int _dm_msg_request_write(_IN_ dm_msg_request_t *request, _IN_ char *buffer, _IN_ int size,
+                                 _OU_ int *payload_len)
+{
+    lite_cjson_writer_t writer;
+
+    lite_cjson_writer_init(&writer, buffer, size);
+    lite_cjson_writer_object_begin(&writer);
+    lite_cjson_writer_key(&writer, DM_MSG_KEY_ID, strlen(DM_MSG_KEY_ID));
+    lite_cjson_writer_int_string(&writer, request->msgid);
+    lite_cjson_writer_key(&writer, DM_MSG_KEY_VERSION, strlen(DM_MSG_KEY_VERSION));
+    lite_cjson_writer_string(&writer, DM_MSG_VERSION, strlen(DM_MSG_VERSION));
+    lite_cjson_writer_key(&writer, DM_MSG_KEY_PARAMS, strlen(DM_MSG_KEY_PARAMS));
+    lite_cjson_writer_raw(&writer, request->params, _dm_msg_raw_len(request->params, request->params_len));
+    lite_cjson_writer_key(&writer, DM_MSG_KEY_METHOD, strlen(DM_MSG_KEY_METHOD));
+    lite_cjson_writer_string(&writer, request->method, strlen(request->method));
+    lite_cjson_writer_object_end(&writer);
+
+    *payload_len = writer.len;
+    return lite_cjson_writer_end(&writer);
+}
+
 int dm_msg_request(dm_msg_dest_type_t type, _IN_ dm_msg_request_t *request)
 {
     int res = 0, payload_len = 0;
-    char *payload = NULL, *uri = NULL;
-    lite_cjson_t lite;
+    char payload_stack[CONFIG_DM_MSG_STACK_PAYLOAD_LEN];
+    char *payload = payload_stack, *uri = NULL, *uri_built = NULL;
 
-    if (request == NULL || request->params == NULL || request->method == NULL) {
+    if (request == NULL || request->params == NULL || request->params_len <= 0 || request->method == NULL) {
         return DM_INVALID_PARAMETER;
     }
 
     /* Request URI */
-    res = dm_utils_service_name(request->service_prefix, request->service_name,
-                                request->product_key, request->device_name, &uri);
-    if (res != SUCCESS_RETURN) {
-        return FAIL_RETURN;
+    if (request->topic != NULL) {
+        uri = (char *)request->topic;
+    } else {
+        res = dm_utils_service_name(request->service_prefix, request->service_name,
+                                    request->product_key, request->device_name, &uri_built);
+        if (res != SUCCESS_RETURN) {
+            return FAIL_RETURN;
+        }
+        uri = uri_built;
     }
 
-    payload_len = strlen(DM_MSG_REQUEST) + 10 + strlen(DM_MSG_VERSION) + request->params_len + strlen(
-                              request->method) + 1;
-    payload = DM_malloc(payload_len);
-    if (payload == NULL) {
-        DM_free(uri);
-        return DM_MEMORY_NOT_ENOUGH;
+#if CONFIG_DM_MSG_PARAMS_CHECK
+    /* params are json of caller and copied as they are, parsing them alone allocates nothing */
+    {
+        lite_cjson_t lite;
+
+        memset(&lite, 0, sizeof(lite_cjson_t));
+        if (lite_cjson_parse(request->params, _dm_msg_raw_len(request->params, request->params_len),
+                             &lite) < SUCCESS_RETURN) {
+            dm_log_info("Wrong JSON Format, URI: %s", uri);
+            if (uri_built != NULL) {
+                DM_free(uri_built);
+            }
+            return FAIL_RETURN;
+        }
     }
-    memset(payload, 0, payload_len);
-    HAL_Snprintf(payload, payload_len, DM_MSG_REQUEST, request->msgid,
-                 DM_MSG_VERSION, request->params_len, request->params, request->method);
+#endif
 
-    memset(&lite, 0, sizeof(lite_cjson_t));
-    res = lite_cjson_parse(payload, payload_len, &lite);
-    if (res < SUCCESS_RETURN) {
-        dm_log_info("Wrong JSON Format, URI: %s, Payload: %s", uri, payload);
-        DM_free(uri);
-        DM_free(payload);
+    /* the envelope is well formed as written */
+    res = _dm_msg_request_write(request, payload_stack, sizeof(payload_stack), &payload_len);
+    if (res == DM_MSG_WRITE_SHORT) {
+        payload = DM_malloc(payload_len + 1);
+        if (payload == NULL) {
+            if (uri_built != NULL) {
+                DM_free(uri_built);
+            }
+            return DM_MEMORY_NOT_ENOUGH;
+        }
+        res = _dm_msg_request_write(request, payload, payload_len + 1, &payload_len);
+    }
+    if (res != SUCCESS_RETURN) {
+        dm_log_info("Wrong JSON Format, URI: %s", uri);
+        if (uri_built != NULL) {
+            DM_free(uri_built);
+        }
+        if (payload != payload_stack) {
+            DM_free(payload);
+        }
         return FAIL_RETURN;
     }
 
     dm_log_info("DM Send Message, URI: %s, Payload: %s", uri, payload);
 
+    request->publish_res = SUCCESS_RETURN;
     if (type & DM_MSG_DEST_CLOUD) {
-        dm_client_publish(uri, (unsigned char *)payload, strlen(payload), request->callback);
+        request->publish_res = dm_client_publish(uri, (unsigned char *)payload, payload_len, request->callback);
     }
 
 #ifdef ALCS_ENABLED
     if (type & DM_MSG_DEST_LOCAL) {
-        dm_server_send(uri, (unsigned char *)payload, strlen(payload), NULL);
+        dm_server_send(uri, (unsigned char *)payload, payload_len, NULL);
     }
 #endif
 
-    DM_free(uri);
-    DM_free(payload);
+    if (uri_built != NULL) {
+        DM_free(uri_built);
+    }
+    if (payload != payload_stack) {
+        DM_free(payload);
+    }
     return SUCCESS_RETURN;
 }
 
-const char DM_MSG_RESPONSE_WITH_DATA[] DM_READ_ONLY = "{\"id\":\"%.*s\",\"code\":%d,\"data\":%.*s}";
+static int _dm_msg_response_write(_IN_ dm_msg_request_payload_t *request, _IN_ dm_msg_response_t *response,
+                                  _IN_ char *data, _IN_ int data_len, _IN_ char *buffer, _IN_ int size, _OU_ int *payload_len)
+{
+    lite_cjson_writer_t writer;
+
+    lite_cjson_writer_init(&writer, buffer, size);
+    lite_cjson_writer_object_begin(&writer);
+    lite_cjson_writer_key(&writer, DM_MSG_KEY_ID, strlen(DM_MSG_KEY_ID));
+    lite_cjson_writer_string(&writer, request->id.value, request->id.value_length);
+    lite_cjson_writer_key(&writer, DM_MSG_KEY_CODE, strlen(DM_MSG_KEY_CODE));
+    lite_cjson_writer_int(&writer, response->code);
+    lite_cjson_writer_key(&writer, DM_MSG_KEY_DATA, strlen(DM_MSG_KEY_DATA));
+    lite_cjson_writer_raw(&writer, data, _dm_msg_raw_len(data, data_len));
+    lite_cjson_writer_object_end(&writer);
+
+    *payload_len = writer.len;
+    return lite_cjson_writer_end(&writer);
+}
+
 int dm_msg_response(dm_msg_dest_type_t type, _IN_ dm_msg_request_payload_t *request, _IN_ dm_msg_response_t *response,
                     _IN_ char *data, _IN_ int data_len, _IN_ void *user_data)
 {
     int res = 0, payload_len = 0;
-    char *uri = NULL, *payload = NULL;
-    lite_cjson_t lite;
+    char payload_stack[CONFIG_DM_MSG_STACK_PAYLOAD_LEN];
+    char *uri = NULL, *payload = payload_stack;
 
     if (request == NULL || response == NULL || data == NULL || data_len <= 0) {
         return DM_INVALID_PARAMETER;
@@ -239,29 +589,28 @@ int dm_msg_response(dm_msg_dest_type_t type, _IN_ dm_msg_request_payload_t *requ
     }
 
     /* Response Payload */
-    payload_len = strlen(DM_MSG_RESPONSE_WITH_DATA) + request->id.value_length + DM_UTILS_UINT32_STRLEN + data_len + 1;
-    payload = DM_malloc(payload_len);
-    if (payload == NULL) {
-        DM_free(uri);
-        return DM_MEMORY_NOT_ENOUGH;
+    res = _dm_msg_response_write(request, response, data, data_len, payload_stack, sizeof(payload_stack), &payload_len);
+    if (res == DM_MSG_WRITE_SHORT) {
+        payload = DM_malloc(payload_len + 1);
+        if (payload == NULL) {
+            DM_free(uri);
+            return DM_MEMORY_NOT_ENOUGH;
+        }
+        res = _dm_msg_response_write(request, response, data, data_len, payload, payload_len + 1, &payload_len);
     }
-    memset(payload, 0, payload_len);
-    HAL_Snprintf(payload, payload_len, DM_MSG_RESPONSE_WITH_DATA,
-                 request->id.value_length, request->id.value, response->code, data_len, data);
-
-    memset(&lite, 0, sizeof(lite_cjson_t));
-    res = lite_cjson_parse(payload, payload_len, &lite);
-    if (res < SUCCESS_RETURN) {
-        dm_log_info("Wrong JSON Format, URI: %s, Payload: %s", uri, payload);
+    if (res != SUCCESS_RETURN) {
+        dm_log_info("Wrong JSON Format, URI: %s", uri);
         DM_free(uri);
-        DM_free(payload);
+        if (payload != payload_stack) {
+            DM_free(payload);
+        }
         return FAIL_RETURN;
     }
 
     dm_log_info("Send URI: %s, Payload: %s", uri, payload);
 
     if (type & DM_MSG_DEST_CLOUD) {
-        dm_client_publish(uri, (unsigned char *)payload, strlen(payload), NULL);
+        dm_client_publish(uri, (unsigned char *)payload, payload_len, NULL);
     }
 
 #ifdef ALCS_ENABLED
@@ -275,26 +624,26 @@ int dm_msg_response(dm_msg_dest_type_t type, _IN_ dm_msg_request_payload_t *requ
             if (strstr(end, "_reply") != 0) {
                 *end = '\0';
             }
-            dm_server_send(uri, (unsigned char *)payload, strlen(payload), user_data);
+            dm_server_send(uri, (unsigned char *)payload, payload_len, user_data);
         } while (0);
 
     }
 #endif
 
     DM_free(uri);
-    DM_free(payload);
+    if (payload != payload_stack) {
+        DM_free(payload);
+    }
 
     return SUCCESS_RETURN;
 }
 
 
-const char DM_MSG_THING_MODEL_DOWN_FMT[] DM_READ_ONLY = "{\"devid\":%d,\"payload\":\"%.*s\"}";
-int dm_msg_thing_model_down_raw(_IN_ char product_key[IOTX_PRODUCT_KEY_LEN + 1],
-                                _IN_ char device_name[IOTX_DEVICE_NAME_LEN + 1],
-                                _IN_ char *payload, _IN_ int payload_len)
+static int _dm_msg_raw_data_send_to_user(iotx_dm_event_types_t type, _IN_ char product_key[IOTX_PRODUCT_KEY_LEN + 1],
+        _IN_ char device_name[IOTX_DEVICE_NAME_LEN + 1], _IN_ char *payload, _IN_ int payload_len)
 {
-    int res = 0, devid = 0, message_len = 0;
-    char *hexstr = NULL, *message = NULL;
+    int res = 0, devid = 0;
+    dm_ipc_msg_t *dipc_msg = NULL;
 
     if (product_key == NULL || device_name == NULL ||
         (strlen(product_key) >= IOTX_PRODUCT_KEY_LEN + 1) ||
@@ -308,157 +657,74 @@ int dm_msg_thing_model_down_raw(_IN_ char product_key[IOTX_PRODUCT_KEY_LEN + 1],
         return FAIL_RETURN;
     }
 
-    res = dm_utils_hex_to_str((unsigned char *)payload, payload_len, &hexstr);
-    if (res != SUCCESS_RETURN) {
-        return FAIL_RETURN;
-    }
-
-    message_len = strlen(DM_MSG_THING_MODEL_DOWN_FMT) + DM_UTILS_UINT32_STRLEN + strlen(hexstr) + 1;
-    message = DM_malloc(message_len);
-    if (message == NULL) {
-        DM_free(hexstr);
+    /* raw data is carried in binary, hex string is only rendered for iotx_dm_event_callback */
+    dipc_msg = dm_msg_event_new(type, devid, payload_len);
+    if (dipc_msg == NULL) {
         return DM_MEMORY_NOT_ENOUGH;
     }
-    memset(message, 0, message_len);
-    HAL_Snprintf(message, message_len, DM_MSG_THING_MODEL_DOWN_FMT, devid, strlen(hexstr), hexstr);
-    DM_free(hexstr);
+    dm_msg_event_str_set(dipc_msg, &dipc_msg->event.data.request.payload, payload, payload_len);
 
-    res = _dm_msg_send_to_user(IOTX_DM_EVENT_MODEL_DOWN_RAW, message);
-    if (res != SUCCESS_RETURN) {
-        DM_free(message);
-        return FAIL_RETURN;
-    }
-
-    return SUCCESS_RETURN;
+    return dm_msg_event_send_to_user(dipc_msg);
 }
 
+int dm_msg_thing_model_down_raw(_IN_ char product_key[IOTX_PRODUCT_KEY_LEN + 1],
+                                _IN_ char device_name[IOTX_DEVICE_NAME_LEN + 1],
+                                _IN_ char *payload, _IN_ int payload_len)
+{
+    return _dm_msg_raw_data_send_to_user(IOTX_DM_EVENT_MODEL_DOWN_RAW, product_key, device_name, payload, payload_len);
+}
 
-const char DM_MSG_THING_MODEL_UP_RAW_REPLY_FMT[] DM_READ_ONLY = "{\"devid\":%d,\"payload\":\"%.*s\"}";
 int dm_msg_thing_model_up_raw_reply(_IN_ char product_key[IOTX_PRODUCT_KEY_LEN + 1],
                                     _IN_ char device_name[IOTX_DEVICE_NAME_LEN + 1], char *payload, int payload_len)
 {
-    int res = 0, devid = 0, message_len = 0;
-    char *hexstr = NULL, *message = NULL;
-
-    if (product_key == NULL || device_name == NULL ||
-        (strlen(product_key) >= IOTX_PRODUCT_KEY_LEN + 1) ||
-        (strlen(device_name) >= IOTX_DEVICE_NAME_LEN + 1) ||
-        payload == NULL || payload_len <= 0) {
-        return DM_INVALID_PARAMETER;
-    }
-
-    res = dm_mgr_search_device_by_pkdn(product_key, device_name, &devid);
-    if (res != SUCCESS_RETURN) {
-        return FAIL_RETURN;
-    }
-
-    res = dm_utils_hex_to_str((unsigned char *)payload, payload_len, &hexstr);
-    if (res != SUCCESS_RETURN) {
-        return FAIL_RETURN;
-    }
-
-    message_len = strlen(DM_MSG_THING_MODEL_DOWN_FMT) + DM_UTILS_UINT32_STRLEN + strlen(hexstr) + 1;
-    message = DM_malloc(message_len);
-    if (message == NULL) {
-        DM_free(hexstr);
-        return DM_MEMORY_NOT_ENOUGH;
-    }
-    memset(message, 0, message_len);
-    HAL_Snprintf(message, message_len, DM_MSG_THING_MODEL_DOWN_FMT, devid, strlen(hexstr), hexstr);
-    DM_free(hexstr);
-
-    res = _dm_msg_send_to_user(IOTX_DM_EVENT_MODEL_UP_RAW_REPLY, message);
-    if (res != SUCCESS_RETURN) {
-        DM_free(message);
-        return FAIL_RETURN;
-    }
-
-    return SUCCESS_RETURN;
+    return _dm_msg_raw_data_send_to_user(IOTX_DM_EVENT_MODEL_UP_RAW_REPLY, product_key, device_name, payload,
+                                         payload_len);
 }
 
 #if !defined(DEVICE_MODEL_RAWDATA_SOLO)
 #ifndef DEPRECATED_LINKKIT
-#ifdef LOG_REPORT_TO_CLOUD
-    const char DM_MSG_PROPERTY_SET_FMT[] DM_READ_ONLY = "{\"devid\":%d,\"payload\":%.*s,\"msgid\":%.*s}";
-#else
-    const char DM_MSG_PROPERTY_SET_FMT[] DM_READ_ONLY = "{\"devid\":%d,\"payload\":%.*s}";
-#endif
 int dm_msg_property_set(int devid, dm_msg_request_payload_t *request)
 {
-    int res = 0, message_len = 0;
-    char *message = NULL;
+    dm_ipc_msg_t *dipc_msg = NULL;
+    iotx_dm_event_request_t *event_request = NULL;
 
-    message_len = strlen(DM_MSG_PROPERTY_SET_FMT) + DM_UTILS_UINT32_STRLEN + request->params.value_length + 1;
-    message = DM_malloc(message_len);
-    if (message == NULL) {
+    dipc_msg = dm_msg_event_new(IOTX_DM_EVENT_PROPERTY_SET, devid,
+                                request->id.value_length + request->params.value_length);
+    if (dipc_msg == NULL) {
         return DM_MEMORY_NOT_ENOUGH;
     }
-    memset(message, 0, message_len);
-#ifdef LOG_REPORT_TO_CLOUD
-    HAL_Snprintf(message, message_len, DM_MSG_PROPERTY_SET_FMT, devid, request->params.value_length, request->params.value,
-                 request->id.value_length, request->id.value);
-#else
-    HAL_Snprintf(message, message_len, DM_MSG_PROPERTY_SET_FMT, devid, request->params.value_length, request->params.value);
-#endif
-    res = _dm_msg_send_to_user(IOTX_DM_EVENT_PROPERTY_SET, message);
-    if (res != SUCCESS_RETURN) {
-        DM_free(message);
-        return FAIL_RETURN;
-    }
-    return SUCCESS_RETURN;
+    event_request = &dipc_msg->event.data.request;
+    dm_msg_event_str_set(dipc_msg, &event_request->id, request->id.value, request->id.value_length);
+    dm_msg_event_str_set(dipc_msg, &event_request->payload, request->params.value, request->params.value_length);
+
+    return dm_msg_event_send_to_user(dipc_msg);
 }
 
-const char DM_MSG_THING_PROPERTY_GET_FMT[] DM_READ_ONLY =
-            "{\"id\":\"%.*s\",\"devid\":%d,\"payload\":%.*s,\"ctx\":\"%s\"}";
 int dm_msg_property_get(_IN_ int devid, _IN_ dm_msg_request_payload_t *request, _IN_ void *ctx)
 {
-    int res = 0, message_len = 0;
-    uintptr_t ctx_addr_num = (uintptr_t)ctx;
-    char *ctx_addr_str = NULL, *message = NULL;
-
-    ctx_addr_str = DM_malloc(sizeof(uintptr_t) * 2 + 1);
-    if (ctx_addr_str == NULL) {
-        return DM_MEMORY_NOT_ENOUGH;
-    }
-    memset(ctx_addr_str, 0, sizeof(uintptr_t) * 2 + 1);
-
-    /*  dm_log_debug("ctx: %p", ctx);
-     dm_log_debug("ctx_addr_num: %0x016llX", ctx_addr_num); */
-    infra_hex2str((unsigned char *)&ctx_addr_num, sizeof(uintptr_t), ctx_addr_str);
-    /* dm_log_debug("ctx_addr_str: %s", ctx_addr_str); */
+    dm_ipc_msg_t *dipc_msg = NULL;
+    iotx_dm_event_request_t *event_request = NULL;
 
-    message_len = strlen(DM_MSG_THING_PROPERTY_GET_FMT) + request->id.value_length + DM_UTILS_UINT32_STRLEN +
-                  request->params.value_length + strlen(ctx_addr_str) + 1;
-    message = DM_malloc(message_len);
-    if (message == NULL) {
-        DM_free(ctx_addr_str);
+    dipc_msg = dm_msg_event_new(IOTX_DM_EVENT_PROPERTY_GET, devid,
+                                request->id.value_length + request->params.value_length);
+    if (dipc_msg == NULL) {
         return DM_MEMORY_NOT_ENOUGH;
     }
-    memset(message, 0, message_len);
-    HAL_Snprintf(message, message_len, DM_MSG_THING_PROPERTY_GET_FMT, request->id.value_length, request->id.value, devid,
-                 request->params.value_length, request->params.value, ctx_addr_str);
-
-    DM_free(ctx_addr_str);
-
-    res = _dm_msg_send_to_user(IOTX_DM_EVENT_PROPERTY_GET, message);
-    if (res != SUCCESS_RETURN) {
-        DM_free(message);
-        return FAIL_RETURN;
-    }
+    event_request = &dipc_msg->event.data.request;
+    dm_msg_event_str_set(dipc_msg, &event_request->id, request->id.value, request->id.value_length);
+    dm_msg_event_str_set(dipc_msg, &event_request->payload, request->params.value, request->params.value_length);
+    event_request->ctx = ctx;
 
-    return SUCCESS_RETURN;
+    return dm_msg_event_send_to_user(dipc_msg);
 }
 
-const char DM_MSG_SERVICE_REQUEST_FMT[] DM_READ_ONLY =
-            "{\"id\":\"%.*s\",\"devid\":%d,\"serviceid\":\"%.*s\",\"payload\":%.*s,\"ctx\":\"%s\"}";
 int dm_msg_thing_service_request(_IN_ char product_key[IOTX_PRODUCT_KEY_LEN + 1],
                                  _IN_ char device_name[IOTX_DEVICE_NAME_LEN + 1],
                                  char *identifier, int identifier_len, dm_msg_request_payload_t *request,  _IN_ void *ctx)
 {
-    int res = 0, devid = 0, message_len = 0;
-    char *message = NULL;
-    uintptr_t ctx_addr_num = (uintptr_t)ctx;
-    char *ctx_addr_str = NULL;
+    int res = 0, devid = 0;
+    dm_ipc_msg_t *dipc_msg = NULL;
+    iotx_dm_event_request_t *event_request = NULL;
 
     res = dm_mgr_search_device_by_pkdn(product_key, device_name, &devid);
     if (res != SUCCESS_RETURN) {
@@ -472,46 +738,30 @@ int dm_msg_thing_service_request(_IN_ char product_key[IOTX_PRODUCT_KEY_LEN + 1]
     }
 #endif
 
-    ctx_addr_str = DM_malloc(sizeof(uintptr_t) * 2 + 1);
-    if (ctx_addr_str == NULL) {
-        return DM_MEMORY_NOT_ENOUGH;
-    }
-    memset(ctx_addr_str, 0, sizeof(uintptr_t) * 2 + 1);
-    infra_hex2str((unsigned char *)&ctx_addr_num, sizeof(uintptr_t), ctx_addr_str);
-
-    message_len = strlen(DM_MSG_SERVICE_REQUEST_FMT) + request->id.value_length + DM_UTILS_UINT32_STRLEN + identifier_len +
-                  request->params.value_length + strlen(ctx_addr_str)  + 1;
-    message = DM_malloc(message_len);
-    if (message == NULL) {
-        DM_free(ctx_addr_str);
+    dipc_msg = dm_msg_event_new(IOTX_DM_EVENT_THING_SERVICE_REQUEST, devid,
+                                request->id.value_length + identifier_len + request->params.value_length);
+    if (dipc_msg == NULL) {
         return DM_MEMORY_NOT_ENOUGH;
     }
+    event_request = &dipc_msg->event.data.request;
+    dm_msg_event_str_set(dipc_msg, &event_request->id, request->id.value, request->id.value_length);
+    dm_msg_event_str_set(dipc_msg, &event_request->serviceid, identifier, identifier_len);
+    dm_msg_event_str_set(dipc_msg, &event_request->payload, request->params.value, request->params.value_length);
+    event_request->ctx = ctx;
 
-    memset(message, 0, message_len);
-    HAL_Snprintf(message, message_len, DM_MSG_SERVICE_REQUEST_FMT, request->id.value_length, request->id.value, devid,
-                 identifier_len, identifier,
-                 request->params.value_length, request->params.value, ctx_addr_str);
-
-    DM_free(ctx_addr_str);
-    res = _dm_msg_send_to_user(IOTX_DM_EVENT_THING_SERVICE_REQUEST, message);
-    if (res != SUCCESS_RETURN) {
-        DM_free(message);
-        return FAIL_RETURN;
-    }
-
-    return SUCCESS_RETURN;
+    return dm_msg_event_send_to_user(dipc_msg);
 }
 #endif
 
-const char DM_MSG_EVENT_RRPC_REQUEST_FMT[] DM_READ_ONLY =
-            "{\"id\":\"%.*s\",\"devid\":%d,\"serviceid\":\"%.*s\",\"rrpcid\":\"%.*s\",\"payload\":%.*s}";
 int dm_msg_rrpc_request(_IN_ char product_key[IOTX_PRODUCT_KEY_LEN + 1],
                         _IN_ char device_name[IOTX_DEVICE_NAME_LEN + 1],
                         char *rrpcid, int rrpcid_len, dm_msg_request_payload_t *request)
 {
-    int res = 0, devid = 0, message_len = 0;
+    int res = 0, devid = 0;
     int service_offset = 0, serviceid_len = 0;
-    char *serviceid = NULL, *message = NULL;
+    char *serviceid = NULL;
+    dm_ipc_msg_t *dipc_msg = NULL;
+    iotx_dm_event_request_t *event_request = NULL;
 
     /* Get Devid */
     res = dm_mgr_search_device_by_pkdn(product_key, device_name, &devid);
@@ -529,34 +779,26 @@ int dm_msg_rrpc_request(_IN_ char product_key[IOTX_PRODUCT_KEY_LEN + 1],
     /* dm_log_info("Current RRPC Service ID: %.*s", serviceid_len, serviceid); */
 
     /* Send Message To User */
-    message_len = strlen(DM_MSG_EVENT_RRPC_REQUEST_FMT) + request->id.value_length + DM_UTILS_UINT32_STRLEN + serviceid_len
-                  + rrpcid_len +
-                  request->params.value_length + 1;
-    message = DM_malloc(message_len);
-    if (message == NULL) {
+    dipc_msg = dm_msg_event_new(IOTX_DM_EVENT_RRPC_REQUEST, devid,
+                                request->id.value_length + serviceid_len + rrpcid_len + request->params.value_length);
+    if (dipc_msg == NULL) {
         return DM_MEMORY_NOT_ENOUGH;
     }
-    memset(message, 0, message_len);
-    HAL_Snprintf(message, message_len, DM_MSG_EVENT_RRPC_REQUEST_FMT, request->id.value_length, request->id.value, devid,
-                 serviceid_len, serviceid, rrpcid_len, rrpcid,
-                 request->params.value_length, request->params.value);
-
-    res = _dm_msg_send_to_user(IOTX_DM_EVENT_RRPC_REQUEST, message);
-    if (res != SUCCESS_RETURN) {
-        DM_free(message);
-        return FAIL_RETURN;
-    }
+    event_request = &dipc_msg->event.data.request;
+    dm_msg_event_str_set(dipc_msg, &event_request->id, request->id.value, request->id.value_length);
+    dm_msg_event_str_set(dipc_msg, &event_request->serviceid, serviceid, serviceid_len);
+    dm_msg_event_str_set(dipc_msg, &event_request->rrpcid, rrpcid, rrpcid_len);
+    dm_msg_event_str_set(dipc_msg, &event_request->payload, request->params.value, request->params.value_length);
 
-    return SUCCESS_RETURN;
+    return dm_msg_event_send_to_user(dipc_msg);
 }
 
-const char DM_MSG_EVENT_PROPERTY_POST_REPLY_FMT[] DM_READ_ONLY =
-            "{\"id\":%d,\"code\":%d,\"devid\":%d,\"payload\":%.*s}";
 int dm_msg_thing_event_property_post_reply(dm_msg_response_payload_t *response)
 {
-    int res = 0, devid = 0, id = 0, message_len = 0, payload_len = 0;
-    char *message = NULL, *payload = NULL;
+    int res = 0, devid = 0, id = 0, payload_len = 0;
+    char *payload = NULL;
     char int_id[DM_UTILS_UINT32_STRLEN] = {0};
+    dm_ipc_msg_t *dipc_msg = NULL;
 #if !defined(DM_MESSAGE_CACHE_DISABLED)
     dm_msg_cache_node_t *node = NULL;
 #endif
@@ -587,33 +829,23 @@ int dm_msg_thing_event_property_post_reply(dm_msg_response_payload_t *response)
         payload_len = response->message.value_length;
     }
 
-    message_len = strlen(DM_MSG_EVENT_PROPERTY_POST_REPLY_FMT) + DM_UTILS_UINT32_STRLEN * 3 + payload_len +
-                  1;
-    message = DM_malloc(message_len);
-    if (message == NULL) {
+    dipc_msg = dm_msg_event_new(IOTX_DM_EVENT_EVENT_PROPERTY_POST_REPLY, devid, payload_len);
+    if (dipc_msg == NULL) {
         return DM_MEMORY_NOT_ENOUGH;
     }
-    memset(message, 0, message_len);
-    HAL_Snprintf(message, message_len, DM_MSG_EVENT_PROPERTY_POST_REPLY_FMT, id, response->code.value_int, devid,
-                 payload_len, payload);
+    dipc_msg->event.data.reply.id = id;
+    dipc_msg->event.data.reply.code = response->code.value_int;
+    dm_msg_event_str_set(dipc_msg, &dipc_msg->event.data.reply.payload, payload, payload_len);
 
-    res = _dm_msg_send_to_user(IOTX_DM_EVENT_EVENT_PROPERTY_POST_REPLY, message);
-    if (res != SUCCESS_RETURN) {
-        DM_free(message);
-        return FAIL_RETURN;
-    }
-
-    return SUCCESS_RETURN;
+    return dm_msg_event_send_to_user(dipc_msg);
 }
 
-const char DM_MSG_EVENT_SPECIFIC_POST_REPLY_FMT[] DM_READ_ONLY =
-            "{\"id\":%d,\"code\":%d,\"devid\":%d,\"eventid\":\"%.*s\",\"payload\":\"%.*s\"}";
 int dm_msg_thing_event_post_reply(_IN_ char *identifier, _IN_ int identifier_len,
                                   _IN_ dm_msg_response_payload_t *response)
 {
-    int res = 0, devid = 0, id = 0, message_len = 0;
-    char *message = NULL;
+    int res = 0, devid = 0, id = 0;
     char int_id[DM_UTILS_UINT32_STRLEN] = {0};
+    dm_ipc_msg_t *dipc_msg = NULL;
 #if !defined(DM_MESSAGE_CACHE_DISABLED)
     dm_msg_cache_node_t *node = NULL;
 #endif
@@ -634,31 +866,25 @@ int dm_msg_thing_event_post_reply(_IN_ char *identifier, _IN_ int identifier_len
     devid = node->devid;
 #endif
 
-    message_len = strlen(DM_MSG_EVENT_SPECIFIC_POST_REPLY_FMT) + DM_UTILS_UINT32_STRLEN * 3 + strlen(
-                              identifier) + response->message.value_length + 1;
-    message = DM_malloc(message_len);
-    if (message == NULL) {
+    dipc_msg = dm_msg_event_new(IOTX_DM_EVENT_EVENT_SPECIFIC_POST_REPLY, devid,
+                                identifier_len + response->message.value_length);
+    if (dipc_msg == NULL) {
         return DM_MEMORY_NOT_ENOUGH;
     }
-    memset(message, 0, message_len);
-    HAL_Snprintf(message, message_len, DM_MSG_EVENT_SPECIFIC_POST_REPLY_FMT, id, response->code.value_int, devid,
-                 identifier_len, identifier, response->message.value_length, response->message.value);
+    dipc_msg->event.data.reply.id = id;
+    dipc_msg->event.data.reply.code = response->code.value_int;
+    dm_msg_event_str_set(dipc_msg, &dipc_msg->event.data.reply.eventid, identifier, identifier_len);
+    dm_msg_event_str_set(dipc_msg, &dipc_msg->event.data.reply.payload, response->message.value,
+                         response->message.value_length);
 
-    res = _dm_msg_send_to_user(IOTX_DM_EVENT_EVENT_SPECIFIC_POST_REPLY, message);
-    if (res != SUCCESS_RETURN) {
-        DM_free(message);
-        return FAIL_RETURN;
-    }
-
-    return SUCCESS_RETURN;
+    return dm_msg_event_send_to_user(dipc_msg);
 }
 #ifdef DEVICE_MODEL_SHADOW
-const char DM_MSG_EVENT_PROPERTY_DESIRED_GET_REPLY_FMT[] DM_READ_ONLY = "{\"id\":%d,\"code\":%d,\"data\":%.*s}";
 int dm_msg_thing_property_desired_get_reply(dm_msg_response_payload_t *response)
 {
-    int res = 0, id = 0, message_len = 0;
-    char *message = NULL;
+    int res = 0, id = 0;
     char int_id[DM_UTILS_UINT32_STRLEN] = {0};
+    dm_ipc_msg_t *dipc_msg = NULL;
 #if !defined(DM_MESSAGE_CACHE_DISABLED)
     dm_msg_cache_node_t *node = NULL;
 #endif
@@ -677,32 +903,24 @@ int dm_msg_thing_property_desired_get_reply(dm_msg_response_payload_t *response)
     }
 #endif
 
-    message_len = strlen(DM_MSG_EVENT_PROPERTY_DESIRED_GET_REPLY_FMT) + DM_UTILS_UINT32_STRLEN * 2 + 1 +
-                  response->data.value_length;
-    message = DM_malloc(message_len);
-    if (message == NULL) {
+    dipc_msg = dm_msg_event_new(IOTX_DM_EVENT_PROPERTY_DESIRED_GET_REPLY, IOTX_DM_LOCAL_NODE_DEVID,
+                                response->data.value_length);
+    if (dipc_msg == NULL) {
         return DM_MEMORY_NOT_ENOUGH;
     }
-    memset(message, 0, message_len);
-    HAL_Snprintf(message, message_len, DM_MSG_EVENT_PROPERTY_DESIRED_GET_REPLY_FMT, id, response->code.value_int,
-                 response->data.value_length, response->data.value);
-
-    res = _dm_msg_send_to_user(IOTX_DM_EVENT_PROPERTY_DESIRED_GET_REPLY, message);
-    if (res != SUCCESS_RETURN) {
-        DM_free(message);
-        return FAIL_RETURN;
-    }
+    dipc_msg->event.data.reply.id = id;
+    dipc_msg->event.data.reply.code = response->code.value_int;
+    dm_msg_event_str_set(dipc_msg, &dipc_msg->event.data.reply.payload, response->data.value,
+                         response->data.value_length);
 
-    return SUCCESS_RETURN;
+    return dm_msg_event_send_to_user(dipc_msg);
 }
 
-const char DM_MSG_EVENT_PROPERTY_DESIRED_DELETE_REPLY_FMT[] DM_READ_ONLY =
-            "{\"id\":%d,\"code\":%d,\"data\":%.*s,\"devid\":%d}";
 int dm_msg_thing_property_desired_delete_reply(dm_msg_response_payload_t *response)
 {
-    int res = 0, id = 0, devid = 0,  message_len = 0;
-    char *message = NULL;
+    int res = 0, id = 0, devid = 0;
     char int_id[DM_UTILS_UINT32_STRLEN] = {0};
+    dm_ipc_msg_t *dipc_msg = NULL;
 #if !defined(DM_MESSAGE_CACHE_DISABLED)
     dm_msg_cache_node_t *node = NULL;
 #endif
@@ -722,32 +940,23 @@ int dm_msg_thing_property_desired_delete_reply(dm_msg_response_payload_t *respon
     devid = node->devid;
 #endif
 
-    message_len = strlen(DM_MSG_EVENT_PROPERTY_DESIRED_DELETE_REPLY_FMT) + DM_UTILS_UINT32_STRLEN * 3 + 1 +
-                  response->data.value_length;
-    message = DM_malloc(message_len);
-    if (message == NULL) {
+    dipc_msg = dm_msg_event_new(IOTX_DM_EVENT_PROPERTY_DESIRED_DELETE_REPLY, devid, response->data.value_length);
+    if (dipc_msg == NULL) {
         return DM_MEMORY_NOT_ENOUGH;
     }
-    memset(message, 0, message_len);
-    HAL_Snprintf(message, message_len, DM_MSG_EVENT_PROPERTY_DESIRED_DELETE_REPLY_FMT, id, response->code.value_int,
-                 response->data.value_length, response->data.value, devid);
-
-    res = _dm_msg_send_to_user(IOTX_DM_EVENT_PROPERTY_DESIRED_DELETE_REPLY, message);
-    if (res != SUCCESS_RETURN) {
-        DM_free(message);
-        return FAIL_RETURN;
-    }
+    dipc_msg->event.data.reply.id = id;
+    dipc_msg->event.data.reply.code = response->code.value_int;
+    dm_msg_event_str_set(dipc_msg, &dipc_msg->event.data.reply.payload, response->data.value,
+                         response->data.value_length);
 
-    return SUCCESS_RETURN;
+    return dm_msg_event_send_to_user(dipc_msg);
 }
 #endif
 
 
-const char DM_MSG_EVENT_DEVICEINFO_UPDATE_REPLY_FMT[] DM_READ_ONLY = "{\"id\":%d,\"code\":%d,\"devid\":%d}";
 int dm_msg_thing_deviceinfo_update_reply(dm_msg_response_payload_t *response)
 {
-    int res = 0, devid = 0, id = 0, message_len = 0;
-    char *message = NULL;
+    int res = 0, devid = 0, id = 0;
     char int_id[DM_UTILS_UINT32_STRLEN] = {0};
 #if !defined(DM_MESSAGE_CACHE_DISABLED)
     dm_msg_cache_node_t *node = NULL;
@@ -770,28 +979,12 @@ int dm_msg_thing_deviceinfo_update_reply(dm_msg_response_payload_t *response)
     devid = node->devid;
 #endif
 
-    message_len = strlen(DM_MSG_EVENT_DEVICEINFO_UPDATE_REPLY_FMT) + DM_UTILS_UINT32_STRLEN * 3 + 1;
-    message = DM_malloc(message_len);
-    if (message == NULL) {
-        return DM_MEMORY_NOT_ENOUGH;
-    }
-    memset(message, 0, message_len);
-    HAL_Snprintf(message, message_len, DM_MSG_EVENT_DEVICEINFO_UPDATE_REPLY_FMT, id, response->code.value_int, devid);
-
-    res = _dm_msg_send_to_user(IOTX_DM_EVENT_DEVICEINFO_UPDATE_REPLY, message);
-    if (res != SUCCESS_RETURN) {
-        DM_free(message);
-        return FAIL_RETURN;
-    }
-
-    return SUCCESS_RETURN;
+    return _dm_msg_reply_send_to_user(IOTX_DM_EVENT_DEVICEINFO_UPDATE_REPLY, id, response->code.value_int, devid);
 }
 
-const char DM_MSG_EVENT_DEVICEINFO_DELETE_REPLY_FMT[] DM_READ_ONLY = "{\"id\":%d,\"code\":%d,\"devid\":%d}";
 int dm_msg_thing_deviceinfo_delete_reply(dm_msg_response_payload_t *response)
 {
-    int res = 0, devid = 0, id = 0, message_len = 0;
-    char *message = NULL;
+    int res = 0, devid = 0, id = 0;
     char int_id[DM_UTILS_UINT32_STRLEN] = {0};
 #if !defined(DM_MESSAGE_CACHE_DISABLED)
     dm_msg_cache_node_t *node = NULL;
@@ -814,21 +1007,7 @@ int dm_msg_thing_deviceinfo_delete_reply(dm_msg_response_payload_t *response)
     devid = node->devid;
 #endif
 
-    message_len = strlen(DM_MSG_EVENT_DEVICEINFO_DELETE_REPLY_FMT) + DM_UTILS_UINT32_STRLEN * 3 + 1;
-    message = DM_malloc(message_len);
-    if (message == NULL) {
-        return DM_MEMORY_NOT_ENOUGH;
-    }
-    memset(message, 0, message_len);
-    HAL_Snprintf(message, message_len, DM_MSG_EVENT_DEVICEINFO_DELETE_REPLY_FMT, id, response->code.value_int, devid);
-
-    res = _dm_msg_send_to_user(IOTX_DM_EVENT_DEVICEINFO_DELETE_REPLY, message);
-    if (res != SUCCESS_RETURN) {
-        DM_free(message);
-        return FAIL_RETURN;
-    }
-
-    return SUCCESS_RETURN;
+    return _dm_msg_reply_send_to_user(IOTX_DM_EVENT_DEVICEINFO_DELETE_REPLY, id, response->code.value_int, devid);
 }
 
 int dm_msg_thing_dsltemplate_get_reply(dm_msg_response_payload_t *response)
@@ -903,13 +1082,11 @@ int dm_msg_thing_dynamictsl_get_reply(dm_msg_response_payload_t *response)
     return SUCCESS_RETURN;
 }
 
-const char DM_MSG_THING_NTP_RESPONSE_FMT[] DM_READ_ONLY = "{\"utc\":\"%.*s\"}";
 int dm_msg_ntp_response(char *payload, int payload_len)
 {
-    int res = 0, message_len = 0;
-    char *message = NULL;
     lite_cjson_t lite, lite_item_server_send_time;
     const char *serverSendTime = "serverSendTime";
+    dm_ipc_msg_t *dipc_msg = NULL;
 
     if (payload == NULL || payload_len <= 0) {
         return DM_INVALID_PARAMETER;
@@ -924,23 +1101,15 @@ int dm_msg_ntp_response(char *payload, int payload_len)
     /* dm_log_debug("NTP Time In String: %.*s", lite_item_server_send_time.value_length, lite_item_server_send_time.value); */
 
     /* Send Message To User */
-    message_len = strlen(DM_MSG_THING_NTP_RESPONSE_FMT) + DM_UTILS_UINT32_STRLEN + lite_item_server_send_time.value_length +
-                  1;
-    message = DM_malloc(message_len);
-    if (message == NULL) {
+    dipc_msg = dm_msg_event_new(IOTX_DM_EVENT_NTP_RESPONSE, IOTX_DM_LOCAL_NODE_DEVID,
+                                lite_item_server_send_time.value_length);
+    if (dipc_msg == NULL) {
         return DM_MEMORY_NOT_ENOUGH;
     }
-    memset(message, 0, message_len);
-    HAL_Snprintf(message, message_len, DM_MSG_THING_NTP_RESPONSE_FMT, lite_item_server_send_time.value_length,
-                 lite_item_server_send_time.value);
-
-    res = _dm_msg_send_to_user(IOTX_DM_EVENT_NTP_RESPONSE, message);
-    if (res != SUCCESS_RETURN) {
-        DM_free(message);
-        return FAIL_RETURN;
-    }
+    dm_msg_event_str_set(dipc_msg, &dipc_msg->event.data.utc, lite_item_server_send_time.value,
+                         lite_item_server_send_time.value_length);
 
-    return SUCCESS_RETURN;
+    return dm_msg_event_send_to_user(dipc_msg);
 }
 
 int dm_msg_ext_error_reply(dm_msg_response_payload_t *response)
@@ -1187,9 +1356,10 @@ int dm_msg_thing_delete(_IN_ char product_key[IOTX_PRODUCT_KEY_LEN + 1],
 
 int dm_msg_thing_gateway_permit(_IN_ char *payload, _IN_ int payload_len)
 {
-    int res = 0, message_len = 0;
-    char *message = NULL;
-    lite_cjson_t lite;
+    int res = 0;
+    lite_cjson_t lite, lite_item_pk, lite_item_time;
+    dm_ipc_msg_t *dipc_msg = NULL;
+    iotx_dm_event_permit_t *permit = NULL;
 
     if (payload == NULL || payload_len <= 0) {
         return DM_INVALID_PARAMETER;
@@ -1200,28 +1370,33 @@ int dm_msg_thing_gateway_permit(_IN_ char *payload, _IN_ int payload_len)
         return DM_JSON_PARSE_FAILED;
     }
 
-    message_len = payload_len + 1;
-    message = DM_malloc(message_len);
-    if (message == NULL) {
-        return DM_MEMORY_NOT_ENOUGH;
+    memset(&lite_item_pk, 0, sizeof(lite_cjson_t));
+    memset(&lite_item_time, 0, sizeof(lite_cjson_t));
+    lite_cjson_object_item(&lite, DM_MSG_KEY_PRODUCT_KEY, strlen(DM_MSG_KEY_PRODUCT_KEY), &lite_item_pk);
+    lite_cjson_object_item(&lite, DM_MSG_KEY_TIME, strlen(DM_MSG_KEY_TIME), &lite_item_time);
+    if (!lite_cjson_is_number(&lite_item_time)) {
+        return DM_JSON_PARSE_FAILED;
     }
-    memcpy(message, payload, payload_len);
 
-    res = _dm_msg_send_to_user(IOTX_DM_EVENT_GATEWAY_PERMIT, message);
-    if (res != SUCCESS_RETURN) {
-        DM_free(message);
-        return FAIL_RETURN;
+    dipc_msg = dm_msg_event_new(IOTX_DM_EVENT_GATEWAY_PERMIT, IOTX_DM_LOCAL_NODE_DEVID,
+                                payload_len + lite_item_pk.value_length);
+    if (dipc_msg == NULL) {
+        return DM_MEMORY_NOT_ENOUGH;
+    }
+    permit = &dipc_msg->event.data.permit;
+    permit->time = lite_item_time.value_int;
+    if (lite_cjson_is_string(&lite_item_pk)) {
+        dm_msg_event_str_set(dipc_msg, &permit->product_key, lite_item_pk.value, lite_item_pk.value_length);
     }
+    dm_msg_event_str_set(dipc_msg, &permit->params, payload, payload_len);
 
-    return SUCCESS_RETURN;
+    return dm_msg_event_send_to_user(dipc_msg);
 }
 
-const char DM_MSG_EVENT_SUBDEV_REGISTER_REPLY_FMT[] DM_READ_ONLY = "{\"id\":%d,\"code\":%d,\"devid\":%d}";
 int dm_msg_thing_sub_register_reply(dm_msg_response_payload_t *response)
 {
-    int res = 0, index = 0, message_len = 0, devid = 0;
+    int res = 0, index = 0, devid = 0;
     lite_cjson_t lite, lite_item, lite_item_pk, lite_item_dn, lite_item_ds;
-    char *message = NULL;
     char product_key[IOTX_PRODUCT_KEY_LEN + 1] = {0};
     char device_name[IOTX_DEVICE_NAME_LEN + 1] = {0};
     char device_secret[IOTX_DEVICE_SECRET_LEN + 1] = {0};
@@ -1238,8 +1413,6 @@ int dm_msg_thing_sub_register_reply(dm_msg_response_payload_t *response)
 
     for (index = 0; index < lite.size; index++) {
         devid = 0;
-        message_len = 0;
-        message = NULL;
         memset(temp_id, 0, DM_UTILS_UINT32_STRLEN);
         memset(product_key, 0, IOTX_PRODUCT_KEY_LEN + 1);
         memset(device_name, 0, IOTX_DEVICE_NAME_LEN + 1);
@@ -1298,31 +1471,16 @@ int dm_msg_thing_sub_register_reply(dm_msg_response_payload_t *response)
 
         /* Send Message To User */
         memcpy(temp_id, response->id.value, response->id.value_length);
-        message_len = strlen(DM_MSG_EVENT_SUBDEV_REGISTER_REPLY_FMT) + DM_UTILS_UINT32_STRLEN * 2 + 1;
-        message = DM_malloc(message_len);
-        if (message == NULL) {
-            dm_log_warning("Memory Not Enough");
-            continue;
-        }
-        memset(message, 0, message_len);
-        HAL_Snprintf(message, message_len, DM_MSG_EVENT_SUBDEV_REGISTER_REPLY_FMT, atoi(temp_id), response->code.value_int,
-                     devid);
-
-        res = _dm_msg_send_to_user(IOTX_DM_EVENT_SUBDEV_REGISTER_REPLY, message);
-        if (res != SUCCESS_RETURN) {
-            DM_free(message);
-        }
+        _dm_msg_reply_send_to_user(IOTX_DM_EVENT_SUBDEV_REGISTER_REPLY, atoi(temp_id), response->code.value_int, devid);
     }
 
     return SUCCESS_RETURN;
 }
 
-const char DM_MSG_EVENT_SUBDEV_UNREGISTER_REPLY_FMT[] DM_READ_ONLY = "{\"id\":%d,\"code\":%d,\"devid\":%d}";
 int dm_msg_thing_sub_unregister_reply(dm_msg_response_payload_t *response)
 {
-    int res = 0, devid = 0, id, message_len = 0;
+    int res = 0, devid = 0, id;
     char int_id[DM_UTILS_UINT32_STRLEN] = {0};
-    char *message = NULL;
 #if !defined(DM_MESSAGE_CACHE_DISABLED)
     dm_msg_cache_node_t *node = NULL;
 #endif
@@ -1347,28 +1505,57 @@ int dm_msg_thing_sub_unregister_reply(dm_msg_response_payload_t *response)
     devid = node->devid;
 #endif
 
-    message_len = strlen(DM_MSG_EVENT_SUBDEV_UNREGISTER_REPLY_FMT) + DM_UTILS_UINT32_STRLEN * 3 + 1;
-    message = DM_malloc(message_len);
-    if (message == NULL) {
-        return DM_MEMORY_NOT_ENOUGH;
-    }
-    memset(message, 0, message_len);
-    HAL_Snprintf(message, message_len, DM_MSG_EVENT_SUBDEV_UNREGISTER_REPLY_FMT, id, response->code.value_int, devid);
+    _dm_msg_reply_send_to_user(IOTX_DM_EVENT_SUBDEV_UNREGISTER_REPLY, id, response->code.value_int, devid);
 
-    res = _dm_msg_send_to_user(IOTX_DM_EVENT_SUBDEV_UNREGISTER_REPLY, message);
-    if (res != SUCCESS_RETURN) {
-        DM_free(message);
+    return SUCCESS_RETURN;
+}
+
+/* set status of sub devices listed as [{"productKey":"","deviceName":""}] in reply data of a batch request */
+static void _dm_msg_subdev_list_set_status(_IN_ lite_cjson_t *data, _IN_ iotx_dm_dev_status_t status)
+{
+    int res = 0, index = 0, devid = 0;
+    lite_cjson_t lite_item, lite_item_pk, lite_item_dn;
+    char product_key[IOTX_PRODUCT_KEY_LEN + 1];
+    char device_name[IOTX_DEVICE_NAME_LEN + 1];
+
+    if (!lite_cjson_is_array(data)) {
+        return;
     }
 
-    return SUCCESS_RETURN;
+    for (index = 0; index < data->size; index++) {
+        memset(&lite_item, 0, sizeof(lite_cjson_t));
+        memset(&lite_item_pk, 0, sizeof(lite_cjson_t));
+        memset(&lite_item_dn, 0, sizeof(lite_cjson_t));
+        res = lite_cjson_array_item(data, index, &lite_item);
+        if (res != SUCCESS_RETURN || !lite_cjson_is_object(&lite_item)) {
+            continue;
+        }
+        res = lite_cjson_object_item(&lite_item, DM_MSG_KEY_PRODUCT_KEY, strlen(DM_MSG_KEY_PRODUCT_KEY), &lite_item_pk);
+        if (res != SUCCESS_RETURN || !lite_cjson_is_string(&lite_item_pk)
+            || lite_item_pk.value_length >= IOTX_PRODUCT_KEY_LEN + 1) {
+            continue;
+        }
+        res = lite_cjson_object_item(&lite_item, DM_MSG_KEY_DEVICE_NAME, strlen(DM_MSG_KEY_DEVICE_NAME), &lite_item_dn);
+        if (res != SUCCESS_RETURN || !lite_cjson_is_string(&lite_item_dn)
+            || lite_item_dn.value_length >= IOTX_DEVICE_NAME_LEN + 1) {
+            continue;
+        }
+
+        memcpy(product_key, lite_item_pk.value, lite_item_pk.value_length);
+        product_key[lite_item_pk.value_length] = '\0';
+        memcpy(device_name, lite_item_dn.value, lite_item_dn.value_length);
+        device_name[lite_item_dn.value_length] = '\0';
+
+        if (dm_mgr_search_device_by_pkdn(product_key, device_name, &devid) == SUCCESS_RETURN) {
+            dm_mgr_set_dev_status(devid, status);
+        }
+    }
 }
 
-const char DM_MSG_EVENT_THING_TOPO_ADD_REPLY_FMT[] DM_READ_ONLY = "{\"id\":%d,\"code\":%d,\"devid\":%d}";
 int dm_msg_thing_topo_add_reply(dm_msg_response_payload_t *response)
 {
-    int res = 0, devid = 0, id = 0, message_len = 0;
+    int res = 0, devid = 0, id = 0;
     char int_id[DM_UTILS_UINT32_STRLEN] = {0};
-    char *message = NULL;
 #if !defined(DM_MESSAGE_CACHE_DISABLED)
     dm_msg_cache_node_t *node = NULL;
 #endif
@@ -1390,34 +1577,28 @@ int dm_msg_thing_topo_add_reply(dm_msg_response_payload_t *response)
 
     /* Update State Machine */
     if (response->code.value_int == IOTX_DM_ERR_CODE_SUCCESS) {
-        dm_mgr_set_dev_status(node->devid, IOTX_DM_DEV_STATUS_ATTACHED);
+        if (node->devid == IOTX_DM_LOCAL_NODE_DEVID) {
+            /* sent by dm_msg_thing_topo_add_batch(), sub devices added are listed in data */
+            _dm_msg_subdev_list_set_status(&response->data, IOTX_DM_DEV_STATUS_ATTACHED);
+        } else {
+            dm_mgr_set_dev_status(node->devid, IOTX_DM_DEV_STATUS_ATTACHED);
+        }
     }
 
 #endif
 
-    message_len = strlen(DM_MSG_EVENT_THING_TOPO_ADD_REPLY_FMT) + DM_UTILS_UINT32_STRLEN * 3 + 1;
-    message = DM_malloc(message_len);
-    if (message == NULL) {
-        return DM_MEMORY_NOT_ENOUGH;
-    }
-    memset(message, 0, message_len);
-    HAL_Snprintf(message, message_len, DM_MSG_EVENT_THING_TOPO_ADD_REPLY_FMT, id, response->code.value_int, devid);
-
-    res = _dm_msg_send_to_user(IOTX_DM_EVENT_TOPO_ADD_REPLY, message);
+    res = _dm_msg_reply_send_to_user(IOTX_DM_EVENT_TOPO_ADD_REPLY, id, response->code.value_int, devid);
     if (res != SUCCESS_RETURN) {
-        DM_free(message);
         return FAIL_RETURN;
     }
 
     return SUCCESS_RETURN;
 }
 
-const char DM_MSG_EVENT_THING_TOPO_DELETE_REPLY_FMT[] DM_READ_ONLY = "{\"id\":%d,\"code\":%d,\"devid\":%d}";
 int dm_msg_thing_topo_delete_reply(dm_msg_response_payload_t *response)
 {
-    int res = 0, devid = 0, id = 0, message_len = 0;
+    int res = 0, devid = 0, id = 0;
     char int_id[DM_UTILS_UINT32_STRLEN] = {0};
-    char *message = NULL;
 #if !defined(DM_MESSAGE_CACHE_DISABLED)
     dm_msg_cache_node_t *node = NULL;
 #endif
@@ -1444,29 +1625,19 @@ int dm_msg_thing_topo_delete_reply(dm_msg_response_payload_t *response)
 
 #endif
 
-    message_len = strlen(DM_MSG_EVENT_THING_TOPO_DELETE_REPLY_FMT) + DM_UTILS_UINT32_STRLEN * 3 + 1;
-    message = DM_malloc(message_len);
-    if (message == NULL) {
-        return DM_MEMORY_NOT_ENOUGH;
-    }
-    memset(message, 0, message_len);
-    HAL_Snprintf(message, message_len, DM_MSG_EVENT_THING_TOPO_DELETE_REPLY_FMT, id, response->code.value_int, devid);
-
-    res = _dm_msg_send_to_user(IOTX_DM_EVENT_TOPO_DELETE_REPLY, message);
+    res = _dm_msg_reply_send_to_user(IOTX_DM_EVENT_TOPO_DELETE_REPLY, id, response->code.value_int, devid);
     if (res != SUCCESS_RETURN) {
-        DM_free(message);
         return FAIL_RETURN;
     }
 
     return SUCCESS_RETURN;
 }
 
-const char DM_MSG_TOPO_GET_REPLY_FMT[] DM_READ_ONLY = "{\"id\":%d,\"code\":%d,\"devid\":%d,\"topo\":%.*s}";
 int dm_msg_topo_get_reply(dm_msg_response_payload_t *response)
 {
-    int res = 0, id = 0, message_len = 0;
-    char *message = NULL;
+    int id = 0;
     char int_id[DM_UTILS_UINT32_STRLEN] = {0};
+    dm_ipc_msg_t *dipc_msg = NULL;
 
     if (response == NULL) {
         return DM_INVALID_PARAMETER;
@@ -1481,23 +1652,16 @@ int dm_msg_topo_get_reply(dm_msg_response_payload_t *response)
 
     /* dm_log_debug("Current ID: %d", id); */
 
-    message_len = strlen(DM_MSG_TOPO_GET_REPLY_FMT) + DM_UTILS_UINT32_STRLEN * 3 + response->data.value_length + 1;
-    message = DM_malloc(message_len);
-    if (message == NULL) {
+    dipc_msg = dm_msg_event_new(IOTX_DM_EVENT_TOPO_GET_REPLY, IOTX_DM_LOCAL_NODE_DEVID, response->data.value_length);
+    if (dipc_msg == NULL) {
         return DM_MEMORY_NOT_ENOUGH;
     }
-    memset(message, 0, message_len);
-    HAL_Snprintf(message, message_len, DM_MSG_TOPO_GET_REPLY_FMT, id, response->code.value_int, IOTX_DM_LOCAL_NODE_DEVID,
-                 response->data.value_length,
-                 response->data.value);
-
-    res = _dm_msg_send_to_user(IOTX_DM_EVENT_TOPO_GET_REPLY, message);
-    if (res != SUCCESS_RETURN) {
-        DM_free(message);
-        return FAIL_RETURN;
-    }
+    dipc_msg->event.data.reply.id = id;
+    dipc_msg->event.data.reply.code = response->code.value_int;
+    dm_msg_event_str_set(dipc_msg, &dipc_msg->event.data.reply.payload, response->data.value,
+                         response->data.value_length);
 
-    return SUCCESS_RETURN;
+    return dm_msg_event_send_to_user(dipc_msg);
 }
 
 int dm_msg_thing_list_found_reply(dm_msg_response_payload_t *response)
@@ -1505,11 +1669,9 @@ int dm_msg_thing_list_found_reply(dm_msg_response_payload_t *response)
     return SUCCESS_RETURN;
 }
 
-const char DM_MSG_EVENT_COMBINE_LOGIN_REPLY_FMT[] DM_READ_ONLY = "{\"id\":%d,\"code\":%d,\"devid\":%d}";
 int dm_msg_combine_login_reply(dm_msg_response_payload_t *response)
 {
-    int res = 0, message_len = 0, devid = 0;
-    char *message = NULL;
+    int res = 0, devid = 0;
     lite_cjson_t lite, lite_item_pk, lite_item_dn;
     char product_key[IOTX_PRODUCT_KEY_LEN + 1] = {0};
     char device_name[IOTX_DEVICE_NAME_LEN + 1] = {0};
@@ -1556,18 +1718,8 @@ int dm_msg_combine_login_reply(dm_msg_response_payload_t *response)
     /* Message ID */
     memcpy(temp_id, response->id.value, response->id.value_length);
 
-    message_len = strlen(DM_MSG_EVENT_COMBINE_LOGIN_REPLY_FMT) + DM_UTILS_UINT32_STRLEN * 3 + 1;
-    message = DM_malloc(message_len);
-    if (message == NULL) {
-        return DM_MEMORY_NOT_ENOUGH;
-    }
-    memset(message, 0, message_len);
-    HAL_Snprintf(message, message_len, DM_MSG_EVENT_COMBINE_LOGIN_REPLY_FMT, atoi(temp_id), response->code.value_int,
-                 devid);
-
-    res = _dm_msg_send_to_user(IOTX_DM_EVENT_COMBINE_LOGIN_REPLY, message);
+    res = _dm_msg_reply_send_to_user(IOTX_DM_EVENT_COMBINE_LOGIN_REPLY, atoi(temp_id), response->code.value_int, devid);
     if (res != SUCCESS_RETURN) {
-        DM_free(message);
         return FAIL_RETURN;
     }
 
@@ -1578,11 +1730,29 @@ int dm_msg_combine_login_reply(dm_msg_response_payload_t *response)
     return SUCCESS_RETURN;
 }
 
-const char DM_MSG_EVENT_COMBINE_LOGOUT_REPLY_FMT[] DM_READ_ONLY = "{\"id\":%d,\"code\":%d,\"devid\":%d}";
+int dm_msg_combine_batch_login_reply(dm_msg_response_payload_t *response)
+{
+    char temp_id[DM_UTILS_UINT32_STRLEN + 1] = {0};
+
+    if (response == NULL || response->id.value_length > DM_UTILS_UINT32_STRLEN) {
+        return DM_INVALID_PARAMETER;
+    }
+
+    /* Update State Machine, sub devices logged in are listed in data */
+    if (response->code.value_int == IOTX_DM_ERR_CODE_SUCCESS) {
+        _dm_msg_subdev_list_set_status(&response->data, IOTX_DM_DEV_STATUS_LOGINED);
+    }
+
+    /* Message ID */
+    memcpy(temp_id, response->id.value, response->id.value_length);
+
+    return _dm_msg_reply_send_to_user(IOTX_DM_EVENT_COMBINE_LOGIN_REPLY, atoi(temp_id), response->code.value_int,
+                                      IOTX_DM_LOCAL_NODE_DEVID);
+}
+
 int dm_msg_combine_logout_reply(dm_msg_response_payload_t *response)
 {
-    int res = 0, message_len = 0, devid = 0;
-    char *message = NULL;
+    int res = 0, devid = 0;
     lite_cjson_t lite, lite_item_pk, lite_item_dn;
     char product_key[IOTX_PRODUCT_KEY_LEN + 1] = {0};
     char device_name[IOTX_DEVICE_NAME_LEN + 1] = {0};
@@ -1629,18 +1799,8 @@ int dm_msg_combine_logout_reply(dm_msg_response_payload_t *response)
     /* Message ID */
     memcpy(temp_id, response->id.value, response->id.value_length);
 
-    message_len = strlen(DM_MSG_EVENT_COMBINE_LOGOUT_REPLY_FMT) + DM_UTILS_UINT32_STRLEN * 3 + 1;
-    message = DM_malloc(message_len);
-    if (message == NULL) {
-        return DM_MEMORY_NOT_ENOUGH;
-    }
-    memset(message, 0, message_len);
-    HAL_Snprintf(message, message_len, DM_MSG_EVENT_COMBINE_LOGOUT_REPLY_FMT, atoi(temp_id), response->code.value_int,
-                 devid);
-
-    res = _dm_msg_send_to_user(IOTX_DM_EVENT_COMBINE_LOGOUT_REPLY, message);
+    res = _dm_msg_reply_send_to_user(IOTX_DM_EVENT_COMBINE_LOGOUT_REPLY, atoi(temp_id), response->code.value_int, devid);
     if (res != SUCCESS_RETURN) {
-        DM_free(message);
         return FAIL_RETURN;
     }
 
@@ -1661,13 +1821,15 @@ int dm_msg_dev_core_service_dev(char **payload, int *payload_len)
     char ip_addr[16] = {0};
     char *device_array = NULL;
     lite_cjson_item_t *lite_array = NULL, *lite_object = NULL;
+    lite_cjson_arena_t arena;
     uint16_t port = 5683;
 
     if (payload == NULL || *payload != NULL || payload_len == NULL) {
         return DM_INVALID_PARAMETER;
     }
 
-    lite_array = lite_cjson_create_array();
+    lite_cjson_arena_init(&arena, NULL, 0);
+    lite_array = lite_cjson_arena_create_array(&arena);
     if (lite_array == NULL) {
         return DM_MEMORY_NOT_ENOUGH;
     }
@@ -1682,28 +1844,28 @@ int dm_msg_dev_core_service_dev(char **payload, int *payload_len)
 
         res = dm_mgr_get_devid_by_index(index, &search_devid);
         if (res != SUCCESS_RETURN) {
-            lite_cjson_delete(lite_array);
+            lite_cjson_arena_deinit(&arena);
             return FAIL_RETURN;
         }
 
         res = dm_mgr_search_device_by_devid(search_devid, product_key, device_name, device_secret);
         if (res != SUCCESS_RETURN) {
-            lite_cjson_delete(lite_array);
+            lite_cjson_arena_deinit(&arena);
             return FAIL_RETURN;
         }
 
-        lite_object = lite_cjson_create_object();
+        lite_object = lite_cjson_arena_create_object(&arena);
         if (lite_object == NULL) {
-            lite_cjson_delete(lite_array);
+            lite_cjson_arena_deinit(&arena);
             return FAIL_RETURN;
         }
-        lite_cjson_add_string_to_object(lite_object, "productKey", product_key);
-        lite_cjson_add_string_to_object(lite_object, "deviceName", device_name);
+        lite_cjson_arena_add_string_to_object(&arena, lite_object, "productKey", product_key);
+        lite_cjson_arena_add_string_to_object(&arena, lite_object, "deviceName", device_name);
         lite_cjson_add_item_to_array(lite_array, lite_object);
     }
 
     device_array = lite_cjson_print_unformatted(lite_array);
-    lite_cjson_delete(lite_array);
+    lite_cjson_arena_deinit(&arena);
     if (device_array == NULL) {
         return DM_MEMORY_NOT_ENOUGH;
     }
@@ -2077,6 +2239,150 @@ int dm_msg_combine_login(_IN_ char product_key[IOTX_PRODUCT_KEY_LEN + 1],
     return SUCCESS_RETURN;
 }
 
+/* client id of sub device, "productKey.deviceName" */
+#define DM_MSG_SUBDEV_CLIENT_ID_LEN (IOTX_PRODUCT_KEY_LEN + 1 + IOTX_DEVICE_NAME_LEN + 1 + 1)
+
+static int _dm_msg_subdev_sign(_IN_ dm_msg_subdev_t *subdev, _IN_ const char *sign_source_fmt,
+                               _IN_ const char *timestamp, _OU_ char client_id[DM_MSG_SUBDEV_CLIENT_ID_LEN],
+                               _OU_ char sign[65])
+{
+    char sign_source[64 + DM_MSG_SUBDEV_CLIENT_ID_LEN + IOTX_DEVICE_NAME_LEN + IOTX_PRODUCT_KEY_LEN + DM_UTILS_UINT64_STRLEN];
+
+    if (subdev->product_key == NULL || subdev->device_name == NULL || subdev->device_secret == NULL ||
+        (strlen(subdev->product_key) >= IOTX_PRODUCT_KEY_LEN + 1) ||
+        (strlen(subdev->device_name) >= IOTX_DEVICE_NAME_LEN + 1) ||
+        (strlen(subdev->device_secret) >= IOTX_DEVICE_SECRET_LEN + 1) ||
+        strlen(sign_source_fmt) >= 64) {
+        return DM_INVALID_PARAMETER;
+    }
+
+    /* Client ID */
+    HAL_Snprintf(client_id, DM_MSG_SUBDEV_CLIENT_ID_LEN, "%s.%s", subdev->product_key, subdev->device_name);
+
+    /* Sign */
+    HAL_Snprintf(sign_source, sizeof(sign_source), sign_source_fmt, client_id, subdev->device_name,
+                 subdev->product_key, timestamp);
+    memset(sign, 0, 65);
+    utils_hmac_sha1(sign_source, strlen(sign_source), sign, subdev->device_secret, strlen(subdev->device_secret));
+
+    return SUCCESS_RETURN;
+}
+
+static void _dm_msg_subdev_write_string(_IN_ lite_cjson_writer_t *writer, _IN_ const char *key, _IN_ const char *value)
+{
+    lite_cjson_writer_key(writer, key, strlen(key));
+    lite_cjson_writer_string(writer, value, strlen(value));
+}
+
+static int _dm_msg_subdev_list_write(_IN_ dm_msg_subdev_t *subdevs, _IN_ int subdev_num, _IN_ int login,
+                                     _IN_ const char *timestamp, _IN_ char *buffer, _IN_ int size, _OU_ int *params_len)
+{
+    int res = 0, index = 0;
+    char client_id[DM_MSG_SUBDEV_CLIENT_ID_LEN] = {0};
+    char sign[65] = {0};
+    lite_cjson_writer_t writer;
+
+    /* {"deviceList":[...]} */
+    lite_cjson_writer_init(&writer, buffer, size);
+    if (login) {
+        lite_cjson_writer_object_begin(&writer);
+        lite_cjson_writer_key(&writer, "deviceList", strlen("deviceList"));
+    }
+    lite_cjson_writer_array_begin(&writer);
+    for (index = 0; index < subdev_num; index++) {
+        res = _dm_msg_subdev_sign(&subdevs[index], login ? DM_MSG_COMBINE_LOGIN_SIGN_SOURCE : DM_MSG_THING_TOPO_ADD_SIGN_SOURCE,
+                                  timestamp, client_id, sign);
+        if (res != SUCCESS_RETURN) {
+            return res;
+        }
+
+        lite_cjson_writer_object_begin(&writer);
+        _dm_msg_subdev_write_string(&writer, DM_MSG_KEY_PRODUCT_KEY, subdevs[index].product_key);
+        _dm_msg_subdev_write_string(&writer, DM_MSG_KEY_DEVICE_NAME, subdevs[index].device_name);
+        _dm_msg_subdev_write_string(&writer, "clientId", client_id);
+        _dm_msg_subdev_write_string(&writer, "timestamp", timestamp);
+        _dm_msg_subdev_write_string(&writer, login ? "signMethod" : "signmethod", DM_MSG_SIGN_METHOD_HMACSHA1);
+        _dm_msg_subdev_write_string(&writer, "sign", sign);
+        if (login) {
+            _dm_msg_subdev_write_string(&writer, "cleanSession", "true");
+        }
+        lite_cjson_writer_object_end(&writer);
+    }
+    lite_cjson_writer_array_end(&writer);
+    if (login) {
+        lite_cjson_writer_object_end(&writer);
+    }
+
+    *params_len = writer.len;
+    return lite_cjson_writer_end(&writer);
+}
+
+static int _dm_msg_subdev_list(_IN_ dm_msg_subdev_t *subdevs, _IN_ int subdev_num, _IN_ int login,
+                               _OU_ dm_msg_request_t *request)
+{
+    int res = 0, params_len = 0;
+    char *params = NULL;
+    char timestamp[DM_UTILS_UINT64_STRLEN] = {0};
+
+    if (subdevs == NULL || subdev_num <= 0 || request == NULL ||
+        (strlen(request->product_key) >= IOTX_PRODUCT_KEY_LEN + 1) ||
+        (strlen(request->device_name) >= IOTX_DEVICE_NAME_LEN + 1)) {
+        return DM_INVALID_PARAMETER;
+    }
+
+    /* one timestamp for whole batch, so that both passes write the same text */
+    HAL_Snprintf(timestamp, DM_UTILS_UINT64_STRLEN, "%llu", (unsigned long long)HAL_UptimeMs());
+
+    /* count first, then write into a buffer of exactly that length */
+    res = _dm_msg_subdev_list_write(subdevs, subdev_num, login, timestamp, NULL, 0, &params_len);
+    if (res != DM_MSG_WRITE_SHORT) {
+        return (res == SUCCESS_RETURN) ? FAIL_RETURN : res;
+    }
+
+    params = DM_malloc(params_len + 1);
+    if (params == NULL) {
+        return DM_MEMORY_NOT_ENOUGH;
+    }
+
+    res = _dm_msg_subdev_list_write(subdevs, subdev_num, login, timestamp, params, params_len + 1, &params_len);
+    if (res != SUCCESS_RETURN) {
+        DM_free(params);
+        return FAIL_RETURN;
+    }
+
+    request->params = params;
+    request->params_len = params_len;
+
+    return SUCCESS_RETURN;
+}
+
+int dm_msg_thing_topo_add_batch(_IN_ dm_msg_subdev_t *subdevs, _IN_ int subdev_num, _OU_ dm_msg_request_t *request)
+{
+    int res = 0;
+
+    res = _dm_msg_subdev_list(subdevs, subdev_num, 0, request);
+    if (res != SUCCESS_RETURN) {
+        return res;
+    }
+    request->method = (char *)DM_MSG_THING_TOPO_ADD_METHOD;
+
+    return SUCCESS_RETURN;
+}
+
+const char DM_MSG_COMBINE_BATCH_LOGIN_METHOD[] DM_READ_ONLY = "combine.batchLogin";
+int dm_msg_combine_batch_login(_IN_ dm_msg_subdev_t *subdevs, _IN_ int subdev_num, _OU_ dm_msg_request_t *request)
+{
+    int res = 0;
+
+    res = _dm_msg_subdev_list(subdevs, subdev_num, 1, request);
+    if (res != SUCCESS_RETURN) {
+        return res;
+    }
+    request->method = (char *)DM_MSG_COMBINE_BATCH_LOGIN_METHOD;
+
+    return SUCCESS_RETURN;
+}
+
 const char DM_MSG_COMBINE_LOGOUT_METHOD[] DM_READ_ONLY = "combine.logout";
 const char DM_MSG_COMBINE_LOGOUT_PARAMS[] DM_READ_ONLY = "{\"productKey\":\"%s\",\"deviceName\":\"%s\"}";
 int dm_msg_combine_logout(_IN_ char product_key[IOTX_PRODUCT_KEY_LEN + 1],
@@ -2405,12 +2711,14 @@ int dm_msg_property_get(_IN_ int devid, _IN_ dm_msg_request_payload_t *request,
     int res = 0, index = 0;
     lite_cjson_t lite, lite_item;
     lite_cjson_item_t *lite_cjson_item = NULL;
+    lite_cjson_arena_t arena;
 
     if (devid < 0 || request == NULL || payload == NULL || *payload != NULL || payload_len == NULL) {
         return DM_INVALID_PARAMETER;
     }
 
-    lite_cjson_item = lite_cjson_create_object();
+    lite_cjson_arena_init(&arena, NULL, 0);
+    lite_cjson_item = lite_cjson_arena_create_object(&arena);
     if (lite_cjson_item == NULL) {
         return DM_MEMORY_NOT_ENOUGH;
     }
@@ -2419,6 +2727,7 @@ int dm_msg_property_get(_IN_ int devid, _IN_ dm_msg_request_payload_t *request,
     memset(&lite, 0, sizeof(lite_cjson_t));
     res = lite_cjson_parse(request->params.value, request->params.value_length, &lite);
     if (res != SUCCESS_RETURN || !lite_cjson_is_array(&lite)) {
+        lite_cjson_arena_deinit(&arena);
         return DM_JSON_PARSE_FAILED;
     }
     /* dm_log_info("Property Get, Size: %d", lite.size); */
@@ -2428,28 +2737,28 @@ int dm_msg_property_get(_IN_ int devid, _IN_ dm_msg_request_payload_t *request,
         memset(&lite_item, 0, sizeof(lite_cjson_t));
         res = lite_cjson_array_item(&lite, index, &lite_item);
         if (res != SUCCESS_RETURN) {
-            lite_cjson_delete(lite_cjson_item);
+            lite_cjson_arena_deinit(&arena);
             return FAIL_RETURN;
         }
 
         if (!lite_cjson_is_string(&lite_item)) {
-            lite_cjson_delete(lite_cjson_item);
+            lite_cjson_arena_deinit(&arena);
             return FAIL_RETURN;
         }
 
-        res = dm_mgr_deprecated_assemble_property(devid, lite_item.value, lite_item.value_length, lite_cjson_item);
+        res = dm_mgr_deprecated_assemble_property(devid, lite_item.value, lite_item.value_length, lite_cjson_item,
+                &arena);
         if (res != SUCCESS_RETURN) {
-            lite_cjson_delete(lite_cjson_item);
+            lite_cjson_arena_deinit(&arena);
             return FAIL_RETURN;
         }
     }
 
     *payload = lite_cjson_print_unformatted(lite_cjson_item);
+    lite_cjson_arena_deinit(&arena);
     if (*payload == NULL) {
-        lite_cjson_delete(lite_cjson_item);
         return FAIL_RETURN;
     }
-    lite_cjson_delete(lite_cjson_item);
     *payload_len = strlen(*payload);
 
     return SUCCESS_RETURN;
@@ -19,6 +19,12 @@
 
 #define DM_MSG_VERSION                  "1.0"
 
+/* most slices a typed event carries */
+#define DM_MSG_EVENT_STR_NUM_MAX        (5)
+
+/* nodes to index top level of request and response, {"id","version","method","params","sys"} and root fit */
+#define DM_MSG_INDEX_NODE_NUM           (8)
+
 #define DM_MSG_KEY_PRODUCT_KEY          "productKey"
 #define DM_MSG_KEY_DEVICE_NAME          "deviceName"
 #define DM_MSG_KEY_DEVICE_SECRET        "deviceSecret"
@@ -65,12 +71,14 @@ typedef struct {
     int devid;
     const char *service_prefix;
     const char *service_name;
+    const char *topic;  /* complete URI kept by dm_manager, service_prefix and service_name are not used if set */
     char product_key[IOTX_PRODUCT_KEY_LEN + 1];
     char device_name[IOTX_DEVICE_NAME_LEN + 1];
     char *params;
     int params_len;
     char *method;
     iotx_cm_data_handle_cb callback;
+    int publish_res;    /* set by dm_msg_request(), result of publishing to cloud, which it does not return */
 } dm_msg_request_t;
 
 typedef struct {
@@ -85,10 +93,23 @@ typedef struct {
     int id;
 } dm_msg_ctx_t;
 
+#ifdef DEVICE_MODEL_GATEWAY
+/* sub device carried by a batch request */
+typedef struct {
+    char *product_key;
+    char *device_name;
+    char *device_secret;
+} dm_msg_subdev_t;
+#endif
+
 
 int dm_msg_init(void);
 int dm_msg_deinit(void);
 int _dm_msg_send_to_user(iotx_dm_event_types_t type, char *message);
+dm_ipc_msg_t *dm_msg_event_new(iotx_dm_event_types_t type, int devid, int str_len);
+void dm_msg_event_str_set(dm_ipc_msg_t *msg, iotx_dm_event_str_t *str, const char *value, int value_len);
+int dm_msg_event_send_to_user(dm_ipc_msg_t *msg);
+int dm_msg_event_render(dm_ipc_msg_t *msg);
 int dm_msg_send_msg_timeout_to_user(int msg_id, int devid, iotx_dm_event_types_t type);
 int dm_msg_uri_parse_pkdn(_IN_ char *uri, _IN_ int uri_len, _IN_ int start_deli, _IN_ int end_deli,
                           _OU_ char product_key[IOTX_PRODUCT_KEY_LEN + 1], _OU_ char device_name[IOTX_DEVICE_NAME_LEN + 1]);
@@ -139,6 +160,7 @@ int dm_msg_ext_error_reply(dm_msg_response_payload_t *response);
     int dm_msg_topo_get_reply(dm_msg_response_payload_t *response);
     int dm_msg_thing_list_found_reply(dm_msg_response_payload_t *response);
     int dm_msg_combine_login_reply(dm_msg_response_payload_t *response);
+    int dm_msg_combine_batch_login_reply(dm_msg_response_payload_t *response);
     int dm_msg_combine_logout_reply(dm_msg_response_payload_t *response);
 #endif
 #ifdef ALCS_ENABLED
@@ -173,5 +195,7 @@ int dm_msg_combine_login(_IN_ char product_key[IOTX_PRODUCT_KEY_LEN + 1], _IN_ c
                          _IN_ char device_secret[IOTX_DEVICE_SECRET_LEN + 1], _OU_ dm_msg_request_t *request);
 int dm_msg_combine_logout(_IN_ char product_key[IOTX_PRODUCT_KEY_LEN + 1], _IN_ char device_name[IOTX_DEVICE_NAME_LEN + 1],
                           _OU_ dm_msg_request_t *request);
+int dm_msg_thing_topo_add_batch(_IN_ dm_msg_subdev_t *subdevs, _IN_ int subdev_num, _OU_ dm_msg_request_t *request);
+int dm_msg_combine_batch_login(_IN_ dm_msg_subdev_t *subdevs, _IN_ int subdev_num, _OU_ dm_msg_request_t *request);
 #endif
 #endif
@@ -28,15 +28,46 @@ static void _dm_msg_cache_mutex_unlock(void)
     }
 }
 
+static struct list_head *_dm_msg_cache_bucket(int msgid)
+{
+    dm_msg_cache_ctx_t *ctx = _dm_msg_cache_get_ctx();
+
+    return &ctx->dmc_hash[(unsigned int)msgid % CONFIG_MSGCACHE_HASH_SIZE];
+}
+
+static void _dm_msg_cache_free_node(dm_msg_cache_node_t *node)
+{
+    dm_msg_cache_ctx_t *ctx = _dm_msg_cache_get_ctx();
+
+    list_del(&node->linked_list);
+    list_del(&node->hash_linked);
+    if (node->data) {
+        DM_free(node->data);
+    }
+    DM_free(node);
+    ctx->dmc_list_size--;
+}
+
 int dm_msg_cache_init(void)
 {
+    int index = 0;
     dm_msg_cache_ctx_t *ctx = _dm_msg_cache_get_ctx();
 
     memset(ctx, 0, sizeof(dm_msg_cache_ctx_t));
 
+    ctx->dmc_hash = DM_malloc(sizeof(struct list_head) * CONFIG_MSGCACHE_HASH_SIZE);
+    if (ctx->dmc_hash == NULL) {
+        return DM_MEMORY_NOT_ENOUGH;
+    }
+    for (index = 0; index < CONFIG_MSGCACHE_HASH_SIZE; index++) {
+        INIT_LIST_HEAD(&ctx->dmc_hash[index]);
+    }
+
     /* Create Mutex */
     ctx->mutex = HAL_MutexCreate();
     if (ctx->mutex == NULL) {
+        DM_free(ctx->dmc_hash);
+        ctx->dmc_hash = NULL;
         return DM_MEMORY_NOT_ENOUGH;
     }
 
@@ -52,19 +83,21 @@ int dm_msg_cache_deinit(void)
     dm_msg_cache_node_t *node = NULL;
     dm_msg_cache_node_t *next = NULL;
 
+    if (ctx->dmc_hash == NULL) {
+        return SUCCESS_RETURN;
+    }
+
     _dm_msg_cache_mutex_lock();
     list_for_each_entry_safe(node, next, &ctx->dmc_list, linked_list, dm_msg_cache_node_t) {
-        list_del(&node->linked_list);
-        if (node->data) {
-            DM_free(node->data);
-        }
-        DM_free(node);
-        _dm_msg_cache_mutex_unlock();
+        _dm_msg_cache_free_node(node);
     }
+    DM_free(ctx->dmc_hash);
+    ctx->dmc_hash = NULL;
     _dm_msg_cache_mutex_unlock();
 
     if (ctx->mutex) {
         HAL_MutexDestroy(ctx->mutex);
+        ctx->mutex = NULL;
     }
 
     return SUCCESS_RETURN;
@@ -90,11 +123,14 @@ int dm_msg_cache_insert(int msgid, int devid, iotx_dm_event_types_t type, char *
     node->devid = devid;
     node->response_type = type;
     node->data = data;
-    node->ctime = HAL_UptimeMs();
     INIT_LIST_HEAD(&node->linked_list);
+    INIT_LIST_HEAD(&node->hash_linked);
 
     _dm_msg_cache_mutex_lock();
+    /* taken under lock, so that ctime never decreases along dmc_list */
+    node->ctime = HAL_UptimeMs();
     list_add_tail(&node->linked_list, &ctx->dmc_list);
+    list_add(&node->hash_linked, _dm_msg_cache_bucket(msgid));
     ctx->dmc_list_size++;
     _dm_msg_cache_mutex_unlock();
 
@@ -103,7 +139,6 @@ int dm_msg_cache_insert(int msgid, int devid, iotx_dm_event_types_t type, char *
 
 int dm_msg_cache_search(_IN_ int msgid, _OU_ dm_msg_cache_node_t **node)
 {
-    dm_msg_cache_ctx_t *ctx = _dm_msg_cache_get_ctx();
     dm_msg_cache_node_t *search_node = NULL;
 
     if (msgid <= 0 || node == NULL || *node != NULL) {
@@ -111,7 +146,7 @@ int dm_msg_cache_search(_IN_ int msgid, _OU_ dm_msg_cache_node_t **node)
     }
 
     _dm_msg_cache_mutex_lock();
-    list_for_each_entry(search_node, &ctx->dmc_list, linked_list, dm_msg_cache_node_t) {
+    list_for_each_entry(search_node, _dm_msg_cache_bucket(msgid), hash_linked, dm_msg_cache_node_t) {
         if (search_node->msgid == msgid) {
             *node = search_node;
             _dm_msg_cache_mutex_unlock();
@@ -125,19 +160,12 @@ int dm_msg_cache_search(_IN_ int msgid, _OU_ dm_msg_cache_node_t **node)
 
 int dm_msg_cache_remove(int msgid)
 {
-    dm_msg_cache_ctx_t *ctx = _dm_msg_cache_get_ctx();
     dm_msg_cache_node_t *node = NULL;
-    dm_msg_cache_node_t *next = NULL;
 
     _dm_msg_cache_mutex_lock();
-    list_for_each_entry_safe(node, next, &ctx->dmc_list, linked_list, dm_msg_cache_node_t) {
+    list_for_each_entry(node, _dm_msg_cache_bucket(msgid), hash_linked, dm_msg_cache_node_t) {
         if (node->msgid == msgid) {
-            list_del(&node->linked_list);
-            if (node->data) {
-                DM_free(node->data);
-            }
-            ctx->dmc_list_size--;
-            DM_free(node);
+            _dm_msg_cache_free_node(node);
             dm_log_debug("Remove Message ID: %d", msgid);
             _dm_msg_cache_mutex_unlock();
             return SUCCESS_RETURN;
@@ -158,19 +186,20 @@ void dm_msg_cache_tick(void)
     _dm_msg_cache_mutex_lock();
     list_for_each_entry_safe(node, next, &ctx->dmc_list, linked_list, dm_msg_cache_node_t) {
         if (current_time < node->ctime) {
-            node->ctime = current_time;
-        }
-        if (current_time - node->ctime >= DM_MSG_CACHE_TIMEOUT_MS_DEFAULT) {
-            dm_log_debug("Message ID Timeout: %d", node->msgid);
-            /* Send Timeout Message To User */
-            dm_msg_send_msg_timeout_to_user(node->msgid, node->devid, node->response_type);
-            list_del(&node->linked_list);
-            if (node->data) {
-                DM_free(node->data);
+            /* clock went back, restart timeout of all messages from now on */
+            list_for_each_entry(node, &ctx->dmc_list, linked_list, dm_msg_cache_node_t) {
+                node->ctime = current_time;
             }
-            DM_free(node);
-            ctx->dmc_list_size--;
+            break;
+        }
+        if (current_time - node->ctime < DM_MSG_CACHE_TIMEOUT_MS_DEFAULT) {
+            /* messages behind were inserted later */
+            break;
         }
+        dm_log_debug("Message ID Timeout: %d", node->msgid);
+        /* Send Timeout Message To User */
+        dm_msg_send_msg_timeout_to_user(node->msgid, node->devid, node->response_type);
+        _dm_msg_cache_free_node(node);
     }
     _dm_msg_cache_mutex_unlock();
 }
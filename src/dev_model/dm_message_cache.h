@@ -18,12 +18,19 @@ typedef struct {
     char *data;
     uint64_t ctime;
     struct list_head linked_list;
+    struct list_head hash_linked;
 } dm_msg_cache_node_t;
 
+/*
+ * Every message waits for DM_MSG_CACHE_TIMEOUT_MS_DEFAULT, so dmc_list kept in order of insertion is
+ * also in order of expiry and dm_msg_cache_tick() stops at its first message not timed out.
+ * Replies are matched through dmc_hash indexed by msgid.
+ */
 typedef struct {
     void *mutex;
     int dmc_list_size;
     struct list_head dmc_list;
+    struct list_head *dmc_hash;
 } dm_msg_cache_ctx_t;
 
 int dm_msg_cache_init(void);
@@ -90,6 +90,8 @@ const char DM_URI_DEV_CORE_SERVICE_DEV[]              DM_READ_ONLY = "/dev/core/
     const char DM_URI_THING_LIST_FOUND_REPLY[]            DM_READ_ONLY = "thing/list/found_reply";
     const char DM_URI_COMBINE_LOGIN[]                     DM_READ_ONLY = "combine/login";
     const char DM_URI_COMBINE_LOGIN_REPLY[]               DM_READ_ONLY = "combine/login_reply";
+    const char DM_URI_COMBINE_BATCH_LOGIN[]               DM_READ_ONLY = "combine/batch_login";
+    const char DM_URI_COMBINE_BATCH_LOGIN_REPLY[]         DM_READ_ONLY = "combine/batch_login_reply";
     const char DM_URI_COMBINE_LOGOUT[]                    DM_READ_ONLY = "combine/logout";
     const char DM_URI_COMBINE_LOGOUT_REPLY[]              DM_READ_ONLY = "combine/logout_reply";
 #endif
@@ -913,6 +915,37 @@ int dm_msg_proc_combine_login_reply(_IN_ dm_msg_source_t *source)
     return SUCCESS_RETURN;
 }
 
+int dm_msg_proc_combine_batch_login_reply(_IN_ dm_msg_source_t *source)
+{
+    int res = 0;
+    dm_msg_response_payload_t response;
+#if !defined(DM_MESSAGE_CACHE_DISABLED)
+    char int_id[DM_UTILS_UINT32_STRLEN + 1] = {0};
+#endif
+
+    dm_log_info(DM_URI_COMBINE_BATCH_LOGIN_REPLY);
+
+    memset(&response, 0, sizeof(dm_msg_response_payload_t));
+
+    /* Response */
+    res = dm_msg_response_parse((char *)source->payload, source->payload_len, &response);
+    if (res != SUCCESS_RETURN) {
+        return FAIL_RETURN;
+    }
+
+    /* Operation */
+    dm_msg_combine_batch_login_reply(&response);
+
+    /* Remove Message From Cache */
+#if !defined(DM_MESSAGE_CACHE_DISABLED)
+    if (response.id.value_length <= DM_UTILS_UINT32_STRLEN) {
+        memcpy(int_id, response.id.value, response.id.value_length);
+        dm_msg_cache_remove(atoi(int_id));
+    }
+#endif
+    return SUCCESS_RETURN;
+}
+
 int dm_msg_proc_combine_logout_reply(_IN_ dm_msg_source_t *source)
 {
     int res = 0;
@@ -91,6 +91,8 @@ extern const char DM_URI_DEV_CORE_SERVICE_DEV[]              DM_READ_ONLY;
     extern const char DM_URI_THING_LIST_FOUND_REPLY[]            DM_READ_ONLY;
     extern const char DM_URI_COMBINE_LOGIN[]                     DM_READ_ONLY;
     extern const char DM_URI_COMBINE_LOGIN_REPLY[]               DM_READ_ONLY;
+    extern const char DM_URI_COMBINE_BATCH_LOGIN[]               DM_READ_ONLY;
+    extern const char DM_URI_COMBINE_BATCH_LOGIN_REPLY[]         DM_READ_ONLY;
     extern const char DM_URI_COMBINE_LOGOUT[]                    DM_READ_ONLY;
     extern const char DM_URI_COMBINE_LOGOUT_REPLY[]              DM_READ_ONLY;
 #endif
@@ -142,6 +144,7 @@ int dm_msg_proc_thing_topo_delete_reply(_IN_ dm_msg_source_t *source);
 int dm_msg_proc_thing_topo_get_reply(_IN_ dm_msg_source_t *source);
 int dm_msg_proc_thing_list_found_reply(_IN_ dm_msg_source_t *source);
 int dm_msg_proc_combine_login_reply(_IN_ dm_msg_source_t *source);
+int dm_msg_proc_combine_batch_login_reply(_IN_ dm_msg_source_t *source);
 int dm_msg_proc_combine_logout_reply(_IN_ dm_msg_source_t *source);
 #endif
 
@@ -6,7 +6,7 @@
 #if !defined(DEVICE_MODEL_RAWDATA_SOLO)
 
 static dm_opt_ctx g_dm_opt = {
-    0, 0, 1, 1, 1
+    0, 0, 1, 1, 1, 0, 0
 };
 
 int dm_opt_set(dm_opt_t opt, void *data)
@@ -45,6 +45,16 @@ int dm_opt_set(dm_opt_t opt, void *data)
         }
         break;
 #endif
+        case DM_OPT_PROPERTY_REPORT_WINDOW_MS: {
+            int opt = *(int *)(data);
+            g_dm_opt.prop_report_window_ms = (opt > 0) ? opt : 0;
+        }
+        break;
+        case DM_OPT_PROPERTY_REPORT_DELTA: {
+            int opt = *(int *)(data);
+            g_dm_opt.prop_report_delta = opt;
+        }
+        break;
         default: {
             res = FAIL_RETURN;
         }
@@ -85,6 +95,14 @@ int dm_opt_get(dm_opt_t opt, void *data)
         }
         break;
 #endif
+        case DM_OPT_PROPERTY_REPORT_WINDOW_MS: {
+            *(int *)(data) = g_dm_opt.prop_report_window_ms;
+        }
+        break;
+        case DM_OPT_PROPERTY_REPORT_DELTA: {
+            *(int *)(data) = g_dm_opt.prop_report_delta;
+        }
+        break;
         default: {
             res = FAIL_RETURN;
         }
@@ -11,7 +11,9 @@ typedef enum {
     DM_OPT_DOWNSTREAM_EVENT_POST_REPLY,
     DM_OPT_UPSTREAM_PROPERTY_SET_REPLY,
     DM_OPT_DOWNSTREAM_EVENT_PROPERTY_DESIRED_DELETE_REPLY,
-    DM_OPT_DOWNSTREAM_EVENT_PROPERTY_DESIRED_GET_REPLY
+    DM_OPT_DOWNSTREAM_EVENT_PROPERTY_DESIRED_GET_REPLY,
+    DM_OPT_PROPERTY_REPORT_WINDOW_MS,
+    DM_OPT_PROPERTY_REPORT_DELTA
 } dm_opt_t;
 
 typedef struct {
@@ -20,6 +22,8 @@ typedef struct {
     int prop_set_reply_opt;
     int prop_desired_get_reply_opt;
     int prop_desired_delete_reply_opt;
+    int prop_report_window_ms;                   /* property posts within window are merged, 0 to post each */
+    int prop_report_delta;                       /* leave unchanged values out of merged property post */
 } dm_opt_ctx;
 
 int dm_opt_set(dm_opt_t opt, void *data);
@@ -0,0 +1,289 @@
+/*
+ * Copyright (C) 2015-2018 Alibaba Group Holding Limited
+ */
+#include "iotx_dm_internal.h"
+
+#if !defined(DEVICE_MODEL_RAWDATA_SOLO)
+
+/* "key":value, */
+#define _DM_PROP_REPORT_MEMBER_LEN(key_len, value_len) ((key_len) + (value_len) + 4)
+
+static unsigned int _dm_prop_report_hash(_IN_ const char *key, _IN_ int key_len)
+{
+    unsigned int hash = 2166136261u;
+    int index = 0;
+
+    for (index = 0; index < key_len; index++) {
+        hash = (hash ^ (unsigned char)key[index]) * 16777619u;
+    }
+
+    return hash;
+}
+
+static dm_prop_report_item_t *_dm_prop_report_item(_IN_ dm_prop_report_t *report, _IN_ const char *key,
+        _IN_ int key_len)
+{
+    int index = 0;
+    unsigned int key_hash = _dm_prop_report_hash(key, key_len);
+    dm_prop_report_item_t *item = NULL;
+    dm_prop_report_item_t *items = NULL;
+
+    for (index = 0; index < report->item_number; index++) {
+        item = report->items + index;
+        if (item->key_hash == key_hash && item->key_len == key_len && memcmp(item->key, key, key_len) == 0) {
+            return item;
+        }
+    }
+
+    if (report->item_number == report->item_size) {
+        items = DM_malloc(sizeof(dm_prop_report_item_t) * (report->item_size ? report->item_size * 2 : 8));
+        if (items == NULL) {
+            return NULL;
+        }
+        if (report->items) {
+            memcpy(items, report->items, sizeof(dm_prop_report_item_t) * report->item_number);
+            DM_free(report->items);
+        }
+        report->items = items;
+        report->item_size = report->item_size ? report->item_size * 2 : 8;
+    }
+
+    item = report->items + report->item_number;
+    memset(item, 0, sizeof(dm_prop_report_item_t));
+    item->key = DM_malloc(key_len);
+    if (item->key == NULL) {
+        return NULL;
+    }
+    memcpy(item->key, key, key_len);
+    item->key_len = key_len;
+    item->key_hash = key_hash;
+    report->item_number++;
+
+    return item;
+}
+
+static void _dm_prop_report_drop(_IN_ dm_prop_report_t *report, _IN_ dm_prop_report_item_t *item)
+{
+    report->payload_len -= _DM_PROP_REPORT_MEMBER_LEN(item->key_len, item->value_len);
+    report->waiting--;
+    DM_free(item->value);
+    item->value = NULL;
+    item->value_len = 0;
+}
+
+static int _dm_prop_report_member(_IN_ dm_prop_report_t *report, _IN_ lite_cjson_t *key, _IN_ lite_cjson_t *value,
+                                  _IN_ int delta)
+{
+    dm_prop_report_item_t *item = NULL;
+    const char *raw = value->value;
+    int raw_len = value->value_length;
+    char *copy = NULL;
+
+    if (value->type == cJSON_String) {
+        /* keep the quotes */
+        raw--;
+        raw_len += 2;
+    }
+
+    item = _dm_prop_report_item(report, key->value, key->value_length);
+    if (item == NULL) {
+        return DM_MEMORY_NOT_ENOUGH;
+    }
+
+    if (delta && item->reported != NULL && item->reported_len == raw_len &&
+        memcmp(item->reported, raw, raw_len) == 0) {
+        /* back to the value reported last time, nothing to report */
+        if (item->value != NULL) {
+            _dm_prop_report_drop(report, item);
+        }
+        return SUCCESS_RETURN;
+    }
+
+    if (item->value != NULL && item->value_len == raw_len && memcmp(item->value, raw, raw_len) == 0) {
+        return SUCCESS_RETURN;
+    }
+
+    copy = DM_malloc(raw_len);
+    if (copy == NULL) {
+        return DM_MEMORY_NOT_ENOUGH;
+    }
+    memcpy(copy, raw, raw_len);
+
+    if (item->value != NULL) {
+        /* replacing a waiting value keeps the window it opened, or a value changing faster is never sent */
+        _dm_prop_report_drop(report, item);
+    } else if (report->waiting == 0) {
+        report->first_ms = HAL_UptimeMs();
+    }
+    item->value = copy;
+    item->value_len = raw_len;
+    report->payload_len += _DM_PROP_REPORT_MEMBER_LEN(item->key_len, item->value_len);
+    report->waiting++;
+
+    return SUCCESS_RETURN;
+}
+
+int dm_prop_report_merge(_IN_ dm_prop_report_t *report, _IN_ const char *payload, _IN_ int payload_len,
+                         _IN_ int delta)
+{
+    int res = 0, index = 0, node = 0;
+    lite_cjson_node_t nodes[DM_PROP_REPORT_INDEX_NODES];
+    lite_cjson_index_t lite_index;
+    lite_cjson_t lite, lite_key, lite_value;
+
+    if (report == NULL || payload == NULL || payload_len <= 0) {
+        return DM_INVALID_PARAMETER;
+    }
+
+    memset(&lite_index, 0, sizeof(lite_cjson_index_t));
+    lite_index.nodes = nodes;
+    lite_index.size = DM_PROP_REPORT_INDEX_NODES;
+    lite_index.depth = 1;
+
+    res = dm_utils_json_index_parse(payload, payload_len, cJSON_Object, &lite_index, &lite);
+    if (res != SUCCESS_RETURN) {
+        return DM_JSON_PARSE_FAILED;
+    }
+
+    if (lite_index.count <= lite_index.size) {
+        /* members of root follow it one after another */
+        for (index = 0, node = 1; index < lite.size; index++, node = nodes[node].next) {
+            memset(&lite_key, 0, sizeof(lite_cjson_t));
+            lite_key.value = (char *)nodes[node].key;
+            lite_key.value_length = nodes[node].key_len;
+            res = _dm_prop_report_member(report, &lite_key, &nodes[node].item, delta);
+            if (res != SUCCESS_RETURN) {
+                return res;
+            }
+        }
+        return SUCCESS_RETURN;
+    }
+
+    for (index = 0; index < lite.size; index++) {
+        memset(&lite_key, 0, sizeof(lite_cjson_t));
+        memset(&lite_value, 0, sizeof(lite_cjson_t));
+        res = lite_cjson_object_item_by_index(&lite, index, &lite_key, &lite_value);
+        if (res != SUCCESS_RETURN) {
+            return DM_JSON_PARSE_FAILED;
+        }
+        res = _dm_prop_report_member(report, &lite_key, &lite_value, delta);
+        if (res != SUCCESS_RETURN) {
+            return res;
+        }
+    }
+
+    return SUCCESS_RETURN;
+}
+
+int dm_prop_report_payload(_IN_ dm_prop_report_t *report, _OU_ char **payload, _OU_ int *payload_len)
+{
+    int index = 0, offset = 0;
+    char *buffer = NULL;
+    dm_prop_report_item_t *item = NULL;
+
+    if (report == NULL || payload == NULL || *payload != NULL || payload_len == NULL) {
+        return DM_INVALID_PARAMETER;
+    }
+
+    if (report->waiting == 0) {
+        return FAIL_RETURN;
+    }
+
+    /* '{' in front, last ',' becomes '}' */
+    buffer = DM_malloc(report->payload_len + 2);
+    if (buffer == NULL) {
+        return DM_MEMORY_NOT_ENOUGH;
+    }
+
+    buffer[offset++] = '{';
+    for (index = 0; index < report->item_number; index++) {
+        item = report->items + index;
+        if (item->value == NULL) {
+            continue;
+        }
+        buffer[offset++] = '\"';
+        memcpy(buffer + offset, item->key, item->key_len);
+        offset += item->key_len;
+        buffer[offset++] = '\"';
+        buffer[offset++] = ':';
+        memcpy(buffer + offset, item->value, item->value_len);
+        offset += item->value_len;
+        buffer[offset++] = ',';
+    }
+    buffer[offset - 1] = '}';
+    buffer[offset] = '\0';
+
+    *payload = buffer;
+    *payload_len = offset;
+
+    return SUCCESS_RETURN;
+}
+
+void dm_prop_report_done(_IN_ dm_prop_report_t *report, _IN_ int delta)
+{
+    int index = 0;
+    dm_prop_report_item_t *item = NULL;
+
+    if (report == NULL) {
+        return;
+    }
+
+    for (index = 0; index < report->item_number; index++) {
+        item = report->items + index;
+        if (item->value == NULL) {
+            if (!delta && item->reported != NULL) {
+                DM_free(item->reported);
+                item->reported = NULL;
+                item->reported_len = 0;
+            }
+            continue;
+        }
+        if (delta) {
+            if (item->reported != NULL) {
+                DM_free(item->reported);
+            }
+            item->reported = item->value;
+            item->reported_len = item->value_len;
+        } else {
+            DM_free(item->value);
+            if (!delta && item->reported != NULL) {
+                DM_free(item->reported);
+                item->reported = NULL;
+                item->reported_len = 0;
+            }
+        }
+        item->value = NULL;
+        item->value_len = 0;
+    }
+
+    report->waiting = 0;
+    report->payload_len = 0;
+}
+
+void dm_prop_report_clear(_IN_ dm_prop_report_t *report)
+{
+    int index = 0;
+    dm_prop_report_item_t *item = NULL;
+
+    if (report == NULL) {
+        return;
+    }
+
+    for (index = 0; index < report->item_number; index++) {
+        item = report->items + index;
+        DM_free(item->key);
+        if (item->value != NULL) {
+            DM_free(item->value);
+        }
+        if (item->reported != NULL) {
+            DM_free(item->reported);
+        }
+    }
+    if (report->items != NULL) {
+        DM_free(report->items);
+    }
+
+    memset(report, 0, sizeof(dm_prop_report_t));
+}
+
+#endif
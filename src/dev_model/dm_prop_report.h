@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2015-2018 Alibaba Group Holding Limited
+ */
+
+#if !defined(DEVICE_MODEL_RAWDATA_SOLO)
+#ifndef _DM_PROP_REPORT_H_
+#define _DM_PROP_REPORT_H_
+
+#include "iotx_dm_internal.h"
+
+/*
+ * Property report accumulator of one device.
+ *
+ * Property posts made within a window are merged member by member into one payload, a later
+ * value of an identifier replaces the earlier one. In delta mode the value reported last time
+ * is kept as well, and a value equal to it is left out of next report.
+ * Values are kept as raw JSON text, so nested struct and array values are compared as written.
+ */
+
+/* top level members of a property post found without rescanning the payload */
+#define DM_PROP_REPORT_INDEX_NODES (16)
+
+typedef struct {
+    char *key;                                  /* identifier as written in payload, without quotes */
+    int key_len;
+    unsigned int key_hash;
+    char *value;                                /* value waiting to be reported, NULL if none */
+    int value_len;
+    char *reported;                             /* value reported last time, only kept in delta mode */
+    int reported_len;
+} dm_prop_report_item_t;
+
+typedef struct {
+    uint64_t first_ms;                          /* time oldest waiting value was merged */
+    int waiting;                                /* items with value waiting */
+    int payload_len;                            /* length of payload holding waiting values */
+    int item_number;
+    int item_size;
+    dm_prop_report_item_t *items;
+} dm_prop_report_t;
+
+/**
+ * @brief Merge property post @payload into @report.
+ *
+ * @param report. The accumulator.
+ * @param payload. JSON object of property identifiers and values.
+ * @param payload_len. The length of payload.
+ * @param delta. Leave out values equal to those reported last time.
+ *
+ * @return success or fail, an invalid payload merges nothing, but members merged before
+ *         running out of memory stay merged. Merging the same payload again is harmless.
+ */
+int dm_prop_report_merge(_IN_ dm_prop_report_t *report, _IN_ const char *payload, _IN_ int payload_len,
+                         _IN_ int delta);
+
+/**
+ * @brief Assemble waiting values into one property post payload.
+ *
+ * @param report. The accumulator.
+ * @param payload. JSON object, malloc by this function and should be free by caller.
+ * @param payload_len. The length of payload.
+ *
+ * @return success or fail, FAIL_RETURN if no value is waiting.
+ */
+int dm_prop_report_payload(_IN_ dm_prop_report_t *report, _OU_ char **payload, _OU_ int *payload_len);
+
+/**
+ * @brief Drop waiting values once their payload is sent, values are left waiting if it could not be sent.
+ *
+ * @param report. The accumulator.
+ * @param delta. Delta mode, sent values become those reported last time.
+ */
+void dm_prop_report_done(_IN_ dm_prop_report_t *report, _IN_ int delta);
+
+/**
+ * @brief Free all values kept by @report, @report itself is not freed.
+ */
+void dm_prop_report_clear(_IN_ dm_prop_report_t *report);
+
+#endif
+#endif
@@ -345,6 +345,84 @@ static int _dm_shw_data_search(_IN_ dm_shw_data_t *input, _IN_ char *key,
     return FAIL_RETURN;
 }
 
+static unsigned int _dm_shw_identifier_hash(_IN_ const char *identifier, _IN_ int identifier_len)
+{
+    unsigned int hash = 2166136261u;
+    int index = 0;
+
+    for (index = 0; index < identifier_len; index++) {
+        hash = (hash ^ (unsigned char)identifier[index]) * 16777619u;
+    }
+
+    return hash;
+}
+
+/* index property identifiers by open addressing at no more than half load, done once TSL is parsed */
+static int _dm_shw_property_index_build(_IN_ dm_shw_t *shadow)
+{
+    int size = 1, index = 0, slot = 0;
+    char *identifier = NULL;
+
+    if (shadow->property_number <= 0 || shadow->properties == NULL) {
+        return SUCCESS_RETURN;
+    }
+
+    while (size < shadow->property_number * 2) {
+        size <<= 1;
+    }
+
+    shadow->property_index = DM_malloc(sizeof(int) * size);
+    if (shadow->property_index == NULL) {
+        return DM_MEMORY_NOT_ENOUGH;
+    }
+    memset(shadow->property_index, 0, sizeof(int) * size);
+    shadow->property_index_size = size;
+
+    for (index = 0; index < shadow->property_number; index++) {
+        identifier = shadow->properties[index].identifier;
+        if (identifier == NULL) {
+            continue;
+        }
+        slot = _dm_shw_identifier_hash(identifier, strlen(identifier)) & (size - 1);
+        while (shadow->property_index[slot] != 0) {
+            slot = (slot + 1) & (size - 1);
+        }
+        shadow->property_index[slot] = index + 1;
+    }
+
+    return SUCCESS_RETURN;
+}
+
+/* index of property whose identifier is exactly @identifier, -1 if none */
+static int _dm_shw_property_lookup(_IN_ dm_shw_t *shadow, _IN_ const char *identifier, _IN_ int identifier_len)
+{
+    int index = 0, slot = 0;
+    dm_shw_data_t *property = NULL;
+
+    if (shadow->property_index != NULL) {
+        slot = _dm_shw_identifier_hash(identifier, identifier_len) & (shadow->property_index_size - 1);
+        while (shadow->property_index[slot] != 0) {
+            property = shadow->properties + shadow->property_index[slot] - 1;
+            if (strlen(property->identifier) == identifier_len &&
+                memcmp(property->identifier, identifier, identifier_len) == 0) {
+                return shadow->property_index[slot] - 1;
+            }
+            slot = (slot + 1) & (shadow->property_index_size - 1);
+        }
+        return -1;
+    }
+
+    for (index = 0; index < shadow->property_number; index++) {
+        property = shadow->properties + index;
+        if (property->identifier != NULL && strlen(property->identifier) == identifier_len &&
+            memcmp(property->identifier, identifier, identifier_len) == 0) {
+            return index;
+        }
+    }
+
+    return -1;
+}
+
 static int _dm_shw_property_search(_IN_ dm_shw_t *shadow, _IN_ char *key, _IN_ int key_len,
                                    _OU_ dm_shw_data_t **property, _OU_ int *index)
 {
@@ -359,6 +437,18 @@ static int _dm_shw_property_search(_IN_ dm_shw_t *shadow, _IN_ char *key, _IN_ i
         return DM_TSL_PROPERTY_NOT_EXIST;
     }
 
+    if (shadow->property_index != NULL) {
+        /* property identifier is the key up to its first '.' or '[' */
+        while (item_index < key_len && key[item_index] != DM_SHW_KEY_DELIMITER && key[item_index] != '[') {
+            item_index++;
+        }
+        item_index = _dm_shw_property_lookup(shadow, key, item_index);
+        if (item_index < 0) {
+            return FAIL_RETURN;
+        }
+        return _dm_shw_data_search(shadow->properties + item_index, key, key_len, property, index);
+    }
+
     for (item_index = 0; item_index < shadow->property_number; item_index++) {
         property_item = shadow->properties + item_index;
         res = _dm_shw_data_search(property_item, key, key_len, property, index);
@@ -481,6 +571,9 @@ int dm_shw_create(_IN_ iotx_dm_tsl_type_t type, _IN_ const char *tsl, _IN_ int t
     switch (type) {
         case IOTX_DM_TSL_TYPE_ALINK: {
             res = dm_tsl_alink_create(tsl, tsl_len, shadow);
+            if (res == SUCCESS_RETURN && _dm_shw_property_index_build(*shadow) != SUCCESS_RETURN) {
+                dm_log_warning("TSL Property Index Not Built, Properties Are Searched One By One");
+            }
         }
         break;
         case IOTX_DM_TSL_TYPE_TLV: {
@@ -1508,40 +1601,48 @@ int dm_shw_get_service_input_output_value(_IN_ dm_shw_data_target_e type, _IN_ d
     return SUCCESS_RETURN;
 }
 
-static int _dm_shw_int_insert_json_item(_IN_ dm_shw_data_t *data, _IN_ lite_cjson_item_t *lite)
+static int _dm_shw_int_insert_json_item(_IN_ dm_shw_data_t *data, _IN_ lite_cjson_item_t *lite,
+        _IN_ lite_cjson_arena_t *arena)
 {
-    lite_cjson_add_number_to_object(lite, data->identifier, data->data_value.value_int);
+    lite_cjson_arena_add_number_to_object(arena, lite, data->identifier, data->data_value.value_int);
 
     return SUCCESS_RETURN;
 }
 
-static int _dm_shw_float_insert_json_item(_IN_ dm_shw_data_t *data, _IN_ lite_cjson_item_t *lite)
+static int _dm_shw_float_insert_json_item(_IN_ dm_shw_data_t *data, _IN_ lite_cjson_item_t *lite,
+        _IN_ lite_cjson_arena_t *arena)
 {
-    lite_cjson_add_number_to_object(lite, data->identifier, data->data_value.value_float);
+    lite_cjson_arena_add_number_to_object(arena, lite, data->identifier, data->data_value.value_float);
 
     return SUCCESS_RETURN;
 }
 
-static int _dm_shw_double_insert_json_item(_IN_ dm_shw_data_t *data, _IN_ lite_cjson_item_t *lite)
+static int _dm_shw_double_insert_json_item(_IN_ dm_shw_data_t *data, _IN_ lite_cjson_item_t *lite,
+        _IN_ lite_cjson_arena_t *arena)
 {
-    lite_cjson_add_number_to_object(lite, data->identifier, data->data_value.value_double);
+    lite_cjson_arena_add_number_to_object(arena, lite, data->identifier, data->data_value.value_double);
 
     return SUCCESS_RETURN;
 }
 
-static int _dm_shw_string_insert_json_item(_IN_ dm_shw_data_t *data, _IN_ lite_cjson_item_t *lite)
+static int _dm_shw_string_insert_json_item(_IN_ dm_shw_data_t *data, _IN_ lite_cjson_item_t *lite,
+        _IN_ lite_cjson_arena_t *arena)
 {
     char *value = (data->data_value.value == NULL) ? ("") : (data->data_value.value);
-    lite_cjson_add_string_to_object(lite, data->identifier, value);
+    lite_cjson_arena_add_string_to_object(arena, lite, data->identifier, value);
 
     return SUCCESS_RETURN;
 }
 
-static int _dm_shw_array_insert_json_item(_IN_ dm_shw_data_t *data, _IN_ lite_cjson_item_t *lite);
-static int _dm_shw_struct_insert_json_item(_IN_ dm_shw_data_t *data, _IN_ lite_cjson_item_t *lite);
-static int _dm_shw_data_insert_json_item(_IN_ dm_shw_data_t *data, _IN_ lite_cjson_item_t *lite);
+static int _dm_shw_array_insert_json_item(_IN_ dm_shw_data_t *data, _IN_ lite_cjson_item_t *lite,
+        _IN_ lite_cjson_arena_t *arena);
+static int _dm_shw_struct_insert_json_item(_IN_ dm_shw_data_t *data, _IN_ lite_cjson_item_t *lite,
+        _IN_ lite_cjson_arena_t *arena);
+static int _dm_shw_data_insert_json_item(_IN_ dm_shw_data_t *data, _IN_ lite_cjson_item_t *lite,
+        _IN_ lite_cjson_arena_t *arena);
 
-static int _dm_shw_array_insert_json_item(_IN_ dm_shw_data_t *data, _IN_ lite_cjson_item_t *lite)
+static int _dm_shw_array_insert_json_item(_IN_ dm_shw_data_t *data, _IN_ lite_cjson_item_t *lite,
+        _IN_ lite_cjson_arena_t *arena)
 {
     int res = SUCCESS_RETURN, index = 0;
     lite_cjson_item_t *array = NULL, *array_item = NULL;
@@ -1554,16 +1655,16 @@ static int _dm_shw_array_insert_json_item(_IN_ dm_shw_data_t *data, _IN_ lite_cj
     complex_array = data->data_value.value;
 
     if (lite->type == cJSON_Array) {
-        array = lite_cjson_create_object();
+        array = lite_cjson_arena_create_object(arena);
         if (array == NULL) {
             return DM_MEMORY_NOT_ENOUGH;
         }
     }
 
-    array_item = lite_cjson_create_array();
+    array_item = lite_cjson_arena_create_array(arena);
     if (array_item == NULL) {
         if (array) {
-            lite_cjson_delete(array);
+            lite_cjson_arena_delete(arena, array);
         }
         return DM_MEMORY_NOT_ENOUGH;
     }
@@ -1575,14 +1676,14 @@ static int _dm_shw_array_insert_json_item(_IN_ dm_shw_data_t *data, _IN_ lite_cj
             int value = 0;
             for (index = 0; index < complex_array->size; index++) {
                 value = *((int *)(complex_array->value) + index);
-                lite_cjson_add_item_to_array(array_item, lite_cjson_create_number((double)value));
+                lite_cjson_add_item_to_array(array_item, lite_cjson_arena_create_number(arena, (double)value));
             }
             if (lite->type == cJSON_Array) {
-                lite_cjson_add_item_to_object(array, data->identifier, array_item);
+                lite_cjson_arena_add_item_to_object(arena, array, data->identifier, array_item);
                 lite_cjson_add_item_to_array(lite, array);
             } else {
-                lite_cjson_add_item_to_object(lite, data->identifier, array_item);
-                lite_cjson_delete(array);
+                lite_cjson_arena_add_item_to_object(arena, lite, data->identifier, array_item);
+                lite_cjson_arena_delete(arena, array);
             }
         }
         break;
@@ -1590,14 +1691,14 @@ static int _dm_shw_array_insert_json_item(_IN_ dm_shw_data_t *data, _IN_ lite_cj
             float value = 0;
             for (index = 0; index < complex_array->size; index++) {
                 value = *((float *)(complex_array->value) + index);
-                lite_cjson_add_item_to_array(array_item, lite_cjson_create_number((double)value));
+                lite_cjson_add_item_to_array(array_item, lite_cjson_arena_create_number(arena, (double)value));
             }
             if (lite->type == cJSON_Array) {
-                lite_cjson_add_item_to_object(array, data->identifier, array_item);
+                lite_cjson_arena_add_item_to_object(arena, array, data->identifier, array_item);
                 lite_cjson_add_item_to_array(lite, array);
             } else {
-                lite_cjson_add_item_to_object(lite, data->identifier, array_item);
-                lite_cjson_delete(array);
+                lite_cjson_arena_add_item_to_object(arena, lite, data->identifier, array_item);
+                lite_cjson_arena_delete(arena, array);
             }
         }
         break;
@@ -1605,14 +1706,14 @@ static int _dm_shw_array_insert_json_item(_IN_ dm_shw_data_t *data, _IN_ lite_cj
             double value = 0;
             for (index = 0; index < complex_array->size; index++) {
                 value = *((double *)(complex_array->value) + index);
-                lite_cjson_add_item_to_array(array_item, lite_cjson_create_number(value));
+                lite_cjson_add_item_to_array(array_item, lite_cjson_arena_create_number(arena, value));
             }
             if (lite->type == cJSON_Array) {
-                lite_cjson_add_item_to_object(array, data->identifier, array_item);
+                lite_cjson_arena_add_item_to_object(arena, array, data->identifier, array_item);
                 lite_cjson_add_item_to_array(lite, array);
             } else {
-                lite_cjson_add_item_to_object(lite, data->identifier, array_item);
-                lite_cjson_delete(array);
+                lite_cjson_arena_add_item_to_object(arena, lite, data->identifier, array_item);
+                lite_cjson_arena_delete(arena, array);
             }
         }
         break;
@@ -1622,14 +1723,14 @@ static int _dm_shw_array_insert_json_item(_IN_ dm_shw_data_t *data, _IN_ lite_cj
             for (index = 0; index < complex_array->size; index++) {
                 value = *((char **)(complex_array->value) + index);
                 value = (value == NULL) ? ("") : (value);
-                lite_cjson_add_item_to_array(array_item, lite_cjson_create_string((const char *)value));
+                lite_cjson_add_item_to_array(array_item, lite_cjson_arena_create_string(arena, (const char *)value));
             }
             if (lite->type == cJSON_Array) {
-                lite_cjson_add_item_to_object(array, data->identifier, array_item);
+                lite_cjson_arena_add_item_to_object(arena, array, data->identifier, array_item);
                 lite_cjson_add_item_to_array(lite, array);
             } else {
-                lite_cjson_add_item_to_object(lite, data->identifier, array_item);
-                lite_cjson_delete(array);
+                lite_cjson_arena_add_item_to_object(arena, lite, data->identifier, array_item);
+                lite_cjson_arena_delete(arena, array);
             }
         }
         break;
@@ -1642,22 +1743,22 @@ static int _dm_shw_array_insert_json_item(_IN_ dm_shw_data_t *data, _IN_ lite_cj
             for (index = 0; index < complex_array->size; index++) {
                 array_data = (dm_shw_data_t *)(complex_array->value) + index;
                 if (array_data) {
-                    _dm_shw_struct_insert_json_item(array_data, array_item);
+                    _dm_shw_struct_insert_json_item(array_data, array_item, arena);
                 }
             }
 
             if (lite->type == cJSON_Array) {
-                lite_cjson_add_item_to_object(array, data->identifier, array_item);
+                lite_cjson_arena_add_item_to_object(arena, array, data->identifier, array_item);
                 lite_cjson_add_item_to_array(lite, array);
             } else {
-                lite_cjson_add_item_to_object(lite, data->identifier, array_item);
-                lite_cjson_delete(array);
+                lite_cjson_arena_add_item_to_object(arena, lite, data->identifier, array_item);
+                lite_cjson_arena_delete(arena, array);
             }
         }
         break;
         default: {
-            lite_cjson_delete(array_item);
-            lite_cjson_delete(array);
+            lite_cjson_arena_delete(arena, array_item);
+            lite_cjson_arena_delete(arena, array);
         }
         break;
     }
@@ -1665,7 +1766,8 @@ static int _dm_shw_array_insert_json_item(_IN_ dm_shw_data_t *data, _IN_ lite_cj
     return res;
 }
 
-static int _dm_shw_struct_insert_json_item(_IN_ dm_shw_data_t *data, _IN_ lite_cjson_item_t *lite)
+static int _dm_shw_struct_insert_json_item(_IN_ dm_shw_data_t *data, _IN_ lite_cjson_item_t *lite,
+        _IN_ lite_cjson_arena_t *arena)
 {
     int res = 0, index = 0;
     lite_cjson_item_t *lite_object = NULL, *lite_item = NULL;
@@ -1677,15 +1779,15 @@ static int _dm_shw_struct_insert_json_item(_IN_ dm_shw_data_t *data, _IN_ lite_c
     }
 
     if (lite->type == cJSON_Array) {
-        lite_object = lite_cjson_create_object();
+        lite_object = lite_cjson_arena_create_object(arena);
         if (lite_object == NULL) {
             return DM_MEMORY_NOT_ENOUGH;
         }
     }
 
-    lite_item = lite_cjson_create_object();
+    lite_item = lite_cjson_arena_create_object(arena);
     if (lite_item == NULL) {
-        lite_cjson_delete(lite_object);
+        lite_cjson_arena_delete(arena, lite_object);
         return DM_MEMORY_NOT_ENOUGH;
     }
 
@@ -1693,31 +1795,32 @@ static int _dm_shw_struct_insert_json_item(_IN_ dm_shw_data_t *data, _IN_ lite_c
 
     for (index = 0; index < complex_struct->size; index++) {
         current_data = (dm_shw_data_t *)complex_struct->value + index;
-        _dm_shw_data_insert_json_item(current_data, lite_item);
+        _dm_shw_data_insert_json_item(current_data, lite_item, arena);
     }
     if (lite->type == cJSON_Array) {
         if (data->identifier) {
-            lite_cjson_add_item_to_object(lite_object, data->identifier, lite_item);
+            lite_cjson_arena_add_item_to_object(arena, lite_object, data->identifier, lite_item);
             lite_cjson_add_item_to_array(lite, lite_object);
         } else {
             lite_cjson_add_item_to_array(lite, lite_item);
-            lite_cjson_delete(lite_object);
+            lite_cjson_arena_delete(arena, lite_object);
         }
     } else {
         if (data->identifier) {
-            lite_cjson_add_item_to_object(lite, data->identifier, lite_item);
-            lite_cjson_delete(lite_object);
+            lite_cjson_arena_add_item_to_object(arena, lite, data->identifier, lite_item);
+            lite_cjson_arena_delete(arena, lite_object);
         } else {
             res = FAIL_RETURN;
-            lite_cjson_delete(lite_item);
-            lite_cjson_delete(lite_object);
+            lite_cjson_arena_delete(arena, lite_item);
+            lite_cjson_arena_delete(arena, lite_object);
         }
     }
 
     return res;
 }
 
-static int _dm_shw_data_insert_json_item(_IN_ dm_shw_data_t *data, _IN_ lite_cjson_item_t *lite)
+static int _dm_shw_data_insert_json_item(_IN_ dm_shw_data_t *data, _IN_ lite_cjson_item_t *lite,
+        _IN_ lite_cjson_arena_t *arena)
 {
     int res = 0;
     lite_cjson_item_t *data_object = NULL;
@@ -1727,7 +1830,7 @@ static int _dm_shw_data_insert_json_item(_IN_ dm_shw_data_t *data, _IN_ lite_cjs
     }
 
     if (lite->type == cJSON_Array) {
-        data_object = lite_cjson_create_object();
+        data_object = lite_cjson_arena_create_object(arena);
         if (data_object == NULL) {
             return DM_MEMORY_NOT_ENOUGH;
         }
@@ -1738,81 +1841,81 @@ static int _dm_shw_data_insert_json_item(_IN_ dm_shw_data_t *data, _IN_ lite_cjs
         case DM_SHW_DATA_TYPE_BOOL:
         case DM_SHW_DATA_TYPE_ENUM: {
             if (lite->type == cJSON_Array) {
-                res = _dm_shw_int_insert_json_item(data, data_object);
+                res = _dm_shw_int_insert_json_item(data, data_object, arena);
                 if (res == SUCCESS_RETURN) {
                     lite_cjson_add_item_to_array(lite, data_object);
                 }
             } else {
-                res = _dm_shw_int_insert_json_item(data, lite);
-                lite_cjson_delete(data_object);
+                res = _dm_shw_int_insert_json_item(data, lite, arena);
+                lite_cjson_arena_delete(arena, data_object);
             }
         }
         break;
         case DM_SHW_DATA_TYPE_FLOAT: {
             if (lite->type == cJSON_Array) {
-                res = _dm_shw_float_insert_json_item(data, data_object);
+                res = _dm_shw_float_insert_json_item(data, data_object, arena);
                 if (res == SUCCESS_RETURN) {
                     lite_cjson_add_item_to_array(lite, data_object);
                 }
             } else {
-                res = _dm_shw_float_insert_json_item(data, lite);
-                lite_cjson_delete(data_object);
+                res = _dm_shw_float_insert_json_item(data, lite, arena);
+                lite_cjson_arena_delete(arena, data_object);
             }
         }
         break;
         case DM_SHW_DATA_TYPE_DOUBLE: {
             if (lite->type == cJSON_Array) {
-                res = _dm_shw_double_insert_json_item(data, data_object);
+                res = _dm_shw_double_insert_json_item(data, data_object, arena);
                 if (res == SUCCESS_RETURN) {
                     lite_cjson_add_item_to_array(lite, data_object);
                 }
             } else {
-                res = _dm_shw_double_insert_json_item(data, lite);
-                lite_cjson_delete(data_object);
+                res = _dm_shw_double_insert_json_item(data, lite, arena);
+                lite_cjson_arena_delete(arena, data_object);
             }
         }
         break;
         case DM_SHW_DATA_TYPE_TEXT:
         case DM_SHW_DATA_TYPE_DATE: {
             if (lite->type == cJSON_Array) {
-                res = _dm_shw_string_insert_json_item(data, data_object);
+                res = _dm_shw_string_insert_json_item(data, data_object, arena);
                 if (res == SUCCESS_RETURN) {
                     lite_cjson_add_item_to_array(lite, data_object);
                 }
             } else {
-                res = _dm_shw_string_insert_json_item(data, lite);
-                lite_cjson_delete(data_object);
+                res = _dm_shw_string_insert_json_item(data, lite, arena);
+                lite_cjson_arena_delete(arena, data_object);
             }
         }
         break;
         case DM_SHW_DATA_TYPE_ARRAY: {
             /* dm_log_debug("DM_SHW_DATA_TYPE_ARRAY"); */
             if (lite->type == cJSON_Array) {
-                res = _dm_shw_array_insert_json_item(data, data_object);
+                res = _dm_shw_array_insert_json_item(data, data_object, arena);
                 if (res == SUCCESS_RETURN) {
                     lite_cjson_add_item_to_array(lite, data_object);
                 }
             } else {
-                res = _dm_shw_array_insert_json_item(data, lite);
-                lite_cjson_delete(data_object);
+                res = _dm_shw_array_insert_json_item(data, lite, arena);
+                lite_cjson_arena_delete(arena, data_object);
             }
         }
         break;
         case DM_SHW_DATA_TYPE_STRUCT: {
             /* dm_log_debug("DM_SHW_DATA_TYPE_STRUCT"); */
             if (lite->type == cJSON_Array) {
-                res = _dm_shw_struct_insert_json_item(data, data_object);
+                res = _dm_shw_struct_insert_json_item(data, data_object, arena);
                 if (res == SUCCESS_RETURN) {
                     lite_cjson_add_item_to_array(lite, data_object);
                 }
             } else {
-                res = _dm_shw_struct_insert_json_item(data, lite);
-                lite_cjson_delete(data_object);
+                res = _dm_shw_struct_insert_json_item(data, lite, arena);
+                lite_cjson_arena_delete(arena, data_object);
             }
         }
         break;
         default:
-            lite_cjson_delete(data_object);
+            lite_cjson_arena_delete(arena, data_object);
             res = FAIL_RETURN;
             break;
     }
@@ -1821,7 +1924,7 @@ static int _dm_shw_data_insert_json_item(_IN_ dm_shw_data_t *data, _IN_ lite_cjs
 }
 
 int dm_shw_assemble_property(_IN_ dm_shw_t *shadow, _IN_ char *identifier, _IN_ int identifier_len,
-                             _IN_ lite_cjson_item_t *lite)
+                             _IN_ lite_cjson_item_t *lite, _IN_ lite_cjson_arena_t *arena)
 {
     int res = 0, index = 0;
     dm_shw_data_t *property = NULL;
@@ -1830,21 +1933,14 @@ int dm_shw_assemble_property(_IN_ dm_shw_t *shadow, _IN_ char *identifier, _IN_
         return DM_INVALID_PARAMETER;
     }
 
-    for (index = 0; index < shadow->property_number; index++) {
-        property = shadow->properties + index;
-        if ((strlen(property->identifier) == identifier_len) &&
-            (memcmp(property->identifier, identifier, identifier_len) == 0)) {
-            /* dm_log_debug("Property Found: %.*s",identifier_len,identifier); */
-            break;
-        }
-    }
-
-    if (index == shadow->property_number) {
+    index = _dm_shw_property_lookup(shadow, identifier, identifier_len);
+    if (index < 0) {
         dm_log_debug("Property Not Found: %.*s", identifier_len, identifier);
         return FAIL_RETURN;
     }
+    property = shadow->properties + index;
 
-    res = _dm_shw_data_insert_json_item(property, lite);
+    res = _dm_shw_data_insert_json_item(property, lite, arena);
     if (res != SUCCESS_RETURN) {
         return FAIL_RETURN;
     }
@@ -1853,7 +1949,7 @@ int dm_shw_assemble_property(_IN_ dm_shw_t *shadow, _IN_ char *identifier, _IN_
 }
 
 int dm_shw_assemble_event_output(_IN_ dm_shw_t *shadow, _IN_ char *identifier, _IN_ int identifier_len,
-                                 _IN_ lite_cjson_item_t *lite)
+                                 _IN_ lite_cjson_item_t *lite, _IN_ lite_cjson_arena_t *arena)
 {
     int res = 0, index = 0;
     dm_shw_data_t *event_outputdata = NULL;
@@ -1880,7 +1976,7 @@ int dm_shw_assemble_event_output(_IN_ dm_shw_t *shadow, _IN_ char *identifier, _
     for (index = 0; index < event->output_data_number; index++) {
         event_outputdata = event->output_datas + index;
 
-        res = _dm_shw_data_insert_json_item(event_outputdata, lite);
+        res = _dm_shw_data_insert_json_item(event_outputdata, lite, arena);
         if (res != SUCCESS_RETURN) {
             return FAIL_RETURN;
         }
@@ -1890,7 +1986,7 @@ int dm_shw_assemble_event_output(_IN_ dm_shw_t *shadow, _IN_ char *identifier, _
 }
 
 int dm_shw_assemble_service_output(_IN_ dm_shw_t *shadow, _IN_ char *identifier, _IN_ int identifier_len,
-                                   _IN_ lite_cjson_item_t *lite)
+                                   _IN_ lite_cjson_item_t *lite, _IN_ lite_cjson_arena_t *arena)
 {
     int res = 0, index = 0;
     dm_shw_data_t *service_outputdata = NULL;
@@ -1917,7 +2013,7 @@ int dm_shw_assemble_service_output(_IN_ dm_shw_t *shadow, _IN_ char *identifier,
     for (index = 0; index < service->output_data_number; index++) {
         service_outputdata = service->output_datas + index;
 
-        res = _dm_shw_data_insert_json_item(service_outputdata, lite);
+        res = _dm_shw_data_insert_json_item(service_outputdata, lite, arena);
         if (res != SUCCESS_RETURN) {
             return FAIL_RETURN;
         }
@@ -2235,6 +2331,11 @@ void dm_shw_destroy(_IN_ dm_shw_t **shadow)
         return;
     }
 
+    if ((*shadow)->property_index) {
+        DM_free((*shadow)->property_index);
+        (*shadow)->property_index = NULL;
+    }
+
     /* Free Properties */
     if ((*shadow)->properties) {
         _dm_shw_properties_free((*shadow)->properties, (*shadow)->property_number);
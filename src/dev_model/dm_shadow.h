@@ -112,6 +112,8 @@ typedef struct {
 typedef struct {
     int property_number;
     dm_shw_data_t *properties;                /* property array, type is dm_shw_data_t */
+    int property_index_size;
+    int *property_index;                      /* hash of property identifier, 1 + index into properties, 0 unused */
     int event_number;
     dm_shw_event_t *events;                   /* event array, type is dm_shw_event_t */
     int service_number;
@@ -462,6 +464,7 @@ int dm_shw_get_service_input_output_value(_IN_ dm_shw_data_target_e type, _IN_ d
  * @param identifier. The Property Identifier
  * @param identifier_len. The Property Identifier Length
  * @param lite. The pointer to json array where to store property value
+ * @param arena. The arena lite items are created in, NULL to malloc each of them
  *
  * @warning The payload malloc by this function and need to be free manully.
  *
@@ -469,7 +472,7 @@ int dm_shw_get_service_input_output_value(_IN_ dm_shw_data_target_e type, _IN_ d
  *
  */
 int dm_shw_assemble_property(_IN_ dm_shw_t *shadow, _IN_ char *identifier, _IN_ int identifier_len,
-                             _IN_ lite_cjson_item_t *lite);
+                             _IN_ lite_cjson_item_t *lite, _IN_ lite_cjson_arena_t *arena);
 
 /**
  * @brief Get event output payload from TSL struct.
@@ -479,6 +482,7 @@ int dm_shw_assemble_property(_IN_ dm_shw_t *shadow, _IN_ char *identifier, _IN_
  * @param identifier. The Event Identifier
  * @param identifier_len. The Event Identifier Length
  * @param lite. The pointer to json array where to store event output value
+ * @param arena. The arena lite items are created in, NULL to malloc each of them
  *
  * @warning The payload malloc by this function and need to be free manully.
  *
@@ -486,7 +490,7 @@ int dm_shw_assemble_property(_IN_ dm_shw_t *shadow, _IN_ char *identifier, _IN_
  *
  */
 int dm_shw_assemble_event_output(_IN_ dm_shw_t *shadow, _IN_ char *identifier, _IN_ int identifier_len,
-                                 _IN_ lite_cjson_item_t *lite);
+                                 _IN_ lite_cjson_item_t *lite, _IN_ lite_cjson_arena_t *arena);
 
 /**
  * @brief Get service output payload from TSL struct.
@@ -496,6 +500,7 @@ int dm_shw_assemble_event_output(_IN_ dm_shw_t *shadow, _IN_ char *identifier, _
  * @param identifier. The Service Identifier
  * @param identifier_len. The Service Identifier Length
  * @param lite. The pointer to json array where to store service output value
+ * @param arena. The arena lite items are created in, NULL to malloc each of them
  *
  * @warning The payload malloc by this function and need to be free manully.
  *
@@ -503,7 +508,7 @@ int dm_shw_assemble_event_output(_IN_ dm_shw_t *shadow, _IN_ char *identifier, _
  *
  */
 int dm_shw_assemble_service_output(_IN_ dm_shw_t *shadow, _IN_ char *identifier, _IN_ int identifier_len,
-                                   _IN_ lite_cjson_item_t *lite);
+                                   _IN_ lite_cjson_item_t *lite, _IN_ lite_cjson_arena_t *arena);
 
 /**
  * @brief Free TSL struct.
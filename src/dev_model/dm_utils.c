@@ -409,6 +409,54 @@ int dm_utils_json_object_item(_IN_ lite_cjson_t *lite, _IN_ const char *key, _IN
     return SUCCESS_RETURN;
 }
 
+int dm_utils_json_index_parse(_IN_ const char *payload, _IN_ int payload_len, _IN_ int type,
+                              _IN_ lite_cjson_index_t *index, _OU_ lite_cjson_t *lite)
+{
+    if (payload == NULL || payload_len <= 0 || type < 0 || index == NULL || lite == NULL) {
+        return DM_INVALID_PARAMETER;
+    }
+
+    if (lite_cjson_index_parse(payload, payload_len, index) != SUCCESS_RETURN) {
+        if (index->count <= index->size) {
+            memset(lite, 0, sizeof(lite_cjson_t));
+            return FAIL_RETURN;
+        }
+
+        /* valid but larger than index, index->count > index->size makes lookups rescan @lite */
+        return dm_utils_json_parse(payload, payload_len, type, lite);
+    }
+
+    memcpy(lite, &index->nodes[0].item, sizeof(lite_cjson_t));
+    if (type != cJSON_Invalid && lite->type != type) {
+        memset(lite, 0, sizeof(lite_cjson_t));
+        return FAIL_RETURN;
+    }
+
+    return SUCCESS_RETURN;
+}
+
+int dm_utils_json_index_item(_IN_ lite_cjson_index_t *index, _IN_ lite_cjson_t *lite, _IN_ const char *key,
+                             _IN_ int key_len, _IN_ int type, _OU_ lite_cjson_t *lite_item)
+{
+    if (index == NULL || index->count > index->size) {
+        return dm_utils_json_object_item(lite, key, key_len, type, lite_item);
+    }
+
+    if (key == NULL || key_len <= 0 || type < 0 || lite_item == NULL) {
+        return DM_INVALID_PARAMETER;
+    }
+
+    memset(lite_item, 0, sizeof(lite_cjson_t));
+
+    if (lite_cjson_index_object_item(index, 0, key, key_len, lite_item) < 0 ||
+        (type != cJSON_Invalid && lite_item->type != type)) {
+        memset(lite_item, 0, sizeof(lite_cjson_t));
+        return FAIL_RETURN;
+    }
+
+    return SUCCESS_RETURN;
+}
+
 void *dm_utils_malloc(unsigned int size)
 {
 #ifdef INFRA_MEM_STATS
@@ -46,6 +46,18 @@ int dm_utils_uri_add_prefix(const char *prefix, char *uri, char **new_uri);
 int dm_utils_json_parse(const char *payload, int payload_len, int type, lite_cjson_t *lite);
 int dm_utils_json_object_item(lite_cjson_t *lite, const char *key, int key_len, int type,
                               lite_cjson_t *lite_item);
+
+/**
+ * @brief parse payload once into @index, so that its top level members are looked up without rescanning it.
+ *        If @index has not enough nodes, payload is parsed into @lite only and lookups fall back to rescanning.
+ *
+ * @param [in] index: index with nodes, size and depth set by caller.
+ * @param [out] lite: root of payload.
+ */
+int dm_utils_json_index_parse(const char *payload, int payload_len, int type, lite_cjson_index_t *index,
+                              lite_cjson_t *lite);
+int dm_utils_json_index_item(lite_cjson_index_t *index, lite_cjson_t *lite, const char *key, int key_len, int type,
+                             lite_cjson_t *lite_item);
 void *dm_utils_malloc(unsigned int size);
 void dm_utils_free(void *ptr);
 #endif
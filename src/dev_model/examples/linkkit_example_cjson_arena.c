@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2015-2018 Alibaba Group Holding Limited
+ */
+
+/*
+ * Cost of building a document with the lite_cjson_item_t API, once with an item, key and string
+ * allocated each at a time and freed by lite_cjson_delete(), once in a lite_cjson_arena_t whose
+ * blocks come from the heap, and once in an arena whose first block is on stack. Two shapes
+ * are built: a service reply, and a property post holding a struct and arrays.
+ *
+ * Allocations are counted through lite_cjson_init_hooks(), each of them is what takes the
+ * global mutex when infra_mem_stats is enabled. Printing a document costs the same in any
+ * case and is left out.
+ *
+ * usage: linkkit-example-cjson-arena [documents]
+ *     documents    documents of each shape built in each way, 200000 by default
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "infra_types.h"
+#include "infra_defs.h"
+#include "infra_cjson.h"
+
+#define EXAMPLE_STACK_BLOCK_SIZE    1024
+
+void HAL_Printf(const char *fmt, ...);
+int HAL_Snprintf(char *str, const int len, const char *fmt, ...);
+uint64_t HAL_UptimeMs(void);
+void *HAL_Malloc(uint32_t size);
+void HAL_Free(void *ptr);
+
+typedef lite_cjson_item_t *(*example_build_t)(lite_cjson_arena_t *arena);
+
+static uint32_t g_allocs = 0;
+
+static void *example_malloc(unsigned int size)
+{
+    g_allocs++;
+    return HAL_Malloc(size);
+}
+
+static void example_free(void *ptr)
+{
+    HAL_Free(ptr);
+}
+
+static lite_cjson_item_t *example_service_reply(lite_cjson_arena_t *arena)
+{
+    lite_cjson_item_t *root = lite_cjson_arena_create_object(arena);
+
+    lite_cjson_arena_add_number_to_object(arena, root, "code", 200);
+    lite_cjson_arena_add_string_to_object(arena, root, "result", "success");
+    lite_cjson_arena_add_number_to_object(arena, root, "Temperature", 25.5);
+    lite_cjson_arena_add_string_to_object(arena, root, "message", "operation done");
+
+    return root;
+}
+
+static lite_cjson_item_t *example_property_post(lite_cjson_arena_t *arena)
+{
+    lite_cjson_item_t *root = lite_cjson_arena_create_object(arena), *color = NULL, *array = NULL, *zone = NULL;
+    char zone_name[8];
+    int index;
+
+    lite_cjson_arena_add_number_to_object(arena, root, "PowerSwitch", 1);
+    lite_cjson_arena_add_number_to_object(arena, root, "CurrentTemperature", 23.4);
+    lite_cjson_arena_add_number_to_object(arena, root, "CurrentHumidity", 61);
+    lite_cjson_arena_add_string_to_object(arena, root, "DeviceName", "living room sensor");
+    lite_cjson_arena_add_string_to_object(arena, root, "WorkMode", "auto");
+
+    color = lite_cjson_arena_create_object(arena);
+    lite_cjson_arena_add_number_to_object(arena, color, "Red", 12);
+    lite_cjson_arena_add_number_to_object(arena, color, "Green", 200);
+    lite_cjson_arena_add_number_to_object(arena, color, "Blue", 33);
+    lite_cjson_arena_add_item_to_object(arena, root, "RGBColor", color);
+
+    array = lite_cjson_arena_create_array(arena);
+    for (index = 0; index < 6; index++) {
+        lite_cjson_add_item_to_array(array, lite_cjson_arena_create_number(arena, index * 1.5));
+    }
+    lite_cjson_arena_add_item_to_object(arena, root, "History", array);
+
+    array = lite_cjson_arena_create_array(arena);
+    for (index = 0; index < 3; index++) {
+        zone = lite_cjson_arena_create_object(arena);
+        HAL_Snprintf(zone_name, sizeof(zone_name), "z%d", index);
+        lite_cjson_arena_add_string_to_object(arena, zone, "zone", zone_name);
+        lite_cjson_arena_add_number_to_object(arena, zone, "level", index);
+        lite_cjson_add_item_to_array(array, zone);
+    }
+    lite_cjson_arena_add_item_to_object(arena, root, "Zones", array);
+
+    return root;
+}
+
+/* @way: 0 heap, 1 arena, 2 arena with its first block on stack */
+static void example_run(const char *shape, example_build_t build, int way, int documents)
+{
+    static const char *ways[] = {"heap", "arena", "arena + stack"};
+    char block[EXAMPLE_STACK_BLOCK_SIZE];
+    lite_cjson_arena_t arena;
+    lite_cjson_item_t *root = NULL;
+    uint32_t allocs = g_allocs;
+    uint64_t start, elapsed;
+    int index;
+
+    start = HAL_UptimeMs();
+    for (index = 0; index < documents; index++) {
+        if (way == 0) {
+            root = build(NULL);
+            lite_cjson_delete(root);
+        } else {
+            lite_cjson_arena_init(&arena, way == 2 ? block : NULL, way == 2 ? sizeof(block) : 0);
+            build(&arena);
+            lite_cjson_arena_deinit(&arena);
+        }
+    }
+    elapsed = HAL_UptimeMs() - start;
+
+    HAL_Printf("%-14s %-14s: %6d ns/doc, %d.%02d allocs/doc\n", shape, ways[way],
+               (int)(elapsed * 1000000 / documents), (int)((g_allocs - allocs) / documents),
+               (int)((uint64_t)(g_allocs - allocs) * 100 / documents % 100));
+}
+
+int main(int argc, char *argv[])
+{
+    lite_cjson_hooks hooks;
+    int documents = 200000, way;
+
+    if (argc > 1) {
+        documents = atoi(argv[1]);
+    }
+    if (documents <= 0) {
+        documents = 200000;
+    }
+
+    hooks.malloc_fn = example_malloc;
+    hooks.free_fn = example_free;
+    lite_cjson_init_hooks(&hooks);
+
+    for (way = 0; way < 3; way++) {
+        example_run("service reply", example_service_reply, way, documents);
+    }
+    for (way = 0; way < 3; way++) {
+        example_run("property post", example_property_post, way, documents);
+    }
+
+    return 0;
+}
@@ -0,0 +1,313 @@
+/*
+ * Copyright (C) 2015-2018 Alibaba Group Holding Limited
+ */
+
+/*
+ * Cost of pulling fields out of a payload with lite_cjson, once with lite_cjson_object_item(),
+ * which rescans the container for every lookup, and once through lite_cjson_index_parse() and
+ * lite_cjson_index_object_item(). Payloads of 256 bytes to 64 KB are looked up in three ways:
+ *
+ *   request    top level members of a thing.service.property.set, as dm_msg_request_parse() does,
+ *              "method" coming after a "params" that makes up most of the payload
+ *   property   every property of the same payload by name
+ *   ota        members of "data" of an OTA upgrade notify, which carries an "extData" object that
+ *              makes up most of the payload, indexed two levels deep only
+ *
+ * Each way is repeated for about EXAMPLE_RUN_MS, microseconds per payload are printed.
+ *
+ * usage: linkkit-example-cjson-index [max_len]
+ *     max_len      largest payload, sizes double from 256 bytes up to it, 65536 by default
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "infra_types.h"
+#include "infra_defs.h"
+#include "infra_cjson.h"
+
+#define EXAMPLE_MIN_LEN         256
+#define EXAMPLE_KEY_MAXLEN      16
+#define EXAMPLE_TOP_NODES       16
+#define EXAMPLE_OTA_NODES       32
+#define EXAMPLE_RUN_MS          200
+
+void HAL_Printf(const char *fmt, ...);
+int HAL_Snprintf(char *str, const int len, const char *fmt, ...);
+uint64_t HAL_UptimeMs(void);
+void *HAL_Malloc(uint32_t size);
+void HAL_Free(void *ptr);
+
+typedef struct {
+    char               *json;
+    int                 len;
+    char              (*keys)[EXAMPLE_KEY_MAXLEN];
+    int                 keys_num;
+    lite_cjson_node_t  *nodes;          /* enough for every property */
+    int                 nodes_num;
+} example_doc_t;
+
+/* lookups of one payload done in one way, number of fields found */
+typedef int (*example_lookup_t)(example_doc_t *doc);
+
+static const char *g_request_keys[] = {"id", "version", "params", "method"};
+static const char *g_ota_keys[] = {"size", "version", "url", "signMethod", "md5", "sign"};
+
+static int example_request_rescan(example_doc_t *doc)
+{
+    lite_cjson_t root, item;
+    int idx, found = 0;
+
+    if (lite_cjson_parse(doc->json, doc->len, &root) != 0) {
+        return -1;
+    }
+    for (idx = 0; idx < sizeof(g_request_keys) / sizeof(g_request_keys[0]); idx++) {
+        if (lite_cjson_object_item(&root, g_request_keys[idx], strlen(g_request_keys[idx]), &item) == 0) {
+            found++;
+        }
+    }
+    return found;
+}
+
+static int example_request_index(example_doc_t *doc)
+{
+    lite_cjson_node_t nodes[EXAMPLE_TOP_NODES];
+    lite_cjson_index_t index;
+    lite_cjson_t item;
+    int idx, found = 0;
+
+    index.nodes = nodes;
+    index.size = EXAMPLE_TOP_NODES;
+    index.depth = 1;
+    if (lite_cjson_index_parse(doc->json, doc->len, &index) != 0) {
+        return -1;
+    }
+    for (idx = 0; idx < sizeof(g_request_keys) / sizeof(g_request_keys[0]); idx++) {
+        if (lite_cjson_index_object_item(&index, 0, g_request_keys[idx], strlen(g_request_keys[idx]), &item) >= 0) {
+            found++;
+        }
+    }
+    return found;
+}
+
+static int example_property_rescan(example_doc_t *doc)
+{
+    lite_cjson_t root, params, item;
+    int idx, found = 0;
+
+    if (lite_cjson_parse(doc->json, doc->len, &root) != 0 ||
+        lite_cjson_object_item(&root, "params", strlen("params"), &params) != 0) {
+        return -1;
+    }
+    for (idx = 0; idx < doc->keys_num; idx++) {
+        if (lite_cjson_object_item(&params, doc->keys[idx], strlen(doc->keys[idx]), &item) == 0) {
+            found++;
+        }
+    }
+    return found;
+}
+
+static int example_property_index(example_doc_t *doc)
+{
+    lite_cjson_index_t index;
+    lite_cjson_t item;
+    int idx, params, found = 0;
+
+    index.nodes = doc->nodes;
+    index.size = doc->nodes_num;
+    index.depth = 2;
+    if (lite_cjson_index_parse(doc->json, doc->len, &index) != 0) {
+        return -1;
+    }
+    params = lite_cjson_index_object_item(&index, 0, "params", strlen("params"), NULL);
+    if (params < 0) {
+        return -1;
+    }
+    for (idx = 0; idx < doc->keys_num; idx++) {
+        if (lite_cjson_index_object_item(&index, params, doc->keys[idx], strlen(doc->keys[idx]), &item) >= 0) {
+            found++;
+        }
+    }
+    return found;
+}
+
+static int example_ota_rescan(example_doc_t *doc)
+{
+    lite_cjson_t root, data, item;
+    int idx, found = 0;
+
+    if (lite_cjson_parse(doc->json, doc->len, &root) != 0 ||
+        lite_cjson_object_item(&root, "data", strlen("data"), &data) != 0) {
+        return -1;
+    }
+    for (idx = 0; idx < sizeof(g_ota_keys) / sizeof(g_ota_keys[0]); idx++) {
+        if (lite_cjson_object_item(&data, g_ota_keys[idx], strlen(g_ota_keys[idx]), &item) == 0) {
+            found++;
+        }
+    }
+    return found;
+}
+
+static int example_ota_index(example_doc_t *doc)
+{
+    lite_cjson_node_t nodes[EXAMPLE_OTA_NODES];
+    lite_cjson_index_t index;
+    lite_cjson_t item;
+    int idx, data, found = 0;
+
+    index.nodes = nodes;
+    index.size = EXAMPLE_OTA_NODES;
+    index.depth = 2;
+    if (lite_cjson_index_parse(doc->json, doc->len, &index) != 0) {
+        return -1;
+    }
+    data = lite_cjson_index_object_item(&index, 0, "data", strlen("data"), NULL);
+    if (data < 0) {
+        return -1;
+    }
+    for (idx = 0; idx < sizeof(g_ota_keys) / sizeof(g_ota_keys[0]); idx++) {
+        if (lite_cjson_index_object_item(&index, data, g_ota_keys[idx], strlen(g_ota_keys[idx]), &item) >= 0) {
+            found++;
+        }
+    }
+    return found;
+}
+
+/* thing.service.property.set of about @len bytes, names of its properties go to @doc->keys */
+static int example_property_set(example_doc_t *doc, int len)
+{
+    const char *head = "{\"id\":\"12345\",\"version\":\"1.0\",\"params\":{";
+    const char *tail = "},\"method\":\"thing.service.property.set\"}";
+    int pos, prop;
+
+    doc->json = HAL_Malloc(len + EXAMPLE_MIN_LEN);
+    doc->keys = HAL_Malloc(sizeof(doc->keys[0]) * (len / 8 + 1));
+    if (doc->json == NULL || doc->keys == NULL) {
+        return -1;
+    }
+
+    pos = HAL_Snprintf(doc->json, len + EXAMPLE_MIN_LEN, "%s", head);
+    for (prop = 0; pos + (int)strlen(tail) < len; prop++) {
+        HAL_Snprintf(doc->keys[prop], EXAMPLE_KEY_MAXLEN, "Prop%d", prop);
+        pos += HAL_Snprintf(doc->json + pos, len + EXAMPLE_MIN_LEN - pos, "%s\"%s\":%d", prop ? "," : "",
+                            doc->keys[prop], prop % 1000);
+    }
+    pos += HAL_Snprintf(doc->json + pos, len + EXAMPLE_MIN_LEN - pos, "%s", tail);
+    doc->len = pos;
+    doc->keys_num = prop;
+
+    doc->nodes_num = prop + EXAMPLE_TOP_NODES;
+    doc->nodes = HAL_Malloc(sizeof(lite_cjson_node_t) * doc->nodes_num);
+    return (doc->nodes == NULL) ? -1 : 0;
+}
+
+/* OTA upgrade notify of about @len bytes */
+static int example_ota_notify(example_doc_t *doc, int len)
+{
+    const char *head = "{\"code\":\"1000\",\"data\":{\"extData\":{";
+    const char *tail = "},\"size\":372104,\"sign\":\"93230c3bde425a9d7984a594ac55ea1e\",\"version\":\"app-1.0.1\","
+                       "\"url\":\"https://iotx-ota.oss-cn-shanghai.aliyuncs.com/ota/a1example/firmware.bin\","
+                       "\"signMethod\":\"Md5\",\"md5\":\"93230c3bde425a9d7984a594ac55ea1e\"},"
+                       "\"id\":1536,\"message\":\"success\"}";
+    int pos, item;
+
+    doc->json = HAL_Malloc(len + strlen(tail) + EXAMPLE_MIN_LEN);
+    if (doc->json == NULL) {
+        return -1;
+    }
+
+    pos = HAL_Snprintf(doc->json, len, "%s", head);
+    for (item = 0; pos + (int)strlen(tail) < len; item++) {
+        pos += HAL_Snprintf(doc->json + pos, len + EXAMPLE_MIN_LEN - pos, "%s\"key%d\":\"value%d\"", item ? "," : "",
+                            item, item);
+    }
+    pos += HAL_Snprintf(doc->json + pos, len + strlen(tail) + EXAMPLE_MIN_LEN - pos, "%s", tail);
+    doc->len = pos;
+    return 0;
+}
+
+static void example_doc_free(example_doc_t *doc)
+{
+    if (doc->json != NULL) {
+        HAL_Free(doc->json);
+    }
+    if (doc->keys != NULL) {
+        HAL_Free(doc->keys);
+    }
+    if (doc->nodes != NULL) {
+        HAL_Free(doc->nodes);
+    }
+    memset(doc, 0, sizeof(example_doc_t));
+}
+
+/* microseconds per payload looked up by @lookup, -1 if a field is missed */
+static double example_time(example_doc_t *doc, example_lookup_t lookup, int expected)
+{
+    uint64_t start = HAL_UptimeMs(), elapsed;
+    int runs = 0;
+
+    do {
+        if (lookup(doc) != expected) {
+            return -1;
+        }
+        runs++;
+        elapsed = HAL_UptimeMs() - start;
+    } while (elapsed < EXAMPLE_RUN_MS);
+
+    return (double)elapsed * 1000 / runs;
+}
+
+static int example_compare(const char *name, example_doc_t *doc, example_lookup_t rescan, example_lookup_t index,
+                           int expected)
+{
+    double rescan_us = example_time(doc, rescan, expected);
+    double index_us = example_time(doc, index, expected);
+
+    if (rescan_us < 0 || index_us < 0) {
+        HAL_Printf("%-8s %6d bytes: lookup failed\n", name, doc->len);
+        return -1;
+    }
+    HAL_Printf("%-8s %6d bytes: %10.2f us rescan, %8.2f us index, %7.1f times\n", name, doc->len, rescan_us, index_us,
+               rescan_us / (index_us > 0 ? index_us : 1));
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    example_doc_t doc;
+    int max_len = 65536, len, res = 0;
+
+    if (argc > 1) {
+        max_len = atoi(argv[1]);
+    }
+    if (max_len < EXAMPLE_MIN_LEN) {
+        HAL_Printf("usage: %s [max_len]\n", argv[0]);
+        return -1;
+    }
+
+    memset(&doc, 0, sizeof(doc));
+    for (len = EXAMPLE_MIN_LEN; len <= max_len && res == 0; len *= 2) {
+        if (example_property_set(&doc, len) != 0) {
+            res = -1;
+            break;
+        }
+        res = example_compare("request", &doc, example_request_rescan, example_request_index,
+                              sizeof(g_request_keys) / sizeof(g_request_keys[0]));
+        if (res == 0) {
+            res = example_compare("property", &doc, example_property_rescan, example_property_index, doc.keys_num);
+        }
+        example_doc_free(&doc);
+
+        if (res == 0 && example_ota_notify(&doc, len) != 0) {
+            res = -1;
+        }
+        if (res == 0) {
+            res = example_compare("ota", &doc, example_ota_rescan, example_ota_index,
+                                  sizeof(g_ota_keys) / sizeof(g_ota_keys[0]));
+        }
+        example_doc_free(&doc);
+    }
+
+    return res;
+}
@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2015-2018 Alibaba Group Holding Limited
+ */
+
+/*
+ * Cost of putting the params of a property post into the alink request envelope
+ * {"id":"..","version":"1.0","params":..,"method":".."}, written three ways:
+ *
+ *   printf     as dm_msg_request() used to: HAL_Snprintf() into a buffer from HAL_Malloc(), then
+ *              lite_cjson_parse() of the whole payload to check it, and strlen() of it to publish
+ *   writer     as dm_msg_request() does now: the lite_cjson streaming writer into a stack buffer of
+ *              CONFIG_DM_MSG_STACK_PAYLOAD_LEN, written again into a buffer of exact length from
+ *              HAL_Malloc() only when it did not fit
+ *   checked    writer, after lite_cjson_parse() of the params alone, as CONFIG_DM_MSG_PARAMS_CHECK
+ *              has it by default
+ *
+ * Params of 64 bytes to a maximum are used, each way is repeated for about EXAMPLE_RUN_MS and
+ * nanoseconds per envelope are printed. Text written by the writer must be that of printf.
+ *
+ * usage: linkkit-example-envelope [max_len]
+ *     max_len      largest params, sizes double from 64 bytes up to it, 16384 by default
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "iotx_dm_internal.h"
+
+#define EXAMPLE_MIN_LEN         64
+#define EXAMPLE_MSGID           12345
+#define EXAMPLE_METHOD          "thing.event.property.post"
+#define EXAMPLE_RUN_MS          200
+
+static const char g_request_fmt[] = "{\"id\":\"%d\",\"version\":\"%s\",\"params\":%.*s,\"method\":\"%s\"}";
+
+typedef struct {
+    char       *params;
+    int         params_len;
+    char        text[CONFIG_DM_MSG_STACK_PAYLOAD_LEN];  /* head of last envelope written */
+    int         text_len;
+} example_post_t;
+
+/* envelope of @post written in one way, its length or -1 */
+typedef int (*example_write_t)(example_post_t *post);
+
+static void example_keep(example_post_t *post, const char *payload, int payload_len)
+{
+    int len = (payload_len < sizeof(post->text) - 1) ? payload_len : sizeof(post->text) - 1;
+
+    memcpy(post->text, payload, len);
+    post->text[len] = '\0';
+    post->text_len = payload_len;
+}
+
+static int example_printf(example_post_t *post)
+{
+    lite_cjson_t lite;
+    char *payload = NULL;
+    int payload_len = strlen(g_request_fmt) + 10 + strlen(DM_MSG_VERSION) + post->params_len +
+                      strlen(EXAMPLE_METHOD) + 1;
+
+    payload = HAL_Malloc(payload_len);
+    if (payload == NULL) {
+        return -1;
+    }
+    memset(payload, 0, payload_len);
+    HAL_Snprintf(payload, payload_len, g_request_fmt, EXAMPLE_MSGID, DM_MSG_VERSION, post->params_len, post->params,
+                 EXAMPLE_METHOD);
+
+    memset(&lite, 0, sizeof(lite_cjson_t));
+    if (lite_cjson_parse(payload, payload_len, &lite) < SUCCESS_RETURN) {
+        HAL_Free(payload);
+        return -1;
+    }
+    payload_len = strlen(payload);
+    example_keep(post, payload, payload_len);
+    HAL_Free(payload);
+
+    return payload_len;
+}
+
+static int example_writer_write(example_post_t *post, char *buffer, int size, int *payload_len)
+{
+    lite_cjson_writer_t writer;
+
+    lite_cjson_writer_init(&writer, buffer, size);
+    lite_cjson_writer_object_begin(&writer);
+    lite_cjson_writer_key(&writer, DM_MSG_KEY_ID, strlen(DM_MSG_KEY_ID));
+    lite_cjson_writer_int_string(&writer, EXAMPLE_MSGID);
+    lite_cjson_writer_key(&writer, DM_MSG_KEY_VERSION, strlen(DM_MSG_KEY_VERSION));
+    lite_cjson_writer_string(&writer, DM_MSG_VERSION, strlen(DM_MSG_VERSION));
+    lite_cjson_writer_key(&writer, DM_MSG_KEY_PARAMS, strlen(DM_MSG_KEY_PARAMS));
+    lite_cjson_writer_raw(&writer, post->params, post->params_len);
+    lite_cjson_writer_key(&writer, DM_MSG_KEY_METHOD, strlen(DM_MSG_KEY_METHOD));
+    lite_cjson_writer_string(&writer, EXAMPLE_METHOD, strlen(EXAMPLE_METHOD));
+    lite_cjson_writer_object_end(&writer);
+
+    *payload_len = writer.len;
+    return lite_cjson_writer_end(&writer);
+}
+
+static int example_writer(example_post_t *post)
+{
+    char payload_stack[CONFIG_DM_MSG_STACK_PAYLOAD_LEN];
+    char *payload = payload_stack;
+    int payload_len = 0, res;
+
+    res = example_writer_write(post, payload_stack, sizeof(payload_stack), &payload_len);
+    if (res == -2) {
+        payload = HAL_Malloc(payload_len + 1);
+        if (payload == NULL) {
+            return -1;
+        }
+        res = example_writer_write(post, payload, payload_len + 1, &payload_len);
+    }
+    if (res == 0) {
+        example_keep(post, payload, payload_len);
+    }
+    if (payload != payload_stack) {
+        HAL_Free(payload);
+    }
+
+    return (res == 0) ? payload_len : -1;
+}
+
+static int example_checked(example_post_t *post)
+{
+    lite_cjson_t lite;
+
+    memset(&lite, 0, sizeof(lite_cjson_t));
+    if (lite_cjson_parse(post->params, post->params_len, &lite) != SUCCESS_RETURN) {
+        return -1;
+    }
+    return example_writer(post);
+}
+
+/* params of a property post of about @len bytes */
+static int example_post_create(example_post_t *post, int len)
+{
+    int pos, prop;
+
+    memset(post, 0, sizeof(example_post_t));
+    post->params = HAL_Malloc(len + EXAMPLE_MIN_LEN);
+    if (post->params == NULL) {
+        return -1;
+    }
+
+    pos = HAL_Snprintf(post->params, len + EXAMPLE_MIN_LEN, "{\"Name\":\"light \\\"kitchen\\\"\"");
+    for (prop = 0; pos + 1 < len; prop++) {
+        pos += HAL_Snprintf(post->params + pos, len + EXAMPLE_MIN_LEN - pos, ",\"Prop%d\":%d", prop, prop % 1000);
+    }
+    pos += HAL_Snprintf(post->params + pos, len + EXAMPLE_MIN_LEN - pos, "}");
+    post->params_len = pos;
+
+    return 0;
+}
+
+/* nanoseconds per envelope written by @write, -1 if one fails */
+static double example_time(example_post_t *post, example_write_t write, int *payload_len)
+{
+    uint64_t start = HAL_UptimeMs(), elapsed;
+    int runs = 0;
+
+    do {
+        *payload_len = write(post);
+        if (*payload_len < 0) {
+            return -1;
+        }
+        runs++;
+        elapsed = HAL_UptimeMs() - start;
+    } while (elapsed < EXAMPLE_RUN_MS);
+
+    return (double)elapsed * 1000000 / runs;
+}
+
+int main(int argc, char *argv[])
+{
+    example_post_t post;
+    char text[CONFIG_DM_MSG_STACK_PAYLOAD_LEN];
+    double printf_ns, writer_ns, checked_ns;
+    int max_len = 16384, len, printf_len, writer_len, checked_len, res = 0;
+
+    if (argc > 1) {
+        max_len = atoi(argv[1]);
+    }
+    if (max_len < EXAMPLE_MIN_LEN) {
+        HAL_Printf("usage: %s [max_len]\n", argv[0]);
+        return -1;
+    }
+
+    for (len = EXAMPLE_MIN_LEN; len <= max_len && res == 0; len *= 2) {
+        res = -1;
+        if (example_post_create(&post, len) != 0) {
+            break;
+        }
+
+        printf_ns = example_time(&post, example_printf, &printf_len);
+        memcpy(text, post.text, sizeof(text));
+        writer_ns = example_time(&post, example_writer, &writer_len);
+        checked_ns = example_time(&post, example_checked, &checked_len);
+        if (printf_ns < 0 || writer_ns < 0 || checked_ns < 0) {
+            HAL_Printf("%5d bytes: write failed\n", post.params_len);
+        } else if (writer_len != printf_len || checked_len != printf_len || strcmp(text, post.text) != 0) {
+            HAL_Printf("%5d bytes: writer text differs from printf\n", post.params_len);
+        } else {
+            HAL_Printf("%5d bytes of params: printf %8.1f ns, writer %8.1f ns, checked %8.1f ns\n", post.params_len,
+                       printf_ns, writer_ns, checked_ns);
+            res = 0;
+        }
+        HAL_Free(post.params);
+    }
+
+    return res;
+}
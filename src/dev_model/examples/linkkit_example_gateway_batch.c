@@ -0,0 +1,305 @@
+/*
+ * Copyright (C) 2015-2018 Alibaba Group Holding Limited
+ */
+
+/*
+ * Brings sub devices of a gateway online against the local stub broker of
+ * src/mqtt/examples/mqtt_example_broker.c, which answers thing.topo.add, combine.login and
+ * combine.batchLogin, and holds back every packet it sends for a configurable latency. The same number of sub devices is brought
+ * up once one by one, with IOT_Linkkit_Connect() and ITM_MSG_LOGIN, and once with
+ * IOT_Linkkit_Connect_Batch(), and the time and publishes taken by each are printed.
+ *
+ * Broker listens on 127.0.0.1:1883, the port an MQTT connection without TLS goes to.
+ *
+ * usage: linkkit-example-gateway-batch [devices] [latency] [refuse]
+ *     devices  sub devices of each run, 100 by default
+ *     latency  milliseconds broker holds back each packet, 20 by default and at least 10
+ *     refuse   login of every refuse-th sub device is refused by broker, 0 (default) refuses none
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cJSON.h"
+#include "infra_types.h"
+#include "infra_defs.h"
+#include "infra_compat.h"
+#include "wrappers_defs.h"
+#include "dev_model_api.h"
+#include "mqtt_example_broker.h"
+
+#define EXAMPLE_BROKER_PORT     1883
+#define EXAMPLE_GATEWAY_PK      "a1example"
+#define EXAMPLE_GATEWAY_DN      "example_gw"
+#define EXAMPLE_SUBDEV_PK       "a1examplesub"
+#define EXAMPLE_DEVICE_SECRET   "examplesubdevicesecret0123456789"
+#define EXAMPLE_TOPIC_MAXLEN    128
+#define EXAMPLE_LATENCY_MIN_MS  10
+
+void HAL_Printf(const char *fmt, ...);
+int HAL_Snprintf(char *str, const int len, const char *fmt, ...);
+void HAL_SleepMs(uint32_t ms);
+uint64_t HAL_UptimeMs(void);
+void *HAL_Malloc(uint32_t size);
+void HAL_Free(void *ptr);
+int HAL_ThreadCreate(void **thread_handle, void *(*work_routine)(void *), void *arg,
+                     hal_os_thread_param_t *hal_os_thread_param, int *stack_used);
+void HAL_ThreadDetach(void *thread_handle);
+
+static example_broker_t *g_broker = NULL;
+static int               g_running = 0;
+static int               g_latency_ms = 20;
+static int               g_refuse = 0;
+static int               g_batch_ok = 0;
+static int               g_batch_failed = 0;
+
+/* sub devices are named "sub<index>", a refused one has index which is a multiple of g_refuse */
+static int example_refused(cJSON *device)
+{
+    cJSON *device_name = cJSON_GetObjectItem(device, "deviceName");
+
+    if (g_refuse <= 0 || !cJSON_IsString(device_name) || strncmp(device_name->valuestring, "sub", 3) != 0) {
+        return 0;
+    }
+    return (atoi(device_name->valuestring + 3) % g_refuse) == 0;
+}
+
+/* productKey and deviceName of each device of @list, refused ones left out when @login */
+static cJSON *example_device_list(cJSON *list, int login)
+{
+    cJSON *data = cJSON_CreateArray(), *device = NULL, *item = NULL;
+    int index = 0;
+
+    for (index = 0; index < cJSON_GetArraySize(list); index++) {
+        device = cJSON_GetArrayItem(list, index);
+        if (login && example_refused(device)) {
+            continue;
+        }
+        item = cJSON_CreateObject();
+        cJSON_AddItemToObject(item, "productKey", cJSON_Duplicate(cJSON_GetObjectItem(device, "productKey"), 1));
+        cJSON_AddItemToObject(item, "deviceName", cJSON_Duplicate(cJSON_GetObjectItem(device, "deviceName"), 1));
+        cJSON_AddItemToArray(data, item);
+    }
+
+    return data;
+}
+
+static void example_broker_cb(example_broker_t *broker, int conn, const char *topic, int topic_len,
+                              const char *payload, int payload_len, void *ctx)
+{
+    char topic_str[EXAMPLE_TOPIC_MAXLEN];
+    char *text = NULL;
+    cJSON *request = NULL, *reply = NULL, *params = NULL, *data = NULL;
+    int code = 200;
+
+    if (topic_len + (int)strlen("_reply") >= EXAMPLE_TOPIC_MAXLEN) {
+        return;
+    }
+    memcpy(topic_str, topic, topic_len);
+    topic_str[topic_len] = '\0';
+
+    text = HAL_Malloc(payload_len + 1);
+    if (text == NULL) {
+        return;
+    }
+    memcpy(text, payload, payload_len);
+    text[payload_len] = '\0';
+    request = cJSON_Parse(text);
+    HAL_Free(text);
+    if (request == NULL) {
+        return;
+    }
+    params = cJSON_GetObjectItem(request, "params");
+
+    /* only the requests of bringing sub devices online get a reply */
+    if (strstr(topic_str, "/thing/topo/add") != NULL) {
+        data = example_device_list(params, 0);
+    } else if (strstr(topic_str, "/combine/batch_login") != NULL) {
+        data = example_device_list(cJSON_GetObjectItem(params, "deviceList"), 1);
+    } else if (strstr(topic_str, "/combine/login") != NULL) {
+        code = example_refused(params) ? 520 : 200;
+        data = cJSON_Duplicate(params, 1);
+    } else {
+        cJSON_Delete(request);
+        return;
+    }
+
+    reply = cJSON_CreateObject();
+    cJSON_AddItemToObject(reply, "id", cJSON_Duplicate(cJSON_GetObjectItem(request, "id"), 1));
+    cJSON_AddNumberToObject(reply, "code", code);
+    cJSON_AddItemToObject(reply, "data", data);
+    cJSON_Delete(request);
+
+    text = cJSON_PrintUnformatted(reply);
+    cJSON_Delete(reply);
+    if (text == NULL) {
+        return;
+    }
+    strcat(topic_str, "_reply");
+    example_broker_publish(broker, conn, topic_str, text, strlen(text));
+    cJSON_free(text);
+}
+
+static void *example_yield_thread(void *arg)
+{
+    while (g_running) {
+        IOT_Linkkit_Yield(10);
+    }
+
+    return NULL;
+}
+
+static void example_batch_cb(int devid, int result, void *user_data)
+{
+    if (result == 0) {
+        g_batch_ok++;
+    } else {
+        g_batch_failed++;
+    }
+}
+
+static int example_open_subdevs(int *devids, int first, int num)
+{
+    iotx_linkkit_dev_meta_info_t meta_info;
+    int index = 0;
+
+    for (index = 0; index < num; index++) {
+        memset(&meta_info, 0, sizeof(meta_info));
+        HAL_Snprintf(meta_info.product_key, sizeof(meta_info.product_key), "%s", EXAMPLE_SUBDEV_PK);
+        HAL_Snprintf(meta_info.device_name, sizeof(meta_info.device_name), "sub%d", first + index);
+        HAL_Snprintf(meta_info.device_secret, sizeof(meta_info.device_secret), "%s", EXAMPLE_DEVICE_SECRET);
+        devids[index] = IOT_Linkkit_Open(IOTX_LINKKIT_DEV_TYPE_SLAVE, &meta_info);
+        if (devids[index] < 0) {
+            HAL_Printf("IOT_Linkkit_Open of sub%d failed\n", first + index);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/* sub devices among "sub<first>" .. "sub<first + num - 1>" which broker refuses */
+static int example_refused_num(int first, int num)
+{
+    int index = 0, refused = 0;
+
+    for (index = first; g_refuse > 0 && index < first + num; index++) {
+        if (index % g_refuse == 0) {
+            refused++;
+        }
+    }
+
+    return refused;
+}
+
+static void example_report(const char *name, int ok, int failed, uint64_t elapsed, uint32_t publishes)
+{
+    HAL_Printf("%-7s: %4d online, %4d failed in %6d ms, %5u publishes\n", name, ok, failed, (int)elapsed,
+               publishes);
+}
+
+int main(int argc, char *argv[])
+{
+    iotx_linkkit_dev_meta_info_t master_meta_info;
+    example_broker_stats_t stats;
+    void *thread = NULL;
+    int *devids = NULL;
+    int devices = 100, master_devid = -1, index = 0, ok = 0, failed = 0, res = -1;
+    int dynamic_register = 0;
+    uint32_t publishes = 0;
+    uint64_t start = 0;
+
+    if (argc > 1) {
+        devices = atoi(argv[1]);
+    }
+    if (argc > 2) {
+        g_latency_ms = atoi(argv[2]);
+    }
+    if (argc > 3) {
+        g_refuse = atoi(argv[3]);
+    }
+    if (devices <= 0) {
+        devices = 100;
+    }
+    /* a SUBACK quicker than this can come before a sync subscribe starts waiting for it */
+    if (g_latency_ms < EXAMPLE_LATENCY_MIN_MS) {
+        g_latency_ms = EXAMPLE_LATENCY_MIN_MS;
+    }
+
+    devids = HAL_Malloc(sizeof(int) * devices);
+    g_broker = example_broker_start(EXAMPLE_BROKER_PORT, example_broker_cb, NULL);
+    if (devids == NULL || g_broker == NULL) {
+        HAL_Printf("start broker on port %d failed\n", EXAMPLE_BROKER_PORT);
+        return -1;
+    }
+    if (example_broker_set_latency(g_broker, g_latency_ms) != 0) {
+        goto out;
+    }
+
+    memset(&master_meta_info, 0, sizeof(master_meta_info));
+    HAL_Snprintf(master_meta_info.product_key, sizeof(master_meta_info.product_key), "%s", EXAMPLE_GATEWAY_PK);
+    HAL_Snprintf(master_meta_info.device_name, sizeof(master_meta_info.device_name), "%s", EXAMPLE_GATEWAY_DN);
+    HAL_Snprintf(master_meta_info.device_secret, sizeof(master_meta_info.device_secret), "%s", EXAMPLE_DEVICE_SECRET);
+    master_devid = IOT_Linkkit_Open(IOTX_LINKKIT_DEV_TYPE_MASTER, &master_meta_info);
+    if (master_devid < 0) {
+        HAL_Printf("IOT_Linkkit_Open failed\n");
+        goto out;
+    }
+
+    IOT_Ioctl(IOTX_IOCTL_SET_MQTT_DOMAIN, (void *)"127.0.0.1");
+    IOT_Ioctl(IOTX_IOCTL_SET_DYNAMIC_REGISTER, (void *)&dynamic_register);
+    if (IOT_Linkkit_Connect(master_devid) < 0) {
+        HAL_Printf("IOT_Linkkit_Connect failed\n");
+        goto out;
+    }
+    g_running = 1;
+    if (HAL_ThreadCreate(&thread, example_yield_thread, NULL, NULL, NULL) != 0) {
+        goto out;
+    }
+    HAL_ThreadDetach(thread);
+
+    /* one by one, each sub device waits for reply of topo add and then of login */
+    if (example_open_subdevs(devids, 0, devices) != 0) {
+        goto out;
+    }
+    example_broker_stats(g_broker, &stats);
+    publishes = stats.publishes;
+    start = HAL_UptimeMs();
+    for (index = 0; index < devices; index++) {
+        if (IOT_Linkkit_Connect(devids[index]) >= 0 && IOT_Linkkit_Report(devids[index], ITM_MSG_LOGIN, NULL, 0) >= 0) {
+            ok++;
+        } else {
+            failed++;
+        }
+    }
+    example_broker_stats(g_broker, &stats);
+    example_report("serial", ok, failed, HAL_UptimeMs() - start, stats.publishes - publishes);
+    if (failed != example_refused_num(0, devices)) {
+        goto out;
+    }
+
+    /* other sub devices, so that none of them is in topo already */
+    if (example_open_subdevs(devids, devices, devices) != 0) {
+        goto out;
+    }
+    example_broker_stats(g_broker, &stats);
+    publishes = stats.publishes;
+    start = HAL_UptimeMs();
+    IOT_Linkkit_Connect_Batch(devids, devices, example_batch_cb, NULL);
+    example_broker_stats(g_broker, &stats);
+    example_report("batch", g_batch_ok, g_batch_failed, HAL_UptimeMs() - start, stats.publishes - publishes);
+
+    res = (g_batch_ok + g_batch_failed == devices && g_batch_failed == example_refused_num(devices, devices)) ? 0 : -1;
+
+out:
+    g_running = 0;
+    HAL_SleepMs(100);
+    if (master_devid >= 0) {
+        IOT_Linkkit_Close(master_devid);
+    }
+    example_broker_stop(g_broker);
+    HAL_Free(devids);
+
+    return res;
+}
@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2015-2018 Alibaba Group Holding Limited
+ */
+
+/*
+ * Throughput of the dm_ipc queue between the threads producing device model events and the one
+ * dispatching them: producer threads each insert a run of messages allocated the way
+ * dm_msg_event_new() does, while the main thread takes them with dm_ipc_msg_next() and frees
+ * them, checking that every producer's messages come out in order. An insert into a full queue
+ * is retried after sched_yield().
+ *
+ * To compare against the locked list the ring replaced, build with -DDM_IPC_RING_DISABLED added
+ * to CONFIG_ENV_CFLAGS of the board config.
+ *
+ * usage: linkkit-example-ipc [messages] [producers] [queue_len]
+ *     messages     messages of all producers together, 1000000 by default
+ *     producers    producer threads, 1 by default
+ *     queue_len    max length of queue, CONFIG_DISPATCH_QUEUE_MAXLEN by default
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+
+#include "iotx_dm_internal.h"
+
+#define EXAMPLE_PRODUCERS_MAX   16
+#define EXAMPLE_TIMEOUT_MS      60000
+
+void HAL_ThreadDetach(void *thread_handle);
+
+typedef struct {
+    int         producer;
+    int         count;
+    int         full;           /* inserts refused by a full queue */
+} example_producer_t;
+
+static void *example_producer(void *arg)
+{
+    example_producer_t *producer = (example_producer_t *)arg;
+    dm_ipc_msg_t *msg = NULL;
+    int seq;
+
+    for (seq = 0; seq < producer->count; seq++) {
+        msg = HAL_Malloc(sizeof(dm_ipc_msg_t));
+        if (msg == NULL) {
+            break;
+        }
+        memset(msg, 0, sizeof(dm_ipc_msg_t));
+        msg->type = IOTX_DM_EVENT_PROPERTY_SET;
+        msg->event.devid = producer->producer;
+        msg->event.data.reply.id = seq;
+        while (dm_ipc_msg_insert(msg) != SUCCESS_RETURN) {
+            producer->full++;
+            sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
+int main(int argc, char *argv[])
+{
+    example_producer_t producers[EXAMPLE_PRODUCERS_MAX];
+    int next_seq[EXAMPLE_PRODUCERS_MAX];
+    int messages = 1000000, producer_num = 1, queue_len = CONFIG_DISPATCH_QUEUE_MAXLEN;
+    int idx, received = 0, empty = 0, reordered = 0, full = 0;
+    dm_ipc_msg_t *msg = NULL;
+    void *thread = NULL, *data = NULL;
+    uint64_t start, elapsed;
+
+    if (argc > 1) {
+        messages = atoi(argv[1]);
+    }
+    if (argc > 2) {
+        producer_num = atoi(argv[2]);
+    }
+    if (argc > 3) {
+        queue_len = atoi(argv[3]);
+    }
+    if (messages <= 0 || producer_num <= 0 || producer_num > EXAMPLE_PRODUCERS_MAX || queue_len <= 0) {
+        HAL_Printf("usage: %s [messages] [producers] [queue_len]\n", argv[0]);
+        return -1;
+    }
+    messages = messages / producer_num * producer_num;
+
+    /* a full queue is expected here, keep its warning out of the timing */
+    IOT_SetLogLevel(IOT_LOG_NONE);
+    if (dm_ipc_init(queue_len) != SUCCESS_RETURN) {
+        HAL_Printf("dm_ipc_init failed\n");
+        return -1;
+    }
+
+    start = HAL_UptimeMs();
+    for (idx = 0; idx < producer_num; idx++) {
+        producers[idx].producer = idx;
+        producers[idx].count = messages / producer_num;
+        producers[idx].full = 0;
+        next_seq[idx] = 0;
+        if (HAL_ThreadCreate(&thread, example_producer, &producers[idx], NULL, NULL) != 0) {
+            HAL_Printf("create producer failed\n");
+            return -1;
+        }
+        HAL_ThreadDetach(thread);
+    }
+
+    while (received < messages) {
+        data = NULL;
+        if (dm_ipc_msg_next(&data) != SUCCESS_RETURN) {
+            empty++;
+            if (empty % 1024 == 0 && HAL_UptimeMs() - start > EXAMPLE_TIMEOUT_MS) {
+                break;
+            }
+            sched_yield();
+            continue;
+        }
+        msg = (dm_ipc_msg_t *)data;
+        if (msg->event.data.reply.id != next_seq[msg->event.devid]) {
+            reordered++;
+        }
+        next_seq[msg->event.devid] = msg->event.data.reply.id + 1;
+        HAL_Free(msg);
+        received++;
+    }
+    elapsed = HAL_UptimeMs() - start;
+
+    for (idx = 0; idx < producer_num; idx++) {
+        full += producers[idx].full;
+    }
+    HAL_Printf("%s, %d producer(s), queue of %d: %7d msgs in %5d ms, %8d msgs/s, %d out of order, "
+               "queue found full %d times, empty %d times\n",
+#ifdef DM_IPC_RING_ENABLED
+               "ring",
+#else
+               "list",
+#endif
+               producer_num, queue_len, received, (int)elapsed,
+               (int)((uint64_t)received * 1000 / (elapsed ? elapsed : 1)), reordered, full, empty);
+
+    dm_ipc_deinit();
+
+    return (received == messages && reordered == 0) ? 0 : -1;
+}
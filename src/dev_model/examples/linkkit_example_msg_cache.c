@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2015-2018 Alibaba Group Holding Limited
+ */
+
+/*
+ * Cost of the device model message cache, which keeps every request waiting for its reply:
+ * with a number of messages pending, the main thread times
+ *
+ *   search     dm_msg_cache_search() of a pending msgid, as a reply arriving does
+ *   reply      dm_msg_cache_remove() of a pending msgid picked at random, replies coming back
+ *              out of order, followed by dm_msg_cache_insert() of a new request
+ *   tick       dm_msg_cache_tick() with no message due, as every IOT_Linkkit_Yield() does
+ *
+ * Each is repeated for about EXAMPLE_RUN_MS, nanoseconds per operation are printed. Pending
+ * messages are bounded by CONFIG_MSGCACHE_QUEUE_MAXLEN, 50 by default, build with
+ * -DCONFIG_MSGCACHE_QUEUE_MAXLEN=20000 added to CONFIG_ENV_CFLAGS of the board config for more.
+ *
+ * usage: linkkit-example-msg-cache [pending]
+ *     pending      messages kept pending, CONFIG_MSGCACHE_QUEUE_MAXLEN by default
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "iotx_dm_internal.h"
+
+#define EXAMPLE_RUN_MS          200
+#define EXAMPLE_BATCH           1024
+
+/* msgids now pending, in no particular order */
+static int *g_pending = NULL;
+static int  g_pending_num = 0;
+static int  g_next_msgid = 1;
+
+static int example_fill(int pending)
+{
+    int idx;
+
+    for (idx = 0; idx < pending; idx++) {
+        if (dm_msg_cache_insert(g_next_msgid, 0, IOTX_DM_EVENT_EVENT_PROPERTY_POST_REPLY, NULL) != SUCCESS_RETURN) {
+            return -1;
+        }
+        g_pending[idx] = g_next_msgid++;
+    }
+    g_pending_num = pending;
+
+    return 0;
+}
+
+static int example_search(void)
+{
+    dm_msg_cache_node_t *node = NULL;
+    int msgid = g_pending[rand() % g_pending_num];
+
+    if (dm_msg_cache_search(msgid, &node) != SUCCESS_RETURN || node->msgid != msgid) {
+        return -1;
+    }
+    return 0;
+}
+
+static int example_reply(void)
+{
+    int idx = rand() % g_pending_num;
+
+    if (dm_msg_cache_remove(g_pending[idx]) != SUCCESS_RETURN ||
+        dm_msg_cache_insert(g_next_msgid, 0, IOTX_DM_EVENT_EVENT_PROPERTY_POST_REPLY, NULL) != SUCCESS_RETURN) {
+        return -1;
+    }
+    g_pending[idx] = g_next_msgid++;
+    return 0;
+}
+
+static int example_tick(void)
+{
+    dm_msg_cache_tick();
+    return 0;
+}
+
+/* nothing was due so every pending msgid is found, while the first ones replied to are gone */
+static int example_check(void)
+{
+    dm_msg_cache_node_t *node = NULL;
+    int idx, msgid, found;
+
+    for (idx = 0; idx < g_pending_num; idx++) {
+        node = NULL;
+        if (dm_msg_cache_search(g_pending[idx], &node) != SUCCESS_RETURN) {
+            HAL_Printf("pending msgid %d lost\n", g_pending[idx]);
+            return -1;
+        }
+    }
+    for (msgid = 1; msgid < g_next_msgid && msgid <= EXAMPLE_BATCH; msgid++) {
+        for (idx = 0, found = 0; idx < g_pending_num && !found; idx++) {
+            found = (g_pending[idx] == msgid);
+        }
+        node = NULL;
+        if (!found && dm_msg_cache_search(msgid, &node) == SUCCESS_RETURN) {
+            HAL_Printf("msgid %d replied to still cached\n", msgid);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/* nanoseconds per call of @op, -1 if it fails */
+static double example_time(const char *name, int (*op)(void))
+{
+    uint64_t start = HAL_UptimeMs(), elapsed;
+    int idx, runs = 0;
+
+    do {
+        for (idx = 0; idx < EXAMPLE_BATCH; idx++) {
+            if (op() != 0) {
+                HAL_Printf("%s failed\n", name);
+                return -1;
+            }
+        }
+        runs += EXAMPLE_BATCH;
+        elapsed = HAL_UptimeMs() - start;
+    } while (elapsed < EXAMPLE_RUN_MS);
+
+    return (double)elapsed * 1000000 / runs;
+}
+
+int main(int argc, char *argv[])
+{
+    double search_ns, reply_ns, tick_ns;
+    int pending = CONFIG_MSGCACHE_QUEUE_MAXLEN, res = -1;
+
+    if (argc > 1) {
+        pending = atoi(argv[1]);
+    }
+    if (pending <= 0 || pending > CONFIG_MSGCACHE_QUEUE_MAXLEN) {
+        HAL_Printf("usage: %s [pending], at most %d pending\n", argv[0], CONFIG_MSGCACHE_QUEUE_MAXLEN);
+        return -1;
+    }
+
+    g_pending = HAL_Malloc(sizeof(int) * pending);
+    if (g_pending == NULL || dm_msg_cache_init() != SUCCESS_RETURN) {
+        goto out;
+    }
+    srand(1);
+    if (example_fill(pending) != 0) {
+        HAL_Printf("insert failed\n");
+        goto out;
+    }
+
+    search_ns = example_time("search", example_search);
+    reply_ns = example_time("reply", example_reply);
+    tick_ns = example_time("tick", example_tick);
+    if (search_ns < 0 || reply_ns < 0 || tick_ns < 0) {
+        goto out;
+    }
+
+    if (example_check() != 0) {
+        goto out;
+    }
+
+    HAL_Printf("%6d pending: search %8.1f ns, reply %8.1f ns, tick %8.1f ns\n", pending, search_ns, reply_ns, tick_ns);
+    res = 0;
+
+out:
+    dm_msg_cache_deinit();
+    if (g_pending != NULL) {
+        HAL_Free(g_pending);
+    }
+
+    return res;
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2015-2018 Alibaba Group Holding Limited
+ */
+
+/*
+ * Messages and bytes a sensor puts on the link when posting its properties at a high rate,
+ * against the local stub broker of src/mqtt/examples/mqtt_example_broker.c. The same load is
+ * posted once with every IOT_Linkkit_Report() sent on its own, once merged within
+ * IOTX_IOCTL_SET_PROP_REPORT_WINDOW, and once merged with IOTX_IOCTL_SET_PROP_REPORT_DELTA
+ * leaving out unchanged values.
+ *
+ * The load is 4 properties posted together at 50 Hz: a switch and a mode which never change,
+ * a temperature which changes on every 10th post and a humidity on every 250th.
+ *
+ * Broker listens on 127.0.0.1:1883, the port an MQTT connection without TLS goes to.
+ *
+ * usage: linkkit-example-prop-report [seconds] [window]
+ *     seconds  posting time of each run, 10 by default
+ *     window   merge window in milliseconds, 1000 by default
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "infra_types.h"
+#include "infra_defs.h"
+#include "infra_compat.h"
+#include "dev_model_api.h"
+#include "mqtt_example_broker.h"
+
+#define EXAMPLE_BROKER_PORT     1883
+#define EXAMPLE_PRODUCT_KEY     "a1example"
+#define EXAMPLE_DEVICE_NAME     "example_sensor"
+#define EXAMPLE_DEVICE_SECRET   "examplesensordevicesecret0123456"
+#define EXAMPLE_POST_PERIOD_MS  20
+#define EXAMPLE_LATENCY_MS      10
+
+void HAL_Printf(const char *fmt, ...);
+int HAL_Snprintf(char *str, const int len, const char *fmt, ...);
+uint64_t HAL_UptimeMs(void);
+
+static void example_run(example_broker_t *broker, int devid, const char *name, int window_ms, int delta,
+                        int seconds)
+{
+    example_broker_stats_t before, after;
+    char payload[128];
+    uint64_t start, elapsed, publishes, bytes;
+    int posts = seconds * 1000 / EXAMPLE_POST_PERIOD_MS, post, len;
+
+    IOT_Ioctl(IOTX_IOCTL_SET_PROP_REPORT_WINDOW, (void *)&window_ms);
+    IOT_Ioctl(IOTX_IOCTL_SET_PROP_REPORT_DELTA, (void *)&delta);
+
+    example_broker_stats(broker, &before);
+    start = HAL_UptimeMs();
+    for (post = 0; post < posts; post++) {
+        len = HAL_Snprintf(payload, sizeof(payload), "{\"PowerSwitch\":1,\"WorkMode\":\"auto\","
+                           "\"CurrentTemperature\":%d.%d,\"CurrentHumidity\":%d}",
+                           20 + post / 10 % 10, post / 10 % 10, 40 + post / 250 % 20);
+        IOT_Linkkit_Report(devid, ITM_MSG_POST_PROPERTY, (unsigned char *)payload, len);
+        IOT_Linkkit_Yield(EXAMPLE_POST_PERIOD_MS);
+    }
+    elapsed = HAL_UptimeMs() - start;
+
+    /* let the last window pass, its values are sent after the run */
+    start = HAL_UptimeMs();
+    while (HAL_UptimeMs() - start < window_ms + 200) {
+        IOT_Linkkit_Yield(EXAMPLE_POST_PERIOD_MS);
+    }
+    example_broker_stats(broker, &after);
+
+    publishes = after.publishes - before.publishes;
+    bytes = after.bytes - before.bytes;
+    elapsed = elapsed ? elapsed : 1;
+    HAL_Printf("%-14s: %5d posts, %5d publishes, %3d.%02d msg/s, %6d byte/s\n", name, posts, (int)publishes,
+               (int)(publishes * 1000 / elapsed), (int)(publishes * 100000 / elapsed % 100),
+               (int)(bytes * 1000 / elapsed));
+}
+
+int main(int argc, char *argv[])
+{
+    iotx_linkkit_dev_meta_info_t meta_info;
+    example_broker_t *broker = NULL;
+    int seconds = 10, window_ms = 1000, devid = -1, dynamic_register = 0, res = -1;
+
+    if (argc > 1) {
+        seconds = atoi(argv[1]);
+    }
+    if (argc > 2) {
+        window_ms = atoi(argv[2]);
+    }
+    if (seconds <= 0) {
+        seconds = 10;
+    }
+    if (window_ms <= 0) {
+        window_ms = 1000;
+    }
+
+    broker = example_broker_start(EXAMPLE_BROKER_PORT, NULL, NULL);
+    if (broker == NULL) {
+        HAL_Printf("start broker on port %d failed\n", EXAMPLE_BROKER_PORT);
+        return -1;
+    }
+    /* a SUBACK quicker than this can come before a sync subscribe starts waiting for it */
+    if (example_broker_set_latency(broker, EXAMPLE_LATENCY_MS) != 0) {
+        goto out;
+    }
+
+    memset(&meta_info, 0, sizeof(meta_info));
+    HAL_Snprintf(meta_info.product_key, sizeof(meta_info.product_key), "%s", EXAMPLE_PRODUCT_KEY);
+    HAL_Snprintf(meta_info.device_name, sizeof(meta_info.device_name), "%s", EXAMPLE_DEVICE_NAME);
+    HAL_Snprintf(meta_info.device_secret, sizeof(meta_info.device_secret), "%s", EXAMPLE_DEVICE_SECRET);
+    devid = IOT_Linkkit_Open(IOTX_LINKKIT_DEV_TYPE_MASTER, &meta_info);
+    if (devid < 0) {
+        HAL_Printf("IOT_Linkkit_Open failed\n");
+        goto out;
+    }
+
+    IOT_Ioctl(IOTX_IOCTL_SET_MQTT_DOMAIN, (void *)"127.0.0.1");
+    IOT_Ioctl(IOTX_IOCTL_SET_DYNAMIC_REGISTER, (void *)&dynamic_register);
+    if (IOT_Linkkit_Connect(devid) < 0) {
+        HAL_Printf("IOT_Linkkit_Connect failed\n");
+        goto out;
+    }
+
+    example_run(broker, devid, "each post", 0, 0, seconds);
+    example_run(broker, devid, "window", window_ms, 0, seconds);
+    example_run(broker, devid, "window + delta", window_ms, 1, seconds);
+    res = 0;
+
+out:
+    if (devid >= 0) {
+        IOT_Linkkit_Close(devid);
+    }
+    example_broker_stop(broker);
+
+    return res;
+}
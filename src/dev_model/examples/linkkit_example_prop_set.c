@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2015-2018 Alibaba Group Holding Limited
+ */
+
+/*
+ * Round trips of property set through a solo device, against the local stub broker of
+ * src/mqtt/examples/mqtt_example_broker.c: broker sends thing.service.property.set, the
+ * ITE_PROPERTY_SET callback posts the same properties back with IOT_Linkkit_Report(), and for
+ * every post broker answers post_reply and sends the next property set, keeping a fixed number
+ * of them in flight.
+ *
+ * Each round trip takes the inbound path from topic lookup to the typed event handed to
+ * the callback, and the upstream path of a property post, which goes out on the topic kept
+ * by the device node. Besides the rate, CPU time of the yielding thread is printed per
+ * round trip, as the rate is bound by the latency broker holds every packet back for. With
+ * FEATURE_INFRA_LOG_NETWORK_PAYLOAD=y, the default of make.settings, printing each payload
+ * takes most of that time, set it to n for the cost of the round trip itself.
+ *
+ * Broker listens on 127.0.0.1:1883, the port an MQTT connection without TLS goes to.
+ *
+ * usage: linkkit-example-prop-set [sets] [inflight]
+ *     sets      property sets sent by broker, 20000 by default
+ *     inflight  property sets in flight at once, 32 by default, CONFIG_DISPATCH_QUEUE_MAXLEN
+ *               bounds the events one yield can queue
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+
+#include "infra_types.h"
+#include "infra_defs.h"
+#include "infra_compat.h"
+#include "dev_model_api.h"
+#include "mqtt_example_broker.h"
+
+#define EXAMPLE_BROKER_PORT     1883
+#define EXAMPLE_TOPIC_MAXLEN    128
+#define EXAMPLE_PAYLOAD_MAXLEN  256
+#define EXAMPLE_LATENCY_MS      10
+#define EXAMPLE_TIMEOUT_MS      120000
+
+void HAL_Printf(const char *fmt, ...);
+int HAL_Snprintf(char *str, const int len, const char *fmt, ...);
+uint64_t HAL_UptimeMs(void);
+int HAL_GetProductKey(char product_key[IOTX_PRODUCT_KEY_LEN + 1]);
+int HAL_GetDeviceName(char device_name[IOTX_DEVICE_NAME_LEN + 1]);
+int HAL_GetDeviceSecret(char device_secret[IOTX_DEVICE_SECRET_LEN + 1]);
+
+static int g_sets = 20000;
+static int g_inflight = 32;
+static int g_sent = 0;          /* touched by connection thread of broker only */
+static int g_received = 0;
+static char g_set_topic[EXAMPLE_TOPIC_MAXLEN];
+static char g_post_topic[EXAMPLE_TOPIC_MAXLEN];
+static char g_post_reply_topic[EXAMPLE_TOPIC_MAXLEN];
+
+/* user and system CPU time of calling thread so far, in us */
+static uint64_t example_cpu_us(void)
+{
+    struct rusage usage;
+
+    memset(&usage, 0, sizeof(usage));
+    getrusage(RUSAGE_THREAD, &usage);
+    return (uint64_t)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000 +
+           usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+}
+
+static void example_send_set(example_broker_t *broker, int conn)
+{
+    char payload[EXAMPLE_PAYLOAD_MAXLEN];
+    int len;
+
+    len = HAL_Snprintf(payload, sizeof(payload), "{\"id\":\"%d\",\"version\":\"1.0\",\"params\":{\"LightSwitch\":%d,"
+                       "\"Brightness\":%d},\"method\":\"thing.service.property.set\"}", g_sent + 1, g_sent % 2,
+                       g_sent % 100);
+    if (example_broker_publish(broker, conn, g_set_topic, payload, len) == 0) {
+        g_sent++;
+    }
+}
+
+/* answer every property post, and keep @g_inflight property sets going */
+static void example_broker_cb(example_broker_t *broker, int conn, const char *topic, int topic_len,
+                              const char *payload, int payload_len, void *ctx)
+{
+    char text[EXAMPLE_PAYLOAD_MAXLEN], reply[EXAMPLE_PAYLOAD_MAXLEN];
+    char *id = NULL, *end = NULL;
+    int first = (g_sent == 0), len;
+
+    if (topic_len != (int)strlen(g_post_topic) || memcmp(topic, g_post_topic, topic_len) != 0 ||
+        payload_len >= EXAMPLE_PAYLOAD_MAXLEN) {
+        return;
+    }
+    memcpy(text, payload, payload_len);
+    text[payload_len] = '\0';
+
+    id = strstr(text, "\"id\":\"");
+    if (id != NULL) {
+        id += strlen("\"id\":\"");
+        end = strchr(id, '"');
+    }
+    if (end != NULL) {
+        *end = '\0';
+        len = HAL_Snprintf(reply, sizeof(reply), "{\"id\":\"%s\",\"code\":200,\"data\":{}}", id);
+        example_broker_publish(broker, conn, g_post_reply_topic, reply, len);
+    }
+
+    /* the post made before timing starts opens the window, every later one is answered by one set */
+    do {
+        if (g_sent >= g_sets) {
+            break;
+        }
+        example_send_set(broker, conn);
+    } while (first && g_sent < g_inflight);
+}
+
+static int example_property_set_cb(const int devid, const char *request, const int request_len)
+{
+    g_received++;
+    IOT_Linkkit_Report(devid, ITM_MSG_POST_PROPERTY, (unsigned char *)request, request_len);
+
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    iotx_linkkit_dev_meta_info_t meta_info;
+    example_broker_t *broker = NULL;
+    int devid = -1, dynamic_register = 0, res = -1;
+    uint64_t start, elapsed, cpu_us;
+
+    if (argc > 1) {
+        g_sets = atoi(argv[1]);
+    }
+    if (argc > 2) {
+        g_inflight = atoi(argv[2]);
+    }
+    if (g_sets <= 0 || g_inflight <= 0) {
+        HAL_Printf("usage: %s [sets] [inflight]\n", argv[0]);
+        return -1;
+    }
+
+    broker = example_broker_start(EXAMPLE_BROKER_PORT, example_broker_cb, NULL);
+    if (broker == NULL) {
+        HAL_Printf("start broker on port %d failed\n", EXAMPLE_BROKER_PORT);
+        return -1;
+    }
+    /* a SUBACK quicker than this can come before a sync subscribe starts waiting for it */
+    if (example_broker_set_latency(broker, EXAMPLE_LATENCY_MS) != 0) {
+        goto out;
+    }
+
+    IOT_RegisterCallback(ITE_PROPERTY_SET, example_property_set_cb);
+
+    /* master device goes online with the identity HAL gives, topics are built from it too */
+    memset(&meta_info, 0, sizeof(meta_info));
+    HAL_GetProductKey(meta_info.product_key);
+    HAL_GetDeviceName(meta_info.device_name);
+    HAL_GetDeviceSecret(meta_info.device_secret);
+    HAL_Snprintf(g_set_topic, sizeof(g_set_topic), "/sys/%s/%s/thing/service/property/set", meta_info.product_key,
+                 meta_info.device_name);
+    HAL_Snprintf(g_post_topic, sizeof(g_post_topic), "/sys/%s/%s/thing/event/property/post", meta_info.product_key,
+                 meta_info.device_name);
+    HAL_Snprintf(g_post_reply_topic, sizeof(g_post_reply_topic), "%s_reply", g_post_topic);
+    devid = IOT_Linkkit_Open(IOTX_LINKKIT_DEV_TYPE_MASTER, &meta_info);
+    if (devid < 0) {
+        HAL_Printf("IOT_Linkkit_Open failed\n");
+        goto out;
+    }
+
+    IOT_Ioctl(IOTX_IOCTL_SET_MQTT_DOMAIN, (void *)"127.0.0.1");
+    IOT_Ioctl(IOTX_IOCTL_SET_DYNAMIC_REGISTER, (void *)&dynamic_register);
+    if (IOT_Linkkit_Connect(devid) < 0) {
+        HAL_Printf("IOT_Linkkit_Connect failed\n");
+        goto out;
+    }
+
+    cpu_us = example_cpu_us();
+    start = HAL_UptimeMs();
+    IOT_Linkkit_Report(devid, ITM_MSG_POST_PROPERTY, (unsigned char *)"{\"LightSwitch\":0}",
+                       strlen("{\"LightSwitch\":0}"));
+    while (g_received < g_sets && HAL_UptimeMs() - start < EXAMPLE_TIMEOUT_MS) {
+        IOT_Linkkit_Yield(10);
+    }
+    elapsed = HAL_UptimeMs() - start;
+    cpu_us = example_cpu_us() - cpu_us;
+
+    HAL_Printf("%6d of %d property sets in %6d ms, %d in flight: %6d sets/s, %6.1f us CPU of yield thread each\n",
+               g_received, g_sets, (int)elapsed, g_inflight, (int)((uint64_t)g_received * 1000 / (elapsed ? elapsed : 1)),
+               g_received ? (double)cpu_us / g_received : 0.0);
+    res = (g_received == g_sets) ? 0 : -1;
+
+out:
+    if (devid >= 0) {
+        IOT_Linkkit_Close(devid);
+    }
+    example_broker_stop(broker);
+
+    return res;
+}
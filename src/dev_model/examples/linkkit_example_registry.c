@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2015-2018 Alibaba Group Holding Limited
+ */
+
+/*
+ * Cost of finding a sub device of a gateway against the number of sub devices opened, no
+ * connection is made. IOT_Linkkit_Open() of a sub device looks it up by product key and
+ * device name before creating it, opening one which is open already is refused by that
+ * lookup alone, and IOT_Linkkit_Close() looks it up by devid: the same lookups each
+ * upstream and downstream message of a sub device goes through.
+ *
+ * usage: linkkit-example-registry [devices] [lookups]
+ *     devices  most sub devices opened at once, 2000 by default
+ *     lookups  repeated opens timed at each number of sub devices, 200000 by default
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "infra_types.h"
+#include "infra_defs.h"
+#include "infra_compat.h"
+#include "dev_model_api.h"
+
+#define EXAMPLE_GATEWAY_PK      "a1example"
+#define EXAMPLE_GATEWAY_DN      "example_gw"
+#define EXAMPLE_SUBDEV_PK_NUM   4
+#define EXAMPLE_DEVICE_SECRET   "examplesubdevicesecret0123456789"
+#define EXAMPLE_OPS_MIN         20000   /* opens and closes timed at each number of sub devices */
+#define EXAMPLE_STRIDE          7919    /* prime, so that stepping by it visits every sub device */
+
+void HAL_Printf(const char *fmt, ...);
+int HAL_Snprintf(char *str, const int len, const char *fmt, ...);
+uint64_t HAL_UptimeMs(void);
+void *HAL_Malloc(uint32_t size);
+void HAL_Free(void *ptr);
+
+static const int g_counts[] = {1, 10, 100, 500, 1000, 2000, 5000, 10000};
+
+/* sub devices spread over a few products, as behind a real gateway */
+static int example_open(int index)
+{
+    iotx_linkkit_dev_meta_info_t meta_info;
+
+    memset(&meta_info, 0, sizeof(meta_info));
+    HAL_Snprintf(meta_info.product_key, sizeof(meta_info.product_key), "a1ProdKey%02d", index % EXAMPLE_SUBDEV_PK_NUM);
+    HAL_Snprintf(meta_info.device_name, sizeof(meta_info.device_name), "sub_device_%05d", index);
+    HAL_Snprintf(meta_info.device_secret, sizeof(meta_info.device_secret), "%s", EXAMPLE_DEVICE_SECRET);
+
+    return IOT_Linkkit_Open(IOTX_LINKKIT_DEV_TYPE_SLAVE, &meta_info);
+}
+
+static int example_ns(uint64_t elapsed_ms, int ops)
+{
+    return (int)(elapsed_ms * 1000000 / (ops > 0 ? ops : 1));
+}
+
+static int example_run(int *devids, int devices, int lookups)
+{
+    uint64_t start, open_ms = 0, reopen_ms = 0, close_ms = 0;
+    int rounds = (EXAMPLE_OPS_MIN + devices - 1) / devices;
+    int round, index, res = 0;
+    long lookup;
+
+    for (round = 0; round < rounds && res == 0; round++) {
+        start = HAL_UptimeMs();
+        for (index = 0; index < devices; index++) {
+            devids[index] = example_open(index);
+            if (devids[index] < 0) {
+                HAL_Printf("IOT_Linkkit_Open of sub device %d failed\n", index);
+                devices = index;
+                res = -1;
+                break;
+            }
+        }
+        open_ms += HAL_UptimeMs() - start;
+
+        if (round == 0 && res == 0) {
+            start = HAL_UptimeMs();
+            for (lookup = 0; lookup < lookups; lookup++) {
+                if (example_open((int)(lookup * EXAMPLE_STRIDE % devices)) >= 0) {
+                    HAL_Printf("sub device opened twice\n");
+                    res = -1;
+                    break;
+                }
+            }
+            reopen_ms = HAL_UptimeMs() - start;
+        }
+
+        /* in scattered order, closing in the order of opening would always find the first one */
+        start = HAL_UptimeMs();
+        for (index = 0; index < devices; index++) {
+            IOT_Linkkit_Close(devids[(long)index * EXAMPLE_STRIDE % devices]);
+        }
+        close_ms += HAL_UptimeMs() - start;
+    }
+
+    if (res == 0) {
+        HAL_Printf("%6d sub devices: open %6d ns, open again %6d ns, close %6d ns\n", devices,
+                   example_ns(open_ms, rounds * devices), example_ns(reopen_ms, lookups),
+                   example_ns(close_ms, rounds * devices));
+    }
+
+    return res;
+}
+
+int main(int argc, char *argv[])
+{
+    iotx_linkkit_dev_meta_info_t master_meta_info;
+    int *devids = NULL;
+    int devices = 2000, lookups = 200000, master_devid = -1, index, res = -1;
+
+    if (argc > 1) {
+        devices = atoi(argv[1]);
+    }
+    if (argc > 2) {
+        lookups = atoi(argv[2]);
+    }
+    if (devices <= 0) {
+        devices = 2000;
+    }
+    if (lookups <= 0) {
+        lookups = 200000;
+    }
+
+    memset(&master_meta_info, 0, sizeof(master_meta_info));
+    HAL_Snprintf(master_meta_info.product_key, sizeof(master_meta_info.product_key), "%s", EXAMPLE_GATEWAY_PK);
+    HAL_Snprintf(master_meta_info.device_name, sizeof(master_meta_info.device_name), "%s", EXAMPLE_GATEWAY_DN);
+    HAL_Snprintf(master_meta_info.device_secret, sizeof(master_meta_info.device_secret), "%s", EXAMPLE_DEVICE_SECRET);
+    master_devid = IOT_Linkkit_Open(IOTX_LINKKIT_DEV_TYPE_MASTER, &master_meta_info);
+    devids = HAL_Malloc(sizeof(int) * devices);
+    if (master_devid < 0 || devids == NULL) {
+        HAL_Printf("IOT_Linkkit_Open failed\n");
+        goto out;
+    }
+
+    res = 0;
+    for (index = 0; index < (int)(sizeof(g_counts) / sizeof(g_counts[0])) && res == 0; index++) {
+        if (g_counts[index] <= devices) {
+            res = example_run(devids, g_counts[index], lookups);
+        }
+    }
+
+out:
+    if (master_devid >= 0) {
+        IOT_Linkkit_Close(master_devid);
+    }
+    if (devids != NULL) {
+        HAL_Free(devids);
+    }
+
+    return res;
+}
@@ -0,0 +1,237 @@
+/*
+ * Copyright (C) 2015-2018 Alibaba Group Holding Limited
+ */
+
+/*
+ * Brings sub devices of a gateway online with IOT_Linkkit_Request_Async() from one thread
+ * against the local stub broker of src/mqtt/examples/mqtt_example_broker.c, which answers
+ * thing.topo.add and combine.login, and holds back every packet it sends for a configurable
+ * latency. Each sub device sends its topo add, then its login from the callback of topo add,
+ * and a new sub device is started as one comes online, so that a number of them are in flight
+ * at once.
+ *
+ * Besides time taken, the longest IOT_Linkkit_Yield() is printed: a login completes once the
+ * SUBACKs of the sub device are in, waiting for them within a yield would hold up every other
+ * request in flight.
+ *
+ * Broker listens on 127.0.0.1:1883, the port an MQTT connection without TLS goes to.
+ *
+ * usage: linkkit-example-request-async [devices] [inflight] [latency]
+ *     devices   sub devices brought online, 100 by default
+ *     inflight  sub devices in flight at once, 20 by default, topo add fails at once with more
+ *               than about a third of CONFIG_MSGCACHE_QUEUE_MAXLEN, as each holds up to three replies
+ *     latency   milliseconds broker holds back each packet, 20 by default and at least 10
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cJSON.h"
+#include "infra_types.h"
+#include "infra_defs.h"
+#include "infra_compat.h"
+#include "dev_model_api.h"
+#include "mqtt_example_broker.h"
+
+#define EXAMPLE_BROKER_PORT     1883
+#define EXAMPLE_GATEWAY_PK      "a1example"
+#define EXAMPLE_GATEWAY_DN      "example_gw"
+#define EXAMPLE_SUBDEV_PK       "a1examplesub"
+#define EXAMPLE_DEVICE_SECRET   "examplesubdevicesecret0123456789"
+#define EXAMPLE_TOPIC_MAXLEN    128
+#define EXAMPLE_LATENCY_MIN_MS  10
+#define EXAMPLE_TIMEOUT_MS      60000
+
+void HAL_Printf(const char *fmt, ...);
+int HAL_Snprintf(char *str, const int len, const char *fmt, ...);
+uint64_t HAL_UptimeMs(void);
+void *HAL_Malloc(uint32_t size);
+void HAL_Free(void *ptr);
+
+static int *g_devids = NULL;
+static int  g_devices = 100;
+static int  g_started = 0;
+static int  g_online = 0;
+static int  g_failed = 0;
+
+/*
+ * answer every request with its params, a request left unanswered, such as the deviceinfo update
+ * sent along a login, holds its place in the message cache of SDK until it times out
+ */
+static void example_broker_cb(example_broker_t *broker, int conn, const char *topic, int topic_len,
+                              const char *payload, int payload_len, void *ctx)
+{
+    char topic_str[EXAMPLE_TOPIC_MAXLEN];
+    char *text = NULL;
+    cJSON *request = NULL, *reply = NULL;
+
+    if (topic_len + (int)strlen("_reply") >= EXAMPLE_TOPIC_MAXLEN) {
+        return;
+    }
+    memcpy(topic_str, topic, topic_len);
+    topic_str[topic_len] = '\0';
+    if (topic_len >= (int)strlen("_reply") && strcmp(topic_str + topic_len - strlen("_reply"), "_reply") == 0) {
+        return;
+    }
+
+    text = HAL_Malloc(payload_len + 1);
+    if (text == NULL) {
+        return;
+    }
+    memcpy(text, payload, payload_len);
+    text[payload_len] = '\0';
+    request = cJSON_Parse(text);
+    HAL_Free(text);
+    if (request == NULL) {
+        return;
+    }
+    if (cJSON_GetObjectItem(request, "id") == NULL || cJSON_GetObjectItem(request, "method") == NULL) {
+        cJSON_Delete(request);
+        return;
+    }
+
+    reply = cJSON_CreateObject();
+    cJSON_AddItemToObject(reply, "id", cJSON_Duplicate(cJSON_GetObjectItem(request, "id"), 1));
+    cJSON_AddNumberToObject(reply, "code", 200);
+    cJSON_AddItemToObject(reply, "data", cJSON_Duplicate(cJSON_GetObjectItem(request, "params"), 1));
+    cJSON_Delete(request);
+
+    text = cJSON_PrintUnformatted(reply);
+    cJSON_Delete(reply);
+    if (text == NULL) {
+        return;
+    }
+    strcat(topic_str, "_reply");
+    example_broker_publish(broker, conn, topic_str, text, strlen(text));
+    cJSON_free(text);
+}
+
+static void example_request_cb(int devid, int request_id, int result, void *user_data);
+
+/* start next sub device, moving on to the one after it if topo add can not be sent */
+static void example_start_next(void)
+{
+    while (g_started < g_devices) {
+        if (IOT_Linkkit_Request_Async(g_devids[g_started++], IOTX_LINKKIT_REQUEST_TOPO_ADD, example_request_cb,
+                                      (void *)IOTX_LINKKIT_REQUEST_TOPO_ADD) >= 0) {
+            return;
+        }
+        g_failed++;
+    }
+}
+
+static void example_request_cb(int devid, int request_id, int result, void *user_data)
+{
+    if (result == 0 && (long)user_data == IOTX_LINKKIT_REQUEST_TOPO_ADD) {
+        if (IOT_Linkkit_Request_Async(devid, IOTX_LINKKIT_REQUEST_LOGIN, example_request_cb,
+                                      (void *)IOTX_LINKKIT_REQUEST_LOGIN) >= 0) {
+            return;
+        }
+        result = -1;
+    }
+
+    if (result == 0) {
+        g_online++;
+    } else {
+        g_failed++;
+    }
+    example_start_next();
+}
+
+int main(int argc, char *argv[])
+{
+    iotx_linkkit_dev_meta_info_t meta_info;
+    example_broker_t *broker = NULL;
+    int inflight = 20, latency_ms = 20, master_devid = -1, dynamic_register = 0, index, res = -1;
+    uint64_t start, yield_start, yield_ms, yield_max_ms = 0;
+
+    if (argc > 1) {
+        g_devices = atoi(argv[1]);
+    }
+    if (argc > 2) {
+        inflight = atoi(argv[2]);
+    }
+    if (argc > 3) {
+        latency_ms = atoi(argv[3]);
+    }
+    if (g_devices <= 0) {
+        g_devices = 100;
+    }
+    if (inflight <= 0 || inflight > g_devices) {
+        inflight = g_devices < 20 ? g_devices : 20;
+    }
+    /* a SUBACK quicker than this can come before a sync subscribe of master device starts waiting for it */
+    if (latency_ms < EXAMPLE_LATENCY_MIN_MS) {
+        latency_ms = EXAMPLE_LATENCY_MIN_MS;
+    }
+
+    g_devids = HAL_Malloc(sizeof(int) * g_devices);
+    broker = example_broker_start(EXAMPLE_BROKER_PORT, example_broker_cb, NULL);
+    if (g_devids == NULL || broker == NULL) {
+        HAL_Printf("start broker on port %d failed\n", EXAMPLE_BROKER_PORT);
+        goto out;
+    }
+    if (example_broker_set_latency(broker, latency_ms) != 0) {
+        goto out;
+    }
+
+    memset(&meta_info, 0, sizeof(meta_info));
+    HAL_Snprintf(meta_info.product_key, sizeof(meta_info.product_key), "%s", EXAMPLE_GATEWAY_PK);
+    HAL_Snprintf(meta_info.device_name, sizeof(meta_info.device_name), "%s", EXAMPLE_GATEWAY_DN);
+    HAL_Snprintf(meta_info.device_secret, sizeof(meta_info.device_secret), "%s", EXAMPLE_DEVICE_SECRET);
+    master_devid = IOT_Linkkit_Open(IOTX_LINKKIT_DEV_TYPE_MASTER, &meta_info);
+    if (master_devid < 0) {
+        HAL_Printf("IOT_Linkkit_Open failed\n");
+        goto out;
+    }
+
+    IOT_Ioctl(IOTX_IOCTL_SET_MQTT_DOMAIN, (void *)"127.0.0.1");
+    IOT_Ioctl(IOTX_IOCTL_SET_DYNAMIC_REGISTER, (void *)&dynamic_register);
+    if (IOT_Linkkit_Connect(master_devid) < 0) {
+        HAL_Printf("IOT_Linkkit_Connect failed\n");
+        goto out;
+    }
+
+    for (index = 0; index < g_devices; index++) {
+        memset(&meta_info, 0, sizeof(meta_info));
+        HAL_Snprintf(meta_info.product_key, sizeof(meta_info.product_key), "%s", EXAMPLE_SUBDEV_PK);
+        HAL_Snprintf(meta_info.device_name, sizeof(meta_info.device_name), "sub%d", index);
+        HAL_Snprintf(meta_info.device_secret, sizeof(meta_info.device_secret), "%s", EXAMPLE_DEVICE_SECRET);
+        g_devids[index] = IOT_Linkkit_Open(IOTX_LINKKIT_DEV_TYPE_SLAVE, &meta_info);
+        if (g_devids[index] < 0) {
+            HAL_Printf("IOT_Linkkit_Open of sub%d failed\n", index);
+            goto out;
+        }
+    }
+
+    start = HAL_UptimeMs();
+    for (index = 0; index < inflight; index++) {
+        example_start_next();
+    }
+    while (g_online + g_failed < g_devices && HAL_UptimeMs() - start < EXAMPLE_TIMEOUT_MS) {
+        yield_start = HAL_UptimeMs();
+        IOT_Linkkit_Yield(10);
+        yield_ms = HAL_UptimeMs() - yield_start;
+        if (yield_ms > yield_max_ms) {
+            yield_max_ms = yield_ms;
+        }
+    }
+
+    HAL_Printf("%4d online, %4d failed in %6d ms, %d in flight, longest yield %5d ms\n", g_online, g_failed,
+               (int)(HAL_UptimeMs() - start), inflight, (int)yield_max_ms);
+    res = (g_online == g_devices) ? 0 : -1;
+
+out:
+    if (master_devid >= 0) {
+        IOT_Linkkit_Close(master_devid);
+    }
+    if (broker != NULL) {
+        example_broker_stop(broker);
+    }
+    if (g_devids != NULL) {
+        HAL_Free(g_devids);
+    }
+
+    return res;
+}
@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2015-2018 Alibaba Group Holding Limited
+ */
+
+/*
+ * Cost of setting and getting a property of the TSL shadow by its key, as property set and
+ * post of the deprecated linkkit API do. Models of 8 properties up to a maximum are created
+ * with dm_shw_create(), each made of int properties, a struct "Settings" and an array "History",
+ * and their keys are set and got in turn:
+ *
+ *   Prop<n>            every int property
+ *   Settings.Level     member of struct
+ *   History[3]         element of array
+ *
+ * Each value got back must be the one set, and a key not in the model must be refused.
+ * Setting and getting are each repeated for about EXAMPLE_RUN_MS, nanoseconds per key are
+ * printed.
+ *
+ * The shadow is part of the deprecated linkkit API only, so this is built with
+ * FEATURE_DEPRECATED_LINKKIT=y, which needs FEATURE_INFRA_JSON_PARSER=y too, in make.settings.
+ *
+ * usage: linkkit-example-shadow [max_properties]
+ *     max_properties   properties of the largest model, doubling from 8 up to it, 512 by default
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "iotx_dm_internal.h"
+
+#define EXAMPLE_MIN_PROPERTIES  8
+#define EXAMPLE_KEY_MAXLEN      24
+#define EXAMPLE_RUN_MS          200
+
+typedef struct {
+    char               *tsl;
+    dm_shw_t           *shadow;
+    char              (*keys)[EXAMPLE_KEY_MAXLEN];
+    int                 keys_num;
+} example_model_t;
+
+static const char *g_tsl_head = "{\"schema\":\"https://iotx-tsl.oss-ap-southeast-1.aliyuncs.com/schema.json\","
+                                "\"profile\":{\"productKey\":\"a1example\"},\"services\":[],\"events\":[],"
+                                "\"properties\":[{\"identifier\":\"Settings\",\"name\":\"Settings\",\"accessMode\":\"rw\","
+                                "\"dataType\":{\"type\":\"struct\",\"specs\":["
+                                "{\"identifier\":\"Mode\",\"name\":\"Mode\",\"dataType\":{\"type\":\"int\",\"specs\":{}}},"
+                                "{\"identifier\":\"Level\",\"name\":\"Level\",\"dataType\":{\"type\":\"int\",\"specs\":{}}}]}},"
+                                "{\"identifier\":\"History\",\"name\":\"History\",\"accessMode\":\"rw\","
+                                "\"dataType\":{\"type\":\"array\",\"specs\":{\"size\":\"8\",\"item\":{\"type\":\"int\"}}}}";
+static const char *g_tsl_property = ",{\"identifier\":\"Prop%d\",\"name\":\"Prop%d\",\"accessMode\":\"rw\","
+                                    "\"dataType\":{\"type\":\"int\",\"specs\":{\"min\":\"0\",\"max\":\"99999\",\"step\":\"1\"}}}";
+
+/* model of @properties int properties besides struct and array, and keys of all of them */
+static int example_model_create(example_model_t *model, int properties)
+{
+    int len = strlen(g_tsl_head) + (strlen(g_tsl_property) + 16) * properties + 8, pos, idx;
+
+    memset(model, 0, sizeof(example_model_t));
+    model->tsl = HAL_Malloc(len);
+    model->keys = HAL_Malloc(sizeof(model->keys[0]) * (properties + 2));
+    if (model->tsl == NULL || model->keys == NULL) {
+        return -1;
+    }
+
+    pos = HAL_Snprintf(model->tsl, len, "%s", g_tsl_head);
+    for (idx = 0; idx < properties; idx++) {
+        pos += HAL_Snprintf(model->tsl + pos, len - pos, g_tsl_property, idx, idx);
+        HAL_Snprintf(model->keys[idx], EXAMPLE_KEY_MAXLEN, "Prop%d", idx);
+    }
+    pos += HAL_Snprintf(model->tsl + pos, len - pos, "]}");
+    HAL_Snprintf(model->keys[idx++], EXAMPLE_KEY_MAXLEN, "Settings.Level");
+    HAL_Snprintf(model->keys[idx++], EXAMPLE_KEY_MAXLEN, "History[3]");
+    model->keys_num = idx;
+
+    if (dm_shw_create(IOTX_DM_TSL_TYPE_ALINK, model->tsl, pos, &model->shadow) != SUCCESS_RETURN) {
+        return -1;
+    }
+
+    return 0;
+}
+
+static void example_model_destroy(example_model_t *model)
+{
+    if (model->shadow != NULL) {
+        dm_shw_destroy(&model->shadow);
+    }
+    if (model->tsl != NULL) {
+        HAL_Free(model->tsl);
+    }
+    if (model->keys != NULL) {
+        HAL_Free(model->keys);
+    }
+    memset(model, 0, sizeof(example_model_t));
+}
+
+/* every key set to a value of its own reads back, and a key not in model is refused */
+static int example_model_check(example_model_t *model)
+{
+    char *missing = "Missing";
+    int idx, value;
+
+    for (idx = 0; idx < model->keys_num; idx++) {
+        value = idx + 1;
+        if (dm_shw_set_property_value(model->shadow, model->keys[idx], strlen(model->keys[idx]), &value,
+                                      0) != SUCCESS_RETURN) {
+            HAL_Printf("set %s failed\n", model->keys[idx]);
+            return -1;
+        }
+    }
+    for (idx = 0; idx < model->keys_num; idx++) {
+        value = 0;
+        if (dm_shw_get_property_value(model->shadow, model->keys[idx], strlen(model->keys[idx]),
+                                      &value) != SUCCESS_RETURN || value != idx + 1) {
+            HAL_Printf("get %s failed\n", model->keys[idx]);
+            return -1;
+        }
+    }
+    value = 0;
+    if (dm_shw_set_property_value(model->shadow, missing, strlen(missing), &value, 0) == SUCCESS_RETURN) {
+        HAL_Printf("set %s not refused\n", missing);
+        return -1;
+    }
+
+    return 0;
+}
+
+/* nanoseconds per key set, or got if @get, -1 if one fails */
+static double example_time(example_model_t *model, int get)
+{
+    uint64_t start = HAL_UptimeMs(), elapsed;
+    int idx, runs = 0, value = 1, res;
+
+    do {
+        for (idx = 0; idx < model->keys_num; idx++) {
+            if (get) {
+                res = dm_shw_get_property_value(model->shadow, model->keys[idx], strlen(model->keys[idx]), &value);
+            } else {
+                res = dm_shw_set_property_value(model->shadow, model->keys[idx], strlen(model->keys[idx]), &value, 0);
+            }
+            if (res != SUCCESS_RETURN) {
+                return -1;
+            }
+        }
+        runs += model->keys_num;
+        elapsed = HAL_UptimeMs() - start;
+    } while (elapsed < EXAMPLE_RUN_MS);
+
+    return (double)elapsed * 1000000 / runs;
+}
+
+int main(int argc, char *argv[])
+{
+    example_model_t model;
+    double set_ns, get_ns;
+    int max_properties = 512, properties, res = 0;
+
+    if (argc > 1) {
+        max_properties = atoi(argv[1]);
+    }
+    if (max_properties < EXAMPLE_MIN_PROPERTIES) {
+        HAL_Printf("usage: %s [max_properties]\n", argv[0]);
+        return -1;
+    }
+
+    for (properties = EXAMPLE_MIN_PROPERTIES; properties <= max_properties && res == 0; properties *= 2) {
+        res = -1;
+        if (example_model_create(&model, properties) != 0) {
+            HAL_Printf("create model of %d properties failed\n", properties);
+        } else if (example_model_check(&model) == 0) {
+            set_ns = example_time(&model, 0);
+            get_ns = example_time(&model, 1);
+            if (set_ns >= 0 && get_ns >= 0) {
+                HAL_Printf("%4d properties: set %8.1f ns, get %8.1f ns per key\n", properties + 2, set_ns, get_ns);
+                res = 0;
+            }
+        }
+        example_model_destroy(&model);
+    }
+
+    return res;
+}
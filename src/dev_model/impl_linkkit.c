@@ -52,6 +52,15 @@ typedef struct {
     int msgid;
     void *semaphore;
     int code;
+#ifdef DEVICE_MODEL_GATEWAY
+    /* request of IOT_Linkkit_Request_Async(), which has callback instead of semaphore */
+    int devid;
+    iotx_linkkit_request_type_t type;
+    iotx_linkkit_request_cb_t callback;
+    void *user_data;
+    uint64_t deadline;
+    int subscribing;            /* logged in, waiting for SUBACKs until deadline */
+#endif
     struct list_head linked_list;
 } iotx_linkkit_upstream_sync_callback_node_t;
 
@@ -86,22 +95,6 @@ static void _iotx_linkkit_mutex_unlock(void)
     }
 }
 
-static int _impl_copy(_IN_ void *input, _IN_ int input_len, _OU_ void **output, _IN_ int output_len)
-{
-    if (input == NULL || output == NULL || *output != NULL) {
-        return DM_INVALID_PARAMETER;
-    }
-
-    *output = IMPL_LINKKIT_MALLOC(output_len);
-    if (*output == NULL) {
-        return DM_MEMORY_NOT_ENOUGH;
-    }
-    memset(*output, 0, output_len);
-    memcpy(*output, input, input_len);
-
-    return SUCCESS_RETURN;
-}
-
 #ifdef DEVICE_MODEL_GATEWAY
 static void _iotx_linkkit_upstream_mutex_lock(void)
 {
@@ -160,7 +153,9 @@ static int _iotx_linkkit_upstream_sync_callback_list_remove(int msgid)
                         iotx_linkkit_upstream_sync_callback_node_t) {
         if (search_node->msgid == msgid) {
             dm_log_debug("Message Found: %d, Delete It", msgid);
-            HAL_SemaphoreDestroy(search_node->semaphore);
+            if (search_node->semaphore) {
+                HAL_SemaphoreDestroy(search_node->semaphore);
+            }
             list_del(&search_node->linked_list);
             IMPL_LINKKIT_FREE(search_node);
             return SUCCESS_RETURN;
@@ -201,22 +196,163 @@ static void _iotx_linkkit_upstream_sync_callback_list_destroy(void)
     list_for_each_entry_safe(search_node, next_node, &ctx->upstream_sync_callback_list, linked_list,
                              iotx_linkkit_upstream_sync_callback_node_t) {
         list_del(&search_node->linked_list);
-        HAL_SemaphoreDestroy(search_node->semaphore);
+        if (search_node->semaphore) {
+            HAL_SemaphoreDestroy(search_node->semaphore);
+        }
         IMPL_LINKKIT_FREE(search_node);
     }
 }
 
 
-static void _iotx_linkkit_upstream_callback_remove(int msgid, int code)
+/* start waiting for reply of upstream message @msgid, collected by _iotx_linkkit_upstream_sync_result() */
+static int _iotx_linkkit_upstream_sync_track(int msgid)
+{
+    int res = 0;
+    void *semaphore = NULL;
+    iotx_linkkit_upstream_sync_callback_node_t *node = NULL;
+
+    semaphore = HAL_SemaphoreCreate();
+    if (semaphore == NULL) {
+        return FAIL_RETURN;
+    }
+
+    _iotx_linkkit_upstream_mutex_lock();
+    res = _iotx_linkkit_upstream_sync_callback_list_insert(msgid, semaphore, &node);
+    if (res != SUCCESS_RETURN) {
+        HAL_SemaphoreDestroy(semaphore);
+    }
+    _iotx_linkkit_upstream_mutex_unlock();
+
+    return res;
+}
+
+/* wait until @deadline for reply of message tracked by _iotx_linkkit_upstream_sync_track() */
+static int _iotx_linkkit_upstream_sync_result(int msgid, uint64_t deadline)
+{
+    int res = 0, code = FAIL_RETURN;
+    uint64_t now = HAL_UptimeMs();
+    iotx_linkkit_upstream_sync_callback_node_t *node = NULL;
+
+    _iotx_linkkit_upstream_mutex_lock();
+    res = _iotx_linkkit_upstream_sync_callback_list_search(msgid, &node);
+    _iotx_linkkit_upstream_mutex_unlock();
+    if (res != SUCCESS_RETURN) {
+        return FAIL_RETURN;
+    }
+
+    res = HAL_SemaphoreWait(node->semaphore, (deadline > now) ? (uint32_t)(deadline - now) : 0);
+
+    _iotx_linkkit_upstream_mutex_lock();
+    if (res == SUCCESS_RETURN) {
+        code = node->code;
+    }
+    _iotx_linkkit_upstream_sync_callback_list_remove(msgid);
+    _iotx_linkkit_upstream_mutex_unlock();
+
+    return code;
+}
+
+/* wake up thread waiting for reply @msgid, or take request of IOT_Linkkit_Request_Async() out of list and return it */
+static iotx_linkkit_upstream_sync_callback_node_t *_iotx_linkkit_upstream_callback_remove(int msgid, int code)
 {
     int res = 0;
     iotx_linkkit_upstream_sync_callback_node_t *sync_node = NULL;
     res = _iotx_linkkit_upstream_sync_callback_list_search(msgid, &sync_node);
+    if (res == SUCCESS_RETURN && sync_node->semaphore == NULL && sync_node->subscribing) {
+        /* reply is in already */
+        return NULL;
+    }
     if (res == SUCCESS_RETURN) {
         sync_node->code = (code == IOTX_DM_ERR_CODE_SUCCESS) ? (SUCCESS_RETURN) : (FAIL_RETURN);
         dm_log_debug("Sync Message %d Result: %d", msgid, sync_node->code);
+        if (sync_node->semaphore == NULL) {
+            list_del(&sync_node->linked_list);
+            return sync_node;
+        }
         HAL_SemaphorePost(sync_node->semaphore);
     }
+
+    return NULL;
+}
+
+/*
+ * finish request of IOT_Linkkit_Request_Async() taken out of list, called without upstream mutex held,
+ * a login is put back to wait for its SUBACKs, which _iotx_linkkit_upstream_async_expire() collects,
+ * as waiting for them here would hold up dispatch
+ */
+static void _iotx_linkkit_upstream_async_complete(iotx_linkkit_upstream_sync_callback_node_t *node)
+{
+    void *callback = NULL;
+
+    if (node->code == SUCCESS_RETURN && node->type == IOTX_LINKKIT_REQUEST_LOGIN && node->subscribing == 0) {
+        if (iotx_dm_subscribe_async(node->devid) == SUCCESS_RETURN) {
+            node->subscribing = 1;
+            node->deadline = HAL_UptimeMs() + IOTX_LINKKIT_SYNC_DEFAULT_TIMEOUT_MS;
+            _iotx_linkkit_upstream_mutex_lock();
+            list_add_tail(&node->linked_list, &_iotx_linkkit_get_ctx()->upstream_sync_callback_list);
+            _iotx_linkkit_upstream_mutex_unlock();
+            return;
+        }
+        iotx_dm_subscribe_cancel(node->devid);
+        node->code = FAIL_RETURN;
+    }
+
+    if (node->code == SUCCESS_RETURN && node->type == IOTX_LINKKIT_REQUEST_LOGIN) {
+        iotx_dm_send_aos_active(node->devid);
+        callback = iotx_event_callback(ITE_INITIALIZE_COMPLETED);
+        if (callback) {
+            ((int (*)(const int))callback)(node->devid);
+        }
+    }
+
+    if (node->callback) {
+        node->callback(node->devid, node->msgid, node->code, node->user_data);
+    }
+    IMPL_LINKKIT_FREE(node);
+}
+
+/* finish logins whose SUBACKs are in, fail requests of IOT_Linkkit_Request_Async() not done in time */
+static void _iotx_linkkit_upstream_async_expire(void)
+{
+    int res = 0;
+    iotx_linkkit_ctx_t *ctx = _iotx_linkkit_get_ctx();
+    iotx_linkkit_upstream_sync_callback_node_t *node = NULL, *next_node = NULL;
+    struct list_head done;
+    uint64_t now = HAL_UptimeMs();
+
+    INIT_LIST_HEAD(&done);
+
+    _iotx_linkkit_upstream_mutex_lock();
+    list_for_each_entry_safe(node, next_node, &ctx->upstream_sync_callback_list, linked_list,
+                             iotx_linkkit_upstream_sync_callback_node_t) {
+        if (node->semaphore != NULL) {
+            continue;
+        }
+        if (node->subscribing) {
+            res = iotx_dm_subscribe_result(node->devid);
+            if (res > 0 && now < node->deadline) {
+                continue;
+            }
+            if (res > 0) {
+                dm_log_info("Devid %d Sub Timeout", node->devid);
+                iotx_dm_subscribe_cancel(node->devid);
+            }
+            node->code = (res == SUCCESS_RETURN) ? SUCCESS_RETURN : FAIL_RETURN;
+        } else if (now >= node->deadline) {
+            dm_log_info("Async Message %d Timeout", node->msgid);
+            node->code = FAIL_RETURN;
+        } else {
+            continue;
+        }
+        list_del(&node->linked_list);
+        list_add_tail(&node->linked_list, &done);
+    }
+    _iotx_linkkit_upstream_mutex_unlock();
+
+    list_for_each_entry_safe(node, next_node, &done, linked_list, iotx_linkkit_upstream_sync_callback_node_t) {
+        list_del(&node->linked_list);
+        _iotx_linkkit_upstream_async_complete(node);
+    }
 }
 #endif
 
@@ -227,67 +363,16 @@ static void _iotx_linkkit_upstream_callback_remove(int msgid, int code)
     extern void dm_server_free_context(_IN_ void *ctx);
 #endif
 
-static void _iotx_linkkit_event_callback(iotx_dm_event_types_t type, char *payload)
+static void _iotx_linkkit_event_callback(iotx_dm_event_t *event)
 {
     int res = 0;
     void *callback;
-#ifdef LOG_REPORT_TO_CLOUD
-    lite_cjson_t msg_id;
-#endif
-    lite_cjson_t lite, lite_item_id, lite_item_devid, lite_item_serviceid, lite_item_payload, lite_item_ctx;
-    lite_cjson_t lite_item_code, lite_item_eventid, lite_item_utc, lite_item_rrpcid, lite_item_topo;
-    lite_cjson_t lite_item_pk, lite_item_time;
-    lite_cjson_t lite_item_version, lite_item_configid, lite_item_configsize, lite_item_gettype, lite_item_sign,
-                 lite_item_signmethod, lite_item_url;
-
-    dm_log_info("Receive Message Type: %d", type);
-    if (payload) {
-        dm_log_info("Receive Message: %s", payload);
-        res = dm_utils_json_parse(payload, strlen(payload), cJSON_Invalid, &lite);
-        if (res != SUCCESS_RETURN) {
-            return;
-        }
-#ifdef LOG_REPORT_TO_CLOUD
-        dm_utils_json_object_item(&lite, "msgid", 5, cJSON_Invalid, &msg_id);
-#endif
-        dm_utils_json_object_item(&lite, IOTX_LINKKIT_KEY_ID, strlen(IOTX_LINKKIT_KEY_ID), cJSON_Invalid, &lite_item_id);
-        dm_utils_json_object_item(&lite, IOTX_LINKKIT_KEY_DEVID, strlen(IOTX_LINKKIT_KEY_DEVID), cJSON_Invalid,
-                                  &lite_item_devid);
-        dm_utils_json_object_item(&lite, IOTX_LINKKIT_KEY_SERVICEID, strlen(IOTX_LINKKIT_KEY_SERVICEID), cJSON_Invalid,
-                                  &lite_item_serviceid);
-        dm_utils_json_object_item(&lite, IOTX_LINKKIT_KEY_PAYLOAD, strlen(IOTX_LINKKIT_KEY_PAYLOAD), cJSON_Invalid,
-                                  &lite_item_payload);
-        dm_utils_json_object_item(&lite, IOTX_LINKKIT_KEY_CTX, strlen(IOTX_LINKKIT_KEY_CTX), cJSON_Invalid, &lite_item_ctx);
-        dm_utils_json_object_item(&lite, IOTX_LINKKIT_KEY_CODE, strlen(IOTX_LINKKIT_KEY_CODE), cJSON_Invalid, &lite_item_code);
-        dm_utils_json_object_item(&lite, IOTX_LINKKIT_KEY_EVENTID, strlen(IOTX_LINKKIT_KEY_EVENTID), cJSON_Invalid,
-                                  &lite_item_eventid);
-        dm_utils_json_object_item(&lite, IOTX_LINKKIT_KEY_UTC, strlen(IOTX_LINKKIT_KEY_UTC), cJSON_Invalid, &lite_item_utc);
-        dm_utils_json_object_item(&lite, IOTX_LINKKIT_KEY_RRPCID, strlen(IOTX_LINKKIT_KEY_RRPCID), cJSON_Invalid,
-                                  &lite_item_rrpcid);
-        dm_utils_json_object_item(&lite, IOTX_LINKKIT_KEY_TOPO, strlen(IOTX_LINKKIT_KEY_TOPO), cJSON_Invalid,
-                                  &lite_item_topo);
-        dm_utils_json_object_item(&lite, IOTX_LINKKIT_KEY_PRODUCT_KEY, strlen(IOTX_LINKKIT_KEY_PRODUCT_KEY), cJSON_Invalid,
-                                  &lite_item_pk);
-        dm_utils_json_object_item(&lite, IOTX_LINKKIT_KEY_TIME, strlen(IOTX_LINKKIT_KEY_TIME), cJSON_Invalid,
-                                  &lite_item_time);
-        dm_utils_json_object_item(&lite, IOTX_LINKKIT_KEY_VERSION, strlen(IOTX_LINKKIT_KEY_VERSION), cJSON_Invalid,
-                                  &lite_item_version);
-        dm_utils_json_object_item(&lite, IOTX_LINKKIT_KEY_CONFIG_ID, strlen(IOTX_LINKKIT_KEY_CONFIG_ID), cJSON_Invalid,
-                                  &lite_item_configid);
-        dm_utils_json_object_item(&lite, IOTX_LINKKIT_KEY_CONFIG_SIZE, strlen(IOTX_LINKKIT_KEY_CONFIG_SIZE), cJSON_Invalid,
-                                  &lite_item_configsize);
-        dm_utils_json_object_item(&lite, IOTX_LINKKIT_KEY_GET_TYPE, strlen(IOTX_LINKKIT_KEY_GET_TYPE), cJSON_Invalid,
-                                  &lite_item_gettype);
-        dm_utils_json_object_item(&lite, IOTX_LINKKIT_KEY_SIGN, strlen(IOTX_LINKKIT_KEY_SIGN), cJSON_Invalid,
-                                  &lite_item_sign);
-        dm_utils_json_object_item(&lite, IOTX_LINKKIT_KEY_SIGN_METHOD, strlen(IOTX_LINKKIT_KEY_SIGN_METHOD), cJSON_Invalid,
-                                  &lite_item_signmethod);
-        dm_utils_json_object_item(&lite, IOTX_LINKKIT_KEY_URL, strlen(IOTX_LINKKIT_KEY_URL), cJSON_Invalid,
-                                  &lite_item_url);
+    iotx_dm_event_reply_t *reply = &event->data.reply;
+    iotx_dm_event_request_t *request = &event->data.request;
 
-    }
+    dm_log_info("Receive Message Type: %d", event->type);
 
-    switch (type) {
+    switch (event->type) {
         case IOTX_DM_EVENT_CLOUD_CONNECTED: {
             callback = iotx_event_callback(ITE_CONNECT_SUCC);
             if (callback) {
@@ -303,157 +388,85 @@ static void _iotx_linkkit_event_callback(iotx_dm_event_types_t type, char *paylo
         }
         break;
         case IOTX_DM_EVENT_INITIALIZED: {
-            if (payload == NULL || lite_item_devid.type != cJSON_Number) {
-                return;
-            }
-
-            dm_log_debug("Current Devid: %d", lite_item_devid.value_int);
+            dm_log_debug("Current Devid: %d", event->devid);
 
             callback = iotx_event_callback(ITE_INITIALIZE_COMPLETED);
             if (callback) {
-                ((int (*)(const int))callback)(lite_item_devid.value_int);
+                ((int (*)(const int))callback)(event->devid);
             }
         }
         break;
-        case IOTX_DM_EVENT_MODEL_DOWN_RAW: {
-            int raw_data_len = 0;
-            unsigned char *raw_data = NULL;
-
-            if (payload == NULL || lite_item_devid.type != cJSON_Number || lite_item_payload.type != cJSON_String) {
-                return;
-            }
-
-            dm_log_debug("Current Devid: %d", lite_item_devid.value_int);
-            dm_log_debug("Current Raw Data: %.*s", lite_item_payload.value_length, lite_item_payload.value);
-
-            raw_data_len = lite_item_payload.value_length / 2;
-            raw_data = IMPL_LINKKIT_MALLOC(raw_data_len);
-            if (raw_data == NULL) {
-                dm_log_err("No Enough Memory");
-                return;
-            }
-            LITE_hexstr_convert(lite_item_payload.value, lite_item_payload.value_length, raw_data, raw_data_len);
-
-            HEXDUMP_DEBUG(raw_data, raw_data_len);
-            callback = iotx_event_callback(ITE_RAWDATA_ARRIVED);
-            if (callback) {
-                ((int (*)(const int, const unsigned char *, const int))callback)(lite_item_devid.value_int, raw_data, raw_data_len);
-            }
-
-            IMPL_LINKKIT_FREE(raw_data);
-        }
-        break;
+        case IOTX_DM_EVENT_MODEL_DOWN_RAW:
         case IOTX_DM_EVENT_MODEL_UP_RAW_REPLY: {
-            int raw_data_len = 0;
-            unsigned char *raw_data = NULL;
-
-            if (payload == NULL || lite_item_devid.type != cJSON_Number || lite_item_payload.type != cJSON_String) {
+            if (request->payload.value == NULL) {
                 return;
             }
 
-            dm_log_debug("Current Devid: %d", lite_item_devid.value_int);
-            dm_log_debug("Current Raw Data: %.*s", lite_item_payload.value_length, lite_item_payload.value);
-
-            raw_data_len = lite_item_payload.value_length / 2;
-            raw_data = IMPL_LINKKIT_MALLOC(raw_data_len);
-            if (raw_data == NULL) {
-                dm_log_err("No Enough Memory");
-                return;
-            }
-            memset(raw_data, 0, raw_data_len);
-            LITE_hexstr_convert(lite_item_payload.value, lite_item_payload.value_length, raw_data, raw_data_len);
-
-            HEXDUMP_DEBUG(raw_data, raw_data_len);
+            dm_log_debug("Current Devid: %d", event->devid);
+            HEXDUMP_DEBUG(request->payload.value, request->payload.value_length);
 
             callback = iotx_event_callback(ITE_RAWDATA_ARRIVED);
             if (callback) {
-                ((int (*)(const int, const unsigned char *, const int))callback)(lite_item_devid.value_int, raw_data, raw_data_len);
+                ((int (*)(const int, const unsigned char *, const int))callback)(event->devid,
+                        (unsigned char *)request->payload.value, request->payload.value_length);
             }
-
-            IMPL_LINKKIT_FREE(raw_data);
         }
         break;
 #if !defined(DEVICE_MODEL_RAWDATA_SOLO)
         case IOTX_DM_EVENT_THING_SERVICE_REQUEST: {
             int response_len = 0;
-            char *request = NULL, *response = NULL;
-
-            uintptr_t property_get_ctx_num = 0;
-            void *property_get_ctx = NULL;
+            char *response = NULL;
 
-            if (payload == NULL || lite_item_id.type != cJSON_String || lite_item_devid.type != cJSON_Number ||
-                lite_item_serviceid.type != cJSON_String || lite_item_payload.type != cJSON_Object) {
+            if (request->id.value == NULL || request->serviceid.value == NULL || request->payload.value == NULL ||
+                request->payload.value[0] != '{') {
                 return;
             }
 
-            dm_log_debug("Current Id: %.*s", lite_item_id.value_length, lite_item_id.value);
-            dm_log_debug("Current Devid: %d", lite_item_devid.value_int);
-            dm_log_debug("Current ServiceID: %.*s", lite_item_serviceid.value_length, lite_item_serviceid.value);
-            dm_log_debug("Current Payload: %.*s", lite_item_payload.value_length, lite_item_payload.value);
-            dm_log_debug("Current Ctx: %.*s", lite_item_ctx.value_length, lite_item_ctx.value);
-
-            LITE_hexstr_convert(lite_item_ctx.value, lite_item_ctx.value_length, (unsigned char *)&property_get_ctx_num,
-                                sizeof(uintptr_t));
-            property_get_ctx = (void *)property_get_ctx_num;
-
-            request = IMPL_LINKKIT_MALLOC(lite_item_payload.value_length + 1);
-            if (request == NULL) {
-                dm_log_err("Not Enough Memory");
-                return;
-            }
-            memset(request, 0, lite_item_payload.value_length + 1);
-            memcpy(request, lite_item_payload.value, lite_item_payload.value_length);
+            dm_log_debug("Current Id: %s", request->id.value);
+            dm_log_debug("Current Devid: %d", event->devid);
+            dm_log_debug("Current ServiceID: %s", request->serviceid.value);
+            dm_log_debug("Current Payload: %s", request->payload.value);
+            dm_log_debug("Current Ctx: %p", request->ctx);
 
             callback = iotx_event_callback(ITE_SERVICE_REQUEST);
             if (callback) {
                 res = ((int (*)(const int, const char *, const int, const char *, const int, char **,
-                                int *))callback)(lite_item_devid.value_int, lite_item_serviceid.value,
-                                                 lite_item_serviceid.value_length, request, lite_item_payload.value_length, &response, &response_len);
+                                int *))callback)(event->devid, request->serviceid.value, request->serviceid.value_length,
+                                                 request->payload.value, request->payload.value_length, &response, &response_len);
                 if (response != NULL && response_len > 0) {
                     /* service response exist */
                     iotx_dm_error_code_t code = (res == 0) ? (IOTX_DM_ERR_CODE_SUCCESS) : (IOTX_DM_ERR_CODE_REQUEST_ERROR);
-                    iotx_dm_send_service_response(lite_item_devid.value_int, lite_item_id.value, lite_item_id.value_length, code,
-                                                  lite_item_serviceid.value,
-                                                  lite_item_serviceid.value_length,
-                                                  response, response_len, property_get_ctx);
+                    iotx_dm_send_service_response(event->devid, request->id.value, request->id.value_length, code,
+                                                  request->serviceid.value,
+                                                  request->serviceid.value_length,
+                                                  response, response_len, request->ctx);
                     HAL_Free(response);
                 }
             }
 #ifdef ALCS_ENABLED
-            if (property_get_ctx) {
-                dm_server_free_context(property_get_ctx);
+            if (request->ctx) {
+                dm_server_free_context(request->ctx);
             }
 #endif
-            IMPL_LINKKIT_FREE(request);
         }
         break;
         case IOTX_DM_EVENT_PROPERTY_SET: {
-            char *property_payload = NULL;
-
-            if (payload == NULL || lite_item_devid.type != cJSON_Number || lite_item_payload.type != cJSON_Object) {
+            if (request->payload.value == NULL || request->payload.value[0] != '{') {
                 return;
             }
 
-            dm_log_debug("Current Devid: %d", lite_item_devid.value_int);
-            dm_log_debug("Current Payload: %.*s", lite_item_payload.value_length, lite_item_payload.value);
-
-            property_payload = IMPL_LINKKIT_MALLOC(lite_item_payload.value_length + 1);
-            if (property_payload == NULL) {
-                dm_log_err("No Enough Memory");
-                return;
-            }
-            memset(property_payload, 0, lite_item_payload.value_length + 1);
-            memcpy(property_payload, lite_item_payload.value, lite_item_payload.value_length);
+            dm_log_debug("Current Devid: %d", event->devid);
+            dm_log_debug("Current Payload: %s", request->payload.value);
 #ifdef LOG_REPORT_TO_CLOUD
-            if (SUCCESS_RETURN == check_target_msg(msg_id.value, msg_id.value_length)) {
+            if (SUCCESS_RETURN == check_target_msg(request->id.value, request->id.value_length)) {
                 report_sample = 1;
-                send_permance_info(msg_id.value, msg_id.value_length, "3", 1);
+                send_permance_info(request->id.value, request->id.value_length, "3", 1);
             }
 #endif
             callback = iotx_event_callback(ITE_PROPERTY_SET);
             if (callback) {
-                ((int (*)(const int, const char *, const int))callback)(lite_item_devid.value_int, property_payload,
-                        lite_item_payload.value_length);
+                ((int (*)(const int, const char *, const int))callback)(event->devid, request->payload.value,
+                        request->payload.value_length);
             }
 #ifdef LOG_REPORT_TO_CLOUD
             if (1 == report_sample) {
@@ -461,86 +474,48 @@ static void _iotx_linkkit_event_callback(iotx_dm_event_types_t type, char *paylo
                 report_sample = 0;
             }
 #endif
-
-            IMPL_LINKKIT_FREE(property_payload);
         }
         break;
 #ifdef DEVICE_MODEL_SHADOW
         case IOTX_DM_EVENT_PROPERTY_DESIRED_GET_REPLY: {
-            char *property_data = NULL;
-            lite_cjson_t lite_item_data;
-
-            memset(&lite_item_data, 0, sizeof(lite_cjson_t));
-            dm_utils_json_object_item(&lite, IOTX_LINKKIT_KEY_DATA, strlen(IOTX_LINKKIT_KEY_DATA), cJSON_Invalid,
-                                      &lite_item_data);
-            if (payload == NULL || lite_item_data.type != cJSON_Object) {
+            if (reply->payload.value == NULL || reply->payload.value[0] != '{') {
                 return;
             }
-            dm_log_debug("Current Data: %.*s", lite_item_data.value_length, lite_item_data.value);
-
-            property_data = IMPL_LINKKIT_MALLOC(lite_item_data.value_length + 1);
-            if (property_data == NULL) {
-                dm_log_err("No Enough Memory");
-                return;
-            }
-            memset(property_data, 0, lite_item_data.value_length + 1);
-            memcpy(property_data, lite_item_data.value, lite_item_data.value_length);
+            dm_log_debug("Current Data: %s", reply->payload.value);
 
             callback = iotx_event_callback(ITE_PROPERTY_DESIRED_GET_REPLY);
             if (callback) {
-                ((int (*)(const char *, const int))callback)(property_data,
-                        lite_item_data.value_length);
+                ((int (*)(const char *, const int))callback)(reply->payload.value, reply->payload.value_length);
             }
-
-            IMPL_LINKKIT_FREE(property_data);
         }
         break;
 #endif
         case IOTX_DM_EVENT_PROPERTY_GET: {
             int response_len = 0;
-            char *request = NULL, *response = NULL;
-            uintptr_t property_get_ctx_num = 0;
-            void *property_get_ctx = NULL;
+            char *response = NULL;
 
-            if (payload == NULL || lite_item_id.type != cJSON_String || lite_item_devid.type != cJSON_Number ||
-                lite_item_payload.type != cJSON_Array) {
+            if (request->id.value == NULL || request->payload.value == NULL || request->payload.value[0] != '[') {
                 return;
             }
 
-            dm_log_debug("Current Id: %.*s", lite_item_id.value_length, lite_item_id.value);
-            dm_log_debug("Current Devid: %d", lite_item_devid.value_int);
-            dm_log_debug("Current Payload: %.*s", lite_item_payload.value_length, lite_item_payload.value);
-            dm_log_debug("Current Ctx: %.*s", lite_item_ctx.value_length, lite_item_ctx.value);
-
-            LITE_hexstr_convert(lite_item_ctx.value, lite_item_ctx.value_length, (unsigned char *)&property_get_ctx_num,
-                                sizeof(uintptr_t));
-            property_get_ctx = (void *)property_get_ctx_num;
-            dm_log_debug("property_get_ctx_num: %0x016llX", (unsigned int)property_get_ctx_num);
-            dm_log_debug("property_get_ctx: %p", property_get_ctx);
-
-            request = IMPL_LINKKIT_MALLOC(lite_item_payload.value_length + 1);
-            if (request == NULL) {
-                dm_log_err("No Enough Memory");
-                return;
-            }
-            memset(request, 0, lite_item_payload.value_length + 1);
-            memcpy(request, lite_item_payload.value, lite_item_payload.value_length);
+            dm_log_debug("Current Id: %s", request->id.value);
+            dm_log_debug("Current Devid: %d", event->devid);
+            dm_log_debug("Current Payload: %s", request->payload.value);
+            dm_log_debug("property_get_ctx: %p", request->ctx);
 
             callback = iotx_event_callback(ITE_PROPERTY_GET);
             if (callback) {
-                res = ((int (*)(const int, const char *, const int, char **, int *))callback)(lite_item_devid.value_int, request,
-                        lite_item_payload.value_length, &response, &response_len);
+                res = ((int (*)(const int, const char *, const int, char **, int *))callback)(event->devid,
+                        request->payload.value, request->payload.value_length, &response, &response_len);
 
                 if (response != NULL && response_len > 0) {
                     /* property get response exist */
                     iotx_dm_error_code_t code = (res == 0) ? (IOTX_DM_ERR_CODE_SUCCESS) : (IOTX_DM_ERR_CODE_REQUEST_ERROR);
-                    iotx_dm_send_property_get_response(lite_item_devid.value_int, lite_item_id.value, lite_item_id.value_length, code,
-                                                       response, response_len, property_get_ctx);
+                    iotx_dm_send_property_get_response(event->devid, request->id.value, request->id.value_length, code,
+                                                       response, response_len, request->ctx);
                     HAL_Free(response);
                 }
             }
-
-            IMPL_LINKKIT_FREE(request);
         }
         break;
         case IOTX_DM_EVENT_EVENT_PROPERTY_POST_REPLY:
@@ -552,275 +527,142 @@ static void _iotx_linkkit_event_callback(iotx_dm_event_types_t type, char *paylo
             char *user_payload = NULL;
             int user_payload_length = 0;
 
-            if (payload == NULL || lite_item_id.type != cJSON_Number || lite_item_code.type != cJSON_Number
-                || lite_item_devid.type != cJSON_Number) {
-                return;
-            }
-            dm_log_debug("Current Id: %d", lite_item_id.value_int);
-            dm_log_debug("Current Code: %d", lite_item_code.value_int);
-            dm_log_debug("Current Devid: %d", lite_item_devid.value_int);
-
-            if (lite_item_payload.type == cJSON_Object && lite_item_payload.value_length > 0) {
-                user_payload = IMPL_LINKKIT_MALLOC(lite_item_payload.value_length + 1);
-                if (user_payload == NULL) {
-                    dm_log_err("No Enough Memory");
-                    return;
-                }
-                memset(user_payload, 0, lite_item_payload.value_length + 1);
-                memcpy(user_payload, lite_item_payload.value, lite_item_payload.value_length);
-                user_payload_length = lite_item_payload.value_length;
+            dm_log_debug("Current Id: %d", reply->id);
+            dm_log_debug("Current Code: %d", reply->code);
+            dm_log_debug("Current Devid: %d", event->devid);
+
+            /* only data of object is passed to user, message of failed reply is not,
+               nor data of desired delete reply, which was never passed */
+            if (event->type != IOTX_DM_EVENT_PROPERTY_DESIRED_DELETE_REPLY && reply->payload.value != NULL &&
+                reply->payload.value[0] == '{') {
+                user_payload = reply->payload.value;
+                user_payload_length = reply->payload.value_length;
             }
 
             callback = iotx_event_callback(ITE_REPORT_REPLY);
             if (callback) {
-                ((int (*)(const int, const int, const int, const char *, const int))callback)(lite_item_devid.value_int,
-                        lite_item_id.value_int, lite_item_code.value_int, user_payload,
-                        user_payload_length);
-            }
-
-            if (user_payload) {
-                IMPL_LINKKIT_FREE(user_payload);
+                ((int (*)(const int, const int, const int, const char *, const int))callback)(event->devid,
+                        reply->id, reply->code, user_payload, user_payload_length);
             }
         }
         break;
         case IOTX_DM_EVENT_EVENT_SPECIFIC_POST_REPLY: {
-            char *user_eventid = NULL;
-            char *user_payload = NULL;
-
-            if (payload == NULL || lite_item_id.type != cJSON_Number || lite_item_code.type != cJSON_Number ||
-                lite_item_devid.type != cJSON_Number || lite_item_eventid.type != cJSON_String
-                || lite_item_payload.type != cJSON_String) {
+            if (reply->eventid.value == NULL || reply->payload.value == NULL) {
                 return;
             }
 
-            dm_log_debug("Current Id: %d", lite_item_id.value_int);
-            dm_log_debug("Current Code: %d", lite_item_code.value_int);
-            dm_log_debug("Current Devid: %d", lite_item_devid.value_int);
-            dm_log_debug("Current EventID: %.*s", lite_item_eventid.value_length, lite_item_eventid.value);
-            dm_log_debug("Current Message: %.*s", lite_item_payload.value_length, lite_item_payload.value);
-
-            user_eventid = IMPL_LINKKIT_MALLOC(lite_item_eventid.value_length + 1);
-            if (user_eventid == NULL) {
-                dm_log_err("Not Enough Memory");
-                return;
-            }
-            memset(user_eventid, 0, lite_item_eventid.value_length + 1);
-            memcpy(user_eventid, lite_item_eventid.value, lite_item_eventid.value_length);
-
-            user_payload = IMPL_LINKKIT_MALLOC(lite_item_payload.value_length + 1);
-            if (user_payload == NULL) {
-                dm_log_err("Not Enough Memory");
-                IMPL_LINKKIT_FREE(user_eventid);
-                return;
-            }
-            memset(user_payload, 0, lite_item_payload.value_length + 1);
-            memcpy(user_payload, lite_item_payload.value, lite_item_payload.value_length);
-
+            dm_log_debug("Current Id: %d", reply->id);
+            dm_log_debug("Current Code: %d", reply->code);
+            dm_log_debug("Current Devid: %d", event->devid);
+            dm_log_debug("Current EventID: %s", reply->eventid.value);
+            dm_log_debug("Current Message: %s", reply->payload.value);
 
             callback = iotx_event_callback(ITE_TRIGGER_EVENT_REPLY);
             if (callback) {
                 ((int (*)(const int, const int, const int, const char *, const int, const char *,
-                          const int))callback)(lite_item_devid.value_int,
-                                               lite_item_id.value_int, lite_item_code.value_int,
-                                               user_eventid, lite_item_eventid.value_length, user_payload, lite_item_payload.value_length);
+                          const int))callback)(event->devid, reply->id, reply->code,
+                                               reply->eventid.value, reply->eventid.value_length,
+                                               reply->payload.value, reply->payload.value_length);
             }
-
-            IMPL_LINKKIT_FREE(user_eventid);
-            IMPL_LINKKIT_FREE(user_payload);
         }
         break;
         case IOTX_DM_EVENT_NTP_RESPONSE: {
-            char *utc_payload = NULL;
-
-            if (payload == NULL || lite_item_utc.type != cJSON_String) {
+            if (event->data.utc.value == NULL) {
                 return;
             }
 
-            dm_log_debug("Current UTC: %.*s", lite_item_utc.value_length, lite_item_utc.value);
-
-            utc_payload = IMPL_LINKKIT_MALLOC(lite_item_utc.value_length + 1);
-            if (utc_payload == NULL) {
-                dm_log_err("Not Enough Memory");
-                return;
-            }
-            memset(utc_payload, 0, lite_item_utc.value_length + 1);
-            memcpy(utc_payload, lite_item_utc.value, lite_item_utc.value_length);
+            dm_log_debug("Current UTC: %s", event->data.utc.value);
 
             callback = iotx_event_callback(ITE_TIMESTAMP_REPLY);
             if (callback) {
-                ((int (*)(const char *))callback)(utc_payload);
+                ((int (*)(const char *))callback)(event->data.utc.value);
             }
-
-            IMPL_LINKKIT_FREE(utc_payload);
         }
         break;
         case IOTX_DM_EVENT_RRPC_REQUEST: {
             int rrpc_response_len = 0;
-            char *rrpc_request = NULL, *rrpc_response = NULL;
+            char *rrpc_response = NULL;
 
-            if (payload == NULL || lite_item_id.type != cJSON_String || lite_item_devid.type != cJSON_Number ||
-                lite_item_serviceid.type != cJSON_String || lite_item_rrpcid.type != cJSON_String
-                || lite_item_payload.type != cJSON_Object) {
+            if (request->id.value == NULL || request->serviceid.value == NULL || request->rrpcid.value == NULL ||
+                request->payload.value == NULL || request->payload.value[0] != '{') {
                 return;
             }
 
-            dm_log_debug("Current Id: %.*s", lite_item_id.value_length, lite_item_id.value);
-            dm_log_debug("Current Devid: %d", lite_item_devid.value_int);
-            dm_log_debug("Current ServiceID: %.*s", lite_item_serviceid.value_length, lite_item_serviceid.value);
-            dm_log_debug("Current RRPC ID: %.*s", lite_item_rrpcid.value_length, lite_item_rrpcid.value);
-            dm_log_debug("Current Payload: %.*s", lite_item_payload.value_length, lite_item_payload.value);
-
-            rrpc_request = IMPL_LINKKIT_MALLOC(lite_item_payload.value_length + 1);
-            if (rrpc_request == NULL) {
-                dm_log_err("Not Enough Memory");
-                return;
-            }
-            memset(rrpc_request, 0, lite_item_payload.value_length + 1);
-            memcpy(rrpc_request, lite_item_payload.value, lite_item_payload.value_length);
+            dm_log_debug("Current Id: %s", request->id.value);
+            dm_log_debug("Current Devid: %d", event->devid);
+            dm_log_debug("Current ServiceID: %s", request->serviceid.value);
+            dm_log_debug("Current RRPC ID: %s", request->rrpcid.value);
+            dm_log_debug("Current Payload: %s", request->payload.value);
 
             callback = iotx_event_callback(ITE_SERVICE_REQUEST);
             if (callback) {
                 res = ((int (*)(const int, const char *, const int, const char *, const int, char **,
-                                int *))callback)(lite_item_devid.value_int, lite_item_serviceid.value,
-                                                 lite_item_serviceid.value_length,
-                                                 rrpc_request, lite_item_payload.value_length, &rrpc_response, &rrpc_response_len);
+                                int *))callback)(event->devid, request->serviceid.value, request->serviceid.value_length,
+                                                 request->payload.value, request->payload.value_length,
+                                                 &rrpc_response, &rrpc_response_len);
                 if (rrpc_response != NULL && rrpc_response_len > 0) {
                     iotx_dm_error_code_t code = (res == 0) ? (IOTX_DM_ERR_CODE_SUCCESS) : (IOTX_DM_ERR_CODE_REQUEST_ERROR);
-                    iotx_dm_send_rrpc_response(lite_item_devid.value_int, lite_item_id.value, lite_item_id.value_length, code,
-                                               lite_item_rrpcid.value,
-                                               lite_item_rrpcid.value_length,
+                    iotx_dm_send_rrpc_response(event->devid, request->id.value, request->id.value_length, code,
+                                               request->rrpcid.value,
+                                               request->rrpcid.value_length,
                                                rrpc_response, rrpc_response_len);
                     HAL_Free(rrpc_response);
                 }
             }
-
-            IMPL_LINKKIT_FREE(rrpc_request);
         }
         break;
 #endif
         case IOTX_DM_EVENT_FOTA_NEW_FIRMWARE: {
-            char *version = NULL;
-
-            if (payload == NULL || lite_item_version.type != cJSON_String) {
+            if (event->data.version.value == NULL) {
                 return;
             }
 
-            dm_log_debug("Current Firmware Version: %.*s", lite_item_version.value_length, lite_item_version.value);
-
-            version = IMPL_LINKKIT_MALLOC(lite_item_version.value_length + 1);
-            if (version == NULL) {
-                return;
-            }
-            memset(version, 0, lite_item_version.value_length + 1);
-            memcpy(version, lite_item_version.value, lite_item_version.value_length);
+            dm_log_debug("Current Firmware Version: %s", event->data.version.value);
 
             callback = iotx_event_callback(ITE_FOTA);
             if (callback) {
-                ((int (*)(const int, const char *))callback)(0, version);
-            }
-
-            if (version) {
-                IMPL_LINKKIT_FREE(version);
+                ((int (*)(const int, const char *))callback)(0, event->data.version.value);
             }
         }
         break;
         case IOTX_DM_EVENT_COTA_NEW_CONFIG: {
-            char *config_id = NULL, *get_type = NULL, *sign = NULL, *sign_method = NULL, *url = NULL;
+            iotx_dm_event_cota_t *cota = &event->data.cota;
 
-            if (payload == NULL || lite_item_configid.type != cJSON_String || lite_item_configsize.type != cJSON_Number ||
-                lite_item_gettype.type != cJSON_String || lite_item_sign.type != cJSON_String
-                || lite_item_signmethod.type != cJSON_String ||
-                lite_item_url.type != cJSON_String) {
+            if (cota->config_id.value == NULL || cota->get_type.value == NULL || cota->sign.value == NULL ||
+                cota->sign_method.value == NULL || cota->url.value == NULL) {
                 return;
             }
 
-            dm_log_debug("Current Config ID: %.*s", lite_item_configid.value_length, lite_item_configid.value);
-            dm_log_debug("Current Config Size: %d", lite_item_configsize.value_int);
-            dm_log_debug("Current Get Type: %.*s", lite_item_gettype.value_length, lite_item_gettype.value);
-            dm_log_debug("Current Sign: %.*s", lite_item_sign.value_length, lite_item_sign.value);
-            dm_log_debug("Current Sign Method: %.*s", lite_item_signmethod.value_length, lite_item_signmethod.value);
-            dm_log_debug("Current URL: %.*s", lite_item_url.value_length, lite_item_url.value);
-
-            _impl_copy(lite_item_configid.value, lite_item_configid.value_length, (void **)&config_id,
-                       lite_item_configid.value_length + 1);
-            _impl_copy(lite_item_gettype.value, lite_item_gettype.value_length, (void **)&get_type,
-                       lite_item_gettype.value_length + 1);
-            _impl_copy(lite_item_sign.value, lite_item_sign.value_length, (void **)&sign, lite_item_sign.value_length + 1);
-            _impl_copy(lite_item_signmethod.value, lite_item_signmethod.value_length, (void **)&sign_method,
-                       lite_item_signmethod.value_length + 1);
-            _impl_copy(lite_item_url.value, lite_item_url.value_length, (void **)&url, lite_item_url.value_length + 1);
-
-            if (config_id == NULL || get_type == NULL || sign == NULL || sign_method == NULL || url == NULL) {
-                if (config_id) {
-                    IMPL_LINKKIT_FREE(config_id);
-                }
-                if (get_type) {
-                    IMPL_LINKKIT_FREE(get_type);
-                }
-                if (sign) {
-                    IMPL_LINKKIT_FREE(sign);
-                }
-                if (sign_method) {
-                    IMPL_LINKKIT_FREE(sign_method);
-                }
-                if (url) {
-                    IMPL_LINKKIT_FREE(url);
-                }
-                return;
-            }
+            dm_log_debug("Current Config ID: %s", cota->config_id.value);
+            dm_log_debug("Current Config Size: %d", cota->config_size);
+            dm_log_debug("Current Get Type: %s", cota->get_type.value);
+            dm_log_debug("Current Sign: %s", cota->sign.value);
+            dm_log_debug("Current Sign Method: %s", cota->sign_method.value);
+            dm_log_debug("Current URL: %s", cota->url.value);
 
             callback = iotx_event_callback(ITE_COTA);
             if (callback) {
-                ((int (*)(const int, const char *, int, const char *, const char *, const char *, const char *))callback)(0, config_id,
-                        lite_item_configsize.value_int, get_type, sign, sign_method, url);
-            }
-
-            if (config_id) {
-                IMPL_LINKKIT_FREE(config_id);
-            }
-            if (get_type) {
-                IMPL_LINKKIT_FREE(get_type);
-            }
-            if (sign) {
-                IMPL_LINKKIT_FREE(sign);
-            }
-            if (sign_method) {
-                IMPL_LINKKIT_FREE(sign_method);
-            }
-            if (url) {
-                IMPL_LINKKIT_FREE(url);
+                ((int (*)(const int, const char *, int, const char *, const char *, const char *, const char *))callback)(0,
+                        cota->config_id.value, cota->config_size, cota->get_type.value, cota->sign.value,
+                        cota->sign_method.value, cota->url.value);
             }
         }
         break;
 #ifdef DEVICE_MODEL_GATEWAY
         case IOTX_DM_EVENT_TOPO_GET_REPLY: {
-            char *topo_list = NULL;
-
-            if (payload == NULL || lite_item_id.type != cJSON_Number || lite_item_devid.type != cJSON_Number ||
-                lite_item_code.type != cJSON_Number || lite_item_topo.type != cJSON_Array) {
-                return;
-            }
-            dm_log_debug("Current Id: %d", lite_item_id.value_int);
-            dm_log_debug("Current Devid: %d", lite_item_devid.value_int);
-            dm_log_debug("Current Code: %d", lite_item_code.value_int);
-            dm_log_debug("Current Topo List: %.*s", lite_item_topo.value_length, lite_item_topo.value);
-
-            topo_list = IMPL_LINKKIT_MALLOC(lite_item_topo.value_length + 1);
-            if (topo_list == NULL) {
-                dm_log_err("Not Enough Memory");
+            if (reply->payload.value == NULL || reply->payload.value[0] != '[') {
                 return;
             }
-            memset(topo_list, 0, lite_item_topo.value_length + 1);
-            memcpy(topo_list, lite_item_topo.value, lite_item_topo.value_length);
+            dm_log_debug("Current Id: %d", reply->id);
+            dm_log_debug("Current Devid: %d", event->devid);
+            dm_log_debug("Current Code: %d", reply->code);
+            dm_log_debug("Current Topo List: %s", reply->payload.value);
 
             callback = iotx_event_callback(ITE_TOPOLIST_REPLY);
             if (callback) {
-                ((int (*)(const int, const int, const int, const char *, const int))callback)(lite_item_devid.value_int,
-                        lite_item_id.value_int,
-                        lite_item_code.value_int, topo_list, lite_item_topo.value_length);
+                ((int (*)(const int, const int, const int, const char *, const int))callback)(event->devid,
+                        reply->id, reply->code, reply->payload.value, reply->payload.value_length);
             }
-
-            IMPL_LINKKIT_FREE(topo_list);
         }
         break;
         case IOTX_DM_EVENT_TOPO_DELETE_REPLY:
@@ -828,45 +670,33 @@ static void _iotx_linkkit_event_callback(iotx_dm_event_types_t type, char *paylo
         case IOTX_DM_EVENT_SUBDEV_REGISTER_REPLY:
         case IOTX_DM_EVENT_COMBINE_LOGIN_REPLY:
         case IOTX_DM_EVENT_COMBINE_LOGOUT_REPLY: {
-            if (payload == NULL || lite_item_id.type != cJSON_Number || lite_item_devid.type != cJSON_Number ||
-                lite_item_code.type != cJSON_Number) {
-                return;
-            }
-            dm_log_debug("Current Id: %d", lite_item_id.value_int);
-            dm_log_debug("Current Code: %d", lite_item_code.value_int);
-            dm_log_debug("Current Devid: %d", lite_item_devid.value_int);
+            iotx_linkkit_upstream_sync_callback_node_t *node = NULL;
+
+            dm_log_debug("Current Id: %d", reply->id);
+            dm_log_debug("Current Code: %d", reply->code);
+            dm_log_debug("Current Devid: %d", event->devid);
 
             _iotx_linkkit_upstream_mutex_lock();
-            _iotx_linkkit_upstream_callback_remove(lite_item_id.value_int, lite_item_code.value_int);
+            node = _iotx_linkkit_upstream_callback_remove(reply->id, reply->code);
             _iotx_linkkit_upstream_mutex_unlock();
+            if (node != NULL) {
+                _iotx_linkkit_upstream_async_complete(node);
+            }
         }
         break;
         case IOTX_DM_EVENT_GATEWAY_PERMIT: {
             char *product_key = "";
 
-            if (payload == NULL || lite_item_time.type != cJSON_Number) {
-                return;
-            }
-            dm_log_debug("Current Time: %d", lite_item_time.value_int);
-
-            if (lite_item_pk.type == cJSON_String) {
-                dm_log_debug("Current Product Key: %.*s", lite_item_pk.value_length, lite_item_pk.value);
-                product_key = IMPL_LINKKIT_MALLOC(lite_item_pk.value_length + 1);
-                if (product_key == NULL) {
-                    dm_log_err("Not Enough Memory");
-                    return;
-                }
-                memset(product_key, 0, lite_item_pk.value_length + 1);
-                memcpy(product_key, lite_item_pk.value, lite_item_pk.value_length);
+            dm_log_debug("Current Time: %d", event->data.permit.time);
+
+            if (event->data.permit.product_key.value != NULL) {
+                dm_log_debug("Current Product Key: %s", event->data.permit.product_key.value);
+                product_key = event->data.permit.product_key.value;
             }
 
             callback = iotx_event_callback(ITE_PERMIT_JOIN);
             if (callback) {
-                ((int (*)(const char *, int))callback)((const char *)product_key, (const int)lite_item_time.value_int);
-            }
-
-            if (lite_item_pk.type == cJSON_String) {
-                IMPL_LINKKIT_FREE(product_key);
+                ((int (*)(const char *, int))callback)((const char *)product_key, (const int)event->data.permit.time);
             }
         }
         break;
@@ -944,7 +774,7 @@ static int _iotx_linkkit_master_connect(void)
     int res = 0;
     iotx_linkkit_ctx_t *ctx = _iotx_linkkit_get_ctx();
     iotx_dm_init_params_t dm_init_params;
-    iotx_dm_event_types_t type;
+    iotx_dm_event_t event;
 
     if (ctx->is_connected) {
         return FAIL_RETURN;
@@ -952,7 +782,7 @@ static int _iotx_linkkit_master_connect(void)
     ctx->is_connected = 1;
 
     memset(&dm_init_params, 0, sizeof(iotx_dm_init_params_t));
-    dm_init_params.event_callback = _iotx_linkkit_event_callback;
+    dm_init_params.event_handler = _iotx_linkkit_event_callback;
 
     res = iotx_dm_connect(&dm_init_params);
     if (res != SUCCESS_RETURN) {
@@ -968,8 +798,10 @@ static int _iotx_linkkit_master_connect(void)
         return FAIL_RETURN;
     }
 
-    type = IOTX_DM_EVENT_INITIALIZED;
-    _iotx_linkkit_event_callback(type, "{\"devid\":0}");
+    memset(&event, 0, sizeof(iotx_dm_event_t));
+    event.type = IOTX_DM_EVENT_INITIALIZED;
+    event.devid = IOTX_DM_LOCAL_NODE_DEVID;
+    _iotx_linkkit_event_callback(&event);
 
     return SUCCESS_RETURN;
 }
@@ -1132,6 +964,123 @@ static int _iotx_linkkit_subdev_delete_topo(int devid)
 
     return SUCCESS_RETURN;
 }
+
+/* slave devices handled together by IOT_Linkkit_Connect_Batch() */
+#define IOTX_LINKKIT_BATCH_WAVE (CONFIG_LINKKIT_BATCH_DEVICES * CONFIG_LINKKIT_BATCH_INFLIGHT)
+
+/* register slave devices without device secret, every request is sent before waiting for replies */
+static void _iotx_linkkit_slave_batch_register(int *devids, int *results, int num)
+{
+    int index = 0;
+    int msgids[IOTX_LINKKIT_BATCH_WAVE];
+    uint64_t deadline = 0;
+
+    for (index = 0; index < num; index++) {
+        msgids[index] = 0;
+        if (results[index] != SUCCESS_RETURN) {
+            continue;
+        }
+        msgids[index] = iotx_dm_subdev_register(devids[index]);
+        if (msgids[index] < SUCCESS_RETURN ||
+            (msgids[index] > SUCCESS_RETURN && _iotx_linkkit_upstream_sync_track(msgids[index]) != SUCCESS_RETURN)) {
+            results[index] = FAIL_RETURN;
+            msgids[index] = 0;
+        }
+    }
+
+    deadline = HAL_UptimeMs() + IOTX_LINKKIT_SYNC_DEFAULT_TIMEOUT_MS;
+    for (index = 0; index < num; index++) {
+        if (msgids[index] > 0 && _iotx_linkkit_upstream_sync_result(msgids[index], deadline) != SUCCESS_RETURN) {
+            results[index] = FAIL_RETURN;
+        }
+    }
+}
+
+/* add slave devices not failed yet to topo, or login them, CONFIG_LINKKIT_BATCH_DEVICES in one request */
+static void _iotx_linkkit_slave_batch_request(int *devids, int *results, int num, int login)
+{
+    int index = 0, batch = 0, batch_num = 0, count = 0, code = FAIL_RETURN, alive_num = 0;
+    int alive[IOTX_LINKKIT_BATCH_WAVE];
+    int batch_devids[CONFIG_LINKKIT_BATCH_DEVICES];
+    int msgids[CONFIG_LINKKIT_BATCH_INFLIGHT];
+    iotx_dm_dev_status_t status = IOTX_DM_DEV_STATUS_UNAUTHORIZED;
+    uint64_t deadline = 0;
+
+    for (index = 0; index < num; index++) {
+        if (results[index] == SUCCESS_RETURN) {
+            alive[alive_num++] = index;
+        }
+    }
+    batch_num = (alive_num + CONFIG_LINKKIT_BATCH_DEVICES - 1) / CONFIG_LINKKIT_BATCH_DEVICES;
+
+    for (batch = 0; batch < batch_num; batch++) {
+        count = alive_num - batch * CONFIG_LINKKIT_BATCH_DEVICES;
+        if (count > CONFIG_LINKKIT_BATCH_DEVICES) {
+            count = CONFIG_LINKKIT_BATCH_DEVICES;
+        }
+        for (index = 0; index < count; index++) {
+            batch_devids[index] = devids[alive[batch * CONFIG_LINKKIT_BATCH_DEVICES + index]];
+        }
+
+        if (login) {
+            msgids[batch] = iotx_dm_subdev_login_batch(batch_devids, count);
+        } else {
+            msgids[batch] = iotx_dm_subdev_topo_add_batch(batch_devids, count);
+        }
+        if (msgids[batch] <= 0 || _iotx_linkkit_upstream_sync_track(msgids[batch]) != SUCCESS_RETURN) {
+            msgids[batch] = 0;
+        }
+    }
+
+    /* a device succeeded if its request did and reply moved it on */
+    deadline = HAL_UptimeMs() + IOTX_LINKKIT_SYNC_DEFAULT_TIMEOUT_MS;
+    for (index = 0; index < alive_num; index++) {
+        batch = index / CONFIG_LINKKIT_BATCH_DEVICES;
+        if (index % CONFIG_LINKKIT_BATCH_DEVICES == 0) {
+            code = (msgids[batch] > 0) ? _iotx_linkkit_upstream_sync_result(msgids[batch], deadline) : FAIL_RETURN;
+        }
+        if (code != SUCCESS_RETURN || iotx_dm_get_device_status(devids[alive[index]], &status) != SUCCESS_RETURN ||
+            status < (login ? IOTX_DM_DEV_STATUS_LOGINED : IOTX_DM_DEV_STATUS_ATTACHED)) {
+            results[alive[index]] = FAIL_RETURN;
+        }
+    }
+}
+
+/* send request of slave device for IOT_Linkkit_Request_Async(), return its msgid */
+static int _iotx_linkkit_slave_request_send(int devid, iotx_linkkit_request_type_t type)
+{
+    int res = 0;
+
+    switch (type) {
+        case IOTX_LINKKIT_REQUEST_REGISTER: {
+            res = iotx_dm_subdev_register(devid);
+        }
+        break;
+        case IOTX_LINKKIT_REQUEST_TOPO_ADD: {
+            res = iotx_dm_subdev_topo_add(devid);
+        }
+        break;
+        case IOTX_LINKKIT_REQUEST_TOPO_DELETE: {
+            res = iotx_dm_subdev_topo_del(devid);
+        }
+        break;
+        case IOTX_LINKKIT_REQUEST_LOGIN: {
+            res = iotx_dm_subdev_login(devid);
+        }
+        break;
+        case IOTX_LINKKIT_REQUEST_LOGOUT: {
+            res = iotx_dm_subdev_logout(devid);
+        }
+        break;
+        default: {
+            dm_log_err("Unknown Request Type: %d", type);
+            res = FAIL_RETURN;
+        }
+        break;
+    }
+
+    return res;
+}
 #endif
 
 static int _iotx_linkkit_master_close(void)
@@ -1243,6 +1192,111 @@ int IOT_Linkkit_Connect(int devid)
     return res;
 }
 
+int IOT_Linkkit_Connect_Batch(int *devids, int devid_num, iotx_linkkit_batch_cb_t callback, void *user_data)
+{
+#ifdef DEVICE_MODEL_GATEWAY
+    int res = 0, wave = 0, index = 0, num = 0, logined = 0;
+    int results[IOTX_LINKKIT_BATCH_WAVE];
+    iotx_linkkit_ctx_t *ctx = _iotx_linkkit_get_ctx();
+    void *event_callback = NULL;
+
+    if (devids == NULL || devid_num <= 0) {
+        dm_log_err("Invalid Parameter");
+        return FAIL_RETURN;
+    }
+
+    if (ctx->is_opened == 0 || ctx->is_connected == 0) {
+        dm_log_err("master isn't start");
+        return FAIL_RETURN;
+    }
+
+    _iotx_linkkit_mutex_lock();
+    for (wave = 0; wave < devid_num; wave += IOTX_LINKKIT_BATCH_WAVE) {
+        num = devid_num - wave;
+        if (num > IOTX_LINKKIT_BATCH_WAVE) {
+            num = IOTX_LINKKIT_BATCH_WAVE;
+        }
+        for (index = 0; index < num; index++) {
+            results[index] = (devids[wave + index] > IOTX_DM_LOCAL_NODE_DEVID) ? SUCCESS_RETURN : FAIL_RETURN;
+        }
+
+        _iotx_linkkit_slave_batch_register(devids + wave, results, num);
+        _iotx_linkkit_slave_batch_request(devids + wave, results, num, 0);
+        _iotx_linkkit_slave_batch_request(devids + wave, results, num, 1);
+
+        for (index = 0; index < num; index++) {
+            if (results[index] == SUCCESS_RETURN) {
+                res = iotx_dm_subscribe(devids[wave + index]);
+                if (res != SUCCESS_RETURN) {
+                    results[index] = FAIL_RETURN;
+                }
+            }
+            if (results[index] == SUCCESS_RETURN) {
+                logined++;
+                iotx_dm_send_aos_active(devids[wave + index]);
+                event_callback = iotx_event_callback(ITE_INITIALIZE_COMPLETED);
+                if (event_callback) {
+                    ((int (*)(const int))event_callback)(devids[wave + index]);
+                }
+            }
+            if (callback) {
+                callback(devids[wave + index], results[index], user_data);
+            }
+        }
+    }
+    _iotx_linkkit_mutex_unlock();
+
+    return logined;
+#else
+    return FAIL_RETURN;
+#endif
+}
+
+int IOT_Linkkit_Request_Async(int devid, iotx_linkkit_request_type_t type, iotx_linkkit_request_cb_t callback,
+                              void *user_data)
+{
+#ifdef DEVICE_MODEL_GATEWAY
+    int res = 0, msgid = 0;
+    iotx_linkkit_ctx_t *ctx = _iotx_linkkit_get_ctx();
+    iotx_linkkit_upstream_sync_callback_node_t *node = NULL;
+
+    if (devid <= 0) {
+        dm_log_err("Invalid Parameter");
+        return FAIL_RETURN;
+    }
+
+    if (ctx->is_opened == 0 || ctx->is_connected == 0) {
+        dm_log_err("master isn't start");
+        return FAIL_RETURN;
+    }
+
+    _iotx_linkkit_mutex_lock();
+    /* reply dispatched by another thread looks for the node under upstream mutex, so it is listed before that */
+    _iotx_linkkit_upstream_mutex_lock();
+    msgid = _iotx_linkkit_slave_request_send(devid, type);
+    if (msgid > 0) {
+        res = _iotx_linkkit_upstream_sync_callback_list_insert(msgid, NULL, &node);
+        if (res == SUCCESS_RETURN) {
+            node->devid = devid;
+            node->type = type;
+            node->callback = callback;
+            node->user_data = user_data;
+            node->deadline = HAL_UptimeMs() + IOTX_LINKKIT_SYNC_DEFAULT_TIMEOUT_MS;
+        } else {
+            msgid = FAIL_RETURN;
+        }
+    } else if (msgid < 0 || type != IOTX_LINKKIT_REQUEST_REGISTER) {
+        msgid = FAIL_RETURN;
+    }
+    _iotx_linkkit_upstream_mutex_unlock();
+    _iotx_linkkit_mutex_unlock();
+
+    return msgid;
+#else
+    return FAIL_RETURN;
+#endif
+}
+
 void IOT_Linkkit_Yield(int timeout_ms)
 {
     iotx_linkkit_ctx_t *ctx = _iotx_linkkit_get_ctx();
@@ -1260,6 +1314,7 @@ void IOT_Linkkit_Yield(int timeout_ms)
     iotx_dm_dispatch();
 
 #ifdef DEVICE_MODEL_GATEWAY
+    _iotx_linkkit_upstream_async_expire();
     HAL_SleepMs(timeout_ms);
 #endif
 }
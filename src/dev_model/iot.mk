@@ -15,13 +15,61 @@ SRCS_linkkit-example-solo := examples/linkkit_example_solo.c examples/cJSON.c
 LIB_SRCS_EXCLUDE             += examples/linkkit_example_gateway.c examples/cJSON.c
 SRCS_linkkit-example-gateway := examples/linkkit_example_gateway.c examples/cJSON.c
 
+LIB_SRCS_EXCLUDE                   += examples/linkkit_example_gateway_batch.c
+SRCS_linkkit-example-gateway-batch := examples/linkkit_example_gateway_batch.c examples/cJSON.c \
+                                      ../mqtt/examples/mqtt_example_broker.c
+
+LIB_SRCS_EXCLUDE                     += examples/linkkit_example_request_async.c
+SRCS_linkkit-example-request-async := examples/linkkit_example_request_async.c examples/cJSON.c \
+                                      ../mqtt/examples/mqtt_example_broker.c
+
+LIB_SRCS_EXCLUDE                += examples/linkkit_example_registry.c
+SRCS_linkkit-example-registry   := examples/linkkit_example_registry.c
+
+LIB_SRCS_EXCLUDE                 += examples/linkkit_example_prop_report.c
+SRCS_linkkit-example-prop-report := examples/linkkit_example_prop_report.c ../mqtt/examples/mqtt_example_broker.c
+
+LIB_SRCS_EXCLUDE                 += examples/linkkit_example_prop_set.c
+SRCS_linkkit-example-prop-set    := examples/linkkit_example_prop_set.c ../mqtt/examples/mqtt_example_broker.c
+
+LIB_SRCS_EXCLUDE                 += examples/linkkit_example_msg_cache.c
+SRCS_linkkit-example-msg-cache   := examples/linkkit_example_msg_cache.c
+
+LIB_SRCS_EXCLUDE                 += examples/linkkit_example_shadow.c
+SRCS_linkkit-example-shadow      := examples/linkkit_example_shadow.c
+
+LIB_SRCS_EXCLUDE                 += examples/linkkit_example_envelope.c
+SRCS_linkkit-example-envelope    := examples/linkkit_example_envelope.c
+
+LIB_SRCS_EXCLUDE                 += examples/linkkit_example_cjson_arena.c
+SRCS_linkkit-example-cjson-arena := examples/linkkit_example_cjson_arena.c
+
+LIB_SRCS_EXCLUDE                 += examples/linkkit_example_cjson_index.c
+SRCS_linkkit-example-cjson-index := examples/linkkit_example_cjson_index.c
+
+LIB_SRCS_EXCLUDE                 += examples/linkkit_example_ipc.c
+SRCS_linkkit-example-ipc         := examples/linkkit_example_ipc.c
+
 $(call Append_Conditional, LIB_SRCS_PATTERN, alcs/*.c, ALCS_ENABLED)
 
 ifneq (,$(filter -DDEPRECATED_LINKKIT,$(CFLAGS)))
 $(call Append_Conditional, TARGET, linkkit-example-solo, DEVICE_MODEL_ENABLED, BUILD_AOS NO_EXECUTABLES DEVICE_MODEL_GATEWAY)
 $(call Append_Conditional, TARGET, linkkit-example-gateway, DEVICE_MODEL_ENABLED DEVICE_MODEL_GATEWAY, BUILD_AOS NO_EXECUTABLES)
+$(call Append_Conditional, TARGET, linkkit-example-shadow, DEVICE_MODEL_ENABLED PLATFORM_HAS_DYNMEM, BUILD_AOS NO_EXECUTABLES)
 else
 $(call Append_Conditional, TARGET, linkkit-example-solo, DEVICE_MODEL_ENABLED, BUILD_AOS NO_EXECUTABLES)
 $(call Append_Conditional, TARGET, linkkit-example-gateway, DEVICE_MODEL_GATEWAY, BUILD_AOS NO_EXECUTABLES)
+$(call Append_Conditional, TARGET, linkkit-example-gateway-batch, DEVICE_MODEL_GATEWAY PLATFORM_HAS_OS PLATFORM_HAS_DYNMEM, ATM_ENABLED BUILD_AOS NO_EXECUTABLES)
+$(call Append_Conditional, TARGET, linkkit-example-request-async, DEVICE_MODEL_GATEWAY PLATFORM_HAS_DYNMEM, ATM_ENABLED BUILD_AOS NO_EXECUTABLES)
+$(call Append_Conditional, TARGET, linkkit-example-registry, DEVICE_MODEL_GATEWAY, BUILD_AOS NO_EXECUTABLES)
+$(call Append_Conditional, TARGET, linkkit-example-prop-report, DEVICE_MODEL_ENABLED PLATFORM_HAS_DYNMEM, ATM_ENABLED BUILD_AOS NO_EXECUTABLES)
+$(call Append_Conditional, TARGET, linkkit-example-prop-set, DEVICE_MODEL_ENABLED PLATFORM_HAS_DYNMEM _PLATFORM_IS_LINUX_, ATM_ENABLED BUILD_AOS NO_EXECUTABLES)
+$(call Append_Conditional, TARGET, linkkit-example-envelope, DEVICE_MODEL_ENABLED INFRA_CJSON PLATFORM_HAS_DYNMEM, BUILD_AOS NO_EXECUTABLES)
+$(call Append_Conditional, TARGET, linkkit-example-cjson-index, DEVICE_MODEL_ENABLED INFRA_CJSON PLATFORM_HAS_DYNMEM, BUILD_AOS NO_EXECUTABLES)
+$(call Append_Conditional, TARGET, linkkit-example-msg-cache, DEVICE_MODEL_ENABLED PLATFORM_HAS_DYNMEM, ATM_ENABLED BUILD_AOS NO_EXECUTABLES)
+$(call Append_Conditional, TARGET, linkkit-example-ipc, DEVICE_MODEL_ENABLED PLATFORM_HAS_DYNMEM, ATM_ENABLED BUILD_AOS NO_EXECUTABLES)
 endif
 
+# lite_cjson builds documents only for gateway, ALCS and deprecated linkkit
+$(call Append_Conditional, TARGET, linkkit-example-cjson-arena, DEVICE_MODEL_GATEWAY PLATFORM_HAS_DYNMEM, BUILD_AOS NO_EXECUTABLES)
+
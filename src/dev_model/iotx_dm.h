@@ -100,6 +100,66 @@ typedef enum {
 
 typedef void (*iotx_dm_event_callback)(iotx_dm_event_types_t type, char *payload);
 
+/* Slice of event, always terminated by '\0' which is not counted in value_length, NULL if absent */
+typedef struct {
+    char *value;
+    int value_length;
+} iotx_dm_event_str_t;
+
+/* Reply of upstream message, or timeout of it with code IOTX_DM_ERR_CODE_TIMEOUT */
+typedef struct {
+    int id;
+    int code;
+    iotx_dm_event_str_t payload;    /* data or message of reply, topo list of topo get reply */
+    iotx_dm_event_str_t eventid;    /* event identifier of specific post reply */
+} iotx_dm_event_reply_t;
+
+/* Downstream request, also the raw data of IOTX_DM_EVENT_MODEL_DOWN_RAW and IOTX_DM_EVENT_MODEL_UP_RAW_REPLY */
+typedef struct {
+    iotx_dm_event_str_t id;         /* message id in string as received */
+    iotx_dm_event_str_t serviceid;
+    iotx_dm_event_str_t rrpcid;
+    iotx_dm_event_str_t payload;    /* params in JSON, or binary of raw data */
+    void *ctx;                      /* context of local request, pass back with response */
+} iotx_dm_event_request_t;
+
+typedef struct {
+    iotx_dm_event_str_t config_id;
+    iotx_dm_event_str_t get_type;
+    iotx_dm_event_str_t sign;
+    iotx_dm_event_str_t sign_method;
+    iotx_dm_event_str_t url;
+    int config_size;
+} iotx_dm_event_cota_t;
+
+typedef struct {
+    iotx_dm_event_str_t product_key;
+    int time;
+    iotx_dm_event_str_t params;     /* params of permit message as received */
+} iotx_dm_event_permit_t;
+
+/*
+ * Event delivered to iotx_dm_event_handler, fields are extracted when the event is produced so
+ * the handler never parses JSON. Events not carried in typed form (topo add notify, thing
+ * disable/enable/delete, events of deprecated linkkit) have only @type and @json.
+ */
+typedef struct {
+    iotx_dm_event_types_t type;
+    int devid;
+    char *json;
+    union {
+        iotx_dm_event_reply_t reply;
+        iotx_dm_event_request_t request;
+        iotx_dm_event_cota_t cota;
+        iotx_dm_event_permit_t permit;
+        iotx_dm_event_str_t version;    /* firmware version of IOTX_DM_EVENT_FOTA_NEW_FIRMWARE */
+        iotx_dm_event_str_t utc;        /* server time of IOTX_DM_EVENT_NTP_RESPONSE */
+    } data;
+} iotx_dm_event_t;
+
+/* event and every slice of it are only valid during the call */
+typedef void (*iotx_dm_event_handler)(iotx_dm_event_t *event);
+
 typedef enum {
     IOTX_DM_DEVICE_SECRET_PRODUCT,
     IOTX_DM_DEVICE_SECRET_DEVICE,
@@ -135,6 +195,7 @@ typedef struct {
     iotx_dm_device_secret_types_t secret_type;
     iotx_dm_cloud_domain_types_t domain_type;
     iotx_dm_event_callback event_callback;
+    iotx_dm_event_handler event_handler;    /* takes over event_callback if set, no JSON rendered */
 } iotx_dm_init_params_t;
 
 typedef enum {
@@ -220,6 +281,12 @@ int iotx_dm_subdev_topo_add(_IN_ int devid);
 int iotx_dm_subdev_topo_del(_IN_ int devid);
 int iotx_dm_subdev_login(_IN_ int devid);
 int iotx_dm_subdev_logout(_IN_ int devid);
+int iotx_dm_subdev_topo_add_batch(_IN_ int *devids, _IN_ int devid_num);
+int iotx_dm_subdev_login_batch(_IN_ int *devids, _IN_ int devid_num);
+/* like iotx_dm_subscribe() without waiting for SUBACKs, iotx_dm_subscribe_result() tells when they are in */
+int iotx_dm_subscribe_async(_IN_ int devid);
+int iotx_dm_subscribe_result(_IN_ int devid);
+void iotx_dm_subscribe_cancel(_IN_ int devid);
 int iotx_dm_get_device_type(_IN_ int devid, _OU_ int *type);
 int iotx_dm_get_device_avail_status(_IN_ int devid, _OU_ iotx_dm_dev_avail_t *status);
 int iotx_dm_get_device_status(_IN_ int devid, _OU_ iotx_dm_dev_status_t *status);
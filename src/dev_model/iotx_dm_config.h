@@ -25,12 +25,55 @@
     #define CONFIG_DISPATCH_QUEUE_MAXLEN    (50)
 #endif
 
+/* ring of dispatch queue needs atomic builtins, define DM_IPC_RING_DISABLED to fall back to locked list */
+#if !defined(DM_IPC_RING_DISABLED) && (defined(__clang__) || \
+    (defined(__GNUC__) && ((__GNUC__ > 4) || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7))))
+    #define DM_IPC_RING_ENABLED
+#endif
+
 #ifndef CONFIG_DISPATCH_PACKET_MAXCOUNT
     #define CONFIG_DISPATCH_PACKET_MAXCOUNT (0)
 #endif
 
+/* buckets of each device index in dm_manager, devices are found by devid and by product key/device name */
+#ifndef CONFIG_DM_DEV_HASH_SIZE
+    #define CONFIG_DM_DEV_HASH_SIZE         (64)
+#endif
+
 #ifndef CONFIG_MSGCACHE_QUEUE_MAXLEN
     #define CONFIG_MSGCACHE_QUEUE_MAXLEN    (50)
 #endif
 
+/* merged property report is sent once its payload grows to this length, see DM_OPT_PROPERTY_REPORT_WINDOW_MS */
+#ifndef CONFIG_DM_PROP_REPORT_MAXLEN
+    #define CONFIG_DM_PROP_REPORT_MAXLEN    (CONFIG_MQTT_TX_MAXLEN / 2)
+#endif
+
+/* buckets of message cache indexed by msgid, allocated by dm_msg_cache_init() */
+#ifndef CONFIG_MSGCACHE_HASH_SIZE
+    #define CONFIG_MSGCACHE_HASH_SIZE       (CONFIG_MSGCACHE_QUEUE_MAXLEN / 4 + 1)
+#endif
+
+/*
+ * IOT_Linkkit_Connect_Batch() puts this many sub devices into one request and waits for this many requests at a time,
+ * a request has to fit CONFIG_MQTT_TX_MAXLEN, with up to 288 bytes for each signed sub device and 192 for the rest
+ */
+#ifndef CONFIG_LINKKIT_BATCH_DEVICES
+    #define CONFIG_LINKKIT_BATCH_DEVICES    ((CONFIG_MQTT_TX_MAXLEN > 192 + 288) ? (CONFIG_MQTT_TX_MAXLEN - 192) / 288 : 1)
+#endif
+
+#ifndef CONFIG_LINKKIT_BATCH_INFLIGHT
+    #define CONFIG_LINKKIT_BATCH_INFLIGHT   (4)
+#endif
+
+/* upstream message up to this length is written on stack, a longer one into a buffer of its exact length */
+#ifndef CONFIG_DM_MSG_STACK_PAYLOAD_LEN
+    #define CONFIG_DM_MSG_STACK_PAYLOAD_LEN (256)
+#endif
+
+/* params of upstream message are copied into it as they are, set to 0 to skip checking they are valid json */
+#ifndef CONFIG_DM_MSG_PARAMS_CHECK
+    #define CONFIG_DM_MSG_PARAMS_CHECK      (1)
+#endif
+
 #endif
\ No newline at end of file
@@ -60,6 +60,7 @@
 #include "dm_tsl_alink.h"
 #include "dm_message_cache.h"
 #include "dm_opt.h"
+#include "dm_prop_report.h"
 #include "dm_ota.h"
 #include "dm_cota.h"
 #include "dm_fota.h"
@@ -58,6 +58,8 @@ typedef struct {
 
     uint8_t if_stop;
 
+    http2_upload_source_t source;
+
     http2_list_t list;
 } http2_file_stream_t;
 
@@ -83,21 +85,6 @@ static http2_file_stream_ctx_t g_http2_fs_ctx = { 0 };
 static http2_stream_cb_t callback_func = { 0 };
 
 
-/* utils, get file sizef */
-static int http2_stream_get_file_size(const char *file_name)
-{
-    void *fp = NULL;
-    int size = 0;
-    if ((fp = HAL_Fopen(file_name, "r")) == NULL) {
-        h2_err("The file %s can not be opened.\n", file_name);
-        return -1;
-    }
-    HAL_Fseek(fp, 0L, HAL_SEEK_END);
-    size = HAL_Ftell(fp);
-    HAL_Fclose(fp);
-    return size;
-}
-
 /* utils, get file name */
 static const char *_http2_fs_get_filename(const char *file_path)
 {
@@ -119,26 +106,81 @@ static const char *_http2_fs_get_filename(const char *file_path)
     return p_name;
 }
 
-/* utils, read file data */
-static int http2_stream_get_file_data(const char *file_name, char *data, int len, int offset)
+/* default data source, one handle is kept open for the whole upload */
+typedef struct {
+    void *fp;
+    uint32_t offset;            /* current position of fp */
+} http2_file_source_t;
+
+static void *_http2_fs_file_open(const char *file_path, void *user_data)
 {
-    void *fp = NULL;
-    int ret = 0;
-    if ((fp = HAL_Fopen(file_name, "r")) == NULL) {
-        h2_err("The file %s can not be opened.\n", file_name);
-        return -1;
+    http2_file_source_t *file = NULL;
+
+    file = (http2_file_source_t *)HTTP2_STREAM_MALLOC(sizeof(http2_file_source_t));
+    if (file == NULL) {
+        return NULL;
+    }
+    memset(file, 0, sizeof(http2_file_source_t));
+
+    if ((file->fp = HAL_Fopen(file_path, "r")) == NULL) {
+        h2_err("The file %s can not be opened.\n", file_path);
+        HTTP2_STREAM_FREE(file);
+        return NULL;
     }
-    ret = HAL_Fseek(fp, offset, HAL_SEEK_SET);
-    if (ret != 0) {
-        HAL_Fclose(fp);
-        h2_err("The file %s can not move offset.\n", file_name);
+
+    return file;
+}
+
+static int _http2_fs_file_size(void *source)
+{
+    http2_file_source_t *file = (http2_file_source_t *)source;
+    long size = 0;
+
+    if (HAL_Fseek(file->fp, 0L, HAL_SEEK_END) != 0) {
         return -1;
     }
-    ret = HAL_Fread(data, len, 1, fp);
-    HAL_Fclose(fp);
-    return len;
+    size = HAL_Ftell(file->fp);
+    file->offset = (size > 0) ? (uint32_t)size : 0;
+
+    return (int)size;
 }
 
+static int _http2_fs_file_read(void *source, char *buf, uint32_t len, uint32_t offset)
+{
+    http2_file_source_t *file = (http2_file_source_t *)source;
+    uint32_t read_len = 0;
+
+    /* packets are read one after another, seek only when not continuing from last read */
+    if (file->offset != offset) {
+        if (HAL_Fseek(file->fp, offset, HAL_SEEK_SET) != 0) {
+            h2_err("The file can not move offset to %d.\n", offset);
+            return -1;
+        }
+        file->offset = offset;
+    }
+
+    read_len = HAL_Fread(buf, 1, len, file->fp);
+    file->offset += read_len;
+
+    return (int)read_len;
+}
+
+static void _http2_fs_file_close(void *source)
+{
+    http2_file_source_t *file = (http2_file_source_t *)source;
+
+    HAL_Fclose(file->fp);
+    HTTP2_STREAM_FREE(file);
+}
+
+static const http2_upload_source_t g_http2_fs_file_source = {
+    _http2_fs_file_open,
+    _http2_fs_file_size,
+    _http2_fs_file_read,
+    _http2_fs_file_close,
+    NULL
+};
+
 /* open http2 file upload channel */
 static int _http2_fs_open_channel(http2_file_stream_t *fs_node, stream_data_info_t *info)
 {
@@ -205,7 +247,8 @@ static int _http2_fs_open_channel(http2_file_stream_t *fs_node, stream_data_info
 
 
 /* file part data send sync api */
-static int _http2_fs_part_send_sync(http2_file_stream_t *fs_node, stream_data_info_t *info, fs_send_ext_info_t *ext_info)
+static int _http2_fs_part_send_sync(http2_file_stream_t *fs_node, void *source, stream_data_info_t *info,
+                                    fs_send_ext_info_t *ext_info)
 {
     stream_handle_t *h2_handle = g_http2_fs_ctx.http2_handle;
     header_ext_info_t ext_header;
@@ -230,7 +273,8 @@ static int _http2_fs_part_send_sync(http2_file_stream_t *fs_node, stream_data_in
             break;
         }
 
-        res = http2_stream_get_file_data(fs_node->file_path, ext_info->send_buffer, FS_UPLOAD_PACKET_LEN, (info->send_len + ext_info->file_offset)); /* offset used */
+        res = fs_node->source.read_cb(source, ext_info->send_buffer, FS_UPLOAD_PACKET_LEN,
+                                      info->send_len + ext_info->file_offset);
         if (res <= 0) {
             res = UPLOAD_FILE_READ_FAILED;
             break;
@@ -260,7 +304,7 @@ static int _http2_fs_part_send_sync(http2_file_stream_t *fs_node, stream_data_in
     return res;
 }
 
-void *_http2_fs_node_handle(http2_file_stream_t *fs_node)
+static void *_http2_fs_node_send(http2_file_stream_t *fs_node, void *source)
 {
     stream_handle_t *h2_handle = g_http2_fs_ctx.http2_handle;
     int filesize = 0;
@@ -278,7 +322,7 @@ void *_http2_fs_node_handle(http2_file_stream_t *fs_node)
     }
 
     /* get fileszie */
-    filesize = http2_stream_get_file_size(fs_node->file_path);
+    filesize = fs_node->source.size_cb(source);
     if (filesize <= 0) {
         if (fs_node->end_cb) {
             fs_node->end_cb(fs_node->file_path, UPLOAD_FILE_NOT_EXIST, fs_node->user_data);
@@ -341,7 +385,7 @@ void *_http2_fs_node_handle(http2_file_stream_t *fs_node)
         send_ext_info.part_len = ((upload_len - send_ext_info.file_offset) < part_len)?
                                 (upload_len - send_ext_info.file_offset): part_len;
 
-        res = _http2_fs_part_send_sync(fs_node, &channel_info, &send_ext_info);
+        res = _http2_fs_part_send_sync(fs_node, source, &channel_info, &send_ext_info);
         if (res < SUCCESS_RETURN) {
             h2_err("fs send return %d", res);
             break;
@@ -372,6 +416,26 @@ void *_http2_fs_node_handle(http2_file_stream_t *fs_node)
     return NULL;
 }
 
+void *_http2_fs_node_handle(http2_file_stream_t *fs_node)
+{
+    void *source = NULL;
+
+    /* data source stays open until the whole upload ends */
+    source = fs_node->source.open_cb(fs_node->file_path, fs_node->source.user_data);
+    if (source == NULL) {
+        if (fs_node->end_cb) {
+            fs_node->end_cb(fs_node->file_path, UPLOAD_FILE_NOT_EXIST, fs_node->user_data);
+        }
+
+        return NULL;
+    }
+
+    _http2_fs_node_send(fs_node, source);
+
+    fs_node->source.close_cb(source);
+    return NULL;
+}
+
 static void *http_upload_file_func(void *fs_data)
 {
     http2_file_stream_ctx_t *fs_ctx = (http2_file_stream_ctx_t *)fs_data;
@@ -515,6 +579,11 @@ int IOT_HTTP2_UploadFile_Request(void *http2_handle, http2_upload_params_t *para
         return UPLOAD_FILE_PATH_IS_NULL;
     }
 
+    if (params->source != NULL && (params->source->open_cb == NULL || params->source->size_cb == NULL ||
+                                   params->source->read_cb == NULL || params->source->close_cb == NULL)) {
+        return NULL_VALUE_ERROR;
+    }
+
     if ( (params->opt_bit_map & UPLOAD_FILE_OPT_BIT_RESUME) && params->upload_id == NULL) {
         return UPLOAD_ID_IS_NULL;
     }
@@ -536,6 +605,12 @@ int IOT_HTTP2_UploadFile_Request(void *http2_handle, http2_upload_params_t *para
     file_node->user_data = user_data;
     file_node->type = FS_TYPE_NORMAL;
     file_node->idx = g_http2_fs_ctx.upload_idx++;
+    if (params->source != NULL) {
+        memcpy(&file_node->source, params->source, sizeof(http2_upload_source_t));
+    }
+    else {
+        memcpy(&file_node->source, &g_http2_fs_file_source, sizeof(http2_upload_source_t));
+    }
 
     if (params->opt_bit_map & UPLOAD_FILE_OPT_BIT_SPECIFIC_LEN) {
         file_node->spec_len = params->upload_len;
@@ -26,6 +26,20 @@ typedef struct {
     int   port;
 } http2_upload_conn_info_t;
 
+/* data source of one upload, used instead of the local file at file_path when provided */
+typedef struct {
+    /* prepare the data named @file_path, return a handle passed to the other callbacks, NULL if failed */
+    void   *(*open_cb)(const char *file_path, void *user_data);
+    /* return total length of data, <= 0 if failed */
+    int     (*size_cb)(void *source);
+    /* read at most @len bytes at @offset into @buf, return length read, <= 0 if failed.
+       offset only goes forward contiguously, except that the first read starts where the server resumes */
+    int     (*read_cb)(void *source, char *buf, uint32_t len, uint32_t offset);
+    /* release the handle, called once whenever open_cb succeeded */
+    void    (*close_cb)(void *source);
+    void   *user_data;
+} http2_upload_source_t;
+
 /* file upload option define */
 typedef struct {
     const char *file_path;      /* file path, filename must be ASCII string and strlen < 2014 */
@@ -33,6 +47,7 @@ typedef struct {
     const char *upload_id;      /* a specific id used to indicate one upload session, only required when UPLOAD_FILE_OPT_BIT_RESUME option set */
     uint32_t upload_len;        /* used to indicate the upload length, only required when UPLOAD_FILE_OPT_BIT_SPECIFIC_LEN option set */
     uint32_t opt_bit_map;       /* option bit map, support UPLOAD_FILE_OPT_BIT_OVERWRITE, UPLOAD_FILE_OPT_BIT_RESUME and UPLOAD_FILE_OPT_BIT_SPECIFIC_LEN */
+    const http2_upload_source_t *source; /* optional data source, NULL to read file_path, file_path still names the remote file */
 } http2_upload_params_t;
 
 /* error code for file upload */
@@ -22,6 +22,9 @@ typedef struct {
     int length;
     int offset;
     int depth; /* How deeply nested (in arrays/objects) is the input at the current offset. */
+    lite_cjson_index_t *index; /* record every value into it if not NULL */
+    const char *key; /* key of the value about to be parsed, only used when recording */
+    int key_len;
 } parse_buffer;
 
 /* check if the given size is left to read in a given parse buffer (starting with 1) */
@@ -34,6 +37,7 @@ typedef struct {
 
 /* Predeclare these prototypes. */
 static int parse_value(lite_cjson_t *const item, parse_buffer *const input_buffer);
+static int parse_value_token(lite_cjson_t *const item, parse_buffer *const input_buffer);
 static int parse_string(lite_cjson_t *const item, parse_buffer *const input_buffer);
 static int parse_array(lite_cjson_t *const item, parse_buffer *const input_buffer);
 static int parse_object(lite_cjson_t *const item, parse_buffer *const input_buffer);
@@ -258,6 +262,8 @@ static int parse_object(lite_cjson_t *const item, parse_buffer *const input_buff
         /* parse the value */
         input_buffer->offset++;
         buffer_skip_whitespace(input_buffer);
+        input_buffer->key = current_item_key.value;
+        input_buffer->key_len = current_item_key.value_length;
         if (parse_value(&current_item_value, input_buffer) != 0) {
             goto fail; /* failed to parse value */
         }
@@ -413,7 +419,7 @@ fail:
 }
 
 /* Parser core - when encountering text, process appropriately. */
-static int parse_value(lite_cjson_t *const lite, parse_buffer *const input_buffer)
+static int parse_value_token(lite_cjson_t *const lite, parse_buffer *const input_buffer)
 {
     if ((input_buffer == NULL) || (input_buffer->content == NULL)) {
         return -1; /* no input */
@@ -474,6 +480,53 @@ static int parse_value(lite_cjson_t *const lite, parse_buffer *const input_buffe
     return -1;
 }
 
+static unsigned int _lite_cjson_key_hash(const char *key, int key_len)
+{
+    unsigned int hash = 2166136261u;
+    int index = 0;
+
+    for (index = 0; index < key_len; index++) {
+        hash ^= (unsigned char)key[index];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+static int parse_value(lite_cjson_t *const lite, parse_buffer *const input_buffer)
+{
+    lite_cjson_index_t *index = NULL;
+    lite_cjson_node_t *node = NULL;
+
+    if (input_buffer == NULL || input_buffer->index == NULL ||
+        (input_buffer->index->depth > 0 && input_buffer->depth > input_buffer->index->depth)) {
+        return parse_value_token(lite, input_buffer);
+    }
+    index = input_buffer->index;
+
+    /* nodes are taken in document order, keep counting when out of nodes to tell how many are needed */
+    if (index->count < index->size) {
+        node = &index->nodes[index->count];
+        node->key = input_buffer->key;
+        node->key_len = (input_buffer->key) ? (input_buffer->key_len) : (0);
+        node->key_hash = (input_buffer->key) ? (_lite_cjson_key_hash(node->key, node->key_len)) : (0);
+    }
+    index->count++;
+    input_buffer->key = NULL;
+    input_buffer->key_len = 0;
+
+    if (parse_value_token(lite, input_buffer) != 0) {
+        return -1;
+    }
+
+    if (node != NULL) {
+        memcpy(&node->item, lite, sizeof(lite_cjson_t));
+        node->next = index->count;
+    }
+
+    return 0;
+}
+
 int lite_cjson_parse(const char *src, int src_len, lite_cjson_t *lite)
 {
     parse_buffer buffer;
@@ -919,6 +972,343 @@ int lite_cjson_object_item_by_index(lite_cjson_t *lite, int index, lite_cjson_t
     return -1;
 }
 
+int lite_cjson_index_parse(const char *src, int src_len, lite_cjson_index_t *index)
+{
+    parse_buffer buffer;
+    lite_cjson_t lite;
+
+    if (!src || src_len <= 0 || !index || (!index->nodes && index->size > 0)) {
+        return -1;
+    }
+
+    memset(&buffer, 0, sizeof(parse_buffer));
+    memset(&lite, 0, sizeof(lite_cjson_t));
+    buffer.content = (const unsigned char *)src;
+    buffer.length = src_len;
+    buffer.offset = 0;
+    buffer.index = index;
+    index->count = 0;
+
+    if (parse_value(&lite, buffer_skip_whitespace(skip_utf8_bom(&buffer))) != 0) {
+        index->count = 0;
+        return -1;
+    }
+
+    if (index->count > index->size) {
+        return -1;
+    }
+
+    return 0;
+}
+
+static int _lite_cjson_index_child(lite_cjson_index_t *index, int node, int type)
+{
+    if (!index || !index->nodes || index->count > index->size || node < 0 || node >= index->count ||
+        index->nodes[node].item.type != type || index->nodes[node].item.size == 0 ||
+        index->nodes[node].next == node + 1) {
+        return -1; /* children of node are not recorded if it is below depth limit */
+    }
+
+    /* first child directly follows its container */
+    return node + 1;
+}
+
+int lite_cjson_index_object_item(lite_cjson_index_t *index, int node, const char *key, int key_len,
+                                 lite_cjson_t *lite_item)
+{
+    int child = 0;
+    int item_index = 0;
+    unsigned int key_hash = 0;
+    lite_cjson_node_t *current = NULL;
+
+    if (!key || key_len <= 0 || (child = _lite_cjson_index_child(index, node, cJSON_Object)) < 0) {
+        return -1;
+    }
+
+    key_hash = _lite_cjson_key_hash(key, key_len);
+    for (item_index = 0; item_index < index->nodes[node].item.size; item_index++) {
+        current = &index->nodes[child];
+        if (current->key_hash == key_hash && current->key_len == key_len &&
+            memcmp(current->key, key, key_len) == 0) {
+            if (lite_item) {
+                memcpy(lite_item, &current->item, sizeof(lite_cjson_t));
+            }
+            return child;
+        }
+        child = current->next;
+    }
+
+    return -1;
+}
+
+int lite_cjson_index_array_item(lite_cjson_index_t *index, int node, int item_index, lite_cjson_t *lite_item)
+{
+    int child = 0;
+
+    if ((child = _lite_cjson_index_child(index, node, cJSON_Array)) < 0 ||
+        item_index < 0 || item_index >= index->nodes[node].item.size) {
+        return -1;
+    }
+
+    while (item_index-- > 0) {
+        child = index->nodes[child].next;
+    }
+
+    if (lite_item) {
+        memcpy(lite_item, &index->nodes[child].item, sizeof(lite_cjson_t));
+    }
+
+    return child;
+}
+
+int lite_cjson_index_object_item_by_index(lite_cjson_index_t *index, int node, int item_index,
+        lite_cjson_t *lite_item_key, lite_cjson_t *lite_item_value)
+{
+    int child = 0;
+
+    if ((child = _lite_cjson_index_child(index, node, cJSON_Object)) < 0 ||
+        item_index < 0 || item_index >= index->nodes[node].item.size) {
+        return -1;
+    }
+
+    while (item_index-- > 0) {
+        child = index->nodes[child].next;
+    }
+
+    if (lite_item_key) {
+        memset(lite_item_key, 0, sizeof(lite_cjson_t));
+        lite_item_key->type = cJSON_String;
+        lite_item_key->value = (char *)index->nodes[child].key;
+        lite_item_key->value_length = index->nodes[child].key_len;
+    }
+    if (lite_item_value) {
+        memcpy(lite_item_value, &index->nodes[child].item, sizeof(lite_cjson_t));
+    }
+
+    return child;
+}
+
+/*** lite_cjson streaming writer ***/
+void lite_cjson_writer_init(lite_cjson_writer_t *writer, char *buf, int size)
+{
+    memset(writer, 0, sizeof(lite_cjson_writer_t));
+    writer->buf = buf;
+    writer->size = (buf == NULL) ? 0 : size;
+    if (writer->size > 0) {
+        writer->buf[0] = '\0';
+    }
+}
+
+static void _lite_cjson_writer_put(lite_cjson_writer_t *writer, const char *text, int text_len)
+{
+    int room = writer->size - 1 - writer->len;
+
+    if (room > 0) {
+        memcpy(writer->buf + writer->len, text, (text_len < room) ? text_len : room);
+    }
+    writer->len += text_len;
+}
+
+static void _lite_cjson_writer_putc(lite_cjson_writer_t *writer, char c)
+{
+    if (writer->len < writer->size - 1) {
+        writer->buf[writer->len] = c;
+    }
+    writer->len++;
+}
+
+/* separator in front of a key, or of a value which does not follow a key */
+static void _lite_cjson_writer_member(lite_cjson_writer_t *writer)
+{
+    if (writer->has_key) {
+        writer->has_key = 0;
+        return;
+    }
+    if (writer->members[writer->depth]) {
+        _lite_cjson_writer_putc(writer, ',');
+    }
+    writer->members[writer->depth] = 1;
+}
+
+static void _lite_cjson_writer_escaped(lite_cjson_writer_t *writer, const char *text, int text_len)
+{
+    static const char hex[] = "0123456789abcdef";
+    char escape[6] = {'\\', 'u', '0', '0', 0, 0};
+    int index = 0, start = 0;
+    unsigned char c = 0;
+
+    _lite_cjson_writer_putc(writer, '\"');
+    for (index = 0; index < text_len; index++) {
+        c = (unsigned char)text[index];
+        if (c >= 0x20 && c != '\"' && c != '\\') {
+            continue;
+        }
+        _lite_cjson_writer_put(writer, text + start, index - start);
+        start = index + 1;
+        switch (c) {
+            case '\"':
+            case '\\':
+                escape[1] = c;
+                _lite_cjson_writer_put(writer, escape, 2);
+                break;
+            case '\b':
+                _lite_cjson_writer_put(writer, "\\b", 2);
+                break;
+            case '\f':
+                _lite_cjson_writer_put(writer, "\\f", 2);
+                break;
+            case '\n':
+                _lite_cjson_writer_put(writer, "\\n", 2);
+                break;
+            case '\r':
+                _lite_cjson_writer_put(writer, "\\r", 2);
+                break;
+            case '\t':
+                _lite_cjson_writer_put(writer, "\\t", 2);
+                break;
+            default:
+                escape[1] = 'u';
+                escape[4] = hex[c >> 4];
+                escape[5] = hex[c & 0x0F];
+                _lite_cjson_writer_put(writer, escape, 6);
+                break;
+        }
+    }
+    _lite_cjson_writer_put(writer, text + start, index - start);
+    _lite_cjson_writer_putc(writer, '\"');
+}
+
+static int _lite_cjson_writer_digits(int value, char text[12])
+{
+    unsigned int magnitude = (value < 0) ? 0u - (unsigned int)value : (unsigned int)value;
+    int offset = 12;
+
+    do {
+        text[--offset] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+    if (value < 0) {
+        text[--offset] = '-';
+    }
+
+    return offset;
+}
+
+static void _lite_cjson_writer_begin(lite_cjson_writer_t *writer, char c)
+{
+    _lite_cjson_writer_member(writer);
+    if (writer->depth + 1 >= LITE_CJSON_WRITER_DEPTH) {
+        writer->error = 1;
+        return;
+    }
+    _lite_cjson_writer_putc(writer, c);
+    writer->members[++writer->depth] = 0;
+}
+
+static void _lite_cjson_writer_end(lite_cjson_writer_t *writer, char c)
+{
+    if (writer->depth == 0 || writer->has_key) {
+        writer->error = 1;
+        return;
+    }
+    _lite_cjson_writer_putc(writer, c);
+    writer->depth--;
+}
+
+void lite_cjson_writer_object_begin(lite_cjson_writer_t *writer)
+{
+    _lite_cjson_writer_begin(writer, '{');
+}
+
+void lite_cjson_writer_object_end(lite_cjson_writer_t *writer)
+{
+    _lite_cjson_writer_end(writer, '}');
+}
+
+void lite_cjson_writer_array_begin(lite_cjson_writer_t *writer)
+{
+    _lite_cjson_writer_begin(writer, '[');
+}
+
+void lite_cjson_writer_array_end(lite_cjson_writer_t *writer)
+{
+    _lite_cjson_writer_end(writer, ']');
+}
+
+void lite_cjson_writer_key(lite_cjson_writer_t *writer, const char *key, int key_len)
+{
+    if (writer->depth == 0 || writer->has_key) {
+        writer->error = 1;
+        return;
+    }
+    _lite_cjson_writer_member(writer);
+    _lite_cjson_writer_escaped(writer, key, key_len);
+    _lite_cjson_writer_putc(writer, ':');
+    writer->has_key = 1;
+}
+
+void lite_cjson_writer_string(lite_cjson_writer_t *writer, const char *value, int value_len)
+{
+    _lite_cjson_writer_member(writer);
+    if (value == NULL) {
+        _lite_cjson_writer_put(writer, "null", 4);
+        return;
+    }
+    _lite_cjson_writer_escaped(writer, value, value_len);
+}
+
+void lite_cjson_writer_int(lite_cjson_writer_t *writer, int value)
+{
+    char text[12];
+    int offset = _lite_cjson_writer_digits(value, text);
+
+    _lite_cjson_writer_member(writer);
+    _lite_cjson_writer_put(writer, text + offset, 12 - offset);
+}
+
+void lite_cjson_writer_int_string(lite_cjson_writer_t *writer, int value)
+{
+    char text[12];
+    int offset = _lite_cjson_writer_digits(value, text);
+
+    _lite_cjson_writer_member(writer);
+    _lite_cjson_writer_putc(writer, '\"');
+    _lite_cjson_writer_put(writer, text + offset, 12 - offset);
+    _lite_cjson_writer_putc(writer, '\"');
+}
+
+void lite_cjson_writer_bool(lite_cjson_writer_t *writer, int value)
+{
+    _lite_cjson_writer_member(writer);
+    if (value) {
+        _lite_cjson_writer_put(writer, "true", 4);
+    } else {
+        _lite_cjson_writer_put(writer, "false", 5);
+    }
+}
+
+void lite_cjson_writer_raw(lite_cjson_writer_t *writer, const char *json, int json_len)
+{
+    _lite_cjson_writer_member(writer);
+    _lite_cjson_writer_put(writer, json, json_len);
+}
+
+int lite_cjson_writer_end(lite_cjson_writer_t *writer)
+{
+    if (writer->size > 0) {
+        writer->buf[(writer->len < writer->size) ? writer->len : writer->size - 1] = '\0';
+    }
+
+    if (writer->error || writer->depth != 0 || writer->has_key) {
+        return -1;
+    }
+    if (writer->len >= writer->size) {
+        return -2;
+    }
+
+    return 0;
+}
+
 /*** cjson create, add and print ***/
 #if defined(DEVICE_MODEL_GATEWAY) || defined(ALCS_ENABLED) || defined(DEPRECATED_LINKKIT)
 #define true ((cJSON_bool)1)
@@ -1720,21 +2110,26 @@ lite_cjson_item_t *lite_cjson_create_bool(cJSON_bool b)
     return item;
 }
 
+static void cJSON_Set_Number(lite_cjson_item_t *item, double num)
+{
+    item->type = cJSON_Number;
+    item->valuedouble = num;
+
+    /* use saturation in case of overflow */
+    if (num >= INT_MAX) {
+        item->valueint = INT_MAX;
+    } else if (num <= INT_MIN) {
+        item->valueint = INT_MIN;
+    } else {
+        item->valueint = (int)num;
+    }
+}
+
 lite_cjson_item_t *lite_cjson_create_number(double num)
 {
     lite_cjson_item_t *item = cJSON_New_Item(&global_hooks);
     if (item) {
-        item->type = cJSON_Number;
-        item->valuedouble = num;
-
-        /* use saturation in case of overflow */
-        if (num >= INT_MAX) {
-            item->valueint = INT_MAX;
-        } else if (num <= INT_MIN) {
-            item->valueint = INT_MIN;
-        } else {
-            item->valueint = (int)num;
-        }
+        cJSON_Set_Number(item, num);
     }
 
     return item;
@@ -1892,6 +2287,206 @@ lite_cjson_item_t *lite_cjson_create_stringArray(const char **strings, int count
 
     return a;
 }
+
+/*** lite_cjson arena ***/
+
+/* header of block allocated by arena, sized so that items after it are aligned as a double */
+typedef union lite_cjson_arena_block_st {
+    union lite_cjson_arena_block_st *next;
+    double align;
+} lite_cjson_arena_block_t;
+
+#define LITE_CJSON_ARENA_ALIGN (sizeof(lite_cjson_arena_block_t))
+
+void lite_cjson_arena_init(lite_cjson_arena_t *arena, void *buf, unsigned int size)
+{
+    if (arena == NULL) {
+        return;
+    }
+
+    memset(arena, 0, sizeof(lite_cjson_arena_t));
+    if (buf != NULL) {
+        arena->buf = (unsigned char *)buf;
+        arena->size = size;
+    }
+}
+
+void lite_cjson_arena_deinit(lite_cjson_arena_t *arena)
+{
+    lite_cjson_arena_block_t *block = NULL, *next = NULL;
+
+    if (arena == NULL) {
+        return;
+    }
+
+    for (block = (lite_cjson_arena_block_t *)arena->blocks; block != NULL; block = next) {
+        next = block->next;
+        global_hooks.deallocate(block);
+    }
+    memset(arena, 0, sizeof(lite_cjson_arena_t));
+}
+
+static void *arena_allocate(lite_cjson_arena_t *arena, size_t size)
+{
+    size_t pad = 0, block_size = 0;
+    lite_cjson_arena_block_t *block = NULL;
+    unsigned char *pointer = NULL;
+
+    if (arena->buf != NULL) {
+        pad = (LITE_CJSON_ARENA_ALIGN - (size_t)(arena->buf + arena->used) % LITE_CJSON_ARENA_ALIGN) % LITE_CJSON_ARENA_ALIGN;
+    }
+
+    if (arena->buf == NULL || arena->used + pad + size > arena->size) {
+        /* rest of current block is left unused, an item larger than a block gets a block of its own */
+        block_size = (size > LITE_CJSON_ARENA_BLOCK_SIZE) ? size : LITE_CJSON_ARENA_BLOCK_SIZE;
+        block = (lite_cjson_arena_block_t *)global_hooks.allocate(sizeof(lite_cjson_arena_block_t) + block_size);
+        if (block == NULL) {
+            return NULL;
+        }
+        block->next = (lite_cjson_arena_block_t *)arena->blocks;
+        arena->blocks = block;
+        arena->buf = (unsigned char *)(block + 1);
+        arena->size = block_size;
+        arena->used = 0;
+        pad = 0;
+    }
+
+    pointer = arena->buf + arena->used + pad;
+    arena->used += pad + size;
+
+    return pointer;
+}
+
+static lite_cjson_item_t *arena_new_item(lite_cjson_arena_t *arena, int type)
+{
+    lite_cjson_item_t *item = (lite_cjson_item_t *)arena_allocate(arena, sizeof(lite_cjson_item_t));
+    if (item) {
+        memset(item, '\0', sizeof(lite_cjson_item_t));
+        item->type = type;
+    }
+
+    return item;
+}
+
+static char *arena_strdup(lite_cjson_arena_t *arena, const char *string)
+{
+    size_t length = 0;
+    char *copy = NULL;
+
+    if (string == NULL) {
+        return NULL;
+    }
+
+    length = strlen(string) + sizeof("");
+    copy = (char *)arena_allocate(arena, length);
+    if (copy == NULL) {
+        return NULL;
+    }
+    memcpy(copy, string, length);
+
+    return copy;
+}
+
+void lite_cjson_arena_delete(lite_cjson_arena_t *arena, lite_cjson_item_t *item)
+{
+    /* item of arena is released with the arena */
+    if (arena == NULL) {
+        lite_cjson_delete(item);
+    }
+}
+
+void lite_cjson_arena_add_item_to_object(lite_cjson_arena_t *arena, lite_cjson_item_t *object, const char *string,
+        lite_cjson_item_t *item)
+{
+    char *key = NULL;
+
+    if (arena == NULL) {
+        lite_cjson_add_item_to_object(object, string, item);
+        return;
+    }
+
+    if ((object == NULL) || (string == NULL) || (item == NULL)) {
+        return;
+    }
+
+    /* a constant key is never freed, which is right for a key living in arena */
+    key = arena_strdup(arena, string);
+    if (key == NULL) {
+        return;
+    }
+    add_item_to_object(object, key, item, &global_hooks, true);
+}
+
+lite_cjson_item_t *lite_cjson_arena_create_null(lite_cjson_arena_t *arena)
+{
+    if (arena == NULL) {
+        return lite_cjson_create_null();
+    }
+
+    return arena_new_item(arena, cJSON_NULL);
+}
+
+lite_cjson_item_t *lite_cjson_arena_create_bool(lite_cjson_arena_t *arena, cJSON_bool b)
+{
+    if (arena == NULL) {
+        return lite_cjson_create_bool(b);
+    }
+
+    return arena_new_item(arena, b ? cJSON_True : cJSON_False);
+}
+
+lite_cjson_item_t *lite_cjson_arena_create_number(lite_cjson_arena_t *arena, double num)
+{
+    lite_cjson_item_t *item = NULL;
+
+    if (arena == NULL) {
+        return lite_cjson_create_number(num);
+    }
+
+    item = arena_new_item(arena, cJSON_Number);
+    if (item) {
+        cJSON_Set_Number(item, num);
+    }
+
+    return item;
+}
+
+lite_cjson_item_t *lite_cjson_arena_create_string(lite_cjson_arena_t *arena, const char *string)
+{
+    lite_cjson_item_t *item = NULL;
+
+    if (arena == NULL) {
+        return lite_cjson_create_string(string);
+    }
+
+    item = arena_new_item(arena, cJSON_String);
+    if (item) {
+        item->valuestring = arena_strdup(arena, string);
+        if (!item->valuestring) {
+            return NULL;
+        }
+    }
+
+    return item;
+}
+
+lite_cjson_item_t *lite_cjson_arena_create_array(lite_cjson_arena_t *arena)
+{
+    if (arena == NULL) {
+        return lite_cjson_create_array();
+    }
+
+    return arena_new_item(arena, cJSON_Array);
+}
+
+lite_cjson_item_t *lite_cjson_arena_create_object(lite_cjson_arena_t *arena)
+{
+    if (arena == NULL) {
+        return lite_cjson_create_object();
+    }
+
+    return arena_new_item(arena, cJSON_Object);
+}
 #endif
 #endif
 
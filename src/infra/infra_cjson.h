@@ -58,6 +58,132 @@ int lite_cjson_object_item_by_index(
             lite_cjson_t *lite_item_key,
             lite_cjson_t *lite_item_value);
 
+/*** lite_cjson structural index ***/
+
+/*
+ * Every lookup above rescans the container text from its opening bracket, so pulling N fields out
+ * of one payload costs N passes over it. The index records every value of a document in a single
+ * parse, in document order, as a tape of nodes. Node 0 is the root, the children of a container
+ * directly follow it and each node knows where its subtree ends, so walking the members of a
+ * container touches one node per member whatever their size, and keys are matched by hash first.
+ *
+ * With depth limited, containers below the limit are recorded as a whole and their children can not be
+ * looked up through the index, which keeps a small fixed node array enough for the top level members.
+ *
+ * Nodes point into the parsed text, which must stay valid while the index is used.
+ */
+typedef struct {
+    lite_cjson_t item;
+    const char *key;            /* raw key text if node is a member of object, otherwise NULL */
+    int key_len;
+    unsigned int key_hash;
+    int next;                   /* node following the subtree of this node, i.e. its next sibling if any */
+} lite_cjson_node_t;
+
+typedef struct {
+    lite_cjson_node_t *nodes;   /* provided by caller */
+    int size;                   /* capacity of nodes */
+    int depth;                  /* levels of containers whose children are recorded, 0 for all levels */
+    int count;                  /* nodes of document, may exceed size when build fails for capacity */
+} lite_cjson_index_t;
+
+/**
+ * @brief Parse a document and record its structure into @index.
+ *
+ * @param [in] src: json text.
+ * @param [in] src_len: length of @src.
+ * @param [in] index: index with nodes, size and depth set by caller.
+ *
+ * @return 0 when success, -1 if @src is invalid or there are not enough nodes,
+ *         in the latter case index->count is the number of nodes needed.
+ */
+int lite_cjson_index_parse(const char *src, int src_len, lite_cjson_index_t *index);
+
+/**
+ * @brief Get member of object node @node by key, nested key like "a.b" or "a[1]" is not supported,
+ *        look up each level in turn with the returned node instead.
+ *
+ * @param [in] index: index built by lite_cjson_index_parse.
+ * @param [in] node: node of object, 0 for root.
+ * @param [in] key: raw key text.
+ * @param [in] key_len: length of @key.
+ * @param [out] lite_item: value of member, can be NULL.
+ *
+ * @return node of member, -1 if not found or children of @node are not recorded.
+ */
+int lite_cjson_index_object_item(lite_cjson_index_t *index, int node, const char *key, int key_len,
+                                 lite_cjson_t *lite_item);
+
+/**
+ * @brief Get element of array node @node by position.
+ *
+ * @return node of element, -1 if not found.
+ */
+int lite_cjson_index_array_item(lite_cjson_index_t *index, int node, int item_index, lite_cjson_t *lite_item);
+
+/**
+ * @brief Get member of object node @node by position.
+ *
+ * @return node of member, -1 if not found.
+ */
+int lite_cjson_index_object_item_by_index(lite_cjson_index_t *index, int node, int item_index,
+        lite_cjson_t *lite_item_key, lite_cjson_t *lite_item_value);
+
+/*** lite_cjson streaming writer ***/
+
+/*
+ * Writes json text straight into a buffer of caller, separators are put in and strings are escaped
+ * as they are written, so the text is well formed by construction and needs no parse to check it.
+ * Nothing is allocated: once the buffer is full the writer keeps counting, and after
+ * lite_cjson_writer_end() @len is the length of the whole text, so a caller can start with a small
+ * stack buffer and write again into one of exactly that size plus one only when it did not fit.
+ *
+ * Raw text given to lite_cjson_writer_raw() is copied as is, it must be valid json itself.
+ */
+#ifndef LITE_CJSON_WRITER_DEPTH
+    #define LITE_CJSON_WRITER_DEPTH (16)
+#endif
+
+typedef struct {
+    char *buf;                  /* provided by caller, can be NULL to only count */
+    int size;                   /* capacity of buf including terminating '\0' */
+    int len;                    /* length of text written so far, may exceed size - 1 */
+    int depth;                  /* containers open */
+    int has_key;                /* key written, its value comes next */
+    int error;                  /* containers mismatched or nested too deep */
+    unsigned char members[LITE_CJSON_WRITER_DEPTH];  /* whether each open container has a member already */
+} lite_cjson_writer_t;
+
+void lite_cjson_writer_init(lite_cjson_writer_t *writer, char *buf, int size);
+void lite_cjson_writer_object_begin(lite_cjson_writer_t *writer);
+void lite_cjson_writer_object_end(lite_cjson_writer_t *writer);
+void lite_cjson_writer_array_begin(lite_cjson_writer_t *writer);
+void lite_cjson_writer_array_end(lite_cjson_writer_t *writer);
+
+/* key of next member of object, @key is escaped */
+void lite_cjson_writer_key(lite_cjson_writer_t *writer, const char *key, int key_len);
+
+/* @value is escaped, a NULL @value writes null */
+void lite_cjson_writer_string(lite_cjson_writer_t *writer, const char *value, int value_len);
+void lite_cjson_writer_int(lite_cjson_writer_t *writer, int value);
+
+/* decimal @value written as string, like "id":"123" of alink messages */
+void lite_cjson_writer_int_string(lite_cjson_writer_t *writer, int value);
+void lite_cjson_writer_bool(lite_cjson_writer_t *writer, int value);
+
+/* @json is valid json text, copied without check */
+void lite_cjson_writer_raw(lite_cjson_writer_t *writer, const char *json, int json_len);
+
+/**
+ * @brief Terminate the text with '\0'.
+ *
+ * @param [in] writer: the writer.
+ *
+ * @return 0 when the whole text is in buf, -1 if containers are left open or mismatched,
+ *         -2 if buf is too small, in which case writer->len + 1 bytes are needed.
+ */
+int lite_cjson_writer_end(lite_cjson_writer_t *writer);
+
 
 /*** lite_cjson create, add and print ***/
 typedef int cJSON_bool;
@@ -122,5 +248,61 @@ lite_cjson_item_t *lite_cjson_create_stringArray(const char **strings, int count
 #define lite_cjson_add_bool_to_object(object,name,b)        lite_cjson_add_item_to_object(object, name, lite_cjson_create_bool(b))
 #define lite_cjson_add_number_to_object(object,name,n)      lite_cjson_add_item_to_object(object, name, lite_cjson_create_number(n))
 #define lite_cjson_add_string_to_object(object,name,s)      lite_cjson_add_item_to_object(object, name, lite_cjson_create_string(s))
+
+/*** lite_cjson arena ***/
+
+/*
+ * Items created by the calls below, their keys and strings included, are carved out of the blocks of
+ * an arena one after another instead of being allocated one by one, and a whole document goes away
+ * with lite_cjson_arena_deinit(). The first block can be given by caller, on stack for example, more
+ * blocks of LITE_CJSON_ARENA_BLOCK_SIZE are allocated only once it is used up.
+ *
+ * A document built in an arena must hold items of that arena only and is never passed to
+ * lite_cjson_delete(), lite_cjson_arena_delete() drops an item not added to it instead.
+ * With @arena NULL each call is the same as its lite_cjson_create_ or lite_cjson_add_ counterpart,
+ * so code can build a document either way.
+ */
+#ifndef LITE_CJSON_ARENA_BLOCK_SIZE
+    #define LITE_CJSON_ARENA_BLOCK_SIZE (512)
+#endif
+
+typedef struct {
+    unsigned char *buf;         /* block items are carved out of */
+    unsigned int size;          /* capacity of buf */
+    unsigned int used;          /* bytes of buf given out */
+    void *blocks;               /* blocks allocated by arena, freed by lite_cjson_arena_deinit() */
+} lite_cjson_arena_t;
+
+/**
+ * @brief Start an arena.
+ *
+ * @param [in] arena: the arena.
+ * @param [in] buf: first block, can be NULL.
+ * @param [in] size: size of @buf.
+ */
+void lite_cjson_arena_init(lite_cjson_arena_t *arena, void *buf, unsigned int size);
+
+/**
+ * @brief Release all items of @arena at once.
+ */
+void lite_cjson_arena_deinit(lite_cjson_arena_t *arena);
+
+/* drop @item not added to a document, only lite_cjson_delete() it if @arena is NULL */
+void lite_cjson_arena_delete(lite_cjson_arena_t *arena, lite_cjson_item_t *item);
+
+/* @string is copied into @arena */
+void lite_cjson_arena_add_item_to_object(lite_cjson_arena_t *arena, lite_cjson_item_t *object, const char *string,
+        lite_cjson_item_t *item);
+
+lite_cjson_item_t *lite_cjson_arena_create_null(lite_cjson_arena_t *arena);
+lite_cjson_item_t *lite_cjson_arena_create_bool(lite_cjson_arena_t *arena, int b);
+lite_cjson_item_t *lite_cjson_arena_create_number(lite_cjson_arena_t *arena, double num);
+lite_cjson_item_t *lite_cjson_arena_create_string(lite_cjson_arena_t *arena, const char *string);
+lite_cjson_item_t *lite_cjson_arena_create_array(lite_cjson_arena_t *arena);
+lite_cjson_item_t *lite_cjson_arena_create_object(lite_cjson_arena_t *arena);
+
+#define lite_cjson_arena_add_bool_to_object(arena,object,name,b)    lite_cjson_arena_add_item_to_object(arena, object, name, lite_cjson_arena_create_bool(arena, b))
+#define lite_cjson_arena_add_number_to_object(arena,object,name,n)  lite_cjson_arena_add_item_to_object(arena, object, name, lite_cjson_arena_create_number(arena, n))
+#define lite_cjson_arena_add_string_to_object(arena,object,name,s)  lite_cjson_arena_add_item_to_object(arena, object, name, lite_cjson_arena_create_string(arena, s))
 #endif
 
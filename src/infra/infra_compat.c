@@ -145,6 +145,14 @@ int IOT_Ioctl(int option, void *data)
             res = iotx_dm_set_opt(IMPL_LINKKIT_IOCTL_SWITCH_PROPERTY_SET_REPLY, data);
         }
         break;
+        case IOTX_IOCTL_SET_PROP_REPORT_WINDOW: {
+            res = iotx_dm_set_opt(IMPL_LINKKIT_IOCTL_PROPERTY_REPORT_WINDOW_MS, data);
+        }
+        break;
+        case IOTX_IOCTL_SET_PROP_REPORT_DELTA: {
+            res = iotx_dm_set_opt(IMPL_LINKKIT_IOCTL_PROPERTY_REPORT_DELTA, data);
+        }
+        break;
 #endif
         case IOTX_IOCTL_SET_SUBDEV_SIGN: {
             /* todo */
@@ -167,6 +175,8 @@ int IOT_Ioctl(int option, void *data)
         case IOTX_IOCTL_RECV_EVENT_REPLY:
         case IOTX_IOCTL_RECV_PROP_REPLY:
         case IOTX_IOCTL_SEND_PROP_SET_REPLY:
+        case IOTX_IOCTL_SET_PROP_REPORT_WINDOW:
+        case IOTX_IOCTL_SET_PROP_REPORT_DELTA:
         case IOTX_IOCTL_GET_SUBDEV_LOGIN: {
             res = SUCCESS_RETURN;
         }
@@ -230,13 +230,17 @@ typedef enum {
     IOTX_IOCTL_SEND_PROP_SET_REPLY,     /* value(int*): 0 - Disable send post set reply by devid; 1 - Enable property set reply by devid */
     IOTX_IOCTL_SET_SUBDEV_SIGN,         /* value(const char*): only for slave device, set signature of subdevice */
     IOTX_IOCTL_GET_SUBDEV_LOGIN,        /* value(int*): 0 - SubDev is logout; 1 - SubDev is login */
-    IOTX_IOCTL_SET_OTA_DEV_ID           /* value(int*):     select the device to do OTA according to devid */
+    IOTX_IOCTL_SET_OTA_DEV_ID,          /* value(int*):     select the device to do OTA according to devid */
+    IOTX_IOCTL_SET_PROP_REPORT_WINDOW,  /* value(int*): milliseconds within which property posts of a device are merged into one, 0 - Disable */
+    IOTX_IOCTL_SET_PROP_REPORT_DELTA    /* value(int*): 0 - Report every merged value; 1 - Leave out values unchanged since last report */
 } iotx_ioctl_option_t;
 
 typedef enum {
     IMPL_LINKKIT_IOCTL_SWITCH_PROPERTY_POST_REPLY,           /* only for master device, choose whether you need receive property post reply message */
     IMPL_LINKKIT_IOCTL_SWITCH_EVENT_POST_REPLY,              /* only for master device, choose whether you need receive event post reply message */
     IMPL_LINKKIT_IOCTL_SWITCH_PROPERTY_SET_REPLY,            /* only for master device, choose whether you need send property set reply message */
+    IMPL_LINKKIT_IOCTL_PROPERTY_REPORT_WINDOW_MS,            /* merge property posts of a device within window in milliseconds */
+    IMPL_LINKKIT_IOCTL_PROPERTY_REPORT_DELTA,                /* leave unchanged values out of merged property post */
     IMPL_LINKKIT_IOCTL_MAX
 } impl_linkkit_ioctl_cmd_t;
 
@@ -81,6 +81,8 @@ typedef enum IOT_RETURN_CODES {
     ERROR_NET_CONN = -301,
     ERROR_NET_UNKNOWN_HOST = -300,
 
+    MQTT_OUTBOX_FULL = -49,/** outbox is full and its oldest message can not be dropped */
+    MQTT_PUBLISH_WOULD_BLOCK = -48,/** QoS1 publish refused as inflight window is full, retry after some PUBACK */
     MQTT_SUBHANDLE_LIST_LEN_TOO_SHORT = -47,
     MQTT_OFFLINE_LIST_LEN_TOO_SHORT = -46,
     MQTT_TOPIC_LEN_TOO_SHORT = -45,
@@ -278,9 +278,114 @@ int utils_net_write(utils_network_pt pNetwork, const char *buffer, uint32_t len,
     return ret;
 }
 
+static void _net_read_ahead_reset(utils_network_pt pNetwork)
+{
+    /* data staged from previous connection is meaningless for the next one */
+    pNetwork->rbuf_head = 0;
+    pNetwork->rbuf_tail = 0;
+}
+
+int utils_net_read_buffered(utils_network_pt pNetwork, char *buffer, uint32_t len, uint32_t timeout_ms)
+{
+    int         ret = 0;
+    uint32_t    copied = 0;
+    uint32_t    need = 0;
+    uint32_t    filled = 0;
+
+    if (NULL == pNetwork || NULL == buffer) {
+        net_err("parameter error! pNetwork=%p, buffer = %p", pNetwork, buffer);
+        return -1;
+    }
+
+    if (NULL == pNetwork->rbuf) {
+        return utils_net_read(pNetwork, buffer, len, timeout_ms);
+    }
+
+    /* 1. serve as much as possible from data staged before */
+    if (pNetwork->rbuf_tail > pNetwork->rbuf_head) {
+        copied = pNetwork->rbuf_tail - pNetwork->rbuf_head;
+        copied = (copied > len) ? len : copied;
+        memcpy(buffer, pNetwork->rbuf + pNetwork->rbuf_head, copied);
+        pNetwork->rbuf_head += copied;
+    }
+    if (pNetwork->rbuf_head == pNetwork->rbuf_tail) {
+        _net_read_ahead_reset(pNetwork);
+    }
+    if (copied == len) {
+        return copied;
+    }
+
+    need = len - copied;
+
+    /* 2. request which can not be staged, read straight into caller's buffer */
+    if (need >= pNetwork->rbuf_size) {
+        ret = utils_net_read(pNetwork, buffer + copied, need, timeout_ms);
+        if (ret > 0) {
+            return copied + ret;
+        }
+        return (copied > 0) ? copied : ret;
+    }
+
+    /* 3. wait for what the caller needs, then top up with whatever the peer has sent already */
+    ret = utils_net_read(pNetwork, pNetwork->rbuf, need, timeout_ms);
+    if (ret <= 0) {
+        return (copied > 0) ? copied : ret;
+    }
+    filled = ret;
+
+    if (filled == need) {
+        uint32_t drain_ms = IOTX_NET_READ_AHEAD_DRAIN_MS;
+#if defined(SUPPORT_TLS) || defined(SUPPORT_ITLS)
+        /* timeout 0 of TLS read means waiting forever */
+        drain_ms = (drain_ms == 0) ? 1 : drain_ms;
+#endif
+        ret = utils_net_read(pNetwork, pNetwork->rbuf + filled, pNetwork->rbuf_size - filled, drain_ms);
+        /* errors of the top up read will be reported by the next read */
+        if (ret > 0) {
+            filled += ret;
+        }
+    }
+
+    need = (filled > need) ? need : filled;
+    memcpy(buffer + copied, pNetwork->rbuf, need);
+    pNetwork->rbuf_head = need;
+    pNetwork->rbuf_tail = filled;
+    if (pNetwork->rbuf_head == pNetwork->rbuf_tail) {
+        _net_read_ahead_reset(pNetwork);
+    }
+
+    return copied + need;
+}
+
+uint32_t utils_net_read_pending(utils_network_pt pNetwork)
+{
+    if (NULL == pNetwork || NULL == pNetwork->rbuf) {
+        return 0;
+    }
+
+    return pNetwork->rbuf_tail - pNetwork->rbuf_head;
+}
+
+int iotx_net_set_read_ahead(utils_network_pt pNetwork, char *buf, uint32_t size)
+{
+    if (NULL == pNetwork || NULL == buf || 0 == size) {
+        net_err("parameter error! pNetwork=%p, buf = %p, size = %u", pNetwork, buf, size);
+        return -1;
+    }
+
+    pNetwork->rbuf = buf;
+    pNetwork->rbuf_size = size;
+    _net_read_ahead_reset(pNetwork);
+    pNetwork->read = utils_net_read_buffered;
+
+    return 0;
+}
+
 int iotx_net_disconnect(utils_network_pt pNetwork)
 {
     int     ret = 0;
+
+    _net_read_ahead_reset(pNetwork);
 #ifdef SUPPORT_TLS
     if (NULL != pNetwork->ca_crt) {
         ret = disconnect_ssl(pNetwork);
@@ -305,6 +410,8 @@ int iotx_net_disconnect(utils_network_pt pNetwork)
 int iotx_net_connect(utils_network_pt pNetwork)
 {
     int     ret = 0;
+
+    _net_read_ahead_reset(pNetwork);
 #ifdef SUPPORT_TLS
     if (NULL != pNetwork->ca_crt) {
         ret = connect_ssl(pNetwork);
@@ -343,6 +450,9 @@ int iotx_net_init(utils_network_pt pNetwork, const char *host, uint16_t port, co
     }
 
     pNetwork->handle = 0;
+    pNetwork->rbuf = NULL;
+    pNetwork->rbuf_size = 0;
+    _net_read_ahead_reset(pNetwork);
     pNetwork->read = utils_net_read;
     pNetwork->write = utils_net_write;
     pNetwork->disconnect = iotx_net_disconnect;
@@ -38,14 +38,42 @@ struct utils_network {
 
     /**< Establish the network */
     int (*connect)(utils_network_pt);
+
+    /**< NULL, unbuffered read; NOT NULL, read-ahead buffer which socket data is staged in */
+    char *rbuf;
+    uint32_t rbuf_size;
+    uint32_t rbuf_head;
+    uint32_t rbuf_tail;
 };
 
+/* Time in millisecond to wait for more data when topping up the read-ahead buffer,
+ * 0 if HAL_TCP_Read() of the platform returns data already queued when timeout is 0 */
+#ifndef IOTX_NET_READ_AHEAD_DRAIN_MS
+    #define IOTX_NET_READ_AHEAD_DRAIN_MS        (1)
+#endif
+
 int utils_net_read(utils_network_pt pNetwork, char *buffer, uint32_t len, uint32_t timeout_ms);
 int utils_net_write(utils_network_pt pNetwork, const char *buffer, uint32_t len, uint32_t timeout_ms);
 int iotx_net_disconnect(utils_network_pt pNetwork);
 int iotx_net_connect(utils_network_pt pNetwork);
 int iotx_net_init(utils_network_pt pNetwork, const char *host, uint16_t port, const char *ca_crt);
 
+/**
+ * @brief Attach a read-ahead buffer to the network connection.
+ *        After this, pNetwork->read fills @buf from the socket in large chunks and serves
+ *        small reads (such as MQTT fixed header bytes) from memory instead of the HAL.
+ *
+ * @param [in] pNetwork: network connection which has been initialized by iotx_net_init().
+ * @param [in] buf: buffer owned by the caller, it must stay valid until the connection is released.
+ * @param [in] size: size of @buf in byte.
+ *
+ * @retval  0 : success.
+ * @retval -1 : failure.
+ */
+int iotx_net_set_read_ahead(utils_network_pt pNetwork, char *buf, uint32_t size);
+int utils_net_read_buffered(utils_network_pt pNetwork, char *buffer, uint32_t len, uint32_t timeout_ms);
+uint32_t utils_net_read_pending(utils_network_pt pNetwork);
+
 #endif /* IOTX_COMMON_NET_H */
 
 
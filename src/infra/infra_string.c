@@ -40,11 +40,22 @@ void infra_int2str(uint32_t input, char output[10])
 
 char *infra_strtok(char *str, const char *delim)
 {
-    int only_delim = 1;
     static char *pos = NULL;
-    static char *target = NULL;
 
-    pos = (str == NULL)?(pos):(str);
+    return infra_strtok_r(str, delim, &pos);
+}
+
+char *infra_strtok_r(char *str, const char *delim, char **saveptr)
+{
+    int only_delim = 1;
+    char *pos = NULL;
+    char *target = NULL;
+
+    if (saveptr == NULL) {
+        return NULL;
+    }
+    pos = (str == NULL)?(*saveptr):(str);
+    *saveptr = pos;
 
     if (pos == NULL || delim == NULL ||
         strlen(pos) <= strlen(delim)) {
@@ -61,6 +72,7 @@ char *infra_strtok(char *str, const char *delim)
 
         if (strlen(pos) == strlen(delim)) {
             memset(pos,0,strlen(delim));
+            *saveptr = pos;
             if (only_delim) {
                 return NULL;
             }
@@ -77,6 +89,7 @@ char *infra_strtok(char *str, const char *delim)
         }
     }
 
+    *saveptr = pos;
     return target;
 }
 
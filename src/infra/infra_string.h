@@ -7,6 +7,8 @@ int8_t infra_hex2char(uint8_t hex);
 void infra_hex2str(uint8_t *input, uint16_t input_len, char *output);
 void infra_int2str(uint32_t input, char output[10]);
 char *infra_strtok(char *str, const char *delim);
+/* same as infra_strtok(), keeping its position in @saveptr instead of a static, so it is reentrant */
+char *infra_strtok_r(char *str, const char *delim, char **saveptr);
 int infra_randstr(char *random, int length);
 void LITE_hexstr_convert(char *input, int input_len, unsigned char *output, int output_len);
 int infra_str2int(const char *input, int *val);
@@ -0,0 +1,537 @@
+/*
+ * Copyright (C) 2015-2018 Alibaba Group Holding Limited
+ */
+
+#define _XOPEN_SOURCE 600
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+#include "infra_types.h"
+#include "infra_defs.h"
+#include "wrappers_defs.h"
+#include "mqtt_example_broker.h"
+
+#define EXAMPLE_BROKER_CONN_MAX     64
+#define EXAMPLE_BROKER_PACKET_MAX   (256 * 1024)
+
+void *HAL_Malloc(uint32_t size);
+void HAL_Free(void *ptr);
+void HAL_Printf(const char *fmt, ...);
+void HAL_SleepMs(uint32_t ms);
+uint64_t HAL_UptimeMs(void);
+void *HAL_MutexCreate(void);
+void HAL_MutexDestroy(void *mutex);
+void HAL_MutexLock(void *mutex);
+void HAL_MutexUnlock(void *mutex);
+int HAL_ThreadCreate(void **thread_handle, void *(*work_routine)(void *), void *arg,
+                     hal_os_thread_param_t *hal_os_thread_param, int *stack_used);
+void HAL_ThreadDetach(void *thread_handle);
+
+/* packet held back by latency of broker, for connection @fd in slot @conn */
+typedef struct example_broker_delayed_s {
+    uint64_t                    due;
+    int                         conn;
+    int                         fd;
+    int                         len;
+    struct example_broker_delayed_s *next;
+    unsigned char               data[1];
+} example_broker_delayed_t;
+
+struct example_broker_s {
+    int                         listen_fd;
+    int                         port;
+    int                         stopping;
+    int                         threads;            /* accept and connection threads running */
+    int                         conns[EXAMPLE_BROKER_CONN_MAX];
+    void                       *conn_locks[EXAMPLE_BROKER_CONN_MAX];  /* serialize writes to each connection */
+    void                       *lock;               /* guards conns, threads and stats */
+    example_broker_publish_cb   cb;
+    void                       *ctx;
+    example_broker_stats_t      stats;
+    int                         latency_ms;         /* delay of every packet sent */
+    example_broker_delayed_t   *delayed_head;       /* in order of due, guarded by lock */
+    example_broker_delayed_t   *delayed_tail;
+};
+
+typedef struct {
+    example_broker_t           *broker;
+    int                         conn;
+} example_broker_conn_arg_t;
+
+static int _broker_recvn(int fd, unsigned char *buf, int len)
+{
+    int got = 0, ret;
+
+    while (got < len) {
+        ret = recv(fd, buf + got, len - got, 0);
+        if (ret <= 0) {
+            return -1;
+        }
+        got += ret;
+    }
+
+    return 0;
+}
+
+/* @fd is the connection the packet was meant for, so that a slot taken over in between gets nothing */
+static int _broker_write(example_broker_t *broker, int conn, int fd, const unsigned char *buf, int len)
+{
+    int sent = 0, ret = 0;
+
+    HAL_MutexLock(broker->conn_locks[conn]);
+    while (broker->conns[conn] >= 0 && broker->conns[conn] == fd && sent < len) {
+        ret = send(fd, buf + sent, len - sent, MSG_NOSIGNAL);
+        if (ret <= 0) {
+            break;
+        }
+        sent += ret;
+    }
+    HAL_MutexUnlock(broker->conn_locks[conn]);
+
+    return sent == len ? 0 : -1;
+}
+
+static int _broker_send(example_broker_t *broker, int conn, const unsigned char *buf, int len)
+{
+    example_broker_delayed_t *delayed = NULL;
+
+    if (broker->latency_ms <= 0) {
+        return _broker_write(broker, conn, broker->conns[conn], buf, len);
+    }
+
+    delayed = HAL_Malloc(sizeof(example_broker_delayed_t) + len);
+    if (delayed == NULL) {
+        return -1;
+    }
+    memset(delayed, 0, sizeof(example_broker_delayed_t));
+    delayed->due = HAL_UptimeMs() + broker->latency_ms;
+    delayed->conn = conn;
+    delayed->fd = broker->conns[conn];
+    delayed->len = len;
+    memcpy(delayed->data, buf, len);
+
+    /* latency is the same for every packet, so appending keeps the queue in order of due */
+    HAL_MutexLock(broker->lock);
+    if (broker->delayed_tail == NULL) {
+        broker->delayed_head = delayed;
+    } else {
+        broker->delayed_tail->next = delayed;
+    }
+    broker->delayed_tail = delayed;
+    HAL_MutexUnlock(broker->lock);
+
+    return 0;
+}
+
+static void *_broker_delay_thread(void *arg)
+{
+    example_broker_t *broker = (example_broker_t *)arg;
+    example_broker_delayed_t *delayed = NULL;
+
+    while (!broker->stopping) {
+        HAL_MutexLock(broker->lock);
+        delayed = broker->delayed_head;
+        if (delayed != NULL && delayed->due <= HAL_UptimeMs()) {
+            broker->delayed_head = delayed->next;
+            if (broker->delayed_head == NULL) {
+                broker->delayed_tail = NULL;
+            }
+        } else {
+            delayed = NULL;
+        }
+        HAL_MutexUnlock(broker->lock);
+
+        if (delayed == NULL) {
+            HAL_SleepMs(1);
+            continue;
+        }
+        _broker_write(broker, delayed->conn, delayed->fd, delayed->data, delayed->len);
+        HAL_Free(delayed);
+    }
+
+    HAL_MutexLock(broker->lock);
+    broker->threads--;
+    HAL_MutexUnlock(broker->lock);
+
+    return NULL;
+}
+
+static int _broker_ack(example_broker_t *broker, int conn, unsigned char type, const unsigned char *packet_id)
+{
+    unsigned char ack[4];
+
+    ack[0] = type;
+    ack[1] = 2;
+    ack[2] = packet_id ? packet_id[0] : 0;
+    ack[3] = packet_id ? packet_id[1] : 0;
+
+    return _broker_send(broker, conn, ack, sizeof(ack));
+}
+
+static void _broker_on_publish(example_broker_t *broker, int conn, unsigned char header, unsigned char *body,
+                               int len)
+{
+    int qos = (header >> 1) & 0x03;
+    int topic_len, pos;
+
+    if (len < 2) {
+        return;
+    }
+    topic_len = (body[0] << 8) | body[1];
+    pos = 2 + topic_len + (qos > 0 ? 2 : 0);
+    if (pos > len) {
+        return;
+    }
+
+    HAL_MutexLock(broker->lock);
+    broker->stats.publishes++;
+    if (header & 0x08) {
+        broker->stats.duplicates++;
+    }
+    HAL_MutexUnlock(broker->lock);
+
+    if (broker->cb) {
+        broker->cb(broker, conn, (const char *)body + 2, topic_len, (const char *)body + pos, len - pos, broker->ctx);
+    }
+
+    if (qos > 0) {
+        _broker_ack(broker, conn, 0x40, body + 2 + topic_len);
+    }
+}
+
+static void _broker_on_subscribe(example_broker_t *broker, int conn, unsigned char *body, int len)
+{
+    unsigned char suback[4 + EXAMPLE_BROKER_CONN_MAX];
+    int pos = 2, count = 0;
+
+    /* grant QoS1 to every topic filter */
+    while (pos + 2 < len && count < EXAMPLE_BROKER_CONN_MAX) {
+        pos += 2 + ((body[pos] << 8) | body[pos + 1]) + 1;
+        suback[4 + count++] = 0x01;
+    }
+
+    suback[0] = 0x90;
+    suback[1] = 2 + count;
+    suback[2] = body[0];
+    suback[3] = body[1];
+    _broker_send(broker, conn, suback, 4 + count);
+}
+
+static void *_broker_conn_thread(void *arg)
+{
+    example_broker_t *broker = ((example_broker_conn_arg_t *)arg)->broker;
+    int conn = ((example_broker_conn_arg_t *)arg)->conn;
+    int fd = broker->conns[conn];
+    unsigned char *body = HAL_Malloc(EXAMPLE_BROKER_PACKET_MAX);
+    unsigned char header, byte;
+    int len, multiplier, type;
+
+    HAL_Free(arg);
+
+    while (body != NULL) {
+        if (_broker_recvn(fd, &header, 1) != 0) {
+            break;
+        }
+        len = 0;
+        multiplier = 1;
+        do {
+            if (_broker_recvn(fd, &byte, 1) != 0) {
+                len = -1;
+                break;
+            }
+            len += (byte & 0x7F) * multiplier;
+            multiplier *= 128;
+        } while ((byte & 0x80) && multiplier <= 128 * 128 * 128);
+        if (len < 0 || len > EXAMPLE_BROKER_PACKET_MAX || _broker_recvn(fd, body, len) != 0) {
+            break;
+        }
+
+        HAL_MutexLock(broker->lock);
+        broker->stats.bytes += 2 + len;
+        HAL_MutexUnlock(broker->lock);
+
+        type = header >> 4;
+        if (type == 1) {                    /* CONNECT */
+            HAL_MutexLock(broker->lock);
+            broker->stats.connects++;
+            HAL_MutexUnlock(broker->lock);
+            _broker_ack(broker, conn, 0x20, NULL);
+        } else if (type == 3) {             /* PUBLISH */
+            _broker_on_publish(broker, conn, header, body, len);
+        } else if (type == 8 && len >= 2) { /* SUBSCRIBE */
+            _broker_on_subscribe(broker, conn, body, len);
+        } else if (type == 10 && len >= 2) { /* UNSUBSCRIBE */
+            _broker_ack(broker, conn, 0xB0, body);
+        } else if (type == 12) {            /* PINGREQ */
+            unsigned char pingresp[2] = {0xD0, 0x00};
+            _broker_send(broker, conn, pingresp, sizeof(pingresp));
+        } else if (type == 14) {            /* DISCONNECT */
+            break;
+        }
+    }
+
+    HAL_Free(body);
+    HAL_MutexLock(broker->conn_locks[conn]);
+    HAL_MutexLock(broker->lock);
+    broker->conns[conn] = -1;
+    close(fd);
+    broker->threads--;
+    HAL_MutexUnlock(broker->lock);
+    HAL_MutexUnlock(broker->conn_locks[conn]);
+
+    return NULL;
+}
+
+static void *_broker_accept_thread(void *arg)
+{
+    example_broker_t *broker = (example_broker_t *)arg;
+    example_broker_conn_arg_t *conn_arg;
+    void *thread = NULL;
+    int fd, conn, one = 1;
+
+    while (!broker->stopping) {
+        fd = accept(broker->listen_fd, NULL, NULL);
+        if (fd < 0) {
+            if (broker->stopping) {
+                break;
+            }
+            HAL_SleepMs(10);
+            continue;
+        }
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        HAL_MutexLock(broker->lock);
+        for (conn = 0; conn < EXAMPLE_BROKER_CONN_MAX; conn++) {
+            if (broker->conns[conn] < 0) {
+                broker->conns[conn] = fd;
+                break;
+            }
+        }
+        HAL_MutexUnlock(broker->lock);
+
+        conn_arg = conn < EXAMPLE_BROKER_CONN_MAX ? HAL_Malloc(sizeof(example_broker_conn_arg_t)) : NULL;
+        if (conn_arg == NULL) {
+            HAL_Printf("broker: connection refused\n");
+            HAL_MutexLock(broker->lock);
+            if (conn < EXAMPLE_BROKER_CONN_MAX) {
+                broker->conns[conn] = -1;
+            }
+            HAL_MutexUnlock(broker->lock);
+            close(fd);
+            continue;
+        }
+        conn_arg->broker = broker;
+        conn_arg->conn = conn;
+
+        HAL_MutexLock(broker->lock);
+        broker->threads++;
+        HAL_MutexUnlock(broker->lock);
+        if (HAL_ThreadCreate(&thread, _broker_conn_thread, conn_arg, NULL, NULL) != 0) {
+            HAL_MutexLock(broker->lock);
+            broker->threads--;
+            broker->conns[conn] = -1;
+            HAL_MutexUnlock(broker->lock);
+            HAL_Free(conn_arg);
+            close(fd);
+            continue;
+        }
+        HAL_ThreadDetach(thread);
+    }
+
+    HAL_MutexLock(broker->lock);
+    broker->threads--;
+    HAL_MutexUnlock(broker->lock);
+
+    return NULL;
+}
+
+example_broker_t *example_broker_start(int port, example_broker_publish_cb cb, void *ctx)
+{
+    example_broker_t *broker = NULL;
+    struct sockaddr_in addr;
+    socklen_t addr_len = sizeof(addr);
+    void *thread = NULL;
+    int idx, one = 1;
+
+    broker = HAL_Malloc(sizeof(example_broker_t));
+    if (broker == NULL) {
+        return NULL;
+    }
+    memset(broker, 0, sizeof(example_broker_t));
+    broker->cb = cb;
+    broker->ctx = ctx;
+    broker->listen_fd = -1;
+    for (idx = 0; idx < EXAMPLE_BROKER_CONN_MAX; idx++) {
+        broker->conns[idx] = -1;
+        broker->conn_locks[idx] = HAL_MutexCreate();
+        if (broker->conn_locks[idx] == NULL) {
+            goto failed;
+        }
+    }
+
+    broker->lock = HAL_MutexCreate();
+    broker->listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (broker->lock == NULL || broker->listen_fd < 0) {
+        goto failed;
+    }
+    setsockopt(broker->listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(broker->listen_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+        listen(broker->listen_fd, EXAMPLE_BROKER_CONN_MAX) != 0 ||
+        getsockname(broker->listen_fd, (struct sockaddr *)&addr, &addr_len) != 0) {
+        HAL_Printf("broker: cannot listen on port %d\n", port);
+        goto failed;
+    }
+    broker->port = ntohs(addr.sin_port);
+
+    broker->threads = 1;
+    if (HAL_ThreadCreate(&thread, _broker_accept_thread, broker, NULL, NULL) != 0) {
+        goto failed;
+    }
+    HAL_ThreadDetach(thread);
+
+    return broker;
+
+failed:
+    if (broker->listen_fd >= 0) {
+        close(broker->listen_fd);
+    }
+    if (broker->lock) {
+        HAL_MutexDestroy(broker->lock);
+    }
+    for (idx = 0; idx < EXAMPLE_BROKER_CONN_MAX; idx++) {
+        if (broker->conn_locks[idx]) {
+            HAL_MutexDestroy(broker->conn_locks[idx]);
+        }
+    }
+    HAL_Free(broker);
+    return NULL;
+}
+
+int example_broker_set_latency(example_broker_t *broker, int latency_ms)
+{
+    void *thread = NULL;
+
+    if (broker->latency_ms > 0 || latency_ms <= 0) {
+        return -1;
+    }
+
+    HAL_MutexLock(broker->lock);
+    broker->threads++;
+    HAL_MutexUnlock(broker->lock);
+    if (HAL_ThreadCreate(&thread, _broker_delay_thread, broker, NULL, NULL) != 0) {
+        HAL_MutexLock(broker->lock);
+        broker->threads--;
+        HAL_MutexUnlock(broker->lock);
+        return -1;
+    }
+    HAL_ThreadDetach(thread);
+    broker->latency_ms = latency_ms;
+
+    return 0;
+}
+
+void example_broker_kick(example_broker_t *broker)
+{
+    int idx;
+
+    HAL_MutexLock(broker->lock);
+    for (idx = 0; idx < EXAMPLE_BROKER_CONN_MAX; idx++) {
+        if (broker->conns[idx] >= 0) {
+            shutdown(broker->conns[idx], SHUT_RDWR);
+        }
+    }
+    HAL_MutexUnlock(broker->lock);
+}
+
+void example_broker_stop(example_broker_t *broker)
+{
+    int idx, threads;
+
+    if (broker == NULL) {
+        return;
+    }
+
+    broker->stopping = 1;
+    shutdown(broker->listen_fd, SHUT_RDWR);
+    example_broker_kick(broker);
+
+    /* threads are detached, wait for them to leave */
+    do {
+        HAL_SleepMs(10);
+        HAL_MutexLock(broker->lock);
+        threads = broker->threads;
+        HAL_MutexUnlock(broker->lock);
+    } while (threads > 0);
+
+    while (broker->delayed_head != NULL) {
+        example_broker_delayed_t *delayed = broker->delayed_head;
+        broker->delayed_head = delayed->next;
+        HAL_Free(delayed);
+    }
+    close(broker->listen_fd);
+    HAL_MutexDestroy(broker->lock);
+    for (idx = 0; idx < EXAMPLE_BROKER_CONN_MAX; idx++) {
+        HAL_MutexDestroy(broker->conn_locks[idx]);
+    }
+    HAL_Free(broker);
+}
+
+int example_broker_port(example_broker_t *broker)
+{
+    return broker->port;
+}
+
+int example_broker_publish(example_broker_t *broker, int conn, const char *topic, const char *payload,
+                           int payload_len)
+{
+    int topic_len = strlen(topic);
+    int remain = 2 + topic_len + payload_len;
+    int pos = 1, ret;
+    unsigned char *packet;
+
+    packet = HAL_Malloc(1 + 4 + remain);
+    if (packet == NULL) {
+        return -1;
+    }
+
+    packet[0] = 0x30;
+    do {
+        packet[pos] = remain % 128;
+        remain /= 128;
+        if (remain > 0) {
+            packet[pos] |= 0x80;
+        }
+        pos++;
+    } while (remain > 0);
+    packet[pos++] = topic_len >> 8;
+    packet[pos++] = topic_len & 0xFF;
+    memcpy(packet + pos, topic, topic_len);
+    pos += topic_len;
+    memcpy(packet + pos, payload, payload_len);
+    pos += payload_len;
+
+    ret = _broker_send(broker, conn, packet, pos);
+    HAL_Free(packet);
+
+    return ret;
+}
+
+void example_broker_stats(example_broker_t *broker, example_broker_stats_t *stats)
+{
+    HAL_MutexLock(broker->lock);
+    memcpy(stats, &broker->stats, sizeof(example_broker_stats_t));
+    HAL_MutexUnlock(broker->lock);
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2015-2018 Alibaba Group Holding Limited
+ */
+
+#ifndef __MQTT_EXAMPLE_BROKER_H__
+#define __MQTT_EXAMPLE_BROKER_H__
+
+#include "infra_types.h"
+
+/*
+ * Minimal MQTT 3.1.1 broker on 127.0.0.1 for examples which measure the client without a cloud:
+ * it accepts any CONNECT, acks QoS1 PUBLISH, SUBSCRIBE and UNSUBSCRIBE, answers PINGREQ, and
+ * hands every PUBLISH to a callback instead of routing it. Packets it sends can be held back to
+ * stand in for the round trip of a remote broker.
+ */
+typedef struct example_broker_s example_broker_t;
+
+/* called from thread of connection @conn for every PUBLISH, before it is acked */
+typedef void (*example_broker_publish_cb)(example_broker_t *broker, int conn, const char *topic, int topic_len,
+        const char *payload, int payload_len, void *ctx);
+
+typedef struct {
+    uint32_t connects;          /* CONNECT accepted */
+    uint32_t publishes;         /* PUBLISH received */
+    uint32_t duplicates;        /* PUBLISH received with DUP flag */
+    uint32_t bytes;             /* bytes received in all packets */
+} example_broker_stats_t;
+
+/**
+ * @brief Start broker listening on 127.0.0.1:@port.
+ *
+ * @param [in] port: port to listen on, 0 picks a free one, see example_broker_port().
+ * @param [in] cb: callback of PUBLISH received, NULL if not needed.
+ * @param [in] ctx: passed to @cb.
+ *
+ * @retval NULL : failed.
+ * @retval Others : handle of broker.
+ */
+example_broker_t *example_broker_start(int port, example_broker_publish_cb cb, void *ctx);
+
+/**
+ * @brief Hold back every packet sent by broker for @latency_ms from now on, order is kept.
+ *
+ * @retval  0 : success.
+ * @retval -1 : latency is set already, or failure.
+ */
+int example_broker_set_latency(example_broker_t *broker, int latency_ms);
+
+/**
+ * @brief Close listening socket and every connection, then free broker.
+ */
+void example_broker_stop(example_broker_t *broker);
+
+/**
+ * @brief Drop every connection as a network failure would, while keeping on listening.
+ */
+void example_broker_kick(example_broker_t *broker);
+
+/**
+ * @brief Port broker listens on.
+ */
+int example_broker_port(example_broker_t *broker);
+
+/**
+ * @brief Send a QoS0 PUBLISH to connection @conn, may be called from the publish callback.
+ *
+ * @retval  0 : success.
+ * @retval -1 : failure.
+ */
+int example_broker_publish(example_broker_t *broker, int conn, const char *topic, const char *payload,
+                           int payload_len);
+
+/**
+ * @brief Copy counters of broker into @stats.
+ */
+void example_broker_stats(example_broker_t *broker, example_broker_stats_t *stats);
+
+#endif  /* __MQTT_EXAMPLE_BROKER_H__ */
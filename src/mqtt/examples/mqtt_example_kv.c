@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2015-2018 Alibaba Group Holding Limited
+ */
+
+/*
+ * Cost of HAL_Kv_XXX(), which the persistent outbox stores every QoS1 publish with: puts cycling
+ * over a set of keys, then ten gets for each put, timed per call. Bytes handed to write() per put
+ * are taken from wchar of /proc/self/io, against the key + value put, as write amplification.
+ *
+ * Keys are named "kv_example_<n>" and deleted again at the end, the KV file is left in place.
+ *
+ * usage: mqtt-example-kv [puts] [keys] [value_len] [sync]
+ *     puts         HAL_Kv_Set() calls, 20000 by default
+ *     keys         distinct keys puts cycle over, 40 by default
+ *     value_len    bytes of each value, 200 by default
+ *     sync         sync argument of HAL_Kv_Set(), 0 by default
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "infra_types.h"
+#include "infra_defs.h"
+
+#define EXAMPLE_KEY_MAXLEN      32
+#define EXAMPLE_GETS_PER_PUT    10
+
+void HAL_Printf(const char *fmt, ...);
+int HAL_Snprintf(char *str, const int len, const char *fmt, ...);
+uint64_t HAL_UptimeMs(void);
+void *HAL_Malloc(uint32_t size);
+void HAL_Free(void *ptr);
+int HAL_Kv_Set(const char *key, const void *val, int len, int sync);
+int HAL_Kv_Get(const char *key, void *val, int *buffer_len);
+int HAL_Kv_Del(const char *key);
+
+/* bytes written by this process so far, -1 if not known */
+static long example_written(void)
+{
+    char line[64];
+    long written = -1;
+    FILE *fp = fopen("/proc/self/io", "r");
+
+    if (fp == NULL) {
+        return -1;
+    }
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        if (strncmp(line, "wchar:", strlen("wchar:")) == 0) {
+            written = atol(line + strlen("wchar:"));
+        }
+    }
+    fclose(fp);
+    return written;
+}
+
+int main(int argc, char *argv[])
+{
+    char key[EXAMPLE_KEY_MAXLEN];
+    char *value = NULL, *out = NULL;
+    int put_num = 20000, keys = 40, value_len = 200, sync = 0, index, len, res = -1;
+    long written, written_end;
+    uint64_t start, put_ms, get_ms;
+
+    if (argc > 1) {
+        put_num = atoi(argv[1]);
+    }
+    if (argc > 2) {
+        keys = atoi(argv[2]);
+    }
+    if (argc > 3) {
+        value_len = atoi(argv[3]);
+    }
+    if (argc > 4) {
+        sync = atoi(argv[4]);
+    }
+    if (put_num <= 0 || keys <= 0 || value_len <= 0) {
+        HAL_Printf("usage: %s [puts] [keys] [value_len] [sync]\n", argv[0]);
+        return -1;
+    }
+    if (keys > put_num) {
+        keys = put_num;
+    }
+
+    value = HAL_Malloc(value_len);
+    out = HAL_Malloc(value_len);
+    if (value == NULL || out == NULL) {
+        goto out;
+    }
+    memset(value, 'v', value_len);
+
+    /* opens the KV file, and has it replay or import whatever is there before timing starts */
+    HAL_Snprintf(key, sizeof(key), "kv_example_%d", 0);
+    HAL_Kv_Del(key);
+
+    written = example_written();
+    start = HAL_UptimeMs();
+    for (index = 0; index < put_num; index++) {
+        HAL_Snprintf(key, sizeof(key), "kv_example_%d", index % keys);
+        value[0] = (char)index;
+        if (HAL_Kv_Set(key, value, value_len, sync) != 0) {
+            HAL_Printf("HAL_Kv_Set of %s failed\n", key);
+            goto out;
+        }
+    }
+    put_ms = HAL_UptimeMs() - start;
+    written_end = example_written();
+    written = (written >= 0 && written_end >= 0) ? written_end - written : -1;
+
+    start = HAL_UptimeMs();
+    for (index = 0; index < put_num * EXAMPLE_GETS_PER_PUT; index++) {
+        HAL_Snprintf(key, sizeof(key), "kv_example_%d", index % keys);
+        len = value_len;
+        if (HAL_Kv_Get(key, out, &len) != 0 || len != value_len) {
+            HAL_Printf("HAL_Kv_Get of %s failed\n", key);
+            goto out;
+        }
+    }
+    get_ms = HAL_UptimeMs() - start;
+
+    HAL_Printf("put: %8.2f us, sync %d, %d keys of %d + %d bytes\n", (double)put_ms * 1000 / put_num, sync, keys,
+               (int)strlen(key), value_len);
+    if (written >= 0) {
+        HAL_Printf("     %8ld bytes written each, %.2f times key + value\n", written / put_num,
+                   (double)written / put_num / (strlen(key) + value_len));
+    }
+    HAL_Printf("get: %8.2f us\n", (double)get_ms * 1000 / (put_num * EXAMPLE_GETS_PER_PUT));
+    res = 0;
+
+out:
+    for (index = 0; index < keys; index++) {
+        HAL_Snprintf(key, sizeof(key), "kv_example_%d", index);
+        HAL_Kv_Del(key);
+    }
+    if (value != NULL) {
+        HAL_Free(value);
+    }
+    if (out != NULL) {
+        HAL_Free(out);
+    }
+
+    return res;
+}
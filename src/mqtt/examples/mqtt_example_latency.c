@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2015-2018 Alibaba Group Holding Limited
+ */
+
+/*
+ * Downlink latency of the MQTT client against the local stub broker of mqtt_example_broker.c:
+ * once the client has published a start message, a thread of broker sends it a QoS0 publish
+ * at a fixed interval, carrying the CLOCK_MONOTONIC time it was sent at. The client does
+ * nothing but IOT_MQTT_Yield() with a long timeout, and takes the time each message took to
+ * be handed to its callback. Percentiles are printed, along with the CPU time the process
+ * spends in two seconds of yield without any message.
+ *
+ * usage: mqtt-example-latency [messages] [interval]
+ *     messages     publishes sent by broker, 500 by default
+ *     interval     milliseconds between publishes, 3 by default
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+
+#include "infra_types.h"
+#include "infra_defs.h"
+#include "wrappers_defs.h"
+#include "mqtt_api.h"
+#include "mqtt_example_broker.h"
+
+#define EXAMPLE_START_TOPIC     "/a1example/example1/user/start"
+#define EXAMPLE_STAMP_TOPIC     "/a1example/example1/user/stamp"
+#define EXAMPLE_YIELD_MS        200
+#define EXAMPLE_IDLE_MS         2000
+#define EXAMPLE_TIMEOUT_MS      60000
+
+void HAL_Printf(const char *fmt, ...);
+int HAL_Snprintf(char *str, const int len, const char *fmt, ...);
+void HAL_SleepMs(uint32_t ms);
+uint64_t HAL_UptimeMs(void);
+void *HAL_Malloc(uint32_t size);
+void HAL_Free(void *ptr);
+int HAL_ThreadCreate(void **thread_handle, void *(*work_routine)(void *), void *arg,
+                     hal_os_thread_param_t *hal_os_thread_param, int *stack_used);
+void HAL_ThreadDetach(void *thread_handle);
+
+typedef struct {
+    example_broker_t   *broker;
+    int                 conn;
+} example_sender_t;
+
+static int       g_messages = 500;
+static int       g_interval_ms = 3;
+static int       g_received = 0;
+static uint32_t *g_latency_us = NULL;
+static example_sender_t g_sender;
+
+static uint64_t example_now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static uint64_t example_cpu_us(void)
+{
+    struct rusage usage;
+
+    memset(&usage, 0, sizeof(usage));
+    getrusage(RUSAGE_SELF, &usage);
+    return (uint64_t)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000 +
+           usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+}
+
+static int example_latency_cmp(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+
+    return (x < y) ? -1 : (x > y);
+}
+
+static void *example_sender(void *arg)
+{
+    example_sender_t *sender = (example_sender_t *)arg;
+    char stamp[32];
+    int idx, len;
+
+    for (idx = 0; idx < g_messages; idx++) {
+        HAL_SleepMs(g_interval_ms);
+        len = HAL_Snprintf(stamp, sizeof(stamp), "%llu", (unsigned long long)example_now_us());
+        if (example_broker_publish(sender->broker, sender->conn, EXAMPLE_STAMP_TOPIC, stamp, len) != 0) {
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+static void example_broker_cb(example_broker_t *broker, int conn, const char *topic, int topic_len,
+                              const char *payload, int payload_len, void *ctx)
+{
+    void *thread = NULL;
+
+    if (topic_len != (int)strlen(EXAMPLE_START_TOPIC) || memcmp(topic, EXAMPLE_START_TOPIC, topic_len) != 0) {
+        return;
+    }
+    g_sender.broker = broker;
+    g_sender.conn = conn;
+    if (HAL_ThreadCreate(&thread, example_sender, &g_sender, NULL, NULL) == 0) {
+        HAL_ThreadDetach(thread);
+    }
+}
+
+static void example_message_arrive(void *pcontext, void *pclient, iotx_mqtt_event_msg_pt msg)
+{
+    iotx_mqtt_topic_info_t *topic_info = (iotx_mqtt_topic_info_pt) msg->msg;
+    uint64_t now_us = example_now_us();
+    char stamp[32];
+
+    if (msg->event_type != IOTX_MQTT_EVENT_PUBLISH_RECEIVED || topic_info->payload_len >= sizeof(stamp) ||
+        g_received >= g_messages) {
+        return;
+    }
+    memcpy(stamp, topic_info->payload, topic_info->payload_len);
+    stamp[topic_info->payload_len] = '\0';
+    g_latency_us[g_received++] = (uint32_t)(now_us - strtoull(stamp, NULL, 10));
+}
+
+int main(int argc, char *argv[])
+{
+    example_broker_t *broker = NULL;
+    iotx_mqtt_param_t params;
+    void *handle = NULL;
+    uint64_t start, cpu_us;
+    int res = -1;
+
+    if (argc > 1) {
+        g_messages = atoi(argv[1]);
+    }
+    if (argc > 2) {
+        g_interval_ms = atoi(argv[2]);
+    }
+    if (g_messages <= 0 || g_interval_ms < 0) {
+        HAL_Printf("usage: %s [messages] [interval]\n", argv[0]);
+        return -1;
+    }
+
+    g_latency_us = HAL_Malloc(sizeof(uint32_t) * g_messages);
+    broker = example_broker_start(0, example_broker_cb, NULL);
+    if (g_latency_us == NULL || broker == NULL) {
+        goto out;
+    }
+
+    memset(&params, 0, sizeof(params));
+    params.host = "127.0.0.1";
+    params.port = example_broker_port(broker);
+    params.client_id = "example-latency";
+    params.username = "example";
+    params.password = "example";
+    params.keepalive_interval_ms = 60000;
+
+    handle = IOT_MQTT_Construct(&params);
+    if (handle == NULL) {
+        HAL_Printf("IOT_MQTT_Construct failed\n");
+        goto out;
+    }
+    if (IOT_MQTT_Subscribe_Sync(handle, EXAMPLE_STAMP_TOPIC, IOTX_MQTT_QOS0, example_message_arrive, NULL,
+                                5000) < 0) {
+        HAL_Printf("IOT_MQTT_Subscribe_Sync failed\n");
+        goto out;
+    }
+    if (IOT_MQTT_Publish_Simple(handle, EXAMPLE_START_TOPIC, IOTX_MQTT_QOS0, "start", strlen("start")) < 0) {
+        HAL_Printf("IOT_MQTT_Publish_Simple failed\n");
+        goto out;
+    }
+
+    start = HAL_UptimeMs();
+    while (g_received < g_messages && HAL_UptimeMs() - start < EXAMPLE_TIMEOUT_MS) {
+        IOT_MQTT_Yield(handle, EXAMPLE_YIELD_MS);
+    }
+
+    cpu_us = example_cpu_us();
+    for (start = HAL_UptimeMs(); HAL_UptimeMs() - start < EXAMPLE_IDLE_MS;) {
+        IOT_MQTT_Yield(handle, EXAMPLE_YIELD_MS);
+    }
+    cpu_us = example_cpu_us() - cpu_us;
+
+    if (g_received > 0) {
+        qsort(g_latency_us, g_received, sizeof(uint32_t), example_latency_cmp);
+        HAL_Printf("%d msgs every %d ms: p50 %u us, p99 %u us, max %u us\n", g_received, g_interval_ms,
+                   g_latency_us[g_received / 2], g_latency_us[g_received * 99 / 100], g_latency_us[g_received - 1]);
+    }
+    HAL_Printf("idle %d ms of yield: %d us of CPU\n", EXAMPLE_IDLE_MS, (int)cpu_us);
+    res = (g_received == g_messages) ? 0 : -1;
+
+out:
+    if (handle != NULL) {
+        IOT_MQTT_Destroy(&handle);
+    }
+    if (broker != NULL) {
+        example_broker_stop(broker);
+    }
+    if (g_latency_us != NULL) {
+        HAL_Free(g_latency_us);
+    }
+
+    return res;
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2015-2018 Alibaba Group Holding Limited
+ */
+
+/*
+ * Downlink throughput of the MQTT client against the local stub broker of mqtt_example_broker.c:
+ * the client publishes a start message, the broker answers it with a burst of QoS0 publishes on
+ * a subscribed topic, and the client yields until every one of them is handled. Besides rate,
+ * the user and system CPU time of the yielding thread is printed per message received, system
+ * time being mostly the cost of the recv() and poll() calls made for it. recv() on a socket is
+ * not counted in syscr of /proc/self/io, count calls with "strace -f -c -e recvfrom,poll".
+ *
+ * To compare against reading one packet at a time, build with -DWITH_MQTT_READ_AHEAD=0 added to
+ * CONFIG_ENV_CFLAGS of the board config.
+ *
+ * usage: mqtt-example-loopback [messages] [payload_len]
+ *     messages     publishes in the burst, 2000 by default
+ *     payload_len  bytes of each payload, 64 by default
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+
+#include "infra_types.h"
+#include "infra_defs.h"
+#include "mqtt_api.h"
+#include "mqtt_example_broker.h"
+
+#define EXAMPLE_START_TOPIC     "/a1example/example1/user/start"
+#define EXAMPLE_BURST_TOPIC     "/a1example/example1/user/burst"
+#define EXAMPLE_PAYLOAD_MAXLEN  4096
+#define EXAMPLE_TIMEOUT_MS      60000
+
+void HAL_Printf(const char *fmt, ...);
+uint64_t HAL_UptimeMs(void);
+void *HAL_Malloc(uint32_t size);
+void HAL_Free(void *ptr);
+
+static int   g_messages = 2000;
+static int   g_payload_len = 64;
+static char *g_payload = NULL;
+static int   g_received = 0;
+
+/* user and system CPU time of calling thread so far, in us */
+static void example_cpu_us(uint64_t *user_us, uint64_t *sys_us)
+{
+    struct rusage usage;
+
+    memset(&usage, 0, sizeof(usage));
+    getrusage(RUSAGE_THREAD, &usage);
+    *user_us = (uint64_t)usage.ru_utime.tv_sec * 1000000 + usage.ru_utime.tv_usec;
+    *sys_us = (uint64_t)usage.ru_stime.tv_sec * 1000000 + usage.ru_stime.tv_usec;
+}
+
+/* sends the whole burst from the connection thread of broker, the client is read while it runs */
+static void example_broker_cb(example_broker_t *broker, int conn, const char *topic, int topic_len,
+                              const char *payload, int payload_len, void *ctx)
+{
+    int idx;
+
+    if (topic_len != (int)strlen(EXAMPLE_START_TOPIC) || memcmp(topic, EXAMPLE_START_TOPIC, topic_len) != 0) {
+        return;
+    }
+    for (idx = 0; idx < g_messages; idx++) {
+        if (example_broker_publish(broker, conn, EXAMPLE_BURST_TOPIC, g_payload, g_payload_len) != 0) {
+            return;
+        }
+    }
+}
+
+static void example_message_arrive(void *pcontext, void *pclient, iotx_mqtt_event_msg_pt msg)
+{
+    iotx_mqtt_topic_info_t *topic_info = (iotx_mqtt_topic_info_pt) msg->msg;
+
+    if (msg->event_type == IOTX_MQTT_EVENT_PUBLISH_RECEIVED && topic_info->payload_len == g_payload_len) {
+        g_received++;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    example_broker_t *broker = NULL;
+    iotx_mqtt_param_t params;
+    void *handle = NULL;
+    uint64_t start, elapsed, user_us, sys_us, user_end_us, sys_end_us;
+    int res = -1;
+
+    if (argc > 1) {
+        g_messages = atoi(argv[1]);
+    }
+    if (argc > 2) {
+        g_payload_len = atoi(argv[2]);
+    }
+    if (g_messages <= 0 || g_payload_len <= 0 || g_payload_len > EXAMPLE_PAYLOAD_MAXLEN) {
+        HAL_Printf("usage: %s [messages] [payload_len]\n", argv[0]);
+        return -1;
+    }
+
+    g_payload = HAL_Malloc(g_payload_len);
+    broker = example_broker_start(0, example_broker_cb, NULL);
+    if (g_payload == NULL || broker == NULL) {
+        goto out;
+    }
+    memset(g_payload, 'p', g_payload_len);
+
+    memset(&params, 0, sizeof(params));
+    params.host = "127.0.0.1";
+    params.port = example_broker_port(broker);
+    params.client_id = "example-loopback";
+    params.username = "example";
+    params.password = "example";
+    params.read_buf_size = EXAMPLE_PAYLOAD_MAXLEN + 256;
+
+    handle = IOT_MQTT_Construct(&params);
+    if (handle == NULL) {
+        HAL_Printf("IOT_MQTT_Construct failed\n");
+        goto out;
+    }
+    if (IOT_MQTT_Subscribe_Sync(handle, EXAMPLE_BURST_TOPIC, IOTX_MQTT_QOS0, example_message_arrive, NULL,
+                                5000) < 0) {
+        HAL_Printf("IOT_MQTT_Subscribe_Sync failed\n");
+        goto out;
+    }
+
+    example_cpu_us(&user_us, &sys_us);
+    start = HAL_UptimeMs();
+    if (IOT_MQTT_Publish_Simple(handle, EXAMPLE_START_TOPIC, IOTX_MQTT_QOS0, "start", strlen("start")) < 0) {
+        HAL_Printf("IOT_MQTT_Publish_Simple failed\n");
+        goto out;
+    }
+    while (g_received < g_messages && HAL_UptimeMs() - start < EXAMPLE_TIMEOUT_MS) {
+        IOT_MQTT_Yield(handle, 10);
+    }
+    elapsed = HAL_UptimeMs() - start;
+    example_cpu_us(&user_end_us, &sys_end_us);
+
+    HAL_Printf("%6d of %d msgs of %d bytes in %6d ms, %8d msgs/s\n", g_received, g_messages, g_payload_len,
+               (int)elapsed, (int)((uint64_t)g_received * 1000 / (elapsed ? elapsed : 1)));
+    if (g_received > 0) {
+        HAL_Printf("%8.2f us user, %8.2f us system of yielding thread per msg\n",
+                   (double)(user_end_us - user_us) / g_received, (double)(sys_end_us - sys_us) / g_received);
+    }
+    res = (g_received == g_messages) ? 0 : -1;
+
+out:
+    if (handle != NULL) {
+        IOT_MQTT_Destroy(&handle);
+    }
+    if (broker != NULL) {
+        example_broker_stop(broker);
+    }
+    if (g_payload != NULL) {
+        HAL_Free(g_payload);
+    }
+
+    return res;
+}
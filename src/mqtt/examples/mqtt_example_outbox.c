@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2015-2018 Alibaba Group Holding Limited
+ */
+
+/*
+ * Drain rate of the persistent outbox against the local stub broker of mqtt_example_broker.c:
+ * the broker goes away, messages published meanwhile are stored by IOT_MQTT_Outbox_Open(),
+ * then the broker comes back on the same port and the time taken to empty the outbox after
+ * reconnecting is measured, along with the order the broker got the messages in.
+ *
+ * Needs an MQTT client built with WITH_MQTT_OUTBOX, outbox is kept by HAL_Kv_XXX().
+ *
+ * usage: mqtt-example-outbox [messages]
+ *     messages     QoS1 publishes made while offline, 2000 by default
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "infra_types.h"
+#include "infra_defs.h"
+#include "mqtt_api.h"
+#include "mqtt_example_broker.h"
+
+#define EXAMPLE_OUTBOX_NAME     "example"
+#define EXAMPLE_TOPIC           "/sys/a1example/example1/thing/event/property/post"
+#define EXAMPLE_TIMEOUT_MS      60000
+
+void HAL_Printf(const char *fmt, ...);
+int HAL_Snprintf(char *str, const int len, const char *fmt, ...);
+void HAL_SleepMs(uint32_t ms);
+uint64_t HAL_UptimeMs(void);
+
+static int g_next = 0;          /* sequence expected next by broker */
+static int g_reordered = 0;
+
+static void example_broker_cb(example_broker_t *broker, int conn, const char *topic, int topic_len,
+                              const char *payload, int payload_len, void *ctx)
+{
+    char seq[16];
+    int value;
+
+    if (payload_len <= 0 || payload_len >= (int)sizeof(seq)) {
+        return;
+    }
+    memcpy(seq, payload, payload_len);
+    seq[payload_len] = '\0';
+    value = atoi(seq);
+
+    /* a message sent again is fine, one overtaking another is not */
+    if (value > g_next) {
+        g_reordered++;
+    }
+    if (value >= g_next) {
+        g_next = value + 1;
+    }
+}
+
+static int example_wait_state(void *handle, int normal)
+{
+    uint64_t start = HAL_UptimeMs();
+
+    while ((IOT_MQTT_CheckStateNormal(handle) == 1) != normal) {
+        if (HAL_UptimeMs() - start > EXAMPLE_TIMEOUT_MS) {
+            return -1;
+        }
+        IOT_MQTT_Yield(handle, 50);
+    }
+
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    example_broker_t *broker = NULL;
+    iotx_mqtt_param_t params;
+    iotx_mqtt_outbox_stats_t stats;
+    example_broker_stats_t broker_stats;
+    void *handle = NULL;
+    char payload[16];
+    uint64_t start, elapsed;
+    int messages = 2000, port, idx, len, res = -1;
+
+    if (argc > 1) {
+        messages = atoi(argv[1]);
+    }
+
+    broker = example_broker_start(0, example_broker_cb, NULL);
+    if (broker == NULL) {
+        return -1;
+    }
+    port = example_broker_port(broker);
+
+    memset(&params, 0, sizeof(params));
+    params.host = "127.0.0.1";
+    params.port = port;
+    params.client_id = "example-outbox";
+    params.username = "example";
+    params.password = "example";
+
+    handle = IOT_MQTT_Construct(&params);
+    if (handle == NULL) {
+        HAL_Printf("IOT_MQTT_Construct failed\n");
+        goto out;
+    }
+    if (IOT_MQTT_Outbox_Open(handle, EXAMPLE_OUTBOX_NAME, messages) != 0) {
+        HAL_Printf("IOT_MQTT_Outbox_Open failed, is client built with WITH_MQTT_OUTBOX?\n");
+        goto out;
+    }
+    IOT_MQTT_Get_Outbox_Stats(handle, &stats);
+    if (stats.stored > 0) {
+        HAL_Printf("outbox keeps %u messages of a previous run, remove them first\n", stats.stored);
+        goto out;
+    }
+
+    /* go offline */
+    example_broker_stop(broker);
+    broker = NULL;
+    if (example_wait_state(handle, 0) != 0) {
+        goto out;
+    }
+
+    start = HAL_UptimeMs();
+    for (idx = 0; idx < messages; idx++) {
+        len = HAL_Snprintf(payload, sizeof(payload), "%d", idx);
+        if (IOT_MQTT_Publish_Simple(handle, EXAMPLE_TOPIC, IOTX_MQTT_QOS1, payload, len) < 0) {
+            HAL_Printf("publish %d while offline failed\n", idx);
+            goto out;
+        }
+    }
+    elapsed = HAL_UptimeMs() - start;
+    IOT_MQTT_Get_Outbox_Stats(handle, &stats);
+    HAL_Printf("offline : %d msgs stored in %d ms, outbox has %u\n", messages, (int)elapsed, stats.stored);
+
+    /* come back on the same port, reconnect waits for backoff of client */
+    broker = example_broker_start(port, example_broker_cb, NULL);
+    if (broker == NULL || example_wait_state(handle, 1) != 0) {
+        goto out;
+    }
+
+    start = HAL_UptimeMs();
+    do {
+        IOT_MQTT_Yield(handle, 10);
+        IOT_MQTT_Get_Outbox_Stats(handle, &stats);
+    } while (stats.stored > 0 && HAL_UptimeMs() - start < EXAMPLE_TIMEOUT_MS);
+    elapsed = HAL_UptimeMs() - start;
+
+    example_broker_stats(broker, &broker_stats);
+    /* drain starts on reconnect, before state is seen normal here, so rate is taken from outbox */
+    HAL_Printf("online  : outbox emptied %d ms after reconnect seen, last drain %u msgs in %u ms, %d msgs/s\n",
+               (int)elapsed, stats.last_drain_msgs, stats.last_drain_ms,
+               (int)((uint64_t)stats.last_drain_msgs * 1000 / (stats.last_drain_ms ? stats.last_drain_ms : 1)));
+    HAL_Printf("broker  : %u publishes, %u sent again, %d out of order, %d of %d arrived\n",
+               broker_stats.publishes, broker_stats.duplicates, g_reordered, g_next, messages);
+
+    res = (stats.stored == 0 && g_next == messages && g_reordered == 0) ? 0 : -1;
+
+out:
+    if (handle != NULL) {
+        IOT_MQTT_Destroy(&handle);
+    }
+    example_broker_stop(broker);
+
+    return res;
+}
@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2015-2018 Alibaba Group Holding Limited
+ */
+
+/*
+ * Uplink throughput of IOT_MQTT_Pool_Construct() against the local stub broker of
+ * mqtt_example_broker.c: publisher threads send QoS1 messages on the topics of many
+ * sub-devices, once through a single connection and once through a pool.
+ *
+ * usage: mqtt-example-pool [messages] [threads] [connections]
+ *     messages     QoS1 publishes in each run, 100000 by default
+ *     threads      publisher threads, 4 by default
+ *     connections  members of pool, same as threads by default
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "infra_types.h"
+#include "infra_defs.h"
+#include "wrappers_defs.h"
+#include "mqtt_api.h"
+#include "mqtt_example_broker.h"
+
+#define EXAMPLE_DEVICES         128
+#define EXAMPLE_THREADS_MAX     16
+#define EXAMPLE_TIMEOUT_MS      60000
+
+void HAL_Printf(const char *fmt, ...);
+int HAL_Snprintf(char *str, const int len, const char *fmt, ...);
+void HAL_SleepMs(uint32_t ms);
+uint64_t HAL_UptimeMs(void);
+int HAL_ThreadCreate(void **thread_handle, void *(*work_routine)(void *), void *arg,
+                     hal_os_thread_param_t *hal_os_thread_param, int *stack_used);
+void HAL_ThreadDetach(void *thread_handle);
+void *HAL_MutexCreate(void);
+void HAL_MutexDestroy(void *mutex);
+void HAL_MutexLock(void *mutex);
+void HAL_MutexUnlock(void *mutex);
+
+typedef struct {
+    void       *handle;
+    int         first;          /* first message of thread */
+    int         count;          /* messages of thread */
+    int         blocked;        /* publishes refused by a full inflight window */
+    int         failed;
+} example_publisher_t;
+
+static void *g_done_lock = NULL;
+static int   g_done = 0;
+
+static void *example_publisher(void *arg)
+{
+    example_publisher_t *publisher = (example_publisher_t *)arg;
+    char topic[64];
+    char payload[96];
+    int idx, res, len;
+
+    for (idx = publisher->first; idx < publisher->first + publisher->count; idx++) {
+        HAL_Snprintf(topic, sizeof(topic), "/sys/a1example/sub%03d/thing/event/property/post", idx % EXAMPLE_DEVICES);
+        len = HAL_Snprintf(payload, sizeof(payload), "{\"id\":\"%d\",\"params\":{\"temperature\":%d}}", idx, idx % 40);
+
+        res = IOT_MQTT_Publish_Simple(publisher->handle, topic, IOTX_MQTT_QOS1, payload, len);
+        if (res == MQTT_PUBLISH_WOULD_BLOCK) {
+            /* wait for some PUBACK, then send the same message again */
+            publisher->blocked++;
+            IOT_MQTT_Yield(publisher->handle, 1);
+            idx--;
+            continue;
+        }
+        if (res < 0) {
+            publisher->failed++;
+        }
+        if (idx % 32 == 31) {
+            IOT_MQTT_Yield(publisher->handle, 1);
+        }
+    }
+
+    HAL_MutexLock(g_done_lock);
+    g_done++;
+    HAL_MutexUnlock(g_done_lock);
+
+    return NULL;
+}
+
+static int example_run(example_broker_t *broker, int messages, int threads, int connections)
+{
+    iotx_mqtt_param_t params[EXAMPLE_THREADS_MAX];
+    char client_id[EXAMPLE_THREADS_MAX][32];
+    example_publisher_t publishers[EXAMPLE_THREADS_MAX];
+    example_broker_stats_t stats;
+    void *handle = NULL, *thread = NULL;
+    uint64_t start, elapsed;
+    uint32_t received;
+    int idx, done, blocked = 0, failed = 0;
+
+    messages = messages / threads * threads;
+
+    memset(params, 0, sizeof(params));
+    for (idx = 0; idx < connections; idx++) {
+        HAL_Snprintf(client_id[idx], sizeof(client_id[idx]), "example-gw-%d", idx);
+        params[idx].host = "127.0.0.1";
+        params[idx].port = example_broker_port(broker);
+        params[idx].client_id = client_id[idx];
+        params[idx].username = "example";
+        params[idx].password = "example";
+    }
+
+    handle = IOT_MQTT_Pool_Construct(params, connections);
+    if (handle == NULL) {
+        HAL_Printf("IOT_MQTT_Pool_Construct failed\n");
+        return -1;
+    }
+
+    g_done = 0;
+    example_broker_stats(broker, &stats);
+    received = stats.publishes;
+    start = HAL_UptimeMs();
+    for (idx = 0; idx < threads; idx++) {
+        publishers[idx].handle = handle;
+        publishers[idx].first = messages / threads * idx;
+        publishers[idx].count = messages / threads;
+        publishers[idx].blocked = 0;
+        publishers[idx].failed = 0;
+        if (HAL_ThreadCreate(&thread, example_publisher, &publishers[idx], NULL, NULL) != 0) {
+            HAL_Printf("create publisher failed\n");
+            return -1;
+        }
+        HAL_ThreadDetach(thread);
+    }
+
+    /* finished once every message has reached broker */
+    do {
+        HAL_SleepMs(1);
+        HAL_MutexLock(g_done_lock);
+        done = g_done;
+        HAL_MutexUnlock(g_done_lock);
+        example_broker_stats(broker, &stats);
+    } while ((done < threads || stats.publishes - received < messages) &&
+             HAL_UptimeMs() - start < EXAMPLE_TIMEOUT_MS);
+    elapsed = HAL_UptimeMs() - start;
+
+    for (idx = 0; idx < threads; idx++) {
+        blocked += publishers[idx].blocked;
+        failed += publishers[idx].failed;
+    }
+    HAL_Printf("%2d thread(s), %2d connection(s): %6d msgs in %5d ms, %7d msgs/s, %d would block, %d failed\n",
+               threads, connections, (int)(stats.publishes - received), (int)elapsed,
+               (int)((uint64_t)(stats.publishes - received) * 1000 / (elapsed ? elapsed : 1)), blocked, failed);
+
+    IOT_MQTT_Destroy(&handle);
+
+    return (done == threads && failed == 0 && stats.publishes - received >= messages) ? 0 : -1;
+}
+
+int main(int argc, char *argv[])
+{
+    example_broker_t *broker = NULL;
+    int messages = 100000, threads = 4, connections = 0, res;
+
+    if (argc > 1) {
+        messages = atoi(argv[1]);
+    }
+    if (argc > 2) {
+        threads = atoi(argv[2]);
+    }
+    if (argc > 3) {
+        connections = atoi(argv[3]);
+    }
+    if (threads <= 0 || threads > EXAMPLE_THREADS_MAX) {
+        threads = 4;
+    }
+    if (connections <= 0 || connections > EXAMPLE_THREADS_MAX) {
+        connections = threads;
+    }
+
+    g_done_lock = HAL_MutexCreate();
+    broker = example_broker_start(0, NULL, NULL);
+    if (g_done_lock == NULL || broker == NULL) {
+        return -1;
+    }
+
+    res = example_run(broker, messages, threads, 1);
+    if (res == 0) {
+        res = example_run(broker, messages, threads, connections);
+    }
+
+    example_broker_stop(broker);
+    HAL_MutexDestroy(g_done_lock);
+
+    return res;
+}
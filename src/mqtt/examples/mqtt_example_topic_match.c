@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2015-2018 Alibaba Group Holding Limited
+ */
+
+/*
+ * Cost of dispatching an inbound PUBLISH as the number of subscriptions grows, against the local
+ * stub broker of mqtt_example_broker.c. For each count, a new connection subscribes that many
+ * topic filters, one of every ten of them with a '+' or '#' wildcard, plus the exact topic the
+ * broker then sends a burst of QoS0 publishes on. None of the other filters match it, yet each
+ * of them had to be looked at when subscriptions were kept in a plain list.
+ *
+ * usage: mqtt-example-topic-match [messages] [subscriptions ...]
+ *     messages         publishes in each burst, 200000 by default
+ *     subscriptions    counts of subscriptions to run with, 10 100 1000 10000 by default
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "infra_types.h"
+#include "infra_defs.h"
+#include "mqtt_api.h"
+#include "mqtt_example_broker.h"
+
+#define EXAMPLE_START_TOPIC     "/a1example/example1/user/start"
+#define EXAMPLE_BURST_TOPIC     "/a1example/example1/user/get"
+#define EXAMPLE_PAYLOAD         "LightSwitch=1"
+#define EXAMPLE_SUBACK_PENDING  128
+#define EXAMPLE_RUNS_MAX        16
+#define EXAMPLE_TIMEOUT_MS      60000
+
+void HAL_Printf(const char *fmt, ...);
+int HAL_Snprintf(char *str, const int len, const char *fmt, ...);
+uint64_t HAL_UptimeMs(void);
+
+static int g_messages = 200000;
+static int g_received = 0;
+static int g_subacks = 0;
+
+static void example_broker_cb(example_broker_t *broker, int conn, const char *topic, int topic_len,
+                              const char *payload, int payload_len, void *ctx)
+{
+    int idx;
+
+    if (topic_len != (int)strlen(EXAMPLE_START_TOPIC) || memcmp(topic, EXAMPLE_START_TOPIC, topic_len) != 0) {
+        return;
+    }
+    for (idx = 0; idx < g_messages; idx++) {
+        if (example_broker_publish(broker, conn, EXAMPLE_BURST_TOPIC, EXAMPLE_PAYLOAD,
+                                   strlen(EXAMPLE_PAYLOAD)) != 0) {
+            return;
+        }
+    }
+}
+
+static void example_event_handle(void *pcontext, void *pclient, iotx_mqtt_event_msg_pt msg)
+{
+    if (msg->event_type == IOTX_MQTT_EVENT_SUBCRIBE_SUCCESS) {
+        g_subacks++;
+    }
+}
+
+static void example_message_arrive(void *pcontext, void *pclient, iotx_mqtt_event_msg_pt msg)
+{
+    if (msg->event_type == IOTX_MQTT_EVENT_PUBLISH_RECEIVED) {
+        g_received++;
+    }
+}
+
+/* @idx-th filter, none of which matches EXAMPLE_BURST_TOPIC */
+static void example_filter(char *filter, int len, int idx)
+{
+    switch (idx % 10) {
+        case 0:
+            HAL_Snprintf(filter, len, "/a1example/sub%d/+/get", idx);
+            break;
+        case 5:
+            HAL_Snprintf(filter, len, "/sys/a1example/sub%d/thing/#", idx);
+            break;
+        default:
+            HAL_Snprintf(filter, len, "/a1example/sub%d/user/get", idx);
+            break;
+    }
+}
+
+static int example_subscribe(void *handle, int subscriptions)
+{
+    char filter[64];
+    uint64_t start = HAL_UptimeMs();
+    int idx = 0, sent = 0;
+
+    g_subacks = 0;
+    while (g_subacks < subscriptions + 1) {
+        if (HAL_UptimeMs() - start > EXAMPLE_TIMEOUT_MS) {
+            return -1;
+        }
+        if (sent > subscriptions || sent - g_subacks >= EXAMPLE_SUBACK_PENDING) {
+            IOT_MQTT_Yield(handle, 10);
+            continue;
+        }
+        if (idx < subscriptions) {
+            example_filter(filter, sizeof(filter), idx);
+        } else {
+            HAL_Snprintf(filter, sizeof(filter), "%s", EXAMPLE_BURST_TOPIC);
+        }
+        if (IOT_MQTT_Subscribe(handle, filter, IOTX_MQTT_QOS0, example_message_arrive, NULL) < 0) {
+            /* too many requests waiting for SUBACK, try again once some are in */
+            IOT_MQTT_Yield(handle, 10);
+            continue;
+        }
+        idx++;
+        sent++;
+    }
+
+    return 0;
+}
+
+static int example_run(example_broker_t *broker, int subscriptions)
+{
+    iotx_mqtt_param_t params;
+    char client_id[32];
+    void *handle = NULL;
+    uint64_t start, elapsed;
+    int res = -1;
+
+    HAL_Snprintf(client_id, sizeof(client_id), "example-match-%d", subscriptions);
+    memset(&params, 0, sizeof(params));
+    params.host = "127.0.0.1";
+    params.port = example_broker_port(broker);
+    params.client_id = client_id;
+    params.username = "example";
+    params.password = "example";
+    params.handle_event.h_fp = example_event_handle;
+
+    handle = IOT_MQTT_Construct(&params);
+    if (handle == NULL) {
+        HAL_Printf("IOT_MQTT_Construct failed\n");
+        return -1;
+    }
+    if (example_subscribe(handle, subscriptions) != 0) {
+        HAL_Printf("subscribe %d filters failed, %d acked\n", subscriptions + 1, g_subacks);
+        goto out;
+    }
+
+    g_received = 0;
+    start = HAL_UptimeMs();
+    if (IOT_MQTT_Publish_Simple(handle, EXAMPLE_START_TOPIC, IOTX_MQTT_QOS0, "start", strlen("start")) < 0) {
+        HAL_Printf("IOT_MQTT_Publish_Simple failed\n");
+        goto out;
+    }
+    while (g_received < g_messages && HAL_UptimeMs() - start < EXAMPLE_TIMEOUT_MS) {
+        IOT_MQTT_Yield(handle, 10);
+    }
+    elapsed = HAL_UptimeMs() - start;
+
+    HAL_Printf("%6d subscriptions: %6d msgs in %5d ms, %8d msgs/s, %6.2f us/msg\n", subscriptions, g_received,
+               (int)elapsed, (int)((uint64_t)g_received * 1000 / (elapsed ? elapsed : 1)),
+               g_received ? (double)elapsed * 1000 / g_received : 0.0);
+    res = (g_received == g_messages) ? 0 : -1;
+
+out:
+    IOT_MQTT_Destroy(&handle);
+    return res;
+}
+
+int main(int argc, char *argv[])
+{
+    int subscriptions[EXAMPLE_RUNS_MAX] = {10, 100, 1000, 10000};
+    int runs = 4, idx, res = 0;
+    example_broker_t *broker = NULL;
+
+    if (argc > 1) {
+        g_messages = atoi(argv[1]);
+    }
+    if (argc > 2) {
+        for (runs = 0; runs < argc - 2 && runs < EXAMPLE_RUNS_MAX; runs++) {
+            subscriptions[runs] = atoi(argv[runs + 2]);
+        }
+    }
+    if (g_messages <= 0) {
+        HAL_Printf("usage: %s [messages] [subscriptions ...]\n", argv[0]);
+        return -1;
+    }
+
+    broker = example_broker_start(0, example_broker_cb, NULL);
+    if (broker == NULL) {
+        return -1;
+    }
+
+    for (idx = 0; idx < runs && res == 0; idx++) {
+        if (subscriptions[idx] >= 0) {
+            res = example_run(broker, subscriptions[idx]);
+        }
+    }
+
+    example_broker_stop(broker);
+
+    return res;
+}
@@ -0,0 +1,235 @@
+/*
+ * Copyright (C) 2015-2018 Alibaba Group Holding Limited
+ */
+
+/*
+ * Timer wheel the MQTT client tracks QoS1 publishes waiting for PUBACK with, checked in two parts.
+ *
+ * First the wheel alone under a mocked clock: timers due at random times, some of them past the
+ * span of the wheel, are added, one in ten is removed again, and the clock is moved on in random
+ * steps. Every timer left must expire exactly once, at the first collection after it is due, and
+ * never before.
+ *
+ * Then QoS1 publishes against the local stub broker of mqtt_example_broker.c, which holds back
+ * each PUBACK for a latency, so that many publishes wait for their PUBACK at once. Publishes
+ * in flight are bounded by IOTX_MC_REPUB_NUM_MAX, 2048 on the ubuntu board config, build with
+ * -DIOTX_MC_REPUB_NUM_MAX=10240 for 10k in flight. Longest IOT_MQTT_Yield() is printed, as it
+ * used to walk every publish in flight.
+ *
+ * usage: mqtt-example-wheel [timers] [messages] [latency]
+ *     timers       timers of mocked clock check, 20000 by default
+ *     messages     QoS1 publishes, 100000 by default
+ *     latency      milliseconds broker holds back each packet, 100 by default
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "infra_types.h"
+#include "infra_defs.h"
+#include "infra_list.h"
+#include "mqtt_api.h"
+#include "iotx_mqtt_timer_wheel.h"
+#include "mqtt_example_broker.h"
+
+#define EXAMPLE_WHEEL_SPAN_MS   ((uint64_t)IOTX_MC_WHEEL_TICK_MS << (IOTX_MC_WHEEL_SLOT_BITS * IOTX_MC_WHEEL_LEVEL_NUM))
+#define EXAMPLE_STEP_MAX_MS     50000
+#define EXAMPLE_TOPIC           "/sys/a1example/example1/thing/event/property/post"
+#define EXAMPLE_TIMEOUT_MS      60000
+
+void HAL_Printf(const char *fmt, ...);
+int HAL_Snprintf(char *str, const int len, const char *fmt, ...);
+uint64_t HAL_UptimeMs(void);
+void *HAL_Malloc(uint32_t size);
+void HAL_Free(void *ptr);
+
+typedef struct {
+    iotx_mc_wheel_timer_t   timer;
+    uint64_t                due_ms;
+    int                     removed;
+    int                     fired;
+} example_timer_t;
+
+/* random number of up to 62 bits, rand() alone gives as few as 15 */
+static uint64_t example_random(void)
+{
+    return ((uint64_t)(rand() & 0x7FFF) << 45) | ((uint64_t)(rand() & 0x7FFF) << 30) |
+           ((uint64_t)(rand() & 0x7FFF) << 15) | (uint64_t)(rand() & 0x7FFF);
+}
+
+static int example_wheel_check(int timers)
+{
+    iotx_mc_timer_wheel_t *wheel = NULL;
+    example_timer_t *entries = NULL, *entry = NULL, *next = NULL;
+    struct list_head expired;
+    uint64_t now_ms = 12345, prev_ms, last_due_ms = 0, start;
+    int idx, left = 0, collections = 0, early = 0, late = 0, removed_fired = 0, res = -1;
+
+    wheel = HAL_Malloc(sizeof(iotx_mc_timer_wheel_t));
+    entries = HAL_Malloc(sizeof(example_timer_t) * timers);
+    if (wheel == NULL || entries == NULL) {
+        goto out;
+    }
+    memset(entries, 0, sizeof(example_timer_t) * timers);
+
+    srand(1);
+    start = HAL_UptimeMs();
+    iotx_mc_timer_wheel_init(wheel, now_ms);
+    for (idx = 0; idx < timers; idx++) {
+        /* due anywhere up to twice the span of wheel, with one in four due within a second */
+        if (idx % 4 == 0) {
+            entries[idx].due_ms = now_ms + example_random() % 1000;
+        } else {
+            entries[idx].due_ms = now_ms + example_random() % (EXAMPLE_WHEEL_SPAN_MS * 2);
+        }
+        if (entries[idx].due_ms > last_due_ms) {
+            last_due_ms = entries[idx].due_ms;
+        }
+        iotx_mc_timer_wheel_add(wheel, &entries[idx].timer, entries[idx].due_ms);
+    }
+    for (idx = 0; idx < timers; idx += 10) {
+        iotx_mc_timer_wheel_del(wheel, &entries[idx].timer);
+        entries[idx].removed = 1;
+    }
+    left = timers - (timers + 9) / 10;
+
+    while (now_ms <= last_due_ms + IOTX_MC_WHEEL_TICK_MS) {
+        prev_ms = now_ms;
+        now_ms += 1 + example_random() % EXAMPLE_STEP_MAX_MS;
+        INIT_LIST_HEAD(&expired);
+        iotx_mc_timer_wheel_expire(wheel, now_ms, &expired);
+        collections++;
+
+        list_for_each_entry_safe(entry, next, &expired, timer.linked_list, example_timer_t) {
+            list_del(&entry->timer.linked_list);
+            INIT_LIST_HEAD(&entry->timer.linked_list);
+            if (entry->removed || entry->fired) {
+                removed_fired++;
+                continue;
+            }
+            entry->fired = 1;
+            left--;
+            if (entry->due_ms > now_ms) {
+                early++;
+            }
+            /* due by the previous collection, counting a tick as due once it has begun */
+            if ((entry->due_ms + IOTX_MC_WHEEL_TICK_MS - 1) / IOTX_MC_WHEEL_TICK_MS <= prev_ms / IOTX_MC_WHEEL_TICK_MS) {
+                late++;
+            }
+        }
+    }
+
+    HAL_Printf("wheel: %d timers over %d hours in %d collections, %d ms: %d early, %d late, %d not fired, "
+               "%d fired after removal or twice\n", timers, (int)(EXAMPLE_WHEEL_SPAN_MS * 2 / 3600000), collections,
+               (int)(HAL_UptimeMs() - start), early, late, left, removed_fired);
+    res = (early == 0 && late == 0 && left == 0 && removed_fired == 0 && wheel->count == 0) ? 0 : -1;
+
+out:
+    if (wheel != NULL) {
+        HAL_Free(wheel);
+    }
+    if (entries != NULL) {
+        HAL_Free(entries);
+    }
+
+    return res;
+}
+
+static int example_puback_run(int messages, int latency_ms)
+{
+    example_broker_t *broker = NULL;
+    iotx_mqtt_inflight_stats_t stats;
+    iotx_mqtt_param_t params;
+    void *handle = NULL;
+    char payload[64];
+    uint64_t start, elapsed, yield_start, yield_ms, yield_max_ms = 0;
+    int idx = 0, len, blocked = 0, failed = 0, res = -1;
+
+    broker = example_broker_start(0, NULL, NULL);
+    if (broker == NULL || example_broker_set_latency(broker, latency_ms) != 0) {
+        goto out;
+    }
+
+    memset(&params, 0, sizeof(params));
+    params.host = "127.0.0.1";
+    params.port = example_broker_port(broker);
+    params.client_id = "example-wheel";
+    params.username = "example";
+    params.password = "example";
+    params.request_timeout_ms = 10000;
+
+    handle = IOT_MQTT_Construct(&params);
+    if (handle == NULL) {
+        HAL_Printf("IOT_MQTT_Construct failed\n");
+        goto out;
+    }
+
+    /* PUBACKs of reports sent on connect are counted in @stats too */
+    memset(&stats, 0, sizeof(stats));
+    start = HAL_UptimeMs();
+    while ((idx < messages || stats.inflight > 0) && HAL_UptimeMs() - start < EXAMPLE_TIMEOUT_MS) {
+        /* send until the window of publishes waiting for PUBACK is full, then wait for some of them */
+        while (idx < messages) {
+            len = HAL_Snprintf(payload, sizeof(payload), "id=%d", idx);
+            res = IOT_MQTT_Publish_Simple(handle, EXAMPLE_TOPIC, IOTX_MQTT_QOS1, payload, len);
+            if (res == MQTT_PUBLISH_WOULD_BLOCK) {
+                blocked++;
+                break;
+            }
+            if (res < 0) {
+                failed++;
+            }
+            idx++;
+        }
+        yield_start = HAL_UptimeMs();
+        IOT_MQTT_Yield(handle, 1);
+        yield_ms = HAL_UptimeMs() - yield_start;
+        if (yield_ms > yield_max_ms) {
+            yield_max_ms = yield_ms;
+        }
+        IOT_MQTT_Get_Inflight_Stats(handle, &stats);
+    }
+    elapsed = HAL_UptimeMs() - start;
+
+    HAL_Printf("puback: %6d msgs in %5d ms, %7d msgs/s, latency %d ms, %u in flight at most, %d would block, "
+               "%u republished, %d failed, longest yield %d ms\n", idx, (int)elapsed,
+               (int)((uint64_t)idx * 1000 / (elapsed ? elapsed : 1)), latency_ms, stats.inflight_peak, blocked,
+               stats.republished, failed, (int)yield_max_ms);
+    res = (idx == messages && stats.inflight == 0 && failed == 0) ? 0 : -1;
+
+out:
+    if (handle != NULL) {
+        IOT_MQTT_Destroy(&handle);
+    }
+    if (broker != NULL) {
+        example_broker_stop(broker);
+    }
+
+    return res;
+}
+
+int main(int argc, char *argv[])
+{
+    int timers = 20000, messages = 100000, latency_ms = 100;
+
+    if (argc > 1) {
+        timers = atoi(argv[1]);
+    }
+    if (argc > 2) {
+        messages = atoi(argv[2]);
+    }
+    if (argc > 3) {
+        latency_ms = atoi(argv[3]);
+    }
+    if (timers <= 0 || messages <= 0 || latency_ms <= 0) {
+        HAL_Printf("usage: %s [timers] [messages] [latency]\n", argv[0]);
+        return -1;
+    }
+
+    if (example_wheel_check(timers) != 0) {
+        return -1;
+    }
+
+    return example_puback_run(messages, latency_ms);
+}
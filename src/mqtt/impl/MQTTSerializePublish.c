@@ -27,30 +27,28 @@ int MQTTSerialize_publishLength(int qos, MQTTString topicName, int payloadlen)
 
 
 /**
-  * Serializes the supplied publish data into the supplied buffer, ready for sending
-  * @param buf the buffer into which the packet will be serialized
+  * Serializes the fixed header, topic and packet id of a publish, the payload is expected to follow them
+  * @param buf the buffer into which the header will be serialized
   * @param buflen the length in bytes of the supplied buffer
   * @param dup integer - the MQTT dup flag
   * @param qos integer - the MQTT QoS value
   * @param retained integer - the MQTT retained flag
   * @param packetid integer - the MQTT packet identifier
   * @param topicName MQTTString - the MQTT topic in the publish
-  * @param payload byte buffer - the MQTT publish payload
   * @param payloadlen integer - the length of the MQTT payload
-  * @return the length of the serialized data.  <= 0 indicates error
+  * @return the length of the serialized header.  <= 0 indicates error
   */
-int MQTTSerialize_publish(unsigned char *buf, int buflen, unsigned char dup, int qos, unsigned char retained,
-                          unsigned short packetid,
-                          MQTTString topicName, unsigned char *payload, int payloadlen)
+int MQTTSerialize_publishHeader(unsigned char *buf, int buflen, unsigned char dup, int qos, unsigned char retained,
+                                unsigned short packetid,
+                                MQTTString topicName, int payloadlen)
 {
     unsigned char *ptr = buf;
     MQTTHeader header = {0};
     int rem_len = 0;
-    int rc = 0;
 
-    if (MQTTPacket_len(rem_len = MQTTSerialize_publishLength(qos, topicName, payloadlen)) > buflen) {
-        rc = MQTTPACKET_BUFFER_TOO_SHORT;
-        goto exit;
+    rem_len = MQTTSerialize_publishLength(qos, topicName, payloadlen);
+    if (MQTTPacket_len(rem_len) - payloadlen > buflen) {
+        return MQTTPACKET_BUFFER_TOO_SHORT;
     }
 
     MQTT_HEADER_SET_TYPE(header.byte, PUBLISH);
@@ -67,13 +65,41 @@ int MQTTSerialize_publish(unsigned char *buf, int buflen, unsigned char dup, int
         writeInt(&ptr, packetid);
     }
 
-    memcpy(ptr, payload, payloadlen);
-    ptr += payloadlen;
+    return ptr - buf;
+}
 
-    rc = ptr - buf;
 
-exit:
-    return rc;
+/**
+  * Serializes the supplied publish data into the supplied buffer, ready for sending
+  * @param buf the buffer into which the packet will be serialized
+  * @param buflen the length in bytes of the supplied buffer
+  * @param dup integer - the MQTT dup flag
+  * @param qos integer - the MQTT QoS value
+  * @param retained integer - the MQTT retained flag
+  * @param packetid integer - the MQTT packet identifier
+  * @param topicName MQTTString - the MQTT topic in the publish
+  * @param payload byte buffer - the MQTT publish payload
+  * @param payloadlen integer - the length of the MQTT payload
+  * @return the length of the serialized data.  <= 0 indicates error
+  */
+int MQTTSerialize_publish(unsigned char *buf, int buflen, unsigned char dup, int qos, unsigned char retained,
+                          unsigned short packetid,
+                          MQTTString topicName, unsigned char *payload, int payloadlen)
+{
+    int rc = 0;
+
+    if (MQTTPacket_len(MQTTSerialize_publishLength(qos, topicName, payloadlen)) > buflen) {
+        return MQTTPACKET_BUFFER_TOO_SHORT;
+    }
+
+    rc = MQTTSerialize_publishHeader(buf, buflen, dup, qos, retained, packetid, topicName, payloadlen);
+    if (rc <= 0) {
+        return rc;
+    }
+
+    memcpy(buf + rc, payload, payloadlen);
+
+    return rc + payloadlen;
 }
 
 
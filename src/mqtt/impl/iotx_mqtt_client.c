@@ -21,11 +21,85 @@ static void iotx_mc_release(iotx_mc_client_t *pclient)
 #endif
 }
 
+#ifdef PLATFORM_HAS_DYNMEM
+static iotx_mc_buf_owner_t *_buf_owner_new(void)
+{
+    iotx_mc_buf_owner_t *owner = mqtt_malloc(sizeof(iotx_mc_buf_owner_t));
+
+    if (owner == NULL) {
+        return NULL;
+    }
+    owner->lock = HAL_MutexCreate();
+    if (owner->lock == NULL) {
+        mqtt_free(owner);
+        return NULL;
+    }
+    owner->refcnt = 1;
+
+    return owner;
+}
+
+/* drop one reference of owner, the last one frees it */
+static void _buf_owner_put(iotx_mc_buf_owner_t *owner)
+{
+    uint32_t refcnt;
+
+    if (owner == NULL) {
+        return;
+    }
+
+    HAL_MutexLock(owner->lock);
+    refcnt = --owner->refcnt;
+    HAL_MutexUnlock(owner->lock);
+
+    if (refcnt == 0) {
+        HAL_MutexDestroy(owner->lock);
+        mqtt_free(owner);
+    }
+}
+
+static void _buf_get(iotx_mc_buf_t *buf)
+{
+    HAL_MutexLock(buf->owner->lock);
+    buf->refcnt++;
+    HAL_MutexUnlock(buf->owner->lock);
+}
+
+/* drop one reference of payload buffer, which may outlive its client */
+static void _buf_put(iotx_mc_buf_t *buf)
+{
+    iotx_mc_buf_owner_t *owner = buf->owner;
+    uint32_t refcnt;
+
+    HAL_MutexLock(owner->lock);
+    refcnt = --buf->refcnt;
+    HAL_MutexUnlock(owner->lock);
+
+    if (refcnt == 0) {
+        mqtt_free(buf);
+        _buf_owner_put(owner);
+    }
+}
+#endif
+
 #if !WITH_MQTT_ONLY_QOS0
 static void iotx_mc_pub_wait_list_init(iotx_mc_client_t *pClient)
 {
 #ifdef PLATFORM_HAS_DYNMEM
     INIT_LIST_HEAD(&pClient->list_pub_wait_ack);
+    pClient->pub_id_hash = NULL;
+    pClient->pub_id_hash_size = 0;
+    pClient->pub_wait_cnt = 0;
+    iotx_mc_timer_wheel_init(&pClient->pub_wheel, HAL_UptimeMs());
+#if WITH_MQTT_INFLIGHT_AIMD
+    pClient->inflight_window = IOTX_MC_INFLIGHT_WINDOW_MIN;
+#else
+    pClient->inflight_window = IOTX_MC_INFLIGHT_WINDOW_MAX;
+#endif
+    pClient->inflight_grow = 0;
+    pClient->inflight_slow_start = 1;
+    pClient->inflight_cut_time = 0;
+    memset(&pClient->inflight_stats, 0, sizeof(iotx_mqtt_inflight_stats_t));
 #else
     memset(pClient->list_pub_wait_ack, 0, sizeof(iotx_mc_pub_info_t) * IOTX_MC_PUBWAIT_LIST_MAX_LEN);
 #endif
@@ -37,8 +111,17 @@ static void iotx_mc_pub_wait_list_deinit(iotx_mc_client_t *pClient)
     iotx_mc_pub_info_t *node = NULL, *next_node = NULL;
     list_for_each_entry_safe(node, next_node, &pClient->list_pub_wait_ack, linked_list, iotx_mc_pub_info_t) {
         list_del(&node->linked_list);
+        if (node->ref != NULL) {
+            _buf_put(node->ref);
+        }
         mqtt_free(node);
     }
+    if (pClient->pub_id_hash) {
+        mqtt_free(pClient->pub_id_hash);
+        pClient->pub_id_hash = NULL;
+    }
+    pClient->pub_id_hash_size = 0;
+    pClient->pub_wait_cnt = 0;
 #else
     memset(pClient->list_pub_wait_ack, 0, sizeof(iotx_mc_pub_info_t) * IOTX_MC_PUBWAIT_LIST_MAX_LEN);
 #endif
@@ -145,6 +228,13 @@ static int iotx_mc_init(iotx_mc_client_t *pClient, iotx_mqtt_param_t *pInitParam
         goto RETURN;
     }
 
+#ifdef PLATFORM_HAS_DYNMEM
+    pClient->buf_owner = _buf_owner_new();
+    if (pClient->buf_owner == NULL) {
+        goto RETURN;
+    }
+#endif
+
     connectdata.MQTTVersion = IOTX_MC_MQTT_VERSION;
     connectdata.keepAliveInterval = pInitParams->keepalive_interval_ms / 1000;
 
@@ -198,6 +288,11 @@ static int iotx_mc_init(iotx_mc_client_t *pClient, iotx_mqtt_param_t *pInitParam
 #ifdef PLATFORM_HAS_DYNMEM
     INIT_LIST_HEAD(&pClient->list_sub_handle);
     INIT_LIST_HEAD(&pClient->list_sub_sync_ack);
+    rc = iotx_mc_topic_trie_init(&pClient->sub_trie);
+    if (SUCCESS_RETURN != rc) {
+        mc_state = IOTX_MC_STATE_INVALID;
+        goto RETURN;
+    }
 #endif
     /* Initialize MQTT connect parameter */
     rc = iotx_mc_set_connect_params(pClient, &connectdata);
@@ -225,6 +320,30 @@ static int iotx_mc_init(iotx_mc_client_t *pClient, iotx_mqtt_param_t *pInitParam
         goto RETURN;
     }
 
+#if WITH_MQTT_READ_AHEAD && !defined(ASYNC_PROTOCOL_STACK)
+#ifdef PLATFORM_HAS_DYNMEM
+    pClient->buf_read_ahead = mqtt_malloc(IOTX_MC_READ_AHEAD_LEN);
+    if (pClient->buf_read_ahead == NULL) {
+        rc = FAIL_RETURN;
+        goto RETURN;
+    }
+#endif
+    rc = iotx_net_set_read_ahead(&pClient->ipstack, pClient->buf_read_ahead, IOTX_MC_READ_AHEAD_LEN);
+    if (SUCCESS_RETURN != rc) {
+        goto RETURN;
+    }
+#endif
+#if WITH_MQTT_PUB_BATCH && !defined(ASYNC_PROTOCOL_STACK)
+#ifdef PLATFORM_HAS_DYNMEM
+    pClient->buf_batch = mqtt_malloc(IOTX_MC_PUB_BATCH_LEN);
+    if (pClient->buf_batch == NULL) {
+        rc = FAIL_RETURN;
+        goto RETURN;
+    }
+#endif
+    pClient->batch_len = 0;
+#endif
+
     mc_state = IOTX_MC_STATE_INITIALIZED;
     rc = SUCCESS_RETURN;
     mqtt_info("MQTT init success!");
@@ -241,6 +360,21 @@ RETURN :
             mqtt_free(pClient->buf_read);
             pClient->buf_read = NULL;
         }
+#if WITH_MQTT_READ_AHEAD && !defined(ASYNC_PROTOCOL_STACK)
+        if (pClient->buf_read_ahead != NULL) {
+            mqtt_free(pClient->buf_read_ahead);
+            pClient->buf_read_ahead = NULL;
+        }
+#endif
+#if WITH_MQTT_PUB_BATCH && !defined(ASYNC_PROTOCOL_STACK)
+        if (pClient->buf_batch != NULL) {
+            mqtt_free(pClient->buf_batch);
+            pClient->buf_batch = NULL;
+        }
+#endif
+        iotx_mc_topic_trie_deinit(&pClient->sub_trie);
+        _buf_owner_put(pClient->buf_owner);
+        pClient->buf_owner = NULL;
 #endif
         if (pClient->lock_list_pub) {
             HAL_MutexDestroy(pClient->lock_list_pub);
@@ -398,7 +532,7 @@ static int _alloc_recv_buffer(iotx_mc_client_t *c, int len)
 #endif
 }
 
-static int iotx_mc_send_packet(iotx_mc_client_t *c, char *buf, int length, iotx_time_t *time)
+static int iotx_mc_write_packet(iotx_mc_client_t *c, char *buf, int length, iotx_time_t *time)
 {
     int rc = FAIL_RETURN;
     int sent = 0;
@@ -426,6 +560,86 @@ static int iotx_mc_send_packet(iotx_mc_client_t *c, char *buf, int length, iotx_
     return rc;
 }
 
+#if WITH_MQTT_PUB_BATCH && !defined(ASYNC_PROTOCOL_STACK)
+/* send publishes queued in buf_batch with one write, i.e. one syscall or one TLS record, caller holds lock_write_buf */
+static int iotx_mc_batch_flush(iotx_mc_client_t *c, iotx_time_t *time)
+{
+    int rc;
+
+    if (c->batch_len == 0) {
+        return SUCCESS_RETURN;
+    }
+
+    rc = iotx_mc_write_packet(c, c->buf_batch, c->batch_len, time);
+    c->batch_len = 0;
+
+    return rc;
+}
+
+/* queue publish behind others in buf_batch, which is sent once full or IOTX_MC_PUB_BATCH_DELAY_MS after its first publish */
+static int iotx_mc_batch_append(iotx_mc_client_t *c, char *buf, int length, iotx_time_t *time)
+{
+    if (c->batch_len + length > IOTX_MC_PUB_BATCH_LEN) {
+        if (iotx_mc_batch_flush(c, time) != SUCCESS_RETURN) {
+            return MQTT_NETWORK_ERROR;
+        }
+    }
+
+    if (length > IOTX_MC_PUB_BATCH_LEN) {
+        return iotx_mc_write_packet(c, buf, length, time);
+    }
+
+    if (c->batch_len == 0) {
+        iotx_time_init(&c->batch_deadline);
+        utils_time_countdown_ms(&c->batch_deadline, IOTX_MC_PUB_BATCH_DELAY_MS);
+    }
+    memcpy(c->buf_batch + c->batch_len, buf, length);
+    c->batch_len += length;
+
+    if (utils_time_is_expired(&c->batch_deadline)) {
+        return iotx_mc_batch_flush(c, time);
+    }
+
+    return SUCCESS_RETURN;
+}
+
+/* send batch whose delay is over, otherwise bring @wait forward to its deadline */
+static void iotx_mc_batch_poll(iotx_mc_client_t *c, iotx_time_t *wait)
+{
+    iotx_time_t timer;
+    int rc = SUCCESS_RETURN;
+
+    HAL_MutexLock(c->lock_write_buf);
+    if (c->batch_len) {
+        if (utils_time_is_expired(&c->batch_deadline)) {
+            iotx_time_init(&timer);
+            utils_time_countdown_ms(&timer, c->request_timeout_ms);
+            rc = iotx_mc_batch_flush(c, &timer);
+        } else if (iotx_time_left(&c->batch_deadline) < iotx_time_left(wait)) {
+            *wait = c->batch_deadline;
+        }
+    }
+    HAL_MutexUnlock(c->lock_write_buf);
+
+    if (rc != SUCCESS_RETURN) {
+        mqtt_err("send publish batch failed, rc = %d", rc);
+        iotx_mc_set_client_state(c, IOTX_MC_STATE_DISCONNECTED);
+    }
+}
+#endif
+
+static int iotx_mc_send_packet(iotx_mc_client_t *c, char *buf, int length, iotx_time_t *time)
+{
+#if WITH_MQTT_PUB_BATCH && !defined(ASYNC_PROTOCOL_STACK)
+    /* queued publishes go out first, nothing may overtake them */
+    if (c != NULL && c->batch_len && iotx_mc_batch_flush(c, time) != SUCCESS_RETURN) {
+        return MQTT_NETWORK_ERROR;
+    }
+#endif
+
+    return iotx_mc_write_packet(c, buf, length, time);
+}
+
 int MQTTConnect(iotx_mc_client_t *pClient)
 {
     MQTTPacket_connectData *pConnectParams;
@@ -439,6 +653,11 @@ int MQTTConnect(iotx_mc_client_t *pClient)
     pConnectParams = &pClient->connect_data;
     HAL_MutexLock(pClient->lock_write_buf);
 
+#if WITH_MQTT_PUB_BATCH && !defined(ASYNC_PROTOCOL_STACK)
+    /* publishes queued for previous connection are lost with it, QoS1 ones will be republished */
+    pClient->batch_len = 0;
+#endif
+
     len = _get_connect_length(pConnectParams);
 
     if (_alloc_send_buffer(pClient, len) != SUCCESS_RETURN) {
@@ -823,10 +1042,120 @@ static int _mqtt_connect(void *client)
 }
 
 #if !WITH_MQTT_ONLY_QOS0
-static int iotx_mc_push_pubInfo_to(iotx_mc_client_t *c, int len, unsigned short msgId, iotx_mc_pub_info_t **node)
+#ifdef PLATFORM_HAS_DYNMEM
+/* double buckets of packet id hash, lock_list_pub held by caller */
+static int _pub_id_hash_grow(iotx_mc_client_t *c)
+{
+    uint32_t idx = 0;
+    uint32_t size = 0;
+    struct list_head *table = NULL;
+    iotx_mc_pub_info_t *node = NULL, *next_node = NULL;
+
+    size = (c->pub_id_hash_size == 0) ? IOTX_MC_PUB_ID_HASH_SIZE : c->pub_id_hash_size * 2;
+    table = mqtt_malloc(size * sizeof(struct list_head));
+    if (table == NULL) {
+        return FAIL_RETURN;
+    }
+    for (idx = 0; idx < size; idx++) {
+        INIT_LIST_HEAD(&table[idx]);
+    }
+
+    for (idx = 0; idx < c->pub_id_hash_size; idx++) {
+        list_for_each_entry_safe(node, next_node, &c->pub_id_hash[idx], hash_list, iotx_mc_pub_info_t) {
+            list_del(&node->hash_list);
+            list_add_tail(&node->hash_list, &table[node->msg_id & (size - 1)]);
+        }
+    }
+
+    if (c->pub_id_hash) {
+        mqtt_free(c->pub_id_hash);
+    }
+    c->pub_id_hash = table;
+    c->pub_id_hash_size = size;
+
+    return SUCCESS_RETURN;
+}
+
+/* unlink a node from list_pub_wait_ack, its id hash and republish wheel, then free it */
+static void _pub_info_release(iotx_mc_client_t *c, iotx_mc_pub_info_t *node)
+{
+    list_del(&node->linked_list);
+    list_del(&node->hash_list);
+    iotx_mc_timer_wheel_del(&c->pub_wheel, &node->timer);
+    c->pub_wait_cnt--;
+    if (node->ref != NULL) {
+        _buf_put(node->ref);
+    }
+    mqtt_free(node);
+}
+
+#if WITH_MQTT_INFLIGHT_AIMD
+/* halve inflight window, at most once per smoothed RTT so that one congestion cuts it once */
+static void _inflight_cut(iotx_mc_client_t *c)
+{
+    uint64_t now = HAL_UptimeMs();
+
+    if (!c->inflight_slow_start && now - c->inflight_cut_time < c->inflight_stats.rtt_srtt_ms) {
+        return;
+    }
+
+    c->inflight_slow_start = 0;
+    c->inflight_cut_time = now;
+    c->inflight_grow = 0;
+    c->inflight_window /= 2;
+    if (c->inflight_window < IOTX_MC_INFLIGHT_WINDOW_MIN) {
+        c->inflight_window = IOTX_MC_INFLIGHT_WINDOW_MIN;
+    }
+}
+#endif
+
+/* sample RTT from PUBACK of @node, and adapt inflight window to it with WITH_MQTT_INFLIGHT_AIMD */
+static void _inflight_on_ack(iotx_mc_client_t *c, iotx_mc_pub_info_t *node)
+{
+    iotx_mqtt_inflight_stats_t *stats = &c->inflight_stats;
+    uint32_t rtt = 0;
+
+    stats->acked++;
+
+    /* PUBACK of a republished message may answer either copy of it */
+    if (node->retrans) {
+        return;
+    }
+
+    rtt = utils_time_spend(&node->pub_start_time);
+    stats->rtt_last_ms = rtt;
+    if (stats->rtt_samples == 0 || rtt < stats->rtt_min_ms) {
+        stats->rtt_min_ms = rtt;
+    }
+    stats->rtt_srtt_ms = (stats->rtt_samples == 0) ? rtt : (stats->rtt_srtt_ms * 7 + rtt) / 8;
+    stats->rtt_samples++;
+
+#if WITH_MQTT_INFLIGHT_AIMD
+    if (rtt - stats->rtt_min_ms > IOTX_MC_INFLIGHT_QUEUE_DELAY_MS) {
+        /* PUBACK delayed beyond path RTT means broker queues, back off multiplicatively */
+        _inflight_cut(c);
+        return;
+    }
+
+    /* grow only a window in use, by one per PUBACK in slow start, otherwise by one per window of PUBACKs */
+    if (c->pub_wait_cnt * 2 < c->inflight_window) {
+        return;
+    }
+    if (c->inflight_slow_start || ++c->inflight_grow >= c->inflight_window) {
+        c->inflight_grow = 0;
+        if (c->inflight_window < IOTX_MC_INFLIGHT_WINDOW_MAX) {
+            c->inflight_window++;
+        }
+    }
+#endif
+}
+#endif
+
+/* keep publish @packet for republish, it is copied unless it lies in payload buffer @ref */
+static int iotx_mc_push_pubInfo_to(iotx_mc_client_t *c, char *packet, int len, iotx_mc_buf_t *ref,
+                                   unsigned short msgId, iotx_mc_pub_info_t **node)
 {
 #ifdef PLATFORM_HAS_DYNMEM
-    int list_number;
     iotx_mc_pub_info_t *repubInfo;
 #else
     int idx;
@@ -837,7 +1166,7 @@ static int iotx_mc_push_pubInfo_to(iotx_mc_client_t *c, int len, unsigned short
         return FAIL_RETURN;
     }
 
-    if ((len < 0) || (len > c->buf_size_send)) {
+    if ((len < 0) || (ref == NULL && len > c->buf_size_send)) {
         mqtt_err("the param of len is error!");
 #ifndef PLATFORM_HAS_DYNMEM
         if (len >= c->buf_size_send) {
@@ -848,14 +1177,23 @@ static int iotx_mc_push_pubInfo_to(iotx_mc_client_t *c, int len, unsigned short
     }
 
 #ifdef PLATFORM_HAS_DYNMEM
-    list_number = list_entry_number(&c->list_pub_wait_ack);
+    if (c->pub_wait_cnt >= c->inflight_window) {
+        c->inflight_stats.would_block++;
+        mqtt_debug("publish would block, %u publishes wait for PUBACK", c->pub_wait_cnt);
+        return MQTT_PUBLISH_WOULD_BLOCK;
+    }
 
-    if (list_number >= IOTX_MC_REPUB_NUM_MAX) {
-        mqtt_err("more than %u elements in republish list. List overflow!", list_number);
+    if (c->pub_wait_cnt >= IOTX_MC_REPUB_NUM_MAX) {
+        mqtt_err("more than %u elements in republish list. List overflow!", c->pub_wait_cnt);
         return FAIL_RETURN;
     }
 
-    repubInfo = (iotx_mc_pub_info_t *)mqtt_malloc(sizeof(iotx_mc_pub_info_t) + len);
+    if (c->pub_wait_cnt >= c->pub_id_hash_size && _pub_id_hash_grow(c) != SUCCESS_RETURN) {
+        mqtt_err("grow packet id hash failed!");
+        return FAIL_RETURN;
+    }
+
+    repubInfo = (iotx_mc_pub_info_t *)mqtt_malloc(sizeof(iotx_mc_pub_info_t) + (ref == NULL ? len : 0));
     if (NULL == repubInfo) {
         mqtt_err("run iotx_memory_malloc is error!");
         return FAIL_RETURN;
@@ -865,12 +1203,27 @@ static int iotx_mc_push_pubInfo_to(iotx_mc_client_t *c, int len, unsigned short
     repubInfo->msg_id = msgId;
     repubInfo->len = len;
     iotx_time_start(&repubInfo->pub_start_time);
-    repubInfo->buf = (unsigned char *)repubInfo + sizeof(iotx_mc_pub_info_t);
-
-    memcpy(repubInfo->buf, c->buf_send, len);
+    if (ref != NULL) {
+        /* republish straight from payload buffer, which is kept until acked */
+        repubInfo->buf = (unsigned char *)packet;
+        repubInfo->ref = ref;
+        _buf_get(ref);
+    } else {
+        repubInfo->buf = (unsigned char *)repubInfo + sizeof(iotx_mc_pub_info_t);
+        repubInfo->ref = NULL;
+        memcpy(repubInfo->buf, packet, len);
+    }
     INIT_LIST_HEAD(&repubInfo->linked_list);
 
     list_add_tail(&repubInfo->linked_list, &c->list_pub_wait_ack);
+    list_add_tail(&repubInfo->hash_list, &c->pub_id_hash[msgId & (c->pub_id_hash_size - 1)]);
+    /* republish once waiting longer than 2 times of request timeout */
+    iotx_mc_timer_wheel_add(&c->pub_wheel, &repubInfo->timer, HAL_UptimeMs() + c->request_timeout_ms * 2 + 1);
+    c->pub_wait_cnt++;
+    repubInfo->retrans = 0;
+    if (c->pub_wait_cnt > c->inflight_stats.inflight_peak) {
+        c->inflight_stats.inflight_peak = c->pub_wait_cnt;
+    }
 
     *node = repubInfo;
     return SUCCESS_RETURN;
@@ -881,13 +1234,14 @@ static int iotx_mc_push_pubInfo_to(iotx_mc_client_t *c, int len, unsigned short
             c->list_pub_wait_ack[idx].msg_id = msgId;
             c->list_pub_wait_ack[idx].len = len;
             iotx_time_start(&c->list_pub_wait_ack[idx].pub_start_time);
-            memcpy(c->list_pub_wait_ack[idx].buf, c->buf_send, len);
+            memcpy(c->list_pub_wait_ack[idx].buf, packet, len);
             c->list_pub_wait_ack[idx].used = 1;
             *node = &c->list_pub_wait_ack[idx];
             return SUCCESS_RETURN;
         }
     }
 
+    /* static list has no inflight window, a full list stays an error as callers of static builds expect */
     mqtt_err("IOTX_MC_PUBWAIT_LIST_MAX_LEN is too short");
 
     return FAIL_RETURN;
@@ -897,16 +1251,21 @@ static int iotx_mc_push_pubInfo_to(iotx_mc_client_t *c, int len, unsigned short
 static int iotx_mc_mask_pubInfo_from(iotx_mc_client_t *c, uint16_t msgId)
 {
 #ifdef PLATFORM_HAS_DYNMEM
-    iotx_mc_pub_info_t *node = NULL;
+    iotx_mc_pub_info_t *node = NULL, *next_node = NULL;
 
     if (!c) {
         return FAIL_RETURN;
     }
 
+    /* acked node is found by packet id and released at once */
     HAL_MutexLock(c->lock_list_pub);
-    list_for_each_entry(node, &c->list_pub_wait_ack, linked_list, iotx_mc_pub_info_t) {
-        if (node->msg_id == msgId) {
-            node->node_state = IOTX_MC_NODE_STATE_INVALID; /* mark as invalid node */
+    if (c->pub_id_hash != NULL) {
+        list_for_each_entry_safe(node, next_node, &c->pub_id_hash[msgId & (c->pub_id_hash_size - 1)], hash_list,
+                                 iotx_mc_pub_info_t) {
+            if (node->msg_id == msgId) {
+                _inflight_on_ack(c, node);
+                _pub_info_release(c, node);
+            }
         }
     }
     HAL_MutexUnlock(c->lock_list_pub);
@@ -945,7 +1304,10 @@ static int MQTTPubInfoProc(iotx_mc_client_t *pClient)
     int rc = 0;
     iotx_mc_state_t state = IOTX_MC_STATE_INVALID;
 #ifdef PLATFORM_HAS_DYNMEM
-    iotx_mc_pub_info_t *node = NULL, *next_node = NULL;
+    uint64_t now_ms = 0;
+    struct list_head expired;
+    iotx_mc_wheel_timer_t *timer = NULL, *next_timer = NULL;
+    iotx_mc_pub_info_t *node = NULL;
 #else
     int idx;
 #endif
@@ -956,31 +1318,39 @@ static int MQTTPubInfoProc(iotx_mc_client_t *pClient)
 
     HAL_MutexLock(pClient->lock_list_pub);
 #ifdef PLATFORM_HAS_DYNMEM
-    list_for_each_entry_safe(node, next_node, &pClient->list_pub_wait_ack, linked_list, iotx_mc_pub_info_t) {
-        /* remove invalid node */
-        if (IOTX_MC_NODE_STATE_INVALID == node->node_state) {
-            list_del(&node->linked_list);
-            mqtt_free(node);
-            continue;
-        }
+    /* acked nodes have been released in iotx_mc_mask_pubInfo_from(), only timeout ones are visited here */
+    state = iotx_mc_get_client_state(pClient);
+    if (state != IOTX_MC_STATE_CONNECTED) {
+        HAL_MutexUnlock(pClient->lock_list_pub);
+        return SUCCESS_RETURN;
+    }
 
-        state = iotx_mc_get_client_state(pClient);
-        if (state != IOTX_MC_STATE_CONNECTED) {
-            continue;
-        }
+    INIT_LIST_HEAD(&expired);
+    now_ms = HAL_UptimeMs();
+    iotx_mc_timer_wheel_expire(&pClient->pub_wheel, now_ms, &expired);
 
-        /* check the request if timeout or not */
-        if (utils_time_spend(&node->pub_start_time) <= (pClient->request_timeout_ms * 2)) {
+    list_for_each_entry_safe(timer, next_timer, &expired, linked_list, iotx_mc_wheel_timer_t) {
+        node = list_entry(timer, iotx_mc_pub_info_t, timer);
+        list_del(&timer->linked_list);
+
+        if (MQTT_NETWORK_ERROR == rc) {
+            /* keep it overdue, republish after reconnected */
+            iotx_mc_timer_wheel_add(&pClient->pub_wheel, timer, now_ms);
             continue;
         }
 
         /* If wait ACK timeout, republish */
+        node->retrans = 1;
+        pClient->inflight_stats.republished++;
+#if WITH_MQTT_INFLIGHT_AIMD
+        _inflight_cut(pClient);
+#endif
         rc = MQTTRePublish(pClient, (char *)node->buf, node->len);
         iotx_time_start(&node->pub_start_time);
+        iotx_mc_timer_wheel_add(&pClient->pub_wheel, timer, now_ms + pClient->request_timeout_ms * 2 + 1);
 
         if (MQTT_NETWORK_ERROR == rc) {
             iotx_mc_set_client_state(pClient, IOTX_MC_STATE_DISCONNECTED);
-            break;
         }
     }
 #else
@@ -1035,6 +1405,11 @@ static int iotx_mc_handle_recv_PUBACK(iotx_mc_client_t *c)
     }
 
     (void)iotx_mc_mask_pubInfo_from(c, mypacketid);
+#if WITH_MQTT_OUTBOX && defined(PLATFORM_HAS_DYNMEM)
+    if (c->outbox != NULL) {
+        iotx_mc_outbox_ack(c->outbox, mypacketid);
+    }
+#endif
 
     /* call callback function to notify that PUBLISH is successful */
     if (NULL != c->handle_event.h_fp) {
@@ -1140,8 +1515,6 @@ static int iotx_mc_handle_recv_SUBACK(iotx_mc_client_t *c)
 }
 
 #if WITH_MQTT_ZIP_TOPIC
-#define MQTT_ZIP_PATH_DEFAULT_LEN (32)
-
 static int iotx_mc_get_zip_topic(const char *path, int len, char outbuf[], int outlen)
 {
     unsigned char comp_data[MQTT_ZIP_PATH_DEFAULT_LEN] = {0};
@@ -1154,6 +1527,56 @@ static int iotx_mc_get_zip_topic(const char *path, int len, char outbuf[], int o
     memcpy(outbuf, comp_data, outlen > MQTT_ZIP_PATH_DEFAULT_LEN ? MQTT_ZIP_PATH_DEFAULT_LEN : outlen);
     return 0;
 }
+
+#ifdef PLATFORM_HAS_DYNMEM
+/* digest of inbound topic, taken from c->zip_cache when the same topic was seen before, only used on reading path */
+static const char *iotx_mc_zip_cache_get(iotx_mc_client_t *c, const char *topic, uint32_t len, char *outbuf)
+{
+    uint32_t hash = 2166136261u;
+    uint32_t idx = 0;
+    iotx_mc_zip_entry_t *entry = NULL;
+
+    for (idx = 0; idx < len; idx++) {
+        hash = (hash ^ (unsigned char)topic[idx]) * 16777619u;
+    }
+    entry = &c->zip_cache[hash % IOTX_MC_ZIP_CACHE_NUM];
+
+    if (entry->topic != NULL && entry->topic_len == len && memcmp(entry->topic, topic, len) == 0) {
+        return entry->digest;
+    }
+
+    iotx_mc_get_zip_topic(topic, len, outbuf, MQTT_ZIP_PATH_DEFAULT_LEN);
+    if (len > 0xFFFF) {
+        return outbuf;
+    }
+
+    if (entry->topic == NULL || entry->topic_len < len) {
+        if (entry->topic != NULL) {
+            mqtt_free(entry->topic);
+        }
+        entry->topic = mqtt_malloc(len);
+        if (entry->topic == NULL) {
+            return outbuf;
+        }
+    }
+    memcpy(entry->topic, topic, len);
+    entry->topic_len = len;
+    memcpy(entry->digest, outbuf, MQTT_ZIP_PATH_DEFAULT_LEN);
+
+    return entry->digest;
+}
+
+static void iotx_mc_zip_cache_deinit(iotx_mc_client_t *c)
+{
+    int idx = 0;
+
+    for (idx = 0; idx < IOTX_MC_ZIP_CACHE_NUM; idx++) {
+        if (c->zip_cache[idx].topic != NULL) {
+            mqtt_free(c->zip_cache[idx].topic);
+        }
+    }
+}
+#endif
 #endif
 
 static char iotx_mc_is_topic_matched(char *topicFilter, MQTTString *topicName)
@@ -1195,14 +1618,138 @@ static char iotx_mc_is_topic_matched(char *topicFilter, MQTTString *topicName)
     return (curn == curn_end) && (*curf == '\0');
 }
 
+static int iotx_mc_check_handle_is_identical_ex(iotx_mc_topic_handle_t *messageHandlers1,
+        iotx_mc_topic_handle_t *messageHandler2);
+static int iotx_mc_check_handle_is_identical(iotx_mc_topic_handle_t *messageHandlers1,
+        iotx_mc_topic_handle_t *messageHandler2);
+
+#ifdef PLATFORM_HAS_DYNMEM
+/* handles found by one lookup, callbacks are invoked after lock_generic released */
+typedef struct {
+    iotx_mqtt_event_handle_t    stack[IOTX_MC_DELIVER_HANDLE_NUM];
+    iotx_mqtt_event_handle_t   *handles;
+    int                         size;
+    int                         count;
+} iotx_mc_deliver_ctx_t;
+
+static int iotx_mc_topic_is_wildcard(iotx_mc_topic_handle_t *handler)
+{
+#if WITH_MQTT_ZIP_TOPIC
+    return (handler->topic_type == TOPIC_FILTER_TYPE);
+#else
+    return (strchr(handler->topic_filter, '+') != NULL || strchr(handler->topic_filter, '#') != NULL);
+#endif
+}
+
+static uint32_t iotx_mc_topic_key_len(iotx_mc_topic_handle_t *handler)
+{
+#if WITH_MQTT_ZIP_TOPIC
+    if (handler->topic_type == TOPIC_NAME_TYPE) {
+        return MQTT_ZIP_PATH_DEFAULT_LEN;
+    }
+#endif
+    return strlen(handler->topic_filter);
+}
+
+static int _deliver_collect(iotx_mc_trie_entry_t *entry, void *ctx)
+{
+    iotx_mc_deliver_ctx_t *deliver = (iotx_mc_deliver_ctx_t *)ctx;
+    iotx_mc_topic_handle_t *node = list_entry(entry, iotx_mc_topic_handle_t, trie_entry);
+
+    if (NULL == node->handle.h_fp) {
+        return 0;
+    }
+
+    if (deliver->count == deliver->size) {
+        iotx_mqtt_event_handle_t *handles = NULL;
+
+        handles = mqtt_malloc(deliver->size * 2 * sizeof(iotx_mqtt_event_handle_t));
+        if (handles == NULL) {
+            mqtt_err("too many handles matched, drop the rest");
+            return 1;
+        }
+        memcpy(handles, deliver->handles, deliver->count * sizeof(iotx_mqtt_event_handle_t));
+        if (deliver->handles != deliver->stack) {
+            mqtt_free(deliver->handles);
+        }
+        deliver->handles = handles;
+        deliver->size *= 2;
+    }
+
+    deliver->handles[deliver->count++] = node->handle;
+    return 0;
+}
+
+typedef struct {
+    iotx_mc_topic_handle_t     *handler;
+    int                         dup;
+} iotx_mc_dup_ctx_t;
+
+static int _sub_handle_check_dup(iotx_mc_trie_entry_t *entry, void *ctx)
+{
+    iotx_mc_dup_ctx_t *dup_ctx = (iotx_mc_dup_ctx_t *)ctx;
+    iotx_mc_topic_handle_t *node = list_entry(entry, iotx_mc_topic_handle_t, trie_entry);
+
+#if defined(INSPECT_MQTT_FLOW) && defined (INFRA_LOG)
+#if WITH_MQTT_ZIP_TOPIC
+    HEXDUMP_DEBUG(node->topic_filter, MQTT_ZIP_PATH_DEFAULT_LEN);
+#else
+    mqtt_warning("node->topic: %s", node->topic_filter);
+#endif
+#endif
+    if (0 == iotx_mc_check_handle_is_identical(node, dup_ctx->handler)) {
+        dup_ctx->dup = 1;
+        return 1;
+    }
+
+    return 0;
+}
+
+/* link handler into list_sub_handle and its index, 1 returned if identical one exists, lock_generic held by caller */
+static int iotx_mc_sub_handle_link(iotx_mc_client_t *c, iotx_mc_topic_handle_t *handler)
+{
+    int rc = 0;
+    iotx_mc_dup_ctx_t dup_ctx;
+
+    memset(&dup_ctx, 0, sizeof(iotx_mc_dup_ctx_t));
+    dup_ctx.handler = handler;
+    iotx_mc_topic_trie_find(&c->sub_trie, handler->topic_filter, iotx_mc_topic_key_len(handler),
+                            iotx_mc_topic_is_wildcard(handler), _sub_handle_check_dup, &dup_ctx);
+    if (dup_ctx.dup) {
+        return 1;
+    }
+
+    rc = iotx_mc_topic_trie_insert(&c->sub_trie, &handler->trie_entry, handler->topic_filter,
+                                   iotx_mc_topic_key_len(handler), iotx_mc_topic_is_wildcard(handler));
+    if (rc != SUCCESS_RETURN) {
+        return rc;
+    }
+    list_add_tail(&handler->linked_list, &c->list_sub_handle);
+
+    return 0;
+}
+
+static int _unsub_handle_collect(iotx_mc_trie_entry_t *entry, void *ctx)
+{
+    iotx_mc_topic_handle_t *node = list_entry(entry, iotx_mc_topic_handle_t, trie_entry);
+
+    if (0 == iotx_mc_check_handle_is_identical_ex(node, (iotx_mc_topic_handle_t *)ctx)) {
+        /* borrow linked_list to move it out of list_sub_handle */
+        list_del(&node->linked_list);
+        list_add_tail(&node->linked_list, &((iotx_mc_topic_handle_t *)ctx)->linked_list);
+    }
+
+    return 0;
+}
+#endif
+
 static void iotx_mc_deliver_message(iotx_mc_client_t *c, MQTTString *topicName, iotx_mqtt_topic_info_pt topic_msg)
 {
     int flag_matched = 0;
     MQTTString *compare_topic = NULL;
-#ifdef PLATFORM_HAS_DYNMEM
-    iotx_mc_topic_handle_t *node = NULL;
-#else
     int idx = 0;
+#ifdef PLATFORM_HAS_DYNMEM
+    iotx_mc_deliver_ctx_t deliver;
 #endif
 
 #if WITH_MQTT_ZIP_TOPIC
@@ -1228,34 +1775,46 @@ static void iotx_mc_deliver_message(iotx_mc_client_t *c, MQTTString *topicName,
         net_topic_len = topicName->lenstring.len;
     }
     md5_topic.cstring = NULL;
-    md5_topic.lenstring.data = md5_topic_data;
     md5_topic.lenstring.len = MQTT_ZIP_PATH_DEFAULT_LEN;
+#ifdef PLATFORM_HAS_DYNMEM
+    md5_topic.lenstring.data = (char *)iotx_mc_zip_cache_get(c, net_topic, net_topic_len, md5_topic_data);
+#else
+    md5_topic.lenstring.data = md5_topic_data;
     iotx_mc_get_zip_topic(net_topic, net_topic_len, md5_topic_data, MQTT_ZIP_PATH_DEFAULT_LEN);
+#endif
     compare_topic = &md5_topic;
 #else
     compare_topic = topicName;
 #endif
 
     /* we have to find the right message handler - indexed by topic */
-    HAL_MutexLock(c->lock_generic);
 #ifdef PLATFORM_HAS_DYNMEM
-    list_for_each_entry(node, &c->list_sub_handle, linked_list, iotx_mc_topic_handle_t) {
-        if (MQTTPacket_equals(compare_topic, (char *)node->topic_filter)
-            || iotx_mc_is_topic_matched((char *)node->topic_filter, topicName)) {
-            mqtt_debug("topic be matched");
+    memset(&deliver, 0, sizeof(iotx_mc_deliver_ctx_t));
+    deliver.handles = deliver.stack;
+    deliver.size = IOTX_MC_DELIVER_HANDLE_NUM;
 
-            HAL_MutexUnlock(c->lock_generic);
-            if (NULL != node->handle.h_fp) {
-                iotx_mqtt_event_msg_t msg;
-                msg.event_type = IOTX_MQTT_EVENT_PUBLISH_RECEIVED;
-                msg.msg = (void *)topic_msg;
-                _handle_event(&node->handle, c, &msg);
-                flag_matched = 1;
-            }
-            HAL_MutexLock(c->lock_generic);
-        }
+    HAL_MutexLock(c->lock_generic);
+    iotx_mc_topic_trie_match(&c->sub_trie,
+                             compare_topic->cstring ? compare_topic->cstring : compare_topic->lenstring.data,
+                             compare_topic->cstring ? strlen(compare_topic->cstring) : compare_topic->lenstring.len,
+                             topicName->lenstring.data, topicName->lenstring.len,
+                             _deliver_collect, &deliver);
+    HAL_MutexUnlock(c->lock_generic);
+
+    for (idx = 0; idx < deliver.count; idx++) {
+        iotx_mqtt_event_msg_t msg;
+
+        mqtt_debug("topic be matched");
+        msg.event_type = IOTX_MQTT_EVENT_PUBLISH_RECEIVED;
+        msg.msg = (void *)topic_msg;
+        _handle_event(&deliver.handles[idx], c, &msg);
+        flag_matched = 1;
+    }
+    if (deliver.handles != deliver.stack) {
+        mqtt_free(deliver.handles);
     }
 #else
+    HAL_MutexLock(c->lock_generic);
     for (idx = 0; idx < IOTX_MC_SUBHANDLE_LIST_MAX_LEN; idx++) {
         if ((c->list_sub_handle[idx].used == 1) &&
             (MQTTPacket_equals(compare_topic, (char *)c->list_sub_handle[idx].topic_filter)
@@ -1273,8 +1832,8 @@ static void iotx_mc_deliver_message(iotx_mc_client_t *c, MQTTString *topicName,
             HAL_MutexLock(c->lock_generic);
         }
     }
-#endif
     HAL_MutexUnlock(c->lock_generic);
+#endif
 
     if (0 == flag_matched) {
         mqtt_info("NO matching any topic, call default handle function");
@@ -1581,10 +2140,16 @@ static int iotx_mc_cycle(iotx_mc_client_t *c, iotx_time_t *timer)
     return rc;
 }
 
+static int iotx_mc_keepalive_sub(iotx_mc_client_t *pClient);
+#if WITH_MQTT_OUTBOX && defined(PLATFORM_HAS_DYNMEM)
+static void iotx_mc_outbox_drain(iotx_mc_client_t *c);
+#endif
+
 void _mqtt_cycle(void *client)
 {
     int                 rc = SUCCESS_RETURN;
     iotx_time_t         time;
+    iotx_time_t         wait;
     iotx_mc_client_t *pClient = (iotx_mc_client_t *)client;
 
     iotx_time_init(&time);
@@ -1597,10 +2162,27 @@ void _mqtt_cycle(void *client)
             mqtt_err("error occur rc=%d", rc);
         }
 
-        HAL_MutexLock(pClient->lock_yield);
-
-        /* acquire package in cycle, such as PINGRESP or PUBLISH */
-        rc = iotx_mc_cycle(pClient, &time);
+        HAL_MutexLock(pClient->lock_yield);
+
+        wait = time;
+#ifndef ASYNC_PROTOCOL_STACK
+        /* ping falling due inside a long cycle is sent on time rather than by next yield */
+        if (wrapper_mqtt_check_state(pClient)) {
+            iotx_mc_keepalive_sub(pClient);
+            if (iotx_time_left(&pClient->next_ping_time) < iotx_time_left(&time)) {
+                wait = pClient->next_ping_time;
+            }
+#if WITH_MQTT_OUTBOX && defined(PLATFORM_HAS_DYNMEM)
+            iotx_mc_outbox_drain(pClient);
+#endif
+#if WITH_MQTT_PUB_BATCH
+            iotx_mc_batch_poll(pClient, &wait);
+#endif
+        }
+#endif
+
+        /* acquire package in cycle, such as PINGRESP or PUBLISH, read blocks until one arrives or @wait is due */
+        rc = iotx_mc_cycle(pClient, &wait);
         if (SUCCESS_RETURN == rc) {
 #ifndef ASYNC_PROTOCOL_STACK
 #if !WITH_MQTT_ONLY_QOS0
@@ -1611,11 +2193,14 @@ void _mqtt_cycle(void *client)
         }
         HAL_MutexUnlock(pClient->lock_yield);
 
-        left_t = iotx_time_left(&time);
-        if (left_t < 10) {
-            HAL_SleepMs(left_t);
-        } else {
-            HAL_SleepMs(10);
+        /* go straight back to read for next packet, only back off when something went wrong */
+        if (SUCCESS_RETURN != rc) {
+            left_t = iotx_time_left(&time);
+            if (left_t < 10) {
+                HAL_SleepMs(left_t);
+            } else {
+                HAL_SleepMs(10);
+            }
         }
     } while (!utils_time_is_expired(&time));
 }
@@ -1941,6 +2526,7 @@ static int iotx_mc_check_handle_is_identical(iotx_mc_topic_handle_t *messageHand
 static int MQTTSubscribe(iotx_mc_client_t *c, const char *topicFilter, iotx_mqtt_qos_t qos, unsigned int msgId,
                          iotx_mqtt_event_handle_func_fpt messageHandler, void *pcontext)
 {
+    int                         rc = 0;
     int                         len = 0;
     iotx_time_t                 timer;
     MQTTString                  topic = MQTTString_initializer;
@@ -2054,9 +2640,6 @@ static int MQTTSubscribe(iotx_mc_client_t *c, const char *topicFilter, iotx_mqtt
 #ifdef SUB_PERSISTENCE_ENABLED
     if (qos == IOTX_MQTT_QOS3_SUB_LOCAL) {
         uint8_t dup = 0;
-#ifdef PLATFORM_HAS_DYNMEM
-        iotx_mc_topic_handle_t *node;
-#endif
         HAL_MutexLock(c->lock_generic);
 #ifdef PLATFORM_HAS_DYNMEM
 #if defined(INSPECT_MQTT_FLOW) && defined (INFRA_LOG)
@@ -2066,19 +2649,14 @@ static int MQTTSubscribe(iotx_mc_client_t *c, const char *topicFilter, iotx_mqtt
         mqtt_warning("handler->topic: %s", handler->topic_filter);
 #endif
 #endif
-        list_for_each_entry(node, &c->list_sub_handle, linked_list, iotx_mc_topic_handle_t) {
-            /* If subscribe the same topic and callback function, then ignore */
-#if defined(INSPECT_MQTT_FLOW) && defined (INFRA_LOG)
-#if WITH_MQTT_ZIP_TOPIC
-            HEXDUMP_DEBUG(node->topic_filter, MQTT_ZIP_PATH_DEFAULT_LEN);
-#else
-            mqtt_warning("node->topic: %s", node->topic_filter);
-#endif
-#endif
-            if (0 == iotx_mc_check_handle_is_identical(node, handler)) {
-                mqtt_warning("dup sub,topic = %s", topicFilter);
-                dup = 1;
-            }
+        /* If subscribe the same topic and callback function, then ignore */
+        rc = iotx_mc_sub_handle_link(c, handler);
+        if (rc > 0) {
+            mqtt_warning("dup sub,topic = %s", topicFilter);
+            dup = 1;
+        } else if (rc < 0) {
+            mqtt_err("index subscription failed, rc = %d", rc);
+            dup = 1;
         }
 #else
         for (idx = 0; idx < IOTX_MC_SUBHANDLE_LIST_MAX_LEN; idx++) {
@@ -2090,11 +2668,7 @@ static int MQTTSubscribe(iotx_mc_client_t *c, const char *topicFilter, iotx_mqtt
             }
         }
 #endif
-        if (dup == 0) {
-#ifdef PLATFORM_HAS_DYNMEM
-            list_add_tail(&handler->linked_list, &c->list_sub_handle);
-#endif
-        } else {
+        if (dup != 0) {
 #ifdef PLATFORM_HAS_DYNMEM
             mqtt_free(handler->topic_filter);
             mqtt_free(handler);
@@ -2103,7 +2677,7 @@ static int MQTTSubscribe(iotx_mc_client_t *c, const char *topicFilter, iotx_mqtt
 #endif
         }
         HAL_MutexUnlock(c->lock_generic);
-        return SUCCESS_RETURN;
+        return (rc < 0) ? rc : SUCCESS_RETURN;
     }
 #endif
 
@@ -2160,9 +2734,6 @@ static int MQTTSubscribe(iotx_mc_client_t *c, const char *topicFilter, iotx_mqtt
 
     {
         uint8_t dup = 0;
-#ifdef PLATFORM_HAS_DYNMEM
-        iotx_mc_topic_handle_t *node;
-#endif
         HAL_MutexLock(c->lock_generic);
 #ifdef PLATFORM_HAS_DYNMEM
 #if defined(INSPECT_MQTT_FLOW) && defined (INFRA_LOG)
@@ -2172,19 +2743,14 @@ static int MQTTSubscribe(iotx_mc_client_t *c, const char *topicFilter, iotx_mqtt
         mqtt_warning("handler->topic: %s", handler->topic_filter);
 #endif
 #endif
-        list_for_each_entry(node, &c->list_sub_handle, linked_list, iotx_mc_topic_handle_t) {
-            /* If subscribe the same topic and callback function, then ignore */
-#if defined(INSPECT_MQTT_FLOW) && defined (INFRA_LOG)
-#if WITH_MQTT_ZIP_TOPIC
-            HEXDUMP_DEBUG(node->topic_filter, MQTT_ZIP_PATH_DEFAULT_LEN);
-#else
-            mqtt_warning("node->topic: %s", node->topic_filter);
-#endif
-#endif
-            if (0 == iotx_mc_check_handle_is_identical(node, handler)) {
-                mqtt_warning("dup sub,topic = %s", topicFilter);
-                dup = 1;
-            }
+        /* If subscribe the same topic and callback function, then ignore */
+        rc = iotx_mc_sub_handle_link(c, handler);
+        if (rc > 0) {
+            mqtt_warning("dup sub,topic = %s", topicFilter);
+            dup = 1;
+        } else if (rc < 0) {
+            mqtt_err("index subscription failed, rc = %d", rc);
+            dup = 1;
         }
 #else
         for (idx = 0; idx < IOTX_MC_SUBHANDLE_LIST_MAX_LEN; idx++) {
@@ -2196,11 +2762,7 @@ static int MQTTSubscribe(iotx_mc_client_t *c, const char *topicFilter, iotx_mqtt
             }
         }
 #endif
-        if (dup == 0) {
-#ifdef PLATFORM_HAS_DYNMEM
-            list_add_tail(&handler->linked_list, &c->list_sub_handle);
-#endif
-        } else {
+        if (dup != 0) {
 #ifdef PLATFORM_HAS_DYNMEM
             mqtt_free(handler->topic_filter);
             mqtt_free(handler);
@@ -2211,7 +2773,7 @@ static int MQTTSubscribe(iotx_mc_client_t *c, const char *topicFilter, iotx_mqtt
         HAL_MutexUnlock(c->lock_generic);
     }
 
-    return SUCCESS_RETURN;
+    return (rc < 0) ? rc : SUCCESS_RETURN;
 }
 
 static int iotx_mc_get_next_packetid(iotx_mc_client_t *c)
@@ -2269,6 +2831,7 @@ static int iotx_mc_check_topic(const char *topicName, iotx_mc_topic_type_t type)
     int mask = 0;
     char *delim = "/";
     char *iterm = NULL;
+    char *saveptr = NULL;
     char topicString[CONFIG_MQTT_TOPIC_MAXLEN];
     if (NULL == topicName || '/' != topicName[0]) {
         return FAIL_RETURN;
@@ -2282,7 +2845,8 @@ static int iotx_mc_check_topic(const char *topicName, iotx_mc_topic_type_t type)
     memset(topicString, 0x0, CONFIG_MQTT_TOPIC_MAXLEN);
     strncpy(topicString, topicName, CONFIG_MQTT_TOPIC_MAXLEN - 1);
 
-    iterm = infra_strtok(topicString, delim);
+    /* publishes may come from several threads, static position of infra_strtok() is not shared */
+    iterm = infra_strtok_r(topicString, delim, &saveptr);
 
     if (SUCCESS_RETURN != iotx_mc_check_rule(iterm, type)) {
         mqtt_err("run iotx_check_rule error");
@@ -2290,7 +2854,7 @@ static int iotx_mc_check_topic(const char *topicName, iotx_mc_topic_type_t type)
     }
 
     for (;;) {
-        iterm = infra_strtok(NULL, delim);
+        iterm = infra_strtok_r(NULL, delim, &saveptr);
 
         if (iterm == NULL) {
             break;
@@ -2459,14 +3023,15 @@ static int MQTTUnsubscribe(iotx_mc_client_t *c, const char *topicFilter, unsigne
     /* we have to find the right message handler - indexed by topic */
     HAL_MutexLock(c->lock_generic);
 #ifdef PLATFORM_HAS_DYNMEM
-    list_for_each_entry_safe(node, next, &c->list_sub_handle, linked_list, iotx_mc_topic_handle_t) {
-        if (MQTTPacket_equals(&cur_topic, (char *)node->topic_filter)
-            || iotx_mc_is_topic_matched((char *)node->topic_filter, &cur_topic)) {
-            mqtt_debug("topic be matched");
-            list_del(&node->linked_list);
-            mqtt_free(node->topic_filter);
-            mqtt_free(node);
-        }
+    INIT_LIST_HEAD(&handler->linked_list);
+    iotx_mc_topic_trie_find(&c->sub_trie, handler->topic_filter, iotx_mc_topic_key_len(handler),
+                            iotx_mc_topic_is_wildcard(handler), _unsub_handle_collect, handler);
+    list_for_each_entry_safe(node, next, &handler->linked_list, linked_list, iotx_mc_topic_handle_t) {
+        mqtt_debug("topic be matched");
+        list_del(&node->linked_list);
+        iotx_mc_topic_trie_remove(&c->sub_trie, &node->trie_entry);
+        mqtt_free(node->topic_filter);
+        mqtt_free(node);
     }
     mqtt_free(handler->topic_filter);
     mqtt_free(handler);
@@ -2486,13 +3051,16 @@ static int MQTTUnsubscribe(iotx_mc_client_t *c, const char *topicFilter, unsigne
     return SUCCESS_RETURN;
 }
 
-int MQTTPublish(iotx_mc_client_t *c, const char *topicName, iotx_mqtt_topic_info_pt topic_msg)
+/* serialize publish into buf_send, or in front of its payload when it lies in payload buffer @ref, and send it */
+int MQTTPublish(iotx_mc_client_t *c, const char *topicName, iotx_mqtt_topic_info_pt topic_msg, iotx_mc_buf_t *ref)
 
 {
     iotx_time_t         timer;
     MQTTString          topic = MQTTString_initializer;
     int                 len = 0;
+    char               *packet = NULL;
 #if !WITH_MQTT_ONLY_QOS0
+    int                 rc = 0;
     iotx_mc_pub_info_t  *node = NULL;
 #endif
 #ifdef INFRA_LOG_NETWORK_PAYLOAD
@@ -2510,30 +3078,54 @@ int MQTTPublish(iotx_mc_client_t *c, const char *topicName, iotx_mqtt_topic_info
     HAL_MutexLock(c->lock_list_pub);
     HAL_MutexLock(c->lock_write_buf);
 
-    if (_alloc_send_buffer(c, strlen(topicName) + topic_msg->payload_len) < 0) {
-        HAL_MutexUnlock(c->lock_write_buf);
-        HAL_MutexUnlock(c->lock_list_pub);
-        return FAIL_RETURN;
-    }
+    if (ref != NULL) {
+        /* header and topic go into room reserved in front of payload, packet is sent without copying */
+        len = MQTTPacket_len(MQTTSerialize_publishLength(topic_msg->qos, topic, topic_msg->payload_len)) -
+              topic_msg->payload_len;
+        if ((uint32_t)len > ref->headroom || topic_msg->payload_len > ref->size) {
+            mqtt_err("payload buffer too short, header len=%d, headroom=%u, payloadlen=%u",
+                     len, ref->headroom, topic_msg->payload_len);
+            HAL_MutexUnlock(c->lock_write_buf);
+            HAL_MutexUnlock(c->lock_list_pub);
+            return MQTT_PUBLISH_PACKET_ERROR;
+        }
+        packet = (char *)ref->payload - len;
+        len = MQTTSerialize_publishHeader((unsigned char *)packet, len, topic_msg->dup, topic_msg->qos, topic_msg->retain,
+                                          topic_msg->packet_id, topic, topic_msg->payload_len);
+        if (len <= 0) {
+            mqtt_err("MQTTSerialize_publishHeader is error, len=%d", len);
+            HAL_MutexUnlock(c->lock_write_buf);
+            HAL_MutexUnlock(c->lock_list_pub);
+            return MQTT_PUBLISH_PACKET_ERROR;
+        }
+        len += topic_msg->payload_len;
+    } else {
+        if (_alloc_send_buffer(c, strlen(topicName) + topic_msg->payload_len) < 0) {
+            HAL_MutexUnlock(c->lock_write_buf);
+            HAL_MutexUnlock(c->lock_list_pub);
+            return FAIL_RETURN;
+        }
 
-    len = MQTTSerialize_publish((unsigned char *)c->buf_send,
-                                c->buf_size_send,
-                                0,
-                                topic_msg->qos,
-                                topic_msg->retain,
-                                topic_msg->packet_id,
-                                topic,
-                                (unsigned char *)topic_msg->payload,
-                                topic_msg->payload_len);
-    if (len <= 0) {
-        mqtt_err("MQTTSerialize_publish is error, len=%d, buf_size_send=%u, payloadlen=%u",
-                 len,
-                 c->buf_size_send,
-                 topic_msg->payload_len);
-        _reset_send_buffer(c);
-        HAL_MutexUnlock(c->lock_write_buf);
-        HAL_MutexUnlock(c->lock_list_pub);
-        return MQTT_PUBLISH_PACKET_ERROR;
+        len = MQTTSerialize_publish((unsigned char *)c->buf_send,
+                                    c->buf_size_send,
+                                    topic_msg->dup,
+                                    topic_msg->qos,
+                                    topic_msg->retain,
+                                    topic_msg->packet_id,
+                                    topic,
+                                    (unsigned char *)topic_msg->payload,
+                                    topic_msg->payload_len);
+        if (len <= 0) {
+            mqtt_err("MQTTSerialize_publish is error, len=%d, buf_size_send=%u, payloadlen=%u",
+                     len,
+                     c->buf_size_send,
+                     topic_msg->payload_len);
+            _reset_send_buffer(c);
+            HAL_MutexUnlock(c->lock_write_buf);
+            HAL_MutexUnlock(c->lock_list_pub);
+            return MQTT_PUBLISH_PACKET_ERROR;
+        }
+        packet = c->buf_send;
     }
 
 #if !WITH_MQTT_ONLY_QOS0
@@ -2541,23 +3133,30 @@ int MQTTPublish(iotx_mc_client_t *c, const char *topicName, iotx_mqtt_topic_info
     /* If the QOS >1, push the information into list of wait publish ACK */
     if (topic_msg->qos > IOTX_MQTT_QOS0) {
         /* push into list */
-        if (SUCCESS_RETURN != iotx_mc_push_pubInfo_to(c, len, topic_msg->packet_id, &node)) {
-            mqtt_err("push publish into to pubInfolist failed!");
+        rc = iotx_mc_push_pubInfo_to(c, packet, len, ref, topic_msg->packet_id, &node);
+        if (SUCCESS_RETURN != rc) {
             _reset_send_buffer(c);
             HAL_MutexUnlock(c->lock_write_buf);
             HAL_MutexUnlock(c->lock_list_pub);
+            if (MQTT_PUBLISH_WOULD_BLOCK == rc) {
+                return rc;
+            }
+            mqtt_err("push publish into to pubInfolist failed!");
             return MQTT_PUSH_TO_LIST_ERROR;
         }
     }
 #endif
     /* send the publish packet */
-    if (iotx_mc_send_packet(c, c->buf_send, len, &timer) != SUCCESS_RETURN) {
+#if WITH_MQTT_PUB_BATCH && !defined(ASYNC_PROTOCOL_STACK)
+    if (iotx_mc_batch_append(c, packet, len, &timer) != SUCCESS_RETURN) {
+#else
+    if (iotx_mc_send_packet(c, packet, len, &timer) != SUCCESS_RETURN) {
+#endif
 #if !WITH_MQTT_ONLY_QOS0
         if (topic_msg->qos > IOTX_MQTT_QOS0) {
             /* If not even successfully sent to IP stack, meaningless to wait QOS1 ack, give up waiting */
 #ifdef PLATFORM_HAS_DYNMEM
-            list_del(&node->linked_list);
-            mqtt_free(node);
+            _pub_info_release(c, node);
 #else
             memset(node, 0, sizeof(iotx_mc_pub_info_t));
 #endif
@@ -2585,6 +3184,49 @@ int MQTTPublish(iotx_mc_client_t *c, const char *topicName, iotx_mqtt_topic_info
     return SUCCESS_RETURN;
 }
 
+#if WITH_MQTT_OUTBOX && defined(PLATFORM_HAS_DYNMEM)
+/* keep message in outbox, it is sent by iotx_mc_outbox_drain() once connected */
+static int iotx_mc_outbox_store(iotx_mc_client_t *c, const char *topicName, iotx_mqtt_topic_info_pt topic_msg)
+{
+    int rc = iotx_mc_outbox_push(c->outbox, topicName, topic_msg);
+
+    if (rc != SUCCESS_RETURN) {
+        mqtt_err("put message into outbox failed, rc = %d", rc);
+        return rc;
+    }
+
+    return (topic_msg->qos > IOTX_MQTT_QOS0) ? (int)topic_msg->packet_id : 0;
+}
+
+/* send messages of outbox in order, as many as inflight window takes */
+static void iotx_mc_outbox_drain(iotx_mc_client_t *c)
+{
+    int rc = 0;
+    const char *topic = NULL;
+    iotx_mqtt_topic_info_t topic_msg;
+
+    if (c->outbox == NULL) {
+        return;
+    }
+
+    while (wrapper_mqtt_check_state(c) && iotx_mc_outbox_peek(c->outbox, &topic, &topic_msg) == SUCCESS_RETURN) {
+        rc = MQTTPublish(c, topic, &topic_msg, NULL);
+        if (rc == MQTT_NETWORK_ERROR) {
+            iotx_mc_set_client_state(c, IOTX_MC_STATE_DISCONNECTED);
+            break;
+        }
+        if (rc == MQTT_PUBLISH_PACKET_ERROR) {
+            /* never sendable, e.g. larger than send buffer */
+            mqtt_err("message of outbox dropped, topic = %s", topic);
+        } else if (rc != SUCCESS_RETURN) {
+            /* window is full or memory is short, try again later */
+            break;
+        }
+        iotx_mc_outbox_sent(c->outbox, &topic_msg, rc != SUCCESS_RETURN);
+    }
+}
+#endif
+
 static int MQTTDisconnect(iotx_mc_client_t *c)
 {
     int             rc = FAIL_RETURN;
@@ -2753,6 +3395,10 @@ int wrapper_mqtt_release(void **c)
         mqtt_free(node->topic_filter);
         mqtt_free(node);
     }
+    iotx_mc_topic_trie_deinit(&pClient->sub_trie);
+#if WITH_MQTT_ZIP_TOPIC
+    iotx_mc_zip_cache_deinit(pClient);
+#endif
 #else
     memset(pClient->list_sub_handle, 0, sizeof(iotx_mc_topic_handle_t) * IOTX_MC_SUBHANDLE_LIST_MAX_LEN);
 #endif
@@ -2766,6 +3412,9 @@ int wrapper_mqtt_release(void **c)
     iotx_mc_pub_wait_list_deinit(pClient);
 #endif
 #ifdef PLATFORM_HAS_DYNMEM
+    /* buffers not yet released by application keep the owner */
+    _buf_owner_put(pClient->buf_owner);
+    pClient->buf_owner = NULL;
     if (pClient->buf_send != NULL) {
         mqtt_free(pClient->buf_send);
         pClient->buf_send = NULL;
@@ -2774,6 +3423,22 @@ int wrapper_mqtt_release(void **c)
         mqtt_free(pClient->buf_read);
         pClient->buf_read = NULL;
     }
+#if WITH_MQTT_READ_AHEAD && !defined(ASYNC_PROTOCOL_STACK)
+    if (pClient->buf_read_ahead != NULL) {
+        mqtt_free(pClient->buf_read_ahead);
+        pClient->buf_read_ahead = NULL;
+    }
+#endif
+#if WITH_MQTT_PUB_BATCH && !defined(ASYNC_PROTOCOL_STACK)
+    if (pClient->buf_batch != NULL) {
+        mqtt_free(pClient->buf_batch);
+        pClient->buf_batch = NULL;
+    }
+#endif
+#if WITH_MQTT_OUTBOX
+    iotx_mc_outbox_close(pClient->outbox);
+    pClient->outbox = NULL;
+#endif
     mqtt_free(pClient);
 #else
     memset(pClient, 0, sizeof(iotx_mc_client_t));
@@ -2812,6 +3477,9 @@ int wrapper_mqtt_yield(void *client, int timeout_ms)
 #if !WITH_MQTT_ONLY_QOS0
         /* check list of wait publish ACK to remove node that is ACKED or timeout */
         MQTTPubInfoProc(pClient);
+#endif
+#if WITH_MQTT_OUTBOX && defined(PLATFORM_HAS_DYNMEM)
+        iotx_mc_outbox_drain(pClient);
 #endif
     }
     HAL_SleepMs(timeout_ms);
@@ -3095,7 +3763,11 @@ int wrapper_mqtt_publish(void *client, const char *topicName, iotx_mqtt_topic_in
         return MQTT_TOPIC_FORMAT_ERROR;
     }
 
+#if WITH_MQTT_OUTBOX && defined(PLATFORM_HAS_DYNMEM)
+    if (!wrapper_mqtt_check_state(c) && c->outbox == NULL) {
+#else
     if (!wrapper_mqtt_check_state(c)) {
+#endif
         mqtt_err("mqtt client state is error,state = %d", iotx_mc_get_client_state(c));
         return MQTT_STATE_ERROR;
     }
@@ -3112,24 +3784,254 @@ int wrapper_mqtt_publish(void *client, const char *topicName, iotx_mqtt_topic_in
 #else
     topic_msg->qos = IOTX_MQTT_QOS0;
 #endif
+    topic_msg->dup = 0;
+
+#if WITH_MQTT_OUTBOX && defined(PLATFORM_HAS_DYNMEM)
+    /* offline, or earlier messages still in outbox, queue behind them to keep order */
+    if (c->outbox != NULL && (!wrapper_mqtt_check_state(c) || iotx_mc_outbox_pending(c->outbox))) {
+        return iotx_mc_outbox_store(c, topicName, topic_msg);
+    }
+#endif
 
 #if defined(INSPECT_MQTT_FLOW) && defined(INFRA_LOG)
     HEXDUMP_DEBUG(topicName, strlen(topicName));
     HEXDUMP_DEBUG(topic_msg->payload, topic_msg->payload_len);
 #endif
 
-    rc = MQTTPublish(c, topicName, topic_msg);
+    rc = MQTTPublish(c, topicName, topic_msg, NULL);
     if (rc != SUCCESS_RETURN) { /* send the subscribe packet */
         if (rc == MQTT_NETWORK_ERROR) {
             iotx_mc_set_client_state(c, IOTX_MC_STATE_DISCONNECTED);
+#if WITH_MQTT_OUTBOX && defined(PLATFORM_HAS_DYNMEM)
+            if (c->outbox != NULL) {
+                return iotx_mc_outbox_store(c, topicName, topic_msg);
+            }
+#endif
+        }
+        if (rc != MQTT_PUBLISH_WOULD_BLOCK) {
+            mqtt_err("MQTTPublish is error, rc = %d", rc);
         }
-        mqtt_err("MQTTPublish is error, rc = %d", rc);
         return rc;
     }
 
     return (int)msg_id;
 }
 
+void *wrapper_mqtt_buf_alloc(void *client, int topic_len, int payload_len)
+{
+#ifdef PLATFORM_HAS_DYNMEM
+    iotx_mc_client_t *c = (iotx_mc_client_t *)client;
+    iotx_mc_buf_t *buf = NULL;
+    uint32_t headroom = 0;
+
+    if (c == NULL || c->buf_owner == NULL || topic_len <= 0 || payload_len < 0) {
+        return NULL;
+    }
+
+    /* fixed header, remaining length of at most 4 bytes, topic with its length and packet id */
+    headroom = 1 + 4 + 2 + topic_len + 2;
+
+    /* one more byte terminates payload, which is printed as string when network payload is logged */
+    buf = mqtt_malloc(sizeof(iotx_mc_buf_t) + headroom + payload_len + 1);
+    if (buf == NULL) {
+        return NULL;
+    }
+    buf->owner = c->buf_owner;
+    buf->refcnt = 1;
+    buf->headroom = headroom;
+    buf->size = payload_len;
+    buf->payload = (unsigned char *)buf + sizeof(iotx_mc_buf_t) + headroom;
+    buf->payload[payload_len] = '\0';
+
+    HAL_MutexLock(c->buf_owner->lock);
+    c->buf_owner->refcnt++;
+    HAL_MutexUnlock(c->buf_owner->lock);
+
+    return buf;
+#else
+    return NULL;
+#endif
+}
+
+void *wrapper_mqtt_buf_payload(void *buf)
+{
+    if (buf == NULL) {
+        return NULL;
+    }
+
+    return ((iotx_mc_buf_t *)buf)->payload;
+}
+
+void wrapper_mqtt_buf_release(void *buf)
+{
+#ifdef PLATFORM_HAS_DYNMEM
+    if (buf == NULL) {
+        return;
+    }
+
+    _buf_put((iotx_mc_buf_t *)buf);
+#endif
+}
+
+int wrapper_mqtt_inflight_stats(void *client, iotx_mqtt_inflight_stats_t *stats)
+{
+#if defined(PLATFORM_HAS_DYNMEM) && !WITH_MQTT_ONLY_QOS0
+    iotx_mc_client_t *c = (iotx_mc_client_t *)client;
+
+    if (c == NULL || stats == NULL) {
+        return NULL_VALUE_ERROR;
+    }
+
+    HAL_MutexLock(c->lock_list_pub);
+    memcpy(stats, &c->inflight_stats, sizeof(iotx_mqtt_inflight_stats_t));
+    stats->window = c->inflight_window;
+    stats->inflight = c->pub_wait_cnt;
+    HAL_MutexUnlock(c->lock_list_pub);
+
+    return SUCCESS_RETURN;
+#else
+    return FAIL_RETURN;
+#endif
+}
+
+int wrapper_mqtt_outbox_open(void *client, const char *name, int max_msgs)
+{
+#if WITH_MQTT_OUTBOX && defined(PLATFORM_HAS_DYNMEM)
+    iotx_mc_client_t *c = (iotx_mc_client_t *)client;
+    iotx_mc_outbox_t *ob = NULL;
+
+    if (c == NULL || name == NULL || max_msgs < 0) {
+        return NULL_VALUE_ERROR;
+    }
+    if (c->outbox != NULL) {
+        mqtt_err("outbox already opened");
+        return FAIL_RETURN;
+    }
+
+    ob = iotx_mc_outbox_open(name, max_msgs ? (uint32_t)max_msgs : IOTX_MC_OUTBOX_MSGS_DEFAULT);
+    if (ob == NULL) {
+        mqtt_err("open outbox %s failed", name);
+        return FAIL_RETURN;
+    }
+
+    /* packet ids continue after those of stored messages, which are sent again with their own id */
+    HAL_MutexLock(c->lock_generic);
+    if (iotx_mc_outbox_pending(ob)) {
+        c->packet_id = ob->last_id;
+    }
+    c->outbox = ob;
+    HAL_MutexUnlock(c->lock_generic);
+
+    return SUCCESS_RETURN;
+#else
+    return FAIL_RETURN;
+#endif
+}
+
+int wrapper_mqtt_outbox_stats(void *client, iotx_mqtt_outbox_stats_t *stats)
+{
+#if WITH_MQTT_OUTBOX && defined(PLATFORM_HAS_DYNMEM)
+    iotx_mc_client_t *c = (iotx_mc_client_t *)client;
+
+    if (c == NULL || stats == NULL) {
+        return NULL_VALUE_ERROR;
+    }
+    if (c->outbox == NULL) {
+        return FAIL_RETURN;
+    }
+
+    iotx_mc_outbox_stats(c->outbox, stats);
+    return SUCCESS_RETURN;
+#else
+    return FAIL_RETURN;
+#endif
+}
+
+int wrapper_mqtt_publish_buf(void *client, const char *topicName, iotx_mqtt_topic_info_pt topic_msg, void *buf)
+{
+#ifdef PLATFORM_HAS_DYNMEM
+    uint16_t msg_id = 0;
+    int rc = FAIL_RETURN;
+    iotx_mc_client_t *c = (iotx_mc_client_t *)client;
+    iotx_mc_buf_t *ref = (iotx_mc_buf_t *)buf;
+
+    if (ref == NULL) {
+        return NULL_VALUE_ERROR;
+    }
+
+    if (c == NULL || topicName == NULL || topic_msg == NULL || ref->owner != c->buf_owner) {
+        rc = NULL_VALUE_ERROR;
+        goto RETURN;
+    }
+
+    if (0 != iotx_mc_check_topic(topicName, TOPIC_NAME_TYPE)) {
+        mqtt_err("topic format is error,topicFilter = %s", topicName);
+        rc = MQTT_TOPIC_FORMAT_ERROR;
+        goto RETURN;
+    }
+
+#if WITH_MQTT_OUTBOX
+    if (!wrapper_mqtt_check_state(c) && c->outbox == NULL) {
+#else
+    if (!wrapper_mqtt_check_state(c)) {
+#endif
+        mqtt_err("mqtt client state is error,state = %d", iotx_mc_get_client_state(c));
+        rc = MQTT_STATE_ERROR;
+        goto RETURN;
+    }
+
+#if !WITH_MQTT_ONLY_QOS0
+    if (topic_msg->qos == IOTX_MQTT_QOS2) {
+        mqtt_err("MQTTPublish return error,MQTT_QOS2 is now not supported.");
+        rc = MQTT_PUBLISH_QOS_ERROR;
+        goto RETURN;
+    }
+    if (topic_msg->qos == IOTX_MQTT_QOS1) {
+        msg_id = iotx_mc_get_next_packetid(c);
+        topic_msg->packet_id = msg_id;
+    }
+#else
+    topic_msg->qos = IOTX_MQTT_QOS0;
+#endif
+
+    topic_msg->payload = (const char *)ref->payload;
+    topic_msg->dup = 0;
+
+#if WITH_MQTT_OUTBOX
+    /* payload is copied into outbox, buffer is released as usual */
+    if (c->outbox != NULL && (!wrapper_mqtt_check_state(c) || iotx_mc_outbox_pending(c->outbox))) {
+        rc = iotx_mc_outbox_store(c, topicName, topic_msg);
+        goto RETURN;
+    }
+#endif
+
+    rc = MQTTPublish(c, topicName, topic_msg, ref);
+    if (rc != SUCCESS_RETURN) {
+        if (rc == MQTT_NETWORK_ERROR) {
+            iotx_mc_set_client_state(c, IOTX_MC_STATE_DISCONNECTED);
+#if WITH_MQTT_OUTBOX
+            if (c->outbox != NULL) {
+                rc = iotx_mc_outbox_store(c, topicName, topic_msg);
+                goto RETURN;
+            }
+#endif
+        }
+        if (rc != MQTT_PUBLISH_WOULD_BLOCK) {
+            mqtt_err("MQTTPublish is error, rc = %d", rc);
+        }
+    } else {
+        rc = (int)msg_id;
+    }
+
+RETURN:
+    /* reference of caller is handed over whatever the result */
+    wrapper_mqtt_buf_release(ref);
+    return rc;
+#else
+    return FAIL_RETURN;
+#endif
+}
+
 #ifdef ASYNC_PROTOCOL_STACK
 int wrapper_mqtt_nwk_event_handler(void *client, iotx_mqtt_nwk_event_t event, iotx_mqtt_nwk_param_t *param)
 {
@@ -14,6 +14,9 @@
 #include "mqtt_api.h"
 
 #include "MQTTPacket.h"
+#include "iotx_mqtt_topic_trie.h"
+#include "iotx_mqtt_timer_wheel.h"
+#include "iotx_mqtt_outbox.h"
 
 #ifdef INFRA_MEM_STATS
     #include "infra_mem_stats.h"
@@ -28,6 +31,8 @@
 
 #define MQTT_DYNBUF_RECV_MARGIN                      (8)
 
+#define MQTT_ZIP_PATH_DEFAULT_LEN                    (32)
+
 typedef enum {
     IOTX_MC_CONNECTION_ACCEPTED = 0,
     IOTX_MC_CONNECTION_REFUSED_UNACCEPTABLE_PROTOCOL_VERSION = 1,
@@ -64,12 +69,37 @@ typedef struct iotx_mc_topic_handle_s {
 #ifdef PLATFORM_HAS_DYNMEM
     const char *topic_filter;
     struct list_head linked_list;
+    iotx_mc_trie_entry_t trie_entry;
 #else
     const char topic_filter[CONFIG_MQTT_TOPIC_MAXLEN];
     int used;
 #endif
 } iotx_mc_topic_handle_t;
 
+#if WITH_MQTT_ZIP_TOPIC && defined(PLATFORM_HAS_DYNMEM)
+/* digest of an inbound topic, kept so that it is not computed for every message */
+typedef struct {
+    char                       *topic;
+    uint16_t                    topic_len;
+    char                        digest[MQTT_ZIP_PATH_DEFAULT_LEN];
+} iotx_mc_zip_entry_t;
+#endif
+
+/* Lock shared by a client and its payload buffers, kept until the client and all its buffers are gone */
+typedef struct {
+    void                       *lock;               /* guards refcnt here and refcnt of every buffer */
+    uint32_t                    refcnt;             /* one held by client and one by each buffer */
+} iotx_mc_buf_owner_t;
+
+/* Reference counted publish payload with room in front of it for MQTT header, see wrapper_mqtt_buf_alloc() */
+typedef struct {
+    iotx_mc_buf_owner_t        *owner;              /* owner of client it was allocated from */
+    uint32_t                    refcnt;
+    uint32_t                    headroom;           /* bytes reserved in front of payload */
+    uint32_t                    size;               /* capacity of payload in byte */
+    unsigned char              *payload;
+} iotx_mc_buf_t;
+
 #if !WITH_MQTT_ONLY_QOS0
 /* Information structure of published topic */
 typedef struct REPUBLISH_INFO {
@@ -79,7 +109,11 @@ typedef struct REPUBLISH_INFO {
     uint32_t                    len;                /* length of publish message */
 #ifdef PLATFORM_HAS_DYNMEM
     unsigned char              *buf;                /* publish message */
+    iotx_mc_buf_t              *ref;                /* payload buffer holding buf, NULL if buf is a copy */
     struct list_head            linked_list;
+    struct list_head            hash_list;          /* bucket of packet id hash */
+    iotx_mc_wheel_timer_t       timer;              /* republish timer */
+    uint8_t                     retrans;            /* republished, so its PUBACK tells no RTT */
 #else
     unsigned char               buf[IOTX_MC_TX_MAX_LEN];  /* publish message */
     int                         used;
@@ -125,8 +159,25 @@ typedef struct Client {
     char                            buf_send[IOTX_MC_TX_MAX_LEN];
     char                            buf_read[IOTX_MC_RX_MAX_LEN];
 #endif
+#if WITH_MQTT_READ_AHEAD && !defined(ASYNC_PROTOCOL_STACK)
+#ifdef PLATFORM_HAS_DYNMEM
+    char                           *buf_read_ahead;                             /* socket data staged for buf_read */
+#else
+    char                            buf_read_ahead[IOTX_MC_READ_AHEAD_LEN];
+#endif
+#endif
+#if WITH_MQTT_PUB_BATCH && !defined(ASYNC_PROTOCOL_STACK)
+#ifdef PLATFORM_HAS_DYNMEM
+    char                           *buf_batch;                                  /* serialized publishes waiting to be sent */
+#else
+    char                            buf_batch[IOTX_MC_PUB_BATCH_LEN];
+#endif
+    uint32_t                        batch_len;                                  /* bytes in buf_batch */
+    iotx_time_t                     batch_deadline;                             /* time buf_batch must be sent by */
+#endif
 #ifdef PLATFORM_HAS_DYNMEM
     struct list_head                list_sub_handle;                            /* list of subscribe handle */
+    iotx_mc_topic_trie_t            sub_trie;                                   /* index of list_sub_handle */
 #else
     iotx_mc_topic_handle_t          list_sub_handle[IOTX_MC_SUBHANDLE_LIST_MAX_LEN];
 #endif
@@ -139,6 +190,15 @@ typedef struct Client {
 #if !WITH_MQTT_ONLY_QOS0
 #ifdef PLATFORM_HAS_DYNMEM
     struct list_head                list_pub_wait_ack;                          /* list of wait publish ack */
+    struct list_head               *pub_id_hash;                                /* list_pub_wait_ack indexed by packet id */
+    uint32_t                        pub_id_hash_size;
+    uint32_t                        pub_wait_cnt;                               /* count of list_pub_wait_ack */
+    iotx_mc_timer_wheel_t           pub_wheel;                                  /* republish timers of list_pub_wait_ack */
+    uint32_t                        inflight_window;                            /* limit of pub_wait_cnt */
+    uint32_t                        inflight_grow;                              /* PUBACKs counted towards next window growth */
+    uint8_t                         inflight_slow_start;                        /* window grows by one per PUBACK until first cut */
+    uint64_t                        inflight_cut_time;                          /* time window was last cut */
+    iotx_mqtt_inflight_stats_t      inflight_stats;
 #else
     iotx_mc_pub_info_t              list_pub_wait_ack[IOTX_MC_PUBWAIT_LIST_MAX_LEN];
 #endif
@@ -147,6 +207,15 @@ typedef struct Client {
     struct list_head                list_sub_sync_ack;
 #else
     mqtt_sub_sync_node_t            list_sub_sync_ack[IOTX_MC_SUBSYNC_LIST_MAX_LEN];
+#endif
+#if WITH_MQTT_OUTBOX && defined(PLATFORM_HAS_DYNMEM)
+    iotx_mc_outbox_t               *outbox;                                     /* publishes kept while offline */
+#endif
+#ifdef PLATFORM_HAS_DYNMEM
+    iotx_mc_buf_owner_t            *buf_owner;                                  /* owner of payload buffers */
+#endif
+#if WITH_MQTT_ZIP_TOPIC && defined(PLATFORM_HAS_DYNMEM)
+    iotx_mc_zip_entry_t             zip_cache[IOTX_MC_ZIP_CACHE_NUM];           /* digests of inbound topics, by hash */
 #endif
     void                           *lock_list_pub;                              /* lock for list of QoS1 pub */
     void                           *lock_write_buf;                             /* lock of write */
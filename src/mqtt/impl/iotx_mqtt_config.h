@@ -29,8 +29,65 @@
     #define WITH_MQTT_ZIP_TOPIC                 (0)
 #endif
 
-/* maximum republish elements in list */
-#define IOTX_MC_REPUB_NUM_MAX                   (20)
+#ifndef WITH_MQTT_READ_AHEAD
+    #define WITH_MQTT_READ_AHEAD                (1)
+#endif
+
+#ifndef WITH_MQTT_PUB_BATCH
+    #define WITH_MQTT_PUB_BATCH                 (0)
+#endif
+
+#ifndef WITH_MQTT_INFLIGHT_AIMD
+    #define WITH_MQTT_INFLIGHT_AIMD             (0)
+#endif
+
+/* persistent outbox, needs PLATFORM_HAS_DYNMEM and HAL_Kv_XXX() */
+#ifndef WITH_MQTT_OUTBOX
+    #define WITH_MQTT_OUTBOX                    (0)
+#endif
+
+/* maximum republish elements in list, a gateway with many QoS1 publishes in flight raises it in its board config */
+#ifndef IOTX_MC_REPUB_NUM_MAX
+    #define IOTX_MC_REPUB_NUM_MAX               (20)
+#endif
+
+/* maximum QoS1 publishes waiting for PUBACK, more are refused with MQTT_PUBLISH_WOULD_BLOCK, PLATFORM_HAS_DYNMEM only */
+#ifndef IOTX_MC_INFLIGHT_WINDOW_MAX
+    #define IOTX_MC_INFLIGHT_WINDOW_MAX         IOTX_MC_REPUB_NUM_MAX
+#endif
+
+/* window adapted by WITH_MQTT_INFLIGHT_AIMD starts from and is never cut below this */
+#ifndef IOTX_MC_INFLIGHT_WINDOW_MIN
+    #define IOTX_MC_INFLIGHT_WINDOW_MIN         (4)
+#endif
+
+/* PUBACK later than the lowest RTT seen by this much in millisecond means broker queues, window is cut */
+#ifndef IOTX_MC_INFLIGHT_QUEUE_DELAY_MS
+    #define IOTX_MC_INFLIGHT_QUEUE_DELAY_MS     (50)
+#endif
+
+/* messages kept by outbox when IOT_MQTT_Outbox_Open() is given 0 */
+#ifndef IOTX_MC_OUTBOX_MSGS_DEFAULT
+    #define IOTX_MC_OUTBOX_MSGS_DEFAULT         (1024)
+#endif
+
+/* longest message kept by outbox in byte, topic included */
+#ifndef IOTX_MC_OUTBOX_MSG_LEN_MAX
+    #define IOTX_MC_OUTBOX_MSG_LEN_MAX          (2048)
+#endif
+
+/* messages sent from outbox and waiting for PUBACK at most */
+#ifndef IOTX_MC_OUTBOX_INFLIGHT_MAX
+    #define IOTX_MC_OUTBOX_INFLIGHT_MAX         (32)
+#endif
+
+/* 1 to refuse new messages when outbox is full, 0 to drop the oldest one */
+#ifndef IOTX_MC_OUTBOX_DROP_NEWEST
+    #define IOTX_MC_OUTBOX_DROP_NEWEST          (0)
+#endif
+
+/* initial buckets of packet id hash for republish list, must be power of 2 */
+#define IOTX_MC_PUB_ID_HASH_SIZE                (16)
 
 /* MQTT client version number */
 #define IOTX_MC_MQTT_VERSION                    (4)
@@ -47,6 +104,37 @@
 /* Maximum interval of MQTT reconnect in millisecond */
 #define IOTX_MC_RECONNECT_INTERVAL_MAX_MS       (60000)
 
+/* count of subscription handles matched by one inbound message without allocating */
+#define IOTX_MC_DELIVER_HANDLE_NUM              (8)
+
+/* count of inbound topics whose digest is kept, see WITH_MQTT_ZIP_TOPIC */
+#ifndef IOTX_MC_ZIP_CACHE_NUM
+    #define IOTX_MC_ZIP_CACHE_NUM               (16)
+#endif
+
+/* size of inbound read-ahead buffer in byte, see WITH_MQTT_READ_AHEAD */
+#ifndef IOTX_MC_READ_AHEAD_LEN
+    #ifdef PLATFORM_HAS_DYNMEM
+        #define IOTX_MC_READ_AHEAD_LEN              (2048)
+    #else
+        #define IOTX_MC_READ_AHEAD_LEN              (256)
+    #endif
+#endif
+
+/* size of outbound publish batch in byte, see WITH_MQTT_PUB_BATCH */
+#ifndef IOTX_MC_PUB_BATCH_LEN
+    #ifdef PLATFORM_HAS_DYNMEM
+        #define IOTX_MC_PUB_BATCH_LEN               (4096)
+    #else
+        #define IOTX_MC_PUB_BATCH_LEN               (512)
+    #endif
+#endif
+
+/* longest time in millisecond a publish waits in batch for others to join it */
+#ifndef IOTX_MC_PUB_BATCH_DELAY_MS
+    #define IOTX_MC_PUB_BATCH_DELAY_MS          (2)
+#endif
+
 /* Max times of keepalive which has been send and did not received response package */
 #define IOTX_MC_KEEPALIVE_PROBE_MAX             (1)
 
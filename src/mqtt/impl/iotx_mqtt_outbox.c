@@ -0,0 +1,337 @@
+/*
+ * Copyright (C) 2015-2018 Alibaba Group Holding Limited
+ */
+#include "mqtt_internal.h"
+
+#if WITH_MQTT_OUTBOX && defined(PLATFORM_HAS_DYNMEM)
+
+#define _OUTBOX_META_MAGIC              (0x4d4f4231)    /* "MOB1" */
+#define _OUTBOX_META_LEN                (18)
+#define _OUTBOX_MSG_HEAD_LEN            (10)
+#define _OUTBOX_MSG_BUF_LEN             (_OUTBOX_MSG_HEAD_LEN + IOTX_MC_OUTBOX_MSG_LEN_MAX + 1)
+#define _OUTBOX_KEY_LEN                 (IOTX_MC_OUTBOX_NAME_LEN + 10)
+
+/* records are packed byte by byte so that they are read back the same whatever the struct layout */
+static void _put_u16(unsigned char *p, uint16_t v)
+{
+    p[0] = (unsigned char)(v >> 8);
+    p[1] = (unsigned char)v;
+}
+
+static void _put_u32(unsigned char *p, uint32_t v)
+{
+    _put_u16(p, (uint16_t)(v >> 16));
+    _put_u16(p + 2, (uint16_t)v);
+}
+
+static uint16_t _get_u16(const unsigned char *p)
+{
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static uint32_t _get_u32(const unsigned char *p)
+{
+    return ((uint32_t)_get_u16(p) << 16) | _get_u16(p + 2);
+}
+
+static void _outbox_key(iotx_mc_outbox_t *ob, uint32_t seq, char key[_OUTBOX_KEY_LEN])
+{
+    HAL_Snprintf(key, _OUTBOX_KEY_LEN, "%s.%08x", ob->name, (unsigned int)seq);
+}
+
+static int _outbox_save_meta(iotx_mc_outbox_t *ob)
+{
+    char key[_OUTBOX_KEY_LEN];
+    unsigned char meta[_OUTBOX_META_LEN];
+
+    HAL_Snprintf(key, _OUTBOX_KEY_LEN, "%s.m", ob->name);
+    _put_u32(meta, _OUTBOX_META_MAGIC);
+    _put_u32(meta + 4, ob->head);
+    _put_u32(meta + 8, ob->tail);
+    _put_u32(meta + 12, ob->sent_mark);
+    _put_u16(meta + 16, ob->last_id);
+
+    return HAL_Kv_Set(key, meta, _OUTBOX_META_LEN, 0) == 0 ? SUCCESS_RETURN : FAIL_RETURN;
+}
+
+static void _outbox_load_meta(iotx_mc_outbox_t *ob)
+{
+    char key[_OUTBOX_KEY_LEN];
+    unsigned char meta[_OUTBOX_META_LEN];
+    int len = _OUTBOX_META_LEN;
+
+    HAL_Snprintf(key, _OUTBOX_KEY_LEN, "%s.m", ob->name);
+    if (HAL_Kv_Get(key, meta, &len) != 0 || len != _OUTBOX_META_LEN || _get_u32(meta) != _OUTBOX_META_MAGIC) {
+        return;
+    }
+
+    ob->head = _get_u32(meta + 4);
+    ob->tail = _get_u32(meta + 8);
+    ob->dup_below = _get_u32(meta + 12);
+    ob->last_id = _get_u16(meta + 16);
+    /* outbox opened smaller than before keeps the newest messages */
+    while (ob->tail - ob->head > ob->max_msgs) {
+        _outbox_key(ob, ob->head++, key);
+        HAL_Kv_Del(key);
+        ob->stats.dropped++;
+    }
+    ob->sent = ob->head;
+    ob->sent_mark = ((int32_t)(ob->dup_below - ob->head) > 0) ? ob->dup_below : ob->head;
+}
+
+/* remove messages from head while they are acknowledged, called with ob->lock held */
+static void _outbox_pop_acked(iotx_mc_outbox_t *ob)
+{
+    char key[_OUTBOX_KEY_LEN];
+    int popped = 0;
+
+    while (ob->head != ob->sent && ob->slots[ob->slot_first].acked) {
+        _outbox_key(ob, ob->head, key);
+        HAL_Kv_Del(key);
+        ob->head++;
+        ob->slot_first = (ob->slot_first + 1) % IOTX_MC_OUTBOX_INFLIGHT_MAX;
+        popped = 1;
+    }
+
+    if (!popped) {
+        return;
+    }
+
+    _outbox_save_meta(ob);
+    if (ob->head == ob->tail && ob->drain_start != 0) {
+        ob->stats.last_drain_msgs = ob->stats.drained - ob->drain_base;
+        ob->stats.last_drain_ms = (uint32_t)(HAL_UptimeMs() - ob->drain_start);
+        ob->drain_start = 0;
+    }
+}
+
+/* message at ob->sent has been sent or skipped, called with ob->lock held */
+static void _outbox_mark_sent(iotx_mc_outbox_t *ob, uint16_t msg_id, int acked)
+{
+    iotx_mc_outbox_slot_t *slot = &ob->slots[(ob->slot_first + (ob->sent - ob->head)) % IOTX_MC_OUTBOX_INFLIGHT_MAX];
+
+    slot->msg_id = msg_id;
+    slot->acked = acked ? 1 : 0;
+    ob->sent++;
+    _outbox_pop_acked(ob);
+}
+
+iotx_mc_outbox_t *iotx_mc_outbox_open(const char *name, uint32_t max_msgs)
+{
+    iotx_mc_outbox_t *ob = NULL;
+
+    if (name == NULL || name[0] == '\0' || strlen(name) > IOTX_MC_OUTBOX_NAME_LEN || max_msgs == 0) {
+        return NULL;
+    }
+
+    ob = (iotx_mc_outbox_t *)mqtt_malloc(sizeof(iotx_mc_outbox_t));
+    if (ob == NULL) {
+        return NULL;
+    }
+    memset(ob, 0, sizeof(iotx_mc_outbox_t));
+
+    ob->buf_read = mqtt_malloc(_OUTBOX_MSG_BUF_LEN);
+    ob->buf_write = mqtt_malloc(_OUTBOX_MSG_BUF_LEN);
+    ob->lock = HAL_MutexCreate();
+    if (ob->buf_read == NULL || ob->buf_write == NULL || ob->lock == NULL) {
+        iotx_mc_outbox_close(ob);
+        return NULL;
+    }
+
+    strcpy(ob->name, name);
+    ob->max_msgs = max_msgs;
+    _outbox_load_meta(ob);
+    mqtt_info("outbox %s opened with %u messages", ob->name, (unsigned int)(ob->tail - ob->head));
+
+    return ob;
+}
+
+void iotx_mc_outbox_close(iotx_mc_outbox_t *ob)
+{
+    if (ob == NULL) {
+        return;
+    }
+
+    if (ob->lock != NULL) {
+        HAL_MutexDestroy(ob->lock);
+    }
+    if (ob->buf_read != NULL) {
+        mqtt_free(ob->buf_read);
+    }
+    if (ob->buf_write != NULL) {
+        mqtt_free(ob->buf_write);
+    }
+    mqtt_free(ob);
+}
+
+int iotx_mc_outbox_pending(iotx_mc_outbox_t *ob)
+{
+    int pending;
+
+    HAL_MutexLock(ob->lock);
+    pending = (ob->head != ob->tail);
+    HAL_MutexUnlock(ob->lock);
+
+    return pending;
+}
+
+int iotx_mc_outbox_push(iotx_mc_outbox_t *ob, const char *topic, iotx_mqtt_topic_info_pt topic_msg)
+{
+    char key[_OUTBOX_KEY_LEN];
+    unsigned char *msg = (unsigned char *)ob->buf_write;
+    uint32_t topic_len = strlen(topic);
+    uint32_t len = 0;
+
+    if (topic_len + 1 + topic_msg->payload_len > IOTX_MC_OUTBOX_MSG_LEN_MAX) {
+        mqtt_err("message too long for outbox, topic len=%u, payload len=%u",
+                 (unsigned int)topic_len, (unsigned int)topic_msg->payload_len);
+        return MQTT_PUBLISH_PACKET_ERROR;
+    }
+
+    HAL_MutexLock(ob->lock);
+    if (ob->tail - ob->head >= ob->max_msgs) {
+        /* messages already sent can not be dropped, they are removed by PUBACK */
+        if (IOTX_MC_OUTBOX_DROP_NEWEST || ob->head != ob->sent) {
+            ob->stats.dropped++;
+            HAL_MutexUnlock(ob->lock);
+            return MQTT_OUTBOX_FULL;
+        }
+        _outbox_key(ob, ob->head, key);
+        HAL_Kv_Del(key);
+        ob->head++;
+        ob->sent = ob->head;
+        if ((int32_t)(ob->sent_mark - ob->head) < 0) {
+            ob->sent_mark = ob->head;
+        }
+        ob->stats.dropped++;
+    }
+
+    _put_u16(msg, topic_msg->packet_id);
+    msg[2] = topic_msg->qos;
+    msg[3] = topic_msg->retain;
+    _put_u16(msg + 4, (uint16_t)topic_len);
+    _put_u32(msg + 6, topic_msg->payload_len);
+    len = _OUTBOX_MSG_HEAD_LEN;
+    memcpy(msg + len, topic, topic_len + 1);
+    len += topic_len + 1;
+    memcpy(msg + len, topic_msg->payload, topic_msg->payload_len);
+    len += topic_msg->payload_len;
+
+    _outbox_key(ob, ob->tail, key);
+    if (HAL_Kv_Set(key, msg, len, 0) != 0) {
+        mqtt_err("store message into outbox failed");
+        HAL_MutexUnlock(ob->lock);
+        return FAIL_RETURN;
+    }
+    ob->tail++;
+    if (topic_msg->qos > IOTX_MQTT_QOS0) {
+        ob->last_id = topic_msg->packet_id;
+    }
+    _outbox_save_meta(ob);
+    ob->stats.queued++;
+    HAL_MutexUnlock(ob->lock);
+
+    return SUCCESS_RETURN;
+}
+
+int iotx_mc_outbox_peek(iotx_mc_outbox_t *ob, const char **topic, iotx_mqtt_topic_info_pt topic_msg)
+{
+    char key[_OUTBOX_KEY_LEN];
+    unsigned char *msg = (unsigned char *)ob->buf_read;
+    int len = _OUTBOX_MSG_BUF_LEN - 1;
+    uint32_t topic_len = 0;
+
+    HAL_MutexLock(ob->lock);
+    while (ob->sent != ob->tail && ob->sent - ob->head < IOTX_MC_OUTBOX_INFLIGHT_MAX) {
+        _outbox_key(ob, ob->sent, key);
+        len = _OUTBOX_MSG_BUF_LEN - 1;
+        if (HAL_Kv_Get(key, msg, &len) == 0 && len >= _OUTBOX_MSG_HEAD_LEN) {
+            topic_len = _get_u16(msg + 4);
+            if (_OUTBOX_MSG_HEAD_LEN + topic_len + 1 + _get_u32(msg + 6) == (uint32_t)len) {
+                break;
+            }
+        }
+
+        /* record is lost or broken, skip it rather than stall the queue */
+        mqtt_err("outbox message %u unreadable, dropped", (unsigned int)ob->sent);
+        ob->stats.dropped++;
+        _outbox_mark_sent(ob, 0, 1);
+    }
+
+    if (ob->sent == ob->tail || ob->sent - ob->head >= IOTX_MC_OUTBOX_INFLIGHT_MAX) {
+        HAL_MutexUnlock(ob->lock);
+        return FAIL_RETURN;
+    }
+
+    if (ob->drain_start == 0) {
+        ob->drain_start = HAL_UptimeMs();
+        ob->drain_base = ob->stats.drained;
+    }
+    if ((int32_t)(ob->sent - ob->sent_mark) >= 0) {
+        /* recorded before sending, a window of messages at a time rather than one write for each */
+        ob->sent_mark = ob->sent + IOTX_MC_OUTBOX_INFLIGHT_MAX;
+        if ((int32_t)(ob->sent_mark - ob->tail) > 0) {
+            ob->sent_mark = ob->tail;
+        }
+        _outbox_save_meta(ob);
+    }
+
+    memset(topic_msg, 0, sizeof(iotx_mqtt_topic_info_t));
+    topic_msg->packet_id = _get_u16(msg);
+    topic_msg->qos = msg[2];
+    topic_msg->retain = msg[3];
+    topic_msg->dup = (topic_msg->qos > IOTX_MQTT_QOS0 && (int32_t)(ob->sent - ob->dup_below) < 0) ? 1 : 0;
+    topic_msg->topic_len = (uint16_t)topic_len;
+    topic_msg->payload_len = _get_u32(msg + 6);
+    topic_msg->ptopic = (const char *)msg + _OUTBOX_MSG_HEAD_LEN;
+    topic_msg->payload = (const char *)msg + _OUTBOX_MSG_HEAD_LEN + topic_len + 1;
+    msg[len] = '\0';
+    *topic = topic_msg->ptopic;
+    HAL_MutexUnlock(ob->lock);
+
+    return SUCCESS_RETURN;
+}
+
+void iotx_mc_outbox_sent(iotx_mc_outbox_t *ob, iotx_mqtt_topic_info_pt topic_msg, int drop)
+{
+    HAL_MutexLock(ob->lock);
+    if (drop) {
+        ob->stats.dropped++;
+    } else {
+        ob->stats.drained++;
+    }
+    _outbox_mark_sent(ob, topic_msg->packet_id, drop || topic_msg->qos == IOTX_MQTT_QOS0);
+    HAL_MutexUnlock(ob->lock);
+}
+
+void iotx_mc_outbox_ack(iotx_mc_outbox_t *ob, uint16_t msg_id)
+{
+    uint32_t idx;
+    uint32_t cnt;
+    iotx_mc_outbox_slot_t *slot = NULL;
+
+    HAL_MutexLock(ob->lock);
+    cnt = ob->sent - ob->head;
+    for (idx = 0; idx < cnt; idx++) {
+        slot = &ob->slots[(ob->slot_first + idx) % IOTX_MC_OUTBOX_INFLIGHT_MAX];
+        if (!slot->acked && slot->msg_id == msg_id) {
+            slot->acked = 1;
+            break;
+        }
+    }
+    if (idx < cnt) {
+        _outbox_pop_acked(ob);
+    }
+    HAL_MutexUnlock(ob->lock);
+}
+
+void iotx_mc_outbox_stats(iotx_mc_outbox_t *ob, iotx_mqtt_outbox_stats_t *stats)
+{
+    HAL_MutexLock(ob->lock);
+    memcpy(stats, &ob->stats, sizeof(iotx_mqtt_outbox_stats_t));
+    stats->stored = ob->tail - ob->head;
+    stats->inflight = ob->sent - ob->head;
+    HAL_MutexUnlock(ob->lock);
+}
+
+#endif  /* #if WITH_MQTT_OUTBOX && defined(PLATFORM_HAS_DYNMEM) */
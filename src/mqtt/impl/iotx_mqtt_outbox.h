@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2015-2018 Alibaba Group Holding Limited
+ */
+
+#ifndef __IOTX_MQTT_OUTBOX_H__
+#define __IOTX_MQTT_OUTBOX_H__
+
+#include "infra_types.h"
+#include "mqtt_api.h"
+
+/*
+ * Persistent outbox of MQTT client.
+ *
+ * Publishes made while the connection is down are appended to a queue kept in HAL_Kv_XXX(), one
+ * record per message keyed by a sequence number, plus a meta record holding both ends of the queue.
+ * Once connected again the queue is sent from its oldest message on, new publishes join its end
+ * until it is empty so that messages keep their order, and a QoS1 message is removed only when its
+ * PUBACK arrives. Packet id of QoS1 message is taken when it is stored and kept with it, a message
+ * sent again after restart carries the same id with DUP flag set, so that receiver can drop the copy.
+ */
+
+/* length of outbox name, which prefixes its keys in HAL_Kv_XXX() */
+#define IOTX_MC_OUTBOX_NAME_LEN                 (32)
+
+typedef struct {
+    uint16_t                msg_id;
+    uint8_t                 acked;
+} iotx_mc_outbox_slot_t;
+
+typedef struct {
+    char                    name[IOTX_MC_OUTBOX_NAME_LEN + 1];
+    uint32_t                max_msgs;
+    uint32_t                head;           /* oldest stored message */
+    uint32_t                tail;           /* sequence of next message to store */
+    uint32_t                sent;           /* next message to send, those from head are waiting for PUBACK */
+    uint32_t                sent_mark;      /* messages before may have been sent, kept in meta record */
+    uint32_t                dup_below;      /* sent_mark of previous run */
+    uint16_t                last_id;        /* packet id of newest stored QoS1 message */
+    iotx_mc_outbox_slot_t   slots[IOTX_MC_OUTBOX_INFLIGHT_MAX]; /* messages from head to sent */
+    uint32_t                slot_first;
+    char                   *buf_read;       /* message being sent */
+    char                   *buf_write;      /* message being stored */
+    void                   *lock;
+    uint64_t                drain_start;    /* time sending of stored messages began, 0 if queue is empty */
+    uint32_t                drain_base;
+    iotx_mqtt_outbox_stats_t stats;
+} iotx_mc_outbox_t;
+
+/**
+ * @brief Open outbox @name, messages left by previous run are kept.
+ *
+ * @param [in] name: name of outbox, at most IOTX_MC_OUTBOX_NAME_LEN characters.
+ * @param [in] max_msgs: messages kept at most, older ones are dropped for newer ones when full.
+ *
+ * @return outbox, NULL when failed.
+ */
+iotx_mc_outbox_t *iotx_mc_outbox_open(const char *name, uint32_t max_msgs);
+
+/**
+ * @brief Close outbox, the stored messages stay for next open.
+ */
+void iotx_mc_outbox_close(iotx_mc_outbox_t *ob);
+
+/**
+ * @brief Whether outbox has messages not acknowledged yet, new publishes must be queued behind them.
+ */
+int iotx_mc_outbox_pending(iotx_mc_outbox_t *ob);
+
+/**
+ * @brief Store a message at end of queue, its packet id must have been assigned.
+ *
+ * @return SUCCESS_RETURN, MQTT_OUTBOX_FULL when full and oldest message can not be dropped,
+ *         other negative value when message can not be stored.
+ */
+int iotx_mc_outbox_push(iotx_mc_outbox_t *ob, const char *topic, iotx_mqtt_topic_info_pt topic_msg);
+
+/**
+ * @brief Load next message to send.
+ *
+ * @param [in] ob: the outbox.
+ * @param [out] topic: topic of message, valid until next call.
+ * @param [out] topic_msg: message with stored packet id and DUP flag, payload valid until next call.
+ *
+ * @return SUCCESS_RETURN, FAIL_RETURN when nothing is to be sent or too many are waiting for PUBACK.
+ */
+int iotx_mc_outbox_peek(iotx_mc_outbox_t *ob, const char **topic, iotx_mqtt_topic_info_pt topic_msg);
+
+/**
+ * @brief Mark message loaded by iotx_mc_outbox_peek() as sent, QoS0 or @drop one is removed at once.
+ */
+void iotx_mc_outbox_sent(iotx_mc_outbox_t *ob, iotx_mqtt_topic_info_pt topic_msg, int drop);
+
+/**
+ * @brief Remove message acknowledged by PUBACK of @msg_id, nothing happens if it is not from outbox.
+ */
+void iotx_mc_outbox_ack(iotx_mc_outbox_t *ob, uint16_t msg_id);
+
+void iotx_mc_outbox_stats(iotx_mc_outbox_t *ob, iotx_mqtt_outbox_stats_t *stats);
+
+#endif  /* __IOTX_MQTT_OUTBOX_H__ */
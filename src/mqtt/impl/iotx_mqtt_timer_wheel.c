@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2015-2018 Alibaba Group Holding Limited
+ */
+#include "mqtt_internal.h"
+
+#ifdef PLATFORM_HAS_DYNMEM
+
+#define _WHEEL_LEVEL_SPAN(level)        ((uint64_t)1 << (IOTX_MC_WHEEL_SLOT_BITS * ((level) + 1)))
+#define _WHEEL_LEVEL_INDEX(tick, level) (((tick) >> (IOTX_MC_WHEEL_SLOT_BITS * (level))) & IOTX_MC_WHEEL_SLOT_MASK)
+
+/* move all nodes of @src to the tail of @dst, @src becomes empty */
+static void _wheel_list_move_tail(struct list_head *src, struct list_head *dst)
+{
+    if (list_empty(src)) {
+        return;
+    }
+
+    src->next->prev = dst->prev;
+    dst->prev->next = src->next;
+    src->prev->next = dst;
+    dst->prev = src->prev;
+    INIT_LIST_HEAD(src);
+}
+
+static void _wheel_place(iotx_mc_timer_wheel_t *wheel, iotx_mc_wheel_timer_t *timer)
+{
+    uint64_t expires = timer->expires;
+    uint64_t delta = 0;
+    int level = 0;
+
+    if (expires < wheel->current) {
+        expires = wheel->current;
+    }
+
+    delta = expires - wheel->current;
+    if (delta >= _WHEEL_LEVEL_SPAN(IOTX_MC_WHEEL_LEVEL_NUM - 1)) {
+        /* too far away, park it in the last level and sort it again when cascaded */
+        expires = wheel->current + _WHEEL_LEVEL_SPAN(IOTX_MC_WHEEL_LEVEL_NUM - 1) - 1;
+        level = IOTX_MC_WHEEL_LEVEL_NUM - 1;
+    } else {
+        while (delta >= _WHEEL_LEVEL_SPAN(level)) {
+            level++;
+        }
+    }
+
+    list_add_tail(&timer->linked_list, &wheel->slots[level][_WHEEL_LEVEL_INDEX(expires, level)]);
+}
+
+/* re-sort one slot of upper level into lower levels, return index of the slot */
+static int _wheel_cascade(iotx_mc_timer_wheel_t *wheel, int level)
+{
+    int index = (int)_WHEEL_LEVEL_INDEX(wheel->current, level);
+    struct list_head pending;
+    iotx_mc_wheel_timer_t *timer = NULL, *next = NULL;
+
+    INIT_LIST_HEAD(&pending);
+    _wheel_list_move_tail(&wheel->slots[level][index], &pending);
+
+    list_for_each_entry_safe(timer, next, &pending, linked_list, iotx_mc_wheel_timer_t) {
+        list_del(&timer->linked_list);
+        _wheel_place(wheel, timer);
+    }
+
+    return index;
+}
+
+void iotx_mc_timer_wheel_init(iotx_mc_timer_wheel_t *wheel, uint64_t now_ms)
+{
+    int level = 0;
+    int index = 0;
+
+    for (level = 0; level < IOTX_MC_WHEEL_LEVEL_NUM; level++) {
+        for (index = 0; index < IOTX_MC_WHEEL_SLOT_NUM; index++) {
+            INIT_LIST_HEAD(&wheel->slots[level][index]);
+        }
+    }
+
+    wheel->current = now_ms / IOTX_MC_WHEEL_TICK_MS;
+    wheel->count = 0;
+}
+
+void iotx_mc_timer_wheel_add(iotx_mc_timer_wheel_t *wheel, iotx_mc_wheel_timer_t *timer, uint64_t expire_ms)
+{
+    /* round up, a timer never fires before @expire_ms */
+    timer->expires = (expire_ms + IOTX_MC_WHEEL_TICK_MS - 1) / IOTX_MC_WHEEL_TICK_MS;
+    _wheel_place(wheel, timer);
+    wheel->count++;
+}
+
+void iotx_mc_timer_wheel_del(iotx_mc_timer_wheel_t *wheel, iotx_mc_wheel_timer_t *timer)
+{
+    if (timer->linked_list.next == NULL || list_empty(&timer->linked_list)) {
+        return;
+    }
+
+    list_del(&timer->linked_list);
+    INIT_LIST_HEAD(&timer->linked_list);
+    wheel->count--;
+}
+
+int iotx_mc_timer_wheel_expire(iotx_mc_timer_wheel_t *wheel, uint64_t now_ms, struct list_head *expired)
+{
+    int count = 0;
+    int level = 0;
+    uint64_t target = now_ms / IOTX_MC_WHEEL_TICK_MS;
+    iotx_mc_wheel_timer_t *timer = NULL;
+
+    while (wheel->current <= target) {
+        struct list_head *slot = NULL;
+
+        if (wheel->count == 0) {
+            /* nothing pending, no need to turn tick by tick */
+            wheel->current = target + 1;
+            break;
+        }
+
+        /* entering a new round of lower level, pull timers down from upper levels */
+        if (_WHEEL_LEVEL_INDEX(wheel->current, 0) == 0) {
+            for (level = 1; level < IOTX_MC_WHEEL_LEVEL_NUM; level++) {
+                if (_wheel_cascade(wheel, level) != 0) {
+                    break;
+                }
+            }
+        }
+
+        slot = &wheel->slots[0][_WHEEL_LEVEL_INDEX(wheel->current, 0)];
+        list_for_each_entry(timer, slot, linked_list, iotx_mc_wheel_timer_t) {
+            count++;
+            wheel->count--;
+        }
+        _wheel_list_move_tail(slot, expired);
+
+        wheel->current++;
+    }
+
+    return count;
+}
+
+#endif  /* #ifdef PLATFORM_HAS_DYNMEM */
+
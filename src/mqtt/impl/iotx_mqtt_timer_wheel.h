@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2015-2018 Alibaba Group Holding Limited
+ */
+
+#ifndef __IOTX_MQTT_TIMER_WHEEL_H__
+#define __IOTX_MQTT_TIMER_WHEEL_H__
+
+#include "infra_types.h"
+#include "infra_list.h"
+
+/*
+ * Hierarchical timing wheel of MQTT client.
+ *
+ * Timers due within IOTX_MC_WHEEL_SLOT_NUM ticks sit in the first level, the later ones sit in
+ * coarser levels and cascade down as the wheel turns. Adding or removing a timer is O(1), and
+ * collecting expired timers costs O(expired) plus one slot per elapsed tick, independent of how
+ * many timers are pending.
+ */
+
+/* resolution of wheel in millisecond */
+#ifndef IOTX_MC_WHEEL_TICK_MS
+    #define IOTX_MC_WHEEL_TICK_MS               (10)
+#endif
+
+/* slots of each level is (1 << IOTX_MC_WHEEL_SLOT_BITS) */
+#define IOTX_MC_WHEEL_SLOT_BITS                 (6)
+#define IOTX_MC_WHEEL_SLOT_NUM                  (1 << IOTX_MC_WHEEL_SLOT_BITS)
+#define IOTX_MC_WHEEL_SLOT_MASK                 (IOTX_MC_WHEEL_SLOT_NUM - 1)
+
+/* 4 levels of 10ms tick cover about 46 hours, timers due later wait in the last slot and are re-sorted */
+#define IOTX_MC_WHEEL_LEVEL_NUM                 (4)
+
+/* Hook embedded in the object to be timed */
+typedef struct {
+    struct list_head        linked_list;
+    uint64_t                expires;        /* due tick */
+} iotx_mc_wheel_timer_t;
+
+typedef struct {
+    uint64_t                current;        /* next tick to be processed */
+    uint32_t                count;          /* pending timers */
+    struct list_head        slots[IOTX_MC_WHEEL_LEVEL_NUM][IOTX_MC_WHEEL_SLOT_NUM];
+} iotx_mc_timer_wheel_t;
+
+/**
+ * @brief Initialize an empty wheel.
+ *
+ * @param [in] wheel: the wheel.
+ * @param [in] now_ms: current time in millisecond, from HAL_UptimeMs() or a mocked clock.
+ */
+void iotx_mc_timer_wheel_init(iotx_mc_timer_wheel_t *wheel, uint64_t now_ms);
+
+/**
+ * @brief Arm a timer, it must not be pending already.
+ *
+ * @param [in] wheel: the wheel.
+ * @param [in] timer: hook of timed object, it must stay valid until expired or removed.
+ * @param [in] expire_ms: absolute time in millisecond, a time already passed expires at next collection.
+ */
+void iotx_mc_timer_wheel_add(iotx_mc_timer_wheel_t *wheel, iotx_mc_wheel_timer_t *timer, uint64_t expire_ms);
+
+/**
+ * @brief Disarm a pending timer, nothing happens if it is not pending.
+ */
+void iotx_mc_timer_wheel_del(iotx_mc_timer_wheel_t *wheel, iotx_mc_wheel_timer_t *timer);
+
+/**
+ * @brief Turn the wheel to @now_ms and move every timer due by then onto @expired.
+ *
+ * @param [in] wheel: the wheel.
+ * @param [in] now_ms: current time in millisecond.
+ * @param [out] expired: list receiving hooks of expired timers, in order of expiry.
+ *
+ * @return count of expired timers.
+ */
+int iotx_mc_timer_wheel_expire(iotx_mc_timer_wheel_t *wheel, uint64_t now_ms, struct list_head *expired);
+
+#endif  /* __IOTX_MQTT_TIMER_WHEEL_H__ */
+
@@ -0,0 +1,469 @@
+/*
+ * Copyright (C) 2015-2018 Alibaba Group Holding Limited
+ */
+#include "mqtt_internal.h"
+
+#ifdef PLATFORM_HAS_DYNMEM
+
+static uint32_t _trie_hash(const char *key, uint32_t len)
+{
+    uint32_t hash = 2166136261u;    /* FNV-1a */
+    uint32_t idx;
+
+    for (idx = 0; idx < len; idx++) {
+        hash ^= (uint8_t)key[idx];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+static iotx_mc_trie_node_t *_trie_node_new(iotx_mc_trie_node_t *parent, const char *level, uint16_t level_len,
+        uint32_t hash)
+{
+    iotx_mc_trie_node_t *node = NULL;
+
+    node = mqtt_malloc(sizeof(iotx_mc_trie_node_t) + level_len);
+    if (node == NULL) {
+        return NULL;
+    }
+    memset(node, 0, sizeof(iotx_mc_trie_node_t) + level_len);
+
+    node->parent = parent;
+    node->hash = hash;
+    node->level_len = level_len;
+    memcpy(node->level, level, level_len);
+    INIT_LIST_HEAD(&node->entries);
+
+    return node;
+}
+
+static int _trie_node_is_idle(iotx_mc_trie_node_t *node)
+{
+    return (list_empty(&node->entries) && node->children_cnt == 0 && node->plus == NULL && node->pound == NULL);
+}
+
+static iotx_mc_trie_node_t *_trie_child_get(iotx_mc_trie_node_t *node, const char *level, uint16_t level_len,
+        uint32_t hash)
+{
+    iotx_mc_trie_node_t *child = NULL;
+
+    if (node->children == NULL) {
+        return NULL;
+    }
+
+    child = node->children[hash & (node->children_size - 1)];
+    while (child != NULL) {
+        if (child->hash == hash && child->level_len == level_len && memcmp(child->level, level, level_len) == 0) {
+            return child;
+        }
+        child = child->next;
+    }
+
+    return NULL;
+}
+
+static int _trie_children_grow(iotx_mc_trie_node_t *node)
+{
+    uint16_t size = 0;
+    uint16_t idx = 0;
+    iotx_mc_trie_node_t **children = NULL;
+
+    size = (node->children_size == 0) ? IOTX_MC_TRIE_CHILD_TABLE_SIZE : node->children_size * 2;
+    children = mqtt_malloc(size * sizeof(iotx_mc_trie_node_t *));
+    if (children == NULL) {
+        return FAIL_RETURN;
+    }
+    memset(children, 0, size * sizeof(iotx_mc_trie_node_t *));
+
+    for (idx = 0; idx < node->children_size; idx++) {
+        iotx_mc_trie_node_t *child = node->children[idx];
+        while (child != NULL) {
+            iotx_mc_trie_node_t *next = child->next;
+            child->next = children[child->hash & (size - 1)];
+            children[child->hash & (size - 1)] = child;
+            child = next;
+        }
+    }
+
+    if (node->children != NULL) {
+        mqtt_free(node->children);
+    }
+    node->children = children;
+    node->children_size = size;
+
+    return SUCCESS_RETURN;
+}
+
+static iotx_mc_trie_node_t *_trie_child_add(iotx_mc_trie_node_t *node, const char *level, uint16_t level_len)
+{
+    uint32_t hash = 0;
+    iotx_mc_trie_node_t *child = NULL;
+    iotx_mc_trie_node_t **slot = NULL;
+
+    if (level_len == 1 && level[0] == '+') {
+        slot = &node->plus;
+    } else if (level_len == 1 && level[0] == '#') {
+        slot = &node->pound;
+    }
+
+    if (slot != NULL) {
+        if (*slot == NULL) {
+            *slot = _trie_node_new(node, level, level_len, 0);
+        }
+        return *slot;
+    }
+
+    hash = _trie_hash(level, level_len);
+    child = _trie_child_get(node, level, level_len, hash);
+    if (child != NULL) {
+        return child;
+    }
+
+    if (node->children_cnt >= node->children_size) {
+        if (_trie_children_grow(node) != SUCCESS_RETURN) {
+            return NULL;
+        }
+    }
+
+    child = _trie_node_new(node, level, level_len, hash);
+    if (child == NULL) {
+        return NULL;
+    }
+    child->next = node->children[hash & (node->children_size - 1)];
+    node->children[hash & (node->children_size - 1)] = child;
+    node->children_cnt++;
+
+    return child;
+}
+
+static void _trie_child_unlink(iotx_mc_trie_node_t *node, iotx_mc_trie_node_t *child)
+{
+    iotx_mc_trie_node_t **pos = NULL;
+
+    if (node->plus == child) {
+        node->plus = NULL;
+        return;
+    }
+    if (node->pound == child) {
+        node->pound = NULL;
+        return;
+    }
+
+    pos = &node->children[child->hash & (node->children_size - 1)];
+    while (*pos != NULL) {
+        if (*pos == child) {
+            *pos = child->next;
+            node->children_cnt--;
+            return;
+        }
+        pos = &(*pos)->next;
+    }
+}
+
+static void _trie_node_free(iotx_mc_trie_node_t *node)
+{
+    uint16_t idx = 0;
+
+    if (node == NULL) {
+        return;
+    }
+
+    for (idx = 0; idx < node->children_size; idx++) {
+        iotx_mc_trie_node_t *child = node->children[idx];
+        while (child != NULL) {
+            iotx_mc_trie_node_t *next = child->next;
+            _trie_node_free(child);
+            child = next;
+        }
+    }
+    _trie_node_free(node->plus);
+    _trie_node_free(node->pound);
+
+    if (node->children != NULL) {
+        mqtt_free(node->children);
+    }
+    mqtt_free(node);
+}
+
+/* walk the trie by levels of @key, treat '+' and '#' literally */
+static iotx_mc_trie_node_t *_trie_locate(iotx_mc_topic_trie_t *trie, const char *key, uint32_t key_len, int create)
+{
+    const char *pos = key;
+    const char *end = key + key_len;
+    iotx_mc_trie_node_t *node = trie->root;
+
+    while (node != NULL) {
+        const char *level_end = memchr(pos, '/', end - pos);
+        uint16_t level_len = 0;
+
+        level_end = (level_end == NULL) ? end : level_end;
+        level_len = (uint16_t)(level_end - pos);
+
+        if (create) {
+            node = _trie_child_add(node, pos, level_len);
+        } else if (level_len == 1 && pos[0] == '+') {
+            node = node->plus;
+        } else if (level_len == 1 && pos[0] == '#') {
+            node = node->pound;
+        } else {
+            node = _trie_child_get(node, pos, level_len, _trie_hash(pos, level_len));
+        }
+
+        if (level_end == end) {
+            break;
+        }
+        pos = level_end + 1;
+    }
+
+    return node;
+}
+
+static int _trie_exact_grow(iotx_mc_topic_trie_t *trie)
+{
+    uint32_t size = 0;
+    uint32_t idx = 0;
+    struct list_head *exact = NULL;
+
+    size = trie->exact_size * 2;
+    exact = mqtt_malloc(size * sizeof(struct list_head));
+    if (exact == NULL) {
+        return FAIL_RETURN;
+    }
+    for (idx = 0; idx < size; idx++) {
+        INIT_LIST_HEAD(&exact[idx]);
+    }
+
+    for (idx = 0; idx < trie->exact_size; idx++) {
+        iotx_mc_trie_entry_t *entry = NULL, *next = NULL;
+        list_for_each_entry_safe(entry, next, &trie->exact[idx], linked_list, iotx_mc_trie_entry_t) {
+            list_del(&entry->linked_list);
+            list_add_tail(&entry->linked_list, &exact[entry->hash & (size - 1)]);
+        }
+    }
+
+    mqtt_free(trie->exact);
+    trie->exact = exact;
+    trie->exact_size = size;
+
+    return SUCCESS_RETURN;
+}
+
+static int _trie_visit_list(struct list_head *head, const char *key, uint32_t key_len, uint32_t hash,
+                            iotx_mc_trie_visit_fpt visit, void *ctx, int *count)
+{
+    iotx_mc_trie_entry_t *entry = NULL, *next = NULL;
+
+    list_for_each_entry_safe(entry, next, head, linked_list, iotx_mc_trie_entry_t) {
+        if (key != NULL) {
+            if (entry->hash != hash || entry->key_len != key_len || memcmp(entry->key, key, key_len) != 0) {
+                continue;
+            }
+        }
+        (*count)++;
+        if (visit(entry, ctx) != 0) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static int _trie_match(iotx_mc_trie_node_t *node, const char *pos, const char *end, int has_level,
+                       iotx_mc_trie_visit_fpt visit, void *ctx, int *count)
+{
+    const char *level_end = NULL;
+    const char *next_pos = NULL;
+    int next_has_level = 0;
+    uint16_t level_len = 0;
+    iotx_mc_trie_node_t *child = NULL;
+
+    if (!has_level) {
+        return _trie_visit_list(&node->entries, NULL, 0, 0, visit, ctx, count);
+    }
+
+    /* '#' matches current and all following levels, as long as there is something left */
+    if (node->pound != NULL && end > pos) {
+        if (_trie_visit_list(&node->pound->entries, NULL, 0, 0, visit, ctx, count) != 0) {
+            return 1;
+        }
+    }
+
+    level_end = memchr(pos, '/', end - pos);
+    if (level_end == NULL) {
+        level_end = end;
+        next_pos = end;
+        next_has_level = 0;
+    } else {
+        next_pos = level_end + 1;
+        next_has_level = 1;
+    }
+    level_len = (uint16_t)(level_end - pos);
+
+    /* '+' matches exactly one non-empty level */
+    if (node->plus != NULL && level_len > 0) {
+        if (_trie_match(node->plus, next_pos, end, next_has_level, visit, ctx, count) != 0) {
+            return 1;
+        }
+    }
+
+    child = _trie_child_get(node, pos, level_len, _trie_hash(pos, level_len));
+    if (child != NULL) {
+        return _trie_match(child, next_pos, end, next_has_level, visit, ctx, count);
+    }
+
+    return 0;
+}
+
+int iotx_mc_topic_trie_init(iotx_mc_topic_trie_t *trie)
+{
+    uint32_t idx = 0;
+
+    if (trie == NULL) {
+        return NULL_VALUE_ERROR;
+    }
+    memset(trie, 0, sizeof(iotx_mc_topic_trie_t));
+
+    trie->exact = mqtt_malloc(IOTX_MC_TRIE_EXACT_TABLE_SIZE * sizeof(struct list_head));
+    if (trie->exact == NULL) {
+        return ERROR_MALLOC;
+    }
+    for (idx = 0; idx < IOTX_MC_TRIE_EXACT_TABLE_SIZE; idx++) {
+        INIT_LIST_HEAD(&trie->exact[idx]);
+    }
+    trie->exact_size = IOTX_MC_TRIE_EXACT_TABLE_SIZE;
+
+    trie->root = _trie_node_new(NULL, "", 0, 0);
+    if (trie->root == NULL) {
+        mqtt_free(trie->exact);
+        return ERROR_MALLOC;
+    }
+
+    return SUCCESS_RETURN;
+}
+
+void iotx_mc_topic_trie_deinit(iotx_mc_topic_trie_t *trie)
+{
+    if (trie == NULL) {
+        return;
+    }
+
+    /* entries are owned by subscription handles, only the index itself is released here */
+    if (trie->exact != NULL) {
+        mqtt_free(trie->exact);
+    }
+    _trie_node_free(trie->root);
+    memset(trie, 0, sizeof(iotx_mc_topic_trie_t));
+}
+
+int iotx_mc_topic_trie_insert(iotx_mc_topic_trie_t *trie, iotx_mc_trie_entry_t *entry,
+                              const char *key, uint32_t key_len, int wildcard)
+{
+    if (trie == NULL || trie->root == NULL || entry == NULL || key == NULL || key_len == 0) {
+        return NULL_VALUE_ERROR;
+    }
+
+    entry->key = key;
+    entry->key_len = key_len;
+    entry->hash = _trie_hash(key, key_len);
+    entry->node = NULL;
+    INIT_LIST_HEAD(&entry->linked_list);
+
+    if (!wildcard) {
+        if (trie->exact_cnt >= trie->exact_size) {
+            /* keep going with longer chains if table can not grow */
+            _trie_exact_grow(trie);
+        }
+        list_add_tail(&entry->linked_list, &trie->exact[entry->hash & (trie->exact_size - 1)]);
+        trie->exact_cnt++;
+        return SUCCESS_RETURN;
+    }
+
+    entry->node = _trie_locate(trie, key, key_len, 1);
+    if (entry->node == NULL) {
+        return ERROR_MALLOC;
+    }
+    list_add_tail(&entry->linked_list, &entry->node->entries);
+
+    return SUCCESS_RETURN;
+}
+
+void iotx_mc_topic_trie_remove(iotx_mc_topic_trie_t *trie, iotx_mc_trie_entry_t *entry)
+{
+    iotx_mc_trie_node_t *node = NULL;
+
+    if (trie == NULL || entry == NULL || entry->key == NULL) {
+        return;
+    }
+
+    list_del(&entry->linked_list);
+    INIT_LIST_HEAD(&entry->linked_list);
+    entry->key = NULL;
+
+    if (entry->node == NULL) {
+        trie->exact_cnt--;
+        return;
+    }
+
+    /* prune nodes which are not used anymore */
+    node = entry->node;
+    entry->node = NULL;
+    while (node != trie->root && _trie_node_is_idle(node)) {
+        iotx_mc_trie_node_t *parent = node->parent;
+        _trie_child_unlink(parent, node);
+        _trie_node_free(node);
+        node = parent;
+    }
+}
+
+int iotx_mc_topic_trie_find(iotx_mc_topic_trie_t *trie, const char *key, uint32_t key_len, int wildcard,
+                            iotx_mc_trie_visit_fpt visit, void *ctx)
+{
+    int count = 0;
+    uint32_t hash = 0;
+    iotx_mc_trie_node_t *node = NULL;
+
+    if (trie == NULL || trie->root == NULL || key == NULL || visit == NULL) {
+        return 0;
+    }
+
+    hash = _trie_hash(key, key_len);
+    if (!wildcard) {
+        _trie_visit_list(&trie->exact[hash & (trie->exact_size - 1)], key, key_len, hash, visit, ctx, &count);
+        return count;
+    }
+
+    node = _trie_locate(trie, key, key_len, 0);
+    if (node != NULL) {
+        _trie_visit_list(&node->entries, NULL, 0, 0, visit, ctx, &count);
+    }
+
+    return count;
+}
+
+int iotx_mc_topic_trie_match(iotx_mc_topic_trie_t *trie, const char *key, uint32_t key_len,
+                             const char *topic, uint32_t topic_len,
+                             iotx_mc_trie_visit_fpt visit, void *ctx)
+{
+    int count = 0;
+    uint32_t hash = 0;
+
+    if (trie == NULL || trie->root == NULL || visit == NULL) {
+        return 0;
+    }
+
+    if (key != NULL && key_len > 0) {
+        hash = _trie_hash(key, key_len);
+        if (_trie_visit_list(&trie->exact[hash & (trie->exact_size - 1)], key, key_len, hash, visit, ctx, &count) != 0) {
+            return count;
+        }
+    }
+
+    if (topic != NULL && topic_len > 0) {
+        _trie_match(trie->root, topic, topic + topic_len, 1, visit, ctx, &count);
+    }
+
+    return count;
+}
+#endif  /* #ifdef PLATFORM_HAS_DYNMEM */
+
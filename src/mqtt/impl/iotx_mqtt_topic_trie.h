@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2015-2018 Alibaba Group Holding Limited
+ */
+
+#ifndef __IOTX_MQTT_TOPIC_TRIE_H__
+#define __IOTX_MQTT_TOPIC_TRIE_H__
+
+#include "infra_types.h"
+#include "infra_list.h"
+
+/*
+ * Subscription index of MQTT client.
+ *
+ * Topic filters without wildcard are kept in a hash table keyed by the whole topic (or its
+ * digest when WITH_MQTT_ZIP_TOPIC is enabled), filters with '+' or '#' are kept in a trie
+ * whose levels are hashed. Looking up an inbound topic costs O(topic depth) instead of
+ * O(number of subscriptions).
+ */
+
+/* initial size of exact-match hash table, must be power of 2 */
+#define IOTX_MC_TRIE_EXACT_TABLE_SIZE           (16)
+
+/* initial size of per-level children hash table, must be power of 2 */
+#define IOTX_MC_TRIE_CHILD_TABLE_SIZE           (4)
+
+typedef struct iotx_mc_trie_node_s iotx_mc_trie_node_t;
+
+/* Hook embedded in each subscription handle, links it into the index */
+typedef struct {
+    struct list_head        linked_list;
+    iotx_mc_trie_node_t    *node;           /* NULL, entry is in exact-match table; NOT NULL, trie node */
+    const char             *key;            /* topic filter or its digest */
+    uint32_t                key_len;
+    uint32_t                hash;
+} iotx_mc_trie_entry_t;
+
+struct iotx_mc_trie_node_s {
+    iotx_mc_trie_node_t    *parent;
+    iotx_mc_trie_node_t    *next;           /* next node in the same bucket of parent */
+    iotx_mc_trie_node_t   **children;       /* children of literal levels */
+    uint16_t                children_size;
+    uint16_t                children_cnt;
+    iotx_mc_trie_node_t    *plus;           /* child of '+' level */
+    iotx_mc_trie_node_t    *pound;          /* child of '#' level */
+    struct list_head        entries;        /* subscriptions ending at this node */
+    uint32_t                hash;
+    uint16_t                level_len;
+    char                    level[1];
+};
+
+typedef struct {
+    struct list_head       *exact;
+    uint32_t                exact_size;
+    uint32_t                exact_cnt;
+    iotx_mc_trie_node_t    *root;
+} iotx_mc_topic_trie_t;
+
+/* called for every entry which matches the topic, return non-zero to stop visiting */
+typedef int (*iotx_mc_trie_visit_fpt)(iotx_mc_trie_entry_t *entry, void *ctx);
+
+int iotx_mc_topic_trie_init(iotx_mc_topic_trie_t *trie);
+void iotx_mc_topic_trie_deinit(iotx_mc_topic_trie_t *trie);
+
+/**
+ * @brief Link a subscription into the index.
+ *
+ * @param [in] trie: the index.
+ * @param [in] entry: hook of the subscription, it must stay valid until removed.
+ * @param [in] key: topic filter, or its digest for exact topics when WITH_MQTT_ZIP_TOPIC enabled.
+ * @param [in] key_len: length of @key in byte.
+ * @param [in] wildcard: 1, @key is a filter with '+' or '#'; 0, @key is an exact topic.
+ *
+ * @retval  0 : success.
+ * @retval <0 : failure, the entry is not linked.
+ */
+int iotx_mc_topic_trie_insert(iotx_mc_topic_trie_t *trie, iotx_mc_trie_entry_t *entry,
+                              const char *key, uint32_t key_len, int wildcard);
+void iotx_mc_topic_trie_remove(iotx_mc_topic_trie_t *trie, iotx_mc_trie_entry_t *entry);
+
+/**
+ * @brief Visit entries whose key is exactly @key, without creating anything.
+ *        Used to find duplicated subscriptions or the ones to be unsubscribed.
+ */
+int iotx_mc_topic_trie_find(iotx_mc_topic_trie_t *trie, const char *key, uint32_t key_len, int wildcard,
+                            iotx_mc_trie_visit_fpt visit, void *ctx);
+
+/**
+ * @brief Visit every subscription which matches an inbound topic.
+ *
+ * @param [in] trie: the index.
+ * @param [in] key/key_len: exact-match key of the topic, the topic itself or its digest.
+ * @param [in] topic/topic_len: the topic name in plain text, used by wildcard matching.
+ * @param [in] visit: callback for each matched entry.
+ * @param [in] ctx: context passed to @visit.
+ *
+ * @return count of visited entries.
+ */
+int iotx_mc_topic_trie_match(iotx_mc_topic_trie_t *trie, const char *key, uint32_t key_len,
+                             const char *topic, uint32_t topic_len,
+                             iotx_mc_trie_visit_fpt visit, void *ctx);
+
+#endif  /* __IOTX_MQTT_TOPIC_TRIE_H__ */
+
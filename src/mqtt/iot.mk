@@ -4,10 +4,24 @@ LIB_SRCS_PATTERN    := *.c
 
 SRCS_mqtt-example       := examples/mqtt_example.c
 SRCS_mqtt-example-at    := examples/mqtt_example_at.c
+SRCS_mqtt-example-pool  := examples/mqtt_example_pool.c examples/mqtt_example_broker.c
+SRCS_mqtt-example-outbox := examples/mqtt_example_outbox.c examples/mqtt_example_broker.c
+SRCS_mqtt-example-topic-match := examples/mqtt_example_topic_match.c examples/mqtt_example_broker.c
+SRCS_mqtt-example-wheel := examples/mqtt_example_wheel.c examples/mqtt_example_broker.c
+SRCS_mqtt-example-latency := examples/mqtt_example_latency.c examples/mqtt_example_broker.c
+SRCS_mqtt-example-kv    := examples/mqtt_example_kv.c
+SRCS_mqtt-example-loopback := examples/mqtt_example_loopback.c examples/mqtt_example_broker.c
 
 $(call Append_Conditional, LIB_SRCS_PATTERN, impl/*.c, MQTT_DEFAULT_IMPL)
 $(call Append_Conditional, TARGET, mqtt-example, MQTT_COMM_ENABLED, ATM_ENABLED BUILD_AOS NO_EXECUTABLES)
 $(call Append_Conditional, TARGET, mqtt-example-at, ATM_ENABLED BUILD_AOS NO_EXECUTABLES)
+$(call Append_Conditional, TARGET, mqtt-example-pool, MQTT_COMM_ENABLED PLATFORM_HAS_DYNMEM, ATM_ENABLED BUILD_AOS NO_EXECUTABLES)
+$(call Append_Conditional, TARGET, mqtt-example-outbox, MQTT_COMM_ENABLED PLATFORM_HAS_DYNMEM, ATM_ENABLED BUILD_AOS NO_EXECUTABLES)
+$(call Append_Conditional, TARGET, mqtt-example-loopback, MQTT_COMM_ENABLED PLATFORM_HAS_DYNMEM _PLATFORM_IS_LINUX_, ATM_ENABLED BUILD_AOS NO_EXECUTABLES)
+$(call Append_Conditional, TARGET, mqtt-example-topic-match, MQTT_COMM_ENABLED PLATFORM_HAS_DYNMEM, ATM_ENABLED BUILD_AOS NO_EXECUTABLES)
+$(call Append_Conditional, TARGET, mqtt-example-wheel, MQTT_COMM_ENABLED MQTT_DEFAULT_IMPL PLATFORM_HAS_DYNMEM, ATM_ENABLED BUILD_AOS NO_EXECUTABLES)
+$(call Append_Conditional, TARGET, mqtt-example-latency, MQTT_COMM_ENABLED PLATFORM_HAS_DYNMEM _PLATFORM_IS_LINUX_, ATM_ENABLED BUILD_AOS NO_EXECUTABLES)
+$(call Append_Conditional, TARGET, mqtt-example-kv, HAL_KV _PLATFORM_IS_LINUX_, ATM_ENABLED BUILD_AOS NO_EXECUTABLES)
 
 DEPENDS         += external_libs/mbedtls
 LDFLAGS         += -liot_sdk -liot_hal -liot_tls
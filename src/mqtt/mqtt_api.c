@@ -74,6 +74,139 @@ typedef struct {
 
 static offline_sub_list_t g_mqtt_offline_subs_list = {0};
 
+#ifdef PLATFORM_HAS_DYNMEM
+/*
+ * A pool is a set of MQTT connections which are used as one client: publishes are spread over the
+ * members by topic, so each member keeps its own send buffer and write lock, while subscriptions are
+ * all held by member 0, so downstream messages are dispatched from one subscription table.
+ */
+typedef struct {
+    int count;
+    void **clients;
+} iotx_mqtt_pool_t;
+
+static iotx_mqtt_pool_t *g_mqtt_pools[CONFIG_MQTT_POOL_MAXNUM] = {0};
+
+/*
+ * guards g_mqtt_pools, created with the first pool and kept after it, as any handle passed
+ * to IOT_MQTT_* is looked up here
+ */
+static void *g_mqtt_pools_mutex = NULL;
+
+/*
+ * HAL offers no static mutex, so constructs racing for the first pool each create one and only
+ * the first one stored is kept. Compilers without these builtins construct the first pool
+ * before other threads call IOT_MQTT_*.
+ */
+#if defined(__GNUC__)
+#define _MQTT_POOL_LOAD_ACQUIRE(ptr)            __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define _MQTT_POOL_CAS(ptr, expected, val)      \
+    __atomic_compare_exchange_n(ptr, expected, val, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+#else
+#define _MQTT_POOL_LOAD_ACQUIRE(ptr)            (*(ptr))
+#define _MQTT_POOL_CAS(ptr, expected, val)      (*(ptr) = (val), 1)
+#endif
+
+static int _mqtt_pool_destroy(iotx_mqtt_pool_t *pool);
+
+static iotx_mqtt_pool_t *_mqtt_pool_find(void *handle)
+{
+    iotx_mqtt_pool_t *pool = NULL;
+    int idx;
+
+    /* no pool was ever constructed */
+    if (_MQTT_POOL_LOAD_ACQUIRE(&g_mqtt_pools_mutex) == NULL) {
+        return NULL;
+    }
+
+    HAL_MutexLock(g_mqtt_pools_mutex);
+    for (idx = 0; idx < CONFIG_MQTT_POOL_MAXNUM; idx++) {
+        if (g_mqtt_pools[idx] != NULL && (void *)g_mqtt_pools[idx] == handle) {
+            pool = g_mqtt_pools[idx];
+            break;
+        }
+    }
+    HAL_MutexUnlock(g_mqtt_pools_mutex);
+
+    return pool;
+}
+
+/* put @pool in a free slot of registry */
+static int _mqtt_pool_register(iotx_mqtt_pool_t *pool)
+{
+    void *mutex = NULL, *expected = NULL;
+    int idx;
+
+    if (_MQTT_POOL_LOAD_ACQUIRE(&g_mqtt_pools_mutex) == NULL) {
+        mutex = HAL_MutexCreate();
+        if (mutex == NULL) {
+            return FAIL_RETURN;
+        }
+        if (!_MQTT_POOL_CAS(&g_mqtt_pools_mutex, &expected, mutex)) {
+            HAL_MutexDestroy(mutex);
+        }
+    }
+
+    HAL_MutexLock(g_mqtt_pools_mutex);
+    for (idx = 0; idx < CONFIG_MQTT_POOL_MAXNUM; idx++) {
+        if (g_mqtt_pools[idx] == NULL) {
+            g_mqtt_pools[idx] = pool;
+            break;
+        }
+    }
+    HAL_MutexUnlock(g_mqtt_pools_mutex);
+
+    return idx < CONFIG_MQTT_POOL_MAXNUM ? SUCCESS_RETURN : FAIL_RETURN;
+}
+
+/* remove pool of @handle from registry, so that only one of concurrent destroys gets it */
+static iotx_mqtt_pool_t *_mqtt_pool_unregister(void *handle)
+{
+    iotx_mqtt_pool_t *pool = NULL;
+    int idx;
+
+    if (_MQTT_POOL_LOAD_ACQUIRE(&g_mqtt_pools_mutex) == NULL) {
+        return NULL;
+    }
+
+    HAL_MutexLock(g_mqtt_pools_mutex);
+    for (idx = 0; idx < CONFIG_MQTT_POOL_MAXNUM; idx++) {
+        if (g_mqtt_pools[idx] != NULL && (void *)g_mqtt_pools[idx] == handle) {
+            pool = g_mqtt_pools[idx];
+            g_mqtt_pools[idx] = NULL;
+            break;
+        }
+    }
+    HAL_MutexUnlock(g_mqtt_pools_mutex);
+
+    return pool;
+}
+
+/* member owning @topic, messages of one topic always go through one connection and keep their order */
+static void *_mqtt_pool_member(void *handle, const char *topic)
+{
+    iotx_mqtt_pool_t *pool = _mqtt_pool_find(handle);
+    uint32_t hash = 5381;
+
+    if (pool == NULL) {
+        return handle;
+    }
+
+    if (topic == NULL) {
+        return pool->clients[0];
+    }
+
+    while (*topic) {
+        hash = ((hash << 5) + hash) + (uint8_t)(*topic++);
+    }
+
+    return pool->clients[hash % pool->count];
+}
+#else
+#define _mqtt_pool_find(handle)             (NULL)
+#define _mqtt_pool_member(handle, topic)    (handle)
+#endif
+
 static int _offline_subs_list_init(void)
 {
     if (g_mqtt_offline_subs_list.init) {
@@ -364,6 +497,79 @@ static int _iotx_preauth(iotx_mqtt_region_types_t region, iotx_dev_meta_info_t *
 }
 #endif /* #ifdef MQTT_PRE_AUTH */
 
+/*
+ * defaults of the connection options which are not identity, overridden by those of @pInitParams
+ * in range, host, port and credentials are left to the caller
+ */
+static void _mqtt_params_fill(iotx_mqtt_param_t *mqtt_params, iotx_mqtt_param_t *pInitParams)
+{
+    memset(mqtt_params, 0x0, sizeof(iotx_mqtt_param_t));
+
+#ifdef SUPPORT_TLS
+    {
+        extern const char *iotx_ca_crt;
+        mqtt_params->pub_key = iotx_ca_crt;
+    }
+#endif
+    mqtt_params->request_timeout_ms    = CONFIG_MQTT_REQUEST_TIMEOUT;
+    mqtt_params->clean_session         = 0;
+    mqtt_params->keepalive_interval_ms = CONFIG_MQTT_KEEPALIVE_INTERVAL * 1000;
+    mqtt_params->read_buf_size         = CONFIG_MQTT_MESSAGE_MAXLEN;
+    mqtt_params->write_buf_size        = CONFIG_MQTT_MESSAGE_MAXLEN;
+    mqtt_params->handle_event.h_fp     = NULL;
+    mqtt_params->handle_event.pcontext = NULL;
+
+    if (pInitParams == NULL) {
+        return;
+    }
+
+    if (pInitParams->request_timeout_ms < CONFIG_MQTT_REQ_TIMEOUT_MIN ||
+        pInitParams->request_timeout_ms > CONFIG_MQTT_REQ_TIMEOUT_MAX) {
+        mqtt_warning("Using default request_timeout_ms: %d, configured value(%d) out of [%d, %d]",
+                     mqtt_params->request_timeout_ms,
+                     pInitParams->request_timeout_ms,
+                     CONFIG_MQTT_REQ_TIMEOUT_MIN,
+                     CONFIG_MQTT_REQ_TIMEOUT_MAX);
+    } else {
+        mqtt_params->request_timeout_ms = pInitParams->request_timeout_ms;
+    }
+
+    if (pInitParams->clean_session == 0 || pInitParams->clean_session == 1) {
+        mqtt_params->clean_session = pInitParams->clean_session;
+    }
+
+    if (pInitParams->keepalive_interval_ms < CONFIG_MQTT_KEEPALIVE_INTERVAL_MIN * 1000 ||
+        pInitParams->keepalive_interval_ms > CONFIG_MQTT_KEEPALIVE_INTERVAL_MAX * 1000) {
+        mqtt_warning("Using default keepalive_interval_ms: %d, configured value(%d) out of [%d, %d]",
+                     mqtt_params->keepalive_interval_ms,
+                     pInitParams->keepalive_interval_ms,
+                     CONFIG_MQTT_KEEPALIVE_INTERVAL_MIN * 1000,
+                     CONFIG_MQTT_KEEPALIVE_INTERVAL_MAX * 1000);
+    } else {
+        mqtt_params->keepalive_interval_ms = pInitParams->keepalive_interval_ms;
+    }
+
+    if (!pInitParams->read_buf_size) {
+        mqtt_warning("Using default read_buf_size: %d", mqtt_params->read_buf_size);
+    } else {
+        mqtt_params->read_buf_size = pInitParams->read_buf_size;
+    }
+
+    if (!pInitParams->write_buf_size) {
+        mqtt_warning("Using default write_buf_size: %d", mqtt_params->write_buf_size);
+    } else {
+        mqtt_params->write_buf_size = pInitParams->write_buf_size;
+    }
+
+    if (pInitParams->handle_event.h_fp != NULL) {
+        mqtt_params->handle_event.h_fp = pInitParams->handle_event.h_fp;
+    }
+
+    if (pInitParams->handle_event.pcontext != NULL) {
+        mqtt_params->handle_event.pcontext = pInitParams->handle_event.pcontext;
+    }
+}
+
 /************************  Public Interface ************************/
 void *IOT_MQTT_Construct(iotx_mqtt_param_t *pInitParams)
 {
@@ -443,21 +649,7 @@ void *IOT_MQTT_Construct(iotx_mqtt_param_t *pInitParams)
 #endif /* #ifdef MQTT_PRE_AUTH */
 
     /* Initialize MQTT parameter */
-    memset(&mqtt_params, 0x0, sizeof(iotx_mqtt_param_t));
-
-#ifdef SUPPORT_TLS
-    {
-        extern const char *iotx_ca_crt;
-        mqtt_params.pub_key = iotx_ca_crt;
-    }
-#endif
-    mqtt_params.request_timeout_ms    = CONFIG_MQTT_REQUEST_TIMEOUT;
-    mqtt_params.clean_session         = 0;
-    mqtt_params.keepalive_interval_ms = CONFIG_MQTT_KEEPALIVE_INTERVAL * 1000;
-    mqtt_params.read_buf_size         = CONFIG_MQTT_MESSAGE_MAXLEN;
-    mqtt_params.write_buf_size        = CONFIG_MQTT_MESSAGE_MAXLEN;
-    mqtt_params.handle_event.h_fp     = NULL;
-    mqtt_params.handle_event.pcontext = NULL;
+    _mqtt_params_fill(&mqtt_params, pInitParams);
 
     /* optional configuration */
     if (pInitParams != NULL) {
@@ -499,52 +691,6 @@ void *IOT_MQTT_Construct(iotx_mqtt_param_t *pInitParams)
 #endif
             mqtt_params.password = g_default_sign.password;
         }
-
-        if (pInitParams->request_timeout_ms < CONFIG_MQTT_REQ_TIMEOUT_MIN ||
-            pInitParams->request_timeout_ms > CONFIG_MQTT_REQ_TIMEOUT_MAX) {
-            mqtt_warning("Using default request_timeout_ms: %d, configured value(%d) out of [%d, %d]",
-                         mqtt_params.request_timeout_ms,
-                         pInitParams->request_timeout_ms,
-                         CONFIG_MQTT_REQ_TIMEOUT_MIN,
-                         CONFIG_MQTT_REQ_TIMEOUT_MAX);
-        } else {
-            mqtt_params.request_timeout_ms = pInitParams->request_timeout_ms;
-        }
-
-        if (pInitParams->clean_session == 0 || pInitParams->clean_session == 1) {
-            mqtt_params.clean_session = pInitParams->clean_session;
-        }
-
-        if (pInitParams->keepalive_interval_ms < CONFIG_MQTT_KEEPALIVE_INTERVAL_MIN * 1000 ||
-            pInitParams->keepalive_interval_ms > CONFIG_MQTT_KEEPALIVE_INTERVAL_MAX * 1000) {
-            mqtt_warning("Using default keepalive_interval_ms: %d, configured value(%d) out of [%d, %d]",
-                         mqtt_params.keepalive_interval_ms,
-                         pInitParams->keepalive_interval_ms,
-                         CONFIG_MQTT_KEEPALIVE_INTERVAL_MIN * 1000,
-                         CONFIG_MQTT_KEEPALIVE_INTERVAL_MAX * 1000);
-        } else {
-            mqtt_params.keepalive_interval_ms = pInitParams->keepalive_interval_ms;
-        }
-
-        if (!pInitParams->read_buf_size) {
-            mqtt_warning("Using default read_buf_size: %d", mqtt_params.read_buf_size);
-        } else {
-            mqtt_params.read_buf_size = pInitParams->read_buf_size;
-        }
-
-        if (!pInitParams->write_buf_size) {
-            mqtt_warning("Using default write_buf_size: %d", mqtt_params.write_buf_size);
-        } else {
-            mqtt_params.write_buf_size = pInitParams->write_buf_size;
-        }
-
-        if (pInitParams->handle_event.h_fp != NULL) {
-            mqtt_params.handle_event.h_fp = pInitParams->handle_event.h_fp;
-        }
-
-        if (pInitParams->handle_event.pcontext != NULL) {
-            mqtt_params.handle_event.pcontext = pInitParams->handle_event.pcontext;
-        }
     } else {
         mqtt_warning("Using default port: [%d]", g_default_sign.port);
         mqtt_params.port = g_default_sign.port;
@@ -611,6 +757,16 @@ int IOT_MQTT_Destroy(void **phandler)
         return NULL_VALUE_ERROR;
     }
 
+#ifdef PLATFORM_HAS_DYNMEM
+    {
+        iotx_mqtt_pool_t *pool = _mqtt_pool_unregister(client);
+
+        if (pool != NULL) {
+            return _mqtt_pool_destroy(pool);
+        }
+    }
+#endif
+
     wrapper_mqtt_release(&client);
     g_mqtt_client = NULL;
 
@@ -620,6 +776,26 @@ int IOT_MQTT_Destroy(void **phandler)
 int IOT_MQTT_Yield(void *handle, int timeout_ms)
 {
     void *pClient = (handle ? handle : g_mqtt_client);
+
+#ifdef PLATFORM_HAS_DYNMEM
+    iotx_mqtt_pool_t *pool = _mqtt_pool_find(pClient);
+
+    if (pool != NULL) {
+        int idx, rc, ret = SUCCESS_RETURN;
+        int slice = timeout_ms / pool->count;
+
+        /* every member has its acks and keepalive to serve, share the time between them */
+        for (idx = 0; idx < pool->count; idx++) {
+            rc = wrapper_mqtt_yield(pool->clients[idx], slice > 0 ? slice : 1);
+            if (rc < 0 && ret == SUCCESS_RETURN) {
+                ret = rc;
+            }
+        }
+
+        return ret;
+    }
+#endif
+
     return wrapper_mqtt_yield(pClient, timeout_ms);
 }
 
@@ -627,21 +803,144 @@ int IOT_MQTT_Yield(void *handle, int timeout_ms)
 int IOT_MQTT_CheckStateNormal(void *handle)
 {
     void *pClient = (handle ? handle : g_mqtt_client);
+#ifdef PLATFORM_HAS_DYNMEM
+    iotx_mqtt_pool_t *pool;
+#endif
+
     if (pClient == NULL) {
         mqtt_err("handler is null");
         return NULL_VALUE_ERROR;
     }
 
+#ifdef PLATFORM_HAS_DYNMEM
+    pool = _mqtt_pool_find(pClient);
+    if (pool != NULL) {
+        int idx;
+
+        for (idx = 0; idx < pool->count; idx++) {
+            if (!wrapper_mqtt_check_state(pool->clients[idx])) {
+                return 0;
+            }
+        }
+
+        return 1;
+    }
+#endif
+
     return wrapper_mqtt_check_state(pClient);
 }
 
+#ifdef PLATFORM_HAS_DYNMEM
+/* release members of @pool, which is no longer in registry */
+static int _mqtt_pool_destroy(iotx_mqtt_pool_t *pool)
+{
+    int idx;
+
+    for (idx = 0; idx < pool->count; idx++) {
+        if (pool->clients[idx] != NULL) {
+            wrapper_mqtt_release(&pool->clients[idx]);
+        }
+    }
+
+    mqtt_api_free(pool->clients);
+    mqtt_api_free(pool);
+
+    return SUCCESS_RETURN;
+}
+
+void *IOT_MQTT_Pool_Construct(iotx_mqtt_param_t *params, int count)
+{
+    iotx_mqtt_pool_t *pool = NULL;
+    iotx_mqtt_param_t member;
+    int idx, ret;
+
+    if (params == NULL || count <= 0) {
+        mqtt_err("params err");
+        return NULL;
+    }
+
+    for (idx = 0; idx < count; idx++) {
+        if (params[idx].host == NULL || params[idx].client_id == NULL ||
+            params[idx].username == NULL || params[idx].password == NULL) {
+            mqtt_err("pool member %d lacks host or credentials", idx);
+            return NULL;
+        }
+    }
+
+    pool = mqtt_api_malloc(sizeof(iotx_mqtt_pool_t));
+    if (pool == NULL) {
+        return NULL;
+    }
+    memset(pool, 0, sizeof(iotx_mqtt_pool_t));
+
+    pool->clients = mqtt_api_malloc(count * sizeof(void *));
+    if (pool->clients == NULL) {
+        mqtt_api_free(pool);
+        return NULL;
+    }
+    memset(pool->clients, 0, count * sizeof(void *));
+    pool->count = count;
+
+    /* slot is taken before connecting, concurrent constructs cannot pass the limit */
+    if (_mqtt_pool_register(pool) != SUCCESS_RETURN) {
+        mqtt_err("Too many MQTT pools, max %d", CONFIG_MQTT_POOL_MAXNUM);
+        mqtt_api_free(pool->clients);
+        mqtt_api_free(pool);
+        return NULL;
+    }
+
+    for (idx = 0; idx < count; idx++) {
+        _mqtt_params_fill(&member, &params[idx]);
+        member.host = params[idx].host;
+        member.port = params[idx].port;
+        member.client_id = params[idx].client_id;
+        member.username = params[idx].username;
+        member.password = params[idx].password;
+        if (params[idx].pub_key != NULL) {
+            member.pub_key = params[idx].pub_key;
+        }
+
+        pool->clients[idx] = wrapper_mqtt_init(&member);
+        if (pool->clients[idx] == NULL) {
+            mqtt_err("wrapper_mqtt_init of pool member %d error", idx);
+            _mqtt_pool_unregister(pool);
+            _mqtt_pool_destroy(pool);
+            return NULL;
+        }
+
+        ret = wrapper_mqtt_connect(pool->clients[idx]);
+        if (SUCCESS_RETURN != ret && MQTT_CONNECT_BLOCK != ret) {
+            mqtt_err("wrapper_mqtt_connect of pool member %d failed", idx);
+            _mqtt_pool_unregister(pool);
+            _mqtt_pool_destroy(pool);
+            return NULL;
+        }
+    }
+
+    mqtt_info("MQTT pool of %d connections constructed", count);
+
+    return pool;
+}
+
+void *IOT_MQTT_Pool_Member(void *handle, int index)
+{
+    iotx_mqtt_pool_t *pool = _mqtt_pool_find(handle);
+
+    if (pool == NULL || index < 0 || index >= pool->count) {
+        return NULL;
+    }
+
+    return pool->clients[index];
+}
+#endif /* #ifdef PLATFORM_HAS_DYNMEM */
+
 int IOT_MQTT_Subscribe(void *handle,
                        const char *topic_filter,
                        iotx_mqtt_qos_t qos,
                        iotx_mqtt_event_handle_func_fpt topic_handle_func,
                        void *pcontext)
 {
-    void *client = handle ? handle : g_mqtt_client;
+    void *client = handle ? _mqtt_pool_member(handle, NULL) : g_mqtt_client;
 
     if (client == NULL) { /* do offline subscribe */
         return iotx_mqtt_offline_subscribe(topic_filter, qos, topic_handle_func, pcontext);
@@ -679,7 +978,7 @@ int IOT_MQTT_Subscribe_Sync(void *handle,
                             void *pcontext,
                             int timeout_ms)
 {
-    void *client = handle ? handle : g_mqtt_client;
+    void *client = handle ? _mqtt_pool_member(handle, NULL) : g_mqtt_client;
 
     if (client == NULL) { /* do offline subscribe */
         return iotx_mqtt_offline_subscribe(topic_filter, qos, topic_handle_func, pcontext);
@@ -714,7 +1013,7 @@ int IOT_MQTT_Subscribe_Sync(void *handle,
 
 int IOT_MQTT_Unsubscribe(void *handle, const char *topic_filter)
 {
-    void *client = handle ? handle : g_mqtt_client;
+    void *client = handle ? _mqtt_pool_member(handle, NULL) : g_mqtt_client;
 
 
     if (client == NULL || topic_filter == NULL || strlen(topic_filter) == 0) {
@@ -727,7 +1026,7 @@ int IOT_MQTT_Unsubscribe(void *handle, const char *topic_filter)
 
 int IOT_MQTT_Publish(void *handle, const char *topic_name, iotx_mqtt_topic_info_pt topic_msg)
 {
-    void *client = handle ? handle : g_mqtt_client;
+    void *client = handle ? _mqtt_pool_member(handle, topic_name) : g_mqtt_client;
     int                 rc = -1;
 
     if (client == NULL || topic_name == NULL || strlen(topic_name) == 0) {
@@ -742,7 +1041,7 @@ int IOT_MQTT_Publish(void *handle, const char *topic_name, iotx_mqtt_topic_info_
 int IOT_MQTT_Publish_Simple(void *handle, const char *topic_name, int qos, void *data, int len)
 {
     iotx_mqtt_topic_info_t mqtt_msg;
-    void *client = handle ? handle : g_mqtt_client;
+    void *client = handle ? _mqtt_pool_member(handle, topic_name) : g_mqtt_client;
     int rc = -1;
 
     if (client == NULL || topic_name == NULL || strlen(topic_name) == 0) {
@@ -760,6 +1059,10 @@ int IOT_MQTT_Publish_Simple(void *handle, const char *topic_name, int qos, void
 
     rc = wrapper_mqtt_publish(client, topic_name, &mqtt_msg);
 
+    if (rc == MQTT_PUBLISH_WOULD_BLOCK) {
+        /* a full inflight window is flow control, not a failure */
+        return rc;
+    }
     if (rc < 0) {
         mqtt_err("IOT_MQTT_Publish failed\n");
         return -1;
@@ -768,10 +1071,153 @@ int IOT_MQTT_Publish_Simple(void *handle, const char *topic_name, int qos, void
     return rc;
 }
 
+void *IOT_MQTT_Buf_Alloc(void *handle, const char *topic_name, int payload_len)
+{
+    void *client = handle ? _mqtt_pool_member(handle, topic_name) : g_mqtt_client;
+
+    if (client == NULL || topic_name == NULL || strlen(topic_name) == 0 || payload_len < 0) {
+        mqtt_err("params err");
+        return NULL;
+    }
+
+    return wrapper_mqtt_buf_alloc(client, strlen(topic_name), payload_len);
+}
+
+void *IOT_MQTT_Buf_Payload(void *buf)
+{
+    return wrapper_mqtt_buf_payload(buf);
+}
+
+void IOT_MQTT_Buf_Release(void *buf)
+{
+    wrapper_mqtt_buf_release(buf);
+}
+
+int IOT_MQTT_Publish_Buf(void *handle, const char *topic_name, int qos, void *buf, int len)
+{
+    iotx_mqtt_topic_info_t mqtt_msg;
+    void *client = handle ? _mqtt_pool_member(handle, topic_name) : g_mqtt_client;
+    int rc = -1;
+
+    if (client == NULL || topic_name == NULL || strlen(topic_name) == 0 || buf == NULL || len < 0) {
+        mqtt_err("params err");
+        wrapper_mqtt_buf_release(buf);
+        return NULL_VALUE_ERROR;
+    }
+
+    memset(&mqtt_msg, 0x0, sizeof(iotx_mqtt_topic_info_t));
+
+    mqtt_msg.qos         = qos;
+    mqtt_msg.retain      = 0;
+    mqtt_msg.dup         = 0;
+    mqtt_msg.payload_len = len;
+
+    rc = wrapper_mqtt_publish_buf(client, topic_name, &mqtt_msg, buf);
+
+    if (rc == MQTT_PUBLISH_WOULD_BLOCK) {
+        /* a full inflight window is flow control, not a failure */
+        return rc;
+    }
+    if (rc < 0) {
+        mqtt_err("IOT_MQTT_Publish_Buf failed\n");
+        return -1;
+    }
+
+    return rc;
+}
+
+int IOT_MQTT_Get_Inflight_Stats(void *handle, iotx_mqtt_inflight_stats_t *stats)
+{
+    void *client = handle ? _mqtt_pool_member(handle, NULL) : g_mqtt_client;
+
+    if (client == NULL || stats == NULL) {
+        mqtt_err("params err");
+        return NULL_VALUE_ERROR;
+    }
+
+    return wrapper_mqtt_inflight_stats(client, stats);
+}
+
+int IOT_MQTT_Outbox_Open(void *handle, const char *name, int max_msgs)
+{
+    void *pClient = (handle ? handle : g_mqtt_client);
+#ifdef PLATFORM_HAS_DYNMEM
+    iotx_mqtt_pool_t *pool;
+#endif
+
+    if (pClient == NULL || name == NULL) {
+        mqtt_err("params err");
+        return NULL_VALUE_ERROR;
+    }
+
+#ifdef PLATFORM_HAS_DYNMEM
+    pool = _mqtt_pool_find(pClient);
+    if (pool != NULL) {
+        int idx, rc;
+        char member_name[40];
+
+        /* members publish different topics, each keeps its own queue */
+        for (idx = 0; idx < pool->count; idx++) {
+            HAL_Snprintf(member_name, sizeof(member_name), "%s%d", name, idx);
+            rc = wrapper_mqtt_outbox_open(pool->clients[idx], member_name, max_msgs);
+            if (rc < 0) {
+                return rc;
+            }
+        }
+
+        return SUCCESS_RETURN;
+    }
+#endif
+
+    return wrapper_mqtt_outbox_open(pClient, name, max_msgs);
+}
+
+int IOT_MQTT_Get_Outbox_Stats(void *handle, iotx_mqtt_outbox_stats_t *stats)
+{
+    void *pClient = (handle ? handle : g_mqtt_client);
+#ifdef PLATFORM_HAS_DYNMEM
+    iotx_mqtt_pool_t *pool;
+#endif
+
+    if (pClient == NULL || stats == NULL) {
+        mqtt_err("params err");
+        return NULL_VALUE_ERROR;
+    }
+
+#ifdef PLATFORM_HAS_DYNMEM
+    pool = _mqtt_pool_find(pClient);
+    if (pool != NULL) {
+        int idx, rc;
+        iotx_mqtt_outbox_stats_t member;
+
+        memset(stats, 0, sizeof(iotx_mqtt_outbox_stats_t));
+        for (idx = 0; idx < pool->count; idx++) {
+            rc = wrapper_mqtt_outbox_stats(pool->clients[idx], &member);
+            if (rc < 0) {
+                return rc;
+            }
+            stats->stored += member.stored;
+            stats->inflight += member.inflight;
+            stats->queued += member.queued;
+            stats->drained += member.drained;
+            stats->dropped += member.dropped;
+            stats->last_drain_msgs += member.last_drain_msgs;
+            if (member.last_drain_ms > stats->last_drain_ms) {
+                stats->last_drain_ms = member.last_drain_ms;
+            }
+        }
+
+        return SUCCESS_RETURN;
+    }
+#endif
+
+    return wrapper_mqtt_outbox_stats(pClient, stats);
+}
+
 int IOT_MQTT_Nwk_Event_Handler(void *handle, iotx_mqtt_nwk_event_t event, iotx_mqtt_nwk_param_t *param)
 {
 #ifdef ASYNC_PROTOCOL_STACK
-    void *client = handle ? handle : g_mqtt_client;
+    void *client = handle ? _mqtt_pool_member(handle, NULL) : g_mqtt_client;
     int rc = -1;
 
     if (client == NULL || event >= IOTX_MQTT_SOC_MAX || param == NULL) {
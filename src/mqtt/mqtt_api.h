@@ -80,6 +80,31 @@ typedef struct {
 } iotx_mqtt_topic_info_t, *iotx_mqtt_topic_info_pt;
 
 
+/* QoS1 inflight window and PUBACK round trip counters of MQTT client */
+typedef struct {
+    uint32_t        window;             /* current limit of QoS1 publishes waiting for PUBACK */
+    uint32_t        inflight;           /* QoS1 publishes waiting for PUBACK */
+    uint32_t        inflight_peak;      /* highest @inflight seen */
+    uint32_t        acked;              /* PUBACKs received */
+    uint32_t        would_block;        /* publishes refused with MQTT_PUBLISH_WOULD_BLOCK */
+    uint32_t        republished;        /* publishes resent as PUBACK did not arrive in time */
+    uint32_t        rtt_samples;        /* PUBACKs of publishes sent only once, which the RTT is taken from */
+    uint32_t        rtt_last_ms;
+    uint32_t        rtt_min_ms;
+    uint32_t        rtt_srtt_ms;        /* smoothed RTT */
+} iotx_mqtt_inflight_stats_t;
+
+/* counters of persistent outbox of MQTT client */
+typedef struct {
+    uint32_t        stored;             /* messages in outbox, including those waiting for PUBACK */
+    uint32_t        inflight;           /* messages sent from outbox and waiting for PUBACK */
+    uint32_t        queued;             /* messages put into outbox */
+    uint32_t        drained;            /* messages sent from outbox */
+    uint32_t        dropped;            /* messages dropped or refused as outbox is full */
+    uint32_t        last_drain_msgs;    /* messages sent by last run which emptied outbox */
+    uint32_t        last_drain_ms;      /* time taken by that run */
+} iotx_mqtt_outbox_stats_t;
+
 typedef struct {
 
     /* Specify the event type */
@@ -296,6 +321,8 @@ int IOT_MQTT_Unsubscribe(void *handle, const char *topic_filter);
  * @param [in] topic_msg: specify the topic message.
  *
  * @retval -1 :  Publish failed.
+ * @retval MQTT_PUBLISH_WOULD_BLOCK : QoS1 inflight window is full, retry after yielding for some PUBACK.
+ *                                     Only with PLATFORM_HAS_DYNMEM, a full static list fails as other errors.
  * @retval  0 :  Publish successful, where QoS is 0.
  * @retval >0 :  Publish successful, where QoS is >= 0.
         The value is a unique ID of this request.
@@ -313,6 +340,8 @@ int IOT_MQTT_Publish(void *handle, const char *topic_name, iotx_mqtt_topic_info_
  * @param [in] len: specify the topic message payload len.
  *
  * @retval -1 :  Publish failed.
+ * @retval MQTT_PUBLISH_WOULD_BLOCK : QoS1 inflight window is full, retry after yielding for some PUBACK.
+ *                                     Only with PLATFORM_HAS_DYNMEM, a full static list fails as other errors.
  * @retval  0 :  Publish successful, where QoS is 0.
  * @retval >0 :  Publish successful, where QoS is >= 0.
         The value is a unique ID of this request.
@@ -320,6 +349,129 @@ int IOT_MQTT_Publish(void *handle, const char *topic_name, iotx_mqtt_topic_info_
  * @see None.
  */
 int IOT_MQTT_Publish_Simple(void *handle, const char *topic_name, int qos, void *data, int len);
+
+/**
+ * @brief Allocate a reference counted buffer for IOT_MQTT_Publish_Buf(), with room reserved in front of
+ *        the payload for MQTT header and topic, so the payload is never copied, neither for sending nor
+ *        for keeping a QoS1 message until it is acked.
+ *
+ * @param [in] handle: specify the MQTT client.
+ * @param [in] topic_name: topic the buffer will be published to, a topic of the same length will do.
+ * @param [in] payload_len: capacity of payload in byte.
+ *
+ * @retval     NULL : Allocate failed.
+ * @retval NOT_NULL : The buffer, fill its payload got by IOT_MQTT_Buf_Payload().
+ * @see None.
+ */
+void *IOT_MQTT_Buf_Alloc(void *handle, const char *topic_name, int payload_len);
+
+/**
+ * @brief Get payload area of buffer allocated by IOT_MQTT_Buf_Alloc().
+ *
+ * @param [in] buf: specify the buffer.
+ *
+ * @return pointer to payload.
+ * @see None.
+ */
+void *IOT_MQTT_Buf_Payload(void *buf);
+
+/**
+ * @brief Release buffer allocated by IOT_MQTT_Buf_Alloc() which is not going to be published.
+ *
+ * @param [in] buf: specify the buffer.
+ *
+ * @return none.
+ * @see None.
+ */
+void IOT_MQTT_Buf_Release(void *buf);
+
+/**
+ * @brief Publish payload of buffer allocated by IOT_MQTT_Buf_Alloc() without copying it.
+ *        The buffer is handed over whatever the result, do not touch or release it afterwards.
+ *
+ * @param [in] handle: specify the MQTT client.
+ * @param [in] topic_name: specify the topic name.
+ * @param [in] qos: specify the MQTT Requested QoS.
+ * @param [in] buf: specify the buffer.
+ * @param [in] len: specify the payload len.
+ *
+ * @retval -1 :  Publish failed.
+ * @retval  0 :  Publish successful, where QoS is 0.
+ * @retval >0 :  Publish successful, where QoS is >= 0.
+        The value is a unique ID of this request.
+        The ID will be passed back when callback 'iotx_mqtt_param_t:handle_event'.
+ * @see None.
+ */
+int IOT_MQTT_Publish_Buf(void *handle, const char *topic_name, int qos, void *buf, int len);
+
+/**
+ * @brief Get counters of QoS1 inflight window and PUBACK round trip, e.g. to size the window of a deployment.
+ *
+ * @param [in] handle: specify the MQTT client.
+ * @param [out] stats: the counters.
+ *
+ * @retval  0 : Success.
+ * @retval -1 : Failed, or not supported by MQTT implementation.
+ * @see None.
+ */
+int IOT_MQTT_Get_Inflight_Stats(void *handle, iotx_mqtt_inflight_stats_t *stats);
+
+/**
+ * @brief Open persistent outbox of MQTT client. While the connection is down, or outbox still has messages,
+ *        publishes are stored in HAL_Kv_XXX() and return as successful, they are sent in order once connected
+ *        and QoS1 ones stay stored until PUBACK. Messages left by previous run are sent again with their
+ *        packet id. Only available when WITH_MQTT_OUTBOX is set, for a pool each connection gets an outbox
+ *        named @name followed by its position.
+ *
+ * @param [in] handle: specify the MQTT client.
+ * @param [in] name: name of outbox, which prefixes its keys in HAL_Kv_XXX(), at most 31 characters.
+ * @param [in] max_msgs: messages kept at most, 0 for IOTX_MC_OUTBOX_MSGS_DEFAULT.
+ *
+ * @retval  0 : Success.
+ * @retval -1 : Failed, or not supported by MQTT implementation.
+ * @see None.
+ */
+int IOT_MQTT_Outbox_Open(void *handle, const char *name, int max_msgs);
+
+/**
+ * @brief Get counters of persistent outbox, summed over connections of a pool.
+ *
+ * @param [in] handle: specify the MQTT client.
+ * @param [out] stats: the counters.
+ *
+ * @retval  0 : Success.
+ * @retval -1 : Failed, outbox is not open.
+ * @see None.
+ */
+int IOT_MQTT_Get_Outbox_Stats(void *handle, iotx_mqtt_outbox_stats_t *stats);
+
+/**
+ * @brief Construct a pool of MQTT connections which is used through the same IOT_MQTT_XXX() functions as one client.
+ *        Publishes are spread over the connections by topic name, messages of one topic always take the same
+ *        connection, and subscriptions are all made on the first connection. Every member is a separate
+ *        MQTT session, so each of @params must carry its own host, client_id, username and password.
+ *        Only available when PLATFORM_HAS_DYNMEM is set.
+ *
+ * @param [in] params: array of @count member parameters.
+ * @param [in] count: number of connections.
+ *
+ * @retval     NULL : Construct failed.
+ * @retval NOT_NULL : The handle of MQTT pool, release it with IOT_MQTT_Destroy().
+ * @see None.
+ */
+void *IOT_MQTT_Pool_Construct(iotx_mqtt_param_t *params, int count);
+
+/**
+ * @brief Get one connection of MQTT pool, e.g. to yield each connection from its own thread.
+ *
+ * @param [in] handle: specify the MQTT pool.
+ * @param [in] index: position of connection in pool.
+ *
+ * @retval     NULL : @handle is not a pool or @index is out of range.
+ * @retval NOT_NULL : The handle of MQTT client, owned by pool.
+ * @see None.
+ */
+void *IOT_MQTT_Pool_Member(void *handle, int index);
 /* From mqtt_client.h */
 /** @} */ /* end of api_mqtt */
 
@@ -363,6 +515,11 @@ int IOT_MQTT_Nwk_Event_Handler(void *handle, iotx_mqtt_nwk_event_t event, iotx_m
 #define CONFIG_MQTT_OFFLINE_TOPIC_MAXNUM        (5)
 #endif
 
+/* Maximum number of MQTT pools living at the same time */
+#ifndef CONFIG_MQTT_POOL_MAXNUM
+#define CONFIG_MQTT_POOL_MAXNUM                 (4)
+#endif
+
 /* Default timeout interval of MQTT request in millisecond */
 #define CONFIG_MQTT_REQUEST_TIMEOUT             (2000)
 
@@ -24,9 +24,11 @@ int HAL_GetFirmwareVersion(char *version);
 #ifdef DYNAMIC_REGISTER
 int HAL_SetDeviceSecret(char *device_secret);
 int HAL_GetProductSecret(char product_secret[IOTX_PRODUCT_SECRET_LEN + 1]);
+#endif
+
 int HAL_Kv_Set(const char *key, const void *val, int len, int sync);
 int HAL_Kv_Get(const char *key, void *val, int *buffer_len);
-#endif
+int HAL_Kv_Del(const char *key);
 
 #ifdef SUPPORT_TLS
     uintptr_t HAL_SSL_Establish(const char *host, uint16_t port, const char *ca_crt, uint32_t ca_crt_len);
@@ -59,6 +61,13 @@ int wrapper_mqtt_subscribe_sync(void *client,
                                 int timeout_ms);
 int wrapper_mqtt_unsubscribe(void *client, const char *topicFilter);
 int wrapper_mqtt_publish(void *client, const char *topicName, iotx_mqtt_topic_info_pt topic_msg);
+void *wrapper_mqtt_buf_alloc(void *client, int topic_len, int payload_len);
+void *wrapper_mqtt_buf_payload(void *buf);
+void wrapper_mqtt_buf_release(void *buf);
+int wrapper_mqtt_publish_buf(void *client, const char *topicName, iotx_mqtt_topic_info_pt topic_msg, void *buf);
+int wrapper_mqtt_inflight_stats(void *client, iotx_mqtt_inflight_stats_t *stats);
+int wrapper_mqtt_outbox_open(void *client, const char *name, int max_msgs);
+int wrapper_mqtt_outbox_stats(void *client, iotx_mqtt_outbox_stats_t *stats);
 int wrapper_mqtt_release(void **pclient);
 int wrapper_mqtt_nwk_event_handler(void *client, iotx_mqtt_nwk_event_t event, iotx_mqtt_nwk_param_t *param);
 
@@ -0,0 +1,403 @@
+/*
+ * Copyright (C) 2015-2018 Alibaba Group Holding Limited
+ */
+
+/*
+ * Interrupted OTA downloads against local stand-ins of the cloud: the stub broker of
+ * src/mqtt/examples/mqtt_example_broker.c answers the version report with an upgrade message,
+ * and an HTTP server in this file serves the image but drops every connection after a set number
+ * of body bytes, answering "Range: bytes=<offset>-" with 206 Partial Content.
+ *
+ * Two downloads are made. The first one resumes after each dropped connection by itself. The
+ * second one stands for a device restarted halfway: the first half of the image, as if persisted
+ * by the earlier attempt, is fed back with IOT_OTAG_RESUME_FETCH before fetching the rest. Each
+ * is checked to be byte for byte the image, of its length, and to pass IOT_OTAG_CHECK_FIRMWARE.
+ *
+ * Without TLS the fetch channel connects to port 80, whatever the URL says, so the HTTP server
+ * listens on 127.0.0.1:80, which needs the privilege to bind it.
+ *
+ * usage: ota-example-resume [size] [drop]
+ *     size     bytes of image, 1048576 by default
+ *     drop     body bytes sent on a connection before it is dropped, 262144 by default
+ */
+
+#define _XOPEN_SOURCE 600
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "infra_types.h"
+#include "infra_defs.h"
+#include "infra_md5.h"
+#include "wrappers_defs.h"
+#include "mqtt_api.h"
+#include "ota_api.h"
+#include "mqtt_example_broker.h"
+
+#define EXAMPLE_PRODUCT_KEY     "a1example"
+#define EXAMPLE_DEVICE_NAME     "example1"
+#define EXAMPLE_HTTP_PORT       80
+#define EXAMPLE_URL             "http://127.0.0.1/example.bin"
+#define EXAMPLE_BUF_LEN         4096
+#define EXAMPLE_REQUEST_MAXLEN  2048
+#define EXAMPLE_MSG_MAXLEN      512
+#define EXAMPLE_TIMEOUT_MS      60000
+
+void HAL_Printf(const char *fmt, ...);
+int HAL_Snprintf(char *str, const int len, const char *fmt, ...);
+void HAL_SleepMs(uint32_t ms);
+uint64_t HAL_UptimeMs(void);
+void *HAL_Malloc(uint32_t size);
+void HAL_Free(void *ptr);
+int HAL_ThreadCreate(void **thread_handle, void *(*work_routine)(void *), void *arg,
+                     hal_os_thread_param_t *hal_os_thread_param, int *stack_used);
+void HAL_ThreadDetach(void *thread_handle);
+
+typedef struct {
+    int listen_fd;
+    int stopping;
+    int running;
+    uint32_t drop;              /* body bytes sent before a connection is dropped */
+    uint32_t requests;
+    uint32_t ranged;            /* requests with a Range header */
+    uint32_t dropped;           /* connections dropped before body was complete */
+    int64_t first_offset;       /* offset asked by first request since reset, -1 if none */
+} example_http_t;
+
+static unsigned char *g_image = NULL;
+static uint32_t g_image_len = 1048576;
+static char g_image_md5[33];
+static example_http_t g_http;
+
+static int example_send_all(int fd, const void *data, uint32_t len)
+{
+    const char *p = data;
+    ssize_t sent;
+
+    while (len > 0) {
+        sent = send(fd, p, len, MSG_NOSIGNAL);
+        if (sent <= 0) {
+            return -1;
+        }
+        p += sent;
+        len -= sent;
+    }
+    return 0;
+}
+
+/* answer one GET on @fd, then close it, early if more than drop bytes of body are left */
+static void example_http_serve(example_http_t *http, int fd)
+{
+    char request[EXAMPLE_REQUEST_MAXLEN + 1], header[256];
+    const char *range = NULL;
+    uint32_t offset = 0, len, request_len = 0;
+    ssize_t ret;
+
+    request[0] = '\0';
+    while (strstr(request, "\r\n\r\n") == NULL) {
+        if (request_len >= EXAMPLE_REQUEST_MAXLEN) {
+            close(fd);
+            return;
+        }
+        ret = recv(fd, request + request_len, EXAMPLE_REQUEST_MAXLEN - request_len, 0);
+        if (ret <= 0) {
+            close(fd);
+            return;
+        }
+        request_len += ret;
+        request[request_len] = '\0';
+    }
+
+    range = strstr(request, "Range: bytes=");
+    if (range != NULL) {
+        offset = strtoul(range + strlen("Range: bytes="), NULL, 10);
+        http->ranged++;
+    }
+    if (http->first_offset < 0) {
+        http->first_offset = offset;
+    }
+    http->requests++;
+
+    if (offset >= g_image_len) {
+        HAL_Snprintf(header, sizeof(header), "HTTP/1.1 416 Range Not Satisfiable\r\nContent-Length: 0\r\n"
+                     "Connection: close\r\n\r\n");
+        example_send_all(fd, header, strlen(header));
+        close(fd);
+        return;
+    }
+
+    len = g_image_len - offset;
+    if (range != NULL) {
+        HAL_Snprintf(header, sizeof(header), "HTTP/1.1 206 Partial Content\r\nContent-Length: %u\r\n"
+                     "Content-Range: bytes %u-%u/%u\r\nConnection: close\r\n\r\n",
+                     (unsigned int)len, (unsigned int)offset, (unsigned int)(g_image_len - 1),
+                     (unsigned int)g_image_len);
+    } else {
+        HAL_Snprintf(header, sizeof(header), "HTTP/1.1 200 OK\r\nContent-Length: %u\r\nConnection: close\r\n\r\n",
+                     (unsigned int)len);
+    }
+
+    if (len > http->drop) {
+        len = http->drop;
+        http->dropped++;
+    }
+    if (example_send_all(fd, header, strlen(header)) == 0) {
+        example_send_all(fd, g_image + offset, len);
+    }
+    close(fd);
+}
+
+static void *example_http_thread(void *arg)
+{
+    example_http_t *http = arg;
+    int fd;
+
+    while (!http->stopping) {
+        fd = accept(http->listen_fd, NULL, NULL);
+        if (fd < 0) {
+            if (http->stopping) {
+                break;
+            }
+            HAL_SleepMs(10);
+            continue;
+        }
+        example_http_serve(http, fd);
+    }
+    http->running = 0;
+
+    return NULL;
+}
+
+static int example_http_start(example_http_t *http, uint32_t drop)
+{
+    struct sockaddr_in addr;
+    void *thread = NULL;
+    int one = 1;
+
+    memset(http, 0, sizeof(example_http_t));
+    http->drop = drop;
+    http->first_offset = -1;
+    http->listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (http->listen_fd < 0) {
+        return -1;
+    }
+    setsockopt(http->listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(EXAMPLE_HTTP_PORT);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(http->listen_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(http->listen_fd, 4) != 0) {
+        HAL_Printf("http: cannot listen on port %d\n", EXAMPLE_HTTP_PORT);
+        close(http->listen_fd);
+        return -1;
+    }
+
+    http->running = 1;
+    if (HAL_ThreadCreate(&thread, example_http_thread, http, NULL, NULL) != 0) {
+        http->running = 0;
+        close(http->listen_fd);
+        return -1;
+    }
+    HAL_ThreadDetach(thread);
+
+    return 0;
+}
+
+static void example_http_stop(example_http_t *http)
+{
+    http->stopping = 1;
+    shutdown(http->listen_fd, SHUT_RDWR);
+    while (http->running) {
+        HAL_SleepMs(10);
+    }
+    close(http->listen_fd);
+}
+
+/* answer version report of device with an upgrade to the image */
+static void example_broker_cb(example_broker_t *broker, int conn, const char *topic, int topic_len,
+                              const char *payload, int payload_len, void *ctx)
+{
+    char msg[EXAMPLE_MSG_MAXLEN];
+    const char *inform = "/ota/device/inform/";
+
+    if (topic_len < (int)strlen(inform) || memcmp(topic, inform, strlen(inform)) != 0) {
+        return;
+    }
+
+    HAL_Snprintf(msg, sizeof(msg), "{\"code\":\"1000\",\"data\":{\"size\":%u,\"version\":\"2.0\",\"url\":\"%s\","
+                 "\"md5\":\"%s\"},\"id\":1,\"message\":\"success\"}", (unsigned int)g_image_len, EXAMPLE_URL,
+                 g_image_md5);
+    example_broker_publish(broker, conn, "/ota/device/upgrade/" EXAMPLE_PRODUCT_KEY "/" EXAMPLE_DEVICE_NAME, msg,
+                           strlen(msg));
+}
+
+/*
+ * download image once, feeding the first @resume bytes back with IOT_OTAG_RESUME_FETCH,
+ * returns 0 if image arrived whole and intact
+ */
+static int example_download(void *mqtt, uint32_t resume)
+{
+    void *ota = NULL;
+    char *buf = NULL;
+    uint32_t offset = 0, fetched = 0, file_size = 0, valid = 0, len;
+    uint64_t start;
+    int ret, mismatch = 0, res = -1;
+
+    buf = HAL_Malloc(EXAMPLE_BUF_LEN);
+    ota = IOT_OTA_Init(EXAMPLE_PRODUCT_KEY, EXAMPLE_DEVICE_NAME, mqtt);
+    if (buf == NULL || ota == NULL) {
+        HAL_Printf("IOT_OTA_Init failed\n");
+        goto out;
+    }
+    if (IOT_OTA_ReportVersion(ota, "1.0") < 0) {
+        HAL_Printf("IOT_OTA_ReportVersion failed\n");
+        goto out;
+    }
+
+    start = HAL_UptimeMs();
+    while (!IOT_OTA_IsFetching(ota)) {
+        if (HAL_UptimeMs() - start > EXAMPLE_TIMEOUT_MS) {
+            HAL_Printf("no upgrade message\n");
+            goto out;
+        }
+        IOT_MQTT_Yield(mqtt, 50);
+    }
+
+    g_http.requests = g_http.ranged = g_http.dropped = 0;
+    g_http.first_offset = -1;
+    start = HAL_UptimeMs();
+
+    /* data persisted by an earlier attempt goes in first, in order */
+    while (offset < resume) {
+        len = resume - offset < EXAMPLE_BUF_LEN ? resume - offset : EXAMPLE_BUF_LEN;
+        memcpy(buf, g_image + offset, len);
+        if (IOT_OTA_Ioctl(ota, IOT_OTAG_RESUME_FETCH, buf, len) != 0) {
+            HAL_Printf("IOT_OTAG_RESUME_FETCH failed\n");
+            goto out;
+        }
+        offset += len;
+    }
+
+    while (!IOT_OTA_IsFetchFinish(ota)) {
+        if (HAL_UptimeMs() - start > EXAMPLE_TIMEOUT_MS) {
+            HAL_Printf("download timeout\n");
+            goto out;
+        }
+        ret = IOT_OTA_FetchYield(ota, buf, EXAMPLE_BUF_LEN, 5);
+        if (ret < 0) {
+            HAL_Printf("IOT_OTA_FetchYield failed at %u\n", (unsigned int)offset);
+            goto out;
+        }
+        if (offset + ret > g_image_len || memcmp(buf, g_image + offset, ret) != 0) {
+            mismatch++;
+        }
+        offset += ret;
+    }
+
+    IOT_OTA_Ioctl(ota, IOT_OTAG_FETCHED_SIZE, &fetched, 4);
+    IOT_OTA_Ioctl(ota, IOT_OTAG_FILE_SIZE, &file_size, 4);
+    IOT_OTA_Ioctl(ota, IOT_OTAG_CHECK_FIRMWARE, &valid, 4);
+
+    HAL_Printf("%s: %u bytes in %d ms, %u requests, %u ranged, %u dropped, first from %d\n",
+               resume ? "resumed " : "download", (unsigned int)offset, (int)(HAL_UptimeMs() - start),
+               (unsigned int)g_http.requests, (unsigned int)g_http.ranged, (unsigned int)g_http.dropped,
+               (int)g_http.first_offset);
+    HAL_Printf("          length %s, %s, firmware check %s\n",
+               (offset == g_image_len && fetched == g_image_len && file_size == g_image_len) ? "ok" : "WRONG",
+               mismatch ? "bytes DIFFER" : "bytes identical", valid ? "passed" : "FAILED");
+
+    if (offset == g_image_len && fetched == g_image_len && file_size == g_image_len && mismatch == 0 && valid &&
+        g_http.first_offset == (int64_t)resume) {
+        res = 0;
+    }
+
+out:
+    if (ota != NULL) {
+        IOT_OTA_Deinit(ota);
+    }
+    if (buf != NULL) {
+        HAL_Free(buf);
+    }
+
+    return res;
+}
+
+int main(int argc, char *argv[])
+{
+    example_broker_t *broker = NULL;
+    iotx_mqtt_param_t params;
+    void *mqtt = NULL;
+    unsigned char digest[16];
+    uint32_t drop = 262144, seed = 1, idx;
+    int http_started = 0, res = -1;
+
+    if (argc > 1) {
+        g_image_len = strtoul(argv[1], NULL, 10);
+    }
+    if (argc > 2) {
+        drop = strtoul(argv[2], NULL, 10);
+    }
+    if (g_image_len < 2 || drop == 0) {
+        HAL_Printf("usage: %s [size] [drop]\n", argv[0]);
+        return -1;
+    }
+
+    g_image = HAL_Malloc(g_image_len);
+    if (g_image == NULL) {
+        return -1;
+    }
+    for (idx = 0; idx < g_image_len; idx++) {
+        seed = seed * 1103515245 + 12345;
+        g_image[idx] = (unsigned char)(seed >> 16);
+    }
+    utils_md5(g_image, g_image_len, digest);
+    for (idx = 0; idx < 16; idx++) {
+        HAL_Snprintf(g_image_md5 + idx * 2, 3, "%02x", digest[idx]);
+    }
+
+    if (example_http_start(&g_http, drop) != 0) {
+        goto out;
+    }
+    http_started = 1;
+    broker = example_broker_start(0, example_broker_cb, NULL);
+    if (broker == NULL) {
+        goto out;
+    }
+
+    memset(&params, 0, sizeof(params));
+    params.host = "127.0.0.1";
+    params.port = example_broker_port(broker);
+    params.client_id = "example-ota-resume";
+    params.username = "example";
+    params.password = "example";
+    mqtt = IOT_MQTT_Construct(&params);
+    if (mqtt == NULL) {
+        HAL_Printf("IOT_MQTT_Construct failed\n");
+        goto out;
+    }
+
+    if (example_download(mqtt, 0) == 0 && example_download(mqtt, g_image_len / 2) == 0) {
+        res = 0;
+    }
+
+out:
+    if (mqtt != NULL) {
+        IOT_MQTT_Destroy(&mqtt);
+    }
+    if (broker != NULL) {
+        example_broker_stop(broker);
+    }
+    if (http_started) {
+        example_http_stop(&g_http);
+    }
+    HAL_Free(g_image);
+
+    return res;
+}
@@ -1,6 +1,7 @@
 LIBA_TARGET     := libiot_ota.a
 
 HDR_REFS        := src/infra
+HDR_REFS        += src/mqtt
 
 DEPENDS         += wrappers
 LDFLAGS         += -liot_sdk -liot_hal -liot_tls
@@ -9,5 +10,7 @@ LIB_SRCS_PATTERN := *.c
 
 LIB_SRCS_EXCLUDE        += examples/ota_example_mqtt.c
 SRCS_ota-example-mqtt   := examples/ota_example_mqtt.c
+SRCS_ota-example-resume := examples/ota_example_resume.c ../mqtt/examples/mqtt_example_broker.c
 
 $(call Append_Conditional, TARGET, ota-example-mqtt, OTA_ENABLED, BUILD_AOS NO_EXECUTABLES)
+$(call Append_Conditional, TARGET, ota-example-resume, OTA_ENABLED MQTT_COMM_ENABLED PLATFORM_HAS_DYNMEM, SUPPORT_TLS ATM_ENABLED BUILD_AOS NO_EXECUTABLES)
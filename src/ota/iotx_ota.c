@@ -957,6 +957,26 @@ int IOT_OTA_Ioctl(void *handle, IOT_OTA_CmdType_t type, void *buf, int buf_len)
             h_ota->size_fetched = 0;
             return 0;
         }
+        case IOT_OTAG_RESUME_FETCH: {
+            if ((NULL == buf) || (buf_len <= 0) || (IOT_OTAS_FETCHING != h_ota->state) ||
+                (h_ota->size_fetched + buf_len > h_ota->size_file)) {
+                OTA_LOG_ERROR("Invalid parameter");
+                h_ota->err = IOT_OTAE_INVALID_PARAM;
+                return -1;
+            }
+
+            if (0 != ofc_Resume(h_ota->ch_fetch, h_ota->size_fetched + buf_len)) {
+                OTA_LOG_ERROR("fetch is already running");
+                h_ota->err = IOT_OTAE_INVALID_STATE;
+                return -1;
+            }
+
+            /* digest covers the whole file, so data fetched before goes through it as well */
+            otalib_MD5Update(h_ota->md5, buf, buf_len);
+            otalib_Sha256Update(h_ota->sha256, buf, buf_len);
+            h_ota->size_fetched += buf_len;
+            return 0;
+        }
         default:
             OTA_LOG_ERROR("invalid cmd type");
             h_ota->err = IOT_OTAE_INVALID_PARAM;
@@ -9,6 +9,15 @@
     #define OTA_SIGNAL_CHANNEL      (1)
 #endif
 
+/* reconnects with a range request after a fetch fails without any data, before giving up */
+#ifndef OTA_FETCH_RETRY_MAX
+    #define OTA_FETCH_RETRY_MAX             (3)
+#endif
+
+#ifndef OTA_FETCH_RETRY_INTERVAL_MS
+    #define OTA_FETCH_RETRY_INTERVAL_MS     (1000)
+#endif
+
 #endif  /* __IOTX_OTA_CONFIG_H__ */
 
 
@@ -95,6 +95,7 @@ int otalib_GenReportMsg(char *buf, size_t buf_len, uint32_t id, int progress, co
 
 void *ofc_Init(char *url);
 int32_t ofc_Fetch(void *handle, char *buf, uint32_t buf_len, uint32_t timeout_s);
+int ofc_Resume(void *handle, uint32_t offset);
 int ofc_Deinit(void *handle);
 
 #endif /* _IOTX_OTA_INTERNAL_H_ */
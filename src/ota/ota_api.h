@@ -86,7 +86,8 @@ typedef enum {
     IOT_OTAG_VERSION,          /* version in string format */
     IOT_OTAG_CHECK_FIRMWARE,    /* Check firmware is valid or not */
     IOT_OTAG_CHECK_CONFIG,      /* Check config file is valid or not */
-    IOT_OTAG_RESET_FETCHED_SIZE /* reset the size_fetched parameter to be 0 */
+    IOT_OTAG_RESET_FETCHED_SIZE, /* reset the size_fetched parameter to be 0 */
+    IOT_OTAG_RESUME_FETCH       /* feed data fetched before, following fetch continues after it */
 } IOT_OTA_CmdType_t;
 
 /** @defgroup group_api api
@@ -211,6 +212,9 @@ DLL_IOT_API int IOT_OTA_FetchYield(void *handle, char *buf, uint32_t buf_len, ui
       4) When type is IOT_OTAG_VERSION, 'buf' should be a buffer, and 'buf_len' should be OTA_VERSION_LEN_MAX.
       5) When type is IOT_OTAG_CHECK_FIRMWARE, 'buf' should be pointer of uint32_t, and 'buf_len' should be 4.
          0, firmware is invalid; 1, firmware is valid.
+      6) When type is IOT_OTAG_RESUME_FETCH, 'buf' should be firmware data persisted by an interrupted download,
+         and 'buf_len' its length. It can be called several times in order, before the first IOT_OTA_FetchYield()
+         of a new download, then download resumes from the total length with a HTTP range request.
   @endverbatim
  *
  * @retval   0 : Successful.
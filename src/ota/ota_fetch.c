@@ -6,11 +6,17 @@
 
 /* ofc, OTA fetch channel */
 
+#define OFC_HTTP_HEADER         "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8\r\n" \
+                                "Accept-Encoding: gzip, deflate\r\n"
+
 typedef struct {
 
     const char *url;
     httpclient_t http;              /* http client */
     httpclient_data_t http_data;    /* http client data */
+    uint32_t offset;                /* bytes handed to caller so far, where a new request resumes */
+    int ranged;                     /* current request asks for a range, expects 206 */
+    char header[sizeof(OFC_HTTP_HEADER) + 32];
 
 } otahttp_Struct_t, *otahttp_Struct_pt;
 
@@ -22,6 +28,23 @@ extern int httpclient_common(httpclient_t *client,
                              uint32_t timeout_ms,
                              httpclient_data_t *client_data);
 
+/* drop current request, the next fetch sends a new one starting from h_odc->offset */
+static void ofc_RangeRequest(otahttp_Struct_pt h_odc)
+{
+    httpclient_close(&h_odc->http);
+    memset(&h_odc->http_data, 0, sizeof(httpclient_data_t));
+
+    if (h_odc->offset > 0) {
+        OTA_SNPRINTF(h_odc->header, sizeof(h_odc->header), "%sRange: bytes=%u-\r\n", OFC_HTTP_HEADER,
+                     (unsigned int)h_odc->offset);
+        h_odc->ranged = 1;
+    } else {
+        OTA_SNPRINTF(h_odc->header, sizeof(h_odc->header), "%s", OFC_HTTP_HEADER);
+        h_odc->ranged = 0;
+    }
+    h_odc->http.header = h_odc->header;
+}
+
 void *ofc_Init(char *url)
 {
     otahttp_Struct_pt h_odc;
@@ -34,8 +57,7 @@ void *ofc_Init(char *url)
     memset(h_odc, 0, sizeof(otahttp_Struct_t));
 
     /* set http request-header parameter */
-    h_odc->http.header = "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8\r\n" \
-                         "Accept-Encoding: gzip, deflate\r\n";
+    ofc_RangeRequest(h_odc);
 #if defined(SUPPORT_ITLS)
     char *s_ptr = strstr(url, "://");
     if (strlen("https") == (s_ptr - url) && (0 == strncmp(url, "https", strlen("https")))) {
@@ -54,24 +76,70 @@ extern const char *iotx_ca_crt;
 int32_t ofc_Fetch(void *handle, char *buf, uint32_t buf_len, uint32_t timeout_s)
 {
     int                 diff;
+    int                 ret;
+    int                 fetched;
+    int                 retry = 0;
     otahttp_Struct_pt   h_odc = (otahttp_Struct_pt)handle;
 
-    h_odc->http_data.response_buf = buf;
-    h_odc->http_data.response_buf_len = buf_len;
-    diff = h_odc->http_data.response_content_len - h_odc->http_data.retrieve_len;
+    while (1) {
+        h_odc->http_data.response_buf = buf;
+        h_odc->http_data.response_buf_len = buf_len;
+        diff = h_odc->http_data.response_content_len - h_odc->http_data.retrieve_len;
 
 #if !defined(SUPPORT_TLS)
-    if (0 != httpclient_common(&h_odc->http, h_odc->url, 80, 0, HTTPCLIENT_GET, timeout_s * 1000,
-                               &h_odc->http_data)) {
+        ret = httpclient_common(&h_odc->http, h_odc->url, 80, 0, HTTPCLIENT_GET, timeout_s * 1000,
+                                &h_odc->http_data);
 #else
-    if (0 != httpclient_common(&h_odc->http, h_odc->url, 443, iotx_ca_crt, HTTPCLIENT_GET, timeout_s * 1000,
-                               &h_odc->http_data)) {
+        ret = httpclient_common(&h_odc->http, h_odc->url, 443, iotx_ca_crt, HTTPCLIENT_GET, timeout_s * 1000,
+                                &h_odc->http_data);
 #endif
-        OTA_LOG_ERROR("fetch firmware failed");
+        fetched = h_odc->http_data.response_content_len - h_odc->http_data.retrieve_len - diff;
+
+        if (0 == ret && h_odc->ranged && 206 != h_odc->http.response_code) {
+            /* server ignored range, data would be misplaced */
+            OTA_LOG_ERROR("range request not supported, code = %d", h_odc->http.response_code);
+            httpclient_close(&h_odc->http);
+            return -1;
+        }
+
+        if (fetched > 0) {
+            h_odc->offset += fetched;
+        }
+
+        if (0 == ret) {
+            return fetched;
+        }
+
+        /* hand out what arrived before the connection broke, resume after it at next fetch */
+        ofc_RangeRequest(h_odc);
+        if (fetched > 0) {
+            OTA_LOG_WRN("fetch interrupted, resume from %u", (unsigned int)h_odc->offset);
+            return fetched;
+        }
+
+        if (++retry > OTA_FETCH_RETRY_MAX) {
+            OTA_LOG_ERROR("fetch firmware failed");
+            return -1;
+        }
+        OTA_LOG_WRN("fetch failed, retry %d from %u", retry, (unsigned int)h_odc->offset);
+        HAL_SleepMs(OTA_FETCH_RETRY_INTERVAL_MS);
+    }
+}
+
+
+int ofc_Resume(void *handle, uint32_t offset)
+{
+    otahttp_Struct_pt h_odc = (otahttp_Struct_pt)handle;
+
+    /* only between requests, a running response can not be moved */
+    if (NULL == h_odc || 0 != h_odc->http.net.handle) {
         return -1;
     }
 
-    return h_odc->http_data.response_content_len - h_odc->http_data.retrieve_len - diff;
+    h_odc->offset = offset;
+    ofc_RangeRequest(h_odc);
+
+    return 0;
 }
 
 
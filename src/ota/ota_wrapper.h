@@ -7,6 +7,7 @@ void *HAL_Malloc(uint32_t size);
 void HAL_Free(void *ptr);
 void HAL_Printf(const char *fmt, ...);
 int HAL_Snprintf(char *str, const int len, const char *fmt, ...);
+void HAL_SleepMs(uint32_t ms);
 
 int HAL_SetProductKey(char *product_key);
 int HAL_SetDeviceName(char *device_name);
@@ -5,362 +5,658 @@
 #include <string.h>
 #include <stdio.h>
 #include "stdint.h"
+#include <errno.h>
 #include <fcntl.h>
 #include <pthread.h>
+#include <time.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #include "infra_defs.h"
 
-#define TABLE_COL_SIZE    (384)
-#define TABLE_ROW_SIZE    (2)
+/*
+ * Items are appended to a log file as records of header + key + value, an update or a delete
+ * (a record flagged as deleted) simply supersedes the earlier records of the same key.
+ * The whole log is replayed into an in-memory hash index when the file is opened, so a get
+ * is one pread of the value and a put is one append. Records not fsync'ed by the caller
+ * are flushed in batch by a background thread, which also rewrites the log with live
+ * records only when most of it has become garbage.
+ */
 
-#define ITEM_MAX_KEY_LEN     128 /* The max key length for key-value item */
-#define ITEM_MAX_VAL_LEN     512 /* The max value length for key-value item */
-#define ITEM_MAX_LEN         sizeof(kv_item_t)
+#define ITEM_MAX_KEY_LEN     128        /* The max key length for key-value item */
+#define ITEM_MAX_VAL_LEN     (64 * 1024) /* The max value length for key-value item */
 
-#define KV_FILE_NAME         "linkkit_kv.bin"
+#define KV_FILE_NAME         "linkkit_kv.log"
+#define KV_FILE_NAME_TMP     "linkkit_kv.log.tmp"
+#define KV_OLD_FILE_NAME     "linkkit_kv.bin" /* fixed hash table format, imported once */
+#define KV_IMPORTED_KEY      "\001" KV_OLD_FILE_NAME /* logged after the items of KV_OLD_FILE_NAME */
+
+#define KV_SYNC_INTERVAL_MS  (1000)     /* the longest an unsynced put stays in page cache */
+#define KV_COMPACT_MIN_SIZE  (64 * 1024) /* log smaller than this is never compacted */
+#define KV_COMPACT_RATIO     (2)        /* compact when log is larger than live records by this ratio */
+#define KV_COMPACT_CHUNK     (4096)     /* records appended during compaction are copied in chunks of this */
+#define KV_COMPACT_TAIL_MAX  (64 * 1024) /* most of records appended during compaction copied with lock held */
+#define KV_COMPACT_ROUNDS    (4)        /* most rounds of copying them without lock */
+
+#define KV_BUCKET_INIT_NUM   (64)
+
+#define KV_RECORD_MAGIC      (0x4b564c31) /* "KVL1" */
+#define KV_RECORD_DELETED    (0x0001)
 
 #define kv_err(...)               do{printf(__VA_ARGS__);printf("\r\n");}while(0)
 
-typedef struct kv {
-    char key[ITEM_MAX_KEY_LEN];
-    uint8_t value[ITEM_MAX_VAL_LEN];
-    int value_len;
-} kv_item_t;
+typedef struct {
+    uint32_t magic;
+    uint32_t crc;               /* crc32 of key_len, flags, val_len, key and value */
+    uint16_t key_len;
+    uint16_t flags;
+    uint32_t val_len;
+} kv_record_t;
+
+typedef struct kv_entry_s {
+    struct kv_entry_s *next;
+    unsigned int hash;
+    uint32_t offset;            /* offset of record in log */
+    uint32_t val_len;
+    uint16_t key_len;
+    char *key;
+} kv_entry_t;
+
+typedef struct {
+    uint32_t offset;            /* offset of live record in log being compacted */
+    uint32_t new_offset;        /* offset of it in compacted log */
+    uint32_t size;
+} kv_compact_rec_t;
 
 typedef struct kv_file_s {
     const char *filename;
     pthread_mutex_t lock;
+    pthread_cond_t cond;
+    int fd;
+    uint32_t file_size;
+    uint32_t live_size;         /* bytes of records still referenced by index */
+    int dirty;                  /* appended but not fsync'ed */
+    kv_entry_t **buckets;
+    unsigned int bucket_num;    /* power of 2 */
+    unsigned int entry_num;
 } kv_file_t;
 
 static int kv_get(const char *key, void *value, int *value_len);
-static int kv_set(const char *key, void *value, int value_len);
+static int kv_set(const char *key, void *value, int value_len, int sync);
 static int kv_del(const char *key);
-static unsigned int hash_gen(const char *key);
-static int hash_table_put(kv_file_t *file, const  char *key, void *value, int value_len);
-static int hash_table_get(kv_file_t *file, const char *key, void *value, int *len);
-static int hash_table_rm(kv_file_t *file,  const  char *key);
+static unsigned int hash_gen(const char *key, int key_len);
 static kv_file_t *kv_open(const char *filename);
-static int read_kv_item(const char *filename, void *buf, int location);
-static int write_kv_item(const char *filename, void *data, int location);
 
-static void free_kv(struct kv *kv)
+static uint32_t crc_table[256];
+
+static void crc_table_init(void)
 {
-    if (kv) {
-        kv->value_len = 0;
-        free(kv);
+    uint32_t c;
+    int i, j;
+
+    for (i = 0; i < 256; i++) {
+        c = (uint32_t)i;
+        for (j = 0; j < 8; j++) {
+            c = (c & 1) ? (0xEDB88320 ^ (c >> 1)) : (c >> 1);
+        }
+        crc_table[i] = c;
     }
 }
 
-static unsigned int hash_gen(const char *key)
+static uint32_t crc_update(uint32_t crc, const void *data, uint32_t len)
 {
-    unsigned int hash = 0;
-    while (*key) {
-        hash = (hash << 5) + hash + *key++;
+    const uint8_t *p = data;
+
+    crc = ~crc;
+    while (len--) {
+        crc = crc_table[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
     }
-    return hash % TABLE_COL_SIZE;
+    return ~crc;
 }
 
-/* insert or update a value indexed by key */
-static int hash_table_put(kv_file_t *file, const  char *key, void *value, int value_len)
+static uint32_t record_crc(const kv_record_t *rec, const char *key, const void *value)
 {
-    int i;
-    int read_size;
-    kv_item_t *kv;
-    int j = 0;
-    kv_item_t *p;
-    if (!file || !file->filename ||  !key || !value  || value_len <= 0) {
-        kv_err("paras err");
-        return -1;
-    }
+    uint32_t crc;
 
-    value_len = value_len > ITEM_MAX_VAL_LEN ? ITEM_MAX_VAL_LEN : value_len;
-    i = hash_gen(key);
-    kv_err("hash i= %d", i);
-    read_size = ITEM_MAX_LEN * TABLE_ROW_SIZE;
-    kv = malloc(read_size);
-    if (kv == NULL) {
-        kv_err("malloc kv err");
-        return -1;
-    }
+    crc = crc_update(0, &rec->key_len, sizeof(rec->key_len));
+    crc = crc_update(crc, &rec->flags, sizeof(rec->flags));
+    crc = crc_update(crc, &rec->val_len, sizeof(rec->val_len));
+    crc = crc_update(crc, key, rec->key_len);
+    return crc_update(crc, value, rec->val_len);
+}
 
-    memset(kv, 0, read_size);
-    if (read_kv_item(file->filename, kv, i) != 0) {
-        kv_err("read kv err");
-        free_kv(kv);
-        return -1;
+static uint32_t record_size(uint16_t key_len, uint32_t val_len)
+{
+    return sizeof(kv_record_t) + key_len + val_len;
+}
+
+static unsigned int hash_gen(const char *key, int key_len)
+{
+    unsigned int hash = 0;
+    while (key_len--) {
+        hash = (hash << 5) + hash + *key++;
     }
-    p = &kv[j];
+    return hash;
+}
 
-    while (p && p->value_len) { /* if key is already stroed, update its value */
+static kv_entry_t **hash_table_find(kv_file_t *file, const char *key, int key_len, unsigned int hash)
+{
+    kv_entry_t **pp = &file->buckets[hash & (file->bucket_num - 1)];
 
-        if (strcmp(p->key, key) == 0) {
-            memset(p->value, 0, ITEM_MAX_VAL_LEN);
-            memcpy(p->value, value, value_len);
-            p->value_len = value_len;
+    while (*pp) {
+        if ((*pp)->hash == hash && (*pp)->key_len == key_len && memcmp((*pp)->key, key, key_len) == 0) {
             break;
         }
-
-        if (++j == TABLE_ROW_SIZE) {
-            kv_err("hash row full");
-            free(kv);
-            return -1;
-        }
-        p = &kv[j];
-    }
-
-    p = &kv[j];
-    if (p && !p->value_len) {/* if key has not been stored, then add it */
-        //p->next = NULL;
-        strncpy(p->key, key, ITEM_MAX_KEY_LEN - 1);
-        memcpy(p->value, value, value_len);
-        p->value_len = value_len;
+        pp = &(*pp)->next;
     }
 
-    if (write_kv_item(file->filename, kv, i) < 0) {
-        kv_err("write_kv_item err");
-        free(kv);
-        return -1;
-    }
-    free(kv);
-    return 0;
+    return pp;
 }
 
-/* get a value indexed by key */
-static int hash_table_get(kv_file_t *file, const char *key, void *value, int *len)
+static int hash_table_grow(kv_file_t *file)
 {
-    int i;
-    int read_size;
-    kv_item_t *kv;
-    int j = 0;
-    struct kv *p;
-    if (!file || !file->filename || !key || !value || !len  || *len <= 0) {
-        kv_err("paras err");
-        return -1;
-    }
-
-    i = hash_gen(key);
+    unsigned int i, num = file->bucket_num * 2;
+    kv_entry_t **buckets;
+    kv_entry_t *entry, *next;
 
-    read_size = sizeof(kv_item_t) * TABLE_ROW_SIZE;
-    kv = malloc(read_size);
-    if (kv == NULL) {
-        kv_err("malloc kv err");
+    buckets = calloc(num, sizeof(kv_entry_t *));
+    if (buckets == NULL) {
         return -1;
     }
 
-    memset(kv, 0, read_size);
-    if (read_kv_item(file->filename, kv, i) != 0) {
-        kv_err("read kv err");
-        free_kv(kv);
-        return -1;
+    for (i = 0; i < file->bucket_num; i++) {
+        for (entry = file->buckets[i]; entry; entry = next) {
+            next = entry->next;
+            entry->next = buckets[entry->hash & (num - 1)];
+            buckets[entry->hash & (num - 1)] = entry;
+        }
     }
 
-    // struct kv *p = ht->table[i];
-    p = &kv[j];
+    free(file->buckets);
+    file->buckets = buckets;
+    file->bucket_num = num;
+    return 0;
+}
 
-    while (p && p->value_len) {
-        if (strcmp(key, p->key) == 0) {
-            *len = p->value_len < *len ? p->value_len : *len;
-            memcpy(value, p->value, *len);
-            free_kv(kv);
+/* point key to the record at @offset, or drop it from index if the record is a delete */
+static int hash_table_apply(kv_file_t *file, const char *key, uint16_t key_len, uint16_t flags,
+                            uint32_t val_len, uint32_t offset)
+{
+    unsigned int hash = hash_gen(key, key_len);
+    kv_entry_t **pp = hash_table_find(file, key, key_len, hash);
+    kv_entry_t *entry = *pp;
+
+    if (entry) {
+        file->live_size -= record_size(entry->key_len, entry->val_len);
+        if (flags & KV_RECORD_DELETED) {
+            *pp = entry->next;
+            free(entry->key);
+            free(entry);
+            file->entry_num--;
             return 0;
         }
-        if (++j == TABLE_ROW_SIZE) {
-            break;
+    } else {
+        if (flags & KV_RECORD_DELETED) {
+            return 0;
         }
-        p = &kv[j];
+
+        if (file->entry_num >= file->bucket_num && hash_table_grow(file) == 0) {
+            pp = hash_table_find(file, key, key_len, hash);
+        }
+
+        entry = malloc(sizeof(kv_entry_t));
+        if (entry == NULL) {
+            kv_err("malloc kv entry err");
+            return -1;
+        }
+        memset(entry, 0, sizeof(kv_entry_t));
+        entry->key = malloc(key_len);
+        if (entry->key == NULL) {
+            kv_err("malloc kv key err");
+            free(entry);
+            return -1;
+        }
+        memcpy(entry->key, key, key_len);
+        entry->key_len = key_len;
+        entry->hash = hash;
+        *pp = entry;
+        file->entry_num++;
     }
-    free_kv(kv);
-    kv_err("not found");
-    return -1;
+
+    entry->offset = offset;
+    entry->val_len = val_len;
+    file->live_size += record_size(key_len, val_len);
+    return 0;
 }
 
-/* remove a value indexed by key */
-static int hash_table_rm(kv_file_t *file,  const  char *key)
+static void hash_table_free(kv_file_t *file)
 {
-    int i;
-    int read_size;
-    kv_item_t *kv;
-    int j = 0;
-    struct kv *p;
-    if (!file || !file->filename ||  !key) {
+    unsigned int i;
+    kv_entry_t *entry, *next;
+
+    for (i = 0; i < file->bucket_num; i++) {
+        for (entry = file->buckets[i]; entry; entry = next) {
+            next = entry->next;
+            free(entry->key);
+            free(entry);
+        }
+    }
+    free(file->buckets);
+    file->buckets = NULL;
+}
+
+static int append_record(kv_file_t *file, const char *key, uint16_t flags, const void *value, uint32_t val_len)
+{
+    kv_record_t rec;
+    struct iovec iov[3];
+    uint32_t size;
+    ssize_t ret;
+
+    memset(&rec, 0, sizeof(rec));
+    rec.magic = KV_RECORD_MAGIC;
+    rec.key_len = strlen(key);
+    rec.flags = flags;
+    rec.val_len = val_len;
+    rec.crc = record_crc(&rec, key, value);
+
+    iov[0].iov_base = &rec;
+    iov[0].iov_len = sizeof(rec);
+    iov[1].iov_base = (void *)key;
+    iov[1].iov_len = rec.key_len;
+    iov[2].iov_base = (void *)value;
+    iov[2].iov_len = val_len;
+
+    size = record_size(rec.key_len, val_len);
+    ret = writev(file->fd, iov, 3);
+    if (ret != size) {
+        kv_err("kv write failed");
+        /* drop torn record, it would stop the replay of later ones */
+        if (ftruncate(file->fd, file->file_size) < 0) {
+            kv_err("ftruncate err");
+        }
         return -1;
     }
-    i = hash_gen(key) % TABLE_COL_SIZE;
-    read_size = sizeof(kv_item_t) * TABLE_ROW_SIZE;
-    kv = malloc(read_size);
-    if (kv == NULL) {
+
+    /* a record the index does not know of must not come back on replay either */
+    if (hash_table_apply(file, key, rec.key_len, flags, val_len, file->file_size) < 0) {
+        if (ftruncate(file->fd, file->file_size) < 0) {
+            kv_err("ftruncate err");
+        }
         return -1;
     }
+    file->file_size += size;
+    file->dirty = 1;
+    return 0;
+}
 
-    memset(kv, 0, read_size);
-    if (read_kv_item(file->filename, kv, i) != 0) {
-        free_kv(kv);
+/* rebuild index from log, a record failing check ends the log */
+static int replay_log(kv_file_t *file)
+{
+    struct stat st;
+    kv_record_t rec;
+    uint32_t offset = 0;
+    uint32_t buf_size = 0;
+    char *buf = NULL;
+
+    if (fstat(file->fd, &st) < 0) {
+        kv_err("fstat err");
         return -1;
     }
 
-    p = &kv[j];
+    while (offset + sizeof(rec) <= st.st_size) {
+        if (pread(file->fd, &rec, sizeof(rec), offset) != sizeof(rec) ||
+            rec.magic != KV_RECORD_MAGIC || rec.key_len == 0 || rec.key_len >= ITEM_MAX_KEY_LEN ||
+            rec.val_len > ITEM_MAX_VAL_LEN || offset + record_size(rec.key_len, rec.val_len) > st.st_size) {
+            break;
+        }
 
-    while (p && p->value_len) {
-        if (strcmp(key, p->key) == 0) {
-            memset(p, 0, ITEM_MAX_LEN);
+        if (buf_size < rec.key_len + rec.val_len) {
+            char *tmp = realloc(buf, rec.key_len + rec.val_len);
+            if (tmp == NULL) {
+                kv_err("malloc kv err");
+                free(buf);
+                return -1;
+            }
+            buf = tmp;
+            buf_size = rec.key_len + rec.val_len;
         }
-        if (++j == TABLE_ROW_SIZE) {
+
+        if (pread(file->fd, buf, rec.key_len + rec.val_len, offset + sizeof(rec)) != rec.key_len + rec.val_len ||
+            record_crc(&rec, buf, buf + rec.key_len) != rec.crc) {
             break;
         }
-        p = &kv[j];
+
+        if (hash_table_apply(file, buf, rec.key_len, rec.flags, rec.val_len, offset) < 0) {
+            free(buf);
+            return -1;
+        }
+        offset += record_size(rec.key_len, rec.val_len);
     }
+    free(buf);
 
-    if (write_kv_item(file->filename, kv, i) < 0) {
-        free_kv(kv);
-        return -1;
+    if (offset != st.st_size) {
+        kv_err("kv log truncated at %u of %u", offset, (uint32_t)st.st_size);
+        if (ftruncate(file->fd, offset) < 0) {
+            kv_err("ftruncate err");
+            return -1;
+        }
     }
-    free_kv(kv);
+    file->file_size = offset;
     return 0;
 }
 
-static int read_kv_item(const char *filename, void *buf, int location)
+/*
+ * carry items of the fixed hash table file over, so stored secrets survive the upgrade,
+ * until KV_IMPORTED_KEY is in the log an import cut short by a crash is done again
+ */
+static void import_old_file(kv_file_t *file)
 {
-    struct stat st;
-    int ret = 0;
-    int offset;
-    int fd = open(filename, O_RDONLY);
+    struct {
+        char key[128];
+        uint8_t value[512];
+        int value_len;
+    } item;
+    int key_len = strlen(KV_IMPORTED_KEY);
+    int fd;
+
+    if (*hash_table_find(file, KV_IMPORTED_KEY, key_len, hash_gen(KV_IMPORTED_KEY, key_len)) != NULL) {
+        /* a crash may have come between syncing the log and removing the old file */
+        unlink(KV_OLD_FILE_NAME);
+        return;
+    }
 
+    fd = open(KV_OLD_FILE_NAME, O_RDONLY);
     if (fd < 0) {
-        kv_err("open err");
-        return -1;
+        return;
     }
 
-    if (fstat(fd, &st) < 0) {
-        kv_err("fstat err");
-        close(fd);
-        return -1;
+    while (read(fd, &item, sizeof(item)) == sizeof(item)) {
+        if (item.value_len <= 0 || item.value_len > sizeof(item.value)) {
+            continue;
+        }
+        item.key[sizeof(item.key) - 1] = '\0';
+        if (item.key[0] != '\0') {
+            append_record(file, item.key, 0, item.value, item.value_len);
+        }
     }
+    close(fd);
 
-    if (st.st_size < (location + 1) *ITEM_MAX_LEN * TABLE_ROW_SIZE) {
-        kv_err("read overstep");
-        close(fd);
-        return -1;
+    /* replay stops at the first bad record, so the marker is only found with every item before it */
+    if (append_record(file, KV_IMPORTED_KEY, 0, "", 0) == 0 && fsync(file->fd) == 0) {
+        file->dirty = 0;
+        unlink(KV_OLD_FILE_NAME);
     }
+}
 
-    offset =  location * ITEM_MAX_LEN * TABLE_ROW_SIZE;
-    ret = lseek(fd, offset, SEEK_SET);
-    if (ret < 0) {
-        kv_err("lseek err");
-        close(fd);
+/* make a rename in directory of @path durable */
+static int sync_dir(const char *path)
+{
+    char dir[256];
+    const char *slash = strrchr(path, '/');
+    int fd, ret;
+
+    if (slash == NULL) {
+        strcpy(dir, ".");
+    } else if (slash == path) {
+        strcpy(dir, "/");
+    } else if (slash - path < sizeof(dir)) {
+        memcpy(dir, path, slash - path);
+        dir[slash - path] = '\0';
+    } else {
         return -1;
     }
 
-    if (read(fd, buf, ITEM_MAX_LEN * TABLE_ROW_SIZE) != ITEM_MAX_LEN * TABLE_ROW_SIZE) {
-        kv_err("read err");
-        close(fd);
+    fd = open(dir, O_RDONLY);
+    if (fd < 0) {
         return -1;
     }
-
+    ret = fsync(fd);
     close(fd);
+    return ret;
+}
+
+static int compact_rec_cmp(const void *a, const void *b)
+{
+    uint32_t x = ((const kv_compact_rec_t *)a)->offset, y = ((const kv_compact_rec_t *)b)->offset;
+
+    return x < y ? -1 : x > y;
+}
+
+/* copy log from @from up to @to, records there are never rewritten until the log is replaced */
+static int copy_tail(int old_fd, int fd, char *buf, uint32_t buf_size, uint32_t from, uint32_t to)
+{
+    uint32_t len;
+
+    while (from < to) {
+        len = to - from < buf_size ? to - from : buf_size;
+        if (pread(old_fd, buf, len, from) != len || write(fd, buf, len) != len) {
+            return -1;
+        }
+        from += len;
+    }
     return 0;
 }
 
-static int write_kv_item(const char *filename, void *data, int location)
+/*
+ * rewrite log with live records only, called with lock held. The lock is dropped while the live
+ * records are copied, puts and gets go on against the old log meanwhile. Records appended to it
+ * since are copied as they are, the last of them with lock held, then the new log replaces it.
+ */
+static int compact_log(kv_file_t *file)
 {
-    struct stat st;
-    int offset;
-    int ret;
-    int fd = open(filename, O_WRONLY);
-    if (fd < 0) {
+    unsigned int i, n = 0, rounds = 0;
+    uint32_t size = 0, end, base, to;
+    uint32_t buf_size = 0;
+    char *buf = NULL;
+    kv_compact_rec_t *recs, *rec, key;
+    kv_entry_t *entry;
+    int fd, old_fd = file->fd;
+
+    recs = malloc((file->entry_num + 1) * sizeof(kv_compact_rec_t));
+    if (recs == NULL) {
+        kv_err("kv compact failed");
         return -1;
     }
+    for (i = 0; i < file->bucket_num; i++) {
+        for (entry = file->buckets[i]; entry; entry = entry->next) {
+            recs[n].offset = entry->offset;
+            recs[n].size = record_size(entry->key_len, entry->val_len);
+            n++;
+        }
+    }
+    end = file->file_size;
 
-    if (fstat(fd, &st) < 0) {
-        kv_err("fstat err");
-        close(fd);
+    /* old_fd stays open, only this thread replaces it */
+    pthread_mutex_unlock(&file->lock);
+
+    qsort(recs, n, sizeof(kv_compact_rec_t), compact_rec_cmp);
+
+    fd = open(KV_FILE_NAME_TMP, O_CREAT | O_TRUNC | O_RDWR | O_APPEND, 0644);
+    if (fd < 0) {
+        kv_err("open err");
+        pthread_mutex_lock(&file->lock);
+        free(recs);
         return -1;
     }
 
-    if (st.st_size < (location + 1) *ITEM_MAX_LEN * TABLE_ROW_SIZE) {
-        kv_err("overstep st.st_size = %d location =%d cur loc=%d",
-               (int)st.st_size,
-               (int)location,
-               (int)((location + 1) *ITEM_MAX_LEN * TABLE_ROW_SIZE));
-        close(fd);
-        return -1;
+    for (i = 0; i < n; i++) {
+        if (buf_size < recs[i].size) {
+            char *tmp = realloc(buf, recs[i].size);
+            if (tmp == NULL) {
+                goto fail_unlocked;
+            }
+            buf = tmp;
+            buf_size = recs[i].size;
+        }
+
+        if (pread(old_fd, buf, recs[i].size, recs[i].offset) != recs[i].size ||
+            write(fd, buf, recs[i].size) != recs[i].size) {
+            goto fail_unlocked;
+        }
+        recs[i].new_offset = size;
+        size += recs[i].size;
     }
 
-    offset = (location) * ITEM_MAX_LEN * TABLE_ROW_SIZE;
-    ret = lseek(fd, offset, SEEK_SET);
-    if (ret < 0) {
-        kv_err("lseek err");
-        close(fd);
-        return -1;
+    if (fsync(fd) < 0) {
+        goto fail_unlocked;
+    }
+    if (buf_size < KV_COMPACT_CHUNK) {
+        char *tmp = realloc(buf, KV_COMPACT_CHUNK);
+        if (tmp == NULL) {
+            goto fail_unlocked;
+        }
+        buf = tmp;
+        buf_size = KV_COMPACT_CHUNK;
     }
 
-    if (write(fd, data, ITEM_MAX_LEN * TABLE_ROW_SIZE) != ITEM_MAX_LEN * TABLE_ROW_SIZE) {
-        kv_err("kv write failed");
-        close(fd);
-        return -1;
+    /* catch up with puts and deletes logged while copying, dropping the lock while they are many */
+    base = size;
+    pthread_mutex_lock(&file->lock);
+    while (file->file_size - end - (size - base) > KV_COMPACT_TAIL_MAX && rounds++ < KV_COMPACT_ROUNDS) {
+        to = file->file_size;
+        pthread_mutex_unlock(&file->lock);
+        if (copy_tail(old_fd, fd, buf, buf_size, end + (size - base), to) < 0) {
+            goto fail_unlocked;
+        }
+        size = base + (to - end);
+        pthread_mutex_lock(&file->lock);
     }
+    if (copy_tail(old_fd, fd, buf, buf_size, end + (size - base), file->file_size) < 0) {
+        goto fail;
+    }
+    size = base + (file->file_size - end);
 
-    fsync(fd);
-    close(fd);
+    if ((size > base && fsync(fd) < 0) || rename(KV_FILE_NAME_TMP, file->filename) < 0) {
+        goto fail;
+    }
+    free(buf);
 
+    for (i = 0; i < file->bucket_num; i++) {
+        for (entry = file->buckets[i]; entry; entry = entry->next) {
+            if (entry->offset >= end) {
+                entry->offset = base + (entry->offset - end);
+            } else {
+                /* a record before end still referenced was live when recs was taken */
+                key.offset = entry->offset;
+                rec = bsearch(&key, recs, n, sizeof(kv_compact_rec_t), compact_rec_cmp);
+                entry->offset = rec->new_offset;
+            }
+        }
+    }
+    free(recs);
+
+    file->fd = fd;
+    file->file_size = size;
+    file->dirty = 0;
+
+    /* closing the last fd of the replaced log frees its blocks, which takes long for a large one */
+    pthread_mutex_unlock(&file->lock);
+    close(old_fd);
+    /* the new log is in place, until the directory is synced a crash may still bring the old one back */
+    if (sync_dir(file->filename) < 0) {
+        kv_err("kv dir sync err");
+    }
+    pthread_mutex_lock(&file->lock);
     return 0;
+
+fail_unlocked:
+    pthread_mutex_lock(&file->lock);
+fail:
+    kv_err("kv compact failed");
+    free(buf);
+    free(recs);
+    close(fd);
+    unlink(KV_FILE_NAME_TMP);
+    return -1;
 }
 
-static int create_hash_file(kv_file_t *hash_kv)
+static void *kv_worker(void *arg)
 {
-    int i;
+    kv_file_t *file = arg;
+    struct timespec ts;
     int fd;
-    char init_data[ITEM_MAX_LEN * TABLE_ROW_SIZE] = {0};
-    if (hash_kv == NULL) {
-        return -1;
-    }
-    fd = open(hash_kv->filename, O_CREAT | O_RDWR, 0644);
-    if (fd < 0) {
-        return -1;
-    }
 
-    for (i = 0; i < TABLE_COL_SIZE ; i++) {
-
-        if (write(fd, init_data, ITEM_MAX_LEN * TABLE_ROW_SIZE) != ITEM_MAX_LEN *
-            TABLE_ROW_SIZE) { /* 3 = '{}' + null terminator */
-            kv_err("write err");
-            close(fd);
-            return -1;
+    pthread_mutex_lock(&file->lock);
+    while (1) {
+        clock_gettime(CLOCK_REALTIME, &ts);
+        ts.tv_sec += KV_SYNC_INTERVAL_MS / 1000;
+        ts.tv_nsec += (KV_SYNC_INTERVAL_MS % 1000) * 1000000;
+        if (ts.tv_nsec >= 1000000000) {
+            ts.tv_sec++;
+            ts.tv_nsec -= 1000000000;
+        }
+        pthread_cond_timedwait(&file->cond, &file->lock, &ts);
+
+        if (file->dirty) {
+            /* puts go on while flushing, fd is only replaced by compaction of this thread */
+            file->dirty = 0;
+            fd = file->fd;
+            pthread_mutex_unlock(&file->lock);
+            fdatasync(fd);
+            pthread_mutex_lock(&file->lock);
         }
-    }
 
-    if (fsync(fd) < 0) {
-        close(fd);
-        return -1;
+        if (file->file_size > KV_COMPACT_MIN_SIZE && file->file_size > file->live_size * KV_COMPACT_RATIO) {
+            compact_log(file);
+        }
     }
 
-    close(fd);
-    return 0;
+    return NULL;
 }
 
-
 static kv_file_t *kv_open(const char *filename)
 {
+    pthread_t thread;
+    pthread_attr_t attr;
     kv_file_t *file = malloc(sizeof(kv_file_t));
     if (!file) {
         return NULL;
     }
     memset(file, 0, sizeof(kv_file_t));
+    file->fd = -1;
+
+    crc_table_init();
 
     file->filename = filename;
     pthread_mutex_init(&file->lock, NULL);
-    pthread_mutex_lock(&file->lock);
+    pthread_cond_init(&file->cond, NULL);
 
-    if (access(file->filename, F_OK) < 0) {
-        /* create KV file when not exist */
-        if (create_hash_file(file) < 0) {
-            goto fail;
-        }
+    file->buckets = calloc(KV_BUCKET_INIT_NUM, sizeof(kv_entry_t *));
+    if (file->buckets == NULL) {
+        goto fail;
     }
-    pthread_mutex_unlock(&file->lock);
+    file->bucket_num = KV_BUCKET_INIT_NUM;
+
+    /* create KV file when not exist */
+    file->fd = open(file->filename, O_CREAT | O_RDWR | O_APPEND, 0644);
+    if (file->fd < 0) {
+        kv_err("open err");
+        goto fail;
+    }
+
+    if (replay_log(file) < 0) {
+        goto fail;
+    }
+
+    import_old_file(file);
+
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    if (pthread_create(&thread, &attr, kv_worker, file) != 0) {
+        kv_err("kv worker create failed");
+        pthread_attr_destroy(&attr);
+        goto fail;
+    }
+    pthread_attr_destroy(&attr);
+
     return file;
 fail:
-    pthread_mutex_unlock(&file->lock);
+    if (file->fd >= 0) {
+        close(file->fd);
+    }
+    hash_table_free(file);
+    pthread_cond_destroy(&file->cond);
+    pthread_mutex_destroy(&file->lock);
     free(file);
 
     return NULL;
@@ -368,27 +664,49 @@ fail:
 
 static int __kv_get(kv_file_t *file, const char *key, void *value, int *value_len)
 {
-    int ret;
+    int ret = -1;
+    int key_len;
+    kv_entry_t *entry;
     if (!file || !key || !value || !value_len || *value_len <= 0) {
         return -1;
     }
 
+    key_len = strlen(key);
     pthread_mutex_lock(&file->lock);
-    ret = hash_table_get(file, key, value, value_len);
+    entry = *hash_table_find(file, key, key_len, hash_gen(key, key_len));
+    if (entry) {
+        *value_len = entry->val_len < *value_len ? entry->val_len : *value_len;
+        if (pread(file->fd, value, *value_len, entry->offset + sizeof(kv_record_t) + key_len) == *value_len) {
+            ret = 0;
+        } else {
+            kv_err("read err");
+        }
+    }
     pthread_mutex_unlock(&file->lock);
 
     return ret;
 }
 
-static int __kv_set(kv_file_t *file, const char *key, void *value, int value_len)
+static int __kv_set(kv_file_t *file, const char *key, void *value, int value_len, int sync)
 {
     int ret;
     if (!file || !key || !value || value_len <= 0) {
         return -1;
     }
 
+    if (key[0] == '\0' || strlen(key) >= ITEM_MAX_KEY_LEN || value_len > ITEM_MAX_VAL_LEN) {
+        kv_err("paras err");
+        return -1;
+    }
+
     pthread_mutex_lock(&file->lock);
-    ret = hash_table_put(file, key, value, value_len);
+    ret = append_record(file, key, 0, value, value_len);
+    if (ret == 0 && sync) {
+        if (fdatasync(file->fd) < 0) {
+            kv_err("fdatasync err");
+            ret = -1;
+        }
+    }
     pthread_mutex_unlock(&file->lock);
 
     return ret;
@@ -396,62 +714,58 @@ static int __kv_set(kv_file_t *file, const char *key, void *value, int value_len
 
 int __kv_del(kv_file_t *file, const  char *key)
 {
-    int ret;
+    int ret = 0;
+    int key_len;
     if (!file || !key) {
         return -1;
     }
 
     /* remove old value if exist */
+    key_len = strlen(key);
     pthread_mutex_lock(&file->lock);
-    ret = hash_table_rm(file, key);
+    if (*hash_table_find(file, key, key_len, hash_gen(key, key_len)) != NULL) {
+        ret = append_record(file, key, KV_RECORD_DELETED, NULL, 0);
+    }
     pthread_mutex_unlock(&file->lock);
 
     return ret;
 }
 
 static kv_file_t *file = NULL;
-static int kv_get(const char *key, void *value, int *value_len)
+static pthread_mutex_t file_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static kv_file_t *kv_file(void)
 {
+    pthread_mutex_lock(&file_lock);
     if (!file) {
         file = kv_open(KV_FILE_NAME);
         if (!file) {
             kv_err("kv_open failed");
-            return -1;
         }
     }
+    pthread_mutex_unlock(&file_lock);
 
-    return __kv_get(file, key, value, value_len);
+    return file;
 }
 
-static int kv_set(const char *key, void *value, int value_len)
+static int kv_get(const char *key, void *value, int *value_len)
 {
-    if (!file) {
-        file = kv_open(KV_FILE_NAME);
-        if (!file) {
-            kv_err("kv_open failed");
-            return -1;
-        }
-    }
+    return __kv_get(kv_file(), key, value, value_len);
+}
 
-    return __kv_set(file, key, value, value_len);
+static int kv_set(const char *key, void *value, int value_len, int sync)
+{
+    return __kv_set(kv_file(), key, value, value_len, sync);
 }
 
 static int kv_del(const char *key)
 {
-    if (!file) {
-        file = kv_open(KV_FILE_NAME);
-        if (!file) {
-            kv_err("kv_open failed");
-            return -1;
-        }
-    }
-
-    return __kv_del(file, key);
+    return __kv_del(kv_file(), key);
 }
 
 int HAL_Kv_Set(const char *key, const void *val, int len, int sync)
 {
-    return kv_set(key, (void *)val, len);
+    return kv_set(key, (void *)val, len, sync);
 }
 
 int HAL_Kv_Get(const char *key, void *val, int *buffer_len)
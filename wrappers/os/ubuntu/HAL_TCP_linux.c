@@ -11,6 +11,7 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <netinet/tcp.h>
+#include <poll.h>
 #include <netdb.h>
 #include "infra_config.h"
 
@@ -199,53 +200,49 @@ int32_t HAL_TCP_Read(uintptr_t fd, char *buf, uint32_t len, uint32_t timeout_ms)
     int ret, err_code, tcp_fd;
     uint32_t len_recv;
     uint64_t t_end, t_left;
-    fd_set sets;
-    struct timeval timeout;
+    struct pollfd pfd;
 
     t_end = _linux_get_time_ms() + timeout_ms;
     len_recv = 0;
     err_code = 0;
 
-    if (fd >= FD_SETSIZE) {
-        return -1;
-    }
     tcp_fd = (int)fd;
 
     do {
+        /* take what is already queued without waiting, only wait for readiness when there is nothing */
+        ret = recv(tcp_fd, buf + len_recv, len - len_recv, MSG_DONTWAIT);
+        if (ret > 0) {
+            len_recv += ret;
+            continue;
+        } else if (0 == ret) {
+            printf("connection is closed\n");
+            err_code = -1;
+            break;
+        } else if (EINTR == errno) {
+            continue;
+        } else if (EAGAIN != errno && EWOULDBLOCK != errno) {
+            printf("recv fail\n");
+            err_code = -2;
+            break;
+        }
+
         t_left = _linux_time_left(t_end, _linux_get_time_ms());
         if (0 == t_left) {
             break;
         }
-        FD_ZERO(&sets);
-        FD_SET(tcp_fd, &sets);
 
-        timeout.tv_sec = t_left / 1000;
-        timeout.tv_usec = (t_left % 1000) * 1000;
+        pfd.fd = tcp_fd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
 
-        ret = select(tcp_fd + 1, &sets, NULL, NULL, &timeout);
-        if (ret > 0) {
-            ret = recv(tcp_fd, buf + len_recv, len - len_recv, 0);
-            if (ret > 0) {
-                len_recv += ret;
-            } else if (0 == ret) {
-                printf("connection is closed\n");
-                err_code = -1;
-                break;
-            } else {
-                if (EINTR == errno) {
-                    continue;
-                }
-                printf("recv fail\n");
-                err_code = -2;
-                break;
-            }
-        } else if (0 == ret) {
+        ret = poll(&pfd, 1, (int)t_left);
+        if (0 == ret) {
             break;
-        } else {
+        } else if (ret < 0) {
             if (EINTR == errno) {
                 continue;
             }
-            printf("select-recv fail\n");
+            printf("poll-recv fail\n");
             err_code = -2;
             break;
         }